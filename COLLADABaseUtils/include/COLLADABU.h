@@ -19,10 +19,12 @@
 #include "COLLADABUHashFunctions.h"
 #include "COLLADABUhash_map.h"
 #include "COLLADABUIDList.h"
+#include "COLLADABUMemoryMappedFile.h"
 #include "COLLADABUNativeString.h"
 #include "COLLADABUPcreCompiledPattern.h"
 #include "COLLADABUPlatform.h"
 #include "COLLADABUStringUtils.h"
+#include "COLLADABUThread.h"
 #include "COLLADABUURI.h"
 #include "COLLADABUUtils.h"
 
@@ -0,0 +1,263 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABU_FLATHASHMAP_H__
+#define __COLLADABU_FLATHASHMAP_H__
+
+#include "COLLADABUPrerequisites.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+
+namespace COLLADABU
+{
+	/** Default hash function used by FlatHashMap. It uses the conversion of the key to size_t, which
+	exists for all integral types and for classes like COLLADAFW::UniqueId, that provide an operator size_t.*/
+	template<class KeyType>
+	struct FlatHashFunction
+	{
+		size_t operator() ( const KeyType& key ) const { return (size_t)key; }
+	};
+
+
+	/** Associative container that provides the subset of the std::map interface used for lookup tables
+	(find, count, insert, operator[], erase and iteration). The entries are stored in insertion order in one
+	contiguous array and are located through an open addressing table with linear probing, that only
+	contains entry indices. A lookup therefore touches the small index table and one entry, instead of
+	log(n) tree nodes spread across the heap.
+
+	Differences to std::map:
+	- insert() and operator[] invalidate all iterators, references and pointers to entries. Do not keep
+	pointers into values stored in the map while new keys are added.
+	- The iteration order is the insertion order, not the key order.
+	- erase() moves the last entry to the position of the erased one.
+	@tparam KeyType Type of the keys. Requires operator==.
+	@tparam ValueType Type of the mapped values. Requires a default constructor.
+	@tparam HashFunction Functor that calculates a size_t hash value of a key.*/
+	template<class KeyType, class ValueType, class HashFunction = FlatHashFunction<KeyType> >
+	class FlatHashMap
+	{
+	public:
+		typedef KeyType key_type;
+		typedef ValueType mapped_type;
+		typedef std::pair<KeyType, ValueType> value_type;
+		typedef size_t size_type;
+
+	private:
+		typedef std::vector<value_type> EntryArray;
+
+		/** Each slot contains the index of an entry plus one or EMPTY_SLOT.*/
+		typedef std::vector<size_t> SlotArray;
+
+	public:
+		typedef typename EntryArray::iterator iterator;
+		typedef typename EntryArray::const_iterator const_iterator;
+
+	private:
+		enum
+		{
+			/** Value of a slot that does not reference an entry.*/
+			EMPTY_SLOT = 0,
+
+			/** The number of slots allocated for the first entry.*/
+			MIN_SLOT_COUNT = 16
+		};
+
+	private:
+		/** The entries in insertion order.*/
+		EntryArray mEntries;
+
+		/** The open addressing table. Its size is zero or a power of two and it is at least twice as
+		large as the number of entries.*/
+		SlotArray mSlots;
+
+		/** The hash function.*/
+		HashFunction mHashFunction;
+
+	public:
+
+		/** Constructor. Does not allocate any memory.*/
+		FlatHashMap() {}
+
+		iterator begin() { return mEntries.begin(); }
+		const_iterator begin() const { return mEntries.begin(); }
+		iterator end() { return mEntries.end(); }
+		const_iterator end() const { return mEntries.end(); }
+
+		/** Returns the number of entries.*/
+		size_t size() const { return mEntries.size(); }
+
+		/** Returns true, if the map does not contain any entry.*/
+		bool empty() const { return mEntries.empty(); }
+
+		/** Removes all entries. The allocated memory is kept.*/
+		void clear()
+		{
+			mEntries.clear();
+			mSlots.assign( mSlots.size(), (size_t)EMPTY_SLOT );
+		}
+
+		/** Allocates enough memory to store @a entryCount entries without rehashing.*/
+		void reserve( size_t entryCount )
+		{
+			mEntries.reserve( entryCount );
+			size_t slotCount = (size_t)MIN_SLOT_COUNT;
+			while ( slotCount < 2 * entryCount )
+				slotCount *= 2;
+			if ( slotCount > mSlots.size() )
+				rehash( slotCount );
+		}
+
+		/** Returns an iterator to the entry with key @a key or end(), if there is none.*/
+		iterator find( const KeyType& key )
+		{
+			if ( mSlots.empty() )
+				return mEntries.end();
+			size_t slot = mSlots[ findSlot( key ) ];
+			return ( slot == EMPTY_SLOT ) ? mEntries.end() : mEntries.begin() + (slot - 1);
+		}
+
+		/** Returns an iterator to the entry with key @a key or end(), if there is none.*/
+		const_iterator find( const KeyType& key ) const
+		{
+			if ( mSlots.empty() )
+				return mEntries.end();
+			size_t slot = mSlots[ findSlot( key ) ];
+			return ( slot == EMPTY_SLOT ) ? mEntries.end() : mEntries.begin() + (slot - 1);
+		}
+
+		/** Returns 1, if the map contains an entry with key @a key, 0 otherwise.*/
+		size_t count( const KeyType& key ) const
+		{
+			return ( find( key ) == end() ) ? 0 : 1;
+		}
+
+		/** Adds @a entry, if the map does not contain an entry with the same key.
+		@return An iterator to the entry with the key of @a entry and true, if @a entry has been added.*/
+		std::pair<iterator, bool> insert( const value_type& entry )
+		{
+			growIfRequired();
+			size_t slotIndex = findSlot( entry.first );
+			size_t slot = mSlots[ slotIndex ];
+			if ( slot != EMPTY_SLOT )
+				return std::make_pair( mEntries.begin() + (slot - 1), false );
+
+			mEntries.push_back( entry );
+			mSlots[ slotIndex ] = mEntries.size();
+			return std::make_pair( mEntries.end() - 1, true );
+		}
+
+		/** Returns the value mapped to @a key. If the map does not contain @a key, a default constructed
+		value is added.*/
+		ValueType& operator[]( const KeyType& key )
+		{
+			return insert( value_type( key, ValueType() ) ).first->second;
+		}
+
+		/** Removes the entry with key @a key.
+		@return The number of removed entries.*/
+		size_t erase( const KeyType& key )
+		{
+			if ( mSlots.empty() )
+				return 0;
+
+			size_t slotIndex = findSlot( key );
+			if ( mSlots[ slotIndex ] == EMPTY_SLOT )
+				return 0;
+			size_t entryIndex = mSlots[ slotIndex ] - 1;
+
+			// Shift back the following slots of the probe sequence, that may not be separated from their
+			// ideal slot by an empty slot.
+			size_t mask = mSlots.size() - 1;
+			size_t hole = slotIndex;
+			size_t next = (hole + 1) & mask;
+			while ( mSlots[ next ] != EMPTY_SLOT )
+			{
+				size_t idealSlotIndex = getIdealSlotIndex( mEntries[ mSlots[ next ] - 1 ].first );
+				if ( ((next - idealSlotIndex) & mask) >= ((next - hole) & mask) )
+				{
+					mSlots[ hole ] = mSlots[ next ];
+					hole = next;
+				}
+				next = (next + 1) & mask;
+			}
+			mSlots[ hole ] = EMPTY_SLOT;
+
+			// Move the last entry into the gap
+			size_t lastEntryIndex = mEntries.size() - 1;
+			if ( entryIndex != lastEntryIndex )
+			{
+				mSlots[ findSlot( mEntries[ lastEntryIndex ].first ) ] = entryIndex + 1;
+				mEntries[ entryIndex ] = mEntries[ lastEntryIndex ];
+			}
+			mEntries.pop_back();
+			return 1;
+		}
+
+		/** Exchanges the contents of this map and @a other.*/
+		void swap( FlatHashMap& other )
+		{
+			mEntries.swap( other.mEntries );
+			mSlots.swap( other.mSlots );
+			std::swap( mHashFunction, other.mHashFunction );
+		}
+
+	private:
+
+		/** Returns the slot index at which the probe sequence for @a key starts.*/
+		size_t getIdealSlotIndex( const KeyType& key ) const
+		{
+			// Mix the bits, since many hash functions of integral types are the identity and the
+			// table size is a power of two.
+			size_t hash = mHashFunction( key );
+			hash ^= hash >> 15;
+			hash *= 2654435761U;
+			hash ^= hash >> 13;
+			return hash & (mSlots.size() - 1);
+		}
+
+		/** Returns the index of the slot that references the entry with key @a key or of the empty slot
+		at which such an entry would be inserted. mSlots must not be empty.*/
+		size_t findSlot( const KeyType& key ) const
+		{
+			size_t mask = mSlots.size() - 1;
+			size_t slotIndex = getIdealSlotIndex( key );
+			for (;;)
+			{
+				size_t slot = mSlots[ slotIndex ];
+				if ( slot == EMPTY_SLOT || mEntries[ slot - 1 ].first == key )
+					return slotIndex;
+				slotIndex = (slotIndex + 1) & mask;
+			}
+		}
+
+		/** Doubles the number of slots, if adding another entry would fill more than half of them.*/
+		void growIfRequired()
+		{
+			if ( 2 * (mEntries.size() + 1) > mSlots.size() )
+				rehash( mSlots.empty() ? (size_t)MIN_SLOT_COUNT : 2 * mSlots.size() );
+		}
+
+		/** Resizes the open addressing table to @a slotCount slots and reinserts all entries.*/
+		void rehash( size_t slotCount )
+		{
+			mSlots.assign( slotCount, (size_t)EMPTY_SLOT );
+			for ( size_t i = 0, count = mEntries.size(); i < count; ++i )
+			{
+				mSlots[ findSlot( mEntries[ i ].first ) ] = i + 1;
+			}
+		}
+	};
+
+} // namespace COLLADABU
+
+#endif // __COLLADABU_FLATHASHMAP_H__
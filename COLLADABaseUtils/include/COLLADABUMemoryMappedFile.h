@@ -0,0 +1,76 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABU_MEMORYMAPPEDFILE_H__
+#define __COLLADABU_MEMORYMAPPEDFILE_H__
+
+#include "COLLADABUPrerequisites.h"
+#include "COLLADABUNativeString.h"
+
+
+namespace COLLADABU
+{
+
+	/** Maps a file read only into memory (mmap or the Windows API). The operating system reads the
+	pages on demand, so the file content can be accessed like a buffer without being copied. The
+	platform types are only used in the implementation file.*/
+	class MemoryMappedFile
+	{
+	private:
+		/** The mapped file content.*/
+		const char* mData;
+
+		/** The size of the file in bytes.*/
+		size_t mSize;
+
+		/** True, if a file is mapped.*/
+		bool mIsOpen;
+
+		/** The file and file mapping handles on Windows. Not used on other platforms.*/
+		void* mFileHandle;
+		void* mMappingHandle;
+
+	public:
+
+		/** Constructor. */
+		MemoryMappedFile();
+
+		/** Destructor. Unmaps the file.*/
+		virtual ~MemoryMappedFile();
+
+		/** Maps the file @a fileName. A file that is already mapped is unmapped before.
+		@return True on success, false if the file could not be opened or mapped.*/
+		bool open( const NativeString& fileName );
+
+		/** Unmaps the file. Pointers returned by getData() become invalid.*/
+		void close();
+
+		/** True, if a file is mapped.*/
+		bool isOpen() const { return mIsOpen; }
+
+		/** The mapped file content. 0 if no file is mapped or the file is empty.*/
+		const char* getData() const { return mData; }
+
+		/** The size of the mapped file in bytes.*/
+		size_t getSize() const { return mSize; }
+
+	private:
+
+        /** Disable default copy ctor. */
+		MemoryMappedFile( const MemoryMappedFile& pre );
+
+        /** Disable default assignment operator. */
+		const MemoryMappedFile& operator= ( const MemoryMappedFile& pre );
+
+	};
+
+} // namespace COLLADABU
+
+#endif // __COLLADABU_MEMORYMAPPEDFILE_H__
@@ -0,0 +1,222 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABU_THREAD_H__
+#define __COLLADABU_THREAD_H__
+
+#include "COLLADABUPrerequisites.h"
+
+#include <vector>
+
+
+namespace COLLADABU
+{
+
+	/** Minimal wrappers around the threading primitives of the operating system (pthreads or the
+	Windows API). The platform types are only used in the implementation file, so including this
+	header does not pull in windows.h or pthread.h.*/
+
+	/** A non recursive mutex.*/
+	class Mutex
+	{
+		friend class Condition;
+
+	private:
+		/** The platform mutex.*/
+		void* mHandle;
+
+	public:
+
+		/** Constructor. */
+		Mutex();
+
+		/** Destructor. The mutex must not be locked.*/
+		virtual ~Mutex();
+
+		/** Blocks until the mutex could be locked by the calling thread.*/
+		void lock();
+
+		/** Unlocks the mutex. It must be locked by the calling thread.*/
+		void unlock();
+
+	private:
+
+        /** Disable default copy ctor. */
+		Mutex( const Mutex& pre );
+
+        /** Disable default assignment operator. */
+		const Mutex& operator= ( const Mutex& pre );
+
+	};
+
+
+	/** Locks a mutex for the lifetime of the object.*/
+	class ScopedLock
+	{
+	private:
+		Mutex& mMutex;
+
+	public:
+		ScopedLock( Mutex& mutex ) : mMutex(mutex) { mMutex.lock(); }
+		~ScopedLock() { mMutex.unlock(); }
+
+	private:
+
+        /** Disable default copy ctor. */
+		ScopedLock( const ScopedLock& pre );
+
+        /** Disable default assignment operator. */
+		const ScopedLock& operator= ( const ScopedLock& pre );
+
+	};
+
+
+	/** A condition variable. As usual, waiting threads might wake up without being signaled and need
+	to check their condition in a loop.*/
+	class Condition
+	{
+	private:
+		/** The platform condition variable.*/
+		void* mHandle;
+
+	public:
+
+		/** Constructor. */
+		Condition();
+
+		/** Destructor. No thread must wait for the condition.*/
+		virtual ~Condition();
+
+		/** Unlocks @a mutex, waits until the condition is signaled and locks @a mutex again.
+		@a mutex must be locked by the calling thread.*/
+		void wait( Mutex& mutex );
+
+		/** Wakes up one waiting thread.*/
+		void signal();
+
+		/** Wakes up all waiting threads.*/
+		void broadcast();
+
+	private:
+
+        /** Disable default copy ctor. */
+		Condition( const Condition& pre );
+
+        /** Disable default assignment operator. */
+		const Condition& operator= ( const Condition& pre );
+
+	};
+
+
+	/** A flag that is set once by one thread and can be tested by others without locking a mutex.
+	Writes of the setting thread before set() are visible to threads that see the flag set.*/
+	class AtomicFlag
+	{
+	private:
+		/** 0 or 1. Only accessed through the atomic operations of the platform.*/
+		volatile long mValue;
+
+	public:
+
+		/** Constructor. The flag is not set.*/
+		AtomicFlag() : mValue(0) {}
+
+		/** Sets the flag.*/
+		void set();
+
+		/** Returns true, if set() has been called.*/
+		bool isSet() const;
+
+	private:
+
+        /** Disable default copy ctor. */
+		AtomicFlag( const AtomicFlag& pre );
+
+        /** Disable default assignment operator. */
+		const AtomicFlag& operator= ( const AtomicFlag& pre );
+
+	};
+
+
+	/** Base class of classes that execute their run() method on a separate thread. Derived classes
+	must call join() in their destructor, before any member used by run() is destroyed.*/
+	class Thread
+	{
+	private:
+		/** The platform thread or 0, if the thread is not running.*/
+		void* mHandle;
+
+	public:
+
+		/** Constructor. Does not start the thread.*/
+		Thread();
+
+		/** Destructor. Waits for the thread, if it has been started but not joined.*/
+		virtual ~Thread();
+
+		/** Starts a new thread that executes run().
+		@return True, if the thread could be created, false otherwise.*/
+		bool start();
+
+		/** Waits until run() has returned. Does nothing, if the thread has not been started.*/
+		void join();
+
+		/** Returns true, if the thread has been started and not yet been joined.*/
+		bool isStarted() const { return mHandle != 0; }
+
+		/** Returns an id of the calling thread, that is unique among the running threads of the
+		process.*/
+		static unsigned long getCurrentThreadId();
+
+	protected:
+
+		/** Executed on the new thread.*/
+		virtual void run() = 0;
+
+	private:
+
+        /** Disable default copy ctor. */
+		Thread( const Thread& pre );
+
+        /** Disable default assignment operator. */
+		const Thread& operator= ( const Thread& pre );
+
+		/** Entry point of the platform thread. Calls run() of @a thread.*/
+#ifdef COLLADABU_OS_WIN
+		static unsigned int __stdcall threadFunction( void* thread );
+#else
+		static void* threadFunction( void* thread );
+#endif
+
+	};
+
+
+	/** The body of a loop executed by parallelFor().*/
+	class ParallelForBody
+	{
+	public:
+
+		/** Destructor.*/
+		virtual ~ParallelForBody() {}
+
+		/** Processes the iteration @a index.*/
+		virtual void process( size_t index ) = 0;
+	};
+
+	/** Calls process() of one of @a bodies for each index in 0..@a count - 1. The first body is
+	used on the calling thread, each other body on a new thread. The indices are taken one at a time,
+	so iterations of different cost are balanced among the threads. A body may be passed more than
+	once, if its process() may be called concurrently. If a thread can not be created, its indices are
+	processed by the other bodies. Returns after all iterations have been processed.*/
+	void parallelFor( size_t count, const std::vector<ParallelForBody*>& bodies );
+
+} // namespace COLLADABU
+
+#endif // __COLLADABU_THREAD_H__
@@ -0,0 +1,153 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADABUStableHeaders.h"
+#include "COLLADABUMemoryMappedFile.h"
+
+#ifdef COLLADABU_OS_WIN
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+
+namespace COLLADABU
+{
+
+	//------------------------------
+	MemoryMappedFile::MemoryMappedFile()
+		: mData(0)
+		, mSize(0)
+		, mIsOpen(false)
+		, mFileHandle(0)
+		, mMappingHandle(0)
+	{
+	}
+
+	//------------------------------
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		close();
+	}
+
+#ifdef COLLADABU_OS_WIN
+
+	//------------------------------
+	bool MemoryMappedFile::open( const NativeString& fileName )
+	{
+		close();
+
+		HANDLE file = CreateFileW( fileName.toWideString().c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0 );
+		if ( file == INVALID_HANDLE_VALUE )
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if ( !GetFileSizeEx( file, &fileSize ) || (unsigned long long)fileSize.QuadPart > (size_t)-1 )
+		{
+			CloseHandle( file );
+			return false;
+		}
+		mFileHandle = file;
+		mSize = (size_t)fileSize.QuadPart;
+		mIsOpen = true;
+
+		// empty files can not be mapped
+		if ( mSize == 0 )
+			return true;
+
+		HANDLE mapping = CreateFileMappingW( file, 0, PAGE_READONLY, 0, 0, 0 );
+		if ( !mapping )
+		{
+			close();
+			return false;
+		}
+		mMappingHandle = mapping;
+
+		mData = (const char*)MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		if ( !mData )
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	void MemoryMappedFile::close()
+	{
+		if ( mData )
+			UnmapViewOfFile( mData );
+		if ( mMappingHandle )
+			CloseHandle( (HANDLE)mMappingHandle );
+		if ( mFileHandle )
+			CloseHandle( (HANDLE)mFileHandle );
+		mData = 0;
+		mSize = 0;
+		mIsOpen = false;
+		mFileHandle = 0;
+		mMappingHandle = 0;
+	}
+
+#else
+
+	//------------------------------
+	bool MemoryMappedFile::open( const NativeString& fileName )
+	{
+		close();
+
+		int file = ::open( fileName.c_str(), O_RDONLY );
+		if ( file == -1 )
+			return false;
+
+		struct stat fileStatus;
+		if ( fstat( file, &fileStatus ) != 0 || !S_ISREG(fileStatus.st_mode) )
+		{
+			::close( file );
+			return false;
+		}
+		mSize = (size_t)fileStatus.st_size;
+
+		// empty files can not be mapped
+		if ( mSize > 0 )
+		{
+			void* data = mmap( 0, mSize, PROT_READ, MAP_PRIVATE, file, 0 );
+			if ( data == MAP_FAILED )
+			{
+				::close( file );
+				mSize = 0;
+				return false;
+			}
+			// the file is read front to back in most cases
+			madvise( data, mSize, MADV_SEQUENTIAL );
+			mData = (const char*)data;
+		}
+
+		// the mapping stays valid after the file has been closed
+		::close( file );
+		mIsOpen = true;
+		return true;
+	}
+
+	//------------------------------
+	void MemoryMappedFile::close()
+	{
+		if ( mData )
+			munmap( (void*)mData, mSize );
+		mData = 0;
+		mSize = 0;
+		mIsOpen = false;
+	}
+
+#endif
+
+} // namespace COLLADABU
@@ -0,0 +1,349 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADABUStableHeaders.h"
+#include "COLLADABUThread.h"
+
+#ifdef COLLADABU_OS_WIN
+#	include <windows.h>
+#	include <process.h>
+#else
+#	include <pthread.h>
+#	if defined(__linux__)
+#		include <unistd.h>
+#		include <sys/syscall.h>
+#	endif
+#endif
+
+
+namespace COLLADABU
+{
+
+#ifdef COLLADABU_OS_WIN
+
+	// Condition variables require Windows Vista or later.
+
+	//------------------------------
+	Mutex::Mutex()
+		: mHandle( new CRITICAL_SECTION )
+	{
+		InitializeCriticalSection( (CRITICAL_SECTION*)mHandle );
+	}
+
+	//------------------------------
+	Mutex::~Mutex()
+	{
+		DeleteCriticalSection( (CRITICAL_SECTION*)mHandle );
+		delete (CRITICAL_SECTION*)mHandle;
+	}
+
+	//------------------------------
+	void Mutex::lock()
+	{
+		EnterCriticalSection( (CRITICAL_SECTION*)mHandle );
+	}
+
+	//------------------------------
+	void Mutex::unlock()
+	{
+		LeaveCriticalSection( (CRITICAL_SECTION*)mHandle );
+	}
+
+	//------------------------------
+	Condition::Condition()
+		: mHandle( new CONDITION_VARIABLE )
+	{
+		InitializeConditionVariable( (CONDITION_VARIABLE*)mHandle );
+	}
+
+	//------------------------------
+	Condition::~Condition()
+	{
+		delete (CONDITION_VARIABLE*)mHandle;
+	}
+
+	//------------------------------
+	void Condition::wait( Mutex& mutex )
+	{
+		SleepConditionVariableCS( (CONDITION_VARIABLE*)mHandle, (CRITICAL_SECTION*)mutex.mHandle, INFINITE );
+	}
+
+	//------------------------------
+	void Condition::signal()
+	{
+		WakeConditionVariable( (CONDITION_VARIABLE*)mHandle );
+	}
+
+	//------------------------------
+	void Condition::broadcast()
+	{
+		WakeAllConditionVariable( (CONDITION_VARIABLE*)mHandle );
+	}
+
+	//------------------------------
+	bool Thread::start()
+	{
+		if ( mHandle )
+			return false;
+		mHandle = (void*)_beginthreadex( 0, 0, &Thread::threadFunction, this, 0, 0 );
+		return mHandle != 0;
+	}
+
+	//------------------------------
+	void Thread::join()
+	{
+		if ( !mHandle )
+			return;
+		WaitForSingleObject( (HANDLE)mHandle, INFINITE );
+		CloseHandle( (HANDLE)mHandle );
+		mHandle = 0;
+	}
+
+	//------------------------------
+	unsigned int __stdcall Thread::threadFunction( void* thread )
+	{
+		((Thread*)thread)->run();
+		return 0;
+	}
+
+	//------------------------------
+	unsigned long Thread::getCurrentThreadId()
+	{
+		return (unsigned long)GetCurrentThreadId();
+	}
+
+	//------------------------------
+	void AtomicFlag::set()
+	{
+		InterlockedExchange( &mValue, 1 );
+	}
+
+	//------------------------------
+	bool AtomicFlag::isSet() const
+	{
+		return InterlockedCompareExchange( const_cast<volatile long*>(&mValue), 0, 0 ) != 0;
+	}
+
+#else
+
+	//------------------------------
+	Mutex::Mutex()
+		: mHandle( new pthread_mutex_t )
+	{
+		pthread_mutex_init( (pthread_mutex_t*)mHandle, 0 );
+	}
+
+	//------------------------------
+	Mutex::~Mutex()
+	{
+		pthread_mutex_destroy( (pthread_mutex_t*)mHandle );
+		delete (pthread_mutex_t*)mHandle;
+	}
+
+	//------------------------------
+	void Mutex::lock()
+	{
+		pthread_mutex_lock( (pthread_mutex_t*)mHandle );
+	}
+
+	//------------------------------
+	void Mutex::unlock()
+	{
+		pthread_mutex_unlock( (pthread_mutex_t*)mHandle );
+	}
+
+	//------------------------------
+	Condition::Condition()
+		: mHandle( new pthread_cond_t )
+	{
+		pthread_cond_init( (pthread_cond_t*)mHandle, 0 );
+	}
+
+	//------------------------------
+	Condition::~Condition()
+	{
+		pthread_cond_destroy( (pthread_cond_t*)mHandle );
+		delete (pthread_cond_t*)mHandle;
+	}
+
+	//------------------------------
+	void Condition::wait( Mutex& mutex )
+	{
+		pthread_cond_wait( (pthread_cond_t*)mHandle, (pthread_mutex_t*)mutex.mHandle );
+	}
+
+	//------------------------------
+	void Condition::signal()
+	{
+		pthread_cond_signal( (pthread_cond_t*)mHandle );
+	}
+
+	//------------------------------
+	void Condition::broadcast()
+	{
+		pthread_cond_broadcast( (pthread_cond_t*)mHandle );
+	}
+
+	//------------------------------
+	bool Thread::start()
+	{
+		if ( mHandle )
+			return false;
+		pthread_t* thread = new pthread_t;
+		if ( pthread_create( thread, 0, &Thread::threadFunction, this ) != 0 )
+		{
+			delete thread;
+			return false;
+		}
+		mHandle = thread;
+		return true;
+	}
+
+	//------------------------------
+	void Thread::join()
+	{
+		if ( !mHandle )
+			return;
+		pthread_t* thread = (pthread_t*)mHandle;
+		pthread_join( *thread, 0 );
+		delete thread;
+		mHandle = 0;
+	}
+
+	//------------------------------
+	void* Thread::threadFunction( void* thread )
+	{
+		((Thread*)thread)->run();
+		return 0;
+	}
+
+	//------------------------------
+	unsigned long Thread::getCurrentThreadId()
+	{
+#if defined(__linux__)
+		// the kernel thread id, as shown by top, perf and the debugger
+		return (unsigned long)syscall( SYS_gettid );
+#else
+		return (unsigned long)(size_t)pthread_self();
+#endif
+	}
+
+	//------------------------------
+	void AtomicFlag::set()
+	{
+		__atomic_store_n( &mValue, 1, __ATOMIC_RELEASE );
+	}
+
+	//------------------------------
+	bool AtomicFlag::isSet() const
+	{
+		return __atomic_load_n( &mValue, __ATOMIC_ACQUIRE ) != 0;
+	}
+
+#endif
+
+	//------------------------------
+	Thread::Thread()
+		: mHandle(0)
+	{
+	}
+
+	//------------------------------
+	Thread::~Thread()
+	{
+		join();
+	}
+
+
+	namespace
+	{
+		/** Processes the iterations of a parallelFor(), that have not been taken by another thread.*/
+		class ParallelForThread : public Thread
+		{
+		private:
+			/** The body that processes the iterations.*/
+			ParallelForBody& mBody;
+
+			/** The number of iterations.*/
+			size_t mCount;
+
+			/** The index of the next iteration, that has not been taken by a thread.*/
+			size_t& mNextIndex;
+
+			/** Guards mNextIndex.*/
+			Mutex& mMutex;
+
+		public:
+			ParallelForThread( ParallelForBody& body, size_t count, size_t& nextIndex, Mutex& mutex )
+				: mBody( body )
+				, mCount( count )
+				, mNextIndex( nextIndex )
+				, mMutex( mutex )
+			{}
+
+			virtual ~ParallelForThread() { join(); }
+
+			/** Processes iterations until all have been taken.*/
+			void processIterations()
+			{
+				for ( ;; )
+				{
+					size_t index;
+					{
+						ScopedLock lock( mMutex );
+						index = mNextIndex++;
+					}
+					if ( index >= mCount )
+						return;
+					mBody.process( index );
+				}
+			}
+
+		protected:
+			virtual void run() { processIterations(); }
+
+		private:
+
+			/** Disable default copy ctor. */
+			ParallelForThread( const ParallelForThread& pre );
+
+			/** Disable default assignment operator. */
+			const ParallelForThread& operator= ( const ParallelForThread& pre );
+		};
+	}
+
+	//------------------------------
+	void parallelFor( size_t count, const std::vector<ParallelForBody*>& bodies )
+	{
+		if ( bodies.empty() )
+			return;
+
+		size_t nextIndex = 0;
+		Mutex mutex;
+		std::vector<ParallelForThread*> threads;
+		for ( size_t i = 1, bodyCount = bodies.size(); i < bodyCount && i < count; ++i )
+		{
+			ParallelForThread* thread = new ParallelForThread( *bodies[i], count, nextIndex, mutex );
+			if ( !thread->start() )
+			{
+				delete thread;
+				break;
+			}
+			threads.push_back( thread );
+		}
+
+		// the calling thread processes iterations as well
+		ParallelForThread( *bodies[0], count, nextIndex, mutex ).processIterations();
+
+		for ( size_t i = 0, threadCount = threads.size(); i < threadCount; ++i )
+			delete threads[i];
+	}
+
+} // namespace COLLADABU
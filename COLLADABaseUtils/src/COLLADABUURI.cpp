@@ -24,6 +24,45 @@ namespace COLLADABU
 	const int regExpMatchesVectorLength = 30;    /* should be a multiple of 3 */
 
 
+	/** The compiled patterns are created on first use. Function local statics are not initialized
+	thread safe by all supported compilers. Therefore UriPatternsInitializer below creates them during
+	static initialization, before any thread could be started. pcre_exec() does not modify a compiled
+	pattern, so the patterns can be used by multiple threads concurrently afterwards.*/
+	// regular expression: "(.*/)?(.*)?"
+	static pcre* getFindDirPattern()
+	{
+		static const PcreCompiledPattern findDirCompiledPattern("(.*/)?(.*)?");
+		return findDirCompiledPattern.getCompiledPattern();
+	}
+
+	// regular expression: "([^.]*)?(\.(.*))?"
+	static pcre* getFindExtPattern()
+	{
+		static const PcreCompiledPattern findExtCompiledPattern("([^.]*)?(\\.(.*))?");
+		return findExtCompiledPattern.getCompiledPattern();
+	}
+
+	// This regular expression for parsing URI references comes from the URI spec:
+	//   http://tools.ietf.org/html/rfc3986#appendix-B
+	// regular expression: "^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?"
+	static pcre* getMatchUriPattern()
+	{
+		static const PcreCompiledPattern matchUriCompiledPattern("^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\\?([^#]*))?(#(.*))?");
+		return matchUriCompiledPattern.getCompiledPattern();
+	}
+
+	/** Creates the compiled patterns during static initialization.*/
+	static struct UriPatternsInitializer
+	{
+		UriPatternsInitializer()
+		{
+			getFindDirPattern();
+			getFindExtPattern();
+			getMatchUriPattern();
+		}
+	} uriPatternsInitializer;
+
+
 	const String URI::SCHEME_FILE = "file";
 	const String URI::SCHEME_HTTP = "http";
 	const String URI::SCHEME_HTTPS = "https";
@@ -288,15 +327,8 @@ namespace COLLADABU
 			// The following implementation cannot handle paths like this:
 			// /tmp/se.3/file
 
-			// regular expression: "(.*/)?(.*)?"
-			static const PcreCompiledPattern findDirCompiledPattern("(.*/)?(.*)?");
-
-			pcre* findDir = findDirCompiledPattern.getCompiledPattern();
-
-
-			// regular expression: "([^.]*)?(\.(.*))?"
-			static const PcreCompiledPattern findExtCompiledPattern("([^.]*)?(\\.(.*))?");
-			pcre* findExt = findExtCompiledPattern.getCompiledPattern();
+			pcre* findDir = getFindDirPattern();
+			pcre* findExt = getFindExtPattern();
 			
 			String tmpFile;
 			dir.clear();
@@ -911,11 +943,7 @@ namespace COLLADABU
 		}
 
 
-		// This regular expression for parsing URI references comes from the URI spec:
-		//   http://tools.ietf.org/html/rfc3986#appendix-B
-		// regular expression: "^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?"
-		static const PcreCompiledPattern matchUriCompiledPattern("^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\\?([^#]*))?(#(.*))?");
-		pcre* matchUri = matchUriCompiledPattern.getCompiledPattern();
+		pcre* matchUri = getMatchUriPattern();
 
 
 		int uriMatches[regExpMatchesVectorLength];
@@ -48,7 +48,7 @@ namespace COLLADABU
             else
             {
                 // |w| <= 1/2
-                static size_t s_iNext[ 3 ] = { 1, 2, 0 };
+                static const size_t s_iNext[ 3 ] = { 1, 2, 0 };
                 size_t i = 0;
 
                 if ( kRot[ 1 ][ 1 ] > kRot[ 0 ][ 0 ] )
@@ -0,0 +1,178 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABENCHMARK_COMMON_H__
+#define __COLLADABENCHMARK_COMMON_H__
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Benchmark
+{
+
+	/** Returns a pseudo random number in 0..1, that is the same on all platforms.*/
+	double getRandom( unsigned int& seed );
+
+
+	/** Measures the fastest of several runs. Each run is enclosed by start() and stop().*/
+	class Stopwatch
+	{
+	private:
+		/** The time the current run started, in seconds.*/
+		double mStart;
+
+		/** The duration of the fastest run so far, in seconds.*/
+		double mBest;
+
+	public:
+
+		/** Constructor.*/
+		Stopwatch();
+
+		/** Starts a run.*/
+		void start();
+
+		/** Ends the run started by the last start().*/
+		void stop();
+
+		/** The duration of the fastest run in seconds.*/
+		double getSeconds() const { return mBest; }
+
+		/** The duration of the fastest run in milliseconds.*/
+		double getMilliSeconds() const { return mBest * 1000.0; }
+	};
+
+
+	/** The result of one implementation measured by a micro benchmark.*/
+	struct Result
+	{
+		/** Constructor. Creates the result of the implementation @a name on @a threads threads.
+		The time is infinite and the result is identical to the reference, until the measurement
+		sets them.*/
+		Result( const std::string& name, size_t threads = 1 );
+
+		/** The name of the implementation.*/
+		std::string implementation;
+
+		/** The number of threads the implementation ran on.*/
+		size_t threadCount;
+
+		/** The duration of the fastest run in milliseconds.*/
+		double milliSeconds;
+
+		/** The number of items processed by one run, e.g. vertices or samples.*/
+		size_t itemCount;
+
+		/** The largest difference of a value to the reference.*/
+		double maxDifference;
+
+		/** True, if the values match the reference within the accepted difference.*/
+		bool identical;
+	};
+
+	typedef std::vector<Result> Results;
+
+	/** Returns true, if all @a results are identical to their references.*/
+	bool allIdentical( const Results& results );
+
+	/** Prints @a results as table. @a itemName is the name of the processed items in plural, the
+	throughput is reported as million items per second.*/
+	void printResults( const char* itemName, const Results& results );
+
+
+	/** The parameters of a benchmark run, e.g. the number of generated objects, as written to the
+	JSON results.*/
+	typedef std::vector< std::pair<std::string, size_t> > Parameters;
+
+	/** Adds the parameter @a name with @a value to @a parameters.*/
+	void addParameter( Parameters& parameters, const char* name, size_t value );
+
+	/** Writes the beginning of the JSON results of @a benchmarkName up to the opening bracket of
+	the results array. Each result is written as object on its own line, preceded by ",\n" if
+	it is not the first one.*/
+	void writeJsonBegin( std::ostream& stream, const char* benchmarkName, const Parameters& parameters );
+
+	/** Closes the results array and the object opened by writeJsonBegin().*/
+	void writeJsonEnd( std::ostream& stream );
+
+	/** Writes @a text to the file @a fileName.
+	@return True on success. Otherwise an error is reported on stderr.*/
+	bool writeFile( const std::string& fileName, const std::string& text );
+
+	/** Writes @a parameters and @a results of @a benchmarkName as JSON to the file @a fileName.
+	@a itemName is the key of the item count of each result.
+	@return True on success. Otherwise an error is reported on stderr.*/
+	bool writeJsonFile( const std::string& fileName, const char* benchmarkName, const Parameters& parameters, const char* itemName, const Results& results );
+
+
+	/** Parses the command line of a micro benchmark. Each option is a flag followed by a count.
+	All benchmarks accept "-r <count>" for the number of runs of each implementation and
+	"-j <file>" to write the results as JSON.*/
+	class Options
+	{
+	private:
+		struct Option
+		{
+			const char* flag;
+			size_t* value;
+			size_t defaultValue;
+			const char* description;
+			bool mayBeZero;
+		};
+
+		typedef std::vector<Option> OptionList;
+
+		/** Describes what the benchmark measures, printed by the help text.*/
+		const char* mDescription;
+
+		/** The options added by the benchmark.*/
+		OptionList mOptions;
+
+		/** The number of runs of each implementation.*/
+		size_t mRepetitions;
+
+		/** The default number of runs of each implementation.*/
+		size_t mDefaultRepetitions;
+
+		/** The file the results are written to as JSON or empty.*/
+		std::string mJsonFileName;
+
+	public:
+
+		/** Constructor. @a description describes what the benchmark measures, each implementation
+		is run @a defaultRepetitions times by default.*/
+		Options( const char* description, int defaultRepetitions );
+
+		/** Adds the option @a flag, e.g. "-c", whose count is stored in @a value. The current
+		value is the default. Unless @a mayBeZero is true, 0 is rejected and the default is appended
+		to @a description in the help text.*/
+		void add( const char* flag, size_t& value, const char* description, bool mayBeZero = false );
+
+		/** Parses the command line. If it contains an unknown option or an invalid count, the help
+		text is printed.
+		@return False, if the help text has been printed.*/
+		bool parse( int argc, char* argv[] );
+
+		/** The number of runs of each implementation.*/
+		int getRepetitions() const { return (int)mRepetitions; }
+
+		/** The file the results are written to as JSON or empty.*/
+		const std::string& getJsonFileName() const { return mJsonFileName; }
+
+		/** Prints the usage of the benchmark, e.g. if a count is out of range.*/
+		void printHelpText( const char* programName ) const;
+	};
+
+} // namespace Benchmark
+
+#endif // __COLLADABENCHMARK_COMMON_H__
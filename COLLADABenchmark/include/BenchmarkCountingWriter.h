@@ -0,0 +1,123 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABENCHMARK_COUNTINGWRITER_H__
+#define __COLLADABENCHMARK_COUNTINGWRITER_H__
+
+#include "COLLADAFWIWriter.h"
+#include "COLLADAFWGeometry.h"
+#include "COLLADAFWMesh.h"
+
+
+namespace Benchmark
+{
+
+	/** A writer, that only counts the objects it receives, so the load benchmark measures the loader
+	and not the processing of the loaded data. The counts are compared between runs to detect loads
+	that fail silently.*/
+	class CountingWriter : public COLLADAFW::IWriter
+	{
+	public:
+		/** The number of objects of each kind passed to the writer.*/
+		struct Counts
+		{
+			size_t geometries;
+			size_t faces;
+			size_t visualScenes;
+			size_t libraryNodes;
+			size_t controllers;
+			size_t skinControllerData;
+			size_t animations;
+			size_t animationLists;
+			size_t others;
+
+			Counts() : geometries(0), faces(0), visualScenes(0), libraryNodes(0), controllers(0), skinControllerData(0), animations(0), animationLists(0), others(0) {}
+		};
+
+	private:
+		/** The number of objects of each kind passed to the writer.*/
+		Counts mCounts;
+
+		/** True, if cancel() has been called.*/
+		bool mCanceled;
+
+	public:
+		CountingWriter() : mCanceled(false) {}
+		virtual ~CountingWriter() {}
+
+		/** The number of objects of each kind passed to the writer.*/
+		const Counts& getCounts() const { return mCounts; }
+
+		/** True, if the loader canceled loading.*/
+		bool isCanceled() const { return mCanceled; }
+
+		/** The values are not read, so they are passed as they have been loaded.*/
+		virtual bool acceptsQuantizedValues() const { return true; }
+
+		virtual void cancel( const COLLADAFW::String& /*errorMessage*/ ) { mCanceled = true; }
+
+		virtual void start() {}
+
+		virtual void finish() {}
+
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* /*asset*/ ) { mCounts.others++; return true; }
+
+		virtual bool writeScene( const COLLADAFW::Scene* /*scene*/ ) { mCounts.others++; return true; }
+
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* /*visualScene*/ ) { mCounts.visualScenes++; return true; }
+
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* /*libraryNodes*/ ) { mCounts.libraryNodes++; return true; }
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry )
+		{
+			mCounts.geometries++;
+			if ( geometry->getType() == COLLADAFW::Geometry::GEO_TYPE_MESH )
+			{
+				const COLLADAFW::MeshPrimitiveArray& primitives = ((const COLLADAFW::Mesh*)geometry)->getMeshPrimitives();
+				for ( size_t i = 0, count = primitives.getCount(); i < count; ++i )
+					mCounts.faces += primitives[i]->getFaceCount();
+			}
+			return true;
+		}
+
+		virtual bool writeMaterial( const COLLADAFW::Material* /*material*/ ) { mCounts.others++; return true; }
+
+		virtual bool writeEffect( const COLLADAFW::Effect* /*effect*/ ) { mCounts.others++; return true; }
+
+		virtual bool writeCamera( const COLLADAFW::Camera* /*camera*/ ) { mCounts.others++; return true; }
+
+		virtual bool writeImage( const COLLADAFW::Image* /*image*/ ) { mCounts.others++; return true; }
+
+		virtual bool writeLight( const COLLADAFW::Light* /*light*/ ) { mCounts.others++; return true; }
+
+		virtual bool writeAnimation( const COLLADAFW::Animation* /*animation*/ ) { mCounts.animations++; return true; }
+
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* /*animationList*/ ) { mCounts.animationLists++; return true; }
+
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* /*skinControllerData*/ ) { mCounts.skinControllerData++; return true; }
+
+		virtual bool writeController( const COLLADAFW::Controller* /*controller*/ ) { mCounts.controllers++; return true; }
+
+		virtual bool writeFormulas( const COLLADAFW::Formulas* /*formulas*/ ) { mCounts.others++; return true; }
+
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* /*kinematicsScene*/ ) { mCounts.others++; return true; }
+
+	private:
+
+        /** Disable default copy ctor. */
+		CountingWriter( const CountingWriter& pre );
+
+        /** Disable default assignment operator. */
+		const CountingWriter& operator= ( const CountingWriter& pre );
+	};
+
+} // namespace Benchmark
+
+#endif // __COLLADABENCHMARK_COUNTINGWRITER_H__
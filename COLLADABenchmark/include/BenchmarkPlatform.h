@@ -0,0 +1,38 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABENCHMARK_PLATFORM_H__
+#define __COLLADABENCHMARK_PLATFORM_H__
+
+#include <string>
+
+
+namespace Benchmark
+{
+
+	/** Returns the time in seconds since an arbitrary point in the past, measured by a monotonic
+	high resolution clock.*/
+	double getTime();
+
+	/** Resets the peak resident set size of the process to its current resident set size, so
+	getPeakMemory() reports the peak of the following operations only.
+	@return True, if the peak could be reset. If not, getPeakMemory() reports the peak since the
+	start of the process.*/
+	bool resetPeakMemory();
+
+	/** Returns the peak resident set size of the process in bytes, or 0, if it is not available.*/
+	size_t getPeakMemory();
+
+	/** Returns the size of the file @a fileName in bytes, or 0, if it does not exist.*/
+	size_t getFileSize( const std::string& fileName );
+
+} // namespace Benchmark
+
+#endif // __COLLADABENCHMARK_PLATFORM_H__
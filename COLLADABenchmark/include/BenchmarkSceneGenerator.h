@@ -0,0 +1,124 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABENCHMARK_SCENEGENERATOR_H__
+#define __COLLADABENCHMARK_SCENEGENERATOR_H__
+
+#include "COLLADASWStreamWriter.h"
+
+#include <string>
+#include <vector>
+
+
+namespace Benchmark
+{
+
+	/** Writes deterministic synthetic COLLADA documents through COLLADAStreamWriter. The same options
+	always produce byte identical documents, so results of different builds can be compared.
+	A scene consists of one triangle mesh, instantiated by every node of a node tree. If skin joints
+	are requested, the mesh is skinned to a chain of joints and the nodes instantiate the skin
+	controller instead. Animation channels animate the transformations of the nodes. Each external
+	reference is a separate document containing another mesh, instantiated by one of the nodes.*/
+	class SceneGenerator
+	{
+	public:
+		/** The parameters of a generated scene.*/
+		struct Options
+		{
+			/** The number of triangles of each mesh.*/
+			size_t triangleCount;
+
+			/** The number of nodes in the visual scene, not counting the joints.*/
+			size_t nodeCount;
+
+			/** The number of animated transformation parameters.*/
+			size_t animationChannelCount;
+
+			/** The number of keys of each animation channel.*/
+			size_t animationKeyCount;
+
+			/** The number of joints the mesh is skinned to. 0 writes no skin controller.*/
+			size_t skinJointCount;
+
+			/** The number of documents referenced from the main document.*/
+			size_t externalReferenceCount;
+
+			/** The COLLADA version of the documents.*/
+			COLLADASW::StreamWriter::COLLADAVersion version;
+
+			Options();
+		};
+
+	private:
+		/** The parameters of the scene.*/
+		Options mOptions;
+
+		/** The seed of the pseudo random numbers.*/
+		unsigned int mRandomState;
+
+	public:
+
+		/** Constructor. */
+		SceneGenerator( const Options& options );
+
+		/** Destructor. */
+		virtual ~SceneGenerator();
+
+		/** Writes the main document to @a fileName and the external documents next to it.
+		@param writtenFiles Receives the names of all written files, the main document first.
+		@return True on success, false if a file could not be written.*/
+		bool generate( const std::string& fileName, std::vector<std::string>& writtenFiles );
+
+	private:
+
+        /** Disable default copy ctor. */
+		SceneGenerator( const SceneGenerator& pre );
+
+        /** Disable default assignment operator. */
+		const SceneGenerator& operator= ( const SceneGenerator& pre );
+
+		/** Returns the file name of the external document @a index, relative to the main document.*/
+		static std::string getExternalFileName( const std::string& fileName, size_t index );
+
+		/** Writes the document with the main scene.*/
+		void writeMainDocument( COLLADASW::StreamWriter& streamWriter, const std::string& fileName );
+
+		/** Writes a document, that is referenced from the main document. All referenced documents
+		are identical.*/
+		void writeExternalDocument( COLLADASW::StreamWriter& streamWriter );
+
+		/** Writes the asset element.*/
+		void writeAsset( COLLADASW::StreamWriter& streamWriter );
+
+		/** Writes a library_geometries element containing one mesh with id @a geometryId.*/
+		void writeGeometries( COLLADASW::StreamWriter& streamWriter, const std::string& geometryId );
+
+		/** Writes the skin controller and its library.*/
+		void writeControllers( COLLADASW::StreamWriter& streamWriter );
+
+		/** Writes the library_animations element.*/
+		void writeAnimations( COLLADASW::StreamWriter& streamWriter );
+
+		/** Writes the node @a index and its children.*/
+		void writeNode( COLLADASW::StreamWriter& streamWriter, const std::string& fileName, size_t index );
+
+		/** Writes the library_visual_scenes element.*/
+		void writeVisualScenes( COLLADASW::StreamWriter& streamWriter, const std::string& fileName );
+
+		/** The number of vertices along one side of the vertex grid of each mesh.*/
+		size_t getGridSize() const;
+
+		/** Returns the next pseudo random number in [ @a min, @a max ).*/
+		double random( double min, double max );
+	};
+
+} // namespace Benchmark
+
+#endif // __COLLADABENCHMARK_SCENEGENERATOR_H__
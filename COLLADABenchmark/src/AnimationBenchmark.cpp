@@ -0,0 +1,331 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+	Measures how fast animation curves are baked into frames. COLLADAFW::AnimationSampler is
+	compared with evaluating each curve at each frame on its own, with a binary search for the key
+	interval and a switch over the interpolation type, as the writers of the tree do. The generated
+	curves mix linear, step, Bezier and Hermite intervals with one and three output dimensions.
+	Both bake the frames in batches into a buffer of one float array per channel. The baked values
+	of both are compared frame by frame, so a faster but wrong result is reported as failure.
+*/
+
+#include "BenchmarkCommon.h"
+
+#include "COLLADAFWAnimationSampler.h"
+#include "COLLADAFWAnimationCurve.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+
+namespace
+{
+	/** The default number of generated curves.*/
+	const size_t DEFAULT_CURVE_COUNT = 10000;
+
+	/** The default number of baked frames.*/
+	const size_t DEFAULT_FRAME_COUNT = 10000;
+
+	/** The number of times each approach is measured. The fastest run is reported.*/
+	const int DEFAULT_REPETITIONS = 3;
+
+	/** The number of frames baked at once.*/
+	const size_t BATCH_FRAME_COUNT = 256;
+
+	/** The frames per second of the baked animation.*/
+	const double FRAMES_PER_SECOND = 30.0;
+
+	/** The largest difference of a baked value to the reference, that is not reported as failure.*/
+	const double MAX_DIFFERENCE = 1e-4;
+
+
+	typedef std::vector<COLLADAFW::AnimationCurve*> AnimationCurveList;
+
+
+	//------------------------------
+	/** Makes @a array a float array with room for @a count values and returns the float values.*/
+	COLLADAFW::FloatArray& allocFloatValues( COLLADAFW::FloatOrDoubleArray& array, size_t count )
+	{
+		array.setType( COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT );
+		COLLADAFW::FloatArray& values = *array.getFloatValues();
+		values.allocMemory( count );
+		return values;
+	}
+
+	//------------------------------
+	/** Creates a curve with keys from time 0 up to @a duration. The interpolation type and the
+	dimension depend on @a curveIndex.*/
+	COLLADAFW::AnimationCurve* createCurve( size_t curveIndex, double duration, unsigned int& seed )
+	{
+		COLLADAFW::AnimationCurve* curve = new COLLADAFW::AnimationCurve( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::ANIMATION, curveIndex, 0 ) );
+		const size_t dimension = curveIndex % 4 == 3 ? 3 : 1;
+		const size_t keyCount = 2 + (size_t)( Benchmark::getRandom( seed ) * 30 );
+		curve->setOutDimension( dimension );
+
+		static const COLLADAFW::AnimationCurve::InterpolationType interpolationTypes[] = {
+			COLLADAFW::AnimationCurve::INTERPOLATION_LINEAR,
+			COLLADAFW::AnimationCurve::INTERPOLATION_BEZIER,
+			COLLADAFW::AnimationCurve::INTERPOLATION_STEP,
+			COLLADAFW::AnimationCurve::INTERPOLATION_HERMITE,
+			COLLADAFW::AnimationCurve::INTERPOLATION_MIXED };
+		const COLLADAFW::AnimationCurve::InterpolationType interpolationType = interpolationTypes[curveIndex % 5];
+		curve->setInterpolationType( interpolationType );
+
+		COLLADAFW::FloatArray& times = allocFloatValues( curve->getInputValues(), keyCount );
+		COLLADAFW::FloatArray& values = allocFloatValues( curve->getOutputValues(), keyCount * dimension );
+		COLLADAFW::FloatArray& inTangents = allocFloatValues( curve->getInTangentValues(), 2 * keyCount * dimension );
+		COLLADAFW::FloatArray& outTangents = allocFloatValues( curve->getOutTangentValues(), 2 * keyCount * dimension );
+		for ( size_t key = 0; key < keyCount; ++key )
+		{
+			const double time = duration * key / ( keyCount - 1 );
+			const double previousTime = key > 0 ? duration * ( key - 1 ) / ( keyCount - 1 ) : time;
+			const double nextTime = key + 1 < keyCount ? duration * ( key + 1 ) / ( keyCount - 1 ) : time;
+			times.append( (float)time );
+			for ( size_t d = 0; d < dimension; ++d )
+			{
+				const double value = Benchmark::getRandom( seed ) * 20 - 10;
+				values.append( (float)value );
+				if ( interpolationType == COLLADAFW::AnimationCurve::INTERPOLATION_HERMITE )
+				{
+					const double slope = ( Benchmark::getRandom( seed ) - 0.5 ) * 8;
+					inTangents.append( (float)( time - previousTime ) );
+					inTangents.append( (float)( slope * ( time - previousTime ) ) );
+					outTangents.append( (float)( nextTime - time ) );
+					outTangents.append( (float)( slope * ( nextTime - time ) ) );
+				}
+				else
+				{
+					// uneven control times, so that the time of the Bezier intervals has to be solved
+					const double inWeight = 0.1 + Benchmark::getRandom( seed ) * 0.5;
+					const double outWeight = 0.1 + Benchmark::getRandom( seed ) * 0.5;
+					const double slope = ( Benchmark::getRandom( seed ) - 0.5 ) * 8;
+					inTangents.append( (float)( time - inWeight * ( time - previousTime ) ) );
+					inTangents.append( (float)( value - slope * inWeight * ( time - previousTime ) ) );
+					outTangents.append( (float)( time + outWeight * ( nextTime - time ) ) );
+					outTangents.append( (float)( value + slope * outWeight * ( nextTime - time ) ) );
+				}
+			}
+			// the tangents of mixed curves are Bezier control points, so Hermite intervals are left out
+			if ( interpolationType == COLLADAFW::AnimationCurve::INTERPOLATION_MIXED )
+				curve->getInterpolationTypes().append( interpolationTypes[key % 3] );
+		}
+		return curve;
+	}
+
+	//------------------------------
+	/** Returns the value at @a parameter of the one dimensional cubic Bezier curve with the
+	control points @a p0, @a p1, @a p2 and @a p3.*/
+	double bezier( double p0, double p1, double p2, double p3, double parameter )
+	{
+		const double inverse = 1 - parameter;
+		return inverse * inverse * inverse * p0 + 3 * inverse * inverse * parameter * p1 + 3 * inverse * parameter * parameter * p2 + parameter * parameter * parameter * p3;
+	}
+
+	//------------------------------
+	/** Evaluates dimension @a d of @a curve at @a time the straightforward way.*/
+	double evaluateCurve( const COLLADAFW::AnimationCurve& curve, size_t d, double time )
+	{
+		const float* times = curve.getInputValues().getFloatValues()->getData();
+		const float* values = curve.getOutputValues().getFloatValues()->getData();
+		const size_t keyCount = curve.getKeyCount();
+		const size_t dimension = curve.getOutDimension();
+		if ( time <= times[0] )
+			return values[d];
+		if ( time >= times[keyCount - 1] )
+			return values[( keyCount - 1 ) * dimension + d];
+
+		const size_t key = ( std::upper_bound( times, times + keyCount, time ) - times ) - 1;
+		const double startTime = times[key];
+		const double endTime = times[key + 1];
+		const double startValue = values[key * dimension + d];
+		const double endValue = values[( key + 1 ) * dimension + d];
+		const double parameter = ( time - startTime ) / ( endTime - startTime );
+
+		COLLADAFW::AnimationCurve::InterpolationType interpolationType = curve.getInterpolationType();
+		if ( interpolationType == COLLADAFW::AnimationCurve::INTERPOLATION_MIXED )
+			interpolationType = curve.getInterpolationTypes()[key];
+		switch ( interpolationType )
+		{
+		case COLLADAFW::AnimationCurve::INTERPOLATION_STEP:
+			return startValue;
+		case COLLADAFW::AnimationCurve::INTERPOLATION_BEZIER:
+		case COLLADAFW::AnimationCurve::INTERPOLATION_HERMITE:
+			{
+				const float* inTangents = curve.getInTangentValues().getFloatValues()->getData();
+				const float* outTangents = curve.getOutTangentValues().getFloatValues()->getData();
+				double startControlTime = outTangents[2 * ( key * dimension + d )];
+				double startControlValue = outTangents[2 * ( key * dimension + d ) + 1];
+				double endControlTime = inTangents[2 * ( ( key + 1 ) * dimension + d )];
+				double endControlValue = inTangents[2 * ( ( key + 1 ) * dimension + d ) + 1];
+				if ( interpolationType == COLLADAFW::AnimationCurve::INTERPOLATION_HERMITE )
+				{
+					startControlTime = startTime + startControlTime / 3;
+					startControlValue = startValue + startControlValue / 3;
+					endControlTime = endTime - endControlTime / 3;
+					endControlValue = endValue - endControlValue / 3;
+				}
+				// bisection of the monotonic time curve
+				double low = 0;
+				double high = 1;
+				for ( int iteration = 0; iteration < 40; ++iteration )
+				{
+					const double middle = ( low + high ) / 2;
+					if ( bezier( startTime, startControlTime, endControlTime, endTime, middle ) < time )
+						low = middle;
+					else
+						high = middle;
+				}
+				return bezier( startValue, startControlValue, endControlValue, endValue, ( low + high ) / 2 );
+			}
+		default:
+			return startValue + ( endValue - startValue ) * parameter;
+		}
+	}
+
+	//------------------------------
+	/** Bakes the frames from @a firstFrame to @a firstFrame + @a frameCount of all @a curves into
+	@a buffer, one array of BATCH_FRAME_COUNT floats per channel, evaluating each sample on its own.*/
+	void bakeCurves( const AnimationCurveList& curves, size_t firstFrame, size_t frameCount, float* buffer )
+	{
+		for ( size_t i = 0, count = curves.size(); i < count; ++i )
+		{
+			const COLLADAFW::AnimationCurve& curve = *curves[i];
+			for ( size_t d = 0, dimension = curve.getOutDimension(); d < dimension; ++d )
+			{
+				for ( size_t frame = 0; frame < frameCount; ++frame )
+					buffer[frame] = (float)evaluateCurve( curve, d, ( firstFrame + frame ) / FRAMES_PER_SECOND );
+				buffer += BATCH_FRAME_COUNT;
+			}
+		}
+	}
+
+	//------------------------------
+	/** Bakes the frames from @a firstFrame to @a firstFrame + @a frameCount of @a sampler into
+	@a buffer, one array of BATCH_FRAME_COUNT floats per channel.*/
+	void bakeSampler( const COLLADAFW::AnimationSampler& sampler, size_t firstFrame, size_t frameCount, float* buffer )
+	{
+		double times[BATCH_FRAME_COUNT];
+		for ( size_t frame = 0; frame < frameCount; ++frame )
+			times[frame] = ( firstFrame + frame ) / FRAMES_PER_SECOND;
+		sampler.sample( times, frameCount, buffer, BATCH_FRAME_COUNT );
+	}
+
+	//------------------------------
+	/** Returns the largest difference of the values of @a channelCount channels of @a frameCount
+	frames in @a buffer1 and @a buffer2.*/
+	double getMaxDifference( const std::vector<float>& buffer1, const std::vector<float>& buffer2, size_t channelCount, size_t frameCount )
+	{
+		double maxDifference = 0;
+		for ( size_t channel = 0; channel < channelCount; ++channel )
+			for ( size_t frame = 0; frame < frameCount; ++frame )
+				maxDifference = std::max( maxDifference, fabs( (double)buffer1[channel * BATCH_FRAME_COUNT + frame] - buffer2[channel * BATCH_FRAME_COUNT + frame] ) );
+		return maxDifference;
+	}
+
+	//------------------------------
+	void measureCurves( const AnimationCurveList& curves, size_t channelCount, size_t frameCount, int repetitions, Benchmark::Results& results )
+	{
+		Benchmark::Result result( "per sample search and switch" );
+		result.itemCount = channelCount * frameCount;
+		std::vector<float> buffer( channelCount * BATCH_FRAME_COUNT );
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			stopwatch.start();
+			for ( size_t firstFrame = 0; firstFrame < frameCount; firstFrame += BATCH_FRAME_COUNT )
+				bakeCurves( curves, firstFrame, std::min( BATCH_FRAME_COUNT, frameCount - firstFrame ), &buffer[0] );
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+		results.push_back( result );
+	}
+
+	//------------------------------
+	void measureSampler( const AnimationCurveList& curves, size_t channelCount, size_t frameCount, int repetitions, Benchmark::Results& results )
+	{
+		Benchmark::Result result( "AnimationSampler" );
+		result.itemCount = channelCount * frameCount;
+		COLLADAFW::AnimationSampler sampler;
+		for ( size_t i = 0; i < curves.size(); ++i )
+			sampler.addCurve( *curves[i] );
+
+		std::vector<float> buffer( channelCount * BATCH_FRAME_COUNT );
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			stopwatch.start();
+			for ( size_t firstFrame = 0; firstFrame < frameCount; firstFrame += BATCH_FRAME_COUNT )
+				bakeSampler( sampler, firstFrame, std::min( BATCH_FRAME_COUNT, frameCount - firstFrame ), &buffer[0] );
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+
+		// compare all frames with the reference, outside of the measurement
+		std::vector<float> reference( channelCount * BATCH_FRAME_COUNT );
+		for ( size_t firstFrame = 0; firstFrame < frameCount; firstFrame += BATCH_FRAME_COUNT )
+		{
+			const size_t batchFrameCount = std::min( BATCH_FRAME_COUNT, frameCount - firstFrame );
+			bakeCurves( curves, firstFrame, batchFrameCount, &reference[0] );
+			bakeSampler( sampler, firstFrame, batchFrameCount, &buffer[0] );
+			result.maxDifference = std::max( result.maxDifference, getMaxDifference( reference, buffer, channelCount, batchFrameCount ) );
+		}
+		result.identical = result.maxDifference <= MAX_DIFFERENCE && sampler.getChannelCount() == channelCount;
+		results.push_back( result );
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	size_t curveCount = DEFAULT_CURVE_COUNT;
+	size_t frameCount = DEFAULT_FRAME_COUNT;
+	Benchmark::Options options( "Measures the baking of animation curves into frames and compares\n"
+		"COLLADAFW::AnimationSampler with evaluating each sample on its own.", DEFAULT_REPETITIONS );
+	options.add( "-c", curveCount, "generated curves" );
+	options.add( "-f", frameCount, "baked frames" );
+	if ( !options.parse( argc, argv ) )
+		return 2;
+	const int repetitions = options.getRepetitions();
+
+	// the keys end a second before the last frame, so that the constant end of the curves is baked too
+	const double duration = std::max( frameCount / FRAMES_PER_SECOND - 1, 1.0 );
+	unsigned int seed = 1;
+	AnimationCurveList curves;
+	size_t channelCount = 0;
+	for ( size_t i = 0; i < curveCount; ++i )
+	{
+		curves.push_back( createCurve( i, duration, seed ) );
+		channelCount += curves.back()->getOutDimension();
+	}
+
+	Benchmark::Results results;
+	measureCurves( curves, channelCount, frameCount, repetitions, results );
+	measureSampler( curves, channelCount, frameCount, repetitions, results );
+	for ( size_t i = 0; i < curves.size(); ++i )
+		delete curves[i];
+
+	printf( "%u curves with %u channels, %u frames\n", (unsigned int)curveCount, (unsigned int)channelCount, (unsigned int)frameCount );
+	Benchmark::printResults( "samples", results );
+
+	if ( !options.getJsonFileName().empty() )
+	{
+		Benchmark::Parameters parameters;
+		Benchmark::addParameter( parameters, "curves", curveCount );
+		Benchmark::addParameter( parameters, "channels", channelCount );
+		Benchmark::addParameter( parameters, "frames", frameCount );
+		Benchmark::addParameter( parameters, "repetitions", repetitions );
+		if ( !Benchmark::writeJsonFile( options.getJsonFileName(), "OpenCOLLADAAnimationBenchmark", parameters, "samples", results ) )
+			return 1;
+	}
+	return Benchmark::allIdentical( results ) ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "BenchmarkCommon.h"
+#include "BenchmarkPlatform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+namespace Benchmark
+{
+
+	//------------------------------
+	double getRandom( unsigned int& seed )
+	{
+		seed = seed * 1103515245u + 12345u;
+		return ( ( seed >> 8 ) & 0xffff ) / 65535.0;
+	}
+
+	//------------------------------
+	Stopwatch::Stopwatch()
+		: mStart( 0 )
+		, mBest( HUGE_VAL )
+	{
+	}
+
+	//------------------------------
+	void Stopwatch::start()
+	{
+		mStart = getTime();
+	}
+
+	//------------------------------
+	void Stopwatch::stop()
+	{
+		const double seconds = getTime() - mStart;
+		if ( seconds < mBest )
+			mBest = seconds;
+	}
+
+	//------------------------------
+	Result::Result( const std::string& name, size_t threads )
+		: implementation( name )
+		, threadCount( threads )
+		, milliSeconds( HUGE_VAL )
+		, itemCount( 0 )
+		, maxDifference( 0 )
+		, identical( true )
+	{
+	}
+
+	//------------------------------
+	bool allIdentical( const Results& results )
+	{
+		for ( size_t i = 0; i < results.size(); ++i )
+		{
+			if ( !results[i].identical )
+				return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	void printResults( const char* itemName, const Results& results )
+	{
+		const std::string throughput = std::string( "M" ) + itemName + "/s";
+		printf( "%-40s %8s %12s %16s %16s %10s\n", "implementation", "threads", "ms", throughput.c_str(), "max difference", "identical" );
+		for ( size_t i = 0; i < results.size(); ++i )
+		{
+			const Result& result = results[i];
+			printf( "%-40s %8u %12.2f %16.2f %16.3g %10s\n", result.implementation.c_str(), (unsigned int)result.threadCount, result.milliSeconds,
+				result.itemCount / ( result.milliSeconds * 1000.0 ), result.maxDifference, result.identical ? "yes" : "NO" );
+		}
+	}
+
+	//------------------------------
+	void addParameter( Parameters& parameters, const char* name, size_t value )
+	{
+		parameters.push_back( std::make_pair( std::string( name ), value ) );
+	}
+
+	//------------------------------
+	void writeJsonBegin( std::ostream& stream, const char* benchmarkName, const Parameters& parameters )
+	{
+		stream << "{\n";
+		stream << "  \"benchmark\": \"" << benchmarkName << "\",\n";
+		for ( size_t i = 0; i < parameters.size(); ++i )
+			stream << "  \"" << parameters[i].first << "\": " << parameters[i].second << ",\n";
+		stream << "  \"results\": [";
+	}
+
+	//------------------------------
+	void writeJsonEnd( std::ostream& stream )
+	{
+		stream << "\n  ]\n}\n";
+	}
+
+	//------------------------------
+	bool writeFile( const std::string& fileName, const std::string& text )
+	{
+		std::ofstream file( fileName.c_str() );
+		file << text;
+		file.close();
+		if ( !file )
+		{
+			std::cerr << "Could not write \"" << fileName << "\"." << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	bool writeJsonFile( const std::string& fileName, const char* benchmarkName, const Parameters& parameters, const char* itemName, const Results& results )
+	{
+		std::ostringstream stream;
+		writeJsonBegin( stream, benchmarkName, parameters );
+		for ( size_t i = 0; i < results.size(); ++i )
+		{
+			const Result& result = results[i];
+			stream << ( i == 0 ? "\n" : ",\n" );
+			stream << "    { \"implementation\": \"" << result.implementation << "\""
+				<< ", \"threads\": " << result.threadCount
+				<< ", \"ms\": " << result.milliSeconds
+				<< ", \"" << itemName << "\": " << result.itemCount
+				<< ", \"maxDifference\": " << result.maxDifference
+				<< ", \"identical\": " << ( result.identical ? "true" : "false" ) << " }";
+		}
+		writeJsonEnd( stream );
+		return writeFile( fileName, stream.str() );
+	}
+
+	//------------------------------
+	Options::Options( const char* description, int defaultRepetitions )
+		: mDescription( description )
+		, mRepetitions( (size_t)defaultRepetitions )
+		, mDefaultRepetitions( (size_t)defaultRepetitions )
+	{
+	}
+
+	//------------------------------
+	void Options::add( const char* flag, size_t& value, const char* description, bool mayBeZero )
+	{
+		Option option;
+		option.flag = flag;
+		option.value = &value;
+		option.defaultValue = value;
+		option.description = description;
+		option.mayBeZero = mayBeZero;
+		mOptions.push_back( option );
+	}
+
+	//------------------------------
+	bool Options::parse( int argc, char* argv[] )
+	{
+		bool valid = true;
+		for ( int i = 1; i < argc && valid; ++i )
+		{
+			valid = i + 1 < argc;
+			if ( !valid )
+				break;
+			if ( strcmp( argv[i], "-j" ) == 0 )
+			{
+				mJsonFileName = argv[++i];
+				continue;
+			}
+			if ( strcmp( argv[i], "-r" ) == 0 )
+			{
+				mRepetitions = (size_t)strtoul( argv[++i], 0, 10 );
+				valid = mRepetitions > 0;
+				continue;
+			}
+			valid = false;
+			for ( size_t j = 0; j < mOptions.size(); ++j )
+			{
+				const Option& option = mOptions[j];
+				if ( strcmp( argv[i], option.flag ) == 0 )
+				{
+					*option.value = (size_t)strtoul( argv[++i], 0, 10 );
+					valid = option.mayBeZero || *option.value > 0;
+					break;
+				}
+			}
+		}
+		if ( !valid )
+			printHelpText( argv[0] );
+		return valid;
+	}
+
+	//------------------------------
+	void Options::printHelpText( const char* programName ) const
+	{
+		std::cout << "Usage: " << programName << " [options]" << std::endl
+			<< mDescription << std::endl;
+		for ( size_t j = 0; j < mOptions.size(); ++j )
+		{
+			const Option& option = mOptions[j];
+			std::cout << "  " << option.flag << " <count>   " << option.description;
+			if ( !option.mayBeZero )
+				std::cout << " (default " << option.defaultValue << ")";
+			std::cout << std::endl;
+		}
+		std::cout << "  -r <count>   runs of each implementation, the fastest is reported (default " << mDefaultRepetitions << ")" << std::endl
+			<< "  -j <file>    also write the results as JSON to <file>" << std::endl;
+	}
+
+} // namespace Benchmark
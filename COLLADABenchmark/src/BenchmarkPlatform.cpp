@@ -0,0 +1,122 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "BenchmarkPlatform.h"
+
+#include <stdio.h>
+
+#ifdef WIN32
+#	include <windows.h>
+#	include <psapi.h>
+#	pragma comment(lib, "psapi.lib")
+#else
+#	include <time.h>
+#	include <sys/time.h>
+#	include <sys/resource.h>
+#endif
+
+
+namespace Benchmark
+{
+
+	//------------------------------
+	double getTime()
+	{
+#ifdef WIN32
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER counter;
+		QueryPerformanceFrequency( &frequency );
+		QueryPerformanceCounter( &counter );
+		return (double)counter.QuadPart / (double)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+		timespec now;
+		clock_gettime( CLOCK_MONOTONIC, &now );
+		return now.tv_sec + now.tv_nsec * 1e-9;
+#else
+		timeval now;
+		gettimeofday( &now, 0 );
+		return now.tv_sec + now.tv_usec * 1e-6;
+#endif
+	}
+
+	//------------------------------
+	bool resetPeakMemory()
+	{
+#if defined(__linux__)
+		// writing 5 to clear_refs resets VmHWM (Linux 4.0 and later)
+		FILE* file = fopen( "/proc/self/clear_refs", "w" );
+		if ( !file )
+			return false;
+		bool success = fputs( "5", file ) >= 0;
+		success = ( fclose( file ) == 0 ) && success;
+		return success;
+#else
+		return false;
+#endif
+	}
+
+	//------------------------------
+	size_t getPeakMemory()
+	{
+#ifdef WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if ( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof(counters) ) )
+			return 0;
+		return counters.PeakWorkingSetSize;
+#else
+#	if defined(__linux__)
+		FILE* file = fopen( "/proc/self/status", "r" );
+		if ( file )
+		{
+			char line[256];
+			size_t peak = 0;
+			while ( fgets( line, sizeof(line), file ) )
+			{
+				unsigned long kiloBytes = 0;
+				if ( sscanf( line, "VmHWM: %lu kB", &kiloBytes ) == 1 )
+				{
+					peak = (size_t)kiloBytes * 1024;
+					break;
+				}
+			}
+			fclose( file );
+			if ( peak != 0 )
+				return peak;
+		}
+#	endif
+		rusage usage;
+		if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+			return 0;
+#	if defined(__APPLE__)
+		return (size_t)usage.ru_maxrss;
+#	else
+		return (size_t)usage.ru_maxrss * 1024;
+#	endif
+#endif
+	}
+
+	//------------------------------
+	size_t getFileSize( const std::string& fileName )
+	{
+		FILE* file = fopen( fileName.c_str(), "rb" );
+		if ( !file )
+			return 0;
+		size_t size = 0;
+		if ( fseek( file, 0, SEEK_END ) == 0 )
+		{
+			long position = ftell( file );
+			if ( position > 0 )
+				size = (size_t)position;
+		}
+		fclose( file );
+		return size;
+	}
+
+} // namespace Benchmark
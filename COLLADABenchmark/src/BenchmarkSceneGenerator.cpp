@@ -0,0 +1,571 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "BenchmarkSceneGenerator.h"
+
+#include "COLLADASWConstants.h"
+#include "COLLADASWException.h"
+#include "COLLADASWLibraryGeometries.h"
+#include "COLLADASWLibraryControllers.h"
+#include "COLLADASWLibraryAnimations.h"
+#include "COLLADASWLibraryVisualScenes.h"
+#include "COLLADASWSource.h"
+#include "COLLADASWVertices.h"
+#include "COLLADASWPrimitves.h"
+#include "COLLADASWBaseInputElement.h"
+#include "COLLADASWInputList.h"
+#include "COLLADASWNode.h"
+#include "COLLADASWInstanceGeometry.h"
+#include "COLLADASWInstanceController.h"
+#include "COLLADASWScene.h"
+
+#include "COLLADABUUtils.h"
+
+#include <math.h>
+
+
+namespace Benchmark
+{
+	/** The id of the mesh in each document.*/
+	static const std::string MESH_ID = "mesh";
+
+	/** The id of the skin controller.*/
+	static const std::string SKIN_ID = "skin";
+
+	/** The id of the visual scene.*/
+	static const std::string VISUAL_SCENE_ID = "visual_scene";
+
+	/** The animated parameters of a node, in the order they are assigned to animation channels.*/
+	static const char* ANIMATION_TARGETS[] = { "translate.X", "translate.Y", "translate.Z", "rotateX.ANGLE", "rotateY.ANGLE", "rotateZ.ANGLE" };
+	static const size_t ANIMATION_TARGET_COUNT = sizeof(ANIMATION_TARGETS) / sizeof(ANIMATION_TARGETS[0]);
+
+	/** The maximum number of joints influencing one vertex.*/
+	static const size_t MAX_INFLUENCES = 4;
+
+	/** The number of children of each node in the node tree.*/
+	static const size_t NODE_CHILD_COUNT = 4;
+
+	/** The distance between two neighbouring joints.*/
+	static const double JOINT_LENGTH = 10.0;
+
+	/** The distance between two neighbouring vertices of the mesh grid.*/
+	static const double GRID_SPACING = 0.5;
+
+	/** Makes the methods of the library writers, that are protected in COLLADASW, accessible.*/
+	class GeometriesWriter : public COLLADASW::LibraryGeometries
+	{
+	public:
+		GeometriesWriter( COLLADASW::StreamWriter* streamWriter ) : COLLADASW::LibraryGeometries( streamWriter ) {}
+		using COLLADASW::LibraryGeometries::openMesh;
+		using COLLADASW::LibraryGeometries::closeMesh;
+		using COLLADASW::LibraryGeometries::closeLibrary;
+	};
+
+	class AnimationsWriter : public COLLADASW::LibraryAnimations
+	{
+	public:
+		AnimationsWriter( COLLADASW::StreamWriter* streamWriter ) : COLLADASW::LibraryAnimations( streamWriter ) {}
+		using COLLADASW::LibraryAnimations::openAnimation;
+		using COLLADASW::LibraryAnimations::closeAnimation;
+		using COLLADASW::LibraryAnimations::addSampler;
+		using COLLADASW::LibraryAnimations::addChannel;
+		using COLLADASW::LibraryAnimations::closeLibrary;
+	};
+
+	class VisualScenesWriter : public COLLADASW::LibraryVisualScenes
+	{
+	public:
+		VisualScenesWriter( COLLADASW::StreamWriter* streamWriter ) : COLLADASW::LibraryVisualScenes( streamWriter ) {}
+		using COLLADASW::LibraryVisualScenes::openVisualScene;
+		using COLLADASW::LibraryVisualScenes::closeVisualScene;
+		using COLLADASW::LibraryVisualScenes::closeLibrary;
+	};
+
+	//------------------------------
+	static std::string getNodeId( size_t index )
+	{
+		return "node_" + COLLADABU::Utils::toString( index );
+	}
+
+	//------------------------------
+	static std::string getJointId( size_t index )
+	{
+		return "joint_" + COLLADABU::Utils::toString( index );
+	}
+
+	//------------------------------
+	static std::string::size_type findFileName( const std::string& path )
+	{
+		std::string::size_type separator = path.find_last_of( "/\\" );
+		return separator == std::string::npos ? 0 : separator + 1;
+	}
+
+	//------------------------------
+	SceneGenerator::Options::Options()
+		: triangleCount( 100000 )
+		, nodeCount( 1 )
+		, animationChannelCount( 0 )
+		, animationKeyCount( 60 )
+		, skinJointCount( 0 )
+		, externalReferenceCount( 0 )
+		, version( COLLADASW::StreamWriter::COLLADA_1_4_1 )
+	{
+	}
+
+	//------------------------------
+	SceneGenerator::SceneGenerator( const Options& options )
+		: mOptions( options )
+		, mRandomState( 1 )
+	{
+		if ( mOptions.triangleCount == 0 )
+			mOptions.triangleCount = 1;
+		if ( mOptions.nodeCount == 0 )
+			mOptions.nodeCount = 1;
+		if ( mOptions.animationKeyCount < 2 )
+			mOptions.animationKeyCount = 2;
+		if ( mOptions.externalReferenceCount > mOptions.nodeCount )
+			mOptions.externalReferenceCount = mOptions.nodeCount;
+	}
+
+	//------------------------------
+	SceneGenerator::~SceneGenerator()
+	{
+	}
+
+	//------------------------------
+	bool SceneGenerator::generate( const std::string& fileName, std::vector<std::string>& writtenFiles )
+	{
+		// restart the sequence, so every call writes the same documents
+		mRandomState = 1;
+		writtenFiles.clear();
+		try
+		{
+			{
+				COLLADASW::StreamWriter streamWriter( COLLADASW::NativeString( fileName ), false, mOptions.version );
+				writeMainDocument( streamWriter, fileName );
+			}
+			writtenFiles.push_back( fileName );
+
+			for ( size_t i = 0; i < mOptions.externalReferenceCount; ++i )
+			{
+				std::string externalFileName = fileName.substr( 0, findFileName( fileName ) ) + getExternalFileName( fileName, i );
+				COLLADASW::StreamWriter streamWriter( COLLADASW::NativeString( externalFileName ), false, mOptions.version );
+				writeExternalDocument( streamWriter );
+				writtenFiles.push_back( externalFileName );
+			}
+		}
+		catch ( const COLLADASW::StreamWriterException& )
+		{
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	std::string SceneGenerator::getExternalFileName( const std::string& fileName, size_t index )
+	{
+		std::string baseName = fileName.substr( findFileName( fileName ) );
+		std::string::size_type extension = baseName.rfind( '.' );
+		if ( extension != std::string::npos )
+			baseName.erase( extension );
+		return baseName + "_external_" + COLLADABU::Utils::toString( index ) + ".dae";
+	}
+
+	//------------------------------
+	void SceneGenerator::writeMainDocument( COLLADASW::StreamWriter& streamWriter, const std::string& fileName )
+	{
+		streamWriter.startDocument();
+		writeAsset( streamWriter );
+		if ( mOptions.animationChannelCount > 0 )
+			writeAnimations( streamWriter );
+		writeGeometries( streamWriter, MESH_ID );
+		if ( mOptions.skinJointCount > 0 )
+			writeControllers( streamWriter );
+		writeVisualScenes( streamWriter, fileName );
+
+		COLLADASW::Scene scene( &streamWriter, COLLADASW::URI( COLLADABU::Utils::EMPTY_STRING, VISUAL_SCENE_ID ), COLLADASW::URI() );
+		scene.add();
+		streamWriter.endDocument();
+	}
+
+	//------------------------------
+	void SceneGenerator::writeExternalDocument( COLLADASW::StreamWriter& streamWriter )
+	{
+		streamWriter.startDocument();
+		writeAsset( streamWriter );
+		writeGeometries( streamWriter, MESH_ID );
+		streamWriter.endDocument();
+	}
+
+	//------------------------------
+	void SceneGenerator::writeAsset( COLLADASW::StreamWriter& streamWriter )
+	{
+		// COLLADASW::Asset writes the current time, which would make the documents differ
+		static const std::string DATE = "2009-01-01T00:00:00Z";
+		streamWriter.openElement( COLLADASW::CSWC::CSW_ELEMENT_ASSET );
+		streamWriter.appendTextElement( COLLADASW::CSWC::CSW_ELEMENT_CREATED, DATE );
+		streamWriter.appendTextElement( COLLADASW::CSWC::CSW_ELEMENT_MODIFIED, DATE );
+		streamWriter.openElement( COLLADASW::CSWC::CSW_ELEMENT_UNIT );
+		streamWriter.appendAttribute( COLLADASW::CSWC::CSW_ATTRIBUTE_NAME, "meter" );
+		streamWriter.appendAttribute( COLLADASW::CSWC::CSW_ATTRIBUTE_METER, 1.0 );
+		streamWriter.closeElement();
+		streamWriter.appendTextElement( COLLADASW::CSWC::CSW_ELEMENT_UP_AXIS, "Y_UP" );
+		streamWriter.closeElement();
+	}
+
+	//------------------------------
+	size_t SceneGenerator::getGridSize() const
+	{
+		// two triangles per grid cell
+		size_t cellsPerSide = (size_t)ceil( sqrt( (double)( mOptions.triangleCount + 1 ) / 2.0 ) );
+		return cellsPerSide + 1;
+	}
+
+	//------------------------------
+	void SceneGenerator::writeGeometries( COLLADASW::StreamWriter& streamWriter, const std::string& geometryId )
+	{
+		const size_t gridSize = getGridSize();
+		const size_t vertexCount = gridSize * gridSize;
+
+		GeometriesWriter geometries( &streamWriter );
+		geometries.openMesh( geometryId );
+
+		const std::string positionsId = geometryId + COLLADASW::LibraryGeometries::POSITIONS_SOURCE_ID_SUFFIX;
+		COLLADASW::FloatSource positions( &streamWriter );
+		positions.setId( positionsId );
+		positions.setArrayId( positionsId + COLLADASW::LibraryGeometries::ARRAY_ID_SUFFIX );
+		positions.setAccessorStride( 3 );
+		positions.setAccessorCount( (unsigned long)vertexCount );
+		positions.getParameterNameList().push_back( "X" );
+		positions.getParameterNameList().push_back( "Y" );
+		positions.getParameterNameList().push_back( "Z" );
+		positions.prepareToAppendValues();
+		for ( size_t y = 0; y < gridSize; ++y )
+		{
+			for ( size_t x = 0; x < gridSize; ++x )
+			{
+				positions.appendValues( x * GRID_SPACING + random( -0.1, 0.1 ), random( -2.0, 2.0 ), y * GRID_SPACING + random( -0.1, 0.1 ) );
+			}
+		}
+		positions.finish();
+
+		const std::string normalsId = geometryId + COLLADASW::LibraryGeometries::NORMALS_SOURCE_ID_SUFFIX;
+		COLLADASW::FloatSource normals( &streamWriter );
+		normals.setId( normalsId );
+		normals.setArrayId( normalsId + COLLADASW::LibraryGeometries::ARRAY_ID_SUFFIX );
+		normals.setAccessorStride( 3 );
+		normals.setAccessorCount( (unsigned long)vertexCount );
+		normals.getParameterNameList().push_back( "X" );
+		normals.getParameterNameList().push_back( "Y" );
+		normals.getParameterNameList().push_back( "Z" );
+		normals.prepareToAppendValues();
+		for ( size_t i = 0; i < vertexCount; ++i )
+		{
+			double x = random( -0.3, 0.3 );
+			double z = random( -0.3, 0.3 );
+			double y = sqrt( 1.0 - x * x - z * z );
+			normals.appendValues( x, y, z );
+		}
+		normals.finish();
+
+		const std::string texCoordsId = geometryId + COLLADASW::LibraryGeometries::TEXCOORDS_SOURCE_ID_SUFFIX;
+		COLLADASW::FloatSource texCoords( &streamWriter );
+		texCoords.setId( texCoordsId );
+		texCoords.setArrayId( texCoordsId + COLLADASW::LibraryGeometries::ARRAY_ID_SUFFIX );
+		texCoords.setAccessorStride( 2 );
+		texCoords.setAccessorCount( (unsigned long)vertexCount );
+		texCoords.getParameterNameList().push_back( "S" );
+		texCoords.getParameterNameList().push_back( "T" );
+		texCoords.prepareToAppendValues();
+		for ( size_t y = 0; y < gridSize; ++y )
+		{
+			for ( size_t x = 0; x < gridSize; ++x )
+			{
+				texCoords.appendValues( (double)x / ( gridSize - 1 ), (double)y / ( gridSize - 1 ) );
+			}
+		}
+		texCoords.finish();
+
+		COLLADASW::VerticesElement vertices( &streamWriter );
+		vertices.setId( geometryId + COLLADASW::LibraryGeometries::VERTICES_ID_SUFFIX );
+		vertices.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::POSITION, "#" + positionsId ) );
+		vertices.add();
+
+		COLLADASW::Triangles triangles( &streamWriter );
+		triangles.setCount( (unsigned long)mOptions.triangleCount );
+		triangles.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::VERTEX, "#" + geometryId + COLLADASW::LibraryGeometries::VERTICES_ID_SUFFIX, 0 ) );
+		triangles.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::NORMAL, "#" + normalsId, 1 ) );
+		triangles.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::TEXCOORD, "#" + texCoordsId, 2, 0 ) );
+		triangles.prepareToAppendValues();
+		for ( size_t i = 0; i < mOptions.triangleCount; ++i )
+		{
+			size_t cell = i / 2;
+			size_t x = cell % ( gridSize - 1 );
+			size_t y = cell / ( gridSize - 1 );
+			unsigned long corner = (unsigned long)( y * gridSize + x );
+			unsigned long triangle[3];
+			if ( i % 2 == 0 )
+			{
+				triangle[0] = corner;
+				triangle[1] = corner + (unsigned long)gridSize;
+				triangle[2] = corner + 1;
+			}
+			else
+			{
+				triangle[0] = corner + 1;
+				triangle[1] = corner + (unsigned long)gridSize;
+				triangle[2] = corner + (unsigned long)gridSize + 1;
+			}
+			for ( size_t j = 0; j < 3; ++j )
+				triangles.appendValues( triangle[j], triangle[j], triangle[j] );
+		}
+		triangles.finish();
+
+		geometries.closeMesh();
+		geometries.closeLibrary();
+	}
+
+	//------------------------------
+	void SceneGenerator::writeControllers( COLLADASW::StreamWriter& streamWriter )
+	{
+		const size_t vertexCount = getGridSize() * getGridSize();
+		const size_t jointCount = mOptions.skinJointCount;
+		const size_t influenceCount = jointCount < MAX_INFLUENCES ? jointCount : MAX_INFLUENCES;
+
+		COLLADASW::LibraryControllers controllers( &streamWriter );
+		controllers.openSkin( SKIN_ID, COLLADASW::URI( COLLADABU::Utils::EMPTY_STRING, MESH_ID ) );
+
+		double identity[4][4] = { {1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1} };
+		controllers.addBindShapeTransform( identity );
+
+		const std::string jointsId = SKIN_ID + COLLADASW::LibraryControllers::JOINTS_SOURCE_ID_SUFFIX;
+		COLLADASW::NameSource jointSource( &streamWriter );
+		jointSource.setId( jointsId );
+		jointSource.setArrayId( jointsId + COLLADASW::LibraryControllers::ARRAY_ID_SUFFIX );
+		jointSource.setAccessorStride( 1 );
+		jointSource.getParameterNameList().push_back( "JOINT" );
+		jointSource.setAccessorCount( (unsigned long)jointCount );
+		jointSource.prepareToAppendValues();
+		for ( size_t i = 0; i < jointCount; ++i )
+			jointSource.appendValues( getJointId( i ) );
+		jointSource.finish();
+
+		// the joints form a chain along the y axis
+		const std::string bindPosesId = SKIN_ID + COLLADASW::LibraryControllers::BIND_POSES_SOURCE_ID_SUFFIX;
+		COLLADASW::Float4x4Source bindPoses( &streamWriter );
+		bindPoses.setId( bindPosesId );
+		bindPoses.setArrayId( bindPosesId + COLLADASW::LibraryControllers::ARRAY_ID_SUFFIX );
+		bindPoses.setAccessorStride( 16 );
+		bindPoses.getParameterNameList().push_back( "TRANSFORM" );
+		bindPoses.setAccessorCount( (unsigned long)jointCount );
+		bindPoses.prepareToAppendValues();
+		for ( size_t i = 0; i < jointCount; ++i )
+		{
+			double inverseBindPose[4][4] = { {1, 0, 0, 0}, {0, 1, 0, -JOINT_LENGTH * i}, {0, 0, 1, 0}, {0, 0, 0, 1} };
+			bindPoses.appendValues( inverseBindPose );
+		}
+		bindPoses.finish();
+
+		std::vector<unsigned long> influences;
+		influences.reserve( vertexCount * influenceCount * 2 );
+		const std::string weightsId = SKIN_ID + COLLADASW::LibraryControllers::WEIGHTS_SOURCE_ID_SUFFIX;
+		COLLADASW::FloatSource weights( &streamWriter );
+		weights.setId( weightsId );
+		weights.setArrayId( weightsId + COLLADASW::LibraryControllers::ARRAY_ID_SUFFIX );
+		weights.setAccessorStride( 1 );
+		weights.getParameterNameList().push_back( "WEIGHT" );
+		weights.setAccessorCount( (unsigned long)( vertexCount * influenceCount ) );
+		weights.prepareToAppendValues();
+		for ( size_t i = 0; i < vertexCount; ++i )
+		{
+			size_t firstJoint = (size_t)random( 0, (double)jointCount );
+			double vertexWeights[MAX_INFLUENCES];
+			double sum = 0;
+			for ( size_t j = 0; j < influenceCount; ++j )
+			{
+				vertexWeights[j] = random( 0.05, 1.0 );
+				sum += vertexWeights[j];
+			}
+			for ( size_t j = 0; j < influenceCount; ++j )
+			{
+				weights.appendValues( vertexWeights[j] / sum );
+				influences.push_back( (unsigned long)( ( firstJoint + j ) % jointCount ) );
+				influences.push_back( (unsigned long)( i * influenceCount + j ) );
+			}
+		}
+		weights.finish();
+
+		COLLADASW::JointsElement joints( &streamWriter );
+		joints.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::JOINT, "#" + jointsId ) );
+		joints.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::BINDMATRIX, "#" + bindPosesId ) );
+		joints.add();
+
+		COLLADASW::VertexWeightsElement vertexWeights( &streamWriter );
+		vertexWeights.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::JOINT, "#" + jointsId, 0 ) );
+		vertexWeights.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::WEIGHT, "#" + weightsId, 1 ) );
+		vertexWeights.setCount( (unsigned long)vertexCount );
+		vertexWeights.prepareToAppendVCountValues();
+		for ( size_t i = 0; i < vertexCount; ++i )
+			vertexWeights.appendValues( (unsigned long)influenceCount );
+		vertexWeights.CloseVCountAndOpenVElement();
+		for ( size_t i = 0; i < influences.size(); ++i )
+			vertexWeights.appendValues( influences[i] );
+		vertexWeights.finish();
+
+		controllers.closeSkin();
+		controllers.closeLibrary();
+	}
+
+	//------------------------------
+	void SceneGenerator::writeAnimations( COLLADASW::StreamWriter& streamWriter )
+	{
+		const size_t keyCount = mOptions.animationKeyCount;
+		AnimationsWriter animations( &streamWriter );
+
+		for ( size_t channel = 0; channel < mOptions.animationChannelCount; ++channel )
+		{
+			const size_t nodeIndex = ( channel / ANIMATION_TARGET_COUNT ) % mOptions.nodeCount;
+			const size_t targetIndex = channel % ANIMATION_TARGET_COUNT;
+			const bool isRotation = targetIndex >= 3;
+			const std::string baseId = "animation_" + COLLADABU::Utils::toString( channel );
+
+			animations.openAnimation( baseId );
+
+			const std::string inputId = baseId + COLLADASW::LibraryAnimations::INPUT_SOURCE_ID_SUFFIX;
+			COLLADASW::FloatSource input( &streamWriter );
+			input.setId( inputId );
+			input.setArrayId( inputId + COLLADASW::LibraryAnimations::ARRAY_ID_SUFFIX );
+			input.setAccessorStride( 1 );
+			input.getParameterNameList().push_back( "TIME" );
+			input.setAccessorCount( (unsigned long)keyCount );
+			input.prepareToAppendValues();
+			for ( size_t key = 0; key < keyCount; ++key )
+				input.appendValues( key / 30.0 );
+			input.finish();
+
+			const std::string outputId = baseId + COLLADASW::LibraryAnimations::OUTPUT_SOURCE_ID_SUFFIX;
+			COLLADASW::FloatSource output( &streamWriter );
+			output.setId( outputId );
+			output.setArrayId( outputId + COLLADASW::LibraryAnimations::ARRAY_ID_SUFFIX );
+			output.setAccessorStride( 1 );
+			output.getParameterNameList().push_back( isRotation ? "ANGLE" : "X" );
+			output.setAccessorCount( (unsigned long)keyCount );
+			output.prepareToAppendValues();
+			for ( size_t key = 0; key < keyCount; ++key )
+				output.appendValues( isRotation ? random( -180.0, 180.0 ) : random( -50.0, 50.0 ) );
+			output.finish();
+
+			const std::string interpolationId = baseId + COLLADASW::LibraryAnimations::INTERPOLATION_SOURCE_ID_SUFFIX;
+			COLLADASW::NameSource interpolation( &streamWriter );
+			interpolation.setId( interpolationId );
+			interpolation.setArrayId( interpolationId + COLLADASW::LibraryAnimations::ARRAY_ID_SUFFIX );
+			interpolation.setAccessorStride( 1 );
+			interpolation.getParameterNameList().push_back( "INTERPOLATION" );
+			interpolation.setAccessorCount( (unsigned long)keyCount );
+			interpolation.prepareToAppendValues();
+			for ( size_t key = 0; key < keyCount; ++key )
+				interpolation.appendValues( COLLADASW::LibraryAnimations::LINEAR_NAME );
+			interpolation.finish();
+
+			const std::string samplerId = baseId + COLLADASW::LibraryAnimations::SAMPLER_ID_SUFFIX;
+			COLLADASW::LibraryAnimations::Sampler sampler( &streamWriter, samplerId );
+			sampler.addInput( COLLADASW::InputSemantic::INPUT, "#" + inputId );
+			sampler.addInput( COLLADASW::InputSemantic::OUTPUT, "#" + outputId );
+			sampler.addInput( COLLADASW::InputSemantic::INTERPOLATION, "#" + interpolationId );
+			animations.addSampler( sampler );
+			animations.addChannel( "#" + samplerId, getNodeId( nodeIndex ) + "/" + ANIMATION_TARGETS[targetIndex] );
+
+			animations.closeAnimation();
+		}
+		animations.closeLibrary();
+	}
+
+	//------------------------------
+	void SceneGenerator::writeVisualScenes( COLLADASW::StreamWriter& streamWriter, const std::string& fileName )
+	{
+		VisualScenesWriter visualScenes( &streamWriter );
+		visualScenes.openVisualScene( VISUAL_SCENE_ID );
+
+		writeNode( streamWriter, fileName, 0 );
+
+		// the joints form a chain along the y axis
+		std::vector<COLLADASW::Node*> openNodes;
+		for ( size_t i = 0; i < mOptions.skinJointCount; ++i )
+		{
+			COLLADASW::Node* joint = new COLLADASW::Node( &streamWriter );
+			joint->setNodeId( getJointId( i ) );
+			joint->setNodeSid( getJointId( i ) );
+			joint->setType( COLLADASW::Node::JOINT );
+			joint->start();
+			joint->addTranslate( "translate", 0.0, i == 0 ? 0.0 : JOINT_LENGTH, 0.0 );
+			openNodes.push_back( joint );
+		}
+		while ( !openNodes.empty() )
+		{
+			openNodes.back()->end();
+			delete openNodes.back();
+			openNodes.pop_back();
+		}
+
+		visualScenes.closeVisualScene();
+		visualScenes.closeLibrary();
+	}
+
+	//------------------------------
+	void SceneGenerator::writeNode( COLLADASW::StreamWriter& streamWriter, const std::string& fileName, size_t index )
+	{
+		COLLADASW::Node node( &streamWriter );
+		node.setNodeId( getNodeId( index ) );
+		node.setNodeName( getNodeId( index ) );
+		node.setType( COLLADASW::Node::NODE );
+		node.start();
+		node.addTranslate( "translate", random( -100.0, 100.0 ), random( -100.0, 100.0 ), random( -100.0, 100.0 ) );
+		node.addRotateZ( "rotateZ", random( -180.0, 180.0 ) );
+		node.addRotateY( "rotateY", random( -180.0, 180.0 ) );
+		node.addRotateX( "rotateX", random( -180.0, 180.0 ) );
+		node.addScale( "scale", 1.0, 1.0, 1.0 );
+
+		if ( index < mOptions.externalReferenceCount )
+		{
+			COLLADASW::InstanceGeometry instanceGeometry( &streamWriter );
+			instanceGeometry.setUrl( COLLADASW::URI( getExternalFileName( fileName, index ), MESH_ID ) );
+			instanceGeometry.add();
+		}
+		else if ( mOptions.skinJointCount > 0 )
+		{
+			COLLADASW::InstanceController instanceController( &streamWriter );
+			instanceController.setUrl( COLLADASW::URI( COLLADABU::Utils::EMPTY_STRING, SKIN_ID ) );
+			instanceController.addSkeleton( COLLADASW::URI( COLLADABU::Utils::EMPTY_STRING, getJointId( 0 ) ) );
+			instanceController.add();
+		}
+		else
+		{
+			COLLADASW::InstanceGeometry instanceGeometry( &streamWriter );
+			instanceGeometry.setUrl( COLLADASW::URI( COLLADABU::Utils::EMPTY_STRING, MESH_ID ) );
+			instanceGeometry.add();
+		}
+
+		// node i has the children NODE_CHILD_COUNT * i + 1 ... NODE_CHILD_COUNT * i + NODE_CHILD_COUNT, 
+		// i.e. the depth of the recursion grows logarithmically
+		for ( size_t child = NODE_CHILD_COUNT * index + 1; child <= NODE_CHILD_COUNT * index + NODE_CHILD_COUNT && child < mOptions.nodeCount; ++child )
+			writeNode( streamWriter, fileName, child );
+
+		node.end();
+	}
+
+	//------------------------------
+	double SceneGenerator::random( double min, double max )
+	{
+		// linear congruential generator of Numerical Recipes. std::rand() differs between platforms.
+		mRandomState = mRandomState * 1664525u + 1013904223u;
+		return min + ( max - min ) * ( ( mRandomState >> 8 ) / 16777216.0 );
+	}
+
+} // namespace Benchmark
@@ -0,0 +1,199 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+	Measures the lookup of animation lists by UniqueId, as the loader does for each animated
+	element. COLLADABU::FlatHashMap is compared with the std::map the loader used before. The ids
+	are created like those of the loader, with consecutive object ids spread over a few files, and
+	are looked up in random order. Each implementation sums the looked up values, so a faster but
+	wrong lookup is reported as failure. Before the measurement, a random sequence of insert, erase
+	and find operations on keys of a small range is applied to both containers and every result is
+	compared, which covers the back shifting of the probe sequences by erase().
+*/
+
+#include "BenchmarkCommon.h"
+
+#include "COLLADABUFlatHashMap.h"
+#include "COLLADAFWUniqueId.h"
+
+#include <stdio.h>
+#include <map>
+#include <vector>
+
+
+namespace
+{
+	/** The default number of animation list ids in the map.*/
+	const size_t DEFAULT_ID_COUNT = 100000;
+
+	/** The default number of finds.*/
+	const size_t DEFAULT_FIND_COUNT = 5000000;
+
+	/** The default number of random operations compared with std::map.*/
+	const size_t DEFAULT_OPERATION_COUNT = 1000000;
+
+	/** The number of times each approach is measured. The fastest run is reported.*/
+	const int DEFAULT_REPETITIONS = 3;
+
+	/** The number of files the ids are spread over.*/
+	const size_t FILE_COUNT = 4;
+
+	/** The number of different keys used by the random operations. Small enough, that inserted
+	keys are found and erased again, and large enough for long probe sequences.*/
+	const size_t OPERATION_KEY_COUNT = 5000;
+
+
+	typedef std::vector<COLLADAFW::UniqueId> UniqueIdList;
+	typedef std::map<COLLADAFW::UniqueId, size_t> UniqueIdStdMap;
+	typedef COLLADABU::FlatHashMap<COLLADAFW::UniqueId, size_t> UniqueIdFlatHashMap;
+
+
+	//------------------------------
+	/** Returns the animation list id with index @a index, the ids of each file are consecutive.*/
+	COLLADAFW::UniqueId createUniqueId( size_t index, size_t idCount )
+	{
+		const size_t idsPerFile = ( idCount + FILE_COUNT - 1 ) / FILE_COUNT;
+		return COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::ANIMATIONLIST, index % idsPerFile, (COLLADAFW::FileId)( index / idsPerFile ) );
+	}
+
+	//------------------------------
+	/** Finds all @a lookups in @a map and returns the sum of the found values.*/
+	template<class MapType>
+	size_t findAll( const MapType& map, const UniqueIdList& lookups )
+	{
+		size_t sum = 0;
+		for ( size_t i = 0, count = lookups.size(); i < count; ++i )
+		{
+			typename MapType::const_iterator it = map.find( lookups[i] );
+			if ( it != map.end() )
+				sum += it->second;
+		}
+		return sum;
+	}
+
+	//------------------------------
+	/** Measures findAll() of @a lookups in @a map. @a expectedSum is the sum of the values of the
+	lookups.*/
+	template<class MapType>
+	void measureFinds( const char* name, const MapType& map, const UniqueIdList& lookups, size_t expectedSum, int repetitions, Benchmark::Results& results )
+	{
+		Benchmark::Result result( name );
+		result.itemCount = lookups.size();
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			stopwatch.start();
+			const size_t sum = findAll( map, lookups );
+			stopwatch.stop();
+			result.identical = result.identical && sum == expectedSum;
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+		results.push_back( result );
+	}
+
+	//------------------------------
+	/** Applies @a operationCount random insert, erase and find operations to a std::map and a
+	FlatHashMap and returns the number of operations with different results.*/
+	size_t compareOperations( size_t operationCount, unsigned int& seed )
+	{
+		UniqueIdStdMap stdMap;
+		UniqueIdFlatHashMap flatHashMap;
+		size_t mismatchCount = 0;
+		for ( size_t i = 0; i < operationCount; ++i )
+		{
+			const COLLADAFW::UniqueId key = createUniqueId( (size_t)( Benchmark::getRandom( seed ) * ( OPERATION_KEY_COUNT - 1 ) ), OPERATION_KEY_COUNT );
+			const double operation = Benchmark::getRandom( seed );
+			if ( operation < 0.4 )
+			{
+				const bool stdInserted = stdMap.insert( std::make_pair( key, i ) ).second;
+				const bool flatInserted = flatHashMap.insert( std::make_pair( key, i ) ).second;
+				if ( stdInserted != flatInserted )
+					++mismatchCount;
+			}
+			else if ( operation < 0.7 )
+			{
+				if ( stdMap.erase( key ) != flatHashMap.erase( key ) )
+					++mismatchCount;
+			}
+			else
+			{
+				UniqueIdStdMap::const_iterator stdIt = stdMap.find( key );
+				UniqueIdFlatHashMap::const_iterator flatIt = flatHashMap.find( key );
+				const bool stdFound = stdIt != stdMap.end();
+				const bool flatFound = flatIt != flatHashMap.end();
+				if ( stdFound != flatFound || ( stdFound && stdIt->second != flatIt->second ) )
+					++mismatchCount;
+			}
+		}
+		if ( stdMap.size() != flatHashMap.size() )
+			++mismatchCount;
+		return mismatchCount;
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	size_t idCount = DEFAULT_ID_COUNT;
+	size_t findCount = DEFAULT_FIND_COUNT;
+	size_t operationCount = DEFAULT_OPERATION_COUNT;
+	Benchmark::Options options( "Measures the lookup of animation lists by UniqueId and compares\n"
+		"COLLADABU::FlatHashMap with std::map.", DEFAULT_REPETITIONS );
+	options.add( "-n", idCount, "animation list ids" );
+	options.add( "-f", findCount, "finds in random order" );
+	options.add( "-o", operationCount, "random operations compared with std::map" );
+	if ( !options.parse( argc, argv ) )
+		return 2;
+	const int repetitions = options.getRepetitions();
+
+	UniqueIdStdMap stdMap;
+	UniqueIdFlatHashMap flatHashMap;
+	for ( size_t i = 0; i < idCount; ++i )
+	{
+		const COLLADAFW::UniqueId uniqueId = createUniqueId( i, idCount );
+		stdMap.insert( std::make_pair( uniqueId, i ) );
+		flatHashMap.insert( std::make_pair( uniqueId, i ) );
+	}
+
+	unsigned int seed = 1;
+	UniqueIdList lookups;
+	lookups.reserve( findCount );
+	size_t expectedSum = 0;
+	for ( size_t i = 0; i < findCount; ++i )
+	{
+		const size_t index = (size_t)( Benchmark::getRandom( seed ) * ( idCount - 1 ) );
+		lookups.push_back( createUniqueId( index, idCount ) );
+		expectedSum += index;
+	}
+
+	const size_t mismatchCount = compareOperations( operationCount, seed );
+
+	Benchmark::Results results;
+	measureFinds( "std::map", stdMap, lookups, expectedSum, repetitions, results );
+	measureFinds( "FlatHashMap", flatHashMap, lookups, expectedSum, repetitions, results );
+	results.back().maxDifference = (double)mismatchCount;
+	results.back().identical = results.back().identical && mismatchCount == 0;
+
+	printf( "%u ids in %u files, %u finds\n", (unsigned int)idCount, (unsigned int)FILE_COUNT, (unsigned int)findCount );
+	printf( "random operations compared with std::map: %u, different results: %u\n", (unsigned int)operationCount, (unsigned int)mismatchCount );
+	Benchmark::printResults( "finds", results );
+
+	if ( !options.getJsonFileName().empty() )
+	{
+		Benchmark::Parameters parameters;
+		Benchmark::addParameter( parameters, "ids", idCount );
+		Benchmark::addParameter( parameters, "finds", findCount );
+		Benchmark::addParameter( parameters, "operations", operationCount );
+		Benchmark::addParameter( parameters, "repetitions", repetitions );
+		if ( !Benchmark::writeJsonFile( options.getJsonFileName(), "OpenCOLLADAFlatHashMapBenchmark", parameters, "finds", results ) )
+			return 1;
+	}
+	return Benchmark::allIdentical( results ) ? 0 : 1;
+}
@@ -0,0 +1,390 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+	Measures how fast formulas are evaluated again and again with changing variables, as
+	kinematics formulas are during a simulation. MathML::CompiledExpression is compared with
+	MathML::EvaluatorVisitor walking the AST. The generated formulas look like those of joint
+	chains: sums and products of the joint values with sine and cosine, powers, minima and maxima,
+	fragments with parameters, long constants and limit checks with comparisons and logic
+	operators. Before each evaluation the joint values are changed, by name in the symbol table
+	for the visitor and by slot for the compiled expressions. Type and value of every result of
+	both are compared, so a faster but different result is reported as failure.
+*/
+
+#include "BenchmarkCommon.h"
+
+#include "MathMLSolverStableHeaders.h"
+#include "MathMLCompiledExpression.h"
+#include "MathMLEvaluatorVisitor.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/** The default number of generated formulas.*/
+	const size_t DEFAULT_FORMULA_COUNT = 200;
+
+	/** The default number of evaluations of each formula.*/
+	const size_t DEFAULT_EVALUATION_COUNT = 5000;
+
+	/** The number of times each approach is measured. The fastest run is reported.*/
+	const int DEFAULT_REPETITIONS = 3;
+
+	/** The number of joint variables.*/
+	const size_t JOINT_COUNT = 6;
+
+	/** The depth of the generated formulas.*/
+	const int FORMULA_DEPTH = 4;
+
+
+	typedef std::vector<MathML::AST::INode*> NodeList;
+
+	typedef std::vector<MathML::AST::ConstantExpression> ValueList;
+
+
+	//------------------------------
+	/** Returns a pseudo random index in 0..count-1.*/
+	size_t getRandomIndex( size_t count, unsigned int& seed )
+	{
+		return std::min( (size_t)( Benchmark::getRandom( seed ) * count ), count - 1 );
+	}
+
+	//------------------------------
+	/** Returns the name of the joint variable with index @a joint.*/
+	std::string getJointName( size_t joint )
+	{
+		char name[16];
+		sprintf( name, "q%u", (unsigned int)joint );
+		return name;
+	}
+
+	//------------------------------
+	MathML::AST::INode* createArithmetic( MathML::AST::ArithmeticExpression::Operator op, MathML::AST::INode* lhs, MathML::AST::INode* rhs )
+	{
+		MathML::AST::ArithmeticExpression* node = new MathML::AST::ArithmeticExpression();
+		node->setOperator( op );
+		node->addOperand( lhs );
+		node->addOperand( rhs );
+		return node;
+	}
+
+	//------------------------------
+	MathML::AST::INode* createFunction( const MathML::String& name, MathML::AST::INode* argument1, MathML::AST::INode* argument2 = 0 )
+	{
+		MathML::AST::FunctionExpression* node = new MathML::AST::FunctionExpression( name );
+		node->addParameter( argument1 );
+		if ( argument2 )
+			node->addParameter( argument2 );
+		return node;
+	}
+
+	//------------------------------
+	MathML::AST::INode* createComparison( MathML::AST::BinaryComparisonExpression::Operator op, MathML::AST::INode* lhs, MathML::AST::INode* rhs )
+	{
+		MathML::AST::BinaryComparisonExpression* node = new MathML::AST::BinaryComparisonExpression();
+		node->setOperator( op );
+		node->setLeftOperand( lhs );
+		node->setRightOperand( rhs );
+		return node;
+	}
+
+	//------------------------------
+	/** Creates a use of @a fragment with the parameters p and q. The use owns the parameters.*/
+	MathML::AST::INode* createFragmentUse( const MathML::AST::FragmentExpression& fragment, MathML::AST::INode* p, MathML::AST::INode* q )
+	{
+		MathML::AST::FragmentExpression* node = new MathML::AST::FragmentExpression( fragment.getName(), MathML::AST::INode::CLONEFLAG_DEEPCOPY_FRAGMENT_PARAMS );
+		node->setFragment( fragment.getFragment() );
+		node->addParameter( "p", p );
+		node->addParameter( "q", q );
+		return node;
+	}
+
+	//------------------------------
+	/** Creates a random subexpression of a joint chain formula with a double or long value.*/
+	MathML::AST::INode* createTerm( int depth, const NodeList& fragments, unsigned int& seed )
+	{
+		if ( depth == 0 )
+		{
+			const double choice = Benchmark::getRandom( seed );
+			if ( choice < 0.6 )
+				return new MathML::AST::VariableExpression( getJointName( getRandomIndex( JOINT_COUNT, seed ) ) );
+			if ( choice < 0.7 )
+				return new MathML::AST::VariableExpression( "scale" );
+			if ( choice < 0.8 )
+				return new MathML::AST::ConstantExpression( (long)( 1 + getRandomIndex( 4, seed ) ) );
+			return new MathML::AST::ConstantExpression( Benchmark::getRandom( seed ) * 4 - 2 );
+		}
+
+		MathML::AST::INode* lhs = createTerm( depth - 1, fragments, seed );
+		switch ( getRandomIndex( 9, seed ) )
+		{
+		case 0:
+			return createArithmetic( MathML::AST::ArithmeticExpression::ADD, lhs, createTerm( depth - 1, fragments, seed ) );
+		case 1:
+			return createArithmetic( MathML::AST::ArithmeticExpression::SUB, lhs, createTerm( depth - 1, fragments, seed ) );
+		case 2:
+			return createArithmetic( MathML::AST::ArithmeticExpression::MUL, lhs, createTerm( depth - 1, fragments, seed ) );
+		case 3:
+			// link lengths, never zero
+			return createArithmetic( MathML::AST::ArithmeticExpression::DIV, lhs, new MathML::AST::ConstantExpression( 0.5 + Benchmark::getRandom( seed ) ) );
+		case 4:
+			return createFunction( MathML::FUNCTION_SIN, lhs );
+		case 5:
+			return createFunction( MathML::FUNCTION_COS, lhs );
+		case 6:
+			return createFunction( MathML::FUNCTION_POW, lhs, new MathML::AST::ConstantExpression( 2L ) );
+		case 7:
+			return createFunction( Benchmark::getRandom( seed ) < 0.5 ? MathML::FUNCTION_MIN : MathML::FUNCTION_MAX, lhs, createTerm( depth - 1, fragments, seed ) );
+		default:
+			{
+				MathML::AST::FragmentExpression& fragment = *static_cast<MathML::AST::FragmentExpression*>( fragments[getRandomIndex( fragments.size(), seed )] );
+				return createFragmentUse( fragment, lhs, createTerm( depth - 1, fragments, seed ) );
+			}
+		}
+	}
+
+	//------------------------------
+	/** Creates a formula with the index @a formulaIndex. Every fourth formula is a limit check
+	with a bool value, all others are joint chain terms.*/
+	MathML::AST::INode* createFormula( size_t formulaIndex, const NodeList& fragments, unsigned int& seed )
+	{
+		if ( formulaIndex % 4 != 3 )
+			return createTerm( FORMULA_DEPTH, fragments, seed );
+
+		// lower limit <= term <= upper limit, or the joint is locked
+		MathML::AST::LogicExpression* inRange = new MathML::AST::LogicExpression();
+		inRange->setOperator( MathML::AST::LogicExpression::AND );
+		inRange->addOperand( createComparison( MathML::AST::BinaryComparisonExpression::GTE, createTerm( FORMULA_DEPTH - 1, fragments, seed ), new MathML::AST::ConstantExpression( -Benchmark::getRandom( seed ) ) ) );
+		inRange->addOperand( createComparison( MathML::AST::BinaryComparisonExpression::LTE, createTerm( FORMULA_DEPTH - 1, fragments, seed ), new MathML::AST::ConstantExpression( Benchmark::getRandom( seed ) ) ) );
+
+		MathML::AST::UnaryExpression* unlocked = new MathML::AST::UnaryExpression();
+		unlocked->setOperator( MathML::AST::UnaryExpression::NOT );
+		unlocked->setOperand( new MathML::AST::VariableExpression( "locked" ) );
+
+		MathML::AST::LogicExpression* formula = new MathML::AST::LogicExpression();
+		formula->setOperator( MathML::AST::LogicExpression::OR );
+		formula->addOperand( inRange );
+		formula->addOperand( createComparison( MathML::AST::BinaryComparisonExpression::EQ, unlocked, new MathML::AST::ConstantExpression( false ) ) );
+		return formula;
+	}
+
+	//------------------------------
+	/** Creates the fragments used by the formulas, with the parameters p and q. The fragments
+	own their expressions.*/
+	void createFragments( NodeList& fragments )
+	{
+		// p * cos( q ), the x offset of a link of length p
+		MathML::AST::FragmentExpression* linkX = new MathML::AST::FragmentExpression( "linkX", MathML::AST::INode::CLONEFLAG_DEEPCOPY_FRAGMENT );
+		linkX->setFragment( createArithmetic( MathML::AST::ArithmeticExpression::MUL, new MathML::AST::VariableExpression( "p" ),
+			createFunction( MathML::FUNCTION_COS, new MathML::AST::VariableExpression( "q" ) ) ) );
+		fragments.push_back( linkX );
+
+		// p * sin( q ) * scale, the scaled y offset of a link of length p
+		MathML::AST::FragmentExpression* linkY = new MathML::AST::FragmentExpression( "linkY", MathML::AST::INode::CLONEFLAG_DEEPCOPY_FRAGMENT );
+		linkY->setFragment( createArithmetic( MathML::AST::ArithmeticExpression::MUL, new MathML::AST::VariableExpression( "p" ),
+			createArithmetic( MathML::AST::ArithmeticExpression::MUL, createFunction( MathML::FUNCTION_SIN, new MathML::AST::VariableExpression( "q" ) ),
+			new MathML::AST::VariableExpression( "scale" ) ) ) );
+		fragments.push_back( linkY );
+	}
+
+	//------------------------------
+	/** Returns the joint values of evaluation @a evaluation.*/
+	void getJointValues( size_t evaluation, double* jointValues )
+	{
+		for ( size_t joint = 0; joint < JOINT_COUNT; ++joint )
+			jointValues[joint] = sin( evaluation * 0.01 + joint ) * ( 1.0 + 0.25 * joint );
+	}
+
+	//------------------------------
+	/** Returns true, if the results of @a values1 and @a values2 have the same types and values.*/
+	bool isIdentical( const ValueList& values1, const ValueList& values2 )
+	{
+		if ( values1.size() != values2.size() )
+			return false;
+		for ( size_t i = 0; i < values1.size(); ++i )
+		{
+			const MathML::AST::ConstantExpression& value1 = values1[i];
+			const MathML::AST::ConstantExpression& value2 = values2[i];
+			if ( value1.getType() != value2.getType() )
+				return false;
+			// NaN results are identical, if both are NaN
+			if ( value1.getDoubleValue() != value2.getDoubleValue()
+				&& !( value1.getDoubleValue() != value1.getDoubleValue() && value2.getDoubleValue() != value2.getDoubleValue() ) )
+				return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	void measureVisitor( const NodeList& formulas, size_t evaluationCount, int repetitions, ValueList& values, Benchmark::Results& results )
+	{
+		Benchmark::Result result( "EvaluatorVisitor" );
+		result.itemCount = formulas.size() * evaluationCount;
+
+		MathML::SymbolTable symbolTable( 0 );
+		MathML::SolverFunctionExtentions::addAllExtensionFunctions( symbolTable );
+		std::vector<std::string> jointNames;
+		for ( size_t joint = 0; joint < JOINT_COUNT; ++joint )
+		{
+			jointNames.push_back( getJointName( joint ) );
+			symbolTable.setVariable( jointNames.back(), 0.0 );
+		}
+		symbolTable.setVariable( "scale", 2L );
+		symbolTable.setVariable( "locked", false );
+
+		values.resize( formulas.size() * evaluationCount );
+		double jointValues[JOINT_COUNT];
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			stopwatch.start();
+			size_t valueIndex = 0;
+			for ( size_t evaluation = 0; evaluation < evaluationCount; ++evaluation )
+			{
+				// the values are changed in place, as setVariable() would allocate a new node each time
+				getJointValues( evaluation, jointValues );
+				for ( size_t joint = 0; joint < JOINT_COUNT; ++joint )
+					static_cast<MathML::AST::ConstantExpression*>( symbolTable.getVariable( jointNames[joint] ) )->setValue( jointValues[joint] );
+				static_cast<MathML::AST::ConstantExpression*>( symbolTable.getVariable( "locked" ) )->setValue( evaluation % 8 == 0 );
+
+				for ( size_t i = 0; i < formulas.size(); ++i )
+				{
+					MathML::EvaluatorVisitor evaluator( symbolTable, 0 );
+					formulas[i]->accept( &evaluator );
+					values[valueIndex++] = evaluator.getValue();
+				}
+			}
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+
+		const MathML::SymbolTable::VariableMap& variables = symbolTable.getVariables();
+		for ( MathML::SymbolTable::VariableMap::const_iterator it = variables.begin(); it != variables.end(); ++it )
+			delete it->second;
+		results.push_back( result );
+	}
+
+	//------------------------------
+	void measureCompiled( const NodeList& formulas, size_t evaluationCount, int repetitions, const ValueList& reference, Benchmark::Results& results )
+	{
+		Benchmark::Result result( "CompiledExpression" );
+		result.itemCount = formulas.size() * evaluationCount;
+
+		MathML::SymbolTable symbolTable( 0 );
+		MathML::SolverFunctionExtentions::addAllExtensionFunctions( symbolTable );
+		for ( size_t joint = 0; joint < JOINT_COUNT; ++joint )
+			symbolTable.setVariable( getJointName( joint ), 0.0 );
+		symbolTable.setVariable( "scale", 2L );
+		symbolTable.setVariable( "locked", false );
+
+		// compiling is not measured, it happens once when the formulas are loaded
+		std::vector<MathML::CompiledExpression*> expressions;
+		std::vector<unsigned int> jointSlots;
+		std::vector<unsigned int> lockedSlots;
+		for ( size_t i = 0; i < formulas.size(); ++i )
+		{
+			MathML::CompiledExpression* expression = new MathML::CompiledExpression();
+			expression->compile( formulas[i], symbolTable, 0 );
+			expressions.push_back( expression );
+			for ( size_t joint = 0; joint < JOINT_COUNT; ++joint )
+				jointSlots.push_back( expression->getVariableSlot( getJointName( joint ) ) );
+			lockedSlots.push_back( expression->getVariableSlot( "locked" ) );
+		}
+
+		ValueList values( formulas.size() * evaluationCount );
+		double jointValues[JOINT_COUNT];
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			stopwatch.start();
+			size_t valueIndex = 0;
+			for ( size_t evaluation = 0; evaluation < evaluationCount; ++evaluation )
+			{
+				getJointValues( evaluation, jointValues );
+				const bool locked = evaluation % 8 == 0;
+				for ( size_t i = 0; i < expressions.size(); ++i )
+				{
+					MathML::CompiledExpression& expression = *expressions[i];
+					const unsigned int* slots = &jointSlots[i * JOINT_COUNT];
+					for ( size_t joint = 0; joint < JOINT_COUNT; ++joint )
+					{
+						if ( slots[joint] != MathML::CompiledExpression::NO_SLOT )
+							expression.setVariable( slots[joint], jointValues[joint] );
+					}
+					if ( lockedSlots[i] != MathML::CompiledExpression::NO_SLOT )
+						expression.setVariable( lockedSlots[i], locked );
+					expression.evaluate( values[valueIndex++] );
+				}
+			}
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+		result.identical = isIdentical( reference, values );
+
+		for ( size_t i = 0; i < expressions.size(); ++i )
+			delete expressions[i];
+		const MathML::SymbolTable::VariableMap& variables = symbolTable.getVariables();
+		for ( MathML::SymbolTable::VariableMap::const_iterator it = variables.begin(); it != variables.end(); ++it )
+			delete it->second;
+		results.push_back( result );
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	size_t formulaCount = DEFAULT_FORMULA_COUNT;
+	size_t evaluationCount = DEFAULT_EVALUATION_COUNT;
+	Benchmark::Options options( "Measures the repeated evaluation of formulas with changing variables and compares\n"
+		"MathML::CompiledExpression with MathML::EvaluatorVisitor.", DEFAULT_REPETITIONS );
+	options.add( "-n", formulaCount, "generated formulas" );
+	options.add( "-e", evaluationCount, "evaluations of each formula" );
+	if ( !options.parse( argc, argv ) )
+		return 2;
+	const int repetitions = options.getRepetitions();
+
+	unsigned int seed = 1;
+	NodeList fragments;
+	createFragments( fragments );
+	NodeList formulas;
+	for ( size_t i = 0; i < formulaCount; ++i )
+		formulas.push_back( createFormula( i, fragments, seed ) );
+
+	Benchmark::Results results;
+	ValueList reference;
+	measureVisitor( formulas, evaluationCount, repetitions, reference, results );
+	measureCompiled( formulas, evaluationCount, repetitions, reference, results );
+
+	for ( size_t i = 0; i < formulas.size(); ++i )
+		delete formulas[i];
+	for ( size_t i = 0; i < fragments.size(); ++i )
+		delete fragments[i];
+
+	printf( "%u formulas, %u evaluations each\n", (unsigned int)formulaCount, (unsigned int)evaluationCount );
+	Benchmark::printResults( "evaluations", results );
+
+	if ( !options.getJsonFileName().empty() )
+	{
+		Benchmark::Parameters parameters;
+		Benchmark::addParameter( parameters, "formulas", formulaCount );
+		Benchmark::addParameter( parameters, "evaluations", evaluationCount );
+		Benchmark::addParameter( parameters, "repetitions", repetitions );
+		if ( !Benchmark::writeJsonFile( options.getJsonFileName(), "OpenCOLLADAFormulaBenchmark", parameters, "evaluations", results ) )
+			return 1;
+	}
+
+	return Benchmark::allIdentical( results ) ? 0 : 1;
+}
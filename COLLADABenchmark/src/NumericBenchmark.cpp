@@ -0,0 +1,656 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+	Measures the numeric conversions used by the loader and the stream writer on realistic value
+	distributions and compares them with the conversions of the C and C++ standard libraries.
+	For each conversion the time per value and the accuracy are reported. The accuracy of a parser is
+	measured against strtof/strtod, that of a formatter by reading its output back with strtof/strtod.
+*/
+
+#include "BenchmarkCommon.h"
+
+#include "GeneratedSaxParserUtils.h"
+#include "Commonftoa.h"
+#include "Commondtoa.h"
+#include "Commonitoa.h"
+#include "CommonCharacterBuffer.h"
+#include "CommonMemoryBufferFlusher.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <locale.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 201703L || ( defined(_MSVC_LANG) && _MSVC_LANG >= 201703L )
+#	include <charconv>
+#	if defined(__cpp_lib_to_chars)
+#		define BENCHMARK_HAS_CHARCONV
+#	endif
+#endif
+
+
+namespace
+{
+	typedef unsigned long long uint64;
+
+	/** The number of values of each distribution.*/
+	const size_t DEFAULT_VALUE_COUNT = 1000000;
+
+	/** The number of times each conversion is measured. The fastest run is reported.*/
+	const int DEFAULT_REPETITIONS = 5;
+
+	/** The maximum number of characters written for one value, including the separator.*/
+	const size_t MAX_VALUE_LENGTH = 32;
+
+	/** Sink for the converted values, to prevent the compiler from removing the conversions.*/
+	volatile double valueSink = 0;
+
+
+	/** A value distribution and its text representation, as it appears in a document.*/
+	struct DataSet
+	{
+		/** The name of the distribution.*/
+		std::string name;
+
+		/** The values as space separated text.*/
+		std::string text;
+
+		/** The values of the text, converted by strtof.*/
+		std::vector<float> floats;
+
+		/** The values of the text, converted by strtod.*/
+		std::vector<double> doubles;
+
+		/** The values of the text, if the distribution consists of unsigned integers.*/
+		std::vector<uint64> integers;
+	};
+
+	/** The result of one conversion on one distribution.*/
+	struct Result
+	{
+		std::string dataSet;
+		std::string operation;
+		std::string implementation;
+		double nanoSecondsPerValue;
+		/** The fraction of values, that are bit identical to the reference.*/
+		double exactFraction;
+		/** The largest distance to the reference in units in the last place.*/
+		double maxUlps;
+	};
+
+	typedef std::vector<Result> Results;
+
+
+	/** A pseudo random generator, so all runs use the same values.*/
+	class Random
+	{
+	private:
+		unsigned int mState;
+	public:
+		Random() : mState(1) {}
+		/** Returns the next pseudo random number in [0, 1).*/
+		double next()
+		{
+			mState = mState * 1664525u + 1013904223u;
+			return ( mState >> 8 ) / 16777216.0;
+		}
+	};
+
+
+	//------------------------------
+	/** Creates a floating point distribution. @a format is the printf format of the text.*/
+	template<class Generator>
+	void createFloatingPointDataSet( DataSet& dataSet, const char* name, const char* format, size_t count, Generator generator )
+	{
+		Random random;
+		char text[MAX_VALUE_LENGTH];
+		dataSet.name = name;
+		dataSet.text.reserve( count * 16 );
+		for ( size_t i = 0; i < count; ++i )
+		{
+			sprintf( text, format, generator( random ) );
+			dataSet.text += text;
+			dataSet.text += ' ';
+			dataSet.floats.push_back( strtof( text, 0 ) );
+			dataSet.doubles.push_back( strtod( text, 0 ) );
+		}
+	}
+
+	//------------------------------
+	double meshCoordinate( Random& random )
+	{
+		return random.next() * 2000.0 - 1000.0;
+	}
+
+	//------------------------------
+	double textureCoordinate( Random& random )
+	{
+		return random.next();
+	}
+
+	//------------------------------
+	double scientific( Random& random )
+	{
+		double mantissa = 1.0 + 9.0 * ( random.next() + random.next() / 16777216.0 );
+		double exponent = floor( random.next() * 61.0 ) - 30.0;
+		double sign = random.next() < 0.5 ? -1.0 : 1.0;
+		return sign * mantissa * pow( 10.0, exponent );
+	}
+
+	//------------------------------
+	/** Creates indices in [0, 2^32).*/
+	void createIndexDataSet( DataSet& dataSet, size_t count )
+	{
+		Random random;
+		char text[MAX_VALUE_LENGTH];
+		dataSet.name = "large indices";
+		dataSet.text.reserve( count * 11 );
+		for ( size_t i = 0; i < count; ++i )
+		{
+			uint64 high = (uint64)( random.next() * 65536.0 );
+			uint64 low = (uint64)( random.next() * 65536.0 );
+			uint64 index = ( high << 16 ) | low;
+			sprintf( text, "%llu", index );
+			dataSet.text += text;
+			dataSet.text += ' ';
+			dataSet.integers.push_back( index );
+		}
+	}
+
+
+	//------------------------------
+	/** Maps the bits of @a value to an integer, that grows monotonic with the value.*/
+	double orderedBits( float value )
+	{
+		int bits;
+		memcpy( &bits, &value, sizeof(bits) );
+		return bits < 0 ? -(double)( bits & 0x7fffffff ) : (double)bits;
+	}
+
+	//------------------------------
+	double orderedBits( double value )
+	{
+		long long bits;
+		memcpy( &bits, &value, sizeof(bits) );
+		return bits < 0 ? -(double)( bits & 0x7fffffffffffffffLL ) : (double)bits;
+	}
+
+	//------------------------------
+	double orderedBits( uint64 value )
+	{
+		return (double)value;
+	}
+
+	//------------------------------
+	/** Compares @a values with @a reference and stores the accuracy in @a result.*/
+	template<class T>
+	void compare( const T* values, const std::vector<T>& reference, Result& result )
+	{
+		size_t exact = 0;
+		result.maxUlps = 0;
+		for ( size_t i = 0; i < reference.size(); ++i )
+		{
+			if ( memcmp( &values[i], &reference[i], sizeof(T) ) == 0 )
+			{
+				++exact;
+				continue;
+			}
+			double ulps = fabs( orderedBits( values[i] ) - orderedBits( reference[i] ) );
+			if ( ulps != ulps )
+				ulps = HUGE_VAL;
+			if ( ulps > result.maxUlps )
+				result.maxUlps = ulps;
+		}
+		result.exactFraction = reference.empty() ? 1.0 : (double)exact / reference.size();
+	}
+
+
+	//------------------------------
+	float toValue( const char* text, float* ) { return strtof( text, 0 ); }
+	double toValue( const char* text, double* ) { return strtod( text, 0 ); }
+	uint64 toValue( const char* text, uint64* ) { return strtoull( text, 0, 10 ); }
+
+	//------------------------------
+	/** Reads the space separated values written by a formatter back with the C library.*/
+	template<class T>
+	void readBack( const char* text, size_t length, std::vector<T>& values )
+	{
+		const char* end = text + length;
+		const char* p = text;
+		while ( p < end )
+		{
+			values.push_back( toValue( p, (T*)0 ) );
+			while ( p < end && *p != ' ' )
+				++p;
+			++p;
+		}
+	}
+
+
+	/** A parser of space separated text.*/
+	template<class T>
+	struct Parser
+	{
+		const char* name;
+		void (*parse)( const char* text, const char* textEnd, T* values, size_t count );
+	};
+
+	/** A formatter, that writes space separated values and returns the number of bytes written.*/
+	template<class T>
+	struct Formatter
+	{
+		const char* name;
+		size_t (*format)( const T* values, size_t count, char* text );
+	};
+
+
+	//------------------------------
+	void parseFloatGeneratedSaxParser( const char* text, const char* textEnd, float* values, size_t count )
+	{
+		const GeneratedSaxParser::ParserChar* p = text;
+		bool failed;
+		for ( size_t i = 0; i < count; ++i )
+			values[i] = GeneratedSaxParser::Utils::toFloat( &p, textEnd, failed );
+	}
+
+	//------------------------------
+	void parseDoubleGeneratedSaxParser( const char* text, const char* textEnd, double* values, size_t count )
+	{
+		const GeneratedSaxParser::ParserChar* p = text;
+		bool failed;
+		for ( size_t i = 0; i < count; ++i )
+			values[i] = GeneratedSaxParser::Utils::toDouble( &p, textEnd, failed );
+	}
+
+	//------------------------------
+	void parseUint64GeneratedSaxParser( const char* text, const char* textEnd, uint64* values, size_t count )
+	{
+		const GeneratedSaxParser::ParserChar* p = text;
+		bool failed;
+		for ( size_t i = 0; i < count; ++i )
+			values[i] = GeneratedSaxParser::Utils::toUint64( &p, textEnd, failed );
+	}
+
+	//------------------------------
+	void parseFloatStrtof( const char* text, const char* /*textEnd*/, float* values, size_t count )
+	{
+		char* p = (char*)text;
+		for ( size_t i = 0; i < count; ++i )
+			values[i] = strtof( p, &p );
+	}
+
+	//------------------------------
+	void parseDoubleStrtod( const char* text, const char* /*textEnd*/, double* values, size_t count )
+	{
+		char* p = (char*)text;
+		for ( size_t i = 0; i < count; ++i )
+			values[i] = strtod( p, &p );
+	}
+
+	//------------------------------
+	void parseUint64Strtoull( const char* text, const char* /*textEnd*/, uint64* values, size_t count )
+	{
+		char* p = (char*)text;
+		for ( size_t i = 0; i < count; ++i )
+			values[i] = strtoull( p, &p, 10 );
+	}
+
+#ifdef BENCHMARK_HAS_CHARCONV
+	//------------------------------
+	template<class T>
+	void parseFromChars( const char* text, const char* textEnd, T* values, size_t count )
+	{
+		const char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			while ( *p == ' ' )
+				++p;
+			p = std::from_chars( p, textEnd, values[i] ).ptr;
+		}
+	}
+#endif
+
+
+	//------------------------------
+	size_t formatFloatFtoa( const float* values, size_t count, char* text )
+	{
+		char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			p += Common::ftoa( values[i], p );
+			*p++ = ' ';
+		}
+		return p - text;
+	}
+
+	//------------------------------
+	size_t formatDoubleDtoa( const double* values, size_t count, char* text )
+	{
+		char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			p += Common::dtoa( values[i], p );
+			*p++ = ' ';
+		}
+		return p - text;
+	}
+
+	//------------------------------
+	size_t formatDoubleDtoaDoublePrecision( const double* values, size_t count, char* text )
+	{
+		char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			p += Common::dtoa( values[i], p, true );
+			*p++ = ' ';
+		}
+		return p - text;
+	}
+
+	//------------------------------
+	size_t formatUint64Itoa( const uint64* values, size_t count, char* text )
+	{
+		char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			p += Common::itoa( values[i], p, 10 );
+			*p++ = ' ';
+		}
+		return p - text;
+	}
+
+	//------------------------------
+	/** Formats through a CharacterBuffer, as the stream writer does. The flusher keeps its memory
+	between runs, so only the first run pays for its growth.*/
+	template<class T>
+	size_t formatCharacterBuffer( const T* values, size_t count, char* text )
+	{
+		static Common::MemoryBufferFlusher flusher;
+		flusher.clear();
+		{
+			Common::CharacterBuffer buffer( 64 * 1024, &flusher );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				buffer.copyToBufferAsChar( values[i] );
+				buffer.copyToBuffer( ' ' );
+			}
+			buffer.flushBuffer();
+		}
+		memcpy( text, flusher.getData(), flusher.getSize() );
+		return flusher.getSize();
+	}
+
+	//------------------------------
+	template<int precision>
+	size_t formatFloatSprintf( const float* values, size_t count, char* text )
+	{
+		char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+			p += sprintf( p, "%.*g ", precision, values[i] );
+		return p - text;
+	}
+
+	//------------------------------
+	template<int precision>
+	size_t formatDoubleSprintf( const double* values, size_t count, char* text )
+	{
+		char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+			p += sprintf( p, "%.*g ", precision, values[i] );
+		return p - text;
+	}
+
+	//------------------------------
+	size_t formatUint64Sprintf( const uint64* values, size_t count, char* text )
+	{
+		char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+			p += sprintf( p, "%llu ", values[i] );
+		return p - text;
+	}
+
+#ifdef BENCHMARK_HAS_CHARCONV
+	//------------------------------
+	/** Writes the shortest representation, that reads back to the same value.*/
+	template<class T>
+	size_t formatToChars( const T* values, size_t count, char* text )
+	{
+		char* p = text;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			p = std::to_chars( p, p + MAX_VALUE_LENGTH, values[i] ).ptr;
+			*p++ = ' ';
+		}
+		return p - text;
+	}
+#endif
+
+
+	//------------------------------
+	template<class T>
+	void measureParsers( const DataSet& dataSet, const std::vector<T>& reference, const char* operation, const Parser<T>* parsers, size_t parserCount, int repetitions, Results& results )
+	{
+		const char* text = dataSet.text.c_str();
+		const char* textEnd = text + dataSet.text.size();
+		std::vector<T> values( reference.size() );
+
+		for ( size_t i = 0; i < parserCount; ++i )
+		{
+			Benchmark::Stopwatch stopwatch;
+			for ( int repetition = 0; repetition < repetitions; ++repetition )
+			{
+				stopwatch.start();
+				parsers[i].parse( text, textEnd, &values[0], values.size() );
+				stopwatch.stop();
+				valueSink = valueSink + (double)values[values.size() / 2];
+			}
+
+			Result result;
+			result.dataSet = dataSet.name;
+			result.operation = operation;
+			result.implementation = parsers[i].name;
+			result.nanoSecondsPerValue = stopwatch.getSeconds() * 1e9 / values.size();
+			compare( &values[0], reference, result );
+			results.push_back( result );
+		}
+	}
+
+	//------------------------------
+	template<class T>
+	void measureFormatters( const DataSet& dataSet, const std::vector<T>& values, const char* operation, const Formatter<T>* formatters, size_t formatterCount, int repetitions, Results& results )
+	{
+		std::vector<char> text( values.size() * MAX_VALUE_LENGTH );
+
+		for ( size_t i = 0; i < formatterCount; ++i )
+		{
+			Benchmark::Stopwatch stopwatch;
+			size_t length = 0;
+			for ( int repetition = 0; repetition < repetitions; ++repetition )
+			{
+				stopwatch.start();
+				length = formatters[i].format( &values[0], values.size(), &text[0] );
+				stopwatch.stop();
+				valueSink = valueSink + text[length / 2];
+			}
+
+			std::vector<T> readValues;
+			readValues.reserve( values.size() );
+			readBack( &text[0], length, readValues );
+
+			Result result;
+			result.dataSet = dataSet.name;
+			result.operation = operation;
+			result.implementation = formatters[i].name;
+			result.nanoSecondsPerValue = stopwatch.getSeconds() * 1e9 / values.size();
+			if ( readValues.size() == values.size() )
+			{
+				compare( &readValues[0], values, result );
+			}
+			else
+			{
+				result.exactFraction = 0;
+				result.maxUlps = HUGE_VAL;
+			}
+			results.push_back( result );
+		}
+	}
+
+
+	const Parser<float> FLOAT_PARSERS[] =
+	{
+		{ "GeneratedSaxParser::Utils::toFloat", parseFloatGeneratedSaxParser },
+		{ "strtof", parseFloatStrtof },
+#ifdef BENCHMARK_HAS_CHARCONV
+		{ "std::from_chars", parseFromChars<float> },
+#endif
+	};
+
+	const Parser<double> DOUBLE_PARSERS[] =
+	{
+		{ "GeneratedSaxParser::Utils::toDouble", parseDoubleGeneratedSaxParser },
+		{ "strtod", parseDoubleStrtod },
+#ifdef BENCHMARK_HAS_CHARCONV
+		{ "std::from_chars", parseFromChars<double> },
+#endif
+	};
+
+	const Parser<uint64> UINT64_PARSERS[] =
+	{
+		{ "GeneratedSaxParser::Utils::toUint64", parseUint64GeneratedSaxParser },
+		{ "strtoull", parseUint64Strtoull },
+#ifdef BENCHMARK_HAS_CHARCONV
+		{ "std::from_chars", parseFromChars<uint64> },
+#endif
+	};
+
+	const Formatter<float> FLOAT_FORMATTERS[] =
+	{
+		{ "Common::ftoa", formatFloatFtoa },
+		{ "CharacterBuffer::copyToBufferAsChar", formatCharacterBuffer<float> },
+		{ "sprintf %g", formatFloatSprintf<6> },
+		{ "sprintf %.9g", formatFloatSprintf<9> },
+#ifdef BENCHMARK_HAS_CHARCONV
+		{ "std::to_chars", formatToChars<float> },
+#endif
+	};
+
+	const Formatter<double> DOUBLE_FORMATTERS[] =
+	{
+		{ "Common::dtoa", formatDoubleDtoa },
+		{ "Common::dtoa doublePrecision", formatDoubleDtoaDoublePrecision },
+		{ "CharacterBuffer::copyToBufferAsChar", formatCharacterBuffer<double> },
+		{ "sprintf %g", formatDoubleSprintf<6> },
+		{ "sprintf %.17g", formatDoubleSprintf<17> },
+#ifdef BENCHMARK_HAS_CHARCONV
+		{ "std::to_chars", formatToChars<double> },
+#endif
+	};
+
+	const Formatter<uint64> UINT64_FORMATTERS[] =
+	{
+		{ "Common::itoa", formatUint64Itoa },
+		{ "CharacterBuffer::copyToBufferAsChar", formatCharacterBuffer<uint64> },
+		{ "sprintf %llu", formatUint64Sprintf },
+#ifdef BENCHMARK_HAS_CHARCONV
+		{ "std::to_chars", formatToChars<uint64> },
+#endif
+	};
+
+
+	//------------------------------
+	void printResults( const Results& results )
+	{
+		printf( "%-22s %-14s %-36s %10s %9s %12s\n", "distribution", "operation", "implementation", "ns/value", "exact", "max ulps" );
+		for ( size_t i = 0; i < results.size(); ++i )
+		{
+			const Result& result = results[i];
+			printf( "%-22s %-14s %-36s %10.2f %8.2f%% %12.4g\n", result.dataSet.c_str(), result.operation.c_str(),
+				result.implementation.c_str(), result.nanoSecondsPerValue, result.exactFraction * 100.0, result.maxUlps );
+		}
+	}
+
+	//------------------------------
+	void writeJson( std::ostream& stream, size_t valueCount, int repetitions, const Results& results )
+	{
+		Benchmark::Parameters parameters;
+		Benchmark::addParameter( parameters, "values", valueCount );
+		Benchmark::addParameter( parameters, "repetitions", repetitions );
+		Benchmark::writeJsonBegin( stream, "OpenCOLLADANumericBenchmark", parameters );
+		for ( size_t i = 0; i < results.size(); ++i )
+		{
+			const Result& result = results[i];
+			stream << ( i == 0 ? "\n" : ",\n" );
+			stream << "    { \"distribution\": \"" << result.dataSet << "\""
+				<< ", \"operation\": \"" << result.operation << "\""
+				<< ", \"implementation\": \"" << result.implementation << "\""
+				<< ", \"nsPerValue\": " << result.nanoSecondsPerValue
+				<< ", \"exactFraction\": " << result.exactFraction
+				<< ", \"maxUlps\": ";
+			// JSON has no infinity
+			if ( result.maxUlps == HUGE_VAL )
+				stream << "null }";
+			else
+				stream << result.maxUlps << " }";
+		}
+		Benchmark::writeJsonEnd( stream );
+	}
+}
+
+
+#define ARRAY_SIZE( array ) ( sizeof( array ) / sizeof( array[0] ) )
+
+int main( int argc, char* argv[] )
+{
+	size_t valueCount = DEFAULT_VALUE_COUNT;
+	Benchmark::Options options( "Measures the numeric conversions of the loader and the stream writer and compares them\n"
+		"with the standard library.", DEFAULT_REPETITIONS );
+	options.add( "-n", valueCount, "values of each distribution" );
+	if ( !options.parse( argc, argv ) )
+		return 2;
+	const int repetitions = options.getRepetitions();
+
+	// all conversions of the loader and the writer assume the C locale
+	setlocale( LC_NUMERIC, "C" );
+
+	DataSet dataSets[3];
+	createFloatingPointDataSet( dataSets[0], "mesh coordinates", "%.7g", valueCount, meshCoordinate );
+	createFloatingPointDataSet( dataSets[1], "texture coordinates", "%.6g", valueCount, textureCoordinate );
+	createFloatingPointDataSet( dataSets[2], "scientific notation", "%.9e", valueCount, scientific );
+	DataSet indices;
+	createIndexDataSet( indices, valueCount );
+
+	Results results;
+	for ( size_t i = 0; i < ARRAY_SIZE( dataSets ); ++i )
+	{
+		const DataSet& dataSet = dataSets[i];
+		measureParsers( dataSet, dataSet.floats, "parse float", FLOAT_PARSERS, ARRAY_SIZE( FLOAT_PARSERS ), repetitions, results );
+		measureParsers( dataSet, dataSet.doubles, "parse double", DOUBLE_PARSERS, ARRAY_SIZE( DOUBLE_PARSERS ), repetitions, results );
+		measureFormatters( dataSet, dataSet.floats, "format float", FLOAT_FORMATTERS, ARRAY_SIZE( FLOAT_FORMATTERS ), repetitions, results );
+		measureFormatters( dataSet, dataSet.doubles, "format double", DOUBLE_FORMATTERS, ARRAY_SIZE( DOUBLE_FORMATTERS ), repetitions, results );
+	}
+	measureParsers( indices, indices.integers, "parse uint64", UINT64_PARSERS, ARRAY_SIZE( UINT64_PARSERS ), repetitions, results );
+	measureFormatters( indices, indices.integers, "format uint64", UINT64_FORMATTERS, ARRAY_SIZE( UINT64_FORMATTERS ), repetitions, results );
+
+	printResults( results );
+
+	if ( !options.getJsonFileName().empty() )
+	{
+		std::ostringstream json;
+		writeJson( json, valueCount, repetitions, results );
+		if ( !Benchmark::writeFile( options.getJsonFileName(), json.str() ) )
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,411 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+	Measures how fast the positions of a skinned mesh are calculated. COLLADAFW::SkinInfluences
+	with 4 and 8 influences per vertex and float, 16 bit and 8 bit weights is compared with walking
+	the variable length joint and weight index lists of COLLADAFW::SkinControllerData for each vertex
+	in double precision. The generated skin has one to four significant influences per vertex, some
+	negligible ones, that are dropped, and some that bind the vertex to the bind shape.
+	The skinned positions of all frames are compared with the reference. The largest accepted
+	difference depends on the weight format and on the weights dropped by the build, so a faster but
+	wrong result is reported as failure. The build of the influences is measured on one and on
+	several threads, and both builds are compared value by value.
+*/
+
+#include "BenchmarkCommon.h"
+
+#include "COLLADAFWSkinInfluences.h"
+#include "COLLADAFWSkinControllerData.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/** The default number of vertices of the generated skin.*/
+	const size_t DEFAULT_VERTEX_COUNT = 1000000;
+
+	/** The default number of joints of the generated skin.*/
+	const size_t DEFAULT_JOINT_COUNT = 64;
+
+	/** The default number of skinned frames.*/
+	const size_t DEFAULT_FRAME_COUNT = 10;
+
+	/** The default number of threads of the parallel build.*/
+	const size_t DEFAULT_THREAD_COUNT = 4;
+
+	/** The number of times each approach is measured. The fastest run is reported.*/
+	const int DEFAULT_REPETITIONS = 3;
+
+	/** The largest difference of a skinned coordinate to the reference caused by float arithmetic,
+	that is not reported as failure.*/
+	const double MAX_FLOAT_DIFFERENCE = 1e-4;
+
+	/** An upper bound of the absolute value of the coordinates of the skinned positions.*/
+	const double MAX_COORDINATE = 5.0;
+
+	/** The weight of the negligible influences relative to the significant ones.*/
+	const float NEGLIGIBLE_WEIGHT = 1e-6f;
+
+
+	typedef std::vector<COLLADABU::Math::Matrix4> Matrix4List;
+
+
+	//------------------------------
+	/** Returns a translation matrix.*/
+	COLLADABU::Math::Matrix4 getTranslation( double x, double y, double z )
+	{
+		return COLLADABU::Math::Matrix4(
+			1, 0, 0, x,
+			0, 1, 0, y,
+			0, 0, 1, z,
+			0, 0, 0, 1 );
+	}
+
+	//------------------------------
+	/** Creates a skin with @a vertexCount vertices and @a jointCount joints placed in -1..1. The
+	joint centers are written to @a jointCenters.*/
+	COLLADAFW::SkinControllerData* createSkin( size_t vertexCount, size_t jointCount, std::vector<double>& jointCenters, unsigned int& seed )
+	{
+		COLLADAFW::SkinControllerData* skin = new COLLADAFW::SkinControllerData( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::SKIN_DATA, 1, 0 ) );
+		skin->setJointsCount( jointCount );
+		skin->setBindShapeMatrix( getTranslation( 0.1, 0, -0.1 ) );
+
+		jointCenters.resize( 3 * jointCount );
+		COLLADAFW::Matrix4Array& inverseBindMatrices = skin->getInverseBindMatrices();
+		inverseBindMatrices.allocMemory( jointCount );
+		inverseBindMatrices.setCount( jointCount );
+		for ( size_t j = 0; j < jointCount; ++j )
+		{
+			for ( size_t c = 0; c < 3; ++c )
+				jointCenters[3 * j + c] = Benchmark::getRandom( seed ) * 2 - 1;
+			inverseBindMatrices[j] = getTranslation( -jointCenters[3 * j], -jointCenters[3 * j + 1], -jointCenters[3 * j + 2] );
+		}
+
+		// at most four significant and two negligible influences per vertex, one weight per influence
+		COLLADAFW::UIntValuesArray& jointsPerVertex = skin->getJointsPerVertex();
+		COLLADAFW::IntValuesArray& jointIndices = skin->getJointIndices();
+		COLLADAFW::UIntValuesArray& weightIndices = skin->getWeightIndices();
+		skin->getWeights().setType( COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT );
+		COLLADAFW::FloatArray& weights = *skin->getWeights().getFloatValues();
+		jointsPerVertex.allocMemory( vertexCount );
+		jointIndices.allocMemory( 6 * vertexCount );
+		weightIndices.allocMemory( 6 * vertexCount );
+		weights.allocMemory( 6 * vertexCount );
+		for ( size_t i = 0; i < vertexCount; ++i )
+		{
+			const size_t significantCount = 1 + (size_t)( Benchmark::getRandom( seed ) * 3.999 );
+			const size_t negligibleCount = Benchmark::getRandom( seed ) < 0.3 ? 1 + (size_t)( Benchmark::getRandom( seed ) * 1.999 ) : 0;
+			const size_t pairCount = significantCount + negligibleCount;
+
+			float vertexWeights[6];
+			float weightSum = 0;
+			for ( size_t p = 0; p < pairCount; ++p )
+			{
+				// the negligible influences come first, so the build has to sort them
+				vertexWeights[p] = p < negligibleCount ? NEGLIGIBLE_WEIGHT : (float)( 0.1 + Benchmark::getRandom( seed ) );
+				weightSum += vertexWeights[p];
+			}
+			for ( size_t p = 0; p < pairCount; ++p )
+			{
+				const int jointIndex = Benchmark::getRandom( seed ) < 0.02 ? -1 : (int)( Benchmark::getRandom( seed ) * ( jointCount - 0.001 ) );
+				jointIndices.append( jointIndex );
+				weightIndices.append( (unsigned int)weights.getCount() );
+				weights.append( vertexWeights[p] / weightSum );
+			}
+			jointsPerVertex.append( (unsigned int)pairCount );
+		}
+		return skin;
+	}
+
+	//------------------------------
+	/** Creates @a vertexCount positions in -1..1.*/
+	void createPositions( size_t vertexCount, std::vector<float>& positions, unsigned int& seed )
+	{
+		positions.resize( 3 * vertexCount );
+		for ( size_t i = 0; i < positions.size(); ++i )
+			positions[i] = (float)( Benchmark::getRandom( seed ) * 2 - 1 );
+	}
+
+	//------------------------------
+	/** Returns the world matrices of the joints at @a frame. Each joint rotates around its center
+	and moves a bit.*/
+	void getJointMatrices( size_t frame, const std::vector<double>& jointCenters, Matrix4List& jointMatrices )
+	{
+		const size_t jointCount = jointCenters.size() / 3;
+		jointMatrices.resize( jointCount );
+		for ( size_t j = 0; j < jointCount; ++j )
+		{
+			const double angle = 0.1 * frame + 0.37 * j;
+			const double c = cos( angle );
+			const double s = sin( angle );
+			const double offset = 0.05 * sin( 0.2 * frame + j );
+			const COLLADABU::Math::Matrix4 rotation(
+				c, -s, 0, 0,
+				s, c, 0, 0,
+				0, 0, 1, 0,
+				0, 0, 0, 1 );
+			jointMatrices[j] = getTranslation( jointCenters[3 * j] + offset, jointCenters[3 * j + 1], jointCenters[3 * j + 2] - offset ) * rotation;
+		}
+	}
+
+	//------------------------------
+	/** Skins @a positions by walking the joint and weight index lists of @a skin for each vertex.*/
+	void skinPositions( const COLLADAFW::SkinControllerData& skin, const Matrix4List& jointMatrices, const std::vector<float>& positions, std::vector<float>& skinnedPositions )
+	{
+		const COLLADABU::Math::Matrix4& bindShapeMatrix = skin.getBindShapeMatrix();
+		const COLLADAFW::Matrix4Array& inverseBindMatrices = skin.getInverseBindMatrices();
+		Matrix4List matrices( jointMatrices.size() );
+		for ( size_t j = 0; j < jointMatrices.size(); ++j )
+			matrices[j] = jointMatrices[j] * inverseBindMatrices[j] * bindShapeMatrix;
+
+		const COLLADAFW::UIntValuesArray& jointsPerVertex = skin.getJointsPerVertex();
+		const COLLADAFW::IntValuesArray& jointIndices = skin.getJointIndices();
+		const COLLADAFW::UIntValuesArray& weightIndices = skin.getWeightIndices();
+		const float* weights = skin.getWeights().getFloatValues()->getData();
+		size_t pairIndex = 0;
+		for ( size_t i = 0, count = jointsPerVertex.getCount(); i < count; ++i )
+		{
+			const double x = positions[3 * i];
+			const double y = positions[3 * i + 1];
+			const double z = positions[3 * i + 2];
+			double skinned[3] = { 0, 0, 0 };
+			for ( size_t p = 0; p < jointsPerVertex[i]; ++p, ++pairIndex )
+			{
+				const int jointIndex = jointIndices[pairIndex];
+				const COLLADABU::Math::Matrix4& matrix = jointIndex < 0 ? bindShapeMatrix : matrices[jointIndex];
+				const double weight = weights[weightIndices[pairIndex]];
+				for ( size_t r = 0; r < 3; ++r )
+					skinned[r] += weight * ( matrix[r][0] * x + matrix[r][1] * y + matrix[r][2] * z + matrix[r][3] );
+			}
+			for ( size_t r = 0; r < 3; ++r )
+				skinnedPositions[3 * i + r] = (float)skinned[r];
+		}
+	}
+
+	//------------------------------
+	/** Skins @a positions with @a influences.*/
+	void skinPositions( const COLLADAFW::SkinInfluences& influences, const COLLADAFW::SkinControllerData& skin, const Matrix4List& jointMatrices,
+		std::vector<float>& matrices, const std::vector<float>& positions, std::vector<float>& skinnedPositions )
+	{
+		influences.setMatrices( skin, &jointMatrices[0], &matrices[0] );
+		influences.skinPositions( &matrices[0], &positions[0], &skinnedPositions[0], 0, influences.getVertexCount() );
+	}
+
+	//------------------------------
+	/** Returns the largest difference of the values of @a values1 and @a values2.*/
+	double getMaxDifference( const std::vector<float>& values1, const std::vector<float>& values2 )
+	{
+		double maxDifference = 0;
+		for ( size_t i = 0; i < values1.size(); ++i )
+			maxDifference = std::max( maxDifference, fabs( (double)values1[i] - values2[i] ) );
+		return maxDifference;
+	}
+
+	//------------------------------
+	/** Returns true, if @a influences1 and @a influences2 store the same values.*/
+	bool equalInfluences( const COLLADAFW::SkinInfluences& influences1, const COLLADAFW::SkinInfluences& influences2 )
+	{
+		if ( influences1.getVertexCount() != influences2.getVertexCount() ||
+			influences1.getUsedInfluenceCount() != influences2.getUsedInfluenceCount() ||
+			influences1.getDroppedInfluenceCount() != influences2.getDroppedInfluenceCount() )
+			return false;
+		for ( size_t k = 0; k < influences1.getInfluenceCount(); ++k )
+		{
+			for ( size_t i = 0; i < influences1.getVertexCount(); ++i )
+			{
+				if ( influences1.getJointIndices( k )[i] != influences2.getJointIndices( k )[i] ||
+					influences1.getWeight( k, i ) != influences2.getWeight( k, i ) )
+					return false;
+			}
+		}
+		return true;
+	}
+
+	//------------------------------
+	/** Returns a name for influences with @a influenceCount and @a weightFormat.*/
+	std::string getName( COLLADAFW::SkinInfluences::InfluenceCount influenceCount, COLLADAFW::SkinInfluences::WeightFormat weightFormat )
+	{
+		std::string name = influenceCount == COLLADAFW::SkinInfluences::INFLUENCES_4 ? "SkinInfluences 4" : "SkinInfluences 8";
+		switch ( weightFormat )
+		{
+		case COLLADAFW::SkinInfluences::WEIGHT_UNORM16:
+			return name + " unorm16";
+		case COLLADAFW::SkinInfluences::WEIGHT_UNORM8:
+			return name + " unorm8";
+		default:
+			return name + " float";
+		}
+	}
+
+	//------------------------------
+	void measureSkinControllerData( const COLLADAFW::SkinControllerData& skin, const std::vector<double>& jointCenters, const std::vector<float>& positions,
+		size_t frameCount, int repetitions, Benchmark::Results& results )
+	{
+		Benchmark::Result result( "SkinControllerData lists (double)" );
+		result.itemCount = skin.getVertexCount() * frameCount;
+		Matrix4List jointMatrices;
+		std::vector<float> skinnedPositions( positions.size() );
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			stopwatch.start();
+			for ( size_t frame = 0; frame < frameCount; ++frame )
+			{
+				getJointMatrices( frame, jointCenters, jointMatrices );
+				skinPositions( skin, jointMatrices, positions, skinnedPositions );
+			}
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+		results.push_back( result );
+	}
+
+	//------------------------------
+	void measureBuild( const COLLADAFW::SkinControllerData& skin, size_t threadCount, int repetitions, Benchmark::Results& results )
+	{
+		Benchmark::Result result( "SkinInfluences 4 float build", threadCount );
+		result.itemCount = skin.getVertexCount();
+		COLLADAFW::SkinInfluences influences;
+		bool built = true;
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			stopwatch.start();
+			built = influences.build( skin, threadCount ) && built;
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+
+		// the parallel build has to store the same values as the single threaded one
+		COLLADAFW::SkinInfluences reference;
+		result.identical = built && reference.build( skin ) && equalInfluences( reference, influences );
+		results.push_back( result );
+	}
+
+	//------------------------------
+	void measureInfluences( const COLLADAFW::SkinControllerData& skin, COLLADAFW::SkinInfluences::InfluenceCount influenceCount,
+		COLLADAFW::SkinInfluences::WeightFormat weightFormat, const std::vector<double>& jointCenters, const std::vector<float>& positions,
+		size_t frameCount, int repetitions, Benchmark::Results& results )
+	{
+		Benchmark::Result result( getName( influenceCount, weightFormat ) );
+		result.itemCount = skin.getVertexCount() * frameCount;
+		COLLADAFW::SkinInfluences influences( influenceCount, weightFormat );
+		const bool built = influences.build( skin );
+
+		Matrix4List jointMatrices;
+		std::vector<float> matrices( influences.getMatrixCount() * COLLADAFW::SkinInfluences::MATRIX_SIZE );
+		std::vector<float> skinnedPositions( positions.size() );
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions && built; ++repetition )
+		{
+			stopwatch.start();
+			for ( size_t frame = 0; frame < frameCount; ++frame )
+			{
+				getJointMatrices( frame, jointCenters, jointMatrices );
+				skinPositions( influences, skin, jointMatrices, matrices, positions, skinnedPositions );
+			}
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+
+		// compare all frames with the reference, outside of the measurement
+		std::vector<float> reference( positions.size() );
+		for ( size_t frame = 0; frame < frameCount && built; ++frame )
+		{
+			getJointMatrices( frame, jointCenters, jointMatrices );
+			skinPositions( skin, jointMatrices, positions, reference );
+			skinPositions( influences, skin, jointMatrices, matrices, positions, skinnedPositions );
+			result.maxDifference = std::max( result.maxDifference, getMaxDifference( reference, skinnedPositions ) );
+		}
+
+		// each quantized weight differs by at most one step, the rounding error of all is added to the largest
+		double weightStep = 0;
+		if ( weightFormat == COLLADAFW::SkinInfluences::WEIGHT_UNORM16 )
+			weightStep = 1.0 / 0xFFFF;
+		else if ( weightFormat == COLLADAFW::SkinInfluences::WEIGHT_UNORM8 )
+			weightStep = 1.0 / 0xFF;
+		const double maxWeightError = 2 * influences.getMaxDroppedWeight() + influenceCount * weightStep;
+		result.identical = built && result.maxDifference <= MAX_FLOAT_DIFFERENCE + maxWeightError * MAX_COORDINATE;
+		results.push_back( result );
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	size_t vertexCount = DEFAULT_VERTEX_COUNT;
+	size_t jointCount = DEFAULT_JOINT_COUNT;
+	size_t frameCount = DEFAULT_FRAME_COUNT;
+	size_t threadCount = DEFAULT_THREAD_COUNT;
+	Benchmark::Options options( "Measures the skinning of generated positions and compares COLLADAFW::SkinInfluences\n"
+		"with walking the joint and weight index lists of COLLADAFW::SkinControllerData.", DEFAULT_REPETITIONS );
+	options.add( "-v", vertexCount, "vertices of the generated skin" );
+	options.add( "-n", jointCount, "joints of the generated skin, at most 65535" );
+	options.add( "-f", frameCount, "skinned frames" );
+	options.add( "-t", threadCount, "threads of the parallel build" );
+	if ( !options.parse( argc, argv ) )
+		return 2;
+	if ( jointCount > 0xFFFF )
+	{
+		options.printHelpText( argv[0] );
+		return 2;
+	}
+	const int repetitions = options.getRepetitions();
+
+	unsigned int seed = 1;
+	std::vector<double> jointCenters;
+	COLLADAFW::SkinControllerData* skin = createSkin( vertexCount, jointCount, jointCenters, seed );
+	std::vector<float> positions;
+	createPositions( vertexCount, positions, seed );
+
+	Benchmark::Results results;
+	measureSkinControllerData( *skin, jointCenters, positions, frameCount, repetitions, results );
+	measureBuild( *skin, 1, repetitions, results );
+	if ( threadCount > 1 )
+		measureBuild( *skin, threadCount, repetitions, results );
+	measureInfluences( *skin, COLLADAFW::SkinInfluences::INFLUENCES_4, COLLADAFW::SkinInfluences::WEIGHT_FLOAT, jointCenters, positions, frameCount, repetitions, results );
+	measureInfluences( *skin, COLLADAFW::SkinInfluences::INFLUENCES_4, COLLADAFW::SkinInfluences::WEIGHT_UNORM16, jointCenters, positions, frameCount, repetitions, results );
+	measureInfluences( *skin, COLLADAFW::SkinInfluences::INFLUENCES_4, COLLADAFW::SkinInfluences::WEIGHT_UNORM8, jointCenters, positions, frameCount, repetitions, results );
+	measureInfluences( *skin, COLLADAFW::SkinInfluences::INFLUENCES_8, COLLADAFW::SkinInfluences::WEIGHT_FLOAT, jointCenters, positions, frameCount, repetitions, results );
+
+	// the index lists and the weights of the skin controller, compared with 4 influences and 8 bit weights
+	const size_t pairCount = skin->getJointIndices().getCount();
+	const size_t influenceBytes = ( vertexCount + 2 * pairCount ) * sizeof( unsigned int ) + skin->getWeights().getValuesCount() * sizeof( float );
+	const size_t packedInfluenceBytes = COLLADAFW::SkinInfluences::INFLUENCES_4 * vertexCount * ( sizeof( unsigned short ) + sizeof( unsigned char ) );
+
+	COLLADAFW::SkinInfluences influences;
+	influences.build( *skin );
+	delete skin;
+
+	printf( "%u vertices, %u joints, %u influences, %u frames\n", (unsigned int)vertexCount, (unsigned int)jointCount, (unsigned int)pairCount, (unsigned int)frameCount );
+	printf( "dropped influences: %u, largest dropped weight: %g\n", (unsigned int)influences.getDroppedInfluenceCount(), influences.getMaxDroppedWeight() );
+	printf( "influence memory: %u bytes, 4 influences with 8 bit weights %u bytes\n", (unsigned int)influenceBytes, (unsigned int)packedInfluenceBytes );
+	Benchmark::printResults( "vertices", results );
+
+	if ( !options.getJsonFileName().empty() )
+	{
+		Benchmark::Parameters parameters;
+		Benchmark::addParameter( parameters, "vertices", vertexCount );
+		Benchmark::addParameter( parameters, "joints", jointCount );
+		Benchmark::addParameter( parameters, "frames", frameCount );
+		Benchmark::addParameter( parameters, "repetitions", repetitions );
+		Benchmark::addParameter( parameters, "influenceBytes", influenceBytes );
+		Benchmark::addParameter( parameters, "packedInfluenceBytes", packedInfluenceBytes );
+		if ( !Benchmark::writeJsonFile( options.getJsonFileName(), "OpenCOLLADASkinningBenchmark", parameters, "vertices", results ) )
+			return 1;
+	}
+	return Benchmark::allIdentical( results ) ? 0 : 1;
+}
@@ -0,0 +1,347 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+	Measures how fast the separate position, normal and texture coordinate indices of a mesh are
+	merged into single index vertex buffers. COLLADAFW::VertexBufferBuilder is compared with the
+	std::map based approach of dae2ogre on a generated grid mesh. The buffers of both are compared
+	corner by corner, so a faster but wrong result is reported as failure.
+	The builder is measured a second time after the indices of the mesh have been packed into
+	8 or 16 bits, and the memory of the indices is reported before and after packing.
+*/
+
+#include "BenchmarkCommon.h"
+
+#include "COLLADAFWVertexBufferBuilder.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWTriangles.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+
+namespace
+{
+	/** The default number of corners of the generated mesh.*/
+	const size_t DEFAULT_CORNER_COUNT = 10000000;
+
+	/** The default number of primitives the mesh is split into.*/
+	const size_t DEFAULT_PRIMITIVE_COUNT = 8;
+
+	/** The number of times each approach is measured. The fastest run is reported.*/
+	const int DEFAULT_REPETITIONS = 3;
+
+	/** Every SEAM_INTERVAL columns the texture coordinates of the grid are split.*/
+	const size_t SEAM_INTERVAL = 16;
+
+
+
+	/** A single index vertex buffer with separate positions, normals and texture coordinates, as
+	built by the dae2ogre MeshWriter.*/
+	struct MapVertexBuffer
+	{
+		std::vector<float> positions;
+		std::vector<float> normals;
+		std::vector<float> uvCoordinates;
+		std::vector<unsigned int> indices;
+	};
+
+
+	/** The index tuple of a corner, as used by the dae2ogre MeshWriter.*/
+	struct Tuple
+	{
+		unsigned int positionIndex;
+		unsigned int normalIndex;
+		unsigned int textureIndex;
+
+		bool operator<( const Tuple& rhs ) const
+		{
+			if ( positionIndex != rhs.positionIndex )
+				return positionIndex < rhs.positionIndex;
+			if ( normalIndex != rhs.normalIndex )
+				return normalIndex < rhs.normalIndex;
+			return textureIndex < rhs.textureIndex;
+		}
+	};
+
+	typedef std::map<Tuple, unsigned int> TupleIndexMap;
+
+
+	//------------------------------
+	/** Creates a grid of about @a cornerCount corners in @a primitiveCount triangle primitives, with
+	shared positions and normals and texture coordinates, that are split every SEAM_INTERVAL columns.
+	If @a packed is true, the indices are stored with the smallest width, that is chosen from the
+	number of values before the indices are filled, as the loader does.*/
+	COLLADAFW::Mesh* createMesh( size_t cornerCount, size_t primitiveCount, bool packed )
+	{
+		const size_t quadsPerRow = (size_t)ceil( sqrt( cornerCount / 6.0 ) );
+		const size_t verticesPerRow = quadsPerRow + 1;
+		const size_t vertexCount = verticesPerRow * verticesPerRow;
+
+		COLLADAFW::Mesh* mesh = new COLLADAFW::Mesh( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::MESH, 1, 0 ) );
+
+		COLLADAFW::FloatArray positions;
+		COLLADAFW::FloatArray normals;
+		COLLADAFW::FloatArray uvCoordinates;
+		positions.allocMemory( 3 * vertexCount );
+		normals.allocMemory( 3 * vertexCount );
+		uvCoordinates.allocMemory( 4 * vertexCount );
+		for ( size_t y = 0; y < verticesPerRow; ++y )
+		{
+			for ( size_t x = 0; x < verticesPerRow; ++x )
+			{
+				float height = (float)( sin( x * 0.05 ) * cos( y * 0.05 ) );
+				positions.append( (float)x );
+				positions.append( (float)y );
+				positions.append( height );
+				normals.append( 0.0f );
+				normals.append( 0.0f );
+				normals.append( 1.0f );
+				uvCoordinates.append( (float)x / quadsPerRow );
+				uvCoordinates.append( (float)y / quadsPerRow );
+			}
+		}
+		// the second copy of the texture coordinates is used right of the seams
+		for ( size_t y = 0; y < verticesPerRow; ++y )
+		{
+			for ( size_t x = 0; x < verticesPerRow; ++x )
+			{
+				uvCoordinates.append( 1.0f - (float)x / quadsPerRow );
+				uvCoordinates.append( (float)y / quadsPerRow );
+			}
+		}
+		mesh->getPositions().appendValues( positions, "positions", 3 );
+		mesh->getNormals().appendValues( normals, "normals", 3 );
+		mesh->getUVCoords().appendValues( uvCoordinates, "uvs", 2 );
+
+		const size_t rowsPerPrimitive = ( quadsPerRow + primitiveCount - 1 ) / primitiveCount;
+		for ( size_t firstRow = 0; firstRow < quadsPerRow; firstRow += rowsPerPrimitive )
+		{
+			const size_t lastRow = std::min( firstRow + rowsPerPrimitive, quadsPerRow );
+			const size_t primitiveCorners = ( lastRow - firstRow ) * quadsPerRow * 6;
+
+			COLLADAFW::Triangles* triangles = new COLLADAFW::Triangles( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::PRIMITIVE_ELEMENT, firstRow, 0 ) );
+			COLLADAFW::IndexArray& positionIndices = triangles->getPositionIndexArray();
+			COLLADAFW::IndexArray& normalIndices = triangles->getNormalIndexArray();
+			COLLADAFW::IndexList* uvIndexList = new COLLADAFW::IndexList();
+			uvIndexList->setStride( 2 );
+			COLLADAFW::IndexArray& uvIndices = uvIndexList->getIndexArray();
+			triangles->getUVCoordIndicesArray().append( uvIndexList );
+			if ( packed )
+			{
+				positionIndices.setWidth( COLLADAFW::IndexArray::getWidthForValueCount( vertexCount ) );
+				normalIndices.setWidth( COLLADAFW::IndexArray::getWidthForValueCount( vertexCount ) );
+				uvIndices.setWidth( COLLADAFW::IndexArray::getWidthForValueCount( 2 * vertexCount ) );
+			}
+			positionIndices.reserve( primitiveCorners );
+			normalIndices.reserve( primitiveCorners );
+			uvIndices.reserve( primitiveCorners );
+
+			for ( size_t y = firstRow; y < lastRow; ++y )
+			{
+				for ( size_t x = 0; x < quadsPerRow; ++x )
+				{
+					const unsigned int corners[6] = {
+						(unsigned int)( y * verticesPerRow + x ),
+						(unsigned int)( y * verticesPerRow + x + 1 ),
+						(unsigned int)( ( y + 1 ) * verticesPerRow + x + 1 ),
+						(unsigned int)( y * verticesPerRow + x ),
+						(unsigned int)( ( y + 1 ) * verticesPerRow + x + 1 ),
+						(unsigned int)( ( y + 1 ) * verticesPerRow + x ) };
+					const unsigned int uvOffset = ( x % SEAM_INTERVAL == 0 ) ? (unsigned int)vertexCount : 0;
+					for ( size_t i = 0; i < 6; ++i )
+					{
+						positionIndices.append( corners[i] );
+						normalIndices.append( corners[i] );
+						uvIndices.append( corners[i] + uvOffset );
+					}
+				}
+			}
+			triangles->setFaceCount( primitiveCorners / 3 );
+			mesh->getMeshPrimitives().append( triangles );
+		}
+		return mesh;
+	}
+
+	//------------------------------
+	/** Builds the buffer of @a primitive as the dae2ogre MeshWriter does.*/
+	void buildMapVertexBuffer( const COLLADAFW::Mesh& mesh, const COLLADAFW::MeshPrimitive& primitive, MapVertexBuffer& buffer )
+	{
+		const float* positions = mesh.getPositions().getFloatValues()->getData();
+		const float* normals = mesh.getNormals().getFloatValues()->getData();
+		const float* uvCoordinates = mesh.getUVCoords().getFloatValues()->getData();
+		const COLLADAFW::IndexArray& positionIndices = primitive.getPositionIndexArray();
+		const COLLADAFW::IndexArray& normalIndices = primitive.getNormalIndexArray();
+		const COLLADAFW::IndexArray& uvIndices = primitive.getUVCoordIndices( 0 )->getIndexArray();
+
+		TupleIndexMap tupleMap;
+		unsigned int nextTupleIndex = 0;
+		for ( size_t i = 0, count = positionIndices.getCount(); i < count; ++i )
+		{
+			Tuple tuple;
+			tuple.positionIndex = positionIndices[i];
+			tuple.normalIndex = normalIndices[i];
+			tuple.textureIndex = uvIndices[i];
+			TupleIndexMap::const_iterator it = tupleMap.find( tuple );
+			if ( it != tupleMap.end() )
+			{
+				buffer.indices.push_back( it->second );
+				continue;
+			}
+			buffer.indices.push_back( tupleMap[tuple] = nextTupleIndex++ );
+			buffer.positions.insert( buffer.positions.end(), positions + 3 * tuple.positionIndex, positions + 3 * tuple.positionIndex + 3 );
+			buffer.normals.insert( buffer.normals.end(), normals + 3 * tuple.normalIndex, normals + 3 * tuple.normalIndex + 3 );
+			buffer.uvCoordinates.insert( buffer.uvCoordinates.end(), uvCoordinates + 2 * tuple.textureIndex, uvCoordinates + 2 * tuple.textureIndex + 2 );
+		}
+	}
+
+	//------------------------------
+	/** Returns true, if @a count floats at @a values1 and @a values2 are equal.*/
+	bool equalValues( const float* values1, const float* values2, size_t count )
+	{
+		return memcmp( values1, values2, count * sizeof( float ) ) == 0;
+	}
+
+	//------------------------------
+	/** Returns true, if each corner of @a buffer has the same values as in @a reference and both
+	have the same number of vertices.*/
+	bool compareVertexBuffers( const MapVertexBuffer& reference, const COLLADAFW::VertexBuffer& buffer )
+	{
+		const COLLADAFW::VertexBuffer::Attribute* position = buffer.findAttribute( COLLADAFW::VertexBuffer::POSITION );
+		const COLLADAFW::VertexBuffer::Attribute* normal = buffer.findAttribute( COLLADAFW::VertexBuffer::NORMAL );
+		const COLLADAFW::VertexBuffer::Attribute* uvCoordinate = buffer.findAttribute( COLLADAFW::VertexBuffer::TEXCOORD );
+		if ( !position || !normal || !uvCoordinate )
+			return false;
+		if ( reference.positions.size() / 3 != buffer.getVertexCount() || reference.indices.size() != buffer.getIndexCount() )
+			return false;
+		for ( size_t i = 0, count = reference.indices.size(); i < count; ++i )
+		{
+			const size_t referenceIndex = reference.indices[i];
+			const size_t index = buffer.getIndex( i );
+			if ( !equalValues( &reference.positions[3 * referenceIndex], buffer.getAttributeValues( *position, index ), 3 ) ||
+				!equalValues( &reference.normals[3 * referenceIndex], buffer.getAttributeValues( *normal, index ), 3 ) ||
+				!equalValues( &reference.uvCoordinates[2 * referenceIndex], buffer.getAttributeValues( *uvCoordinate, index ), 2 ) )
+				return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	void measureMap( const COLLADAFW::Mesh& mesh, size_t cornerCount, int repetitions, std::vector<MapVertexBuffer>& buffers, Benchmark::Results& results )
+	{
+		const COLLADAFW::MeshPrimitiveArray& primitives = mesh.getMeshPrimitives();
+		Benchmark::Result result( "std::map (dae2ogre)" );
+		result.itemCount = cornerCount;
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			buffers.clear();
+			buffers.resize( primitives.getCount() );
+			stopwatch.start();
+			for ( size_t i = 0, count = primitives.getCount(); i < count; ++i )
+				buildMapVertexBuffer( mesh, *primitives[i], buffers[i] );
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+		results.push_back( result );
+	}
+
+	//------------------------------
+	void measureBuilder( const COLLADAFW::Mesh& mesh, size_t cornerCount, COLLADAFW::VertexBuffer::Layout layout, size_t threadCount, bool packed, int repetitions, const std::vector<MapVertexBuffer>& reference, Benchmark::Results& results )
+	{
+		Benchmark::Result result( layout == COLLADAFW::VertexBuffer::INTERLEAVED ? "VertexBufferBuilder interleaved" : "VertexBufferBuilder separate", threadCount );
+		if ( packed )
+			result.implementation += " packed";
+		result.itemCount = cornerCount;
+		COLLADAFW::VertexBufferBuilder builder( mesh, layout );
+		Benchmark::Stopwatch stopwatch;
+		for ( int repetition = 0; repetition < repetitions; ++repetition )
+		{
+			stopwatch.start();
+			builder.build( threadCount );
+			stopwatch.stop();
+		}
+		result.milliSeconds = stopwatch.getMilliSeconds();
+		result.identical = builder.getVertexBufferCount() == reference.size();
+		for ( size_t i = 0; i < builder.getVertexBufferCount() && result.identical; ++i )
+			result.identical = compareVertexBuffers( reference[i], builder.getVertexBuffer( i ) );
+		results.push_back( result );
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	size_t cornerCount = DEFAULT_CORNER_COUNT;
+	size_t primitiveCount = DEFAULT_PRIMITIVE_COUNT;
+	size_t threadCount = 0;
+	Benchmark::Options options( "Measures the merging of mesh indices into single index vertex buffers and compares\n"
+		"COLLADAFW::VertexBufferBuilder with the std::map approach of dae2ogre.", DEFAULT_REPETITIONS );
+	options.add( "-c", cornerCount, "corners of the generated mesh" );
+	options.add( "-p", primitiveCount, "primitives the mesh is split into" );
+	options.add( "-t", threadCount, "threads of the parallel build (default: one per primitive)", true );
+	if ( !options.parse( argc, argv ) )
+		return 2;
+	const int repetitions = options.getRepetitions();
+	if ( threadCount == 0 )
+		threadCount = primitiveCount;
+
+	COLLADAFW::Mesh* mesh = createMesh( cornerCount, primitiveCount, false );
+	COLLADAFW::Mesh* packedMesh = createMesh( cornerCount, primitiveCount, true );
+	cornerCount = 0;
+	primitiveCount = mesh->getMeshPrimitives().getCount();
+	for ( size_t i = 0; i < primitiveCount; ++i )
+		cornerCount += mesh->getMeshPrimitives()[i]->getPositionIndexArray().getCount();
+
+	Benchmark::Results results;
+	std::vector<MapVertexBuffer> reference;
+	measureMap( *mesh, cornerCount, repetitions, reference, results );
+	size_t vertexCount = 0;
+	for ( size_t i = 0; i < reference.size(); ++i )
+		vertexCount += reference[i].positions.size() / 3;
+	measureBuilder( *mesh, cornerCount, COLLADAFW::VertexBuffer::INTERLEAVED, 1, false, repetitions, reference, results );
+	measureBuilder( *mesh, cornerCount, COLLADAFW::VertexBuffer::SEPARATE, 1, false, repetitions, reference, results );
+	if ( threadCount > 1 )
+	{
+		measureBuilder( *mesh, cornerCount, COLLADAFW::VertexBuffer::INTERLEAVED, threadCount, false, repetitions, reference, results );
+		measureBuilder( *mesh, cornerCount, COLLADAFW::VertexBuffer::SEPARATE, threadCount, false, repetitions, reference, results );
+	}
+
+	// the map approach stands for the writers, so it is only measured with the unpacked mesh
+	const size_t indexBytes = mesh->getIndicesMemorySize();
+	const size_t packedIndexBytes = packedMesh->getIndicesMemorySize();
+	measureBuilder( *packedMesh, cornerCount, COLLADAFW::VertexBuffer::INTERLEAVED, 1, true, repetitions, reference, results );
+	if ( threadCount > 1 )
+		measureBuilder( *packedMesh, cornerCount, COLLADAFW::VertexBuffer::INTERLEAVED, threadCount, true, repetitions, reference, results );
+	delete packedMesh;
+	delete mesh;
+
+	printf( "%u corners in %u primitives, %u vertices\n", (unsigned int)cornerCount, (unsigned int)primitiveCount, (unsigned int)vertexCount );
+	printf( "index memory: %u bytes, packed %u bytes\n", (unsigned int)indexBytes, (unsigned int)packedIndexBytes );
+	Benchmark::printResults( "corners", results );
+
+	if ( !options.getJsonFileName().empty() )
+	{
+		Benchmark::Parameters parameters;
+		Benchmark::addParameter( parameters, "corners", cornerCount );
+		Benchmark::addParameter( parameters, "primitives", primitiveCount );
+		Benchmark::addParameter( parameters, "vertices", vertexCount );
+		Benchmark::addParameter( parameters, "repetitions", repetitions );
+		Benchmark::addParameter( parameters, "indexBytes", indexBytes );
+		Benchmark::addParameter( parameters, "packedIndexBytes", packedIndexBytes );
+		if ( !Benchmark::writeJsonFile( options.getJsonFileName(), "OpenCOLLADAVertexBufferBenchmark", parameters, "corners", results ) )
+			return 1;
+	}
+	return Benchmark::allIdentical( results ) ? 0 : 1;
+}
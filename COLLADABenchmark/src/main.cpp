@@ -0,0 +1,439 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABenchmark.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "BenchmarkSceneGenerator.h"
+#include "BenchmarkCountingWriter.h"
+#include "BenchmarkPlatform.h"
+
+#include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLIErrorHandler.h"
+#include "COLLADASaxFWLIError.h"
+#include "COLLADASaxFWLTracer.h"
+#include "COLLADAFWRoot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+	static const char* XML_PARSER_NAME = "libxml";
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+	static const char* XML_PARSER_NAME = "expat";
+#else
+#	error "No prepocesser flag set to chose the xml parser to use"
+#endif
+
+
+namespace
+{
+	/** Counts the errors reported by the loader.*/
+	class CountingErrorHandler : public COLLADASaxFWL::IErrorHandler
+	{
+	public:
+		size_t mErrorCount;
+		size_t mCriticalErrorCount;
+		CountingErrorHandler() : mErrorCount(0), mCriticalErrorCount(0) {}
+		virtual bool handleError( const COLLADASaxFWL::IError* error )
+		{
+			++mErrorCount;
+			if ( error->getSeverity() == COLLADASaxFWL::IError::SEVERITY_CRITICAL )
+				++mCriticalErrorCount;
+			return false;
+		}
+	};
+
+	/** A scene of the benchmark suite.*/
+	struct Scene
+	{
+		std::string name;
+		Benchmark::SceneGenerator::Options options;
+	};
+
+	/** The results of one scene.*/
+	struct Result
+	{
+		Scene scene;
+		size_t fileCount;
+		size_t bytes;
+		double exportSeconds;
+		size_t exportPeakMemory;
+		double loadSecondsBest;
+		double loadSecondsMean;
+		size_t loadPeakMemory;
+		size_t loadErrors;
+		size_t loadCriticalErrors;
+		bool loadSucceeded;
+		Benchmark::CountingWriter::Counts counts;
+		COLLADASaxFWL::Loader::PrecisionErrors precisionErrors;
+	};
+
+	/** Command line options.*/
+	struct Arguments
+	{
+		std::string outputDirectory;
+		std::string jsonFileName;
+		std::string sceneName;
+		int iterations;
+		bool keepFiles;
+		bool trace;
+		bool customScene;
+		bool version14;
+		bool version15;
+		COLLADASaxFWL::Loader::NumericPrecision numericPrecision;
+		Benchmark::SceneGenerator::Options customOptions;
+
+		Arguments() : outputDirectory("."), iterations(3), keepFiles(false), trace(false), customScene(false), version14(true), version15(true), numericPrecision(COLLADASaxFWL::Loader::PRECISION_KEEP) {}
+	};
+
+	//------------------------------
+	void addScene( std::vector<Scene>& scenes, const std::string& name, size_t triangles, size_t nodes, size_t channels, size_t joints, size_t externals, const Arguments& arguments )
+	{
+		Scene scene;
+		scene.options.triangleCount = triangles;
+		scene.options.nodeCount = nodes;
+		scene.options.animationChannelCount = channels;
+		scene.options.skinJointCount = joints;
+		scene.options.externalReferenceCount = externals;
+		if ( arguments.customScene )
+			scene.options = arguments.customOptions;
+
+		if ( arguments.version14 )
+		{
+			scene.name = name + "_1.4";
+			scene.options.version = COLLADASW::StreamWriter::COLLADA_1_4_1;
+			scenes.push_back( scene );
+		}
+		if ( arguments.version15 )
+		{
+			scene.name = name + "_1.5";
+			scene.options.version = COLLADASW::StreamWriter::COLLADA_1_5_0;
+			scenes.push_back( scene );
+		}
+	}
+
+	//------------------------------
+	/** The default suite. Each scene stresses another part of the loader.*/
+	void createScenes( std::vector<Scene>& scenes, const Arguments& arguments )
+	{
+		if ( arguments.customScene )
+		{
+			addScene( scenes, "custom", 0, 0, 0, 0, 0, arguments );
+			return;
+		}
+		//                                 triangles  nodes  channels  joints  externals
+		addScene( scenes, "mesh",           1000000,     1,        0,      0,         0, arguments );
+		addScene( scenes, "nodes",                2, 20000,        0,      0,         0, arguments );
+		addScene( scenes, "animation",            2,   500,     3000,      0,         0, arguments );
+		addScene( scenes, "skin",            200000,    16,        0,     64,         0, arguments );
+		addScene( scenes, "external",         20000,    64,        0,      0,        16, arguments );
+
+		if ( !arguments.sceneName.empty() )
+		{
+			std::vector<Scene> selected;
+			for ( size_t i = 0; i < scenes.size(); ++i )
+			{
+				if ( scenes[i].name.compare( 0, arguments.sceneName.size(), arguments.sceneName ) == 0 )
+					selected.push_back( scenes[i] );
+			}
+			scenes.swap( selected );
+		}
+	}
+
+	//------------------------------
+	bool runScene( const Scene& scene, const Arguments& arguments, Result& result )
+	{
+		result.scene = scene;
+		std::string fileName = arguments.outputDirectory + "/benchmark_" + scene.name + ".dae";
+
+		// export
+		std::vector<std::string> files;
+		Benchmark::SceneGenerator generator( scene.options );
+		bool peakResettable = Benchmark::resetPeakMemory();
+		double start = Benchmark::getTime();
+		if ( !generator.generate( fileName, files ) )
+		{
+			std::cerr << "Could not write \"" << fileName << "\"." << std::endl;
+			return false;
+		}
+		result.exportSeconds = Benchmark::getTime() - start;
+		result.exportPeakMemory = peakResettable ? Benchmark::getPeakMemory() : 0;
+
+		result.fileCount = files.size();
+		result.bytes = 0;
+		for ( size_t i = 0; i < files.size(); ++i )
+			result.bytes += Benchmark::getFileSize( files[i] );
+
+		// load
+		result.loadSecondsBest = 0;
+		result.loadSecondsMean = 0;
+		result.loadPeakMemory = 0;
+		result.loadErrors = 0;
+		result.loadCriticalErrors = 0;
+		result.loadSucceeded = true;
+		for ( int iteration = 0; iteration < arguments.iterations; ++iteration )
+		{
+			CountingErrorHandler errorHandler;
+			Benchmark::CountingWriter writer;
+
+			peakResettable = Benchmark::resetPeakMemory();
+			start = Benchmark::getTime();
+			{
+				COLLADASaxFWL::Loader loader( &errorHandler );
+				loader.setNumericPrecision( arguments.numericPrecision );
+				COLLADAFW::Root root( &loader, &writer );
+				result.loadSucceeded = root.loadDocument( fileName ) && result.loadSucceeded;
+				result.precisionErrors = loader.getPrecisionErrors();
+			}
+			double seconds = Benchmark::getTime() - start;
+			size_t peakMemory = peakResettable ? Benchmark::getPeakMemory() : 0;
+
+			result.loadSecondsMean += seconds / arguments.iterations;
+			if ( iteration == 0 || seconds < result.loadSecondsBest )
+				result.loadSecondsBest = seconds;
+			if ( peakMemory > result.loadPeakMemory )
+				result.loadPeakMemory = peakMemory;
+			result.loadErrors += errorHandler.mErrorCount;
+			result.loadCriticalErrors += errorHandler.mCriticalErrorCount;
+			result.counts = writer.getCounts();
+			result.loadSucceeded = result.loadSucceeded && !writer.isCanceled();
+		}
+
+		// traced separately, so the tracing does not affect the measured times
+		if ( arguments.trace )
+		{
+			CountingErrorHandler errorHandler;
+			Benchmark::CountingWriter writer;
+			COLLADASaxFWL::Tracer tracer;
+			{
+				COLLADASaxFWL::Loader loader( &errorHandler );
+				loader.setTracer( &tracer );
+				loader.setNumericPrecision( arguments.numericPrecision );
+				COLLADAFW::Root root( &loader, &writer );
+				root.loadDocument( fileName );
+			}
+			std::string traceFileName = fileName + ".trace.json";
+			if ( !tracer.writeChromeTrace( traceFileName ) )
+				std::cerr << "Could not write \"" << traceFileName << "\"." << std::endl;
+		}
+
+		if ( !arguments.keepFiles )
+		{
+			for ( size_t i = 0; i < files.size(); ++i )
+				remove( files[i].c_str() );
+		}
+		return true;
+	}
+
+	//------------------------------
+	double megaBytesPerSecond( size_t bytes, double seconds )
+	{
+		return seconds > 0 ? bytes / ( 1024.0 * 1024.0 ) / seconds : 0;
+	}
+
+	//------------------------------
+	const char* getNumericPrecisionName( COLLADASaxFWL::Loader::NumericPrecision numericPrecision )
+	{
+		switch ( numericPrecision )
+		{
+		case COLLADASaxFWL::Loader::PRECISION_FLOAT: return "float";
+		case COLLADASaxFWL::Loader::PRECISION_QUANTIZED: return "quantized";
+		default: return "keep";
+		}
+	}
+
+	//------------------------------
+	void writeJson( std::ostream& stream, const Arguments& arguments, const std::vector<Result>& results )
+	{
+		stream << "{\n";
+		stream << "  \"benchmark\": \"OpenCOLLADABenchmark\",\n";
+		stream << "  \"xmlParser\": \"" << XML_PARSER_NAME << "\",\n";
+		stream << "  \"iterations\": " << arguments.iterations << ",\n";
+		stream << "  \"numericPrecision\": \"" << getNumericPrecisionName( arguments.numericPrecision ) << "\",\n";
+		stream << "  \"peakMemoryResettable\": " << ( Benchmark::resetPeakMemory() ? "true" : "false" ) << ",\n";
+		stream << "  \"scenes\": [";
+		for ( size_t i = 0; i < results.size(); ++i )
+		{
+			const Result& result = results[i];
+			const Benchmark::SceneGenerator::Options& options = result.scene.options;
+			const Benchmark::CountingWriter::Counts& counts = result.counts;
+			stream << ( i == 0 ? "\n" : ",\n" );
+			stream << "    {\n";
+			stream << "      \"name\": \"" << result.scene.name << "\",\n";
+			stream << "      \"colladaVersion\": \"" << ( options.version == COLLADASW::StreamWriter::COLLADA_1_5_0 ? "1.5.0" : "1.4.1" ) << "\",\n";
+			stream << "      \"triangles\": " << options.triangleCount << ",\n";
+			stream << "      \"nodes\": " << options.nodeCount << ",\n";
+			stream << "      \"animationChannels\": " << options.animationChannelCount << ",\n";
+			stream << "      \"animationKeys\": " << options.animationKeyCount << ",\n";
+			stream << "      \"skinJoints\": " << options.skinJointCount << ",\n";
+			stream << "      \"externalReferences\": " << options.externalReferenceCount << ",\n";
+			stream << "      \"files\": " << result.fileCount << ",\n";
+			stream << "      \"bytes\": " << result.bytes << ",\n";
+			stream << "      \"export\": { \"seconds\": " << result.exportSeconds
+				<< ", \"mbPerSecond\": " << megaBytesPerSecond( result.bytes, result.exportSeconds )
+				<< ", \"peakRssBytes\": " << result.exportPeakMemory << " },\n";
+			stream << "      \"load\": { \"secondsBest\": " << result.loadSecondsBest
+				<< ", \"secondsMean\": " << result.loadSecondsMean
+				<< ", \"mbPerSecond\": " << megaBytesPerSecond( result.bytes, result.loadSecondsBest )
+				<< ", \"peakRssBytes\": " << result.loadPeakMemory
+				<< ", \"errors\": " << result.loadErrors
+				<< ", \"criticalErrors\": " << result.loadCriticalErrors
+				<< ", \"success\": " << ( result.loadSucceeded ? "true" : "false" ) << " },\n";
+			stream << "      \"loaded\": { \"geometries\": " << counts.geometries
+				<< ", \"faces\": " << counts.faces
+				<< ", \"visualScenes\": " << counts.visualScenes
+				<< ", \"controllers\": " << counts.controllers
+				<< ", \"skinControllerData\": " << counts.skinControllerData
+				<< ", \"animations\": " << counts.animations
+				<< ", \"animationLists\": " << counts.animationLists << " },\n";
+			stream << "      \"precisionErrors\": { \"positions\": " << result.precisionErrors.positions
+				<< ", \"normals\": " << result.precisionErrors.normals
+				<< ", \"uvCoordinates\": " << result.precisionErrors.uvCoordinates
+				<< ", \"others\": " << result.precisionErrors.others << " }\n";
+			stream << "    }";
+		}
+		stream << "\n  ]\n}\n";
+	}
+
+	//------------------------------
+	void printHelpText( const char* programName )
+	{
+		std::cout << "Usage: " << programName << " [options]" << std::endl
+			<< "Generates synthetic COLLADA documents, measures the time to export and to load them and" << std::endl
+			<< "writes the results as JSON." << std::endl
+			<< "  -o <directory>   directory the documents are written to (default .)" << std::endl
+			<< "  -j <file>        file the JSON results are written to (default stdout)" << std::endl
+			<< "  -i <count>       number of loads of each document (default 3)" << std::endl
+			<< "  -s <name>        only run the scenes whose name starts with <name>" << std::endl
+			<< "  -k               keep the generated documents" << std::endl
+			<< "  -t               load each document once more with tracing and write the spans as Chrome" << std::endl
+			<< "                   trace JSON next to the document (<document>.trace.json)" << std::endl
+			<< "  -1.4, -1.5       only generate COLLADA 1.4.1 or 1.5.0 documents" << std::endl
+			<< "  -p <precision>   numeric precision of the loaded values: keep, float or quantized" << std::endl
+			<< "                   (default keep)" << std::endl
+			<< "A custom scene replaces the default suite, if one of the following options is passed:" << std::endl
+			<< "  -triangles <n>   triangles of each mesh" << std::endl
+			<< "  -nodes <n>       nodes in the visual scene" << std::endl
+			<< "  -channels <n>    animation channels" << std::endl
+			<< "  -keys <n>        keys of each animation channel" << std::endl
+			<< "  -joints <n>      skin joints" << std::endl
+			<< "  -externals <n>   externally referenced documents" << std::endl;
+	}
+
+	//------------------------------
+	bool parseArguments( int argc, char* argv[], Arguments& arguments )
+	{
+		for ( int i = 1; i < argc; ++i )
+		{
+			const char* argument = argv[i];
+			const char* value = i + 1 < argc ? argv[i + 1] : 0;
+			size_t* count = 0;
+			if ( strcmp( argument, "-k" ) == 0 )
+				arguments.keepFiles = true;
+			else if ( strcmp( argument, "-t" ) == 0 )
+				arguments.trace = true;
+			else if ( strcmp( argument, "-1.4" ) == 0 )
+				arguments.version15 = false;
+			else if ( strcmp( argument, "-1.5" ) == 0 )
+				arguments.version14 = false;
+			else if ( !value )
+				return false;
+			else if ( strcmp( argument, "-o" ) == 0 )
+				arguments.outputDirectory = argv[++i];
+			else if ( strcmp( argument, "-j" ) == 0 )
+				arguments.jsonFileName = argv[++i];
+			else if ( strcmp( argument, "-s" ) == 0 )
+				arguments.sceneName = argv[++i];
+			else if ( strcmp( argument, "-i" ) == 0 )
+				arguments.iterations = atoi( argv[++i] );
+			else if ( strcmp( argument, "-p" ) == 0 )
+			{
+				const char* precision = argv[++i];
+				if ( strcmp( precision, "keep" ) == 0 )
+					arguments.numericPrecision = COLLADASaxFWL::Loader::PRECISION_KEEP;
+				else if ( strcmp( precision, "float" ) == 0 )
+					arguments.numericPrecision = COLLADASaxFWL::Loader::PRECISION_FLOAT;
+				else if ( strcmp( precision, "quantized" ) == 0 )
+					arguments.numericPrecision = COLLADASaxFWL::Loader::PRECISION_QUANTIZED;
+				else
+					return false;
+			}
+			else if ( strcmp( argument, "-triangles" ) == 0 )
+				count = &arguments.customOptions.triangleCount;
+			else if ( strcmp( argument, "-nodes" ) == 0 )
+				count = &arguments.customOptions.nodeCount;
+			else if ( strcmp( argument, "-channels" ) == 0 )
+				count = &arguments.customOptions.animationChannelCount;
+			else if ( strcmp( argument, "-keys" ) == 0 )
+				count = &arguments.customOptions.animationKeyCount;
+			else if ( strcmp( argument, "-joints" ) == 0 )
+				count = &arguments.customOptions.skinJointCount;
+			else if ( strcmp( argument, "-externals" ) == 0 )
+				count = &arguments.customOptions.externalReferenceCount;
+			else
+				return false;
+
+			if ( count )
+			{
+				*count = (size_t)strtoul( argv[++i], 0, 10 );
+				arguments.customScene = true;
+			}
+		}
+		return arguments.iterations > 0 && ( arguments.version14 || arguments.version15 );
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	Arguments arguments;
+	if ( !parseArguments( argc, argv, arguments ) )
+	{
+		printHelpText( argv[0] );
+		return 2;
+	}
+
+	std::vector<Scene> scenes;
+	createScenes( scenes, arguments );
+
+	std::vector<Result> results;
+	bool success = true;
+	for ( size_t i = 0; i < scenes.size(); ++i )
+	{
+		std::cerr << "running " << scenes[i].name << std::endl;
+		Result result;
+		if ( !runScene( scenes[i], arguments, result ) )
+		{
+			success = false;
+			continue;
+		}
+		success = success && result.loadSucceeded && result.loadCriticalErrors == 0;
+		results.push_back( result );
+	}
+
+	if ( arguments.jsonFileName.empty() )
+	{
+		writeJson( std::cout, arguments, results );
+	}
+	else
+	{
+		std::ofstream jsonFile( arguments.jsonFileName.c_str() );
+		writeJson( jsonFile, arguments, results );
+		if ( !jsonFile )
+		{
+			std::cerr << "Could not write \"" << arguments.jsonFileName << "\"." << std::endl;
+			return 1;
+		}
+	}
+	return success ? 0 : 1;
+}
@@ -17,9 +17,11 @@
 #include "COLLADAFWAnimation.h"
 #include "COLLADAFWAnimationCurve.h"
 #include "COLLADAFWAnimationList.h"
+#include "COLLADAFWAnimationSampler.h"
 #include "COLLADAFWAnnotate.h"
 #include "COLLADAFWArray.h"
 #include "COLLADAFWArrayPrimitiveType.h"
+#include "COLLADAFWBoundingBox.h"
 #include "COLLADAFWCamera.h"
 #include "COLLADAFWColor.h"
 #include "COLLADAFWColorOrTexture.h"
@@ -40,6 +42,7 @@
 #include "COLLADAFWIWriter.h"
 #include "COLLADAFWImage.h"
 #include "COLLADAFWImageSource.h"
+#include "COLLADAFWIndexArray.h"
 #include "COLLADAFWIndexList.h"
 #include "COLLADAFWInstanceCamera.h"
 #include "COLLADAFWInstanceController.h"
@@ -71,30 +74,36 @@
 #include "COLLADAFWParam.h"
 #include "COLLADAFWPointerArray.h"
 #include "COLLADAFWPolygons.h"
+#include "COLLADAFWQuantizedArray.h"
 #include "COLLADAFWRoot.h"
 #include "COLLADAFWRotate.h"
 #include "COLLADAFWSampler.h"
 #include "COLLADAFWScale.h"
 #include "COLLADAFWScene.h"
+#include "COLLADAFWSceneBounds.h"
 #include "COLLADAFWSemantic.h"
 #include "COLLADAFWSetParam.h"
 #include "COLLADAFWShear.h"
 #include "COLLADAFWSkew.h"
 #include "COLLADAFWSkinController.h"
 #include "COLLADAFWSkinControllerData.h"
+#include "COLLADAFWSkinInfluences.h"
 #include "COLLADAFWSpline.h"
 #include "COLLADAFWTargetableValue.h"
 #include "COLLADAFWTechnique.h"
 #include "COLLADAFWTexture.h"
 #include "COLLADAFWTransformation.h"
+#include "COLLADAFWTransformHierarchy.h"
 #include "COLLADAFWTranslate.h"
 #include "COLLADAFWTriangles.h"
+#include "COLLADAFWTriangulator.h"
 #include "COLLADAFWTrifans.h"
 #include "COLLADAFWTristrips.h"
 #include "COLLADAFWTypes.h"
 #include "COLLADAFWUniqueId.h"
 #include "COLLADAFWValidate.h"
 #include "COLLADAFWValueType.h"
+#include "COLLADAFWVertexBufferBuilder.h"
 #include "COLLADAFWVisualScene.h"
 
 
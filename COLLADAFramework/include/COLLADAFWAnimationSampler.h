@@ -0,0 +1,176 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_ANIMATIONSAMPLER_H__
+#define __COLLADAFW_ANIMATIONSAMPLER_H__
+
+#include "COLLADAFWPrerequisites.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+
+	class AnimationCurve;
+
+	/** Evaluates many animation curves at many times, e.g. to bake animations into frames.
+	Each added curve is converted once into one cubic polynomial per key interval and output
+	dimension, so sampling neither reads the FloatOrDoubleArrays of the curve nor switches over
+	interpolation types. Linear and step intervals are polynomials of degree one and zero. Bezier
+	intervals use the in and out tangents as two dimensional control points, as defined by
+	COLLADA. Hermite intervals are converted to Bezier intervals, with the control points placed
+	a third of the tangents away from the keys. Cardinal and B-spline intervals are not supported
+	and are interpolated linearly, as are Bezier and Hermite intervals without tangents.
+	Times before the first key get the value of the first key, times after the last key the value
+	of the last key.
+	The sample times must be sorted in ascending order. For each curve, the key interval of a
+	sample is found by a binary search that starts at the interval of the previous sample, and all
+	following samples within the same interval are evaluated in one tight loop. The results are
+	written as structure of arrays, i.e. all samples of an output value (called channel) are
+	contiguous.
+	The curves do not need to stay valid after they have been added.*/
+	class AnimationSampler
+	{
+	private:
+
+		/** The data of an added curve.*/
+		struct CurveInfo
+		{
+			/** The number of keys. The curve has keyCount + 1 intervals, including the one before
+			the first and the one after the last key.*/
+			size_t keyCount;
+
+			/** The dimension of the output, i.e. the number of channels of the curve.*/
+			size_t dimension;
+
+			/** The index of the first key in mKeyTimes.*/
+			size_t firstKey;
+
+			/** The index of the first interval in mIntervals.*/
+			size_t firstInterval;
+
+			/** The index of the first interval channel in mIntervalChannels. The channels of an
+			interval are stored consecutively, one per output dimension.*/
+			size_t firstIntervalChannel;
+
+			/** The index of the first channel of the curve.*/
+			size_t firstChannel;
+		};
+
+		/** A key interval of a curve. The parameter of a sample at time t is
+		( t - startTime ) * timeScale.*/
+		struct Interval
+		{
+			double startTime;
+			double timeScale;
+		};
+
+		/** The polynomials of an interval for one output dimension.*/
+		struct IntervalChannel
+		{
+			/** The value at parameter s is ( ( value[3] * s + value[2] ) * s + value[1] ) * s + value[0].*/
+			double value[4];
+
+			/** If the key times are not evenly spaced by the control points of a Bezier interval,
+			the parameter s of a sample is the solution of
+			( ( time[2] * s + time[1] ) * s + time[0] ) * s = parameter of the sample.*/
+			double time[3];
+
+			/** True, if the parameter of a sample is used as s directly.*/
+			bool linearTime;
+		};
+
+		typedef std::vector<CurveInfo> CurveInfoList;
+		typedef std::vector<Interval> IntervalList;
+		typedef std::vector<IntervalChannel> IntervalChannelList;
+
+		/** The added curves.*/
+		CurveInfoList mCurves;
+
+		/** The key times of all added curves.*/
+		std::vector<double> mKeyTimes;
+
+		/** The intervals of all added curves.*/
+		IntervalList mIntervals;
+
+		/** The interval channels of all added curves.*/
+		IntervalChannelList mIntervalChannels;
+
+		/** The number of channels of all added curves.*/
+		size_t mChannelCount;
+
+	public:
+
+		/** Constructor. */
+		AnimationSampler();
+
+		/** Destructor. */
+		virtual ~AnimationSampler();
+
+		/** Adds @a curve and returns its index. A curve, whose value count does not match the key
+		count and the dimension, is added without keys and evaluates to zero.*/
+		size_t addCurve( const AnimationCurve& curve );
+
+		/** Removes all curves.*/
+		void clear();
+
+		/** Returns the number of added curves.*/
+		size_t getCurveCount() const { return mCurves.size(); }
+
+		/** Returns the number of channels of all added curves.*/
+		size_t getChannelCount() const { return mChannelCount; }
+
+		/** Returns the index of the first channel of the curve with index @a curveIndex. The
+		channels of a curve are consecutive, one per output dimension.*/
+		size_t getFirstChannel( size_t curveIndex ) const { return mCurves[curveIndex].firstChannel; }
+
+		/** Returns the number of channels of the curve with index @a curveIndex.*/
+		size_t getDimension( size_t curveIndex ) const { return mCurves[curveIndex].dimension; }
+
+		/** Evaluates all curves at the @a sampleCount ascending @a times. The value of channel c
+		at sample i is written to output[c * channelStride + i]. @a channelStride must be at
+		least @a sampleCount.*/
+		void sample( const double* times, size_t sampleCount, double* output, size_t channelStride ) const;
+
+		/** Evaluates all curves at the @a sampleCount ascending @a times. The value of channel c
+		at sample i is written to output[c * channelStride + i]. @a channelStride must be at
+		least @a sampleCount.*/
+		void sample( const double* times, size_t sampleCount, float* output, size_t channelStride ) const;
+
+		/** Evaluates the curve with index @a curveIndex at the @a sampleCount ascending @a times.
+		The value of dimension d at sample i is written to output[d * channelStride + i].*/
+		void sampleCurve( size_t curveIndex, const double* times, size_t sampleCount, double* output, size_t channelStride ) const;
+
+		/** Evaluates the curve with index @a curveIndex at the @a sampleCount ascending @a times.
+		The value of dimension d at sample i is written to output[d * channelStride + i].*/
+		void sampleCurve( size_t curveIndex, const double* times, size_t sampleCount, float* output, size_t channelStride ) const;
+
+	private:
+
+        /** Disable default copy ctor. */
+		AnimationSampler( const AnimationSampler& pre );
+
+        /** Disable default assignment operator. */
+		const AnimationSampler& operator= ( const AnimationSampler& pre );
+
+		/** Appends the interval channel of a constant @a value.*/
+		void appendConstantChannel( double value );
+
+		/** Evaluates the curve with index @a curveIndex. @a parameters and @a solvedParameters
+		must have room for @a sampleCount values.*/
+		template<class T>
+		void sampleCurveTemplate( size_t curveIndex, const double* times, size_t sampleCount, T* output, size_t channelStride, double* parameters, double* solvedParameters ) const;
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_ANIMATIONSAMPLER_H__
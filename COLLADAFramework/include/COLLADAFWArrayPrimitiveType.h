@@ -16,6 +16,7 @@ http://www.opensource.org/licenses/mit-license.php
 #include <string.h>
 #include <cassert>
 #include <stdlib.h>
+#include <algorithm>
 
 
 namespace COLLADAFW
@@ -40,7 +41,14 @@ namespace COLLADAFW
 			RELEASE_MEMORY					= 0x0001,
 			/** Keep the ownership of the data, when this array is assigned to another one, i.e.
 			it will release the memory on destruction, if the RELEASE_MEMORY flag is set.*/
-			KEEP_OWNERSHIP_ON_ASSIGNEMNT    = 0x0002
+			KEEP_OWNERSHIP_ON_ASSIGNEMNT    = 0x0002,
+			/** The data has not been allocated with malloc, e.g. it points into a memory mapped file. 
+			It is never released or reallocated. If the array grows, the data is copied into newly
+			allocated memory, which is owned by the array. Set by setExternalData().*/
+			EXTERNAL_MEMORY					= 0x0004,
+			/** Set by setExternalData(), if RELEASE_MEMORY was set before. RELEASE_MEMORY is set
+			again, when the external data is replaced.*/
+			RELEASE_MEMORY_AFTER_EXTERNAL	= 0x0008
 		};
 
 		enum FlagCombinations
@@ -99,6 +107,8 @@ namespace COLLADAFW
 		{
 			if ( mFlags & RELEASE_MEMORY)
 				releaseMemory();
+			else if ( mFlags & EXTERNAL_MEMORY )
+				setData ( 0, 0, 0 );
 		}
 
 		/** Returns the C-style data array.*/
@@ -107,22 +117,61 @@ namespace COLLADAFW
 		/** Returns the C-style data array.*/
 		const Type* getData () const { return mData; }
 
-		/** Set the C-style data array.*/
+		/** Set the C-style data array. Data passed to setExternalData() before is not used
+		anymore, and the array releases its memory again, if it did so before setExternalData().*/
 		void setData ( Type* data, const size_t count )
 		{
-			mData = data;
-			mCount = count;
-			mCapacity = count;
+			setData ( data, count, count );
 		}
 
-		/** Set the C-style data array and count.*/
+		/** Set the C-style data array and count. Data passed to setExternalData() before is not
+		used anymore, and the array releases its memory again, if it did so before
+		setExternalData().*/
 		void setData ( Type* data, const size_t count, const size_t capacity )
 		{
+			if ( mFlags & EXTERNAL_MEMORY )
+			{
+				if ( mFlags & RELEASE_MEMORY_AFTER_EXTERNAL )
+					mFlags |= RELEASE_MEMORY;
+				mFlags &= ~( EXTERNAL_MEMORY | RELEASE_MEMORY_AFTER_EXTERNAL );
+			}
 			mData = data;
 			mCount = count;
 			mCapacity = capacity;
 		}
 
+		/** Lets the array use @a data, that has not been allocated with malloc, e.g. memory mapped
+		from a file. Memory owned by the array is released before. The data is neither released nor
+		modified in size by the array. It must stay valid as long as the array uses it.*/
+		void setExternalData ( Type* data, const size_t count )
+		{
+			clear();
+			setData ( data, count );
+			if ( mFlags & RELEASE_MEMORY )
+				mFlags = ( mFlags & ~RELEASE_MEMORY ) | RELEASE_MEMORY_AFTER_EXTERNAL;
+			mFlags |= EXTERNAL_MEMORY;
+		}
+
+		/** True, if the array uses data passed to setExternalData().*/
+		bool hasExternalData () const { return ( mFlags & EXTERNAL_MEMORY ) != 0; }
+
+		/** Replaces data passed to setExternalData() by a copy owned by the array, so that the array
+		stays valid after the external data has been released. Does nothing for other data.*/
+		void copyExternalData ()
+		{
+			if ( !( mFlags & EXTERNAL_MEMORY ) )
+				return;
+			Type* data = 0;
+			if ( mCount > 0 )
+			{
+				data = ( Type* ) malloc ( mCount * sizeof ( Type ) );
+				memcpy ( ( void* ) data, ( const void* ) mData, mCount * sizeof ( Type ) );
+			}
+			setData ( data, mCount, mCount );
+			// nobody else knows the copy
+			mFlags |= RELEASE_MEMORY;
+		}
+
 		/** Returns the number of elements in the array.*/
 		const size_t getCount() const { return mCount; }
 
@@ -172,7 +221,15 @@ namespace COLLADAFW
 				newCapacity = minCapacity;
 			mCapacity = newCapacity;
 
-			if ( mData )
+			if ( mData && ( mFlags & EXTERNAL_MEMORY ) )
+			{
+				// external data can not be reallocated. Copy it and take the ownership of the copy
+				Type* data = ( Type* ) malloc ( mCapacity * sizeof ( Type ) );
+				memcpy ( ( void* ) data, ( const void* ) mData, mCount * sizeof ( Type ) );
+				mData = data;
+				mFlags = ( mFlags & ~( EXTERNAL_MEMORY | RELEASE_MEMORY_AFTER_EXTERNAL ) ) | RELEASE_MEMORY;
+			}
+			else if ( mData )
 			{
 				mData = ( Type* ) realloc ( mData, mCapacity * sizeof ( Type ) );
 				if ( mCount > mCapacity )
@@ -250,7 +307,18 @@ namespace COLLADAFW
 		/** Yield the owner ship of data to some else. The date will not be deleted by this array.*/
 		void yieldOwnerShip()
 		{
-			mFlags &= ~OWNER;
+			mFlags &= ~( OWNER | RELEASE_MEMORY_AFTER_EXTERNAL );
+		}
+
+		/** Swaps the data, the count, the capacity and the flags with @a other. This moves the
+		contents of an array into another one without copying them, e.g. by swapping with an
+		empty array.*/
+		void swap( ArrayPrimitiveType<Type>& other )
+		{
+			std::swap( mData, other.mData );
+			std::swap( mCount, other.mCount );
+			std::swap( mCapacity, other.mCapacity );
+			std::swap( mFlags, other.mFlags );
 		}
 
 	private:
@@ -0,0 +1,107 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_BOUNDINGBOX_H__
+#define __COLLADAFW_BOUNDINGBOX_H__
+
+#include "COLLADAFWPrerequisites.h"
+
+#include "Math/COLLADABUMathVector3.h"
+
+
+namespace COLLADABU
+{
+    namespace Math
+    {
+        class Matrix4;
+    }
+}
+
+
+namespace COLLADAFW
+{
+
+	/** An axis aligned bounding box. A box that does not contain any point is empty. Its minimum
+	is larger than its maximum, so that extending it by the first point makes the box contain
+	exactly that point.*/
+	class BoundingBox
+	{
+	private:
+
+		/** The smallest coordinates of all contained points.*/
+		COLLADABU::Math::Vector3 mMin;
+
+		/** The largest coordinates of all contained points.*/
+		COLLADABU::Math::Vector3 mMax;
+
+	public:
+
+		/** Constructor. Creates an empty box.*/
+		BoundingBox();
+
+		/** Constructor. Creates the box from @a min to @a max.*/
+		BoundingBox( const COLLADABU::Math::Vector3& min, const COLLADABU::Math::Vector3& max );
+
+		/** Destructor. */
+		virtual ~BoundingBox() {}
+
+		/** Returns true, if the box does not contain any point.*/
+		bool isEmpty() const { return mMin.x > mMax.x; }
+
+		/** Makes the box empty.*/
+		void clear();
+
+		/** The smallest coordinates of all contained points. Undefined, if the box is empty.*/
+		const COLLADABU::Math::Vector3& getMin() const { return mMin; }
+
+		/** The largest coordinates of all contained points. Undefined, if the box is empty.*/
+		const COLLADABU::Math::Vector3& getMax() const { return mMax; }
+
+		/** The center of the box. Zero, if the box is empty.*/
+		COLLADABU::Math::Vector3 getCenter() const;
+
+		/** The extent of the box along each axis. Zero, if the box is empty.*/
+		COLLADABU::Math::Vector3 getSize() const;
+
+		/** The radius of the bounding sphere around getCenter(), i.e. half the length of the
+		diagonal of the box. Zero, if the box is empty.*/
+		double getRadius() const;
+
+		/** Extends the box, so that it contains the point (@a x, @a y, @a z).*/
+		void extend( double x, double y, double z )
+		{
+			if ( x < mMin.x ) mMin.x = x;
+			if ( x > mMax.x ) mMax.x = x;
+			if ( y < mMin.y ) mMin.y = y;
+			if ( y > mMax.y ) mMax.y = y;
+			if ( z < mMin.z ) mMin.z = z;
+			if ( z > mMax.z ) mMax.z = z;
+		}
+
+		/** Extends the box, so that it contains @a box.*/
+		void extend( const BoundingBox& box );
+
+		/** Extends the box, so that it contains @a positionCount points, whose xyz coordinates
+		are stored one after the other in @a positions.*/
+		void extendByPositions( const float* positions, size_t positionCount );
+
+		/** Extends the box, so that it contains @a positionCount points, whose xyz coordinates
+		are stored one after the other in @a positions.*/
+		void extendByPositions( const double* positions, size_t positionCount );
+
+		/** Returns the smallest axis aligned box that contains this box transformed by @a matrix.
+		The matrix must be affine. The result is empty, if this box is empty.*/
+		BoundingBox transformed( const COLLADABU::Math::Matrix4& matrix ) const;
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_BOUNDINGBOX_H__
@@ -14,21 +14,26 @@
 #include "COLLADAFWPrerequisites.h"
 #include "COLLADAFWTypes.h"
 #include "COLLADAFWAnimatable.h"
+#include "COLLADAFWQuantizedArray.h"
+
+#include <vector>
 
 
 namespace COLLADAFW
 {
 
-	/** Holds either a float or a double array */
+	/** Holds either a float, a double or a quantized array */
 	class FloatOrDoubleArray : public Animatable
 	{
 	public:
-		/** Values can be stored as float or double values. */
+		/** Values can be stored as float or double values or as 16 bit integers, see
+		QuantizedArray. */
 		enum DataType
 		{
 			DATA_TYPE_FLOAT = 0,
 			DATA_TYPE_DOUBLE = 1,
 			DATA_TYPE_UNKNOWN = 2,
+			DATA_TYPE_QUANTIZED = 3,
 		};
 
 
@@ -40,6 +45,7 @@ namespace COLLADAFW
 		/** The position values. */
 		FloatArray mValuesF;
 		DoubleArray mValuesD;
+		QuantizedArray mValuesQ;
 
 	public:
 
@@ -57,7 +63,8 @@ namespace COLLADAFW
 		/** The data type of the stored values. */
 		void setType( DataType Type ) { mType = Type; }
 
-		/** Returns the count of stored elements in the array. For DATA_TYPE_UNKNOWN 0 is returned.*/
+		/** Returns the count of stored elements in the array. For DATA_TYPE_UNKNOWN 0 is returned.
+		For DATA_TYPE_QUANTIZED the count of the decoded values is returned.*/
 		size_t getValuesCount() const;
 
 		/** Returns if the array is empty. If type is DATA_TYPE_UNKNOWN, true is returned. Otherwise the array 
@@ -88,6 +95,39 @@ namespace COLLADAFW
 		/** Returns the values array as a double array. */
 		DoubleArray* getDoubleValues();
 
+		/** Returns the values array as a quantized array. */
+		const QuantizedArray* getQuantizedValues() const;
+
+		/** Returns the values array as a quantized array. */
+		QuantizedArray* getQuantizedValues();
+
+		/** Copies the values to @a values, decoding quantized values. @a values is cleared, if the
+		data type is DATA_TYPE_UNKNOWN.*/
+		void copyValues( std::vector<double>& values ) const;
+
+		/** Converts double values to float values and releases the double values. Values of the
+		other types are not changed.
+		@return The largest absolute difference between a double value and its float value.*/
+		double convertToFloat();
+
+		/** Replaces float or double values by a QuantizedArray with @a encoding, whose elements
+		have @a dimension components, and releases the float or double values. The dimension is
+		ignored for QuantizedArray::ENCODING_OCTAHEDRAL. Nothing is changed, if the values can not
+		be quantized, see QuantizedArray::encodeLinear() and QuantizedArray::encodeOctahedral().
+		@return True, if the values have been quantized.*/
+		bool quantize( QuantizedArray::Encoding encoding, size_t dimension );
+
+		/** Replaces quantized values by their decoded float values. Values of the other types are
+		not changed.*/
+		void dequantize();
+
+		/** Swaps the values and their data type with @a other, without copying the values. The
+		animation list is not swapped, since it belongs to the object the array is part of.*/
+		void swap( FloatOrDoubleArray& other );
+
+		/** Replaces external float or double values, e.g. mapped from a binary array file, by a copy
+		owned by the array, see ArrayPrimitiveType::copyExternalData().*/
+		void copyExternalData();
 
 		/** Set the C-style data array.*/
 		void setData( float* data, const size_t count );
@@ -105,12 +145,23 @@ namespace COLLADAFW
 		was large enough to hold another element. No new memory is allocated.*/
 		bool appendValues( const DoubleArray& valuesArray );
 
+		/** Quantizes @a valuesArray with @a encoding and @a dimension and appends it to the
+		quantized values, see QuantizedArray::appendLinear() and QuantizedArray::appendOctahedral().
+		An empty array of another type becomes a quantized array. Nothing is changed, if the array
+		contains float or double values or @a valuesArray can not be quantized.
+		@return True, if the values have been appended.*/
+		bool appendQuantized( const FloatArray& valuesArray, QuantizedArray::Encoding encoding, size_t dimension );
+		bool appendQuantized( const DoubleArray& valuesArray, QuantizedArray::Encoding encoding, size_t dimension );
+
 
 		/** Destructor. */
 		virtual ~FloatOrDoubleArray();
 
 	private:
 
+		template<class T>
+		bool appendQuantizedTemplate( const T* values, size_t valueCount, QuantizedArray::Encoding encoding, size_t dimension );
+
 
 		/** Disable default assignment operator. */
 		const FloatOrDoubleArray& operator= ( const FloatOrDoubleArray& pre );
@@ -38,6 +38,33 @@ namespace COLLADAFW
 	IMPORTANT: The write functions are called in arbitrary order.*/
 	class IWriter 	
 	{
+	public:
+
+		/** The kinds of objects passed to the write methods. Used to select the objects, whose
+		ownership is taken by the writer, see getOwnedObjects().*/
+		enum ObjectKind
+		{
+			OBJECT_NONE                 = 0,
+			OBJECT_GLOBAL_ASSET         = 1<< 0,
+			OBJECT_SCENE                = 1<< 1,
+			OBJECT_VISUAL_SCENE         = 1<< 2,
+			OBJECT_LIBRARY_NODES        = 1<< 3,
+			OBJECT_GEOMETRY             = 1<< 4,
+			OBJECT_MATERIAL             = 1<< 5,
+			OBJECT_EFFECT               = 1<< 6,
+			OBJECT_CAMERA               = 1<< 7,
+			OBJECT_IMAGE                = 1<< 8,
+			OBJECT_LIGHT                = 1<< 9,
+			OBJECT_ANIMATION            = 1<<10,
+			OBJECT_ANIMATION_LIST       = 1<<11,
+			OBJECT_SKIN_CONTROLLER_DATA = 1<<12,
+			OBJECT_CONTROLLER           = 1<<13,
+			OBJECT_FORMULAS             = 1<<14,
+			OBJECT_KINEMATICS_SCENE     = 1<<15,
+
+			OBJECT_ALL                  = (1<<16) - 1
+		};
+
 	private:
 	
 	public:
@@ -48,6 +75,26 @@ namespace COLLADAFW
         /** Destructor. */
         virtual ~IWriter() {};
 
+		/** Returns the kinds of objects (a combination of ObjectKind), whose ownership is
+		transferred to the writer, when they are passed to a write method. The writer can keep
+		these objects without copying them and must delete them with delete, when they are not
+		needed anymore. The loader might still read them while loading, so they must neither be
+		modified nor deleted before finish() has been called. The loader queries the kinds between
+		start() and finish(), so the returned value must not change in between.
+		Arrays of owned objects never refer to memory of the loader, e.g. values mapped from binary
+		array files, since the loader releases it when it is destroyed. Such values are copied into
+		the arrays before the objects are passed to the writer.
+		The default implementation takes the ownership of no objects.*/
+		virtual int getOwnedObjects() const { return OBJECT_NONE; }
+
+		/** Returns true, if the writer reads the values of meshes through
+		FloatOrDoubleArray::getQuantizedValues(), if their type is
+		FloatOrDoubleArray::DATA_TYPE_QUANTIZED. Otherwise the loader decodes quantized values to
+		float values, before it passes a mesh to writeGeometry(), so that writers that only read
+		float and double values keep working.
+		The default implementation returns false.*/
+		virtual bool acceptsQuantizedValues() const { return false; }
+
 		/** This method will be called if an error in the loading process occurred and the loader cannot
 		continue to to load. The writer should undo all operations that have been performed.
 		@param errorMessage A message containing informations about the error that occurred.
@@ -0,0 +1,257 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_INDEXARRAY_H__
+#define __COLLADAFW_INDEXARRAY_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWTypes.h"
+
+#include <iterator>
+#include <cstddef>
+
+
+namespace COLLADAFW
+{
+
+	/** An array of indices, that are stored with 8, 16 or 32 bits. If the number of values the
+	indices refer to is known before the indices are read, setWidth() chooses the smallest storage
+	and append() fills it directly. Otherwise pack() moves 32 bit indices into the smallest
+	storage afterwards. This reduces the memory of the indices to a half or a quarter.
+	Independent of the width, the indices can be read with operator[] and const_iterator, which
+	return them as unsigned int.*/
+	class IndexArray
+	{
+	public:
+
+		/** The number of bytes per index.*/
+		enum Width
+		{
+			WIDTH_8 = 1,
+			WIDTH_16 = 2,
+			WIDTH_32 = 4
+		};
+
+		/** Iterates over the indices of an IndexArray and returns them as unsigned int, independent
+		of the width they are stored with.*/
+		class const_iterator
+		{
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef unsigned int value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const unsigned int* pointer;
+			typedef unsigned int reference;
+
+		private:
+			/** The first byte of the current index.*/
+			const unsigned char* mPosition;
+
+			/** The width of the indices.*/
+			Width mWidth;
+
+		public:
+			const_iterator() : mPosition(0), mWidth(WIDTH_32) {}
+			const_iterator( const void* position, Width width ) : mPosition((const unsigned char*)position), mWidth(width) {}
+
+			unsigned int operator*() const { return read(mPosition, mWidth); }
+			unsigned int operator[]( difference_type n ) const { return read(mPosition + n * mWidth, mWidth); }
+
+			const_iterator& operator++() { mPosition += mWidth; return *this; }
+			const_iterator operator++( int ) { const_iterator it = *this; mPosition += mWidth; return it; }
+			const_iterator& operator--() { mPosition -= mWidth; return *this; }
+			const_iterator operator--( int ) { const_iterator it = *this; mPosition -= mWidth; return it; }
+			const_iterator& operator+=( difference_type n ) { mPosition += n * mWidth; return *this; }
+			const_iterator& operator-=( difference_type n ) { mPosition -= n * mWidth; return *this; }
+			const_iterator operator+( difference_type n ) const { return const_iterator(mPosition + n * mWidth, mWidth); }
+			const_iterator operator-( difference_type n ) const { return const_iterator(mPosition - n * mWidth, mWidth); }
+			difference_type operator-( const const_iterator& rhs ) const { return (mPosition - rhs.mPosition) / mWidth; }
+
+			bool operator==( const const_iterator& rhs ) const { return mPosition == rhs.mPosition; }
+			bool operator!=( const const_iterator& rhs ) const { return mPosition != rhs.mPosition; }
+			bool operator<( const const_iterator& rhs ) const { return mPosition < rhs.mPosition; }
+			bool operator>( const const_iterator& rhs ) const { return mPosition > rhs.mPosition; }
+			bool operator<=( const const_iterator& rhs ) const { return mPosition <= rhs.mPosition; }
+			bool operator>=( const const_iterator& rhs ) const { return mPosition >= rhs.mPosition; }
+
+		private:
+			/** Reads an index with @a width at @a position.*/
+			static unsigned int read( const unsigned char* position, Width width )
+			{
+				switch ( width )
+				{
+				case WIDTH_8: return *position;
+				case WIDTH_16: return *(const unsigned short*)position;
+				default: return *(const unsigned int*)position;
+				}
+			}
+		};
+
+	private:
+
+		/** The width the indices are currently stored with.*/
+		Width mWidth;
+
+		/** The indices, if they are stored with 32 bits. If they are stored with 8 or 16 bits, a
+		32 bit copy of them created by the const getIndices32(), that is valid as long as it has as
+		many indices as the packed array.*/
+		mutable UIntValuesArray mIndices32;
+
+		/** The indices, if they are stored with 16 bits.*/
+		ArrayPrimitiveType<unsigned short> mIndices16;
+
+		/** The indices, if they are stored with 8 bits.*/
+		ArrayPrimitiveType<unsigned char> mIndices8;
+
+	public:
+
+		/** Constructor. Creates an empty array with 32 bit indices.*/
+		IndexArray();
+
+		/** The width the indices are currently stored with.*/
+		Width getWidth() const { return mWidth; }
+
+		/** The number of indices.*/
+		size_t getCount() const
+		{
+			switch ( mWidth )
+			{
+			case WIDTH_8: return mIndices8.getCount();
+			case WIDTH_16: return mIndices16.getCount();
+			default: return mIndices32.getCount();
+			}
+		}
+
+		/** Returns true, if there are no indices.*/
+		bool empty() const { return getCount() == 0; }
+
+		/** Returns the index with @a index, independent of the width. No check is performed, if the
+		index is out of bounds.*/
+		unsigned int operator[]( size_t index ) const
+		{
+			switch ( mWidth )
+			{
+			case WIDTH_8: return mIndices8[index];
+			case WIDTH_16: return mIndices16[index];
+			default: return mIndices32[index];
+			}
+		}
+
+		/** An iterator to the first index.*/
+		const_iterator begin() const { return const_iterator(getData(), mWidth); }
+
+		/** An iterator behind the last index.*/
+		const_iterator end() const { return begin() + getCount(); }
+
+		/** The indices as 32 bit array. Indices stored with 8 or 16 bits are unpacked first, since
+		the returned array may be modified. To read the indices without unpacking them, use
+		operator[] or const_iterator.*/
+		UIntValuesArray& getIndices32() { unpack(); return mIndices32; }
+
+		/** The indices as 32 bit array. Indices stored with 8 or 16 bits stay packed. They are
+		widened into a copy owned by the array, which is created on the first call and kept until
+		the indices are modified. This costs the memory of the 32 bit indices in addition to the
+		packed ones, and it is not thread safe. To read the indices without the copy, use operator[]
+		or const_iterator.*/
+		const UIntValuesArray& getIndices32() const
+		{
+			if ( (mWidth != WIDTH_32) && (mIndices32.getCount() != getCount()) )
+				copyToIndices32();
+			return mIndices32;
+		}
+
+		/** The indices, if they are stored with 16 bits, 0 otherwise.*/
+		const unsigned short* getIndices16() const { return mWidth == WIDTH_16 ? mIndices16.getData() : 0; }
+
+		/** The indices, if they are stored with 8 bits, 0 otherwise.*/
+		const unsigned char* getIndices8() const { return mWidth == WIDTH_8 ? mIndices8.getData() : 0; }
+
+		/** Replaces the indices by a copy of @a indices, stored with 32 bits.*/
+		void assign( const UIntValuesArray& indices );
+
+		/** Appends @a index with the current width. If the index does not fit into the width, the
+		indices are unpacked to 32 bits before.*/
+		void append( unsigned int index )
+		{
+			switch ( mWidth )
+			{
+			case WIDTH_8:
+				if ( index <= 0xFF )
+				{
+					mIndices8.append( (unsigned char)index );
+					return;
+				}
+				break;
+			case WIDTH_16:
+				if ( index <= 0xFFFF )
+				{
+					mIndices16.append( (unsigned short)index );
+					return;
+				}
+				break;
+			default:
+				mIndices32.append( index );
+				return;
+			}
+			unpack();
+			mIndices32.append( index );
+		}
+
+		/** Erases the last @a n indices.*/
+		void erase( size_t n );
+
+		/** Allocates memory for at least @a capacity indices of the current width.*/
+		void reserve( size_t capacity );
+
+		/** Sets the width new indices are stored with. The array must be empty, the allocated
+		capacity is kept. Use getWidthForValueCount() to choose the width from the number of values
+		the indices refer to.*/
+		void setWidth( Width width );
+
+		/** Moves the 32 bit indices into the smallest storage, that can address @a valueCount values,
+		and releases the 32 bit array. If an index is not smaller than @a valueCount, the width is
+		chosen from the largest index instead. Packing an array that is already packed or uses
+		external data does nothing.*/
+		void pack( size_t valueCount );
+
+		/** Moves the indices back into the 32 bit array, e.g. to append further indices.*/
+		void unpack();
+
+		/** The number of bytes allocated for the indices.*/
+		size_t getMemorySize() const;
+
+		/** Swaps the indices and their width with @a other, without copying them.*/
+		void swap( IndexArray& other );
+
+		/** Returns the smallest width that can address @a valueCount values.*/
+		static Width getWidthForValueCount( size_t valueCount );
+
+	private:
+
+        /** Disable default copy ctor. */
+		IndexArray( const IndexArray& pre );
+
+        /** Disable default assignment operator. */
+		const IndexArray& operator= ( const IndexArray& pre );
+
+		/** The first byte of the indices of the current width.*/
+		const void* getData() const;
+
+		/** The number of indices, for which memory of the current width is allocated.*/
+		size_t getCapacity() const;
+
+		/** Copies the 8 or 16 bit indices into mIndices32, without changing the width.*/
+		void copyToIndices32() const;
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_INDEXARRAY_H__
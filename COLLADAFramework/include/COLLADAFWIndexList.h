@@ -13,6 +13,7 @@
 
 #include "COLLADAFWPrerequisites.h"
 #include "COLLADAFWTypes.h"
+#include "COLLADAFWIndexArray.h"
 
 
 namespace COLLADAFW
@@ -22,7 +23,7 @@ namespace COLLADAFW
     {
     private:
         String mName;
-        UIntValuesArray mIndices;
+        IndexArray mIndices;
         size_t mStride;
         size_t mSetIndex;
         size_t mInitialIndex;
@@ -30,7 +31,6 @@ namespace COLLADAFW
     public:
         IndexList ()
             : mName ("")
-			, mIndices ( UIntValuesArray::OWNER )
             , mStride (0)
             , mSetIndex (0)
             , mInitialIndex (0)
@@ -44,8 +44,18 @@ namespace COLLADAFW
         {}*/
         virtual ~IndexList () {}
 
-		UIntValuesArray& getIndices () { return mIndices; }
-		const UIntValuesArray& getIndices () const { return mIndices; }
+		/** The indices as 32 bit array. Packed indices are unpacked, see IndexArray::getIndices32().*/
+		UIntValuesArray& getIndices () { return mIndices.getIndices32(); }
+		/** The indices as 32 bit array. Packed indices are widened into a copy, see IndexArray::getIndices32().*/
+		const UIntValuesArray& getIndices () const { return mIndices.getIndices32(); }
+		/** The indices, independent of the width they are stored with.*/
+		IndexArray& getIndexArray () { return mIndices; }
+		/** The indices, independent of the width they are stored with.*/
+		const IndexArray& getIndexArray () const { return mIndices; }
+		/** Stores the indices with the smallest width, that can address @a valueCount values.*/
+		void packIndices ( size_t valueCount ) { mIndices.pack ( valueCount ); }
+		/** Moves the indices back to 32 bit storage.*/
+		void unpackIndices () { mIndices.unpack (); }
         unsigned int getIndex ( size_t index ) const { return mIndices [index]; }
         size_t getIndicesCount () const { return mIndices.getCount (); }
 
@@ -15,6 +15,7 @@
 #include "COLLADAFWGeometry.h"
 #include "COLLADAFWMeshVertexData.h"
 #include "COLLADAFWMeshPrimitive.h"
+#include "COLLADAFWBoundingBox.h"
 
 #include "COLLADABUUtils.h"
 
@@ -91,6 +92,12 @@ namespace COLLADAFW
         */
         MeshPrimitiveArray mMeshPrimitives;
 
+        /**
+        * The bounding box of all positions of the mesh. The loader extends it while the positions
+        * are read, so it is available without walking the positions again.
+        */
+        BoundingBox mBoundingBox;
+
     public:
 
         /** Constructor. */
@@ -251,6 +258,23 @@ namespace COLLADAFW
         */
         MeshVertexData& getBinormals () { return mBinormals; }
 
+        /**
+        * The bounding box of all positions of the mesh, in the coordinate system of the mesh.
+        * It is empty, if the mesh has no positions.
+        */
+        const BoundingBox& getBoundingBox () const { return mBoundingBox; }
+
+        /**
+        * The bounding box of all positions of the mesh, in the coordinate system of the mesh.
+        * It is empty, if the mesh has no positions.
+        */
+        BoundingBox& getBoundingBox () { return mBoundingBox; }
+
+        /**
+        * The bounding box of all positions of the mesh, in the coordinate system of the mesh.
+        */
+        void setBoundingBox ( const BoundingBox& boundingBox ) { mBoundingBox = boundingBox; }
+
         /**
         * Geometric primitives, which assemble values from the inputs into vertex attribute data. 
         * Can be any combination of the following in any order:
@@ -341,6 +365,22 @@ namespace COLLADAFW
          */
         const size_t getFacesCount () const;
 
+        /**
+        * Stores the index lists of all primitives with the smallest width, that can address
+        * the values of the mesh. See MeshPrimitive::packIndices().
+        */
+        void packIndices ();
+
+        /**
+        * Moves the index lists of all primitives back to 32 bit storage.
+        */
+        void unpackIndices ();
+
+        /**
+        * The number of bytes allocated for the index lists of all primitives.
+        */
+        size_t getIndicesMemorySize () const;
+
     };
 }
 
@@ -17,6 +17,8 @@
 #include "COLLADAFWTypes.h"
 #include "COLLADAFWEdge.h"
 #include "COLLADAFWIndexList.h"
+#include "COLLADAFWIndexArray.h"
+#include "COLLADAFWBoundingBox.h"
 
 #include <map>
 #include <vector>
@@ -25,6 +27,8 @@
 namespace COLLADAFW
 {
 
+    class Mesh;
+
     /**
     Geometric primitives, which assemble values from the inputs into vertex attribute data. 
     Can be any combination of any primitive types in any order. 
@@ -101,22 +105,22 @@ namespace COLLADAFW
 		/** 
         * The index list of the positions array. 
         */
-        UIntValuesArray mPositionIndices;
+        IndexArray mPositionIndices;
 
         /** 
         * The index list of the normals array. 
         */
-        UIntValuesArray mNormalIndices;
+        IndexArray mNormalIndices;
 
         /** 
         * The index list of the tangent array (support of multiple uv sets). 
         */
-        UIntValuesArray mTangentIndices;
+        IndexArray mTangentIndices;
 
         /** 
         * The index list of the binormal array (support of multiple uv sets). 
         */
-        UIntValuesArray mBinormalIndices;
+        IndexArray mBinormalIndices;
         
 
         /** 
@@ -129,6 +133,12 @@ namespace COLLADAFW
         */
         IndexListArray mUVCoordIndicesArray;
 
+        /**
+        * The bounding box of the positions referenced by the primitive. The loader extends it
+        * while the position indices are read.
+        */
+        BoundingBox mBoundingBox;
+
     public:	
 
         /**
@@ -181,32 +191,30 @@ namespace COLLADAFW
 		/** 
 		* The index list of the positions array. 
 		*/
-		UIntValuesArray& getPositionIndices () { return mPositionIndices; }
+		UIntValuesArray& getPositionIndices () { return mPositionIndices.getIndices32(); }
 
-		/** 
-		* The index list of the positions array. 
-		*/
-		const UIntValuesArray& getPositionIndices () const { return mPositionIndices; }
+		/** The index list of the positions array as 32 bit array. Packed indices are widened into a
+		copy, see IndexArray::getIndices32(). Prefer getPositionIndexArray().*/
+		const UIntValuesArray& getPositionIndices () const { return mPositionIndices.getIndices32(); }
 
         /** 
         * The index list of the positions array. 
         */
-        void setPositionIndices ( const UIntValuesArray& PositionIndices ) { mPositionIndices = PositionIndices; }
+        void setPositionIndices ( const UIntValuesArray& PositionIndices ) { mPositionIndices.assign ( PositionIndices ); }
 
 		/** 
 		* The index list of the normals array. 
 		*/
-		UIntValuesArray& getNormalIndices () { return mNormalIndices; }
+		UIntValuesArray& getNormalIndices () { return mNormalIndices.getIndices32(); }
 
-		/** 
-		* The index list of the normals array. 
-		*/
-		const UIntValuesArray& getNormalIndices () const{ return mNormalIndices; }
+		/** The index list of the normals array as 32 bit array. Packed indices are widened into a
+		copy, see IndexArray::getIndices32(). Prefer getNormalIndexArray().*/
+		const UIntValuesArray& getNormalIndices () const { return mNormalIndices.getIndices32(); }
 
         /** 
         * The index list of the normals array. 
         */
-        void setNormalIndices ( const UIntValuesArray& NormalIndices ) { mNormalIndices = NormalIndices; }
+        void setNormalIndices ( const UIntValuesArray& NormalIndices ) { mNormalIndices.assign ( NormalIndices ); }
 
 		/**Returns true if the mesh primitive has normals.*/
 		bool hasNormalIndices() const { return !mNormalIndices.empty(); }
@@ -214,17 +222,16 @@ namespace COLLADAFW
         /** 
 		* The index list of the normals array. 
 		*/
-		UIntValuesArray& getTangentIndices () { return mTangentIndices; }
+		UIntValuesArray& getTangentIndices () { return mTangentIndices.getIndices32(); }
 
-		/** 
-		* The index list of the normals array. 
-		*/
-        const UIntValuesArray& getTangentIndices () const{ return mTangentIndices; }
+		/** The index list of the tangents array as 32 bit array. Packed indices are widened into a
+		copy, see IndexArray::getIndices32(). Prefer getTangentIndexArray().*/
+		const UIntValuesArray& getTangentIndices () const { return mTangentIndices.getIndices32(); }
 
         /** 
         * The index list of the normals array. 
         */
-        void setTagentIndices ( const UIntValuesArray& TangentIndices ) { mTangentIndices = TangentIndices; }
+        void setTagentIndices ( const UIntValuesArray& TangentIndices ) { mTangentIndices.assign ( TangentIndices ); }
 
 		/**Returns true if the mesh primitive has normals.*/
 		bool hasTangentIndices() const { return !mTangentIndices.empty(); }
@@ -232,21 +239,52 @@ namespace COLLADAFW
         		/** 
 		* The index list of the normals array. 
 		*/
-		UIntValuesArray& getBinormalIndices () { return mBinormalIndices; }
+		UIntValuesArray& getBinormalIndices () { return mBinormalIndices.getIndices32(); }
 
-		/** 
-		* The index list of the normals array. 
-		*/
-		const UIntValuesArray& getBinormalIndices () const{ return mBinormalIndices; }
+		/** The index list of the binormals array as 32 bit array. Packed indices are widened into a
+		copy, see IndexArray::getIndices32(). Prefer getBinormalIndexArray().*/
+		const UIntValuesArray& getBinormalIndices () const { return mBinormalIndices.getIndices32(); }
 
         /** 
         * The index list of the normals array. 
         */
-        void setBinormalIndices ( const UIntValuesArray& BinormalIndices ) { mBinormalIndices = BinormalIndices; }
+        void setBinormalIndices ( const UIntValuesArray& BinormalIndices ) { mBinormalIndices.assign ( BinormalIndices ); }
 
 		/**Returns true if the mesh primitive has normals.*/
 		bool hasBinormalIndices() const { return !mBinormalIndices.empty(); }
 
+		/** The index list of the positions array, independent of the width the indices are stored
+		with. Unlike getPositionIndices(), it neither unpacks nor copies packed indices.*/
+		IndexArray& getPositionIndexArray () { return mPositionIndices; }
+
+		/** The index list of the positions array, independent of the width the indices are stored
+		with. Unlike getPositionIndices(), it neither unpacks nor copies packed indices.*/
+		const IndexArray& getPositionIndexArray () const { return mPositionIndices; }
+
+		/** The index list of the normals array, independent of the width the indices are stored
+		with. Unlike getNormalIndices(), it neither unpacks nor copies packed indices.*/
+		IndexArray& getNormalIndexArray () { return mNormalIndices; }
+
+		/** The index list of the normals array, independent of the width the indices are stored
+		with. Unlike getNormalIndices(), it neither unpacks nor copies packed indices.*/
+		const IndexArray& getNormalIndexArray () const { return mNormalIndices; }
+
+		/** The index list of the tangents array, independent of the width the indices are stored
+		with. Unlike getTangentIndices(), it neither unpacks nor copies packed indices.*/
+		IndexArray& getTangentIndexArray () { return mTangentIndices; }
+
+		/** The index list of the tangents array, independent of the width the indices are stored
+		with. Unlike getTangentIndices(), it neither unpacks nor copies packed indices.*/
+		const IndexArray& getTangentIndexArray () const { return mTangentIndices; }
+
+		/** The index list of the binormals array, independent of the width the indices are stored
+		with. Unlike getBinormalIndices(), it neither unpacks nor copies packed indices.*/
+		IndexArray& getBinormalIndexArray () { return mBinormalIndices; }
+
+		/** The index list of the binormals array, independent of the width the indices are stored
+		with. Unlike getBinormalIndices(), it neither unpacks nor copies packed indices.*/
+		const IndexArray& getBinormalIndexArray () const { return mBinormalIndices; }
+
         /** 
         * The index list of the colors array. 
         */
@@ -326,6 +364,31 @@ namespace COLLADAFW
 		/** Sets the material id of the sub mesh. This material id is used to assign material 
 		to submeshes when the mesh gets instantiated.*/
 		void setMaterialId(MaterialId val) { mMaterialId = val; }
+
+		/** @return The bounding box of the positions referenced by the primitive, in the coordinate
+		system of the mesh. It is empty, if the primitive has no position indices.*/
+		const BoundingBox& getBoundingBox() const { return mBoundingBox; }
+
+		/** @return The bounding box of the positions referenced by the primitive, in the coordinate
+		system of the mesh. It is empty, if the primitive has no position indices.*/
+		BoundingBox& getBoundingBox() { return mBoundingBox; }
+
+		/** Sets the bounding box of the positions referenced by the primitive.*/
+		void setBoundingBox(const BoundingBox& boundingBox) { mBoundingBox = boundingBox; }
+
+		/** Stores all index lists of the primitive with the smallest width, that can address the
+		values of the corresponding array of @a mesh. Packed indices are read without copies through
+		getPositionIndexArray(), ... and IndexList::getIndexArray(). getPositionIndices(),
+		getNormalIndices(), ... and IndexList::getIndices() still return all indices, the non const
+		ones unpack the lists and the const ones widen them into a copy.*/
+		void packIndices ( const Mesh& mesh );
+
+		/** Moves all index lists back to 32 bit storage, so that they can be accessed through
+		the UIntValuesArrays again.*/
+		void unpackIndices ();
+
+		/** The number of bytes allocated for all index lists of the primitive.*/
+		size_t getIndicesMemorySize () const;
 		
         /*
         * Determine the number of grouped vertex elements in the current mesh primitive.
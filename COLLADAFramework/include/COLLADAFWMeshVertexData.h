@@ -85,13 +85,7 @@ namespace COLLADAFW
         {
             setType ( DATA_TYPE_FLOAT );
 			FloatOrDoubleArray::appendValues ( valuesArray );
-
-            InputInfos* info = new InputInfos();
-            info->mLength = valuesArray.getCount ();
-            info->mName = name;
-            info->mStride = stride;
-
-            mInputInfosArray.append ( info );
+            appendInputInfos ( name, stride, valuesArray.getCount () );
         }
 
         /**
@@ -105,9 +99,20 @@ namespace COLLADAFW
         {
             setType ( DATA_TYPE_DOUBLE );
 			FloatOrDoubleArray::appendValues ( valuesArray );
+            appendInputInfos ( name, stride, valuesArray.getCount () );
+        }
 
+        /**
+        * Stores the information of an input, whose values have been appended with the methods
+        * of the FloatOrDoubleArray, e.g. quantized.
+        * @param const String& name The name of the input.
+        * @param const size_t stride The data stride.
+        * @param const size_t length The number of appended values.
+        */
+        void appendInputInfos ( const String& name, const size_t stride, const size_t length )
+        {
             InputInfos* info = new InputInfos();
-            info->mLength = valuesArray.getCount ();
+            info->mLength = length;
             info->mName = name;
             info->mStride = stride;
 
@@ -62,6 +62,13 @@ namespace COLLADAFW
 			ArrayPrimitiveType<T*>::mCount = newCount;
 		}
 
+		/** Swaps the pointers with @a other. In contrast to the copy ctor and the assignment
+		operator, the objects are not cloned.*/
+		void swap( PointerArray<T>& other )
+		{
+			ArrayPrimitiveType<T*>::swap( other );
+		}
+
         /** Disable default assignment operator. */
 		const PointerArray& operator=( const PointerArray& pre )
 		{
@@ -0,0 +1,203 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_QUANTIZEDARRAY_H__
+#define __COLLADAFW_QUANTIZEDARRAY_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWArrayPrimitiveType.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+
+	/** An array of real values, that are stored as 16 bit integers. The values are grouped into
+	elements, e.g. the three coordinates of a position. With ENCODING_LINEAR each component of the
+	elements has a scale and a bias, that map the range of the component to 0..65535. With
+	ENCODING_OCTAHEDRAL each element is a direction with three components, that is stored as two
+	integers by projecting it onto an octahedron. Values can be appended to the array, e.g. one
+	source after the other. With ENCODING_LINEAR the appended values form a segment with scales and
+	biases of their own, so the values already in the array are not encoded again. The array keeps
+	the largest absolute error of a value, that has been measured while encoding.*/
+	class QuantizedArray
+	{
+	public:
+
+		/** How the values are mapped to the integers.*/
+		enum Encoding
+		{
+			ENCODING_LINEAR,
+			ENCODING_OCTAHEDRAL
+		};
+
+		/** The largest number of components of an element.*/
+		static const size_t MAX_DIMENSION = 4;
+
+	private:
+
+		/** Values, that have been encoded together with ENCODING_LINEAR.*/
+		struct LinearSegment
+		{
+			/** The index of the first value of the segment.*/
+			size_t firstValue;
+
+			/** The number of components of an element of the segment.*/
+			size_t dimension;
+
+			/** A value of component i is decoded as biases[i] + integer * scales[i].*/
+			double scales[MAX_DIMENSION];
+			double biases[MAX_DIMENSION];
+		};
+
+		typedef std::vector<LinearSegment> LinearSegments;
+
+		/** How the values are mapped to the integers.*/
+		Encoding mEncoding;
+
+		/** The number of decoded values of an element.*/
+		size_t mDimension;
+
+		/** The encoded values.*/
+		ArrayPrimitiveType<unsigned short> mValues;
+
+		/** The segments ordered by their first value. Only used with ENCODING_LINEAR.*/
+		LinearSegments mSegments;
+
+		/** The largest absolute difference between a value passed to encode and its decoded value.*/
+		double mMaxError;
+
+	public:
+
+		/** Constructor. Creates an empty array.*/
+		QuantizedArray();
+
+		/** Destructor. */
+		virtual ~QuantizedArray() {}
+
+		/** How the values are mapped to the integers.*/
+		Encoding getEncoding() const { return mEncoding; }
+
+		/** The number of decoded values of an element. If linear segments with different
+		dimensions have been appended, each value is an element of its own and 1 is returned.*/
+		size_t getDimension() const { return mDimension; }
+
+		/** The number of elements.*/
+		size_t getElementCount() const;
+
+		/** The number of decoded values, i.e. the element count multiplied with the dimension.*/
+		size_t getValuesCount() const { return getElementCount() * mDimension; }
+
+		/** Returns true, if there are no values.*/
+		bool empty() const { return mValues.getCount() == 0; }
+
+		/** The encoded values. With ENCODING_LINEAR there is one integer per value, with
+		ENCODING_OCTAHEDRAL there are two integers per element.*/
+		const ArrayPrimitiveType<unsigned short>& getEncodedValues() const { return mValues; }
+
+		/** The number of segments, i.e. of calls of encodeLinear() and appendLinear() since the
+		array has been empty. Only used with ENCODING_LINEAR.*/
+		size_t getSegmentCount() const { return mSegments.size(); }
+
+		/** The index of the first value of segment @a segment.*/
+		size_t getSegmentFirstValue( size_t segment ) const { return mSegments[segment].firstValue; }
+
+		/** The number of components of an element of segment @a segment.*/
+		size_t getSegmentDimension( size_t segment ) const { return mSegments[segment].dimension; }
+
+		/** The scale of component @a component in segment @a segment. Only used with
+		ENCODING_LINEAR.*/
+		double getScale( size_t component, size_t segment = 0 ) const { return segment < mSegments.size() ? mSegments[segment].scales[component] : 0; }
+
+		/** The bias of component @a component in segment @a segment. Only used with
+		ENCODING_LINEAR.*/
+		double getBias( size_t component, size_t segment = 0 ) const { return segment < mSegments.size() ? mSegments[segment].biases[component] : 0; }
+
+		/** The largest absolute difference between a value passed to encode and its decoded value.
+		For ENCODING_OCTAHEDRAL it includes the change of the length of directions, that are not
+		normalized.*/
+		double getMaxError() const { return mMaxError; }
+
+		/** The number of bytes allocated for the encoded values.*/
+		size_t getMemorySize() const { return mValues.getCapacity() * sizeof(unsigned short); }
+
+		/** Replaces the values by the @a valueCount values at @a values, whose elements have
+		@a dimension components. The scale and bias of each component are chosen from the range of
+		the component. NaN values are decoded as the minimum of their component and are not part of
+		getMaxError(). If @a valueCount is not a multiple of @a dimension or @a dimension is 0 or
+		larger than MAX_DIMENSION, the array is left empty and false is returned.*/
+		bool encodeLinear( const float* values, size_t valueCount, size_t dimension );
+		bool encodeLinear( const double* values, size_t valueCount, size_t dimension );
+
+		/** As encodeLinear(), but appends the values as a new segment, whose scales and biases are
+		chosen from the range of the appended values only. The dimension may differ from the one of
+		the previous segments. If the array contains octahedral encoded values or the values can
+		not be encoded, the array is not changed and false is returned.*/
+		bool appendLinear( const float* values, size_t valueCount, size_t dimension );
+		bool appendLinear( const double* values, size_t valueCount, size_t dimension );
+
+		/** Replaces the values by the directions at @a values, which has three values per direction.
+		The directions are normalized, so directions that are not of unit length are decoded with a
+		different length, which is part of getMaxError(). A zero direction and directions with NaN
+		components are decoded as (0, 0, 1).
+		If @a valueCount is not a multiple of three, the array is left empty and false is returned.*/
+		bool encodeOctahedral( const float* values, size_t valueCount );
+		bool encodeOctahedral( const double* values, size_t valueCount );
+
+		/** As encodeOctahedral(), but appends the directions. If the array contains linear encoded
+		values or @a valueCount is not a multiple of three, the array is not changed and false is
+		returned.*/
+		bool appendOctahedral( const float* values, size_t valueCount );
+		bool appendOctahedral( const double* values, size_t valueCount );
+
+		/** Writes the @a valueCount decoded values starting at value @a firstValue to
+		@a destination. No check is performed, if the values are out of range.*/
+		void decode( size_t firstValue, size_t valueCount, float* destination ) const;
+		void decode( size_t firstValue, size_t valueCount, double* destination ) const;
+
+		/** Removes all values.*/
+		void clear();
+
+		/** Copies all values into @a destination.*/
+		void cloneArray( QuantizedArray& destination ) const;
+
+		/** Swaps the values, the encoding and its parameters with @a other, without copying the
+		encoded values.*/
+		void swap( QuantizedArray& other );
+
+	private:
+
+        /** Disable default copy ctor. */
+		QuantizedArray( const QuantizedArray& pre );
+
+        /** Disable default assignment operator. */
+		const QuantizedArray& operator= ( const QuantizedArray& pre );
+
+		template<class T>
+		bool appendLinearTemplate( const T* values, size_t valueCount, size_t dimension );
+
+		template<class T>
+		bool appendOctahedralTemplate( const T* values, size_t valueCount );
+
+		template<class T>
+		void decodeTemplate( size_t firstValue, size_t valueCount, T* destination ) const;
+
+		/** Returns the index of the linear segment, that contains value @a value.*/
+		size_t findSegment( size_t value ) const;
+
+		/** Decodes the direction of the octahedral encoded element @a element into @a direction.*/
+		void decodeDirection( size_t element, double direction[3] ) const;
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_QUANTIZEDARRAY_H__
@@ -0,0 +1,139 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_SCENEBOUNDS_H__
+#define __COLLADAFW_SCENEBOUNDS_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWBoundingBox.h"
+#include "COLLADAFWUniqueId.h"
+
+#include "Math/COLLADABUMathMatrix4.h"
+
+#include <map>
+#include <vector>
+
+
+namespace COLLADAFW
+{
+
+	class Geometry;
+	class Controller;
+	class VisualScene;
+	class LibraryNodes;
+	class Node;
+
+	/** Calculates the world space bounding boxes of visual scenes from the bounding boxes of the
+	meshes, which are calculated by the loader, and the transformations of the nodes. No vertex
+	data is read. The bounding box of each instantiated mesh is transformed into world space,
+	which results in a box that contains the transformed mesh, but might be larger than the
+	bounding box of the transformed positions.
+	The objects can be added in any order, e.g. in the order they are passed to an IWriter.
+	Only the data needed for the calculation is copied, so the objects do not need to stay valid
+	after they have been added. Instance controllers use the bounding box of the source geometry
+	of the controller, so deformations are not taken into account.*/
+	class SceneBounds
+	{
+	private:
+
+		/** The data of a node needed to calculate the bounding box.*/
+		struct NodeInfo
+		{
+			/** The transformation of the node relative to its parent.*/
+			COLLADABU::Math::Matrix4 transformation;
+
+			/** The ids of the geometries and controllers instantiated by the node.*/
+			std::vector<UniqueId> instantiatedGeometries;
+
+			/** The ids of the nodes instantiated by the node.*/
+			std::vector<UniqueId> instantiatedNodes;
+
+			/** The indices of the child nodes in mNodeInfos.*/
+			std::vector<size_t> childNodes;
+		};
+
+		typedef std::vector<NodeInfo> NodeInfoList;
+		typedef std::vector<size_t> NodeIndexList;
+		typedef std::map<UniqueId, size_t> UniqueIdNodeIndexMap;
+		typedef std::map<UniqueId, NodeIndexList> UniqueIdNodeIndexListMap;
+		typedef std::map<UniqueId, BoundingBox> UniqueIdBoundingBoxMap;
+		typedef std::map<UniqueId, UniqueId> UniqueIdUniqueIdMap;
+
+		/** The nodes of all added visual scenes and library nodes.*/
+		NodeInfoList mNodeInfos;
+
+		/** Maps the unique id of each node to its index in mNodeInfos.*/
+		UniqueIdNodeIndexMap mNodeIndices;
+
+		/** Maps the unique id of each added visual scene to the indices of its root nodes.*/
+		UniqueIdNodeIndexListMap mVisualSceneRootNodes;
+
+		/** The bounding boxes of all added meshes.*/
+		UniqueIdBoundingBoxMap mGeometryBoundingBoxes;
+
+		/** Maps the unique id of each added controller to the unique id of its source.*/
+		UniqueIdUniqueIdMap mControllerSources;
+
+	public:
+
+		/** Constructor. */
+		SceneBounds();
+
+		/** Destructor. */
+		virtual ~SceneBounds();
+
+		/** Adds the bounding box of @a geometry. Only meshes have a bounding box, other geometries
+		are ignored.*/
+		void addGeometry( const Geometry& geometry );
+
+		/** Adds @a controller, so that instances of the controller use the bounding box of its
+		source geometry.*/
+		void addController( const Controller& controller );
+
+		/** Adds the nodes of @a visualScene.*/
+		void addVisualScene( const VisualScene& visualScene );
+
+		/** Adds the nodes of @a libraryNodes, so that they can be instantiated by instance nodes.*/
+		void addLibraryNodes( const LibraryNodes& libraryNodes );
+
+		/** Returns the world space bounding box of the visual scene with @a visualSceneId. The box
+		is empty, if the visual scene has not been added or does not instantiate any mesh with
+		positions. Instances of geometries, controllers and nodes that have not been added are
+		ignored.*/
+		BoundingBox getBoundingBox( const UniqueId& visualSceneId ) const;
+
+		/** Returns the world space bounding box of all added visual scenes.*/
+		BoundingBox getBoundingBox() const;
+
+	private:
+
+        /** Disable default copy ctor. */
+		SceneBounds( const SceneBounds& pre );
+
+        /** Disable default assignment operator. */
+		const SceneBounds& operator= ( const SceneBounds& pre );
+
+		/** Adds @a node and all its child nodes to mNodeInfos and returns the index of @a node.*/
+		size_t addNode( const Node& node );
+
+		/** Returns the bounding box of the geometry or controller with @a uniqueId. Empty, if it
+		is unknown.*/
+		BoundingBox getInstantiatedBoundingBox( const UniqueId& uniqueId ) const;
+
+		/** Extends @a boundingBox by the node with index @a nodeIndex, whose parent has the world
+		matrix @a parentMatrix. @a visiting marks the nodes on the current path, to stop at
+		instance nodes that instantiate one of their ancestors.*/
+		void extendByNode( size_t nodeIndex, const COLLADABU::Math::Matrix4& parentMatrix, std::vector<bool>& visiting, BoundingBox& boundingBox ) const;
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_SCENEBOUNDS_H__
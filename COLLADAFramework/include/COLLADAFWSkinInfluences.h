@@ -0,0 +1,208 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_SKININFLUENCES_H__
+#define __COLLADAFW_SKININFLUENCES_H__
+
+#include "COLLADAFWPrerequisites.h"
+
+#include "Math/COLLADABUMathMatrix4.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+
+	class SkinControllerData;
+
+	/** The joint influences of the vertices of a skin controller with a fixed number of influences
+	per vertex, as expected by skinning on the GPU or in batches on the CPU.
+	SkinControllerData stores a variable number of joint index / weight index pairs per vertex and
+	the weights in a separate array. build() converts them into getInfluenceCount() joint indices
+	and weights per vertex. The influences of a vertex are sorted by decreasing weight, negligible
+	influences and those that exceed the influence count are dropped, and the remaining weights are
+	normalized to a sum of 1. Unused influences have joint index 0 and weight 0.
+	The influences are stored as structure of arrays: influence k of vertex i is stored at
+	k * getVertexCount() + i, so a loop over the vertices reads consecutive values.
+	Influences with joint index -1, which bind a vertex to the bind shape itself, and vertices without
+	any weight use the joint index getJointCount(). The skinning matrices therefore consist of one
+	matrix per joint followed by the bind shape matrix, see setMatrices().*/
+	class SkinInfluences
+	{
+	public:
+
+		/** The number of influences stored per vertex.*/
+		enum InfluenceCount
+		{
+			INFLUENCES_4 = 4,
+			INFLUENCES_8 = 8
+		};
+
+		/** How the weights are stored.*/
+		enum WeightFormat
+		{
+			WEIGHT_FLOAT,	/**< 32 bit floats.*/
+			WEIGHT_UNORM16,	/**< 16 bit unsigned integers, 65535 is a weight of 1.*/
+			WEIGHT_UNORM8	/**< 8 bit unsigned integers, 255 is a weight of 1.*/
+		};
+
+		/** The number of floats of each skinning matrix: the upper three rows of a 4x4 matrix
+		in row major order. The last row is always 0, 0, 0, 1.*/
+		static const size_t MATRIX_SIZE = 12;
+
+		/** The default weight threshold, see setWeightThreshold().*/
+		static const float DEFAULT_WEIGHT_THRESHOLD;
+
+	private:
+
+		/** The number of influences stored per vertex.*/
+		InfluenceCount mInfluenceCount;
+
+		/** How the weights are stored.*/
+		WeightFormat mWeightFormat;
+
+		/** Influences, whose normalized weight is below the threshold, are dropped.*/
+		float mWeightThreshold;
+
+		/** The number of vertices.*/
+		size_t mVertexCount;
+
+		/** The number of joints of the skin controller.*/
+		size_t mJointCount;
+
+		/** The largest number of influences with a weight other than 0 of a vertex. All vertices
+		have weight 0 in the influences behind it.*/
+		size_t mUsedInfluenceCount;
+
+		/** The number of influences of the skin controller, that have been dropped.*/
+		size_t mDroppedInfluenceCount;
+
+		/** The largest sum of the normalized weights, that have been dropped from a vertex.*/
+		float mMaxDroppedWeight;
+
+		/** The joint indices, getInfluenceCount() * getVertexCount() values.*/
+		std::vector<unsigned short> mJointIndices;
+
+		/** The weights, if the weight format is WEIGHT_FLOAT.*/
+		std::vector<float> mWeights;
+
+		/** The weights, if the weight format is WEIGHT_UNORM16.*/
+		std::vector<unsigned short> mWeights16;
+
+		/** The weights, if the weight format is WEIGHT_UNORM8.*/
+		std::vector<unsigned char> mWeights8;
+
+	public:
+
+		/** Constructor. Creates empty influences, that are built with @a influenceCount influences
+		per vertex and weights in @a weightFormat.*/
+		SkinInfluences( InfluenceCount influenceCount = INFLUENCES_4, WeightFormat weightFormat = WEIGHT_FLOAT );
+
+		/** Destructor. */
+		virtual ~SkinInfluences();
+
+		/** The number of influences stored per vertex.*/
+		InfluenceCount getInfluenceCount() const { return mInfluenceCount; }
+
+		/** The number of influences stored per vertex. Used by the next build().*/
+		void setInfluenceCount( InfluenceCount influenceCount ) { mInfluenceCount = influenceCount; }
+
+		/** How the weights are stored.*/
+		WeightFormat getWeightFormat() const { return mWeightFormat; }
+
+		/** How the weights are stored. Used by the next build().*/
+		void setWeightFormat( WeightFormat weightFormat ) { mWeightFormat = weightFormat; }
+
+		/** Influences, whose weight divided by the sum of the weights of the vertex is below the
+		threshold, are dropped.*/
+		float getWeightThreshold() const { return mWeightThreshold; }
+
+		/** Influences, whose weight divided by the sum of the weights of the vertex is below
+		@a weightThreshold, are dropped. Used by the next build().*/
+		void setWeightThreshold( float weightThreshold ) { mWeightThreshold = weightThreshold; }
+
+		/** Builds the influences of all vertices of @a skinControllerData on up to @a threadCount
+		threads. Influences with a negative weight or with a joint or weight index out of range are
+		dropped. If threads cannot be created, the remaining vertices are built on the calling thread.
+		@return False, if the joint or weight indices are fewer than the sum of the joints per vertex
+		or if there are more than 65535 joints. The influences are empty then.*/
+		bool build( const SkinControllerData& skinControllerData, size_t threadCount = 1 );
+
+		/** The number of vertices.*/
+		size_t getVertexCount() const { return mVertexCount; }
+
+		/** The number of joints of the skin controller.*/
+		size_t getJointCount() const { return mJointCount; }
+
+		/** The number of skinning matrices the influences refer to, i.e. the number of joints
+		plus the bind shape matrix.*/
+		size_t getMatrixCount() const { return mJointCount + 1; }
+
+		/** The largest number of influences with a weight other than 0 of a vertex. The influences
+		behind it have weight 0 for all vertices and can be skipped.*/
+		size_t getUsedInfluenceCount() const { return mUsedInfluenceCount; }
+
+		/** The number of influences of the skin controller, that have been dropped by build().*/
+		size_t getDroppedInfluenceCount() const { return mDroppedInfluenceCount; }
+
+		/** The largest sum of the normalized weights, that have been dropped from a vertex by build().*/
+		float getMaxDroppedWeight() const { return mMaxDroppedWeight; }
+
+		/** The joint indices of influence @a influenceIndex of all vertices.*/
+		const unsigned short* getJointIndices( size_t influenceIndex ) const { return &mJointIndices[influenceIndex * mVertexCount]; }
+
+		/** The weights of influence @a influenceIndex of all vertices, if the weight format is
+		WEIGHT_FLOAT.*/
+		const float* getWeights( size_t influenceIndex ) const { return &mWeights[influenceIndex * mVertexCount]; }
+
+		/** The weights of influence @a influenceIndex of all vertices, if the weight format is
+		WEIGHT_UNORM16.*/
+		const unsigned short* getWeights16( size_t influenceIndex ) const { return &mWeights16[influenceIndex * mVertexCount]; }
+
+		/** The weights of influence @a influenceIndex of all vertices, if the weight format is
+		WEIGHT_UNORM8.*/
+		const unsigned char* getWeights8( size_t influenceIndex ) const { return &mWeights8[influenceIndex * mVertexCount]; }
+
+		/** Returns the weight of influence @a influenceIndex of vertex @a vertexIndex as float,
+		independent of the weight format.*/
+		float getWeight( size_t influenceIndex, size_t vertexIndex ) const;
+
+		/** Writes the getMatrixCount() skinning matrices to @a matrices, MATRIX_SIZE floats each.
+		The matrix of joint j is jointMatrices[j] * inverse bind matrix j * bind shape matrix,
+		where @a jointMatrices are the world matrices of the joints. The last matrix is the bind
+		shape matrix. Missing inverse bind matrices are treated as identity.*/
+		void setMatrices( const SkinControllerData& skinControllerData, const COLLADABU::Math::Matrix4* jointMatrices, float* matrices ) const;
+
+		/** Skins the positions of @a vertexCount vertices starting at @a firstVertex with
+		@a matrices, as written by setMatrices(), by linear blending. @a positions and
+		@a skinnedPositions contain three floats per vertex and start at vertex @a firstVertex.
+		Disjoint vertex ranges can be skinned on several threads.*/
+		void skinPositions( const float* matrices, const float* positions, float* skinnedPositions, size_t firstVertex, size_t vertexCount ) const;
+
+	private:
+
+		class BuildBody;
+		friend class BuildBody;
+
+        /** Disable default copy ctor. */
+		SkinInfluences( const SkinInfluences& pre );
+
+        /** Disable default assignment operator. */
+		const SkinInfluences& operator= ( const SkinInfluences& pre );
+
+		/** Deletes the built influences.*/
+		void clear();
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_SKININFLUENCES_H__
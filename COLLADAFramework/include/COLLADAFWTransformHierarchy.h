@@ -0,0 +1,216 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_TRANSFORMHIERARCHY_H__
+#define __COLLADAFW_TRANSFORMHIERARCHY_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWUniqueId.h"
+
+#include "COLLADABUFlatHashMap.h"
+#include "Math/COLLADABUMathMatrix4.h"
+
+#include <map>
+#include <vector>
+
+
+namespace COLLADAFW
+{
+
+	class VisualScene;
+	class LibraryNodes;
+	class Node;
+
+	/** Calculates the world matrices of the nodes of a visual scene without walking the node tree.
+	The node tree of a visual scene is flattened into an array of entries in depth first order, i.e.
+	each node is followed by its child nodes and the nodes it instantiates through instance nodes.
+	Every entry stores the index of its parent entry, which is always smaller than its own index,
+	and the end of its subtree, which is a contiguous range of entries. A node that is instantiated
+	more than once gets an entry for each instance.
+	The local and world matrices are stored in two contiguous arrays of 16 doubles per entry in
+	row major order, so evaluate() calculates all world matrices in a single loop over the arrays.
+	When the local matrix of a node changes, e.g. by an animation, only the subtrees of the entries of
+	that node are calculated again by the next evaluate().
+	The objects can be added in any order, e.g. in the order they are passed to an IWriter. Only the
+	node ids, the node matrices and the structure of the node tree are copied, so the objects do not
+	need to stay valid after they have been added.*/
+	class TransformHierarchy
+	{
+	public:
+
+		/** The parent index of the entries of the root nodes and the index returned, if there
+		is no matching entry.*/
+		static const size_t NO_ENTRY;
+
+		/** The number of values of each matrix in the matrix arrays.*/
+		static const size_t MATRIX_SIZE = 16;
+
+		/** An entry of the flattened node tree.*/
+		struct Entry
+		{
+			/** The unique id of the node.*/
+			UniqueId nodeId;
+
+			/** The index of the parent entry or NO_ENTRY for root nodes.*/
+			size_t parent;
+
+			/** The index behind the last entry of the subtree of this entry. The subtree consists of
+			this entry and all entries up to, but excluding, subtreeEnd.*/
+			size_t subtreeEnd;
+		};
+
+	private:
+
+		/** The data of a node needed to flatten the node tree.*/
+		struct NodeInfo
+		{
+			/** The unique id of the node.*/
+			UniqueId nodeId;
+
+			/** The transformation of the node relative to its parent.*/
+			COLLADABU::Math::Matrix4 transformation;
+
+			/** The indices of the child nodes in mNodeInfos.*/
+			std::vector<size_t> childNodes;
+
+			/** The ids of the nodes instantiated by the node.*/
+			std::vector<UniqueId> instantiatedNodes;
+		};
+
+		typedef std::vector<NodeInfo> NodeInfoList;
+		typedef std::vector<size_t> NodeIndexList;
+		typedef std::map<UniqueId, size_t> UniqueIdNodeIndexMap;
+		typedef std::map<UniqueId, NodeIndexList> UniqueIdNodeIndexListMap;
+		typedef std::vector<Entry> EntryList;
+		typedef std::vector<double> MatrixArray;
+		typedef std::vector<size_t> EntryIndexList;
+		typedef COLLADABU::FlatHashMap<UniqueId, size_t> UniqueIdEntryIndexMap;
+
+		/** The nodes of all added visual scenes and library nodes.*/
+		NodeInfoList mNodeInfos;
+
+		/** Maps the unique id of each node to its index in mNodeInfos.*/
+		UniqueIdNodeIndexMap mNodeIndices;
+
+		/** Maps the unique id of each added visual scene to the indices of its root nodes.*/
+		UniqueIdNodeIndexListMap mVisualSceneRootNodes;
+
+		/** The entries of the flattened node tree.*/
+		EntryList mEntries;
+
+		/** The local matrices of the entries, MATRIX_SIZE values per entry.*/
+		MatrixArray mLocalMatrices;
+
+		/** The world matrices of the entries, MATRIX_SIZE values per entry.*/
+		MatrixArray mWorldMatrices;
+
+		/** Maps the unique id of each node to its first entry. The further entries of the node are
+		linked by mNextNodeEntries.*/
+		UniqueIdEntryIndexMap mFirstNodeEntries;
+
+		/** The index of the next entry with the same node as the entry, NO_ENTRY for the last one.*/
+		EntryIndexList mNextNodeEntries;
+
+		/** The entries whose local matrix has been changed since the last evaluation.*/
+		EntryIndexList mDirtyEntries;
+
+		/** True, if all world matrices need to be calculated by the next evaluation.*/
+		bool mAllDirty;
+
+	public:
+
+		/** Constructor. */
+		TransformHierarchy();
+
+		/** Destructor. */
+		virtual ~TransformHierarchy();
+
+		/** Adds the nodes of @a visualScene.*/
+		void addVisualScene( const VisualScene& visualScene );
+
+		/** Adds the nodes of @a libraryNodes, so that they can be instantiated by instance nodes.*/
+		void addLibraryNodes( const LibraryNodes& libraryNodes );
+
+		/** Flattens the node tree of the visual scene with @a visualSceneId. The previous entries are
+		replaced. Instance nodes that instantiate a node that has not been added or one of their
+		own ancestors are ignored. All world matrices are calculated by the next evaluate().
+		@return False, if the visual scene has not been added.*/
+		bool flatten( const UniqueId& visualSceneId );
+
+		/** Returns the number of entries of the flattened node tree.*/
+		size_t getEntryCount() const { return mEntries.size(); }
+
+		/** Returns the entry with index @a entryIndex.*/
+		const Entry& getEntry( size_t entryIndex ) const { return mEntries[entryIndex]; }
+
+		/** Returns the index of the first entry of the node with @a nodeId or NO_ENTRY, if the
+		node is not part of the flattened node tree.*/
+		size_t getFirstNodeEntry( const UniqueId& nodeId ) const;
+
+		/** Returns the index of the entry that follows @a entryIndex and has the same node or
+		NO_ENTRY, if @a entryIndex is the last entry of the node.*/
+		size_t getNextNodeEntry( size_t entryIndex ) const { return mNextNodeEntries[entryIndex]; }
+
+		/** Sets the local matrix of the entry with index @a entryIndex. The world matrices of its
+		subtree are calculated by the next evaluate().*/
+		void setLocalMatrix( size_t entryIndex, const COLLADABU::Math::Matrix4& localMatrix );
+
+		/** Sets the local matrix of all entries of the node with @a nodeId, e.g. after an
+		animation changed the transformations of the node.
+		@return The number of entries of the node.*/
+		size_t setLocalMatrix( const UniqueId& nodeId, const COLLADABU::Math::Matrix4& localMatrix );
+
+		/** Calculates the world matrices of the entries, whose local matrix or the local matrix
+		of one of its ancestors has changed since the last evaluation.
+		@return The number of calculated world matrices.*/
+		size_t evaluate();
+
+		/** Writes the local matrix of the entry with index @a entryIndex to @a localMatrix.*/
+		void getLocalMatrix( size_t entryIndex, COLLADABU::Math::Matrix4& localMatrix ) const;
+
+		/** Writes the world matrix of the entry with index @a entryIndex to @a worldMatrix. Only
+		valid after evaluate() has been called.*/
+		void getWorldMatrix( size_t entryIndex, COLLADABU::Math::Matrix4& worldMatrix ) const;
+
+		/** Returns the MATRIX_SIZE values of the world matrix of the entry with index
+		@a entryIndex in row major order.*/
+		const double* getWorldMatrixValues( size_t entryIndex ) const { return &mWorldMatrices[entryIndex * MATRIX_SIZE]; }
+
+		/** Multiplies the row major 4x4 matrices @a left and @a right and writes the product to
+		@a result, which must not overlap with @a left or @a right. Uses SSE2 or AVX, if the
+		compiler targets them and COLLADAFW_CONCATENATE_SCALAR is not defined.*/
+		static void concatenate( const double* left, const double* right, double* result );
+
+	private:
+
+        /** Disable default copy ctor. */
+		TransformHierarchy( const TransformHierarchy& pre );
+
+        /** Disable default assignment operator. */
+		const TransformHierarchy& operator= ( const TransformHierarchy& pre );
+
+		/** Adds @a node and all its child nodes to mNodeInfos and returns the index of @a node.*/
+		size_t addNode( const Node& node );
+
+		/** Appends the entries of the node with index @a nodeIndex and its subtree. @a visiting
+		marks the nodes on the current path, to stop at instance nodes that instantiate one of
+		their ancestors.*/
+		void appendEntries( size_t nodeIndex, size_t parentEntryIndex, std::vector<bool>& visiting );
+
+		/** Calculates the world matrices of the entries from @a firstEntryIndex up to, but
+		excluding, @a endEntryIndex. The world matrices of the parents of the entries before
+		@a firstEntryIndex must be valid.*/
+		void evaluateEntries( size_t firstEntryIndex, size_t endEntryIndex );
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_TRANSFORMHIERARCHY_H__
@@ -0,0 +1,106 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_TRIANGULATOR_H__
+#define __COLLADAFW_TRIANGULATOR_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWMeshPrimitive.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+
+	class Mesh;
+
+	/** Splits the faces of all primitives of a mesh into triangles. The triangles of a primitive are
+	stored as a flat list of corner indices, three per triangle. A corner index is the position of the
+	corner in the index arrays of the primitive, so it can be used to look up the position, normal,
+	texture coordinate, ... index of the corner, or the vertex of a VertexBuffer built from the
+	same primitive.
+	Triangles, polylists, polygons, triangle fans and triangle strips are triangulated. Lines, line
+	strips and points have no triangles. The winding of the triangles is that of the faces. Strip
+	triangles whose corners share a position index, as used to stitch strips, are skipped.
+	Each primitive is triangulated in one pass over its face vertex counts and the primitives are
+	independent of each other, so they can be triangulated on several threads.*/
+	class Triangulator
+	{
+	public:
+
+		/** How polygons with more than three vertices are split.*/
+		enum Method
+		{
+			FAN,			/**< Triangles from the first vertex to each edge. Fast, but correct for
+								convex faces only.*/
+			EAR_CLIPPING	/**< The faces are projected on their plane and ears are cut off until
+								a triangle remains. Correct for concave faces. Convex faces are
+								detected and split into a fan.*/
+		};
+
+		/** Corner indices, three per triangle.*/
+		typedef std::vector<unsigned int> TriangleCornerList;
+
+	private:
+
+		/** The mesh whose primitives are triangulated.*/
+		const Mesh& mMesh;
+
+		/** How polygons are split.*/
+		Method mMethod;
+
+		/** The triangles of each primitive of the mesh.*/
+		std::vector<TriangleCornerList> mTriangleCorners;
+
+	public:
+
+		/** Constructor. @a mesh must stay valid until triangulate() returns.*/
+		Triangulator( const Mesh& mesh, Method method = FAN );
+
+		/** Destructor. */
+		virtual ~Triangulator();
+
+		/** Triangulates all primitives of the mesh on up to @a threadCount threads. The triangles of a
+		previous call are replaced. If threads cannot be created, the remaining primitives are
+		triangulated on the calling thread.*/
+		void triangulate( size_t threadCount = 1 );
+
+		/** The number of triangulated primitives, i.e. the number of primitives of the mesh.*/
+		size_t getPrimitiveCount() const { return mTriangleCorners.size(); }
+
+		/** The corner indices of the triangles of the primitive with index @a primitiveIndex.*/
+		const TriangleCornerList& getTriangleCorners( size_t primitiveIndex ) const { return mTriangleCorners[primitiveIndex]; }
+
+		/** The number of triangles of the primitive with index @a primitiveIndex.*/
+		size_t getTriangleCount( size_t primitiveIndex ) const { return mTriangleCorners[primitiveIndex].size() / 3; }
+
+		/** Triangulates @a primitive of @a mesh and stores the corner indices of the triangles in
+		@a triangleCorners. The positions of @a mesh are used for ear clipping and to find degenerate
+		strip triangles. Without positions, all polygons are split into fans.
+		Holes of polygons are always cut out by ear clipping, since a fan cannot cover them.*/
+		static void triangulatePrimitive( const Mesh& mesh, const MeshPrimitive& primitive, Method method, TriangleCornerList& triangleCorners );
+
+	private:
+
+		class TriangulateBody;
+		friend class TriangulateBody;
+
+        /** Disable default copy ctor. */
+		Triangulator( const Triangulator& pre );
+
+        /** Disable default assignment operator. */
+		const Triangulator& operator= ( const Triangulator& pre );
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_TRIANGULATOR_H__
@@ -76,6 +76,7 @@ namespace COLLADAFW
         bool operator==(const UniqueId& uid) const;
         bool operator!=(const UniqueId& uid) const;
 
+		/** Returns a hash value calculated from class id, object id and file id.*/
 		operator size_t()const;
 
 	private:
@@ -0,0 +1,235 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_VERTEXBUFFERBUILDER_H__
+#define __COLLADAFW_VERTEXBUFFERBUILDER_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWMeshPrimitive.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+
+	class Mesh;
+
+	/** A vertex buffer and an index buffer, as expected by graphics APIs, built from one mesh primitive.
+	The primitive references its positions, normals, colors, ... through separate index arrays. Each
+	distinct combination of these indices becomes one vertex of the buffer and each corner of the
+	primitive one index into it. The corners are kept in the order of the primitive, i.e. polygons,
+	fans and strips are not triangulated. All values are converted to float.*/
+	class VertexBuffer
+	{
+	public:
+
+		/** How the attributes of the vertices are stored in the vertex data.*/
+		enum Layout
+		{
+			INTERLEAVED,	/**< All attributes of a vertex are stored next to each other.
+								The attributes of vertex i start at i * getVertexStride().*/
+			SEPARATE		/**< Each attribute is stored in its own stream, one after the other
+								(structure of arrays). The vertex stride is 0.*/
+		};
+
+		/** The kind of values an attribute contains.*/
+		enum Semantic
+		{
+			POSITION,
+			NORMAL,
+			TANGENT,
+			BINORMAL,
+			COLOR,
+			TEXCOORD
+		};
+
+		/** Describes where an attribute is stored in the vertex data.*/
+		struct Attribute
+		{
+			/** The kind of values.*/
+			Semantic semantic;
+
+			/** The set index of colors and texture coordinates, 0 for all other attributes.*/
+			size_t setIndex;
+
+			/** The number of floats per vertex.*/
+			size_t componentCount;
+
+			/** The offset in floats. For INTERLEAVED the offset within a vertex, for SEPARATE the
+			start of the stream.*/
+			size_t offset;
+		};
+
+		typedef std::vector<Attribute> AttributeList;
+
+		/** The size of the indices in the index buffer.*/
+		enum IndexWidth
+		{
+			INDEX_WIDTH_16 = 2,
+			INDEX_WIDTH_32 = 4
+		};
+
+	private:
+		friend class VertexBufferBuilder;
+
+		/** The type of the primitive the buffer has been built from.*/
+		MeshPrimitive::PrimitiveType mPrimitiveType;
+
+		/** The material id of the primitive the buffer has been built from.*/
+		MaterialId mMaterialId;
+
+		/** The layout of mVertices.*/
+		Layout mLayout;
+
+		/** The attributes of each vertex.*/
+		AttributeList mAttributes;
+
+		/** The number of floats per vertex.*/
+		size_t mVertexSize;
+
+		/** The number of vertices.*/
+		size_t mVertexCount;
+
+		/** The values of all vertices, getVertexCount() * getVertexSize() floats.*/
+		std::vector<float> mVertices;
+
+		/** The indices, if the index width is INDEX_WIDTH_16.*/
+		std::vector<unsigned short> mIndices16;
+
+		/** The indices, if the index width is INDEX_WIDTH_32.*/
+		std::vector<unsigned int> mIndices32;
+
+	public:
+
+		/** Constructor. Creates an empty buffer.*/
+		VertexBuffer();
+
+		/** Destructor. */
+		virtual ~VertexBuffer() {}
+
+		/** The type of the primitive the buffer has been built from.*/
+		MeshPrimitive::PrimitiveType getPrimitiveType() const { return mPrimitiveType; }
+
+		/** The material id of the primitive the buffer has been built from.*/
+		MaterialId getMaterialId() const { return mMaterialId; }
+
+		/** The layout of the vertex data.*/
+		Layout getLayout() const { return mLayout; }
+
+		/** The attributes of each vertex, in the order they are stored.*/
+		const AttributeList& getAttributes() const { return mAttributes; }
+
+		/** Returns the first attribute with @a semantic and @a setIndex or 0, if there is none.*/
+		const Attribute* findAttribute( Semantic semantic, size_t setIndex = 0 ) const;
+
+		/** The number of floats per vertex.*/
+		size_t getVertexSize() const { return mVertexSize; }
+
+		/** The distance between two vertices in floats. 0 for the SEPARATE layout.*/
+		size_t getVertexStride() const { return mLayout == INTERLEAVED ? mVertexSize : 0; }
+
+		/** The number of vertices.*/
+		size_t getVertexCount() const { return mVertexCount; }
+
+		/** The values of all vertices, getVertexCount() * getVertexSize() floats.*/
+		const std::vector<float>& getVertices() const { return mVertices; }
+
+		/** Returns the first component of @a attribute of vertex @a vertexIndex.*/
+		const float* getAttributeValues( const Attribute& attribute, size_t vertexIndex ) const
+		{
+			if ( mLayout == INTERLEAVED )
+				return &mVertices[vertexIndex * mVertexSize + attribute.offset];
+			else
+				return &mVertices[attribute.offset + vertexIndex * attribute.componentCount];
+		}
+
+		/** The number of indices, i.e. the number of corners of the primitive.*/
+		size_t getIndexCount() const { return mIndices16.size() + mIndices32.size(); }
+
+		/** The size of the indices. 16 bit indices are used, if all vertices can be addressed
+		by them without using 0xFFFF, which is the primitive restart index of most graphics APIs.*/
+		IndexWidth getIndexWidth() const { return mIndices32.empty() ? INDEX_WIDTH_16 : INDEX_WIDTH_32; }
+
+		/** The indices, if the index width is INDEX_WIDTH_16. Empty otherwise.*/
+		const std::vector<unsigned short>& getIndices16() const { return mIndices16; }
+
+		/** The indices, if the index width is INDEX_WIDTH_32. Empty otherwise.*/
+		const std::vector<unsigned int>& getIndices32() const { return mIndices32; }
+
+		/** Returns the index of the corner @a cornerIndex, independent of the index width.*/
+		unsigned int getIndex( size_t cornerIndex ) const
+		{
+			return mIndices32.empty() ? mIndices16[cornerIndex] : mIndices32[cornerIndex];
+		}
+
+	};
+
+
+	/** Builds a VertexBuffer for each primitive of a mesh. Identical combinations of indices are
+	merged with a hash table using open addressing, whose size is proportional to the number of
+	corners of the primitive. Primitives are independent of each other and can be built on several
+	threads.*/
+	class VertexBufferBuilder
+	{
+	private:
+
+		/** The mesh the buffers are built from.*/
+		const Mesh& mMesh;
+
+		/** The layout of the built buffers.*/
+		VertexBuffer::Layout mLayout;
+
+		/** The built buffers, one for each primitive of the mesh.*/
+		std::vector<VertexBuffer*> mVertexBuffers;
+
+	public:
+
+		/** Constructor. @a mesh must stay valid until build() returns.*/
+		VertexBufferBuilder( const Mesh& mesh, VertexBuffer::Layout layout = VertexBuffer::INTERLEAVED );
+
+		/** Destructor. Deletes the built buffers.*/
+		virtual ~VertexBufferBuilder();
+
+		/** Builds the buffers of all primitives of the mesh on up to @a threadCount threads. Buffers
+		of a previous call are deleted. If threads cannot be created, the remaining primitives are
+		built on the calling thread.*/
+		void build( size_t threadCount = 1 );
+
+		/** The number of built buffers, i.e. the number of primitives of the mesh.*/
+		size_t getVertexBufferCount() const { return mVertexBuffers.size(); }
+
+		/** The buffer built from the primitive with index @a primitiveIndex.*/
+		const VertexBuffer& getVertexBuffer( size_t primitiveIndex ) const { return *mVertexBuffers[primitiveIndex]; }
+
+		/** Builds the buffer of @a primitive of @a mesh into @a vertexBuffer. Index arrays, whose
+		size differs from the number of position indices, are ignored. Indices that are out of the
+		range of their values result in zeros.*/
+		static void buildVertexBuffer( const Mesh& mesh, const MeshPrimitive& primitive, VertexBuffer::Layout layout, VertexBuffer& vertexBuffer );
+
+	private:
+
+		class BuildBody;
+		friend class BuildBody;
+
+        /** Disable default copy ctor. */
+		VertexBufferBuilder( const VertexBufferBuilder& pre );
+
+        /** Disable default assignment operator. */
+		const VertexBufferBuilder& operator= ( const VertexBufferBuilder& pre );
+
+		/** Deletes all built buffers.*/
+		void clear();
+
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_VERTEXBUFFERBUILDER_H__
@@ -0,0 +1,357 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWAnimationSampler.h"
+#include "COLLADAFWAnimationCurve.h"
+
+#include <algorithm>
+#include <math.h>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** The number of bisection steps used to find the parameter of a sample in a Bezier
+		interval, whose control points do not space the time evenly. The bisection leaves an error
+		of less than 2^-17 for any control points within the interval, even if the slope of the
+		time is zero at the ends of the interval.*/
+		const int BISECTION_STEPS = 16;
+
+		/** The number of Newton iterations that follow the bisection steps. They are kept within
+		the range found by the bisection and reach machine precision, unless the slope of the time
+		is zero at the parameter.*/
+		const int NEWTON_ITERATIONS = 2;
+
+		/** The smallest slope of the time polynomial used by a Newton iteration.*/
+		const double MIN_TIME_SLOPE = 1e-12;
+
+		/** The largest difference of the coefficients of the time polynomial to the identity, for
+		which the parameter of a sample is used directly. Large enough to catch evenly spaced
+		control points that have been rounded to float.*/
+		const double LINEAR_TIME_TOLERANCE = 1e-6;
+
+		/** Clamps @a value to 0..1.*/
+		inline double clampToUnit( double value )
+		{
+			return std::min( std::max( value, 0.0 ), 1.0 );
+		}
+
+		/** Writes the solutions s of ( ( time[2] * s + time[1] ) * s + time[0] ) * s = parameter
+		for the @a count @a parameters to @a solutions. The polynomial must be monotonic in
+		0..1 and map 0 to 0 and 1 to 1. Each bisection step and Newton iteration is a loop over all
+		samples without branches, so the compiler can vectorize it and the divisions of different
+		samples overlap.*/
+		void solveTime( const double time[3], const double* parameters, size_t count, double* solutions )
+		{
+			const double c1 = time[0];
+			const double c2 = time[1];
+			const double c3 = time[2];
+			std::fill( solutions, solutions + count, 0.5 );
+			double step = 0.25;
+			for ( int bisection = 0; bisection < BISECTION_STEPS; ++bisection )
+			{
+				for ( size_t i = 0; i < count; ++i )
+				{
+					const double s = solutions[i];
+					const double sampleTime = ( ( c3 * s + c2 ) * s + c1 ) * s;
+					solutions[i] = s + ( sampleTime < parameters[i] ? step : -step );
+				}
+				step *= 0.5;
+			}
+
+			// the bisection leaves each solution within 2 * step of the parameter found so far
+			const double range = 2 * step;
+			for ( size_t i = 0; i < count; ++i )
+			{
+				const double parameter = parameters[i];
+				const double low = solutions[i] - range;
+				const double high = solutions[i] + range;
+				double s = solutions[i];
+				for ( int iteration = 0; iteration < NEWTON_ITERATIONS; ++iteration )
+				{
+					const double error = ( ( c3 * s + c2 ) * s + c1 ) * s - parameter;
+					const double slope = std::max( ( 3 * c3 * s + 2 * c2 ) * s + c1, MIN_TIME_SLOPE );
+					s = std::min( std::max( s - error / slope, low ), high );
+				}
+				solutions[i] = s;
+			}
+		}
+
+		/** Writes the values of the polynomial @a value at the @a count @a parameters to
+		@a output.*/
+		template<class T>
+		void evaluatePolynomial( const double value[4], const double* parameters, size_t count, T* output )
+		{
+			const double c0 = value[0];
+			const double c1 = value[1];
+			const double c2 = value[2];
+			const double c3 = value[3];
+			for ( size_t i = 0; i < count; ++i )
+			{
+				const double s = parameters[i];
+				output[i] = (T)( ( ( c3 * s + c2 ) * s + c1 ) * s + c0 );
+			}
+		}
+	}
+
+	//------------------------------
+	AnimationSampler::AnimationSampler()
+		: mChannelCount( 0 )
+	{
+	}
+
+	//------------------------------
+	AnimationSampler::~AnimationSampler()
+	{
+	}
+
+	//------------------------------
+	void AnimationSampler::clear()
+	{
+		mCurves.clear();
+		mKeyTimes.clear();
+		mIntervals.clear();
+		mIntervalChannels.clear();
+		mChannelCount = 0;
+	}
+
+	//------------------------------
+	void AnimationSampler::appendConstantChannel( double value )
+	{
+		IntervalChannel channel;
+		channel.value[0] = value;
+		channel.value[1] = 0;
+		channel.value[2] = 0;
+		channel.value[3] = 0;
+		channel.time[0] = 1;
+		channel.time[1] = 0;
+		channel.time[2] = 0;
+		channel.linearTime = true;
+		mIntervalChannels.push_back( channel );
+	}
+
+	//------------------------------
+	size_t AnimationSampler::addCurve( const AnimationCurve& curve )
+	{
+		CurveInfo curveInfo;
+		curveInfo.dimension = curve.getOutDimension();
+		curveInfo.firstKey = mKeyTimes.size();
+		curveInfo.firstInterval = mIntervals.size();
+		curveInfo.firstIntervalChannel = mIntervalChannels.size();
+		curveInfo.firstChannel = mChannelCount;
+
+		std::vector<double> keyTimes;
+		std::vector<double> values;
+		std::vector<double> inTangents;
+		std::vector<double> outTangents;
+		curve.getInputValues().copyValues( keyTimes );
+		curve.getOutputValues().copyValues( values );
+		curve.getInTangentValues().copyValues( inTangents );
+		curve.getOutTangentValues().copyValues( outTangents );
+
+		const size_t dimension = curveInfo.dimension;
+		size_t keyCount = keyTimes.size();
+		if ( values.size() != keyCount * dimension )
+			keyCount = 0;
+		curveInfo.keyCount = keyCount;
+		mKeyTimes.insert( mKeyTimes.end(), keyTimes.begin(), keyTimes.begin() + keyCount );
+
+		// Each key has a two dimensional control point per output dimension
+		const bool hasTangents = inTangents.size() == 2 * keyCount * dimension && outTangents.size() == 2 * keyCount * dimension;
+		const AnimationCurve::InterpolationTypeArray& interpolationTypes = curve.getInterpolationTypes();
+
+		// the interval before the first key
+		Interval constantInterval;
+		constantInterval.startTime = 0;
+		constantInterval.timeScale = 0;
+		mIntervals.push_back( constantInterval );
+		for ( size_t d = 0; d < dimension; ++d )
+			appendConstantChannel( keyCount > 0 ? values[d] : 0 );
+
+		for ( size_t key = 0; key + 1 < keyCount; ++key )
+		{
+			const double startTime = keyTimes[key];
+			const double endTime = keyTimes[key + 1];
+			Interval interval;
+			interval.startTime = startTime;
+			interval.timeScale = endTime > startTime ? 1 / ( endTime - startTime ) : 0;
+			mIntervals.push_back( interval );
+
+			AnimationCurve::InterpolationType interpolationType = curve.getInterpolationType();
+			if ( interpolationType == AnimationCurve::INTERPOLATION_MIXED )
+				interpolationType = key < interpolationTypes.getCount() ? interpolationTypes[key] : AnimationCurve::INTERPOLATION_LINEAR;
+			if ( !hasTangents && ( interpolationType == AnimationCurve::INTERPOLATION_BEZIER || interpolationType == AnimationCurve::INTERPOLATION_HERMITE ) )
+				interpolationType = AnimationCurve::INTERPOLATION_LINEAR;
+
+			for ( size_t d = 0; d < dimension; ++d )
+			{
+				const double startValue = values[key * dimension + d];
+				const double endValue = values[( key + 1 ) * dimension + d];
+				if ( interpolationType == AnimationCurve::INTERPOLATION_STEP )
+				{
+					appendConstantChannel( startValue );
+					continue;
+				}
+
+				IntervalChannel channel;
+				channel.time[0] = 1;
+				channel.time[1] = 0;
+				channel.time[2] = 0;
+				channel.linearTime = true;
+
+				if ( interpolationType == AnimationCurve::INTERPOLATION_BEZIER || interpolationType == AnimationCurve::INTERPOLATION_HERMITE )
+				{
+					const size_t outTangentIndex = 2 * ( key * dimension + d );
+					const size_t inTangentIndex = 2 * ( ( key + 1 ) * dimension + d );
+					double startControlTime = outTangents[outTangentIndex];
+					double startControlValue = outTangents[outTangentIndex + 1];
+					double endControlTime = inTangents[inTangentIndex];
+					double endControlValue = inTangents[inTangentIndex + 1];
+					if ( interpolationType == AnimationCurve::INTERPOLATION_HERMITE )
+					{
+						startControlTime = startTime + startControlTime / 3;
+						startControlValue = startValue + startControlValue / 3;
+						endControlTime = endTime - endControlTime / 3;
+						endControlValue = endValue - endControlValue / 3;
+					}
+
+					channel.value[0] = startValue;
+					channel.value[1] = 3 * ( startControlValue - startValue );
+					channel.value[2] = 3 * ( startValue - 2 * startControlValue + endControlValue );
+					channel.value[3] = endValue - startValue + 3 * ( startControlValue - endControlValue );
+
+					// The control times are clamped to the interval, so that the time is monotonic
+					// and every sample time has exactly one parameter
+					const double a = clampToUnit( ( startControlTime - startTime ) * interval.timeScale );
+					const double b = clampToUnit( ( endControlTime - startTime ) * interval.timeScale );
+					channel.time[0] = 3 * a;
+					channel.time[1] = 3 * b - 6 * a;
+					channel.time[2] = 1 - 3 * b + 3 * a;
+					channel.linearTime = fabs( channel.time[0] - 1 ) <= LINEAR_TIME_TOLERANCE
+						&& fabs( channel.time[1] ) <= LINEAR_TIME_TOLERANCE
+						&& fabs( channel.time[2] ) <= LINEAR_TIME_TOLERANCE;
+				}
+				else
+				{
+					channel.value[0] = startValue;
+					channel.value[1] = endValue - startValue;
+					channel.value[2] = 0;
+					channel.value[3] = 0;
+				}
+				mIntervalChannels.push_back( channel );
+			}
+		}
+
+		// the interval after the last key
+		if ( keyCount > 0 )
+		{
+			mIntervals.push_back( constantInterval );
+			for ( size_t d = 0; d < dimension; ++d )
+				appendConstantChannel( values[( keyCount - 1 ) * dimension + d] );
+		}
+
+		mCurves.push_back( curveInfo );
+		mChannelCount += dimension;
+		return mCurves.size() - 1;
+	}
+
+	//------------------------------
+	template<class T>
+	void AnimationSampler::sampleCurveTemplate( size_t curveIndex, const double* times, size_t sampleCount, T* output, size_t channelStride, double* parameters, double* solvedParameters ) const
+	{
+		const CurveInfo& curveInfo = mCurves[curveIndex];
+		const size_t dimension = curveInfo.dimension;
+		if ( dimension == 0 )
+			return;
+
+		// Interval i lies between key i - 1 and key i, so the interval of a time is the index of
+		// the first key after it
+		const size_t keyCount = curveInfo.keyCount;
+		const double* keyTimes = keyCount > 0 ? &mKeyTimes[curveInfo.firstKey] : 0;
+		size_t intervalIndex = 0;
+		size_t firstSample = 0;
+		while ( firstSample < sampleCount )
+		{
+			intervalIndex = std::upper_bound( keyTimes + intervalIndex, keyTimes + keyCount, times[firstSample] ) - keyTimes;
+			size_t endSample = sampleCount;
+			if ( intervalIndex < keyCount )
+				endSample = std::lower_bound( times + firstSample + 1, times + sampleCount, keyTimes[intervalIndex] ) - times;
+			const size_t runLength = endSample - firstSample;
+
+			const Interval& interval = mIntervals[curveInfo.firstInterval + intervalIndex];
+			const double startTime = interval.startTime;
+			const double timeScale = interval.timeScale;
+			const double* runTimes = times + firstSample;
+			for ( size_t i = 0; i < runLength; ++i )
+				parameters[i] = ( runTimes[i] - startTime ) * timeScale;
+
+			const IntervalChannel* channels = &mIntervalChannels[curveInfo.firstIntervalChannel + intervalIndex * dimension];
+			for ( size_t d = 0; d < dimension; ++d )
+			{
+				const IntervalChannel& channel = channels[d];
+				const double* channelParameters = parameters;
+				if ( !channel.linearTime )
+				{
+					solveTime( channel.time, parameters, runLength, solvedParameters );
+					channelParameters = solvedParameters;
+				}
+				evaluatePolynomial( channel.value, channelParameters, runLength, output + d * channelStride + firstSample );
+			}
+
+			firstSample = endSample;
+		}
+	}
+
+	//------------------------------
+	void AnimationSampler::sample( const double* times, size_t sampleCount, double* output, size_t channelStride ) const
+	{
+		if ( sampleCount == 0 )
+			return;
+		std::vector<double> parameters( sampleCount );
+		std::vector<double> solvedParameters( sampleCount );
+		for ( size_t i = 0, count = mCurves.size(); i < count; ++i )
+			sampleCurveTemplate( i, times, sampleCount, output + mCurves[i].firstChannel * channelStride, channelStride, &parameters[0], &solvedParameters[0] );
+	}
+
+	//------------------------------
+	void AnimationSampler::sample( const double* times, size_t sampleCount, float* output, size_t channelStride ) const
+	{
+		if ( sampleCount == 0 )
+			return;
+		std::vector<double> parameters( sampleCount );
+		std::vector<double> solvedParameters( sampleCount );
+		for ( size_t i = 0, count = mCurves.size(); i < count; ++i )
+			sampleCurveTemplate( i, times, sampleCount, output + mCurves[i].firstChannel * channelStride, channelStride, &parameters[0], &solvedParameters[0] );
+	}
+
+	//------------------------------
+	void AnimationSampler::sampleCurve( size_t curveIndex, const double* times, size_t sampleCount, double* output, size_t channelStride ) const
+	{
+		if ( sampleCount == 0 )
+			return;
+		std::vector<double> parameters( sampleCount );
+		std::vector<double> solvedParameters( sampleCount );
+		sampleCurveTemplate( curveIndex, times, sampleCount, output, channelStride, &parameters[0], &solvedParameters[0] );
+	}
+
+	//------------------------------
+	void AnimationSampler::sampleCurve( size_t curveIndex, const double* times, size_t sampleCount, float* output, size_t channelStride ) const
+	{
+		if ( sampleCount == 0 )
+			return;
+		std::vector<double> parameters( sampleCount );
+		std::vector<double> solvedParameters( sampleCount );
+		sampleCurveTemplate( curveIndex, times, sampleCount, output, channelStride, &parameters[0], &solvedParameters[0] );
+	}
+
+} // namespace COLLADAFW
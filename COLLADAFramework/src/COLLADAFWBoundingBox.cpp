@@ -0,0 +1,298 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWBoundingBox.h"
+
+#include "Math/COLLADABUMathMatrix4.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#	include <emmintrin.h>
+#	define COLLADAFW_BOUNDINGBOX_SSE2
+#endif
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** Extends @a min and @a max by the extent from @a minX, @a minY, @a minZ to @a maxX,
+		@a maxY, @a maxZ.*/
+		template<class T>
+		void extendByExtent( T minX, T minY, T minZ, T maxX, T maxY, T maxZ, COLLADABU::Math::Vector3& min, COLLADABU::Math::Vector3& max )
+		{
+			if ( minX < min.x ) min.x = minX;
+			if ( maxX > max.x ) max.x = maxX;
+			if ( minY < min.y ) min.y = minY;
+			if ( maxY > max.y ) max.y = maxY;
+			if ( minZ < min.z ) min.z = minZ;
+			if ( maxZ > max.z ) max.z = maxZ;
+		}
+
+		/** Extends @a min and @a max by the points in @a positions. The minima and maxima are kept
+		in local variables of the type of the positions and are only written back once. The three
+		interleaved coordinates keep compilers from vectorizing the loop, so it is only used if SSE2
+		is not available and for the points behind the last full SSE2 block.*/
+		template<class T>
+		void extendByPositionsTemplate( const T* positions, size_t positionCount, COLLADABU::Math::Vector3& min, COLLADABU::Math::Vector3& max )
+		{
+			T minX = std::numeric_limits<T>::max();
+			T minY = minX;
+			T minZ = minX;
+			T maxX = -minX;
+			T maxY = maxX;
+			T maxZ = maxX;
+
+			const T* end = positions + 3 * positionCount;
+			for ( const T* position = positions; position != end; position += 3 )
+			{
+				const T x = position[0];
+				const T y = position[1];
+				const T z = position[2];
+				minX = x < minX ? x : minX;
+				maxX = x > maxX ? x : maxX;
+				minY = y < minY ? y : minY;
+				maxY = y > maxY ? y : maxY;
+				minZ = z < minZ ? z : minZ;
+				maxZ = z > maxZ ? z : maxZ;
+			}
+
+			extendByExtent( minX, minY, minZ, maxX, maxY, maxZ, min, max );
+		}
+
+#if defined(COLLADAFW_BOUNDINGBOX_SSE2)
+		/** Extends @a min and @a max by the points in @a positions in blocks of four points, which
+		are twelve floats or three registers. The coordinates rotate through the lanes of the
+		registers, so each register keeps its own minima and maxima, that are combined per axis
+		after the loop. A NaN coordinate is skipped, as in extendByPositionsTemplate().
+		@return The number of points processed, i.e. @a positionCount rounded down to a multiple
+		of four.*/
+		size_t extendByPositionsSSE2( const float* positions, size_t positionCount, COLLADABU::Math::Vector3& min, COLLADABU::Math::Vector3& max )
+		{
+			const size_t blockCount = positionCount / 4;
+			if ( blockCount == 0 )
+				return 0;
+
+			// lanes: x y z x | y z x y | z x y z
+			__m128 min0 = _mm_set1_ps( std::numeric_limits<float>::max() );
+			__m128 min1 = min0;
+			__m128 min2 = min0;
+			__m128 max0 = _mm_set1_ps( -std::numeric_limits<float>::max() );
+			__m128 max1 = max0;
+			__m128 max2 = max0;
+
+			const float* end = positions + 12 * blockCount;
+			for ( const float* position = positions; position != end; position += 12 )
+			{
+				// _mm_min_ps returns the second operand if the first is NaN
+				const __m128 values0 = _mm_loadu_ps( position );
+				const __m128 values1 = _mm_loadu_ps( position + 4 );
+				const __m128 values2 = _mm_loadu_ps( position + 8 );
+				min0 = _mm_min_ps( values0, min0 );
+				max0 = _mm_max_ps( values0, max0 );
+				min1 = _mm_min_ps( values1, min1 );
+				max1 = _mm_max_ps( values1, max1 );
+				min2 = _mm_min_ps( values2, min2 );
+				max2 = _mm_max_ps( values2, max2 );
+			}
+
+			float mins[12];
+			float maxs[12];
+			_mm_storeu_ps( mins, min0 );
+			_mm_storeu_ps( mins + 4, min1 );
+			_mm_storeu_ps( mins + 8, min2 );
+			_mm_storeu_ps( maxs, max0 );
+			_mm_storeu_ps( maxs + 4, max1 );
+			_mm_storeu_ps( maxs + 8, max2 );
+
+			// lane i holds the coordinate i % 3
+			float minXYZ[3] = { mins[0], mins[1], mins[2] };
+			float maxXYZ[3] = { maxs[0], maxs[1], maxs[2] };
+			for ( size_t i = 3; i < 12; ++i )
+			{
+				float& minValue = minXYZ[i % 3];
+				float& maxValue = maxXYZ[i % 3];
+				minValue = mins[i] < minValue ? mins[i] : minValue;
+				maxValue = maxs[i] > maxValue ? maxs[i] : maxValue;
+			}
+			extendByExtent( minXYZ[0], minXYZ[1], minXYZ[2], maxXYZ[0], maxXYZ[1], maxXYZ[2], min, max );
+			return 4 * blockCount;
+		}
+
+		/** Extends @a min and @a max by the points in @a positions in blocks of two points, which
+		are six doubles or three registers. See the float version.
+		@return The number of points processed, i.e. @a positionCount rounded down to a multiple
+		of two.*/
+		size_t extendByPositionsSSE2( const double* positions, size_t positionCount, COLLADABU::Math::Vector3& min, COLLADABU::Math::Vector3& max )
+		{
+			const size_t blockCount = positionCount / 2;
+			if ( blockCount == 0 )
+				return 0;
+
+			// lanes: x y | z x | y z
+			__m128d min0 = _mm_set1_pd( std::numeric_limits<double>::max() );
+			__m128d min1 = min0;
+			__m128d min2 = min0;
+			__m128d max0 = _mm_set1_pd( -std::numeric_limits<double>::max() );
+			__m128d max1 = max0;
+			__m128d max2 = max0;
+
+			const double* end = positions + 6 * blockCount;
+			for ( const double* position = positions; position != end; position += 6 )
+			{
+				const __m128d values0 = _mm_loadu_pd( position );
+				const __m128d values1 = _mm_loadu_pd( position + 2 );
+				const __m128d values2 = _mm_loadu_pd( position + 4 );
+				min0 = _mm_min_pd( values0, min0 );
+				max0 = _mm_max_pd( values0, max0 );
+				min1 = _mm_min_pd( values1, min1 );
+				max1 = _mm_max_pd( values1, max1 );
+				min2 = _mm_min_pd( values2, min2 );
+				max2 = _mm_max_pd( values2, max2 );
+			}
+
+			double mins[6];
+			double maxs[6];
+			_mm_storeu_pd( mins, min0 );
+			_mm_storeu_pd( mins + 2, min1 );
+			_mm_storeu_pd( mins + 4, min2 );
+			_mm_storeu_pd( maxs, max0 );
+			_mm_storeu_pd( maxs + 2, max1 );
+			_mm_storeu_pd( maxs + 4, max2 );
+
+			// lane i holds the coordinate i % 3
+			extendByExtent( mins[0] < mins[3] ? mins[0] : mins[3],
+							mins[1] < mins[4] ? mins[1] : mins[4],
+							mins[2] < mins[5] ? mins[2] : mins[5],
+							maxs[0] > maxs[3] ? maxs[0] : maxs[3],
+							maxs[1] > maxs[4] ? maxs[1] : maxs[4],
+							maxs[2] > maxs[5] ? maxs[2] : maxs[5],
+							min, max );
+			return 2 * blockCount;
+		}
+#endif
+	}
+
+	//------------------------------
+	BoundingBox::BoundingBox()
+	{
+		clear();
+	}
+
+	//------------------------------
+	BoundingBox::BoundingBox( const COLLADABU::Math::Vector3& min, const COLLADABU::Math::Vector3& max )
+		: mMin(min)
+		, mMax(max)
+	{
+	}
+
+	//------------------------------
+	void BoundingBox::clear()
+	{
+		const double largest = std::numeric_limits<double>::max();
+		mMin = COLLADABU::Math::Vector3(largest, largest, largest);
+		mMax = COLLADABU::Math::Vector3(-largest, -largest, -largest);
+	}
+
+	//------------------------------
+	COLLADABU::Math::Vector3 BoundingBox::getCenter() const
+	{
+		if ( isEmpty() )
+			return COLLADABU::Math::Vector3::ZERO;
+		return (mMin + mMax) * 0.5;
+	}
+
+	//------------------------------
+	COLLADABU::Math::Vector3 BoundingBox::getSize() const
+	{
+		if ( isEmpty() )
+			return COLLADABU::Math::Vector3::ZERO;
+		return mMax - mMin;
+	}
+
+	//------------------------------
+	double BoundingBox::getRadius() const
+	{
+		if ( isEmpty() )
+			return 0;
+		return getSize().length() * 0.5;
+	}
+
+	//------------------------------
+	void BoundingBox::extend( const BoundingBox& box )
+	{
+		if ( box.isEmpty() )
+			return;
+		extend(box.mMin.x, box.mMin.y, box.mMin.z);
+		extend(box.mMax.x, box.mMax.y, box.mMax.z);
+	}
+
+	//------------------------------
+	void BoundingBox::extendByPositions( const float* positions, size_t positionCount )
+	{
+#if defined(COLLADAFW_BOUNDINGBOX_SSE2)
+		const size_t processedCount = extendByPositionsSSE2(positions, positionCount, mMin, mMax);
+		extendByPositionsTemplate(positions + 3 * processedCount, positionCount - processedCount, mMin, mMax);
+#else
+		extendByPositionsTemplate(positions, positionCount, mMin, mMax);
+#endif
+	}
+
+	//------------------------------
+	void BoundingBox::extendByPositions( const double* positions, size_t positionCount )
+	{
+#if defined(COLLADAFW_BOUNDINGBOX_SSE2)
+		const size_t processedCount = extendByPositionsSSE2(positions, positionCount, mMin, mMax);
+		extendByPositionsTemplate(positions + 3 * processedCount, positionCount - processedCount, mMin, mMax);
+#else
+		extendByPositionsTemplate(positions, positionCount, mMin, mMax);
+#endif
+	}
+
+	//------------------------------
+	BoundingBox BoundingBox::transformed( const COLLADABU::Math::Matrix4& matrix ) const
+	{
+		BoundingBox result;
+		if ( isEmpty() )
+			return result;
+
+		// Each coordinate of the result is the translation plus the sum of the smaller resp. larger
+		// products of the matrix element with the minimum and maximum of the box (Arvo's method).
+		for ( size_t i = 0; i < 3; ++i )
+		{
+			const COLLADABU::Math::Real* row = matrix[i];
+			double min = row[3];
+			double max = row[3];
+			for ( size_t j = 0; j < 3; ++j )
+			{
+				const double a = row[j] * mMin[j];
+				const double b = row[j] * mMax[j];
+				if ( a < b )
+				{
+					min += a;
+					max += b;
+				}
+				else
+				{
+					min += b;
+					max += a;
+				}
+			}
+			result.mMin[i] = min;
+			result.mMax[i] = max;
+		}
+		return result;
+	}
+
+} // namespace COLLADAFW
@@ -11,6 +11,8 @@
 #include "COLLADAFWStableHeaders.h"
 #include "COLLADAFWFloatOrDoubleArray.h"
 
+#include <math.h>
+
 
 namespace COLLADAFW
 {
@@ -49,6 +51,10 @@ namespace COLLADAFW
 		{
 			pre.mValuesD.cloneArray( mValuesD );
 		}
+		else if ( mType == DATA_TYPE_QUANTIZED )
+		{
+			pre.mValuesQ.cloneArray( mValuesQ );
+		}
 	}
 
 	//------------------------------
@@ -62,6 +68,10 @@ namespace COLLADAFW
 		{
 			return mValuesD.getCount();
 		}
+		if ( mType == DATA_TYPE_QUANTIZED )
+		{
+			return mValuesQ.getValuesCount();
+		}
 		return 0;
 	}
 
@@ -76,6 +86,10 @@ namespace COLLADAFW
 		{
 			mValuesD.clear();
 		}
+		if( mType == DATA_TYPE_QUANTIZED )
+		{
+			mValuesQ.clear();
+		}
 	}
 
 	//------------------------------
@@ -158,4 +172,178 @@ namespace COLLADAFW
 		return false;
 	}
 
+	//------------------------------
+	const QuantizedArray* FloatOrDoubleArray::getQuantizedValues() const
+	{
+		if ( mType == DATA_TYPE_QUANTIZED )
+		{
+			return &mValuesQ;
+		}
+		return 0;
+	}
+
+	//------------------------------
+	QuantizedArray* FloatOrDoubleArray::getQuantizedValues()
+	{
+		if ( mType == DATA_TYPE_QUANTIZED )
+		{
+			return &mValuesQ;
+		}
+		return 0;
+	}
+
+	//------------------------------
+	double FloatOrDoubleArray::convertToFloat()
+	{
+		if ( mType != DATA_TYPE_DOUBLE )
+			return 0;
+
+		const size_t count = mValuesD.getCount();
+		const double* doubleValues = mValuesD.getData();
+		mValuesF.clear();
+		mValuesF.allocMemory( count );
+		float* floatValues = mValuesF.getData();
+		double maxError = 0;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			floatValues[i] = (float)doubleValues[i];
+			const double error = fabs( doubleValues[i] - floatValues[i] );
+			if ( error > maxError )
+				maxError = error;
+		}
+		mValuesF.setCount( count );
+
+		// external data is not released, but must not be used anymore
+		mValuesD.clear();
+		mValuesD.setData( 0, 0, 0 );
+		mType = DATA_TYPE_FLOAT;
+		return maxError;
+	}
+
+	//------------------------------
+	bool FloatOrDoubleArray::quantize( QuantizedArray::Encoding encoding, size_t dimension )
+	{
+		bool success = false;
+		if ( mType == DATA_TYPE_FLOAT )
+		{
+			if ( encoding == QuantizedArray::ENCODING_OCTAHEDRAL )
+				success = mValuesQ.encodeOctahedral( mValuesF.getData(), mValuesF.getCount() );
+			else
+				success = mValuesQ.encodeLinear( mValuesF.getData(), mValuesF.getCount(), dimension );
+			if ( success )
+			{
+				mValuesF.clear();
+				mValuesF.setData( 0, 0, 0 );
+			}
+		}
+		else if ( mType == DATA_TYPE_DOUBLE )
+		{
+			if ( encoding == QuantizedArray::ENCODING_OCTAHEDRAL )
+				success = mValuesQ.encodeOctahedral( mValuesD.getData(), mValuesD.getCount() );
+			else
+				success = mValuesQ.encodeLinear( mValuesD.getData(), mValuesD.getCount(), dimension );
+			if ( success )
+			{
+				mValuesD.clear();
+				mValuesD.setData( 0, 0, 0 );
+			}
+		}
+
+		if ( success )
+			mType = DATA_TYPE_QUANTIZED;
+		return success;
+	}
+
+	//------------------------------
+	template<class T>
+	bool FloatOrDoubleArray::appendQuantizedTemplate( const T* values, size_t valueCount, QuantizedArray::Encoding encoding, size_t dimension )
+	{
+		if ( mType != DATA_TYPE_QUANTIZED && !empty() )
+			return false;
+
+		if ( mType != DATA_TYPE_QUANTIZED )
+			mValuesQ.clear();
+		bool success;
+		if ( encoding == QuantizedArray::ENCODING_OCTAHEDRAL )
+			success = mValuesQ.appendOctahedral( values, valueCount );
+		else
+			success = mValuesQ.appendLinear( values, valueCount, dimension );
+
+		if ( success && mType != DATA_TYPE_QUANTIZED )
+		{
+			mValuesF.clear();
+			mValuesF.setData( 0, 0, 0 );
+			mValuesD.clear();
+			mValuesD.setData( 0, 0, 0 );
+			mType = DATA_TYPE_QUANTIZED;
+		}
+		return success;
+	}
+
+	//------------------------------
+	bool FloatOrDoubleArray::appendQuantized( const FloatArray& valuesArray, QuantizedArray::Encoding encoding, size_t dimension )
+	{
+		return appendQuantizedTemplate( valuesArray.getData(), valuesArray.getCount(), encoding, dimension );
+	}
+
+	//------------------------------
+	bool FloatOrDoubleArray::appendQuantized( const DoubleArray& valuesArray, QuantizedArray::Encoding encoding, size_t dimension )
+	{
+		return appendQuantizedTemplate( valuesArray.getData(), valuesArray.getCount(), encoding, dimension );
+	}
+
+	//------------------------------
+	void FloatOrDoubleArray::copyValues( std::vector<double>& values ) const
+	{
+		values.resize( getValuesCount() );
+		if ( values.empty() )
+			return;
+
+		switch ( mType )
+		{
+		case DATA_TYPE_FLOAT:
+			std::copy( mValuesF.getData(), mValuesF.getData() + values.size(), values.begin() );
+			break;
+		case DATA_TYPE_DOUBLE:
+			std::copy( mValuesD.getData(), mValuesD.getData() + values.size(), values.begin() );
+			break;
+		case DATA_TYPE_QUANTIZED:
+			mValuesQ.decode( 0, values.size(), &values[0] );
+			break;
+		default:
+			values.clear();
+		}
+	}
+
+	//------------------------------
+	void FloatOrDoubleArray::dequantize()
+	{
+		if ( mType != DATA_TYPE_QUANTIZED )
+			return;
+
+		const size_t count = mValuesQ.getValuesCount();
+		mValuesF.clear();
+		mValuesF.allocMemory( count );
+		mValuesQ.decode( 0, count, mValuesF.getData() );
+		mValuesF.setCount( count );
+		mValuesQ.clear();
+		mType = DATA_TYPE_FLOAT;
+	}
+
+	//------------------------------
+	void FloatOrDoubleArray::swap( FloatOrDoubleArray& other )
+	{
+		std::swap( mType, other.mType );
+		mValuesF.swap( other.mValuesF );
+		mValuesD.swap( other.mValuesD );
+		mValuesQ.swap( other.mValuesQ );
+	}
+
+	//--------------------------------------------------------------------
+	void FloatOrDoubleArray::copyExternalData()
+	{
+		mValuesF.copyExternalData();
+		mValuesD.copyExternalData();
+	}
+
 } // namespace COLLADAFW
@@ -0,0 +1,214 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWIndexArray.h"
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** Copies @a count indices from @a source to the 32 bit @a destination.*/
+		template<class T>
+		void widenIndices( const T* source, size_t count, UIntValuesArray& destination )
+		{
+			destination.clear();
+			destination.allocMemory( count );
+			unsigned int* data = destination.getData();
+			for ( size_t i = 0; i < count; ++i )
+				data[i] = source[i];
+			destination.setCount( count );
+		}
+
+		/** Copies @a count indices from @a source to the newly allocated @a destination. Returns
+		false and leaves @a destination empty, if an index is larger than @a maxIndex.*/
+		template<class T>
+		bool copyIndices( const unsigned int* source, size_t count, unsigned int maxIndex, ArrayPrimitiveType<T>& destination )
+		{
+			destination.allocMemory( count );
+			T* data = destination.getData();
+			for ( size_t i = 0; i < count; ++i )
+			{
+				unsigned int index = source[i];
+				if ( index > maxIndex )
+				{
+					destination.releaseMemory();
+					return false;
+				}
+				data[i] = (T)index;
+			}
+			destination.setCount( count );
+			return true;
+		}
+	}
+
+	//------------------------------
+	IndexArray::IndexArray()
+		: mWidth( WIDTH_32 )
+		, mIndices32( UIntValuesArray::OWNER )
+		, mIndices16( ArrayPrimitiveType<unsigned short>::OWNER )
+		, mIndices8( ArrayPrimitiveType<unsigned char>::OWNER )
+	{
+	}
+
+	//------------------------------
+	IndexArray::Width IndexArray::getWidthForValueCount( size_t valueCount )
+	{
+		if ( valueCount <= 0x100 )
+			return WIDTH_8;
+		if ( valueCount <= 0x10000 )
+			return WIDTH_16;
+		return WIDTH_32;
+	}
+
+	//------------------------------
+	const void* IndexArray::getData() const
+	{
+		switch ( mWidth )
+		{
+		case WIDTH_8: return mIndices8.getData();
+		case WIDTH_16: return mIndices16.getData();
+		default: return mIndices32.getData();
+		}
+	}
+
+	//------------------------------
+	size_t IndexArray::getCapacity() const
+	{
+		switch ( mWidth )
+		{
+		case WIDTH_8: return mIndices8.getCapacity();
+		case WIDTH_16: return mIndices16.getCapacity();
+		default: return mIndices32.getCapacity();
+		}
+	}
+
+	//------------------------------
+	void IndexArray::copyToIndices32() const
+	{
+		if ( mWidth == WIDTH_8 )
+			widenIndices( mIndices8.getData(), mIndices8.getCount(), mIndices32 );
+		else
+			widenIndices( mIndices16.getData(), mIndices16.getCount(), mIndices32 );
+	}
+
+	//------------------------------
+	void IndexArray::assign( const UIntValuesArray& indices )
+	{
+		mIndices16.clear();
+		mIndices8.clear();
+		mIndices32.clear();
+		mWidth = WIDTH_32;
+		mIndices32.appendValues( indices );
+	}
+
+	//------------------------------
+	void IndexArray::erase( size_t n )
+	{
+		switch ( mWidth )
+		{
+		case WIDTH_8:
+			mIndices8.erase( n );
+			// the 32 bit copy might have the new count after further appends
+			mIndices32.clear();
+			break;
+		case WIDTH_16:
+			mIndices16.erase( n );
+			mIndices32.clear();
+			break;
+		default:
+			mIndices32.erase( n );
+			break;
+		}
+	}
+
+	//------------------------------
+	void IndexArray::reserve( size_t capacity )
+	{
+		switch ( mWidth )
+		{
+		case WIDTH_8: mIndices8.reallocMemory( capacity ); break;
+		case WIDTH_16: mIndices16.reallocMemory( capacity ); break;
+		default: mIndices32.reallocMemory( capacity ); break;
+		}
+	}
+
+	//------------------------------
+	void IndexArray::setWidth( Width width )
+	{
+		COLLADABU_ASSERT( empty() );
+		if ( width == mWidth )
+			return;
+		const size_t capacity = getCapacity();
+		mIndices32.clear();
+		mIndices16.clear();
+		mIndices8.clear();
+		mWidth = width;
+		reserve( capacity );
+	}
+
+	//------------------------------
+	void IndexArray::pack( size_t valueCount )
+	{
+		// external data, e.g. memory mapped from a file, does not use heap memory
+		if ( mWidth != WIDTH_32 || mIndices32.hasExternalData() )
+			return;
+
+		const unsigned int* indices = mIndices32.getData();
+		const size_t count = mIndices32.getCount();
+		if ( count == 0 )
+			return;
+
+		Width width = getWidthForValueCount( valueCount );
+		if ( width == WIDTH_8 && !copyIndices( indices, count, 0xFF, mIndices8 ) )
+			width = WIDTH_16;
+		if ( width == WIDTH_16 && !copyIndices( indices, count, 0xFFFF, mIndices16 ) )
+			width = WIDTH_32;
+		if ( width == WIDTH_32 )
+			return;
+
+		mWidth = width;
+		mIndices32.clear();
+		mIndices32.setData( 0, 0, 0 );
+	}
+
+	//------------------------------
+	void IndexArray::unpack()
+	{
+		if ( mWidth == WIDTH_32 )
+			return;
+
+		copyToIndices32();
+
+		mIndices16.clear();
+		mIndices8.clear();
+		mWidth = WIDTH_32;
+	}
+
+	//------------------------------
+	void IndexArray::swap( IndexArray& other )
+	{
+		std::swap( mWidth, other.mWidth );
+		mIndices32.swap( other.mIndices32 );
+		mIndices16.swap( other.mIndices16 );
+		mIndices8.swap( other.mIndices8 );
+	}
+
+	//------------------------------
+	size_t IndexArray::getMemorySize() const
+	{
+		return mIndices32.getCapacity() * sizeof(unsigned int)
+			+ mIndices16.getCapacity() * sizeof(unsigned short)
+			+ mIndices8.getCapacity() * sizeof(unsigned char);
+	}
+
+} // namespace COLLADAFW
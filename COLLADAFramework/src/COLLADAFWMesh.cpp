@@ -183,7 +183,7 @@ namespace COLLADAFW
             const MeshPrimitive* meshPrimitive = meshPrimitives [ i ];
 
             // Get the normal indices of the current primitive.
-            const UIntValuesArray& normalIndices = meshPrimitive->getNormalIndices ();
+            const IndexArray& normalIndices = meshPrimitive->getNormalIndexArray ();
 
             switch ( meshPrimitive->getPrimitiveType () )
             {
@@ -233,4 +233,27 @@ namespace COLLADAFW
         return numFaces;
     }
 
+    //----------------------------------
+    void Mesh::packIndices()
+    {
+        for ( size_t i = 0, count = mMeshPrimitives.getCount(); i < count; ++i )
+            mMeshPrimitives[i]->packIndices ( *this );
+    }
+
+    //----------------------------------
+    void Mesh::unpackIndices()
+    {
+        for ( size_t i = 0, count = mMeshPrimitives.getCount(); i < count; ++i )
+            mMeshPrimitives[i]->unpackIndices ();
+    }
+
+    //----------------------------------
+    size_t Mesh::getIndicesMemorySize() const
+    {
+        size_t memorySize = 0;
+        for ( size_t i = 0, count = mMeshPrimitives.getCount(); i < count; ++i )
+            memorySize += mMeshPrimitives[i]->getIndicesMemorySize ();
+        return memorySize;
+    }
+
 } // namespace COLLADAFW
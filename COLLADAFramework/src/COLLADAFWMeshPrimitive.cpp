@@ -10,6 +10,7 @@
 
 #include "COLLADAFWStableHeaders.h"
 #include "COLLADAFWMeshPrimitive.h"
+#include "COLLADAFWMesh.h"
 #include "COLLADAFWPolygons.h"
 #include "COLLADAFWPolylist.h"
 #include "COLLADAFWMeshPrimitiveWithFaceVertexCount.h"
@@ -29,8 +30,6 @@ namespace COLLADAFW
         , mPrimitiveType ( UNDEFINED_PRIMITIVE_TYPE )
 	    , mFaceCount ( 0 )
 		, mMaterialId(0)
-		, mPositionIndices(UIntValuesArray::OWNER)
-		, mNormalIndices(UIntValuesArray::OWNER)
 		, mColorIndicesArray(UIntValuesArray::OWNER)
 		, mUVCoordIndicesArray(UIntValuesArray::OWNER)
 	{
@@ -42,8 +41,6 @@ namespace COLLADAFW
 		, mPrimitiveType ( primitiveType )
 		, mFaceCount ( 0 )
 		, mMaterialId(0)
-		, mPositionIndices(UIntValuesArray::OWNER)
-		, mNormalIndices(UIntValuesArray::OWNER)
 		, mColorIndicesArray(UIntValuesArray::OWNER)
 		, mUVCoordIndicesArray(UIntValuesArray::OWNER)
 	{
@@ -162,4 +159,54 @@ namespace COLLADAFW
         return groupedVertexElementsCount;
     }
 
+    //-----------------------------
+    void MeshPrimitive::packIndices ( const Mesh& mesh )
+    {
+        mPositionIndices.pack ( mesh.getPositions ().getValuesCount () / 3 );
+        mNormalIndices.pack ( mesh.getNormals ().getValuesCount () / 3 );
+        mTangentIndices.pack ( mesh.getTangents ().getValuesCount () / 3 );
+        mBinormalIndices.pack ( mesh.getBinormals ().getValuesCount () / 3 );
+
+        // The indices of colors and uv coordinates are multiplied by the stride of their set.
+        for ( size_t i = 0, count = mColorIndicesArray.getCount (); i < count; ++i )
+        {
+            IndexList* colorIndices = mColorIndicesArray[i];
+            size_t stride = colorIndices->getStride () > 0 ? colorIndices->getStride () : 1;
+            colorIndices->packIndices ( mesh.getColors ().getValuesCount () / stride );
+        }
+        for ( size_t i = 0, count = mUVCoordIndicesArray.getCount (); i < count; ++i )
+        {
+            IndexList* uvCoordIndices = mUVCoordIndicesArray[i];
+            size_t stride = uvCoordIndices->getStride () > 0 ? uvCoordIndices->getStride () : 1;
+            uvCoordIndices->packIndices ( mesh.getUVCoords ().getValuesCount () / stride );
+        }
+    }
+
+    //-----------------------------
+    void MeshPrimitive::unpackIndices ()
+    {
+        mPositionIndices.unpack ();
+        mNormalIndices.unpack ();
+        mTangentIndices.unpack ();
+        mBinormalIndices.unpack ();
+        for ( size_t i = 0, count = mColorIndicesArray.getCount (); i < count; ++i )
+            mColorIndicesArray[i]->unpackIndices ();
+        for ( size_t i = 0, count = mUVCoordIndicesArray.getCount (); i < count; ++i )
+            mUVCoordIndicesArray[i]->unpackIndices ();
+    }
+
+    //-----------------------------
+    size_t MeshPrimitive::getIndicesMemorySize () const
+    {
+        size_t memorySize = mPositionIndices.getMemorySize ()
+            + mNormalIndices.getMemorySize ()
+            + mTangentIndices.getMemorySize ()
+            + mBinormalIndices.getMemorySize ();
+        for ( size_t i = 0, count = mColorIndicesArray.getCount (); i < count; ++i )
+            memorySize += mColorIndicesArray[i]->getIndexArray ().getMemorySize ();
+        for ( size_t i = 0, count = mUVCoordIndicesArray.getCount (); i < count; ++i )
+            memorySize += mUVCoordIndicesArray[i]->getIndexArray ().getMemorySize ();
+        return memorySize;
+    }
+
 }
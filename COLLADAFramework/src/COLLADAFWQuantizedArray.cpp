@@ -0,0 +1,359 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWQuantizedArray.h"
+
+#include <math.h>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** The largest encoded integer.*/
+		const double MAX_INTEGER = 65535.0;
+
+		/** Returns true, if @a value is not a number.*/
+		inline bool isNaN( double value )
+		{
+			return value != value;
+		}
+
+		/** Rounds @a value to the nearest integer in 0..65535. NaN is mapped to 0, since its
+		conversion to an integer is undefined.*/
+		inline unsigned short roundToInteger( double value )
+		{
+			if ( isNaN( value ) || value <= 0 )
+				return 0;
+			if ( value >= MAX_INTEGER )
+				return (unsigned short)MAX_INTEGER;
+			return (unsigned short)( value + 0.5 );
+		}
+
+		/** Maps @a value in -1..1 to 0..65535.*/
+		inline unsigned short encodeSigned( double value )
+		{
+			return roundToInteger( ( value * 0.5 + 0.5 ) * MAX_INTEGER );
+		}
+
+		/** Maps @a value in 0..65535 to -1..1.*/
+		inline double decodeSigned( unsigned short value )
+		{
+			return value / MAX_INTEGER * 2.0 - 1.0;
+		}
+
+		inline double signNotZero( double value )
+		{
+			return value < 0 ? -1.0 : 1.0;
+		}
+	}
+
+	//------------------------------
+	QuantizedArray::QuantizedArray()
+		: mEncoding( ENCODING_LINEAR )
+		, mDimension( 1 )
+		, mValues( ArrayPrimitiveType<unsigned short>::OWNER )
+		, mMaxError( 0 )
+	{
+	}
+
+	//------------------------------
+	size_t QuantizedArray::getElementCount() const
+	{
+		if ( mEncoding == ENCODING_OCTAHEDRAL )
+			return mValues.getCount() / 2;
+		return mValues.getCount() / mDimension;
+	}
+
+	//------------------------------
+	void QuantizedArray::clear()
+	{
+		mValues.clear();
+		mValues.setData( 0, 0, 0 );
+		mEncoding = ENCODING_LINEAR;
+		mDimension = 1;
+		mSegments.clear();
+		mMaxError = 0;
+	}
+
+	//------------------------------
+	void QuantizedArray::cloneArray( QuantizedArray& destination ) const
+	{
+		destination.clear();
+		mValues.cloneArray( destination.mValues );
+		destination.mEncoding = mEncoding;
+		destination.mDimension = mDimension;
+		destination.mSegments = mSegments;
+		destination.mMaxError = mMaxError;
+	}
+
+	//------------------------------
+	void QuantizedArray::swap( QuantizedArray& other )
+	{
+		std::swap( mEncoding, other.mEncoding );
+		std::swap( mDimension, other.mDimension );
+		mValues.swap( other.mValues );
+		mSegments.swap( other.mSegments );
+		std::swap( mMaxError, other.mMaxError );
+	}
+
+	//------------------------------
+	template<class T>
+	bool QuantizedArray::appendLinearTemplate( const T* values, size_t valueCount, size_t dimension )
+	{
+		if ( dimension == 0 || dimension > MAX_DIMENSION || valueCount % dimension != 0 )
+			return false;
+		if ( empty() )
+			clear();
+		else if ( mEncoding != ENCODING_LINEAR )
+			return false;
+
+		LinearSegment segment;
+		segment.firstValue = mValues.getCount();
+		segment.dimension = dimension;
+		for ( size_t component = 0; component < MAX_DIMENSION; ++component )
+		{
+			segment.scales[component] = 0;
+			segment.biases[component] = 0;
+		}
+		for ( size_t component = 0; component < dimension; ++component )
+		{
+			// NaN values are ignored for the range and encoded as the minimum
+			bool hasRange = false;
+			double min = 0;
+			double max = 0;
+			for ( size_t i = component; i < valueCount; i += dimension )
+			{
+				const double value = values[i];
+				if ( isNaN( value ) )
+					continue;
+				if ( !hasRange || value < min )
+					min = value;
+				if ( !hasRange || value > max )
+					max = value;
+				hasRange = true;
+			}
+			segment.biases[component] = min;
+			segment.scales[component] = ( max - min ) / MAX_INTEGER;
+		}
+
+		mValues.reallocMemory( segment.firstValue + valueCount );
+		unsigned short* encoded = mValues.getData() + segment.firstValue;
+		for ( size_t i = 0; i < valueCount; ++i )
+		{
+			const size_t component = i % dimension;
+			const double scale = segment.scales[component];
+			const double bias = segment.biases[component];
+			const unsigned short integer = scale > 0 ? roundToInteger( ( values[i] - bias ) / scale ) : 0;
+			encoded[i] = integer;
+
+			const double error = fabs( bias + integer * scale - values[i] );
+			if ( error > mMaxError )
+				mMaxError = error;
+		}
+		mValues.setCount( segment.firstValue + valueCount );
+
+		// segments with different dimensions are read as elements with one value
+		if ( mSegments.empty() )
+			mDimension = dimension;
+		else if ( mDimension != dimension )
+			mDimension = 1;
+		mEncoding = ENCODING_LINEAR;
+		mSegments.push_back( segment );
+		return true;
+	}
+
+	//------------------------------
+	template<class T>
+	bool QuantizedArray::appendOctahedralTemplate( const T* values, size_t valueCount )
+	{
+		if ( valueCount % 3 != 0 )
+			return false;
+		if ( empty() )
+			clear();
+		else if ( mEncoding != ENCODING_OCTAHEDRAL )
+			return false;
+
+		mEncoding = ENCODING_OCTAHEDRAL;
+		mDimension = 3;
+		const size_t firstElement = mValues.getCount() / 2;
+		const size_t elementCount = valueCount / 3;
+		mValues.reallocMemory( 2 * ( firstElement + elementCount ) );
+		unsigned short* encoded = mValues.getData();
+		mValues.setCount( 2 * ( firstElement + elementCount ) );
+		for ( size_t element = firstElement; element < firstElement + elementCount; ++element )
+		{
+			const T* value = values + 3 * ( element - firstElement );
+			const double length = sqrt( (double)value[0] * value[0] + (double)value[1] * value[1] + (double)value[2] * value[2] );
+			double direction[3] = { 0, 0, 1 };
+			if ( length > 0 )
+			{
+				for ( size_t i = 0; i < 3; ++i )
+					direction[i] = value[i] / length;
+			}
+
+			// project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the upper
+			const double sum = fabs( direction[0] ) + fabs( direction[1] ) + fabs( direction[2] );
+			double x = direction[0] / sum;
+			double y = direction[1] / sum;
+			if ( direction[2] < 0 )
+			{
+				const double foldedX = ( 1.0 - fabs( y ) ) * signNotZero( x );
+				const double foldedY = ( 1.0 - fabs( x ) ) * signNotZero( y );
+				x = foldedX;
+				y = foldedY;
+			}
+			encoded[2 * element] = encodeSigned( x );
+			encoded[2 * element + 1] = encodeSigned( y );
+
+			// the error is measured against the passed value, so it includes the normalization
+			double decoded[3];
+			decodeDirection( element, decoded );
+			for ( size_t i = 0; i < 3; ++i )
+			{
+				const double error = fabs( decoded[i] - value[i] );
+				if ( error > mMaxError )
+					mMaxError = error;
+			}
+		}
+		return true;
+	}
+
+	//------------------------------
+	size_t QuantizedArray::findSegment( size_t value ) const
+	{
+		// there are only a few segments, usually one per source
+		size_t segment = mSegments.size() - 1;
+		while ( segment > 0 && mSegments[segment].firstValue > value )
+			--segment;
+		return segment;
+	}
+
+	//------------------------------
+	void QuantizedArray::decodeDirection( size_t element, double direction[3] ) const
+	{
+		const unsigned short* encoded = mValues.getData() + 2 * element;
+		double x = decodeSigned( encoded[0] );
+		double y = decodeSigned( encoded[1] );
+		const double z = 1.0 - fabs( x ) - fabs( y );
+		if ( z < 0 )
+		{
+			const double unfoldedX = ( 1.0 - fabs( y ) ) * signNotZero( x );
+			const double unfoldedY = ( 1.0 - fabs( x ) ) * signNotZero( y );
+			x = unfoldedX;
+			y = unfoldedY;
+		}
+		const double length = sqrt( x * x + y * y + z * z );
+		direction[0] = x / length;
+		direction[1] = y / length;
+		direction[2] = z / length;
+	}
+
+	//------------------------------
+	template<class T>
+	void QuantizedArray::decodeTemplate( size_t firstValue, size_t valueCount, T* destination ) const
+	{
+		if ( mEncoding == ENCODING_OCTAHEDRAL )
+		{
+			double direction[3];
+			size_t decodedElement = (size_t)-1;
+			for ( size_t i = firstValue, end = firstValue + valueCount; i < end; ++i )
+			{
+				const size_t element = i / 3;
+				if ( element != decodedElement )
+				{
+					decodeDirection( element, direction );
+					decodedElement = element;
+				}
+				*destination++ = (T)direction[i % 3];
+			}
+		}
+		else if ( valueCount > 0 && !mSegments.empty() )
+		{
+			const unsigned short* encoded = mValues.getData();
+			size_t segmentIndex = findSegment( firstValue );
+			for ( size_t i = firstValue, end = firstValue + valueCount; i < end; ++i )
+			{
+				while ( segmentIndex + 1 < mSegments.size() && mSegments[segmentIndex + 1].firstValue <= i )
+					++segmentIndex;
+				const LinearSegment& segment = mSegments[segmentIndex];
+				const size_t component = ( i - segment.firstValue ) % segment.dimension;
+				*destination++ = (T)( segment.biases[component] + encoded[i] * segment.scales[component] );
+			}
+		}
+	}
+
+	//------------------------------
+	bool QuantizedArray::encodeLinear( const float* values, size_t valueCount, size_t dimension )
+	{
+		clear();
+		return appendLinearTemplate( values, valueCount, dimension );
+	}
+
+	//------------------------------
+	bool QuantizedArray::encodeLinear( const double* values, size_t valueCount, size_t dimension )
+	{
+		clear();
+		return appendLinearTemplate( values, valueCount, dimension );
+	}
+
+	//------------------------------
+	bool QuantizedArray::appendLinear( const float* values, size_t valueCount, size_t dimension )
+	{
+		return appendLinearTemplate( values, valueCount, dimension );
+	}
+
+	//------------------------------
+	bool QuantizedArray::appendLinear( const double* values, size_t valueCount, size_t dimension )
+	{
+		return appendLinearTemplate( values, valueCount, dimension );
+	}
+
+	//------------------------------
+	bool QuantizedArray::encodeOctahedral( const float* values, size_t valueCount )
+	{
+		clear();
+		return appendOctahedralTemplate( values, valueCount );
+	}
+
+	//------------------------------
+	bool QuantizedArray::encodeOctahedral( const double* values, size_t valueCount )
+	{
+		clear();
+		return appendOctahedralTemplate( values, valueCount );
+	}
+
+	//------------------------------
+	bool QuantizedArray::appendOctahedral( const float* values, size_t valueCount )
+	{
+		return appendOctahedralTemplate( values, valueCount );
+	}
+
+	//------------------------------
+	bool QuantizedArray::appendOctahedral( const double* values, size_t valueCount )
+	{
+		return appendOctahedralTemplate( values, valueCount );
+	}
+
+	//------------------------------
+	void QuantizedArray::decode( size_t firstValue, size_t valueCount, float* destination ) const
+	{
+		decodeTemplate( firstValue, valueCount, destination );
+	}
+
+	//------------------------------
+	void QuantizedArray::decode( size_t firstValue, size_t valueCount, double* destination ) const
+	{
+		decodeTemplate( firstValue, valueCount, destination );
+	}
+
+} // namespace COLLADAFW
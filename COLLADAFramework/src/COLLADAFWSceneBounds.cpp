@@ -0,0 +1,172 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWSceneBounds.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWController.h"
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWLibraryNodes.h"
+#include "COLLADAFWNode.h"
+
+
+namespace COLLADAFW
+{
+
+	//------------------------------
+	SceneBounds::SceneBounds()
+	{
+	}
+
+	//------------------------------
+	SceneBounds::~SceneBounds()
+	{
+	}
+
+	//------------------------------
+	void SceneBounds::addGeometry( const Geometry& geometry )
+	{
+		if ( geometry.getType() != Geometry::GEO_TYPE_MESH )
+			return;
+
+		const Mesh& mesh = (const Mesh&)geometry;
+		mGeometryBoundingBoxes[mesh.getUniqueId()] = mesh.getBoundingBox();
+	}
+
+	//------------------------------
+	void SceneBounds::addController( const Controller& controller )
+	{
+		mControllerSources[controller.getUniqueId()] = controller.getSource();
+	}
+
+	//------------------------------
+	void SceneBounds::addVisualScene( const VisualScene& visualScene )
+	{
+		NodeIndexList& rootNodes = mVisualSceneRootNodes[visualScene.getUniqueId()];
+		const NodePointerArray& nodes = visualScene.getRootNodes();
+		for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+			rootNodes.push_back( addNode(*nodes[i]) );
+	}
+
+	//------------------------------
+	void SceneBounds::addLibraryNodes( const LibraryNodes& libraryNodes )
+	{
+		const NodePointerArray& nodes = libraryNodes.getNodes();
+		for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+			addNode(*nodes[i]);
+	}
+
+	//------------------------------
+	size_t SceneBounds::addNode( const Node& node )
+	{
+		size_t nodeIndex = mNodeInfos.size();
+		mNodeInfos.push_back(NodeInfo());
+		mNodeIndices[node.getUniqueId()] = nodeIndex;
+
+		// mNodeInfos might be reallocated by the child nodes, so the node info is accessed by index
+		node.getTransformationMatrix(mNodeInfos[nodeIndex].transformation);
+
+		const InstanceGeometryPointerArray& instanceGeometries = node.getInstanceGeometries();
+		for ( size_t i = 0, count = instanceGeometries.getCount(); i < count; ++i )
+			mNodeInfos[nodeIndex].instantiatedGeometries.push_back(instanceGeometries[i]->getInstanciatedObjectId());
+
+		const InstanceControllerPointerArray& instanceControllers = node.getInstanceControllers();
+		for ( size_t i = 0, count = instanceControllers.getCount(); i < count; ++i )
+			mNodeInfos[nodeIndex].instantiatedGeometries.push_back(instanceControllers[i]->getInstanciatedObjectId());
+
+		const InstanceNodePointerArray& instanceNodes = node.getInstanceNodes();
+		for ( size_t i = 0, count = instanceNodes.getCount(); i < count; ++i )
+			mNodeInfos[nodeIndex].instantiatedNodes.push_back(instanceNodes[i]->getInstanciatedObjectId());
+
+		const NodePointerArray& childNodes = node.getChildNodes();
+		for ( size_t i = 0, count = childNodes.getCount(); i < count; ++i )
+		{
+			size_t childIndex = addNode(*childNodes[i]);
+			mNodeInfos[nodeIndex].childNodes.push_back(childIndex);
+		}
+
+		return nodeIndex;
+	}
+
+	//------------------------------
+	BoundingBox SceneBounds::getInstantiatedBoundingBox( const UniqueId& uniqueId ) const
+	{
+		// Follow the sources of controllers until a geometry is reached. The number of steps is
+		// limited by the number of controllers, to stop at controllers that modify each other.
+		UniqueId sourceId = uniqueId;
+		for ( size_t i = 0, count = mControllerSources.size(); i <= count; ++i )
+		{
+			UniqueIdBoundingBoxMap::const_iterator geometryIt = mGeometryBoundingBoxes.find(sourceId);
+			if ( geometryIt != mGeometryBoundingBoxes.end() )
+				return geometryIt->second;
+
+			UniqueIdUniqueIdMap::const_iterator controllerIt = mControllerSources.find(sourceId);
+			if ( controllerIt == mControllerSources.end() )
+				break;
+			sourceId = controllerIt->second;
+		}
+		return BoundingBox();
+	}
+
+	//------------------------------
+	void SceneBounds::extendByNode( size_t nodeIndex, const COLLADABU::Math::Matrix4& parentMatrix, std::vector<bool>& visiting, BoundingBox& boundingBox ) const
+	{
+		if ( visiting[nodeIndex] )
+			return;
+		visiting[nodeIndex] = true;
+
+		const NodeInfo& nodeInfo = mNodeInfos[nodeIndex];
+		COLLADABU::Math::Matrix4 worldMatrix = parentMatrix * nodeInfo.transformation;
+
+		for ( size_t i = 0, count = nodeInfo.instantiatedGeometries.size(); i < count; ++i )
+		{
+			BoundingBox geometryBoundingBox = getInstantiatedBoundingBox(nodeInfo.instantiatedGeometries[i]);
+			boundingBox.extend(geometryBoundingBox.transformed(worldMatrix));
+		}
+
+		// The instantiated nodes are placed as children of the node
+		for ( size_t i = 0, count = nodeInfo.instantiatedNodes.size(); i < count; ++i )
+		{
+			UniqueIdNodeIndexMap::const_iterator it = mNodeIndices.find(nodeInfo.instantiatedNodes[i]);
+			if ( it != mNodeIndices.end() )
+				extendByNode(it->second, worldMatrix, visiting, boundingBox);
+		}
+
+		for ( size_t i = 0, count = nodeInfo.childNodes.size(); i < count; ++i )
+			extendByNode(nodeInfo.childNodes[i], worldMatrix, visiting, boundingBox);
+
+		visiting[nodeIndex] = false;
+	}
+
+	//------------------------------
+	BoundingBox SceneBounds::getBoundingBox( const UniqueId& visualSceneId ) const
+	{
+		BoundingBox boundingBox;
+		UniqueIdNodeIndexListMap::const_iterator it = mVisualSceneRootNodes.find(visualSceneId);
+		if ( it == mVisualSceneRootNodes.end() )
+			return boundingBox;
+
+		std::vector<bool> visiting(mNodeInfos.size(), false);
+		const NodeIndexList& rootNodes = it->second;
+		for ( size_t i = 0, count = rootNodes.size(); i < count; ++i )
+			extendByNode(rootNodes[i], COLLADABU::Math::Matrix4::IDENTITY, visiting, boundingBox);
+		return boundingBox;
+	}
+
+	//------------------------------
+	BoundingBox SceneBounds::getBoundingBox() const
+	{
+		BoundingBox boundingBox;
+		for ( UniqueIdNodeIndexListMap::const_iterator it = mVisualSceneRootNodes.begin(); it != mVisualSceneRootNodes.end(); ++it )
+			boundingBox.extend(getBoundingBox(it->first));
+		return boundingBox;
+	}
+
+} // namespace COLLADAFW
@@ -18,6 +18,7 @@ namespace COLLADAFW
     //------------------------------
 	SkinControllerData::SkinControllerData( const UniqueId& uniqueId )
 		: ObjectTemplate< COLLADA_TYPE::SKIN_DATA >(uniqueId)
+		, mJointsCount(0)
 		, mBindShapeMatrix(COLLADABU::Math::Matrix4::IDENTITY)
 		, mJointsPerVertex(UIntValuesArray::OWNER)
 		, mWeightIndices(UIntValuesArray::OWNER)
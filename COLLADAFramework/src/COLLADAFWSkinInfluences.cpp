@@ -0,0 +1,515 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWSkinInfluences.h"
+#include "COLLADAFWSkinControllerData.h"
+
+#include "COLLADABUThread.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#	include <emmintrin.h>
+#	define COLLADAFW_SKINNING_SSE2
+#endif
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** The number of vertices a thread takes at once.*/
+		const size_t VERTICES_PER_CHUNK = 4096;
+
+		/** The largest number of joints. The largest joint index is used for the bind shape.*/
+		const size_t MAX_JOINT_COUNT = 0xFFFF;
+
+		/** The influence of a joint on a vertex, before it is stored.*/
+		struct Influence
+		{
+			double weight;
+			unsigned int jointIndex;
+		};
+
+		typedef std::vector<Influence> InfluenceList;
+
+		/** Sorts by decreasing weight. Equal weights are sorted by joint index, so the order does
+		not depend on the order of the influences in the skin controller.*/
+		inline bool isHeavier( const Influence& lhs, const Influence& rhs )
+		{
+			if ( lhs.weight != rhs.weight )
+				return lhs.weight > rhs.weight;
+			return lhs.jointIndex < rhs.jointIndex;
+		}
+
+		/** Stores the weights of @a influenceCount influences, that sum up to 1, as integers
+		that sum up to @a maxValue. The rounding error is added to the first, i.e. largest, weight.*/
+		template<class T>
+		void quantizeWeights( const double* weights, size_t influenceCount, unsigned int maxValue, T* quantizedWeights, size_t stride )
+		{
+			int sum = 0;
+			for ( size_t k = 0; k < influenceCount; ++k )
+			{
+				const int value = (int)( weights[k] * maxValue + 0.5 );
+				quantizedWeights[k * stride] = (T)value;
+				sum += value;
+			}
+			const int firstValue = (int)quantizedWeights[0] + (int)maxValue - sum;
+			quantizedWeights[0] = (T)std::min( std::max( firstValue, 0 ), (int)maxValue );
+		}
+
+		/** Skins @a vertexCount positions by linear blending of the matrices of the first
+		@a usedInfluenceCount influences. The scale of quantized weights, @a weightScale, is applied
+		once to the skinned position. The influence count is a template parameter, so the loop over
+		the influences is unrolled.*/
+		template<size_t usedInfluenceCount, class T>
+		void skinPositionsTemplate( const float* matrices, const unsigned short* jointIndices, const T* weights, size_t stride, float weightScale,
+			const float* positions, float* skinnedPositions, size_t vertexCount )
+		{
+			for ( size_t i = 0; i < vertexCount; ++i )
+			{
+				// unused influences have weight 0 and add nothing, so there is no branch per influence
+#if defined(COLLADAFW_SKINNING_SSE2)
+				__m128 row0 = _mm_setzero_ps();
+				__m128 row1 = _mm_setzero_ps();
+				__m128 row2 = _mm_setzero_ps();
+				for ( size_t k = 0; k < usedInfluenceCount; ++k )
+				{
+					const __m128 weight = _mm_set1_ps( (float)weights[k * stride + i] );
+					const float* matrix = matrices + jointIndices[k * stride + i] * SkinInfluences::MATRIX_SIZE;
+					row0 = _mm_add_ps( row0, _mm_mul_ps( weight, _mm_loadu_ps( matrix ) ) );
+					row1 = _mm_add_ps( row1, _mm_mul_ps( weight, _mm_loadu_ps( matrix + 4 ) ) );
+					row2 = _mm_add_ps( row2, _mm_mul_ps( weight, _mm_loadu_ps( matrix + 8 ) ) );
+				}
+
+				// the products of the rows with the position are transposed, so a vertical sum gives the dot products
+				const __m128 position = _mm_set_ps( 1.0f, positions[3 * i + 2], positions[3 * i + 1], positions[3 * i] );
+				__m128 x = _mm_mul_ps( row0, position );
+				__m128 y = _mm_mul_ps( row1, position );
+				__m128 z = _mm_mul_ps( row2, position );
+				__m128 w = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS( x, y, z, w );
+				const __m128 sum = _mm_add_ps( _mm_add_ps( x, y ), _mm_add_ps( z, w ) );
+				float skinned[4];
+				_mm_storeu_ps( skinned, _mm_mul_ps( sum, _mm_set1_ps( weightScale ) ) );
+				skinnedPositions[3 * i] = skinned[0];
+				skinnedPositions[3 * i + 1] = skinned[1];
+				skinnedPositions[3 * i + 2] = skinned[2];
+#else
+				float m[SkinInfluences::MATRIX_SIZE];
+				for ( size_t c = 0; c < SkinInfluences::MATRIX_SIZE; ++c )
+					m[c] = 0.0f;
+				for ( size_t k = 0; k < usedInfluenceCount; ++k )
+				{
+					const float weight = (float)weights[k * stride + i];
+					const float* matrix = matrices + jointIndices[k * stride + i] * SkinInfluences::MATRIX_SIZE;
+					for ( size_t c = 0; c < SkinInfluences::MATRIX_SIZE; ++c )
+						m[c] += weight * matrix[c];
+				}
+
+				const float x = positions[3 * i];
+				const float y = positions[3 * i + 1];
+				const float z = positions[3 * i + 2];
+				skinnedPositions[3 * i] = ( m[0] * x + m[1] * y + m[2] * z + m[3] ) * weightScale;
+				skinnedPositions[3 * i + 1] = ( m[4] * x + m[5] * y + m[6] * z + m[7] ) * weightScale;
+				skinnedPositions[3 * i + 2] = ( m[8] * x + m[9] * y + m[10] * z + m[11] ) * weightScale;
+#endif
+			}
+		}
+
+		/** Calls skinPositionsTemplate() with @a usedInfluenceCount as template parameter.*/
+		template<class T>
+		void dispatchSkinPositions( const float* matrices, const unsigned short* jointIndices, const T* weights, size_t stride,
+			size_t usedInfluenceCount, float weightScale, const float* positions, float* skinnedPositions, size_t vertexCount )
+		{
+			switch ( usedInfluenceCount )
+			{
+			case 1:
+				skinPositionsTemplate<1>( matrices, jointIndices, weights, stride, weightScale, positions, skinnedPositions, vertexCount );
+				break;
+			case 2:
+				skinPositionsTemplate<2>( matrices, jointIndices, weights, stride, weightScale, positions, skinnedPositions, vertexCount );
+				break;
+			case 3:
+				skinPositionsTemplate<3>( matrices, jointIndices, weights, stride, weightScale, positions, skinnedPositions, vertexCount );
+				break;
+			case 4:
+				skinPositionsTemplate<4>( matrices, jointIndices, weights, stride, weightScale, positions, skinnedPositions, vertexCount );
+				break;
+			case 5:
+				skinPositionsTemplate<5>( matrices, jointIndices, weights, stride, weightScale, positions, skinnedPositions, vertexCount );
+				break;
+			case 6:
+				skinPositionsTemplate<6>( matrices, jointIndices, weights, stride, weightScale, positions, skinnedPositions, vertexCount );
+				break;
+			case 7:
+				skinPositionsTemplate<7>( matrices, jointIndices, weights, stride, weightScale, positions, skinnedPositions, vertexCount );
+				break;
+			default:
+				skinPositionsTemplate<SkinInfluences::INFLUENCES_8>( matrices, jointIndices, weights, stride, weightScale, positions, skinnedPositions, vertexCount );
+				break;
+			}
+		}
+	}
+
+
+	/** Builds the influences of a chunk of vertices per iteration of a parallelFor(). Each thread
+	uses its own body, since the body holds the scratch data and statistics of its thread.*/
+	class SkinInfluences::BuildBody : public COLLADABU::ParallelForBody
+	{
+	private:
+		/** The influences that are built.*/
+		SkinInfluences& mInfluences;
+
+		/** The skin controller the influences are built from.*/
+		const SkinControllerData& mSkinControllerData;
+
+		/** The weights of the skin controller.*/
+		const std::vector<double>& mWeights;
+
+		/** The index of the first joint / weight index pair of each chunk of vertices.*/
+		const std::vector<size_t>& mChunkOffsets;
+
+		/** The valid influences of the current vertex.*/
+		InfluenceList mVertexInfluences;
+
+		/** The normalized weights of the influences stored for the current vertex.*/
+		double mStoredWeights[INFLUENCES_8];
+
+		/** The statistics of the vertices built by this body.*/
+		size_t mUsedInfluenceCount;
+		size_t mDroppedInfluenceCount;
+		double mMaxDroppedWeight;
+
+	public:
+		BuildBody( SkinInfluences& influences, const SkinControllerData& skinControllerData, const std::vector<double>& weights,
+			const std::vector<size_t>& chunkOffsets )
+			: mInfluences( influences )
+			, mSkinControllerData( skinControllerData )
+			, mWeights( weights )
+			, mChunkOffsets( chunkOffsets )
+			, mUsedInfluenceCount( 0 )
+			, mDroppedInfluenceCount( 0 )
+			, mMaxDroppedWeight( 0 )
+		{}
+
+		/** Adds the statistics of this body to the influences. Called after the parallelFor().*/
+		void addStatistics()
+		{
+			mInfluences.mUsedInfluenceCount = std::max( mInfluences.mUsedInfluenceCount, mUsedInfluenceCount );
+			mInfluences.mDroppedInfluenceCount += mDroppedInfluenceCount;
+			mInfluences.mMaxDroppedWeight = std::max( mInfluences.mMaxDroppedWeight, (float)mMaxDroppedWeight );
+		}
+
+		/** Builds the influences of the vertices of chunk @a chunkIndex.*/
+		virtual void process( size_t chunkIndex )
+		{
+			const unsigned int* jointsPerVertex = mSkinControllerData.getJointsPerVertex().getData();
+			const int* jointIndices = mSkinControllerData.getJointIndices().getData();
+			const unsigned int* weightIndices = mSkinControllerData.getWeightIndices().getData();
+
+			const size_t firstVertex = chunkIndex * VERTICES_PER_CHUNK;
+			const size_t lastVertex = std::min( firstVertex + VERTICES_PER_CHUNK, mInfluences.mVertexCount );
+			size_t pairIndex = mChunkOffsets[chunkIndex];
+			for ( size_t vertexIndex = firstVertex; vertexIndex < lastVertex; ++vertexIndex )
+			{
+				const size_t pairCount = jointsPerVertex[vertexIndex];
+				gatherInfluences( jointIndices + pairIndex, weightIndices + pairIndex, pairCount );
+				storeInfluences( vertexIndex );
+				pairIndex += pairCount;
+			}
+		}
+
+	private:
+
+        /** Disable default copy ctor. */
+		BuildBody( const BuildBody& pre );
+
+        /** Disable default assignment operator. */
+		const BuildBody& operator= ( const BuildBody& pre );
+
+		/** Collects the valid influences of @a pairCount joint / weight index pairs in
+		mVertexInfluences. Influences of the same joint are merged, invalid ones are dropped.*/
+		void gatherInfluences( const int* jointIndices, const unsigned int* weightIndices, size_t pairCount )
+		{
+			const size_t jointCount = mInfluences.mJointCount;
+			const size_t weightCount = mWeights.size();
+
+			mVertexInfluences.clear();
+			for ( size_t p = 0; p < pairCount; ++p )
+			{
+				const int jointIndex = jointIndices[p];
+				const unsigned int weightIndex = weightIndices[p];
+				if ( jointIndex < -1 || jointIndex >= (int)jointCount || weightIndex >= weightCount )
+				{
+					++mDroppedInfluenceCount;
+					continue;
+				}
+				const double weight = mWeights[weightIndex];
+				// also drops NaN
+				if ( !( weight > 0 ) )
+				{
+					++mDroppedInfluenceCount;
+					continue;
+				}
+
+				Influence influence;
+				influence.weight = weight;
+				influence.jointIndex = jointIndex < 0 ? (unsigned int)jointCount : (unsigned int)jointIndex;
+
+				size_t i = 0;
+				const size_t count = mVertexInfluences.size();
+				while ( i < count && mVertexInfluences[i].jointIndex != influence.jointIndex )
+					++i;
+				if ( i < count )
+					mVertexInfluences[i].weight += weight;
+				else
+					mVertexInfluences.push_back( influence );
+			}
+		}
+
+		/** Sorts, drops and normalizes the influences in mVertexInfluences and stores them for
+		vertex @a vertexIndex.*/
+		void storeInfluences( size_t vertexIndex )
+		{
+			const size_t influenceCount = mInfluences.mInfluenceCount;
+			const size_t stride = mInfluences.mVertexCount;
+			unsigned short* jointIndices = &mInfluences.mJointIndices[vertexIndex];
+
+			double weightSum = 0;
+			for ( size_t i = 0, count = mVertexInfluences.size(); i < count; ++i )
+				weightSum += mVertexInfluences[i].weight;
+
+			size_t storedCount = 0;
+			if ( weightSum > 0 )
+			{
+				// insertion sort, since a vertex has only a few influences
+				for ( size_t i = 1, count = mVertexInfluences.size(); i < count; ++i )
+				{
+					const Influence influence = mVertexInfluences[i];
+					size_t j = i;
+					for ( ; j > 0 && isHeavier( influence, mVertexInfluences[j - 1] ); --j )
+						mVertexInfluences[j] = mVertexInfluences[j - 1];
+					mVertexInfluences[j] = influence;
+				}
+
+				// the heaviest influence is always kept
+				const double minWeight = mInfluences.mWeightThreshold * weightSum;
+				const size_t maxCount = std::min( influenceCount, mVertexInfluences.size() );
+				double storedSum = 0;
+				while ( storedCount < maxCount && ( storedCount == 0 || mVertexInfluences[storedCount].weight >= minWeight ) )
+				{
+					jointIndices[storedCount * stride] = (unsigned short)mVertexInfluences[storedCount].jointIndex;
+					mStoredWeights[storedCount] = mVertexInfluences[storedCount].weight;
+					storedSum += mVertexInfluences[storedCount].weight;
+					++storedCount;
+				}
+				for ( size_t k = 0; k < storedCount; ++k )
+					mStoredWeights[k] /= storedSum;
+				mDroppedInfluenceCount += mVertexInfluences.size() - storedCount;
+				mMaxDroppedWeight = std::max( mMaxDroppedWeight, ( weightSum - storedSum ) / weightSum );
+			}
+			else
+			{
+				// bound to the bind shape
+				jointIndices[0] = (unsigned short)mInfluences.mJointCount;
+				mStoredWeights[0] = 1;
+				storedCount = 1;
+			}
+
+			for ( size_t k = storedCount; k < influenceCount; ++k )
+			{
+				jointIndices[k * stride] = 0;
+				mStoredWeights[k] = 0;
+			}
+
+			switch ( mInfluences.mWeightFormat )
+			{
+			case WEIGHT_FLOAT:
+				for ( size_t k = 0; k < influenceCount; ++k )
+					mInfluences.mWeights[k * stride + vertexIndex] = (float)mStoredWeights[k];
+				break;
+			case WEIGHT_UNORM16:
+				quantizeWeights( mStoredWeights, storedCount, 0xFFFF, &mInfluences.mWeights16[vertexIndex], stride );
+				for ( size_t k = storedCount; k < influenceCount; ++k )
+					mInfluences.mWeights16[k * stride + vertexIndex] = 0;
+				break;
+			case WEIGHT_UNORM8:
+				quantizeWeights( mStoredWeights, storedCount, 0xFF, &mInfluences.mWeights8[vertexIndex], stride );
+				for ( size_t k = storedCount; k < influenceCount; ++k )
+					mInfluences.mWeights8[k * stride + vertexIndex] = 0;
+				break;
+			}
+
+			mUsedInfluenceCount = std::max( mUsedInfluenceCount, storedCount );
+		}
+
+	};
+
+
+	const float SkinInfluences::DEFAULT_WEIGHT_THRESHOLD = 1e-4f;
+
+	//------------------------------
+	SkinInfluences::SkinInfluences( InfluenceCount influenceCount, WeightFormat weightFormat )
+		: mInfluenceCount( influenceCount )
+		, mWeightFormat( weightFormat )
+		, mWeightThreshold( DEFAULT_WEIGHT_THRESHOLD )
+		, mVertexCount( 0 )
+		, mJointCount( 0 )
+		, mUsedInfluenceCount( 0 )
+		, mDroppedInfluenceCount( 0 )
+		, mMaxDroppedWeight( 0 )
+	{
+	}
+
+	//------------------------------
+	SkinInfluences::~SkinInfluences()
+	{
+	}
+
+	//------------------------------
+	void SkinInfluences::clear()
+	{
+		mVertexCount = 0;
+		mJointCount = 0;
+		mUsedInfluenceCount = 0;
+		mDroppedInfluenceCount = 0;
+		mMaxDroppedWeight = 0;
+		std::vector<unsigned short>().swap( mJointIndices );
+		std::vector<float>().swap( mWeights );
+		std::vector<unsigned short>().swap( mWeights16 );
+		std::vector<unsigned char>().swap( mWeights8 );
+	}
+
+	//------------------------------
+	bool SkinInfluences::build( const SkinControllerData& skinControllerData, size_t threadCount )
+	{
+		clear();
+
+		const UIntValuesArray& jointsPerVertex = skinControllerData.getJointsPerVertex();
+		const size_t vertexCount = jointsPerVertex.getCount();
+		const size_t jointCount = skinControllerData.getJointsCount();
+		if ( jointCount > MAX_JOINT_COUNT )
+			return false;
+
+		// the vertices are split into chunks, whose pairs can be found without a pass over the previous vertices
+		const size_t chunkCount = ( vertexCount + VERTICES_PER_CHUNK - 1 ) / VERTICES_PER_CHUNK;
+		std::vector<size_t> chunkOffsets( chunkCount + 1 );
+		size_t pairCount = 0;
+		for ( size_t i = 0; i < vertexCount; ++i )
+		{
+			if ( i % VERTICES_PER_CHUNK == 0 )
+				chunkOffsets[i / VERTICES_PER_CHUNK] = pairCount;
+			pairCount += jointsPerVertex[i];
+		}
+		chunkOffsets[chunkCount] = pairCount;
+		if ( pairCount > skinControllerData.getJointIndices().getCount() || pairCount > skinControllerData.getWeightIndices().getCount() )
+			return false;
+
+		std::vector<double> weights;
+		skinControllerData.getWeights().copyValues( weights );
+
+		mVertexCount = vertexCount;
+		mJointCount = jointCount;
+		const size_t valueCount = mInfluenceCount * vertexCount;
+		mJointIndices.resize( valueCount );
+		switch ( mWeightFormat )
+		{
+		case WEIGHT_FLOAT:
+			mWeights.resize( valueCount );
+			break;
+		case WEIGHT_UNORM16:
+			mWeights16.resize( valueCount );
+			break;
+		case WEIGHT_UNORM8:
+			mWeights8.resize( valueCount );
+			break;
+		}
+
+		std::vector<BuildBody*> bodies;
+		for ( size_t i = 0, bodyCount = std::max<size_t>( std::min( threadCount, chunkCount ), 1 ); i < bodyCount; ++i )
+			bodies.push_back( FW_NEW BuildBody( *this, skinControllerData, weights, chunkOffsets ) );
+		COLLADABU::parallelFor( chunkCount, std::vector<COLLADABU::ParallelForBody*>( bodies.begin(), bodies.end() ) );
+
+		for ( size_t i = 0, count = bodies.size(); i < count; ++i )
+		{
+			bodies[i]->addStatistics();
+			FW_DELETE bodies[i];
+		}
+
+		return true;
+	}
+
+	//------------------------------
+	float SkinInfluences::getWeight( size_t influenceIndex, size_t vertexIndex ) const
+	{
+		const size_t index = influenceIndex * mVertexCount + vertexIndex;
+		switch ( mWeightFormat )
+		{
+		case WEIGHT_UNORM16:
+			return mWeights16[index] * ( 1.0f / 0xFFFF );
+		case WEIGHT_UNORM8:
+			return mWeights8[index] * ( 1.0f / 0xFF );
+		default:
+			return mWeights[index];
+		}
+	}
+
+	//------------------------------
+	void SkinInfluences::setMatrices( const SkinControllerData& skinControllerData, const COLLADABU::Math::Matrix4* jointMatrices, float* matrices ) const
+	{
+		const COLLADABU::Math::Matrix4& bindShapeMatrix = skinControllerData.getBindShapeMatrix();
+		const Matrix4Array& inverseBindMatrices = skinControllerData.getInverseBindMatrices();
+		for ( size_t j = 0; j <= mJointCount; ++j )
+		{
+			COLLADABU::Math::Matrix4 matrix;
+			if ( j == mJointCount )
+				matrix = bindShapeMatrix;
+			else if ( j < inverseBindMatrices.getCount() )
+				matrix = jointMatrices[j] * inverseBindMatrices[j] * bindShapeMatrix;
+			else
+				matrix = jointMatrices[j] * bindShapeMatrix;
+
+			float* destination = matrices + j * MATRIX_SIZE;
+			for ( size_t r = 0; r < 3; ++r )
+			{
+				for ( size_t c = 0; c < 4; ++c )
+					destination[r * 4 + c] = (float)matrix[r][c];
+			}
+		}
+	}
+
+	//------------------------------
+	void SkinInfluences::skinPositions( const float* matrices, const float* positions, float* skinnedPositions, size_t firstVertex, size_t vertexCount ) const
+	{
+		if ( vertexCount == 0 )
+			return;
+
+		const unsigned short* jointIndices = &mJointIndices[firstVertex];
+		switch ( mWeightFormat )
+		{
+		case WEIGHT_FLOAT:
+			dispatchSkinPositions( matrices, jointIndices, &mWeights[firstVertex], mVertexCount, mUsedInfluenceCount, 1.0f,
+				positions, skinnedPositions, vertexCount );
+			break;
+		case WEIGHT_UNORM16:
+			dispatchSkinPositions( matrices, jointIndices, &mWeights16[firstVertex], mVertexCount, mUsedInfluenceCount, 1.0f / 0xFFFF,
+				positions, skinnedPositions, vertexCount );
+			break;
+		case WEIGHT_UNORM8:
+			dispatchSkinPositions( matrices, jointIndices, &mWeights8[firstVertex], mVertexCount, mUsedInfluenceCount, 1.0f / 0xFF,
+				positions, skinnedPositions, vertexCount );
+			break;
+		}
+	}
+
+} // namespace COLLADAFW
@@ -0,0 +1,310 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWTransformHierarchy.h"
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWLibraryNodes.h"
+#include "COLLADAFWNode.h"
+
+#include <algorithm>
+
+// Define COLLADAFW_CONCATENATE_SCALAR to use the scalar loop, e.g. to test it on x86
+#if defined(COLLADAFW_CONCATENATE_SCALAR)
+#elif defined(__AVX__)
+#	include <immintrin.h>
+#	define COLLADAFW_CONCATENATE_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#	include <emmintrin.h>
+#	define COLLADAFW_CONCATENATE_SSE2
+#endif
+
+
+namespace COLLADAFW
+{
+
+	const size_t TransformHierarchy::NO_ENTRY = (size_t)-1;
+
+	namespace
+	{
+		/** Copies the values of @a matrix to @a values in row major order.*/
+		inline void matrixToValues( const COLLADABU::Math::Matrix4& matrix, double* values )
+		{
+			for ( int i = 0; i < (int)TransformHierarchy::MATRIX_SIZE; ++i )
+				values[i] = matrix.getElement(i);
+		}
+
+		/** Copies the row major @a values to @a matrix.*/
+		inline void valuesToMatrix( const double* values, COLLADABU::Math::Matrix4& matrix )
+		{
+			for ( size_t i = 0; i < TransformHierarchy::MATRIX_SIZE; ++i )
+				matrix.setElement(i, values[i]);
+		}
+	}
+
+	//------------------------------
+	TransformHierarchy::TransformHierarchy()
+		: mAllDirty( false )
+	{
+	}
+
+	//------------------------------
+	TransformHierarchy::~TransformHierarchy()
+	{
+	}
+
+	//------------------------------
+	void TransformHierarchy::addVisualScene( const VisualScene& visualScene )
+	{
+		NodeIndexList& rootNodes = mVisualSceneRootNodes[visualScene.getUniqueId()];
+		const NodePointerArray& nodes = visualScene.getRootNodes();
+		for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+			rootNodes.push_back( addNode(*nodes[i]) );
+	}
+
+	//------------------------------
+	void TransformHierarchy::addLibraryNodes( const LibraryNodes& libraryNodes )
+	{
+		const NodePointerArray& nodes = libraryNodes.getNodes();
+		for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+			addNode(*nodes[i]);
+	}
+
+	//------------------------------
+	size_t TransformHierarchy::addNode( const Node& node )
+	{
+		size_t nodeIndex = mNodeInfos.size();
+		mNodeInfos.push_back(NodeInfo());
+		mNodeIndices[node.getUniqueId()] = nodeIndex;
+
+		// mNodeInfos might be reallocated by the child nodes, so the node info is accessed by index
+		mNodeInfos[nodeIndex].nodeId = node.getUniqueId();
+		node.getTransformationMatrix(mNodeInfos[nodeIndex].transformation);
+
+		const InstanceNodePointerArray& instanceNodes = node.getInstanceNodes();
+		for ( size_t i = 0, count = instanceNodes.getCount(); i < count; ++i )
+			mNodeInfos[nodeIndex].instantiatedNodes.push_back(instanceNodes[i]->getInstanciatedObjectId());
+
+		const NodePointerArray& childNodes = node.getChildNodes();
+		for ( size_t i = 0, count = childNodes.getCount(); i < count; ++i )
+		{
+			size_t childIndex = addNode(*childNodes[i]);
+			mNodeInfos[nodeIndex].childNodes.push_back(childIndex);
+		}
+
+		return nodeIndex;
+	}
+
+	//------------------------------
+	bool TransformHierarchy::flatten( const UniqueId& visualSceneId )
+	{
+		mEntries.clear();
+		mLocalMatrices.clear();
+		mWorldMatrices.clear();
+		mFirstNodeEntries.clear();
+		mNextNodeEntries.clear();
+		mDirtyEntries.clear();
+		mAllDirty = true;
+
+		UniqueIdNodeIndexListMap::const_iterator it = mVisualSceneRootNodes.find(visualSceneId);
+		if ( it == mVisualSceneRootNodes.end() )
+			return false;
+
+		std::vector<bool> visiting(mNodeInfos.size(), false);
+		const NodeIndexList& rootNodes = it->second;
+		for ( size_t i = 0, count = rootNodes.size(); i < count; ++i )
+			appendEntries(rootNodes[i], NO_ENTRY, visiting);
+
+		// Link the entries of each node in ascending order, by walking the entries backwards
+		size_t entryCount = mEntries.size();
+		mNextNodeEntries.resize(entryCount, NO_ENTRY);
+		mFirstNodeEntries.reserve(entryCount);
+		for ( size_t i = entryCount; i > 0; --i )
+		{
+			size_t entryIndex = i - 1;
+			size_t& firstEntryIndex = mFirstNodeEntries.insert(std::make_pair(mEntries[entryIndex].nodeId, NO_ENTRY)).first->second;
+			mNextNodeEntries[entryIndex] = firstEntryIndex;
+			firstEntryIndex = entryIndex;
+		}
+
+		mWorldMatrices.resize(entryCount * MATRIX_SIZE);
+		return true;
+	}
+
+	//------------------------------
+	void TransformHierarchy::appendEntries( size_t nodeIndex, size_t parentEntryIndex, std::vector<bool>& visiting )
+	{
+		if ( visiting[nodeIndex] )
+			return;
+		visiting[nodeIndex] = true;
+
+		const NodeInfo& nodeInfo = mNodeInfos[nodeIndex];
+		size_t entryIndex = mEntries.size();
+		Entry entry;
+		entry.nodeId = nodeInfo.nodeId;
+		entry.parent = parentEntryIndex;
+		entry.subtreeEnd = entryIndex + 1;
+		mEntries.push_back(entry);
+
+		mLocalMatrices.resize(mLocalMatrices.size() + MATRIX_SIZE);
+		matrixToValues(nodeInfo.transformation, &mLocalMatrices[entryIndex * MATRIX_SIZE]);
+
+		for ( size_t i = 0, count = nodeInfo.childNodes.size(); i < count; ++i )
+			appendEntries(nodeInfo.childNodes[i], entryIndex, visiting);
+
+		// The instantiated nodes are placed as children of the node
+		for ( size_t i = 0, count = nodeInfo.instantiatedNodes.size(); i < count; ++i )
+		{
+			UniqueIdNodeIndexMap::const_iterator it = mNodeIndices.find(nodeInfo.instantiatedNodes[i]);
+			if ( it != mNodeIndices.end() )
+				appendEntries(it->second, entryIndex, visiting);
+		}
+
+		mEntries[entryIndex].subtreeEnd = mEntries.size();
+		visiting[nodeIndex] = false;
+	}
+
+	//------------------------------
+	size_t TransformHierarchy::getFirstNodeEntry( const UniqueId& nodeId ) const
+	{
+		UniqueIdEntryIndexMap::const_iterator it = mFirstNodeEntries.find(nodeId);
+		return ( it == mFirstNodeEntries.end() ) ? NO_ENTRY : it->second;
+	}
+
+	//------------------------------
+	void TransformHierarchy::setLocalMatrix( size_t entryIndex, const COLLADABU::Math::Matrix4& localMatrix )
+	{
+		matrixToValues(localMatrix, &mLocalMatrices[entryIndex * MATRIX_SIZE]);
+		if ( !mAllDirty )
+			mDirtyEntries.push_back(entryIndex);
+	}
+
+	//------------------------------
+	size_t TransformHierarchy::setLocalMatrix( const UniqueId& nodeId, const COLLADABU::Math::Matrix4& localMatrix )
+	{
+		size_t entryCount = 0;
+		for ( size_t entryIndex = getFirstNodeEntry(nodeId); entryIndex != NO_ENTRY; entryIndex = mNextNodeEntries[entryIndex] )
+		{
+			setLocalMatrix(entryIndex, localMatrix);
+			++entryCount;
+		}
+		return entryCount;
+	}
+
+	//------------------------------
+	size_t TransformHierarchy::evaluate()
+	{
+		if ( mAllDirty )
+		{
+			mAllDirty = false;
+			mDirtyEntries.clear();
+			evaluateEntries(0, mEntries.size());
+			return mEntries.size();
+		}
+
+		// A subtree contains all entries up to its end, so after sorting, every dirty entry that
+		// lies before the end of the last evaluated subtree has already been evaluated.
+		std::sort(mDirtyEntries.begin(), mDirtyEntries.end());
+		size_t evaluatedCount = 0;
+		size_t evaluatedEnd = 0;
+		for ( size_t i = 0, count = mDirtyEntries.size(); i < count; ++i )
+		{
+			size_t entryIndex = mDirtyEntries[i];
+			if ( entryIndex < evaluatedEnd )
+				continue;
+			evaluatedEnd = mEntries[entryIndex].subtreeEnd;
+			evaluateEntries(entryIndex, evaluatedEnd);
+			evaluatedCount += evaluatedEnd - entryIndex;
+		}
+		mDirtyEntries.clear();
+		return evaluatedCount;
+	}
+
+	//------------------------------
+	void TransformHierarchy::evaluateEntries( size_t firstEntryIndex, size_t endEntryIndex )
+	{
+		if ( firstEntryIndex == endEntryIndex )
+			return;
+
+		// The parent of each entry precedes it, so its world matrix is always up to date
+		const double* localMatrices = &mLocalMatrices[0];
+		double* worldMatrices = &mWorldMatrices[0];
+		for ( size_t i = firstEntryIndex; i < endEntryIndex; ++i )
+		{
+			const double* localMatrix = localMatrices + i * MATRIX_SIZE;
+			double* worldMatrix = worldMatrices + i * MATRIX_SIZE;
+			size_t parentEntryIndex = mEntries[i].parent;
+			if ( parentEntryIndex == NO_ENTRY )
+				std::copy(localMatrix, localMatrix + MATRIX_SIZE, worldMatrix);
+			else
+				concatenate(worldMatrices + parentEntryIndex * MATRIX_SIZE, localMatrix, worldMatrix);
+		}
+	}
+
+	//------------------------------
+	void TransformHierarchy::getLocalMatrix( size_t entryIndex, COLLADABU::Math::Matrix4& localMatrix ) const
+	{
+		valuesToMatrix(&mLocalMatrices[entryIndex * MATRIX_SIZE], localMatrix);
+	}
+
+	//------------------------------
+	void TransformHierarchy::getWorldMatrix( size_t entryIndex, COLLADABU::Math::Matrix4& worldMatrix ) const
+	{
+		valuesToMatrix(getWorldMatrixValues(entryIndex), worldMatrix);
+	}
+
+	//------------------------------
+	void TransformHierarchy::concatenate( const double* left, const double* right, double* result )
+	{
+		// Each row of the result is the sum of the rows of right, weighted by the elements of the
+		// same row of left. The sums are built in the same order as in Matrix4::concatenate.
+#if defined(COLLADAFW_CONCATENATE_AVX)
+		const __m256d right0 = _mm256_loadu_pd(right);
+		const __m256d right1 = _mm256_loadu_pd(right + 4);
+		const __m256d right2 = _mm256_loadu_pd(right + 8);
+		const __m256d right3 = _mm256_loadu_pd(right + 12);
+		for ( size_t row = 0; row < 16; row += 4 )
+		{
+			__m256d sum = _mm256_mul_pd(_mm256_set1_pd(left[row]), right0);
+			sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(left[row + 1]), right1));
+			sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(left[row + 2]), right2));
+			sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(left[row + 3]), right3));
+			_mm256_storeu_pd(result + row, sum);
+		}
+#elif defined(COLLADAFW_CONCATENATE_SSE2)
+		for ( size_t row = 0; row < 16; row += 4 )
+		{
+			__m128d factor = _mm_set1_pd(left[row]);
+			__m128d sumLow = _mm_mul_pd(factor, _mm_loadu_pd(right));
+			__m128d sumHigh = _mm_mul_pd(factor, _mm_loadu_pd(right + 2));
+			for ( size_t k = 1; k < 4; ++k )
+			{
+				factor = _mm_set1_pd(left[row + k]);
+				sumLow = _mm_add_pd(sumLow, _mm_mul_pd(factor, _mm_loadu_pd(right + 4 * k)));
+				sumHigh = _mm_add_pd(sumHigh, _mm_mul_pd(factor, _mm_loadu_pd(right + 4 * k + 2)));
+			}
+			_mm_storeu_pd(result + row, sumLow);
+			_mm_storeu_pd(result + row + 2, sumHigh);
+		}
+#else
+		for ( size_t row = 0; row < 16; row += 4 )
+		{
+			for ( size_t column = 0; column < 4; ++column )
+			{
+				result[row + column] = left[row] * right[column]
+				                     + left[row + 1] * right[4 + column]
+				                     + left[row + 2] * right[8 + column]
+				                     + left[row + 3] * right[12 + column];
+			}
+		}
+#endif
+	}
+
+} // namespace COLLADAFW
@@ -0,0 +1,695 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWTriangulator.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWMeshPrimitiveWithFaceVertexCount.h"
+
+#include "COLLADABUThread.h"
+
+#include <algorithm>
+#include <math.h>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		typedef Triangulator::TriangleCornerList TriangleCornerList;
+
+		//------------------------------
+		inline void addTriangle( TriangleCornerList& triangleCorners, size_t corner0, size_t corner1, size_t corner2 )
+		{
+			triangleCorners.push_back( (unsigned int)corner0 );
+			triangleCorners.push_back( (unsigned int)corner1 );
+			triangleCorners.push_back( (unsigned int)corner2 );
+		}
+
+		//------------------------------
+		/** Adds the triangles of the fan of @a cornerCount corners starting at @a firstCorner.*/
+		void addFan( TriangleCornerList& triangleCorners, size_t firstCorner, size_t cornerCount )
+		{
+			for ( size_t i = 2; i < cornerCount; ++i )
+				addTriangle( triangleCorners, firstCorner, firstCorner + i - 1, firstCorner + i );
+		}
+
+
+		/** A vertex of a polygon projected on its plane.*/
+		struct Point
+		{
+			double x;
+			double y;
+
+			/** The corner of the primitive the vertex belongs to.*/
+			size_t corner;
+		};
+
+		/** A hole of a polygon.*/
+		struct Hole
+		{
+			/** The first point of the hole.*/
+			size_t firstPoint;
+
+			/** The number of points of the hole.*/
+			size_t pointCount;
+
+			/** The point with the largest x coordinate.*/
+			size_t rightmostPoint;
+
+			/** The largest x coordinate of the hole.*/
+			double rightmostX;
+
+			/** Holes with larger x coordinates are connected to the polygon first.*/
+			bool operator<( const Hole& rhs ) const
+			{
+				return rhs.rightmostX < rightmostX;
+			}
+		};
+
+		//------------------------------
+		/** Twice the signed area of the triangle @a a, @a b, @a c. Positive, if counter clockwise.*/
+		inline double cross( const Point& a, const Point& b, const Point& c )
+		{
+			return ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x );
+		}
+
+		//------------------------------
+		inline bool isSamePoint( const Point& a, const Point& b )
+		{
+			return a.x == b.x && a.y == b.y;
+		}
+
+		//------------------------------
+		/** Returns true, if @a p lies inside or on an edge of the counter clockwise triangle @a a, @a b, @a c.*/
+		inline bool isInsideOrOnEdge( const Point& p, const Point& a, const Point& b, const Point& c )
+		{
+			return cross( a, b, p ) >= 0 && cross( b, c, p ) >= 0 && cross( c, a, p ) >= 0;
+		}
+
+		//------------------------------
+		/** Returns true, if @a p lies strictly inside the triangle @a a, @a b, @a c of any orientation.*/
+		inline bool isInside( const Point& p, const Point& a, const Point& b, const Point& c )
+		{
+			double d0 = cross( a, b, p );
+			double d1 = cross( b, c, p );
+			double d2 = cross( c, a, p );
+			return ( d0 > 0 && d1 > 0 && d2 > 0 ) || ( d0 < 0 && d1 < 0 && d2 < 0 );
+		}
+
+
+		/** Triangulates concave polygons and polygons with holes by ear clipping. The buffers are kept
+		between the polygons of a primitive, so most polygons do not allocate memory.*/
+		class EarClipper
+		{
+		private:
+			/** The positions of the mesh, if they are floats, 0 otherwise.*/
+			const float* mFloatPositions;
+
+			/** The positions of the mesh, if they are doubles, 0 otherwise.*/
+			const double* mDoublePositions;
+
+			/** The positions of the mesh, if they are quantized, 0 otherwise.*/
+			const QuantizedArray* mQuantizedPositions;
+
+			/** The number of position values.*/
+			size_t mPositionValuesCount;
+
+			/** The position index of each corner of the primitive.*/
+			const IndexArray& mPositionIndices;
+
+			/** The axes of the plane the current polygon is projected on.*/
+			size_t mAxisX;
+			size_t mAxisY;
+
+			/** The vertices of the current polygon, first the outline, then the holes.*/
+			std::vector<Point> mPoints;
+
+			/** The holes of the current polygon.*/
+			std::vector<Hole> mHoles;
+
+			/** The outline of the current polygon with the holes connected to it, as indices into mPoints.*/
+			std::vector<size_t> mRing;
+
+			/** The previous and next element of each element of mRing, that has not been cut off.*/
+			std::vector<size_t> mPrevious;
+			std::vector<size_t> mNext;
+
+		public:
+			EarClipper( const Mesh& mesh, const MeshPrimitive& primitive )
+				: mFloatPositions( 0 )
+				, mDoublePositions( 0 )
+				, mQuantizedPositions( 0 )
+				, mPositionValuesCount( mesh.getPositions().getValuesCount() )
+				, mPositionIndices( primitive.getPositionIndexArray() )
+				, mAxisX( 0 )
+				, mAxisY( 1 )
+			{
+				const MeshVertexData& positions = mesh.getPositions();
+				if ( positions.getType() == MeshVertexData::DATA_TYPE_FLOAT )
+					mFloatPositions = positions.getFloatValues()->getData();
+				else if ( positions.getType() == MeshVertexData::DATA_TYPE_DOUBLE )
+					mDoublePositions = positions.getDoubleValues()->getData();
+				else if ( positions.getType() == MeshVertexData::DATA_TYPE_QUANTIZED )
+					mQuantizedPositions = positions.getQuantizedValues();
+			}
+
+			/** Returns true, if the positions of the corners can be looked up.*/
+			bool hasPositions( size_t cornerCount ) const
+			{
+				return ( mFloatPositions || mDoublePositions || mQuantizedPositions ) && mPositionIndices.getCount() >= cornerCount;
+			}
+
+			/** Triangulates the polygon with @a outlineCount corners starting at @a firstCorner and
+			the holes with the vertex counts @a holeCounts, whose corners follow the outline. A
+			hole count is negative, as in the face vertex count array of Polygons.*/
+			void triangulate( TriangleCornerList& triangleCorners, size_t firstCorner, size_t outlineCount, const int* holeCounts, size_t holeCount );
+
+		private:
+
+			/** Disable default copy ctor. */
+			EarClipper( const EarClipper& pre );
+
+			/** Disable default assignment operator. */
+			const EarClipper& operator= ( const EarClipper& pre );
+
+			/** Stores the position of @a corner in @a position. Returns false, if it is out of range.*/
+			bool getPosition( size_t corner, double position[3] ) const;
+
+			/** Projects the @a pointCount corners starting at @a firstCorner on the plane of mAxisX and
+			mAxisY and appends them to mPoints. Returns false, if a position is out of range.*/
+			bool addPoints( size_t firstCorner, size_t pointCount );
+
+			/** Connects the hole @a hole to mRing by two edges between its rightmost point and a
+			visible point of mRing. Returns false, if no such point exists.*/
+			bool connectHole( const Hole& hole );
+
+			/** Cuts off ears of mRing until a triangle remains.*/
+			void clipEars( TriangleCornerList& triangleCorners );
+
+			/** Returns true, if the corner at ring element @a element is convex.*/
+			bool isConvex( size_t element ) const
+			{
+				return cross( mPoints[mRing[mPrevious[element]]], mPoints[mRing[element]], mPoints[mRing[mNext[element]]] ) > 0;
+			}
+		};
+
+		//------------------------------
+		bool EarClipper::getPosition( size_t corner, double position[3] ) const
+		{
+			size_t index = (size_t)mPositionIndices[corner] * 3;
+			if ( index + 3 > mPositionValuesCount )
+				return false;
+			if ( mQuantizedPositions )
+			{
+				mQuantizedPositions->decode( index, 3, position );
+				return true;
+			}
+			for ( size_t i = 0; i < 3; ++i )
+				position[i] = mFloatPositions ? mFloatPositions[index + i] : mDoublePositions[index + i];
+			return true;
+		}
+
+		//------------------------------
+		bool EarClipper::addPoints( size_t firstCorner, size_t pointCount )
+		{
+			for ( size_t i = 0; i < pointCount; ++i )
+			{
+				double position[3];
+				if ( !getPosition( firstCorner + i, position ) )
+					return false;
+				Point point;
+				point.x = position[mAxisX];
+				point.y = position[mAxisY];
+				point.corner = firstCorner + i;
+				mPoints.push_back( point );
+			}
+			return true;
+		}
+
+		//------------------------------
+		void EarClipper::triangulate( TriangleCornerList& triangleCorners, size_t firstCorner, size_t outlineCount, const int* holeCounts, size_t holeCount )
+		{
+			// The normal of the outline by Newell's method. The polygon is projected on the plane of
+			// the two axes, that are most perpendicular to the normal.
+			double normal[3] = { 0, 0, 0 };
+			double previous[3];
+			if ( !getPosition( firstCorner + outlineCount - 1, previous ) )
+			{
+				addFan( triangleCorners, firstCorner, outlineCount );
+				return;
+			}
+			for ( size_t i = 0; i < outlineCount; ++i )
+			{
+				double current[3];
+				if ( !getPosition( firstCorner + i, current ) )
+				{
+					addFan( triangleCorners, firstCorner, outlineCount );
+					return;
+				}
+				normal[0] += ( previous[1] - current[1] ) * ( previous[2] + current[2] );
+				normal[1] += ( previous[2] - current[2] ) * ( previous[0] + current[0] );
+				normal[2] += ( previous[0] - current[0] ) * ( previous[1] + current[1] );
+				previous[0] = current[0];
+				previous[1] = current[1];
+				previous[2] = current[2];
+			}
+			size_t axisZ = 2;
+			if ( fabs( normal[0] ) > fabs( normal[1] ) && fabs( normal[0] ) > fabs( normal[2] ) )
+				axisZ = 0;
+			else if ( fabs( normal[1] ) > fabs( normal[2] ) )
+				axisZ = 1;
+			if ( normal[axisZ] == 0 )
+			{
+				// all points are on a line
+				addFan( triangleCorners, firstCorner, outlineCount );
+				return;
+			}
+			// choose the axes so the outline is counter clockwise
+			mAxisX = ( axisZ + 1 ) % 3;
+			mAxisY = ( axisZ + 2 ) % 3;
+			if ( normal[axisZ] < 0 )
+				std::swap( mAxisX, mAxisY );
+
+			mPoints.clear();
+			addPoints( firstCorner, outlineCount );
+
+			if ( holeCount == 0 )
+			{
+				// convex polygons are split into a fan
+				bool convex = true;
+				for ( size_t i = 0; i < outlineCount && convex; ++i )
+					convex = cross( mPoints[( i + outlineCount - 1 ) % outlineCount], mPoints[i], mPoints[( i + 1 ) % outlineCount] ) >= 0;
+				if ( convex )
+				{
+					addFan( triangleCorners, firstCorner, outlineCount );
+					return;
+				}
+			}
+
+			mRing.resize( outlineCount );
+			for ( size_t i = 0; i < outlineCount; ++i )
+				mRing[i] = i;
+
+			// holes must be clockwise, they are connected from right to left
+			mHoles.clear();
+			size_t holeCorner = firstCorner + outlineCount;
+			for ( size_t i = 0; i < holeCount; ++i )
+			{
+				Hole hole;
+				hole.firstPoint = mPoints.size();
+				hole.pointCount = (size_t)-holeCounts[i];
+				if ( !addPoints( holeCorner, hole.pointCount ) )
+				{
+					addFan( triangleCorners, firstCorner, outlineCount );
+					return;
+				}
+				holeCorner += hole.pointCount;
+
+				double area = 0;
+				hole.rightmostPoint = hole.firstPoint;
+				for ( size_t j = 0; j < hole.pointCount; ++j )
+				{
+					const Point& point = mPoints[hole.firstPoint + j];
+					const Point& next = mPoints[hole.firstPoint + ( j + 1 ) % hole.pointCount];
+					area += point.x * next.y - next.x * point.y;
+					if ( point.x > mPoints[hole.rightmostPoint].x )
+						hole.rightmostPoint = hole.firstPoint + j;
+				}
+				if ( area > 0 )
+					std::reverse( mPoints.begin() + hole.firstPoint, mPoints.begin() + hole.firstPoint + hole.pointCount );
+				// the rightmost point might have moved
+				hole.rightmostPoint = hole.firstPoint;
+				for ( size_t j = 1; j < hole.pointCount; ++j )
+				{
+					if ( mPoints[hole.firstPoint + j].x > mPoints[hole.rightmostPoint].x )
+						hole.rightmostPoint = hole.firstPoint + j;
+				}
+				hole.rightmostX = mPoints[hole.rightmostPoint].x;
+				mHoles.push_back( hole );
+			}
+			std::sort( mHoles.begin(), mHoles.end() );
+			for ( size_t i = 0; i < mHoles.size(); ++i )
+				connectHole( mHoles[i] );
+
+			clipEars( triangleCorners );
+		}
+
+		//------------------------------
+		bool EarClipper::connectHole( const Hole& hole )
+		{
+			// Cast a ray from the rightmost point of the hole in +x direction and find the closest
+			// edge of the ring it hits. The endpoint of that edge with the larger x coordinate is
+			// visible from the hole, unless a reflex point of the ring lies in the triangle between
+			// the hole point, the hit point and that endpoint. Then the reflex point with the
+			// smallest angle to the ray is visible.
+			const Point& m = mPoints[hole.rightmostPoint];
+			const size_t ringSize = mRing.size();
+			double hitX = HUGE_VAL;
+			size_t visible = ringSize;
+			for ( size_t i = 0; i < ringSize; ++i )
+			{
+				const Point& a = mPoints[mRing[i]];
+				const Point& b = mPoints[mRing[( i + 1 ) % ringSize]];
+				if ( ( a.y > m.y && b.y > m.y ) || ( a.y < m.y && b.y < m.y ) )
+					continue;
+				double x;
+				if ( a.y == b.y )
+					x = std::min( a.x, b.x );
+				else
+					x = a.x + ( m.y - a.y ) * ( b.x - a.x ) / ( b.y - a.y );
+				if ( x < m.x || x >= hitX )
+					continue;
+				hitX = x;
+				visible = a.x > b.x ? i : ( i + 1 ) % ringSize;
+			}
+			if ( visible == ringSize )
+				return false;
+
+			Point hit;
+			hit.x = hitX;
+			hit.y = m.y;
+			const Point& p = mPoints[mRing[visible]];
+			if ( p.x != hitX || p.y != m.y )
+			{
+				double bestTangent = HUGE_VAL;
+				for ( size_t i = 0; i < ringSize; ++i )
+				{
+					const Point& r = mPoints[mRing[i]];
+					if ( i == visible || !isInside( r, m, hit, p ) )
+						continue;
+					bool reflex = cross( mPoints[mRing[( i + ringSize - 1 ) % ringSize]], r, mPoints[mRing[( i + 1 ) % ringSize]] ) <= 0;
+					if ( !reflex )
+						continue;
+					double tangent = fabs( r.y - m.y ) / ( r.x - m.x );
+					if ( tangent < bestTangent )
+					{
+						bestTangent = tangent;
+						visible = i;
+					}
+				}
+			}
+
+			// Points of connected holes appear twice in the ring. The hole must be connected to the
+			// copy whose corner opens towards it.
+			const size_t visiblePoint = mRing[visible];
+			const Point& v = mPoints[visiblePoint];
+			for ( size_t i = 0; i < ringSize; ++i )
+			{
+				if ( mRing[i] != visiblePoint )
+					continue;
+				const Point& previous = mPoints[mRing[( i + ringSize - 1 ) % ringSize]];
+				const Point& next = mPoints[mRing[( i + 1 ) % ringSize]];
+				const bool leftOfPrevious = cross( previous, v, m ) >= 0;
+				const bool leftOfNext = cross( v, next, m ) >= 0;
+				const bool convex = cross( previous, v, next ) > 0;
+				if ( convex ? ( leftOfPrevious && leftOfNext ) : ( leftOfPrevious || leftOfNext ) )
+				{
+					visible = i;
+					break;
+				}
+			}
+
+			// ring ... visible, hole from m around back to m, visible ...
+			std::vector<size_t> bridge;
+			bridge.reserve( hole.pointCount + 2 );
+			size_t offset = hole.rightmostPoint - hole.firstPoint;
+			for ( size_t i = 0; i <= hole.pointCount; ++i )
+				bridge.push_back( hole.firstPoint + ( offset + i ) % hole.pointCount );
+			bridge.push_back( visiblePoint );
+			mRing.insert( mRing.begin() + visible + 1, bridge.begin(), bridge.end() );
+			return true;
+		}
+
+		//------------------------------
+		void EarClipper::clipEars( TriangleCornerList& triangleCorners )
+		{
+			const size_t ringSize = mRing.size();
+			mPrevious.resize( ringSize );
+			mNext.resize( ringSize );
+			for ( size_t i = 0; i < ringSize; ++i )
+			{
+				mPrevious[i] = ( i + ringSize - 1 ) % ringSize;
+				mNext[i] = ( i + 1 ) % ringSize;
+			}
+
+			size_t remaining = ringSize;
+			size_t element = 0;
+			// the number of elements tested since the last ear was cut off
+			size_t tested = 0;
+			while ( remaining > 3 )
+			{
+				const size_t previous = mPrevious[element];
+				const size_t next = mNext[element];
+				bool ear = cross( mPoints[mRing[previous]], mPoints[mRing[element]], mPoints[mRing[next]] ) >= 0;
+				if ( ear )
+				{
+					const Point& a = mPoints[mRing[previous]];
+					const Point& b = mPoints[mRing[element]];
+					const Point& c = mPoints[mRing[next]];
+					// only reflex points can lie in a convex corner without an edge crossing it
+					for ( size_t other = mNext[next]; other != previous && ear; other = mNext[other] )
+					{
+						const Point& point = mPoints[mRing[other]];
+						// connected holes repeat points
+						if ( isSamePoint( point, a ) || isSamePoint( point, b ) || isSamePoint( point, c ) || isConvex( other ) )
+							continue;
+						ear = !isInsideOrOnEdge( point, a, b, c );
+					}
+				}
+				// if there is no ear, the polygon intersects itself. Cut off any corner to finish.
+				if ( ear || tested >= remaining )
+				{
+					addTriangle( triangleCorners, mPoints[mRing[previous]].corner, mPoints[mRing[element]].corner, mPoints[mRing[next]].corner );
+					mNext[previous] = next;
+					mPrevious[next] = previous;
+					--remaining;
+					tested = 0;
+					element = previous;
+				}
+				else
+				{
+					++tested;
+					element = next;
+				}
+			}
+			addTriangle( triangleCorners, mPoints[mRing[mPrevious[element]]].corner, mPoints[mRing[element]].corner, mPoints[mRing[mNext[element]]].corner );
+		}
+
+
+		//------------------------------
+		/** Returns the number of triangles of a primitive with the face vertex counts @a vertexCounts.*/
+		size_t countTriangles( const ArrayPrimitiveType<int>& vertexCounts )
+		{
+			size_t triangleCount = 0;
+			for ( size_t i = 0, count = vertexCounts.getCount(); i < count; ++i )
+			{
+				// each hole adds two triangles, because it is connected by two edges
+				if ( vertexCounts[i] < 0 )
+					triangleCount += 2 + (size_t)-vertexCounts[i];
+				else if ( vertexCounts[i] > 2 )
+					triangleCount += (size_t)vertexCounts[i] - 2;
+			}
+			return triangleCount;
+		}
+
+		//------------------------------
+		/** Returns the number of triangles of a primitive with the strip or fan vertex counts @a vertexCounts.*/
+		size_t countTriangles( const ArrayPrimitiveType<unsigned int>& vertexCounts )
+		{
+			size_t triangleCount = 0;
+			for ( size_t i = 0, count = vertexCounts.getCount(); i < count; ++i )
+			{
+				if ( vertexCounts[i] > 2 )
+					triangleCount += vertexCounts[i] - 2;
+			}
+			return triangleCount;
+		}
+
+		//------------------------------
+		void triangulatePolygons( const Mesh& mesh, const MeshPrimitive& primitive, Triangulator::Method method, TriangleCornerList& triangleCorners )
+		{
+			typedef MeshPrimitiveWithFaceVertexCount<int> PolygonsPrimitive;
+			const PolygonsPrimitive::VertexCountArray& vertexCounts = ((const PolygonsPrimitive&)primitive).getGroupedVerticesVertexCountArray();
+			const size_t cornerCount = primitive.getPositionIndexArray().getCount();
+			triangleCorners.reserve( 3 * countTriangles( vertexCounts ) );
+
+			EarClipper earClipper( mesh, primitive );
+			const bool canClipEars = earClipper.hasPositions( cornerCount );
+			const int* counts = vertexCounts.getData();
+			const size_t faceCount = vertexCounts.getCount();
+			size_t corner = 0;
+			for ( size_t i = 0; i < faceCount; )
+			{
+				const size_t outlineCount = counts[i] > 0 ? (size_t)counts[i] : (size_t)-counts[i];
+				size_t holeCount = 0;
+				size_t holeCornerCount = 0;
+				if ( counts[i] > 0 )
+				{
+					while ( i + 1 + holeCount < faceCount && counts[i + 1 + holeCount] < 0 )
+					{
+						holeCornerCount += (size_t)-counts[i + 1 + holeCount];
+						++holeCount;
+					}
+				}
+				if ( corner + outlineCount + holeCornerCount > cornerCount )
+					break;
+
+				if ( counts[i] > 0 && outlineCount > 2 )
+				{
+					if ( outlineCount == 3 && holeCount == 0 )
+						addTriangle( triangleCorners, corner, corner + 1, corner + 2 );
+					else if ( canClipEars && ( holeCount > 0 || method == Triangulator::EAR_CLIPPING ) )
+						earClipper.triangulate( triangleCorners, corner, outlineCount, counts + i + 1, holeCount );
+					else
+						addFan( triangleCorners, corner, outlineCount );
+				}
+				corner += outlineCount + holeCornerCount;
+				i += 1 + holeCount;
+			}
+		}
+
+		//------------------------------
+		void triangulateStrips( const MeshPrimitive& primitive, TriangleCornerList& triangleCorners )
+		{
+			typedef MeshPrimitiveWithFaceVertexCount<unsigned int> StripsPrimitive;
+			const StripsPrimitive::VertexCountArray& vertexCounts = ((const StripsPrimitive&)primitive).getGroupedVerticesVertexCountArray();
+			const IndexArray& positionIndices = primitive.getPositionIndexArray();
+			const size_t cornerCount = positionIndices.getCount();
+			triangleCorners.reserve( 3 * countTriangles( vertexCounts ) );
+
+			size_t corner = 0;
+			for ( size_t i = 0, count = vertexCounts.getCount(); i < count; ++i )
+			{
+				const size_t stripCount = vertexCounts[i];
+				if ( corner + stripCount > cornerCount )
+					break;
+				for ( size_t j = 2; j < stripCount; ++j )
+				{
+					size_t corner0 = corner + j - 2;
+					size_t corner1 = corner + j - 1;
+					size_t corner2 = corner + j;
+					if ( positionIndices[corner0] == positionIndices[corner1] || positionIndices[corner1] == positionIndices[corner2] || positionIndices[corner0] == positionIndices[corner2] )
+						continue;
+					// every second triangle is flipped to keep the winding of the first
+					if ( j % 2 == 0 )
+						addTriangle( triangleCorners, corner0, corner1, corner2 );
+					else
+						addTriangle( triangleCorners, corner1, corner0, corner2 );
+				}
+				corner += stripCount;
+			}
+		}
+
+		//------------------------------
+		void triangulateFans( const MeshPrimitive& primitive, TriangleCornerList& triangleCorners )
+		{
+			typedef MeshPrimitiveWithFaceVertexCount<unsigned int> FansPrimitive;
+			const FansPrimitive::VertexCountArray& vertexCounts = ((const FansPrimitive&)primitive).getGroupedVerticesVertexCountArray();
+			const size_t cornerCount = primitive.getPositionIndexArray().getCount();
+			triangleCorners.reserve( 3 * countTriangles( vertexCounts ) );
+
+			size_t corner = 0;
+			for ( size_t i = 0, count = vertexCounts.getCount(); i < count; ++i )
+			{
+				const size_t fanCount = vertexCounts[i];
+				if ( corner + fanCount > cornerCount )
+					break;
+				addFan( triangleCorners, corner, fanCount );
+				corner += fanCount;
+			}
+		}
+	}
+
+
+	/** Triangulates a primitive of a triangulator per iteration of a parallelFor().*/
+	class Triangulator::TriangulateBody : public COLLADABU::ParallelForBody
+	{
+	private:
+		/** The triangulator whose primitives are triangulated.*/
+		Triangulator& mTriangulator;
+
+	public:
+		TriangulateBody( Triangulator& triangulator ) : mTriangulator( triangulator ) {}
+
+		virtual void process( size_t primitiveIndex )
+		{
+			triangulatePrimitive( mTriangulator.mMesh, *mTriangulator.mMesh.getMeshPrimitives()[primitiveIndex], mTriangulator.mMethod, mTriangulator.mTriangleCorners[primitiveIndex] );
+		}
+
+	private:
+
+        /** Disable default copy ctor. */
+		TriangulateBody( const TriangulateBody& pre );
+
+        /** Disable default assignment operator. */
+		const TriangulateBody& operator= ( const TriangulateBody& pre );
+	};
+
+
+	//------------------------------
+	Triangulator::Triangulator( const Mesh& mesh, Method method )
+		: mMesh( mesh )
+		, mMethod( method )
+	{
+	}
+
+	//------------------------------
+	Triangulator::~Triangulator()
+	{
+	}
+
+	//------------------------------
+	void Triangulator::triangulate( size_t threadCount )
+	{
+		const size_t primitiveCount = mMesh.getMeshPrimitives().getCount();
+		mTriangleCorners.clear();
+		mTriangleCorners.resize( primitiveCount );
+
+		// the primitives are triangulated independently, so all threads share one body
+		TriangulateBody body( *this );
+		COLLADABU::parallelFor( primitiveCount, std::vector<COLLADABU::ParallelForBody*>( std::max<size_t>( threadCount, 1 ), &body ) );
+	}
+
+	//------------------------------
+	void Triangulator::triangulatePrimitive( const Mesh& mesh, const MeshPrimitive& primitive, Method method, TriangleCornerList& triangleCorners )
+	{
+		triangleCorners.clear();
+		switch ( primitive.getPrimitiveType() )
+		{
+		case MeshPrimitive::TRIANGLES:
+			{
+				const size_t cornerCount = primitive.getPositionIndexArray().getCount() / 3 * 3;
+				triangleCorners.resize( cornerCount );
+				for ( size_t i = 0; i < cornerCount; ++i )
+					triangleCorners[i] = (unsigned int)i;
+			}
+			break;
+		case MeshPrimitive::POLYGONS:
+		case MeshPrimitive::POLYLIST:
+			triangulatePolygons( mesh, primitive, method, triangleCorners );
+			break;
+		case MeshPrimitive::TRIANGLE_STRIPS:
+			triangulateStrips( primitive, triangleCorners );
+			break;
+		case MeshPrimitive::TRIANGLE_FANS:
+			triangulateFans( primitive, triangleCorners );
+			break;
+		case MeshPrimitive::LINES:
+		case MeshPrimitive::LINE_STRIPS:
+		case MeshPrimitive::POINTS:
+		case MeshPrimitive::UNDEFINED_PRIMITIVE_TYPE:
+		default:
+			break;
+		}
+	}
+
+} // namespace COLLADAFW
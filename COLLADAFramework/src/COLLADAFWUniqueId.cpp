@@ -14,6 +14,7 @@ http://www.opensource.org/licenses/mit-license.php
 namespace COLLADAFW
 {
 	static const String UNIQUEID = "UniqueID";
+	static const size_t UNIQUEID_LENGTH = UNIQUEID.length();
 	
 	const UniqueId UniqueId::INVALID = UniqueId();
 
@@ -53,7 +54,6 @@ namespace COLLADAFW
 	//-------------------------------
 	bool UniqueId::fromAscii_intern( const String& ascii )
 	{
-		static const size_t UNIQUEID_LENGTH = UNIQUEID.length();
 		static const char digits[] = "0123456789";
 
 		// sample: UniqueId(1,4)
@@ -159,13 +159,15 @@ namespace COLLADAFW
 	//------------------------------
 	UniqueId::operator size_t() const
 	{
-		size_t retVal = 2166136261U;
-		const char* p = (const char*)this;
-		for ( size_t i = 0; i < sizeof(UniqueId); ++i)
-		{
-			retVal = 16777619U * retVal ^ (size_t)(*p++);
-		}
-		return retVal;
+		// Combine the members into one 64 bit key and mix its bits. The members are used explicitly, 
+		// since the padding bytes between them are not initialized.
+		ObjectId key = mObjectId ^ ((ObjectId)mClassId << 56) ^ ((ObjectId)mFileId << 40);
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdULL;
+		key ^= key >> 33;
+		key *= 0xc4ceb9fe1a85ec53ULL;
+		key ^= key >> 33;
+		return (size_t)key;
 	}
 
 } // namespace COLLADAFW
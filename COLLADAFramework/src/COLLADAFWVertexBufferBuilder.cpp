@@ -0,0 +1,337 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWVertexBufferBuilder.h"
+#include "COLLADAFWMesh.h"
+
+#include "COLLADABUThread.h"
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** Marks an empty slot of the hash table.*/
+		const unsigned int EMPTY_SLOT = 0xFFFFFFFF;
+
+		/** The values and indices of one attribute of a primitive.*/
+		struct AttributeSource
+		{
+			/** The values, if they are floats, 0 otherwise.*/
+			const float* floatValues;
+
+			/** The values, if they are doubles, 0 otherwise.*/
+			const double* doubleValues;
+
+			/** The values, if they are quantized, 0 otherwise.*/
+			const QuantizedArray* quantizedValues;
+
+			/** The number of values.*/
+			size_t valuesCount;
+
+			/** The number of values per index.*/
+			size_t stride;
+
+			/** The index of each corner of the primitive.*/
+			const IndexArray* indices;
+
+			/** Where the attribute is stored in the vertex buffer.*/
+			VertexBuffer::Attribute attribute;
+		};
+
+		typedef std::vector<AttributeSource> AttributeSourceList;
+
+
+		//------------------------------
+		/** Adds an attribute for @a indices, if there are values and an index for each corner.*/
+		void addAttributeSource(
+			AttributeSourceList& sources,
+			const MeshVertexData& values,
+			const IndexArray& indices,
+			size_t stride,
+			size_t cornerCount,
+			VertexBuffer::Semantic semantic,
+			size_t setIndex )
+		{
+			if ( stride == 0 || indices.getCount() != cornerCount || cornerCount == 0 )
+				return;
+
+			AttributeSource source;
+			source.floatValues = 0;
+			source.doubleValues = 0;
+			source.quantizedValues = 0;
+			if ( values.getType() == MeshVertexData::DATA_TYPE_FLOAT )
+				source.floatValues = values.getFloatValues()->getData();
+			else if ( values.getType() == MeshVertexData::DATA_TYPE_DOUBLE )
+				source.doubleValues = values.getDoubleValues()->getData();
+			else if ( values.getType() == MeshVertexData::DATA_TYPE_QUANTIZED )
+				source.quantizedValues = values.getQuantizedValues();
+			else
+				return;
+			source.valuesCount = values.getValuesCount();
+			source.stride = stride;
+			source.indices = &indices;
+			source.attribute.semantic = semantic;
+			source.attribute.setIndex = setIndex;
+			source.attribute.componentCount = stride;
+			source.attribute.offset = 0;
+			sources.push_back( source );
+		}
+
+		//------------------------------
+		/** Combines the indices of all attributes of @a corner to a hash value.*/
+		inline unsigned int hashCorner( const AttributeSourceList& sources, size_t corner )
+		{
+			unsigned int hash = 0;
+			for ( size_t i = 0, count = sources.size(); i < count; ++i )
+			{
+				hash = ( hash ^ (*sources[i].indices)[corner] ) * 0x9E3779B1u;
+				hash ^= hash >> 15;
+			}
+			hash ^= hash >> 16;
+			hash *= 0x85EBCA6Bu;
+			hash ^= hash >> 13;
+			return hash;
+		}
+
+		//------------------------------
+		/** Returns true, if all attributes of the corners @a corner1 and @a corner2 have the same indices.*/
+		inline bool equalCorners( const AttributeSourceList& sources, size_t corner1, size_t corner2 )
+		{
+			for ( size_t i = 0, count = sources.size(); i < count; ++i )
+			{
+				if ( (*sources[i].indices)[corner1] != (*sources[i].indices)[corner2] )
+					return false;
+			}
+			return true;
+		}
+
+		//------------------------------
+		template<class T>
+		void copyAttribute( const AttributeSource& source, const T* values, const std::vector<unsigned int>& vertexCorners, float* destination, size_t vertexStride )
+		{
+			const size_t componentCount = source.attribute.componentCount;
+			for ( size_t vertex = 0, vertexCount = vertexCorners.size(); vertex < vertexCount; ++vertex, destination += vertexStride )
+			{
+				size_t valueIndex = (size_t)(*source.indices)[vertexCorners[vertex]] * source.stride;
+				// out of range values stay zero
+				if ( valueIndex + componentCount > source.valuesCount )
+					continue;
+				for ( size_t i = 0; i < componentCount; ++i )
+					destination[i] = (float)values[valueIndex + i];
+			}
+		}
+
+		//------------------------------
+		void copyAttribute( const AttributeSource& source, const QuantizedArray& values, const std::vector<unsigned int>& vertexCorners, float* destination, size_t vertexStride )
+		{
+			const size_t componentCount = source.attribute.componentCount;
+			for ( size_t vertex = 0, vertexCount = vertexCorners.size(); vertex < vertexCount; ++vertex, destination += vertexStride )
+			{
+				size_t valueIndex = (size_t)(*source.indices)[vertexCorners[vertex]] * source.stride;
+				// out of range values stay zero
+				if ( valueIndex + componentCount > source.valuesCount )
+					continue;
+				values.decode( valueIndex, componentCount, destination );
+			}
+		}
+	}
+
+
+	/** Builds the buffer of a primitive of a builder per iteration of a parallelFor().*/
+	class VertexBufferBuilder::BuildBody : public COLLADABU::ParallelForBody
+	{
+	private:
+		/** The builder whose buffers are built.*/
+		VertexBufferBuilder& mBuilder;
+
+	public:
+		BuildBody( VertexBufferBuilder& builder ) : mBuilder( builder ) {}
+
+		virtual void process( size_t primitiveIndex )
+		{
+			buildVertexBuffer( mBuilder.mMesh, *mBuilder.mMesh.getMeshPrimitives()[primitiveIndex], mBuilder.mLayout, *mBuilder.mVertexBuffers[primitiveIndex] );
+		}
+
+	private:
+
+        /** Disable default copy ctor. */
+		BuildBody( const BuildBody& pre );
+
+        /** Disable default assignment operator. */
+		const BuildBody& operator= ( const BuildBody& pre );
+	};
+
+
+	//------------------------------
+	VertexBuffer::VertexBuffer()
+		: mPrimitiveType( MeshPrimitive::UNDEFINED_PRIMITIVE_TYPE )
+		, mMaterialId( 0 )
+		, mLayout( INTERLEAVED )
+		, mVertexSize( 0 )
+		, mVertexCount( 0 )
+	{
+	}
+
+	//------------------------------
+	const VertexBuffer::Attribute* VertexBuffer::findAttribute( Semantic semantic, size_t setIndex ) const
+	{
+		for ( size_t i = 0, count = mAttributes.size(); i < count; ++i )
+		{
+			const Attribute& attribute = mAttributes[i];
+			if ( attribute.semantic == semantic && attribute.setIndex == setIndex )
+				return &attribute;
+		}
+		return 0;
+	}
+
+	//------------------------------
+	VertexBufferBuilder::VertexBufferBuilder( const Mesh& mesh, VertexBuffer::Layout layout )
+		: mMesh( mesh )
+		, mLayout( layout )
+	{
+	}
+
+	//------------------------------
+	VertexBufferBuilder::~VertexBufferBuilder()
+	{
+		clear();
+	}
+
+	//------------------------------
+	void VertexBufferBuilder::clear()
+	{
+		for ( size_t i = 0, count = mVertexBuffers.size(); i < count; ++i )
+			FW_DELETE mVertexBuffers[i];
+		mVertexBuffers.clear();
+	}
+
+	//------------------------------
+	void VertexBufferBuilder::build( size_t threadCount )
+	{
+		clear();
+
+		const size_t primitiveCount = mMesh.getMeshPrimitives().getCount();
+		mVertexBuffers.reserve( primitiveCount );
+		for ( size_t i = 0; i < primitiveCount; ++i )
+			mVertexBuffers.push_back( FW_NEW VertexBuffer() );
+
+		// the buffers are built independently, so all threads share one body
+		BuildBody body( *this );
+		COLLADABU::parallelFor( primitiveCount, std::vector<COLLADABU::ParallelForBody*>( std::max<size_t>( threadCount, 1 ), &body ) );
+	}
+
+	//------------------------------
+	void VertexBufferBuilder::buildVertexBuffer( const Mesh& mesh, const MeshPrimitive& primitive, VertexBuffer::Layout layout, VertexBuffer& vertexBuffer )
+	{
+		vertexBuffer = VertexBuffer();
+		vertexBuffer.mPrimitiveType = primitive.getPrimitiveType();
+		vertexBuffer.mMaterialId = primitive.getMaterialId();
+		vertexBuffer.mLayout = layout;
+
+		const size_t cornerCount = primitive.getPositionIndexArray().getCount();
+		if ( cornerCount == 0 || cornerCount >= EMPTY_SLOT )
+			return;
+
+		AttributeSourceList sources;
+		addAttributeSource( sources, mesh.getPositions(), primitive.getPositionIndexArray(), 3, cornerCount, VertexBuffer::POSITION, 0 );
+		addAttributeSource( sources, mesh.getNormals(), primitive.getNormalIndexArray(), 3, cornerCount, VertexBuffer::NORMAL, 0 );
+		addAttributeSource( sources, mesh.getTangents(), primitive.getTangentIndexArray(), 3, cornerCount, VertexBuffer::TANGENT, 0 );
+		addAttributeSource( sources, mesh.getBinormals(), primitive.getBinormalIndexArray(), 3, cornerCount, VertexBuffer::BINORMAL, 0 );
+		const IndexListArray& colorIndicesArray = primitive.getColorIndicesArray();
+		for ( size_t i = 0, count = colorIndicesArray.getCount(); i < count; ++i )
+		{
+			const IndexList& indexList = *colorIndicesArray[i];
+			addAttributeSource( sources, mesh.getColors(), indexList.getIndexArray(), indexList.getStride(), cornerCount, VertexBuffer::COLOR, indexList.getSetIndex() );
+		}
+		const IndexListArray& uvCoordIndicesArray = primitive.getUVCoordIndicesArray();
+		for ( size_t i = 0, count = uvCoordIndicesArray.getCount(); i < count; ++i )
+		{
+			const IndexList& indexList = *uvCoordIndicesArray[i];
+			addAttributeSource( sources, mesh.getUVCoords(), indexList.getIndexArray(), indexList.getStride(), cornerCount, VertexBuffer::TEXCOORD, indexList.getSetIndex() );
+		}
+		if ( sources.empty() )
+			return;
+
+		// Merge identical index combinations. The table is at least twice as large as the number
+		// of corners, so the probe sequences stay short. Each vertex remembers its first corner,
+		// whose indices are compared with the indices of the following corners.
+		size_t tableSize = 16;
+		while ( tableSize < 2 * cornerCount )
+			tableSize *= 2;
+		const size_t tableMask = tableSize - 1;
+		std::vector<unsigned int> table( tableSize, EMPTY_SLOT );
+
+		std::vector<unsigned int> vertexCorners;
+		std::vector<unsigned int>& indices = vertexBuffer.mIndices32;
+		indices.resize( cornerCount );
+		for ( size_t corner = 0; corner < cornerCount; ++corner )
+		{
+			size_t slot = hashCorner( sources, corner ) & tableMask;
+			for ( ;; )
+			{
+				unsigned int vertex = table[slot];
+				if ( vertex == EMPTY_SLOT )
+				{
+					vertex = (unsigned int)vertexCorners.size();
+					table[slot] = vertex;
+					vertexCorners.push_back( (unsigned int)corner );
+					indices[corner] = vertex;
+					break;
+				}
+				if ( equalCorners( sources, vertexCorners[vertex], corner ) )
+				{
+					indices[corner] = vertex;
+					break;
+				}
+				slot = ( slot + 1 ) & tableMask;
+			}
+		}
+		std::vector<unsigned int>().swap( table );
+
+		const size_t vertexCount = vertexCorners.size();
+		if ( vertexCount < 0xFFFF )
+		{
+			vertexBuffer.mIndices16.assign( indices.begin(), indices.end() );
+			std::vector<unsigned int>().swap( indices );
+		}
+
+		// lay out the attributes and copy their values
+		size_t vertexSize = 0;
+		for ( size_t i = 0, count = sources.size(); i < count; ++i )
+		{
+			VertexBuffer::Attribute& attribute = sources[i].attribute;
+			attribute.offset = layout == VertexBuffer::INTERLEAVED ? vertexSize : vertexSize * vertexCount;
+			vertexSize += attribute.componentCount;
+			vertexBuffer.mAttributes.push_back( attribute );
+		}
+		vertexBuffer.mVertexSize = vertexSize;
+		vertexBuffer.mVertexCount = vertexCount;
+		vertexBuffer.mVertices.resize( vertexSize * vertexCount, 0.0f );
+
+		float* vertices = &vertexBuffer.mVertices[0];
+		for ( size_t i = 0, count = sources.size(); i < count; ++i )
+		{
+			const AttributeSource& source = sources[i];
+			const VertexBuffer::Attribute& attribute = source.attribute;
+			float* destination = vertices + attribute.offset;
+			size_t vertexStride = layout == VertexBuffer::INTERLEAVED ? vertexSize : attribute.componentCount;
+			if ( source.floatValues )
+				copyAttribute( source, source.floatValues, vertexCorners, destination, vertexStride );
+			else if ( source.quantizedValues )
+				copyAttribute( source, *source.quantizedValues, vertexCorners, destination, vertexStride );
+			else
+				copyAttribute( source, source.doubleValues, vertexCorners, destination, vertexStride );
+		}
+	}
+
+} // namespace COLLADAFW
@@ -0,0 +1,20 @@
+
+# Builds the index array test. LIBDIR must point to the directory that contains the static
+# libraries of a regular build of OpenCOLLADA.
+# run: ./indexArrayTest
+
+LIBDIR=${LIBDIR:-../../../build/lib}
+
+OPTIONS="-O2 -Wall -pthread"
+
+INCLUDES="-I../../include -I../../../common/test/include -I../../../COLLADABaseUtils/include -I../../../COLLADABaseUtils/include/Math -I../../../Externals/MathMLSolver/include -I../../../Externals/MathMLSolver/include/AST"
+
+FILES="main.cpp"
+
+LIBS="-L$LIBDIR -lOpenCOLLADAFramework -lMathMLSolver -lOpenCOLLADABaseUtils -lUTF -lftoa"
+
+OUTPUTFILE="-o indexArrayTest"
+
+
+
+g++ $OPTIONS $INCLUDES $FILES $LIBS $OUTPUTFILE
@@ -0,0 +1,319 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Checks COLLADAFW::IndexArray. Indices are appended after setWidth() with each width, including
+    indices that do not fit and make append() fall back to 32 bits. 32 bit indices are packed with
+    pack() and moved back with unpack(), also with indices larger than the value count and with
+    external data. The const_iterator is compared against operator[] for each width. Finally the
+    32 bit accessors of IndexList and MeshPrimitive are checked for 32 bit and packed indices.
+
+    usage: indexArrayTest
+*/
+
+#include "COLLADAFW.h"
+
+#include "CommonTestCheck.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+
+namespace
+{
+	typedef std::vector<unsigned int> Indices;
+
+	//------------------------------
+	/** Returns @a count indices, that cycle through 0..@a maxIndex.*/
+	Indices getIndices( size_t count, unsigned int maxIndex )
+	{
+		Indices indices( count );
+		for ( size_t i = 0; i < count; ++i )
+			indices[i] = (unsigned int)( ( i * 7 ) % ( (size_t)maxIndex + 1 ) );
+		if ( count > 0 )
+			indices[count - 1] = maxIndex;
+		return indices;
+	}
+
+	//------------------------------
+	/** Returns true, if @a indexArray contains @a expected, read with operator[].*/
+	bool isEqual( const COLLADAFW::IndexArray& indexArray, const Indices& expected )
+	{
+		if ( indexArray.getCount() != expected.size() )
+			return false;
+		for ( size_t i = 0; i < expected.size(); ++i )
+		{
+			if ( indexArray[i] != expected[i] )
+				return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	/** Returns true, if @a indices contains @a expected.*/
+	bool isEqual( const COLLADAFW::UIntValuesArray& indices, const Indices& expected )
+	{
+		return indices.getCount() == expected.size()
+			&& std::equal( expected.begin(), expected.end(), indices.getData() );
+	}
+
+	//------------------------------
+	/** Fills @a indexArray with @a indices, stored with 32 bits.*/
+	void assign( COLLADAFW::IndexArray& indexArray, const Indices& indices )
+	{
+		COLLADAFW::UIntValuesArray values;
+		values.setData( const_cast<unsigned int*>( &indices[0] ), indices.size() );
+		indexArray.assign( values );
+		values.setData( 0, 0 );
+	}
+
+	//------------------------------
+	void checkWidthForValueCount()
+	{
+		CHECK( COLLADAFW::IndexArray::getWidthForValueCount( 0 ) == COLLADAFW::IndexArray::WIDTH_8 );
+		CHECK( COLLADAFW::IndexArray::getWidthForValueCount( 0x100 ) == COLLADAFW::IndexArray::WIDTH_8 );
+		CHECK( COLLADAFW::IndexArray::getWidthForValueCount( 0x101 ) == COLLADAFW::IndexArray::WIDTH_16 );
+		CHECK( COLLADAFW::IndexArray::getWidthForValueCount( 0x10000 ) == COLLADAFW::IndexArray::WIDTH_16 );
+		CHECK( COLLADAFW::IndexArray::getWidthForValueCount( 0x10001 ) == COLLADAFW::IndexArray::WIDTH_32 );
+	}
+
+	//------------------------------
+	/** Appends indices up to @a maxIndex after setWidth( @a width ), then one that does not fit.*/
+	void checkAppend( COLLADAFW::IndexArray::Width width, unsigned int maxIndex )
+	{
+		COLLADAFW::IndexArray indexArray;
+		CHECK( indexArray.getWidth() == COLLADAFW::IndexArray::WIDTH_32 );
+		indexArray.setWidth( width );
+		indexArray.reserve( 1000 );
+		CHECK( indexArray.getWidth() == width );
+		CHECK( indexArray.empty() );
+		CHECK( indexArray.getMemorySize() == 1000 * (size_t)width );
+
+		Indices indices = getIndices( 1000, maxIndex );
+		for ( size_t i = 0; i < indices.size(); ++i )
+			indexArray.append( indices[i] );
+		CHECK( indexArray.getWidth() == width );
+		CHECK( isEqual( indexArray, indices ) );
+		CHECK( ( indexArray.getIndices8() != 0 ) == ( width == COLLADAFW::IndexArray::WIDTH_8 ) );
+		CHECK( ( indexArray.getIndices16() != 0 ) == ( width == COLLADAFW::IndexArray::WIDTH_16 ) );
+
+		indexArray.erase( 10 );
+		indices.resize( indices.size() - 10 );
+		CHECK( isEqual( indexArray, indices ) );
+
+		// an index that does not fit into the width makes append() fall back to 32 bits
+		if ( width == COLLADAFW::IndexArray::WIDTH_32 )
+			return;
+		indexArray.append( maxIndex + 1 );
+		indices.push_back( maxIndex + 1 );
+		CHECK( indexArray.getWidth() == COLLADAFW::IndexArray::WIDTH_32 );
+		CHECK( indexArray.getIndices8() == 0 );
+		CHECK( indexArray.getIndices16() == 0 );
+		CHECK( isEqual( indexArray, indices ) );
+		CHECK( isEqual( indexArray.getIndices32(), indices ) );
+	}
+
+	//------------------------------
+	/** Packs 32 bit indices up to @a maxIndex for @a valueCount values.*/
+	void checkPack( unsigned int maxIndex, size_t valueCount, COLLADAFW::IndexArray::Width expectedWidth )
+	{
+		const Indices indices = getIndices( 5000, maxIndex );
+		COLLADAFW::IndexArray indexArray;
+		assign( indexArray, indices );
+		CHECK( indexArray.getWidth() == COLLADAFW::IndexArray::WIDTH_32 );
+		CHECK( indexArray.getMemorySize() >= indices.size() * 4 );
+
+		indexArray.pack( valueCount );
+		CHECK( indexArray.getWidth() == expectedWidth );
+		CHECK( indexArray.getMemorySize() == indices.size() * expectedWidth );
+		CHECK( isEqual( indexArray, indices ) );
+
+		// packing again does nothing
+		indexArray.pack( 1 );
+		CHECK( indexArray.getWidth() == expectedWidth );
+		CHECK( isEqual( indexArray, indices ) );
+
+		indexArray.unpack();
+		CHECK( indexArray.getWidth() == COLLADAFW::IndexArray::WIDTH_32 );
+		CHECK( indexArray.getIndices8() == 0 );
+		CHECK( indexArray.getIndices16() == 0 );
+		CHECK( indexArray.getMemorySize() == indices.size() * 4 );
+		CHECK( isEqual( indexArray, indices ) );
+		CHECK( isEqual( indexArray.getIndices32(), indices ) );
+	}
+
+	//------------------------------
+	void checkPackExternalData()
+	{
+		Indices indices = getIndices( 100, 50 );
+		COLLADAFW::IndexArray indexArray;
+		indexArray.getIndices32().setExternalData( &indices[0], indices.size() );
+		indexArray.pack( 51 );
+		CHECK( indexArray.getWidth() == COLLADAFW::IndexArray::WIDTH_32 );
+		CHECK( indexArray.getIndices32().getData() == &indices[0] );
+		CHECK( isEqual( indexArray, indices ) );
+	}
+
+	//------------------------------
+	/** Checks the const_iterator of indices up to @a maxIndex, packed for @a valueCount values.*/
+	void checkIterator( unsigned int maxIndex, size_t valueCount )
+	{
+		const Indices indices = getIndices( 300, maxIndex );
+		COLLADAFW::IndexArray indexArray;
+		assign( indexArray, indices );
+		indexArray.pack( valueCount );
+		const COLLADAFW::IndexArray& constIndexArray = indexArray;
+
+		COLLADAFW::IndexArray::const_iterator begin = constIndexArray.begin();
+		COLLADAFW::IndexArray::const_iterator end = constIndexArray.end();
+		CHECK( end - begin == (std::ptrdiff_t)indices.size() );
+		CHECK( std::distance( begin, end ) == (std::ptrdiff_t)indices.size() );
+		CHECK( std::equal( begin, end, indices.begin() ) );
+		CHECK( Indices( begin, end ) == indices );
+
+		size_t i = 0;
+		for ( COLLADAFW::IndexArray::const_iterator it = begin; it != end; ++it, ++i )
+		{
+			CHECK( *it == indices[i] );
+			CHECK( begin[i] == indices[i] );
+			CHECK( *( begin + i ) == indices[i] );
+		}
+		CHECK( i == indices.size() );
+
+		COLLADAFW::IndexArray::const_iterator it = end;
+		--it;
+		CHECK( *it == indices.back() );
+		CHECK( *it-- == indices.back() );
+		CHECK( *it == indices[indices.size() - 2] );
+		it -= 10;
+		CHECK( *it == indices[indices.size() - 12] );
+		CHECK( *( it - 5 ) == indices[indices.size() - 17] );
+		it += 11;
+		CHECK( it == end - 1 );
+		CHECK( *it++ == indices.back() );
+		CHECK( it == end );
+
+		CHECK( begin < end && begin <= end && end > begin && end >= begin );
+		CHECK( begin <= begin && begin >= begin && !( begin < begin ) && !( begin != begin ) );
+		CHECK( *std::max_element( begin, end ) == maxIndex );
+	}
+
+	//------------------------------
+	void checkSwap()
+	{
+		const Indices indices8 = getIndices( 20, 200 );
+		const Indices indices32 = getIndices( 30, 100000 );
+		COLLADAFW::IndexArray indexArray8;
+		assign( indexArray8, indices8 );
+		indexArray8.pack( 201 );
+		COLLADAFW::IndexArray indexArray32;
+		assign( indexArray32, indices32 );
+
+		indexArray8.swap( indexArray32 );
+		CHECK( indexArray8.getWidth() == COLLADAFW::IndexArray::WIDTH_32 );
+		CHECK( indexArray32.getWidth() == COLLADAFW::IndexArray::WIDTH_8 );
+		CHECK( isEqual( indexArray8, indices32 ) );
+		CHECK( isEqual( indexArray32, indices8 ) );
+	}
+
+	//------------------------------
+	/** Checks the 32 bit accessors of IndexList and MeshPrimitive. The const ones widen packed
+	indices into a copy and keep them packed, the non const ones unpack them.*/
+	void checkUnpackedIndices()
+	{
+		const Indices indices = getIndices( 50, 40 );
+
+		COLLADAFW::IndexList indexList;
+		assign( indexList.getIndexArray(), indices );
+		const COLLADAFW::IndexList& constIndexList = indexList;
+
+		// 32 bit indices are referenced
+		{
+			const COLLADAFW::UIntValuesArray& unpacked = constIndexList.getIndices();
+			CHECK( unpacked.getData() == indexList.getIndices().getData() );
+			CHECK( isEqual( unpacked, indices ) );
+		}
+
+		// packed indices are widened into a copy and stay packed
+		indexList.packIndices( 41 );
+		CHECK( indexList.getIndexArray().getWidth() == COLLADAFW::IndexArray::WIDTH_8 );
+		{
+			const COLLADAFW::UIntValuesArray& widened = constIndexList.getIndices();
+			CHECK( isEqual( widened, indices ) );
+			CHECK( &constIndexList.getIndices() == &widened );
+			CHECK( indexList.getIndexArray().getWidth() == COLLADAFW::IndexArray::WIDTH_8 );
+		}
+
+		// the copy follows appended and erased indices
+		Indices modifiedIndices( indices );
+		indexList.getIndexArray().append( 7 );
+		modifiedIndices.push_back( 7 );
+		CHECK( isEqual( constIndexList.getIndices(), modifiedIndices ) );
+		indexList.getIndexArray().erase( 1 );
+		indexList.getIndexArray().append( 9 );
+		modifiedIndices.back() = 9;
+		CHECK( isEqual( constIndexList.getIndices(), modifiedIndices ) );
+		CHECK( indexList.getIndexArray().getWidth() == COLLADAFW::IndexArray::WIDTH_8 );
+
+		// the non const accessor unpacks the indices
+		CHECK( isEqual( indexList.getIndices(), modifiedIndices ) );
+		CHECK( indexList.getIndexArray().getWidth() == COLLADAFW::IndexArray::WIDTH_32 );
+
+		COLLADAFW::Triangles triangles( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::TRIANGLES, 1, 0 ) );
+		assign( triangles.getPositionIndexArray(), indices );
+		assign( triangles.getNormalIndexArray(), indices );
+		triangles.getNormalIndexArray().pack( 0x1000 );
+		const COLLADAFW::MeshPrimitive& constTriangles = triangles;
+		CHECK( constTriangles.getNormalIndexArray().getWidth() == COLLADAFW::IndexArray::WIDTH_16 );
+
+		const COLLADAFW::UIntValuesArray& positionIndices = constTriangles.getPositionIndices();
+		const COLLADAFW::UIntValuesArray& normalIndices = constTriangles.getNormalIndices();
+		CHECK( isEqual( positionIndices, indices ) );
+		CHECK( isEqual( normalIndices, indices ) );
+		CHECK( constTriangles.getTangentIndices().empty() );
+		CHECK( constTriangles.getBinormalIndices().empty() );
+		CHECK( constTriangles.getNormalIndexArray().getWidth() == COLLADAFW::IndexArray::WIDTH_16 );
+
+		CHECK( isEqual( triangles.getNormalIndices(), indices ) );
+		CHECK( constTriangles.getNormalIndexArray().getWidth() == COLLADAFW::IndexArray::WIDTH_32 );
+	}
+}
+
+
+//--------------------------------------------------------------------
+int main()
+{
+	checkWidthForValueCount();
+
+	checkAppend( COLLADAFW::IndexArray::WIDTH_8, 0xFF );
+	checkAppend( COLLADAFW::IndexArray::WIDTH_16, 0xFFFF );
+	checkAppend( COLLADAFW::IndexArray::WIDTH_32, 0x10000 );
+
+	checkPack( 200, 201, COLLADAFW::IndexArray::WIDTH_8 );
+	checkPack( 40000, 40001, COLLADAFW::IndexArray::WIDTH_16 );
+	checkPack( 100000, 100001, COLLADAFW::IndexArray::WIDTH_32 );
+	// indices larger than the value count choose the width from the largest index
+	checkPack( 300, 10, COLLADAFW::IndexArray::WIDTH_16 );
+	checkPack( 0x10000, 10, COLLADAFW::IndexArray::WIDTH_32 );
+	checkPackExternalData();
+
+	checkIterator( 200, 201 );
+	checkIterator( 40000, 40001 );
+	checkIterator( 100000, 100001 );
+
+	checkSwap();
+	checkUnpackedIndices();
+
+	printf( "%d failed checks\n", (int)Common::Test::failureCount );
+	return Common::Test::failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+
+# Builds the transform hierarchy test twice: transformHierarchyTest with the SSE2 or AVX matrix
+# product the compiler targets, transformHierarchyTestScalar with the scalar one. LIBDIR must
+# point to the directory that contains the static libraries of a regular build of OpenCOLLADA.
+# run: ./transformHierarchyTest [seed] && ./transformHierarchyTestScalar [seed]
+
+LIBDIR=${LIBDIR:-../../../build/lib}
+
+OPTIONS="-O2 -Wall -pthread"
+
+INCLUDES="-I../../include -I../../../common/test/include -I../../../COLLADABaseUtils/include -I../../../COLLADABaseUtils/include/Math -I../../../Externals/MathMLSolver/include -I../../../Externals/MathMLSolver/include/AST"
+
+# the hierarchy is compiled with the test, so the variant does not depend on the library
+FILES="main.cpp ../COLLADAFWTransformHierarchy.cpp"
+
+LIBS="-L$LIBDIR -lOpenCOLLADAFramework -lMathMLSolver -lOpenCOLLADABaseUtils -lUTF -lftoa"
+
+
+
+g++ $OPTIONS $INCLUDES $FILES $LIBS -o transformHierarchyTest
+
+g++ $OPTIONS -DCOLLADAFW_CONCATENATE_SCALAR $INCLUDES $FILES $LIBS -o transformHierarchyTestScalar
@@ -0,0 +1,421 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Checks COLLADAFW::TransformHierarchy against a recursive traversal of the node tree, that
+    concatenates the matrices with COLLADABU::Math::Matrix4. A random visual scene with nested
+    nodes, instance nodes of library nodes and an instance node that instantiates one of its own
+    ancestors is flattened and evaluated. Then the local matrices of nested entries and of all
+    entries of a node are changed, and evaluate() must recalculate exactly their subtrees. The world
+    matrices must be equal to the ones of the traversal.
+    build.sh builds the test twice, once with the SSE2 or AVX matrix product the compiler targets
+    and once with COLLADAFW_CONCATENATE_SCALAR.
+
+    usage: transformHierarchyTest [seed]
+*/
+
+#include "COLLADAFW.h"
+#include "COLLADAFWTransformHierarchy.h"
+
+#include "CommonTestCheck.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+
+namespace
+{
+	typedef std::vector<COLLADABU::Math::Matrix4> MatrixList;
+	typedef std::vector<COLLADAFW::UniqueId> UniqueIdList;
+
+	/** The maximal depth of the generated node trees.*/
+	const size_t MAX_DEPTH = 5;
+
+	/** The state of the random number generator.*/
+	unsigned int randomState = 1;
+
+	//------------------------------
+	/** Returns a pseudo random number in 0..@a count-1. The sequence only depends on the seed,
+	so failures can be reproduced.*/
+	size_t getRandom( size_t count )
+	{
+		randomState = randomState * 1103515245u + 12345u;
+		return ( randomState >> 16 ) % count;
+	}
+
+	//------------------------------
+	/** Returns a pseudo random value in [-@a range, @a range].*/
+	double getRandomValue( double range )
+	{
+		return ( (double)getRandom( 20001 ) / 10000.0 - 1.0 ) * range;
+	}
+
+	//------------------------------
+	/** Returns a random affine matrix.*/
+	COLLADABU::Math::Matrix4 getRandomMatrix()
+	{
+		COLLADABU::Math::Matrix4 matrix;
+		for ( int i = 0; i < 12; ++i )
+			matrix.setElement( i, getRandomValue( 2.0 ) );
+		for ( int i = 12; i < 15; ++i )
+			matrix.setElement( i, 0.0 );
+		matrix.setElement( 15, 1.0 );
+		return matrix;
+	}
+
+	/** Creates the nodes with consecutive unique ids.*/
+	class NodeFactory
+	{
+	private:
+		COLLADAFW::ObjectId mNextObjectId;
+
+	public:
+		NodeFactory() : mNextObjectId( 0 ) {}
+
+		/** Returns a new node with one to three random transformations.*/
+		COLLADAFW::Node* createNode()
+		{
+			COLLADAFW::Node* node = new COLLADAFW::Node( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::NODE, mNextObjectId++, 0 ) );
+			for ( size_t i = 0, count = 1 + getRandom( 3 ); i < count; ++i )
+			{
+				COLLADAFW::Transformation* transformation = 0;
+				switch ( getRandom( 4 ) )
+				{
+				case 0:
+					transformation = new COLLADAFW::Translate( getRandomValue( 10.0 ), getRandomValue( 10.0 ), getRandomValue( 10.0 ) );
+					break;
+				case 1:
+					transformation = new COLLADAFW::Rotate( getRandomValue( 1.0 ), getRandomValue( 1.0 ), 1.0, getRandomValue( 180.0 ) );
+					break;
+				case 2:
+					transformation = new COLLADAFW::Scale( 0.5 + getRandom( 3 ), 1.0, 0.5 + getRandom( 2 ) );
+					break;
+				default:
+					transformation = new COLLADAFW::Matrix( getRandomMatrix() );
+					break;
+				}
+				node->getTransformations().append( transformation );
+			}
+			return node;
+		}
+
+		/** Adds an instance node to @a node, that instantiates the node with @a nodeId.*/
+		void instantiate( COLLADAFW::Node* node, const COLLADAFW::UniqueId& nodeId )
+		{
+			COLLADAFW::UniqueId instanceId( COLLADAFW::COLLADA_TYPE::INSTANCE_NODE, mNextObjectId++, 0 );
+			node->getInstanceNodes().append( new COLLADAFW::InstanceNode( instanceId, nodeId ) );
+		}
+
+		/** Creates a random node tree of at most MAX_DEPTH - @a depth levels. Some of the nodes
+		instantiate one of @a instantiableNodes.*/
+		COLLADAFW::Node* createNodeTree( size_t depth, const UniqueIdList& instantiableNodes )
+		{
+			COLLADAFW::Node* node = createNode();
+			if ( !instantiableNodes.empty() && getRandom( 4 ) == 0 )
+				instantiate( node, instantiableNodes[getRandom( instantiableNodes.size() )] );
+			if ( depth + 1 < MAX_DEPTH )
+			{
+				for ( size_t i = 0, count = getRandom( 4 ); i < count; ++i )
+					node->getChildNodes().append( createNodeTree( depth + 1, instantiableNodes ) );
+			}
+			return node;
+		}
+	};
+
+	/** Calculates the world matrices by walking the node tree recursively, in the order of the
+	entries of TransformHierarchy.*/
+	class ReferenceTraversal
+	{
+	private:
+		typedef std::map<COLLADAFW::UniqueId, const COLLADAFW::Node*> UniqueIdNodeMap;
+		typedef std::set<COLLADAFW::UniqueId> UniqueIdSet;
+
+		const COLLADAFW::VisualScene& mVisualScene;
+
+		/** All nodes of the visual scene and the library nodes.*/
+		UniqueIdNodeMap mNodes;
+
+		/** The local matrix of each visited node, in traversal order.*/
+		MatrixList mLocalMatrices;
+
+		/** The world matrix of each visited node, in traversal order.*/
+		MatrixList mWorldMatrices;
+
+		/** The id of each visited node, in traversal order.*/
+		UniqueIdList mNodeIds;
+
+		/** The index of the next visited node.*/
+		size_t mVisitIndex;
+
+	public:
+		ReferenceTraversal( const COLLADAFW::VisualScene& visualScene, const COLLADAFW::LibraryNodes& libraryNodes )
+			: mVisualScene( visualScene )
+			, mVisitIndex( 0 )
+		{
+			addNodes( visualScene.getRootNodes() );
+			addNodes( libraryNodes.getNodes() );
+
+			// the first traversal takes the local matrices from the nodes
+			evaluate();
+		}
+
+		size_t getVisitCount() const { return mNodeIds.size(); }
+
+		const COLLADAFW::UniqueId& getNodeId( size_t visitIndex ) const { return mNodeIds[visitIndex]; }
+
+		const COLLADABU::Math::Matrix4& getWorldMatrix( size_t visitIndex ) const { return mWorldMatrices[visitIndex]; }
+
+		/** Replaces the local matrix of the visit with @a visitIndex.*/
+		void setLocalMatrix( size_t visitIndex, const COLLADABU::Math::Matrix4& localMatrix ) { mLocalMatrices[visitIndex] = localMatrix; }
+
+		/** Calculates the world matrices of all visits.*/
+		void evaluate()
+		{
+			mVisitIndex = 0;
+			UniqueIdSet path;
+			const COLLADAFW::NodePointerArray& rootNodes = mVisualScene.getRootNodes();
+			for ( size_t i = 0, count = rootNodes.getCount(); i < count; ++i )
+				visit( *rootNodes[i], 0, path );
+		}
+
+	private:
+		void addNodes( const COLLADAFW::NodePointerArray& nodes )
+		{
+			for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+			{
+				mNodes[nodes[i]->getUniqueId()] = nodes[i];
+				addNodes( nodes[i]->getChildNodes() );
+			}
+		}
+
+		/** Visits @a node and its subtree. @a parentWorldMatrix is 0 for root nodes.*/
+		void visit( const COLLADAFW::Node& node, const COLLADABU::Math::Matrix4* parentWorldMatrix, UniqueIdSet& path )
+		{
+			if ( !path.insert( node.getUniqueId() ).second )
+				return;
+
+			size_t visitIndex = mVisitIndex++;
+			if ( visitIndex == mNodeIds.size() )
+			{
+				mNodeIds.push_back( node.getUniqueId() );
+				mLocalMatrices.push_back( node.getTransformationMatrix() );
+				mWorldMatrices.push_back( COLLADABU::Math::Matrix4() );
+			}
+
+			const COLLADABU::Math::Matrix4& localMatrix = mLocalMatrices[visitIndex];
+			COLLADABU::Math::Matrix4 worldMatrix = parentWorldMatrix ? *parentWorldMatrix * localMatrix : localMatrix;
+			mWorldMatrices[visitIndex] = worldMatrix;
+
+			const COLLADAFW::NodePointerArray& childNodes = node.getChildNodes();
+			for ( size_t i = 0, count = childNodes.getCount(); i < count; ++i )
+				visit( *childNodes[i], &worldMatrix, path );
+
+			const COLLADAFW::InstanceNodePointerArray& instanceNodes = node.getInstanceNodes();
+			for ( size_t i = 0, count = instanceNodes.getCount(); i < count; ++i )
+			{
+				UniqueIdNodeMap::const_iterator it = mNodes.find( instanceNodes[i]->getInstanciatedObjectId() );
+				if ( it != mNodes.end() )
+					visit( *it->second, &worldMatrix, path );
+			}
+
+			path.erase( node.getUniqueId() );
+		}
+	};
+
+	//------------------------------
+	/** Compares the entries and world matrices of @a hierarchy with @a reference.
+	@return True, if they are equal.*/
+	bool isEqual( const COLLADAFW::TransformHierarchy& hierarchy, const ReferenceTraversal& reference )
+	{
+		if ( hierarchy.getEntryCount() != reference.getVisitCount() )
+			return false;
+		for ( size_t i = 0, count = hierarchy.getEntryCount(); i < count; ++i )
+		{
+			if ( !( hierarchy.getEntry( i ).nodeId == reference.getNodeId( i ) ) )
+				return false;
+			const double* worldMatrix = hierarchy.getWorldMatrixValues( i );
+			const COLLADABU::Math::Matrix4& referenceMatrix = reference.getWorldMatrix( i );
+			for ( int j = 0; j < (int)COLLADAFW::TransformHierarchy::MATRIX_SIZE; ++j )
+			{
+				if ( worldMatrix[j] != referenceMatrix.getElement( j ) )
+				{
+					fprintf( stderr, "entry %d, element %d: %.17g instead of %.17g\n", (int)i, j, worldMatrix[j], referenceMatrix.getElement( j ) );
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	//------------------------------
+	/** Returns the number of entries between @a entryIndex and its ancestor @a ancestorIndex, or 0
+	if @a ancestorIndex is not an ancestor of @a entryIndex.*/
+	size_t getDistance( const COLLADAFW::TransformHierarchy& hierarchy, size_t entryIndex, size_t ancestorIndex )
+	{
+		size_t distance = 0;
+		for ( size_t i = entryIndex; i != COLLADAFW::TransformHierarchy::NO_ENTRY; i = hierarchy.getEntry( i ).parent )
+		{
+			if ( i == ancestorIndex )
+				return distance;
+			++distance;
+		}
+		return 0;
+	}
+
+	//------------------------------
+	/** Changes the local matrix of a nested entry, that is not a root, and of one of its
+	descendants at least two levels below, in reverse order.*/
+	void checkNestedEntries( COLLADAFW::TransformHierarchy& hierarchy, ReferenceTraversal& reference )
+	{
+		size_t ancestorIndex = COLLADAFW::TransformHierarchy::NO_ENTRY;
+		size_t descendantIndex = COLLADAFW::TransformHierarchy::NO_ENTRY;
+		for ( size_t i = 0, count = hierarchy.getEntryCount(); i < count && descendantIndex == COLLADAFW::TransformHierarchy::NO_ENTRY; ++i )
+		{
+			if ( hierarchy.getEntry( i ).parent == COLLADAFW::TransformHierarchy::NO_ENTRY )
+				continue;
+			for ( size_t j = i + 1, end = hierarchy.getEntry( i ).subtreeEnd; j < end; ++j )
+			{
+				if ( getDistance( hierarchy, j, i ) >= 2 )
+				{
+					ancestorIndex = i;
+					descendantIndex = j;
+					break;
+				}
+			}
+		}
+		CHECK( descendantIndex != COLLADAFW::TransformHierarchy::NO_ENTRY );
+		if ( descendantIndex == COLLADAFW::TransformHierarchy::NO_ENTRY )
+			return;
+
+		COLLADABU::Math::Matrix4 descendantMatrix = getRandomMatrix();
+		COLLADABU::Math::Matrix4 ancestorMatrix = getRandomMatrix();
+		hierarchy.setLocalMatrix( descendantIndex, descendantMatrix );
+		hierarchy.setLocalMatrix( ancestorIndex, ancestorMatrix );
+		reference.setLocalMatrix( descendantIndex, descendantMatrix );
+		reference.setLocalMatrix( ancestorIndex, ancestorMatrix );
+
+		// the subtree of the descendant is part of the one of the ancestor
+		size_t evaluatedCount = hierarchy.evaluate();
+		CHECK( evaluatedCount == hierarchy.getEntry( ancestorIndex ).subtreeEnd - ancestorIndex );
+		reference.evaluate();
+		CHECK( isEqual( hierarchy, reference ) );
+
+		// a dirty descendant alone only recalculates its own subtree
+		descendantMatrix = getRandomMatrix();
+		hierarchy.setLocalMatrix( descendantIndex, descendantMatrix );
+		reference.setLocalMatrix( descendantIndex, descendantMatrix );
+		evaluatedCount = hierarchy.evaluate();
+		CHECK( evaluatedCount == hierarchy.getEntry( descendantIndex ).subtreeEnd - descendantIndex );
+		reference.evaluate();
+		CHECK( isEqual( hierarchy, reference ) );
+	}
+
+	//------------------------------
+	/** Changes the local matrix of all entries of the node with @a nodeId.*/
+	void checkNodeEntries( COLLADAFW::TransformHierarchy& hierarchy, ReferenceTraversal& reference, const COLLADAFW::UniqueId& nodeId )
+	{
+		COLLADABU::Math::Matrix4 localMatrix = getRandomMatrix();
+		size_t entryCount = hierarchy.setLocalMatrix( nodeId, localMatrix );
+
+		size_t visitCount = 0;
+		for ( size_t i = 0, count = reference.getVisitCount(); i < count; ++i )
+		{
+			if ( reference.getNodeId( i ) == nodeId )
+			{
+				reference.setLocalMatrix( i, localMatrix );
+				++visitCount;
+			}
+		}
+		CHECK( entryCount == visitCount );
+		CHECK( entryCount >= 2 );
+
+		hierarchy.evaluate();
+		reference.evaluate();
+		CHECK( isEqual( hierarchy, reference ) );
+	}
+}
+
+
+//------------------------------
+int main( int argc, char** argv )
+{
+	randomState = argc > 1 ? (unsigned int)atoi( argv[1] ) : 1;
+
+	NodeFactory nodeFactory;
+
+	// the library nodes: the second instantiates the first and a child of the first instantiates
+	// the first, i.e. its own ancestor, which must be ignored
+	COLLADAFW::LibraryNodes libraryNodes;
+	UniqueIdList libraryNodeIds;
+	COLLADAFW::Node* firstLibraryNode = nodeFactory.createNodeTree( 2, libraryNodeIds );
+	COLLADAFW::Node* cycleNode = nodeFactory.createNode();
+	nodeFactory.instantiate( cycleNode, firstLibraryNode->getUniqueId() );
+	firstLibraryNode->getChildNodes().append( cycleNode );
+	libraryNodes.getNodes().append( firstLibraryNode );
+	libraryNodeIds.push_back( firstLibraryNode->getUniqueId() );
+
+	COLLADAFW::Node* secondLibraryNode = nodeFactory.createNodeTree( 3, UniqueIdList() );
+	nodeFactory.instantiate( secondLibraryNode, firstLibraryNode->getUniqueId() );
+	libraryNodes.getNodes().append( secondLibraryNode );
+	libraryNodeIds.push_back( secondLibraryNode->getUniqueId() );
+
+	// the visual scene: a few deep root nodes, that instantiate both library nodes
+	COLLADAFW::VisualScene visualScene( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::VISUAL_SCENE, 0, 0 ) );
+	for ( size_t i = 0; i < 4; ++i )
+	{
+		COLLADAFW::Node* rootNode = nodeFactory.createNodeTree( 0, libraryNodeIds );
+		COLLADAFW::Node* childNode = nodeFactory.createNodeTree( 1, libraryNodeIds );
+		nodeFactory.instantiate( childNode, libraryNodeIds[i % 2] );
+		rootNode->getChildNodes().append( childNode );
+		visualScene.getRootNodes().append( rootNode );
+	}
+
+	// the hierarchy does not depend on the order the objects are added in
+	COLLADAFW::TransformHierarchy hierarchy;
+	hierarchy.addLibraryNodes( libraryNodes );
+	hierarchy.addVisualScene( visualScene );
+	CHECK( !hierarchy.flatten( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::VISUAL_SCENE, 1, 0 ) ) );
+	CHECK( hierarchy.flatten( visualScene.getUniqueId() ) );
+
+	ReferenceTraversal reference( visualScene, libraryNodes );
+
+	// after flatten() all world matrices are calculated
+	CHECK( hierarchy.evaluate() == hierarchy.getEntryCount() );
+	CHECK( isEqual( hierarchy, reference ) );
+	CHECK( hierarchy.evaluate() == 0 );
+
+	// the local matrices must be the ones of the nodes
+	for ( size_t i = 0, count = hierarchy.getEntryCount(); i < count; ++i )
+	{
+		if ( hierarchy.getEntry( i ).parent != COLLADAFW::TransformHierarchy::NO_ENTRY )
+			continue;
+		COLLADABU::Math::Matrix4 localMatrix;
+		hierarchy.getLocalMatrix( i, localMatrix );
+		CHECK( localMatrix == reference.getWorldMatrix( i ) );
+	}
+
+	checkNestedEntries( hierarchy, reference );
+	checkNodeEntries( hierarchy, reference, libraryNodeIds[0] );
+	checkNodeEntries( hierarchy, reference, libraryNodeIds[1] );
+
+	// dirty entries are dropped by flatten(), which recalculates everything
+	hierarchy.setLocalMatrix( hierarchy.getEntryCount() - 1, getRandomMatrix() );
+	CHECK( hierarchy.flatten( visualScene.getUniqueId() ) );
+	CHECK( hierarchy.evaluate() == hierarchy.getEntryCount() );
+	ReferenceTraversal newReference( visualScene, libraryNodes );
+	CHECK( isEqual( hierarchy, newReference ) );
+
+	printf( "%d entries, %d failed checks\n", (int)hierarchy.getEntryCount(), (int)Common::Test::failureCount );
+	return Common::Test::failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,556 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Triangulates random polygons with COLLADAFW::Triangulator and checks the triangles. The polygons
+    are star shaped, so most of them are concave, and some have holes. They are rotated into random
+    planes and have random winding. For each polygon the test checks the number of triangles, that
+    all triangles have the winding of the polygon, that their areas sum up to the area of the polygon
+    without its holes and that no triangle lies outside the polygon or inside a hole. The polygons
+    are triangulated by ear clipping, the convex ones also as fan, and on one and several threads.
+    Triangle strips, including strips stitched by repeated vertices, and triangle fans are checked
+    for their winding and area as well.
+
+    usage: triangulatorTest [polygon count]
+*/
+
+#include "COLLADAFW.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+
+namespace
+{
+	/** The default number of random polygons.*/
+	const size_t DEFAULT_POLYGON_COUNT = 3000;
+
+	/** The number of polygons primitives the random polygons are spread over.*/
+	const size_t PRIMITIVE_COUNT = 8;
+
+	/** The number of threads used for the multi threaded triangulation.*/
+	const size_t THREAD_COUNT = 4;
+
+	/** The smallest and largest number of outline vertices of a random polygon.*/
+	const size_t MIN_OUTLINE_COUNT = 3;
+	const size_t MAX_OUTLINE_COUNT = 40;
+
+	/** Polygons with fewer outline vertices have no holes, since they might not contain them.*/
+	const size_t MIN_OUTLINE_COUNT_WITH_HOLES = 8;
+
+	/** The largest number of holes of a random polygon.*/
+	const size_t MAX_HOLE_COUNT = 3;
+
+	/** The radius of the outline vertices is between these radii. With at least
+	MIN_OUTLINE_COUNT_WITH_HOLES vertices, the outline contains the circle of radius 0.45.*/
+	const double MIN_OUTLINE_RADIUS = 0.6;
+	const double MAX_OUTLINE_RADIUS = 1.0;
+
+	/** The holes are centered on a circle of this radius around the center of the polygon.*/
+	const double HOLE_CENTER_RADIUS = 0.3;
+
+	/** The largest radius of a hole vertex around the center of its hole.*/
+	const double MAX_HOLE_RADIUS = 0.12;
+
+	/** M_PI is not defined by all compilers.*/
+	const double PI = 3.14159265358979323846;
+
+	/** The largest relative difference of the area of the triangles to the area of the polygon.*/
+	const double MAX_AREA_DIFFERENCE = 1e-9;
+
+	/** Triangles with a smaller area are not checked for lying inside the polygon, since their
+	center might lie on an edge.*/
+	const double MIN_CHECKED_AREA = 1e-9;
+
+
+	//------------------------------
+	/** Returns a pseudo random number in 0..1.*/
+	double getRandom( unsigned int& seed )
+	{
+		seed = seed * 1103515245u + 12345u;
+		return ( ( seed >> 8 ) & 0xffff ) / 65535.0;
+	}
+
+	//------------------------------
+	/** Returns a pseudo random number in @a min..@a max.*/
+	size_t getRandom( unsigned int& seed, size_t min, size_t max )
+	{
+		return min + (size_t)( getRandom( seed ) * ( max - min ) + 0.5 );
+	}
+
+
+	/** A point in the plane of a polygon.*/
+	struct Point
+	{
+		double x;
+		double y;
+	};
+
+	typedef std::vector<Point> PointList;
+
+	/** A random polygon, its outline followed by its holes.*/
+	struct Polygon
+	{
+		/** The outline, followed by the holes.*/
+		PointList points;
+
+		/** The number of vertices of the outline and each hole.*/
+		std::vector<size_t> counts;
+
+		/** The first corner of the polygon in its primitive.*/
+		size_t firstCorner;
+	};
+
+	typedef std::vector<Polygon> PolygonList;
+
+	/** The plane a polygon is placed in, by an origin and two orthonormal axes.*/
+	struct Plane
+	{
+		double origin[3];
+		double axisX[3];
+		double axisY[3];
+	};
+
+
+	//------------------------------
+	/** Appends a star shaped ring of @a count points around @a centerX, @a centerY with radii
+	between @a minRadius and @a maxRadius. The ring is counter clockwise, unless @a reversed is true.*/
+	void appendRing( PointList& points, size_t count, double centerX, double centerY, double minRadius, double maxRadius, bool reversed, unsigned int& seed )
+	{
+		const size_t first = points.size();
+		for ( size_t i = 0; i < count; ++i )
+		{
+			// each point has its own sector of the circle, so the points are ordered by angle
+			const double angle = ( i + 0.9 * getRandom( seed ) ) * 2 * PI / count;
+			const double radius = minRadius + ( maxRadius - minRadius ) * getRandom( seed );
+			Point point;
+			point.x = centerX + radius * cos( angle );
+			point.y = centerY + radius * sin( angle );
+			points.push_back( point );
+		}
+		if ( reversed )
+			std::reverse( points.begin() + first, points.end() );
+	}
+
+	//------------------------------
+	/** Creates a random polygon. The outlines of some polygons are convex.*/
+	void createPolygon( Polygon& polygon, unsigned int& seed )
+	{
+		polygon.points.clear();
+		polygon.counts.clear();
+
+		const size_t outlineCount = getRandom( seed, MIN_OUTLINE_COUNT, MAX_OUTLINE_COUNT );
+		const bool convex = getRandom( seed ) < 0.2;
+		appendRing( polygon.points, outlineCount, 0, 0, convex ? MAX_OUTLINE_RADIUS : MIN_OUTLINE_RADIUS, MAX_OUTLINE_RADIUS, getRandom( seed ) < 0.5, seed );
+		polygon.counts.push_back( outlineCount );
+
+		if ( outlineCount < MIN_OUTLINE_COUNT_WITH_HOLES )
+			return;
+		const size_t holeCount = getRandom( seed, 0, MAX_HOLE_COUNT );
+		const double firstAngle = 2 * PI * getRandom( seed );
+		for ( size_t i = 0; i < holeCount; ++i )
+		{
+			const double angle = firstAngle + i * 2 * PI / holeCount;
+			const size_t count = getRandom( seed, 3, 8 );
+			appendRing( polygon.points, count, HOLE_CENTER_RADIUS * cos( angle ), HOLE_CENTER_RADIUS * sin( angle ), 0.4 * MAX_HOLE_RADIUS, MAX_HOLE_RADIUS, getRandom( seed ) < 0.5, seed );
+			polygon.counts.push_back( count );
+		}
+	}
+
+	//------------------------------
+	/** Creates a random plane.*/
+	void createPlane( Plane& plane, unsigned int& seed )
+	{
+		double normal[3];
+		double length = 0;
+		while ( length < 0.1 )
+		{
+			for ( size_t i = 0; i < 3; ++i )
+				normal[i] = 2 * getRandom( seed ) - 1;
+			length = sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+		}
+		for ( size_t i = 0; i < 3; ++i )
+		{
+			normal[i] /= length;
+			plane.origin[i] = 100 * ( getRandom( seed ) - 0.5 );
+		}
+
+		// the x axis is perpendicular to the normal and the coordinate axis least parallel to it
+		double axis[3] = { 0, 0, 0 };
+		axis[fabs( normal[0] ) < fabs( normal[1] ) ? ( fabs( normal[0] ) < fabs( normal[2] ) ? 0 : 2 ) : ( fabs( normal[1] ) < fabs( normal[2] ) ? 1 : 2 )] = 1;
+		plane.axisX[0] = normal[1] * axis[2] - normal[2] * axis[1];
+		plane.axisX[1] = normal[2] * axis[0] - normal[0] * axis[2];
+		plane.axisX[2] = normal[0] * axis[1] - normal[1] * axis[0];
+		length = sqrt( plane.axisX[0] * plane.axisX[0] + plane.axisX[1] * plane.axisX[1] + plane.axisX[2] * plane.axisX[2] );
+		for ( size_t i = 0; i < 3; ++i )
+			plane.axisX[i] /= length;
+		plane.axisY[0] = normal[1] * plane.axisX[2] - normal[2] * plane.axisX[1];
+		plane.axisY[1] = normal[2] * plane.axisX[0] - normal[0] * plane.axisX[2];
+		plane.axisY[2] = normal[0] * plane.axisX[1] - normal[1] * plane.axisX[0];
+	}
+
+	//------------------------------
+	/** Appends the position of @a point in @a plane to @a positions.*/
+	void appendPosition( COLLADAFW::DoubleArray& positions, const Plane& plane, const Point& point )
+	{
+		for ( size_t i = 0; i < 3; ++i )
+			positions.append( plane.origin[i] + point.x * plane.axisX[i] + point.y * plane.axisY[i] );
+	}
+
+	//------------------------------
+	/** Twice the signed area of the ring of @a count points starting at @a first.*/
+	double getArea( const PointList& points, size_t first, size_t count )
+	{
+		double area = 0;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			const Point& point = points[first + i];
+			const Point& next = points[first + ( i + 1 ) % count];
+			area += point.x * next.y - next.x * point.y;
+		}
+		return area;
+	}
+
+	//------------------------------
+	/** Twice the signed area of the triangle @a a, @a b, @a c.*/
+	double getArea( const Point& a, const Point& b, const Point& c )
+	{
+		return ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x );
+	}
+
+	//------------------------------
+	/** Returns true, if @a point lies inside the ring of @a count points starting at @a first.*/
+	bool isInside( const Point& point, const PointList& points, size_t first, size_t count )
+	{
+		bool inside = false;
+		for ( size_t i = 0, j = count - 1; i < count; j = i++ )
+		{
+			const Point& a = points[first + i];
+			const Point& b = points[first + j];
+			if ( ( a.y > point.y ) != ( b.y > point.y ) && point.x < a.x + ( point.y - a.y ) * ( b.x - a.x ) / ( b.y - a.y ) )
+				inside = !inside;
+		}
+		return inside;
+	}
+
+	//------------------------------
+	/** Returns the number of triangles, that are needed for @a polygon.*/
+	size_t getExpectedTriangleCount( const Polygon& polygon )
+	{
+		size_t triangleCount = polygon.counts[0] - 2;
+		for ( size_t i = 1; i < polygon.counts.size(); ++i )
+			triangleCount += polygon.counts[i] + 2;
+		return triangleCount;
+	}
+
+	//------------------------------
+	/** Checks the triangles of @a polygon in @a triangleCorners starting at triangle
+	@a firstTriangle. The triangles must have the winding of the outline, cover the outline without
+	the holes and not lie outside the outline or inside a hole.
+	@return The number of failed checks.*/
+	size_t checkPolygon( const Polygon& polygon, const COLLADAFW::Triangulator::TriangleCornerList& triangleCorners, size_t firstTriangle )
+	{
+		const PointList& points = polygon.points;
+		const size_t outlineCount = polygon.counts[0];
+		const size_t triangleCount = getExpectedTriangleCount( polygon );
+		if ( 3 * ( firstTriangle + triangleCount ) > triangleCorners.size() )
+			return 1;
+
+		// the triangles are compared with a counter clockwise outline
+		const double outlineArea = getArea( points, 0, outlineCount );
+		const double sign = outlineArea < 0 ? -1 : 1;
+		double expectedArea = fabs( outlineArea );
+		size_t holeFirst = outlineCount;
+		for ( size_t i = 1; i < polygon.counts.size(); ++i )
+		{
+			expectedArea -= fabs( getArea( points, holeFirst, polygon.counts[i] ) );
+			holeFirst += polygon.counts[i];
+		}
+
+		size_t failureCount = 0;
+		double area = 0;
+		for ( size_t t = firstTriangle; t < firstTriangle + triangleCount; ++t )
+		{
+			size_t corners[3];
+			bool inRange = true;
+			for ( size_t i = 0; i < 3; ++i )
+			{
+				corners[i] = triangleCorners[3 * t + i] - polygon.firstCorner;
+				inRange = inRange && triangleCorners[3 * t + i] >= polygon.firstCorner && corners[i] < points.size();
+			}
+			if ( !inRange )
+			{
+				++failureCount;
+				continue;
+			}
+			const Point& a = points[corners[0]];
+			const Point& b = points[corners[1]];
+			const Point& c = points[corners[2]];
+			const double triangleArea = sign * getArea( a, b, c );
+			area += triangleArea;
+			if ( triangleArea < -MIN_CHECKED_AREA )
+			{
+				++failureCount;
+				continue;
+			}
+			if ( triangleArea < MIN_CHECKED_AREA )
+				continue;
+
+			Point center;
+			center.x = ( a.x + b.x + c.x ) / 3;
+			center.y = ( a.y + b.y + c.y ) / 3;
+			bool inside = isInside( center, points, 0, outlineCount );
+			holeFirst = outlineCount;
+			for ( size_t i = 1; i < polygon.counts.size() && inside; ++i )
+			{
+				inside = !isInside( center, points, holeFirst, polygon.counts[i] );
+				holeFirst += polygon.counts[i];
+			}
+			if ( !inside )
+				++failureCount;
+		}
+		if ( fabs( area - expectedArea ) > MAX_AREA_DIFFERENCE * expectedArea )
+			++failureCount;
+		return failureCount;
+	}
+
+	//------------------------------
+	/** Creates a mesh with @a polygons spread over PRIMITIVE_COUNT polygons primitives, each
+	polygon in a random plane.*/
+	COLLADAFW::Mesh* createPolygonsMesh( PolygonList& polygons, unsigned int& seed )
+	{
+		COLLADAFW::Mesh* mesh = new COLLADAFW::Mesh( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::MESH, 1, 0 ) );
+		COLLADAFW::DoubleArray positions( COLLADAFW::DoubleArray::OWNER );
+		std::vector<COLLADAFW::Polygons*> primitives;
+		for ( size_t i = 0; i < PRIMITIVE_COUNT; ++i )
+		{
+			primitives.push_back( new COLLADAFW::Polygons( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::PRIMITIVE_ELEMENT, i, 0 ) ) );
+			mesh->appendPrimitive( primitives.back() );
+		}
+
+		for ( size_t p = 0; p < polygons.size(); ++p )
+		{
+			Polygon& polygon = polygons[p];
+			Plane plane;
+			createPlane( plane, seed );
+
+			COLLADAFW::Polygons& primitive = *primitives[p % PRIMITIVE_COUNT];
+			COLLADAFW::IndexArray& positionIndices = primitive.getPositionIndexArray();
+			polygon.firstCorner = positionIndices.getCount();
+			for ( size_t i = 0; i < polygon.points.size(); ++i )
+			{
+				positionIndices.append( (unsigned int)( positions.getCount() / 3 ) );
+				appendPosition( positions, plane, polygon.points[i] );
+			}
+			COLLADAFW::Polygons::VertexCountArray& vertexCounts = primitive.getGroupedVerticesVertexCountArray();
+			vertexCounts.append( (int)polygon.counts[0] );
+			for ( size_t i = 1; i < polygon.counts.size(); ++i )
+				vertexCounts.append( -(int)polygon.counts[i] );
+		}
+		mesh->getPositions().appendValues( positions, "positions", 3 );
+		return mesh;
+	}
+
+	//------------------------------
+	/** Triangulates @a polygons by ear clipping on one and several threads and checks the triangles.
+	The convex ones are also checked as fan.
+	@return The number of failed checks.*/
+	size_t checkPolygons( size_t polygonCount, unsigned int& seed )
+	{
+		PolygonList polygons( polygonCount );
+		size_t holeCount = 0;
+		for ( size_t i = 0; i < polygonCount; ++i )
+		{
+			createPolygon( polygons[i], seed );
+			holeCount += polygons[i].counts.size() - 1;
+		}
+		COLLADAFW::Mesh* mesh = createPolygonsMesh( polygons, seed );
+
+		COLLADAFW::Triangulator earClipping( *mesh, COLLADAFW::Triangulator::EAR_CLIPPING );
+		earClipping.triangulate( 1 );
+		COLLADAFW::Triangulator parallelEarClipping( *mesh, COLLADAFW::Triangulator::EAR_CLIPPING );
+		parallelEarClipping.triangulate( THREAD_COUNT );
+		COLLADAFW::Triangulator fan( *mesh, COLLADAFW::Triangulator::FAN );
+		fan.triangulate( 1 );
+
+		size_t earClippingFailures = 0;
+		size_t parallelFailures = 0;
+		size_t fanFailures = 0;
+		size_t convexCount = 0;
+		std::vector<size_t> firstTriangles( PRIMITIVE_COUNT, 0 );
+		for ( size_t p = 0; p < polygonCount; ++p )
+		{
+			const Polygon& polygon = polygons[p];
+			const size_t primitiveIndex = p % PRIMITIVE_COUNT;
+			earClippingFailures += checkPolygon( polygon, earClipping.getTriangleCorners( primitiveIndex ), firstTriangles[primitiveIndex] );
+
+			// a fan is only correct for convex polygons without holes
+			bool convex = polygon.counts.size() == 1;
+			const size_t outlineCount = polygon.counts[0];
+			const double sign = getArea( polygon.points, 0, outlineCount ) < 0 ? -1 : 1;
+			for ( size_t i = 0; i < outlineCount && convex; ++i )
+				convex = sign * getArea( polygon.points[i], polygon.points[( i + 1 ) % outlineCount], polygon.points[( i + 2 ) % outlineCount] ) > 0;
+			if ( convex )
+			{
+				fanFailures += checkPolygon( polygon, fan.getTriangleCorners( primitiveIndex ), firstTriangles[primitiveIndex] );
+				++convexCount;
+			}
+			firstTriangles[primitiveIndex] += getExpectedTriangleCount( polygon );
+		}
+		for ( size_t i = 0; i < PRIMITIVE_COUNT; ++i )
+		{
+			if ( earClipping.getTriangleCorners( i ).size() != 3 * firstTriangles[i] )
+				++earClippingFailures;
+			if ( parallelEarClipping.getTriangleCorners( i ) != earClipping.getTriangleCorners( i ) )
+				++parallelFailures;
+		}
+
+		printf( "polygons: %d, holes %d, convex %d, failed checks: ear clipping %d, %d threads %d, fan %d\n", (int)polygonCount, (int)holeCount, (int)convexCount,
+			(int)earClippingFailures, (int)THREAD_COUNT, (int)parallelFailures, (int)fanFailures );
+		delete mesh;
+		return earClippingFailures + parallelFailures + fanFailures;
+	}
+
+	//------------------------------
+	/** Checks that all triangles of @a triangleCorners are counter clockwise in the xy plane and
+	that their areas sum up to @a expectedArea. @a positionIndices and @a positions are the
+	positions of the corners.
+	@return The number of failed checks.*/
+	size_t checkPlanarTriangles( const COLLADAFW::Triangulator::TriangleCornerList& triangleCorners, const COLLADAFW::IndexArray& positionIndices,
+		const PointList& positions, size_t expectedTriangleCount, double expectedArea )
+	{
+		size_t failureCount = 0;
+		if ( triangleCorners.size() != 3 * expectedTriangleCount )
+			++failureCount;
+		double area = 0;
+		for ( size_t t = 0; 3 * t + 2 < triangleCorners.size(); ++t )
+		{
+			const Point& a = positions[positionIndices[triangleCorners[3 * t]]];
+			const Point& b = positions[positionIndices[triangleCorners[3 * t + 1]]];
+			const Point& c = positions[positionIndices[triangleCorners[3 * t + 2]]];
+			const double triangleArea = getArea( a, b, c );
+			if ( triangleArea <= 0 )
+				++failureCount;
+			area += triangleArea;
+		}
+		if ( fabs( area - expectedArea ) > MAX_AREA_DIFFERENCE * expectedArea )
+			++failureCount;
+		return failureCount;
+	}
+
+	//------------------------------
+	/** Triangulates rows of quads as triangle strips and triangle fans. Each strip starts with a
+	counter clockwise triangle, so all triangles must be counter clockwise. Some rows are stitched to
+	one strip by repeating the last vertex of a row and the first of the next one, the triangles with
+	repeated vertices must be skipped.
+	@return The number of failed checks.*/
+	size_t checkStripsAndFans()
+	{
+		const size_t rowCount = 12;
+		const size_t quadsPerRow = 7;
+		const size_t stitchedRowCount = 3;
+
+		COLLADAFW::Mesh mesh( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::MESH, 2, 0 ) );
+		COLLADAFW::DoubleArray positionValues( COLLADAFW::DoubleArray::OWNER );
+		PointList positions;
+		for ( size_t y = 0; y <= rowCount; ++y )
+		{
+			for ( size_t x = 0; x <= quadsPerRow; ++x )
+			{
+				Point point;
+				point.x = (double)x;
+				point.y = (double)y;
+				positions.push_back( point );
+				positionValues.append( point.x );
+				positionValues.append( point.y );
+				positionValues.append( 0 );
+			}
+		}
+		mesh.getPositions().appendValues( positionValues, "positions", 3 );
+
+		// the first triangle of a row (x, y + 1), (x, y), (x + 1, y + 1) is counter clockwise
+		COLLADAFW::Tristrips* strips = new COLLADAFW::Tristrips( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::PRIMITIVE_ELEMENT, 100, 0 ) );
+		COLLADAFW::IndexArray& stripIndices = strips->getPositionIndexArray();
+		COLLADAFW::Tristrips::VertexCountArray& stripCounts = strips->getGroupedVerticesVertexCountArray();
+		size_t stripCount = 0;
+		for ( size_t y = 0; y < rowCount; ++y )
+		{
+			const bool stitched = y % stitchedRowCount != 0;
+			if ( stitched )
+			{
+				// repeats the last vertex of the previous row and the first of this row
+				stripIndices.append( stripIndices[stripIndices.getCount() - 1] );
+				stripIndices.append( (unsigned int)( ( y + 1 ) * ( quadsPerRow + 1 ) ) );
+				stripCount += 2;
+			}
+			else if ( y > 0 )
+			{
+				stripCounts.append( (unsigned int)stripCount );
+				stripCount = 0;
+			}
+			for ( size_t x = 0; x <= quadsPerRow; ++x )
+			{
+				stripIndices.append( (unsigned int)( ( y + 1 ) * ( quadsPerRow + 1 ) + x ) );
+				stripIndices.append( (unsigned int)( y * ( quadsPerRow + 1 ) + x ) );
+			}
+			stripCount += 2 * ( quadsPerRow + 1 );
+		}
+		stripCounts.append( (unsigned int)stripCount );
+		mesh.appendPrimitive( strips );
+
+		// one fan per quad, around its lower left corner
+		COLLADAFW::Trifans* fans = new COLLADAFW::Trifans( COLLADAFW::UniqueId( COLLADAFW::COLLADA_TYPE::PRIMITIVE_ELEMENT, 101, 0 ) );
+		COLLADAFW::IndexArray& fanIndices = fans->getPositionIndexArray();
+		COLLADAFW::Trifans::VertexCountArray& fanCounts = fans->getGroupedVerticesVertexCountArray();
+		for ( size_t y = 0; y < rowCount; ++y )
+		{
+			for ( size_t x = 0; x < quadsPerRow; ++x )
+			{
+				const unsigned int corner = (unsigned int)( y * ( quadsPerRow + 1 ) + x );
+				fanIndices.append( corner );
+				fanIndices.append( corner + 1 );
+				fanIndices.append( corner + 1 + (unsigned int)( quadsPerRow + 1 ) );
+				fanIndices.append( corner + (unsigned int)( quadsPerRow + 1 ) );
+				fanCounts.append( 4 );
+			}
+		}
+		mesh.appendPrimitive( fans );
+
+		COLLADAFW::Triangulator triangulator( mesh );
+		triangulator.triangulate();
+		const size_t quadCount = rowCount * quadsPerRow;
+		const size_t stripFailures = checkPlanarTriangles( triangulator.getTriangleCorners( 0 ), stripIndices, positions, 2 * quadCount, 2.0 * quadCount );
+		const size_t fanFailures = checkPlanarTriangles( triangulator.getTriangleCorners( 1 ), fanIndices, positions, 2 * quadCount, 2.0 * quadCount );
+		printf( "strips: %d, fans: %d, failed checks: strips %d, fans %d\n", (int)stripCounts.getCount(), (int)fanCounts.getCount(), (int)stripFailures, (int)fanFailures );
+		return stripFailures + fanFailures;
+	}
+}
+
+
+int main( int argc, char** argv )
+{
+	size_t polygonCount = DEFAULT_POLYGON_COUNT;
+	if ( argc > 2 || ( argc == 2 && ( polygonCount = (size_t)strtoul( argv[1], 0, 10 ) ) == 0 ) )
+	{
+		fprintf( stderr, "usage: %s [polygon count]\n", argv[0] );
+		return 2;
+	}
+
+	unsigned int seed = 1;
+	size_t failureCount = checkPolygons( polygonCount, seed );
+	failureCount += checkStripsAndFans();
+
+	printf( "%d failed checks\n", (int)failureCount );
+	return failureCount == 0 ? 0 : 1;
+}
@@ -174,7 +174,7 @@ namespace COLLADAMax
 			case COLLADAFW::MeshPrimitive::TRIANGLES:
 				{
 					const COLLADAFW::Triangles* triangles = (const COLLADAFW::Triangles*) meshPrimitive;
-					const COLLADAFW::UIntValuesArray& positionIndices =  triangles->getPositionIndices();
+					const COLLADAFW::IndexArray& positionIndices =  triangles->getPositionIndexArray();
 					for ( size_t j = 0, count = positionIndices.getCount() ; j < count; j+=3 )
 					{
 						Face& face = triangleMesh.faces[faceIndex];
@@ -190,7 +190,7 @@ namespace COLLADAMax
 			case COLLADAFW::MeshPrimitive::TRIANGLE_STRIPS:
 				{
 					const COLLADAFW::Tristrips* tristrips = (const COLLADAFW::Tristrips*) meshPrimitive;
-					const COLLADAFW::UIntValuesArray& positionIndices =  tristrips->getPositionIndices();
+					const COLLADAFW::IndexArray& positionIndices =  tristrips->getPositionIndexArray();
 					const COLLADAFW::UIntValuesArray& faceVertexCountArray = tristrips->getGroupedVerticesVertexCountArray();
 					size_t nextTristripStartIndex = 0;
 					for ( size_t k = 0, count = faceVertexCountArray.getCount(); k < count; ++k)
@@ -223,7 +223,7 @@ namespace COLLADAMax
 			case COLLADAFW::MeshPrimitive::TRIANGLE_FANS:
 				{
 					const COLLADAFW::Trifans* trifans = (const COLLADAFW::Trifans*) meshPrimitive;
-					const COLLADAFW::UIntValuesArray& positionIndices =  trifans->getPositionIndices();
+					const COLLADAFW::IndexArray& positionIndices =  trifans->getPositionIndexArray();
 					const COLLADAFW::UIntValuesArray& faceVertexCountArray = trifans->getGroupedVerticesVertexCountArray();
 					size_t nextTrifanStartIndex = 0;
 					for ( size_t k = 0, count = faceVertexCountArray.getCount(); k < count; ++k)
@@ -305,7 +305,7 @@ namespace COLLADAMax
 			const COLLADAFW::MeshPrimitive* meshPrimitive = meshPrimitives[i];
 			size_t trianglesCount = meshPrimitive->getFaceCount();
 
-			const COLLADAFW::UIntValuesArray& normalIndices = meshPrimitive->getNormalIndices();
+			const COLLADAFW::IndexArray& normalIndices = meshPrimitive->getNormalIndexArray();
 			if (isSupportedMeshPrimitive(meshPrimitive))
 			{
 				if ( skipMeshData( meshPrimitive, normalIndices, faceIndex ) )
@@ -500,7 +500,7 @@ namespace COLLADAMax
 	//------------------------------
 	void GeometryImporter::setTriangleMeshUVVerticesPerPrimitiveAndChannel( const COLLADAFW::MeshPrimitive* meshPrimitive,
 		MeshMap& meshMap,
-		const COLLADAFW::UIntValuesArray& uvIndices,
+		const COLLADAFW::IndexArray& uvIndices,
 		unsigned int initialIndex,
 		size_t& currentFaceIndex)
 	{
@@ -572,13 +572,13 @@ namespace COLLADAMax
 	//------------------------------
 	size_t getTriangleMeshPrimitiveTriangleCount( const COLLADAFW::MeshPrimitive* meshPrimitive)
 	{
-		const COLLADAFW::UIntValuesArray& faceVertexCountArray = meshPrimitive->getPositionIndices();
+		const COLLADAFW::IndexArray& faceVertexCountArray = meshPrimitive->getPositionIndexArray();
 
 		switch (meshPrimitive->getPrimitiveType())
 		{
 		case COLLADAFW::MeshPrimitive::TRIANGLES:
 			{
-				return meshPrimitive->getPositionIndices().getCount()/3;
+				return meshPrimitive->getPositionIndexArray().getCount()/3;
 			}
 		case COLLADAFW::MeshPrimitive::TRIANGLE_STRIPS:
 			{
@@ -682,7 +682,7 @@ namespace COLLADAMax
 
 					unsigned int initialIndex = (unsigned int)uvIndexList.getInitialIndex();
 
-					const COLLADAFW::UIntValuesArray& uvIndices =  uvIndexList.getIndices();
+					const COLLADAFW::IndexArray& uvIndices =  uvIndexList.getIndexArray();
 
 					MeshMap& meshMap = triangleMesh.Map(mapChannel);
 
@@ -705,7 +705,7 @@ namespace COLLADAMax
 
 					unsigned int initialIndex = (unsigned int)colorIndexList.getInitialIndex();
 
-					const COLLADAFW::UIntValuesArray& colorIndices =  colorIndexList.getIndices();
+					const COLLADAFW::IndexArray& colorIndices =  colorIndexList.getIndexArray();
 
 					MeshMap& meshMap = triangleMesh.Map(mapChannel);
 
@@ -810,11 +810,15 @@ namespace COLLADAMax
 			case COLLADAFW::MeshPrimitive::TRIANGLES:
 				{
 					const COLLADAFW::Triangles* triangles = (const COLLADAFW::Triangles*) meshPrimitive;
-					const COLLADAFW::UIntValuesArray& positionIndices =  triangles->getPositionIndices();
+					const COLLADAFW::IndexArray& positionIndices =  triangles->getPositionIndexArray();
 					for ( size_t j = 0, count = positionIndices.getCount() ; j < count; j+=3 )
 					{
 						MNFace* face = polgonMesh.F((int)faceIndex);
-						face->MakePoly(3, (int*) (&positionIndices[j]));
+						int indices[3];
+						indices[0] = (int)positionIndices[j];
+						indices[1] = (int)positionIndices[j + 1];
+						indices[2] = (int)positionIndices[j + 2];
+						face->MakePoly(3, indices);
 						if ( maxMaterialId != 0 )
 							face->material = maxMaterialId;
 
@@ -825,7 +829,7 @@ namespace COLLADAMax
 			case COLLADAFW::MeshPrimitive::TRIANGLE_STRIPS:
 				{
 					const COLLADAFW::Tristrips* tristrips = (const COLLADAFW::Tristrips*) meshPrimitive;
-					const COLLADAFW::UIntValuesArray& positionIndices =  tristrips->getPositionIndices();
+					const COLLADAFW::IndexArray& positionIndices =  tristrips->getPositionIndexArray();
 					const COLLADAFW::UIntValuesArray& faceVertexCountArray = tristrips->getGroupedVerticesVertexCountArray();
 					size_t nextTristripStartIndex = 0;
 					for ( size_t k = 0, count = faceVertexCountArray.getCount(); k < count; ++k)
@@ -848,7 +852,11 @@ namespace COLLADAMax
 							}
 							else
 							{
-								face->MakePoly(3, (int*) (&positionIndices[j - 2]));
+								int indices[3];
+								indices[0] = (int)positionIndices[j - 2];
+								indices[1] = (int)positionIndices[j - 1];
+								indices[2] = (int)positionIndices[j ];
+								face->MakePoly(3, indices);
 								if ( maxMaterialId != 0 )
 									face->material = maxMaterialId;
 								switchOrientation = true;
@@ -863,7 +871,7 @@ namespace COLLADAMax
 			case COLLADAFW::MeshPrimitive::TRIANGLE_FANS:
 				{
 					const COLLADAFW::Trifans* trifans = (const COLLADAFW::Trifans*) meshPrimitive;
-					const COLLADAFW::UIntValuesArray& positionIndices =  trifans->getPositionIndices();
+					const COLLADAFW::IndexArray& positionIndices =  trifans->getPositionIndexArray();
 					const COLLADAFW::UIntValuesArray& faceVertexCountArray = trifans->getGroupedVerticesVertexCountArray();
 					size_t nextTrifanStartIndex = 0;
 					for ( size_t k = 0, count = faceVertexCountArray.getCount(); k < count; ++k)
@@ -890,9 +898,10 @@ namespace COLLADAMax
 			case COLLADAFW::MeshPrimitive::POLYGONS:
 				{
 					const COLLADAFW::Polygons* polygons = (const COLLADAFW::Polygons*) meshPrimitive;
-					const COLLADAFW::UIntValuesArray& positionIndices =  polygons->getPositionIndices();
+					const COLLADAFW::IndexArray& positionIndices =  polygons->getPositionIndexArray();
 					const COLLADAFW::IntValuesArray& faceVertexCountArray = polygons->getGroupedVerticesVertexCountArray();
 					size_t currentIndex = 0;
+					std::vector<int> polygonIndices;
 					for ( size_t j = 0, count = faceVertexCountArray.getCount() ; j < count; ++j )
 					{
 						int faceVertexCount = faceVertexCountArray[j];
@@ -900,7 +909,10 @@ namespace COLLADAMax
 						if ( faceVertexCount <= 0 )
 							continue;
 						MNFace* face = polgonMesh.F((int)faceIndex);
-						face->MakePoly(faceVertexCount, (int*) (&positionIndices[currentIndex]));
+						polygonIndices.resize(faceVertexCount);
+						for ( int k = 0; k < faceVertexCount; ++k )
+							polygonIndices[k] = (int)positionIndices[currentIndex + k];
+						face->MakePoly(faceVertexCount, &polygonIndices[0]);
 						if ( maxMaterialId != 0 )
 							face->material = maxMaterialId;
 						currentIndex += faceVertexCount;
@@ -911,9 +923,10 @@ namespace COLLADAMax
 			case COLLADAFW::MeshPrimitive::POLYLIST:
 				{
 					const COLLADAFW::Polylist* polylist = (const COLLADAFW::Polylist*) meshPrimitive;
-					const COLLADAFW::UIntValuesArray& positionIndices =  polylist->getPositionIndices();
+					const COLLADAFW::IndexArray& positionIndices =  polylist->getPositionIndexArray();
 					const COLLADAFW::IntValuesArray& faceVertexCountArray = polylist->getGroupedVerticesVertexCountArray();
 					size_t currentIndex = 0;
+					std::vector<int> polygonIndices;
 					for ( size_t j = 0, count = faceVertexCountArray.getCount() ; j < count; ++j )
 					{
 						int faceVertexCount = faceVertexCountArray[j];
@@ -921,7 +934,10 @@ namespace COLLADAMax
 						if ( faceVertexCount <= 0 )
 							continue;
 						MNFace* face = polgonMesh.F((int)faceIndex);
-						face->MakePoly(faceVertexCount, (int*) (&positionIndices[currentIndex]));
+						polygonIndices.resize(faceVertexCount);
+						for ( int k = 0; k < faceVertexCount; ++k )
+							polygonIndices[k] = (int)positionIndices[currentIndex + k];
+						face->MakePoly(faceVertexCount, &polygonIndices[0]);
 						if ( maxMaterialId != 0 )
 							face->material = maxMaterialId;
 						currentIndex += faceVertexCount;
@@ -985,7 +1001,7 @@ namespace COLLADAMax
 		for ( size_t i = 0, count = meshPrimitives.getCount(); i < count; ++i )
 		{
 			const COLLADAFW::MeshPrimitive* meshPrimitive = meshPrimitives[i];
-			const COLLADAFW::UIntValuesArray& normalIndices = meshPrimitive->getNormalIndices();
+			const COLLADAFW::IndexArray& normalIndices = meshPrimitive->getNormalIndexArray();
 
 
 			if (isSupportedMeshPrimitive(meshPrimitive))
@@ -1198,7 +1214,7 @@ namespace COLLADAMax
 	//------------------------------
 	void GeometryImporter::setPolygonMeshUVVerticesPerPrimitiveAndChannel( const COLLADAFW::MeshPrimitive* meshPrimitive,
 														 MNMap* meshMap,
-														 const COLLADAFW::UIntValuesArray& uvIndices,
+														 const COLLADAFW::IndexArray& uvIndices,
 														 unsigned int initialIndex,
 														 size_t& currentFaceIndex)
 	{
@@ -1496,7 +1512,7 @@ namespace COLLADAMax
 
 					unsigned int initialIndex = (unsigned int)uvIndexList.getInitialIndex();
 
-					const COLLADAFW::UIntValuesArray& uvIndices =  uvIndexList.getIndices();
+					const COLLADAFW::IndexArray& uvIndices =  uvIndexList.getIndexArray();
 
 					MNMap* meshMap = polygonMesh.M(mapChannel);
 
@@ -1521,7 +1537,7 @@ namespace COLLADAMax
 
 					unsigned int initialIndex = (unsigned int)colorIndexList.getInitialIndex();
 
-					const COLLADAFW::UIntValuesArray& colorIndices =  colorIndexList.getIndices();
+					const COLLADAFW::IndexArray& colorIndices =  colorIndexList.getIndexArray();
 
 					MNMap* meshMap = polygonMesh.M(mapChannel);
 
@@ -1722,10 +1738,10 @@ namespace COLLADAMax
 	}
 
 	bool GeometryImporter::skipMeshData( const COLLADAFW::MeshPrimitive* meshPrimitive,
-										 const COLLADAFW::UIntValuesArray& dataIndices,
+										 const COLLADAFW::IndexArray& dataIndices,
 										 size_t& faceIndex)
 	{
-		const COLLADAFW::UIntValuesArray& positionIndices = meshPrimitive->getPositionIndices();
+		const COLLADAFW::IndexArray& positionIndices = meshPrimitive->getPositionIndexArray();
 
 		size_t positionIndicesCount = positionIndices.getCount();
 
@@ -0,0 +1,145 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_BINARYARRAY_H__
+#define __COLLADASAXFWL_BINARYARRAY_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLXmlTypes.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	/** A reference to the values of a float array or the indices of a primitive, stored little endian
+	in a binary sidecar file instead of the document (see COLLADASW::BinaryArrayFile). It is read from
+	a binary_array element within a technique with profile PROFILE, e.g.
+	\<binary_array file="scene.bin" offset="1024" count="300" type="float32"/\>*/
+	class BinaryArray
+	{
+	public:
+		/** The types of the values in the file.*/
+		enum ValueType
+		{
+			VALUE_TYPE_FLOAT32,
+			VALUE_TYPE_FLOAT64,
+			VALUE_TYPE_UINT32,
+			VALUE_TYPE_UNKNOWN
+		};
+
+		/** The profile of the techniques containing binary_array elements.*/
+		static const char* PROFILE;
+
+		/** The name of the binary_array element.*/
+		static const char* ELEMENT_NAME;
+
+	private:
+		/** The uri of the sidecar file, relative to the document.*/
+		String mFile;
+
+		/** The offset of the first value in the file in bytes.*/
+		uint64 mOffset;
+
+		/** The number of values.*/
+		uint64 mCount;
+
+		/** The type of the values.*/
+		ValueType mValueType;
+
+	public:
+
+        /** Constructor. */
+		BinaryArray();
+
+        /** Destructor. */
+		virtual ~BinaryArray();
+
+		/** Reads the attributes of a binary_array element.
+		@return True, if all attributes are present and valid, false otherwise.*/
+		bool readAttributes( const GeneratedSaxParser::xmlChar** attributes );
+
+		/** The uri of the sidecar file, relative to the document.*/
+		const String& getFile() const { return mFile; }
+
+		/** The offset of the first value in the file in bytes.*/
+		uint64 getOffset() const { return mOffset; }
+
+		/** The number of values.*/
+		uint64 getCount() const { return mCount; }
+
+		/** The type of the values.*/
+		ValueType getValueType() const { return mValueType; }
+
+		/** The size of one value in bytes.*/
+		size_t getValueSize() const;
+
+		/** Returns the first value in @a fileData, which is the content of the sidecar file of
+		@a fileSize bytes, or 0, if the array exceeds the file.*/
+		const char* getValues( const char* fileData, size_t fileSize ) const;
+
+		/** True, if the offset in the file and the address of @a values, as returned by getValues(),
+		are multiples of the value size. Only aligned values can be used in place, others have to
+		be copied.*/
+		bool isAligned( const char* values ) const;
+
+		/** True, if the values are stored in the byte order of this machine, i.e. can be used in place.*/
+		static bool isNativeByteOrder();
+
+		/** Reads the value @a index from @a values, converted to @a TargetType.*/
+		template<class TargetType>
+		TargetType getValue( const char* values, size_t index ) const;
+
+	private:
+		/** Reads the @a index'th value of type @a Type from @a values, swapping the bytes if required.*/
+		template<class Type>
+		static Type readValue( const char* values, size_t index );
+	};
+
+
+	//------------------------------
+	template<class Type>
+	Type BinaryArray::readValue( const char* values, size_t index )
+	{
+		Type value;
+		const char* bytes = values + index * sizeof(Type);
+		char* valueBytes = (char*)&value;
+		if ( isNativeByteOrder() )
+		{
+			for ( size_t i = 0; i < sizeof(Type); ++i )
+				valueBytes[i] = bytes[i];
+		}
+		else
+		{
+			for ( size_t i = 0; i < sizeof(Type); ++i )
+				valueBytes[i] = bytes[sizeof(Type) - 1 - i];
+		}
+		return value;
+	}
+
+	//------------------------------
+	template<class TargetType>
+	TargetType BinaryArray::getValue( const char* values, size_t index ) const
+	{
+		switch ( mValueType )
+		{
+		case VALUE_TYPE_FLOAT32:
+			return (TargetType)readValue<float>( values, index );
+		case VALUE_TYPE_FLOAT64:
+			return (TargetType)readValue<double>( values, index );
+		case VALUE_TYPE_UINT32:
+			return (TargetType)readValue<uint32>( values, index );
+		default:
+			return TargetType();
+		}
+	}
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_BINARYARRAY_H__
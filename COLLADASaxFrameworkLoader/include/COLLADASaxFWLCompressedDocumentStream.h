@@ -0,0 +1,178 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_COMPRESSEDDOCUMENTSTREAM_H__
+#define __COLLADASAXFWL_COMPRESSEDDOCUMENTSTREAM_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADABUThread.h"
+
+#include "GeneratedSaxParserIInputStream.h"
+
+#include <vector>
+
+
+namespace COLLADABU
+{
+	class URI;
+}
+
+struct zzip_dir;
+struct zzip_file;
+
+
+namespace COLLADASaxFWL
+{
+
+	/** Input stream for COLLADA documents, that are stored gzip compressed (.dae.gz) or in a zae
+	archive (.zae). The document is inflated on a separate thread into a ring of fixed-size blocks,
+	that are passed to the xml parser as soon as they are filled. Decompression and parsing therefore
+	overlap and no temporary file is written.
+	For zae archives, the root document is taken from the dae_root element of manifest.xml. If the
+	archive does not contain a manifest, the first .dae file in the archive is used.*/
+	class CompressedDocumentStream : public GeneratedSaxParser::IInputStream, private COLLADABU::Thread
+	{
+	public:
+		/** The formats that can be read.*/
+		enum Format
+		{
+			FORMAT_NONE,	///< Not compressed. Not supported by this class.
+			FORMAT_GZIP,	///< gzip compressed document
+			FORMAT_ZAE		///< zae archive
+		};
+
+		/** The default size of each block in bytes.*/
+		static const size_t DEFAULT_BLOCK_SIZE = 64*1024;
+
+		/** The default number of blocks in the ring.*/
+		static const size_t DEFAULT_BLOCK_COUNT = 4;
+
+	private:
+		/** The format of the file.*/
+		Format mFormat;
+
+		/** The native path of the file.*/
+		String mFilePath;
+
+		/** The path of the root document within the zae archive.*/
+		String mRootDocumentPath;
+
+		/** The gzip file, if mFormat is FORMAT_GZIP.*/
+		void* mGzipFile;
+
+		/** The zae archive, if mFormat is FORMAT_ZAE.*/
+		zzip_dir* mZipDirectory;
+
+		/** The root document in the zae archive, if mFormat is FORMAT_ZAE.*/
+		zzip_file* mZipFile;
+
+		/** The size of each block.*/
+		size_t mBlockSize;
+
+		/** Memory of all blocks.*/
+		std::vector<char> mBlocks;
+
+		/** The number of valid bytes in each block.*/
+		std::vector<size_t> mBlockFillSizes;
+
+		/** Index of the block that is returned next by getNextBlock().*/
+		size_t mReadIndex;
+
+		/** Index of the block that is filled next by the decompression thread.*/
+		size_t mWriteIndex;
+
+		/** Number of filled blocks not yet released by the parser.*/
+		size_t mFilledBlockCount;
+
+		/** True, if the block at mReadIndex has been returned to the parser and has not been
+		released yet.*/
+		bool mIsReadBlockInUse;
+
+		/** Set by the decompression thread, when the end of the document has been reached.*/
+		bool mIsFinished;
+
+		/** Set by the decompression thread, if inflating the document failed.*/
+		bool mHasFailed;
+
+		/** Set, if the stream is destroyed, before the decompression thread has finished.*/
+		bool mIsAborted;
+
+		/** Protects the state shared by the two threads.*/
+		mutable COLLADABU::Mutex mMutex;
+
+		/** Signaled whenever a block has been filled or released.*/
+		COLLADABU::Condition mStateChanged;
+
+		/** A description of the error that occurred in open().*/
+		String mErrorMessage;
+
+	public:
+
+		/** Constructor. Call open() to start reading.
+		@param filePath The native path of the file to read.
+		@param format The format of the file.*/
+		CompressedDocumentStream( const String& filePath,
+								  Format format,
+								  size_t blockSize = DEFAULT_BLOCK_SIZE,
+								  size_t blockCount = DEFAULT_BLOCK_COUNT );
+
+		/** Destructor. Stops the decompression thread.*/
+		virtual ~CompressedDocumentStream();
+
+		/** Returns the format of the document referenced by @a uri, determined by the extension of
+		its path.*/
+		static Format getFormat( const COLLADABU::URI& uri );
+
+		/** Opens the file and starts the decompression thread.
+		@return True on success, false otherwise. In this case, getErrorMessage() describes the error.*/
+		bool open();
+
+		/** A description of the error that occurred in open().*/
+		const String& getErrorMessage() const { return mErrorMessage; }
+
+		/** The path of the root document within the zae archive.*/
+		const String& getRootDocumentPath() const { return mRootDocumentPath; }
+
+		virtual const char* getNextBlock( size_t& blockSize );
+
+		virtual bool hasFailed() const;
+
+	private:
+
+        /** Disable default copy ctor. */
+		CompressedDocumentStream( const CompressedDocumentStream& pre );
+
+        /** Disable default assignment operator. */
+		const CompressedDocumentStream& operator= ( const CompressedDocumentStream& pre );
+
+		/** Opens the root document of the zae archive.*/
+		bool openZae();
+
+		/** Determines the root document of the opened zae archive. Fails if the manifest has an empty
+		dae_root. Without a dae_root, the first dae file of the archive is used.*/
+		bool findZaeRootDocument();
+
+		/** Reads and inflates up to @a length bytes into @a buffer.
+		@return The number of bytes read, 0 at the end of the document or -1 on error, including a
+		truncated or damaged gzip stream.*/
+		int readCompressed( char* buffer, size_t length );
+
+		/** Stops the decompression thread and closes the file.*/
+		void close();
+
+		/** Fills the blocks, until the end of the document has been reached or the stream is aborted.*/
+		virtual void run();
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_COMPRESSEDDOCUMENTSTREAM_H__
@@ -0,0 +1,235 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_DOCUMENTSCANNER_H__
+#define __COLLADASAXFWL_DOCUMENTSCANNER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLSaxParserErrorHandler.h"
+#include "COLLADASaxFWLXmlTypes.h"
+
+#include "GeneratedSaxParserParser.h"
+
+#include <set>
+#include <vector>
+
+
+namespace COLLADASaxFWL
+{
+	class IErrorHandler;
+
+	/** Statistics of a COLLADA document, collected by DocumentScanner in one pass without creating
+	any framework objects. All array sizes are taken from the count attributes, the sizes of the p
+	elements are determined by counting the tokens, without converting them.*/
+	struct DocumentStatistics
+	{
+		/** Flags for each library element that might be present in a COLLADA document.*/
+		enum LibraryFlags
+		{
+			NO_LIBRARY                           = 0,
+			LIBRARY_ANIMATIONS                   = 1<< 0,
+			LIBRARY_ANIMATION_CLIPS              = 1<< 1,
+			LIBRARY_ARTICULATED_SYSTEMS          = 1<< 2,
+			LIBRARY_CAMERAS                      = 1<< 3,
+			LIBRARY_CONTROLLERS                  = 1<< 4,
+			LIBRARY_EFFECTS                      = 1<< 5,
+			LIBRARY_FORCE_FIELDS                 = 1<< 6,
+			LIBRARY_FORMULAS                     = 1<< 7,
+			LIBRARY_GEOMETRIES                   = 1<< 8,
+			LIBRARY_IMAGES                       = 1<< 9,
+			LIBRARY_JOINTS                       = 1<<10,
+			LIBRARY_KINEMATICS_MODELS            = 1<<11,
+			LIBRARY_KINEMATICS_SCENES            = 1<<12,
+			LIBRARY_LIGHTS                       = 1<<13,
+			LIBRARY_MATERIALS                    = 1<<14,
+			LIBRARY_NODES                        = 1<<15,
+			LIBRARY_PHYSICS_MATERIALS            = 1<<16,
+			LIBRARY_PHYSICS_MODELS               = 1<<17,
+			LIBRARY_PHYSICS_SCENES               = 1<<18,
+			LIBRARY_VISUAL_SCENES                = 1<<19
+		};
+
+		typedef std::set<String> StringSet;
+
+		/** Constructor. Sets all counters to zero.*/
+		DocumentStatistics();
+
+		/** Sets all counters to zero and clears all sets.*/
+		void reset();
+
+		/** The version of the collada document.*/
+		COLLADAVersion version;
+
+		/** Combination of LibraryFlags of all libraries found in the document.*/
+		int libraryFlags;
+
+		/** Number of elements in the document.*/
+		size_t elementCount;
+
+		/** Number of geometry elements.*/
+		size_t geometryCount;
+
+		/** Number of mesh elements.*/
+		size_t meshCount;
+
+		/** Number of mesh primitives (triangles, polylist, polygons, tristrips, trifans, lines, linestrips).*/
+		size_t primitiveCount;
+
+		/** Number of controller elements.*/
+		size_t controllerCount;
+
+		/** Number of animation elements.*/
+		size_t animationCount;
+
+		/** Number of node elements.*/
+		size_t nodeCount;
+
+		/** Number of image elements.*/
+		size_t imageCount;
+
+		/** Number of float_array elements.*/
+		size_t floatArrayCount;
+
+		/** Sum of the count attributes of all float_array elements.*/
+		size_t floatValueCount;
+
+		/** The largest count attribute of all float_array elements.*/
+		size_t maxFloatArrayValueCount;
+
+		/** Number of int_array elements.*/
+		size_t intArrayCount;
+
+		/** Sum of the count attributes of all int_array elements.*/
+		size_t intValueCount;
+
+		/** Number of p elements.*/
+		size_t pCount;
+
+		/** Number of indices in all p elements.*/
+		size_t indexCount;
+
+		/** Number of indices in the largest p element.*/
+		size_t maxPIndexCount;
+
+		/** Estimated number of triangles after triangulation of all primitives. It is calculated from the
+		count attribute of each primitive and the number of indices in its p elements.*/
+		size_t triangleEstimate;
+
+		/** The paths of all external COLLADA documents referenced by url or source attributes.*/
+		StringSet externalDocuments;
+
+		/** The paths of all image files referenced by images.*/
+		StringSet imageFiles;
+	};
+
+
+	/** Reads a COLLADA document once and collects DocumentStatistics. Only the element structure and
+	the attributes are evaluated. The character data of arrays is skipped without being converted,
+	which makes the scan much faster than loading the document with the Loader.*/
+	class DocumentScanner : public GeneratedSaxParser::Parser
+	{
+	private:
+		typedef std::vector<StringHash> StringHashStack;
+
+	private:
+		/** Passes the errors of the sax parser to the error handler, passed to the constructor.*/
+		SaxParserErrorHandler mSaxParserErrorHandler;
+
+		/** The statistics currently filled.*/
+		DocumentStatistics* mStatistics;
+
+		/** The hashes of all currently opened elements.*/
+		StringHashStack mElementStack;
+
+		/** The hash of the currently opened primitive element or 0 if no primitive is opened.*/
+		StringHash mCurrentPrimitive;
+
+		/** The count attribute of the currently opened primitive.*/
+		size_t mCurrentPrimitiveCount;
+
+		/** The largest offset of all inputs of the currently opened primitive.*/
+		size_t mCurrentPrimitiveMaxOffset;
+
+		/** The number of indices in all p elements of the currently opened primitive.*/
+		size_t mCurrentPrimitiveIndexCount;
+
+		/** The number of indices in the currently opened p element.*/
+		size_t mCurrentPIndexCount;
+
+		/** True, if the character data received last ended within a token.*/
+		bool mIsInToken;
+
+		/** True, if we are within a p element.*/
+		bool mIsInP;
+
+		/** True, if the character data of the current element is a path to an image file.*/
+		bool mIsInImagePath;
+
+		/** The character data received so far for the image file path.*/
+		String mImagePath;
+
+	public:
+
+		/** Constructor. */
+		DocumentScanner( IErrorHandler* errorHandler = 0 );
+
+		/** Destructor. */
+		virtual ~DocumentScanner();
+
+		/** Scans the file @a fileName and fills @a statistics.
+		@return True, if the document could be scanned, false otherwise.*/
+		bool scanDocument( const String& fileName, DocumentStatistics& statistics );
+
+		/** Scans the document in @a buffer and fills @a statistics.
+		@param uri The URI associated with the buffer.
+		@param buffer A pointer to a document buffer that should be scanned.
+		@param length The length of the buffer in bytes.
+		@return True, if the document could be scanned, false otherwise.*/
+		bool scanDocument( const String& uri, const char* buffer, int length, DocumentStatistics& statistics );
+
+		virtual bool elementBegin( const ParserChar* elementName, const ParserAttributes& attributes );
+
+		virtual bool elementEnd( const ParserChar* elementName );
+
+		virtual bool textData( const ParserChar* text, size_t textLength );
+
+	private:
+
+        /** Disable default copy ctor. */
+		DocumentScanner( const DocumentScanner& pre );
+
+        /** Disable default assignment operator. */
+		const DocumentScanner& operator= ( const DocumentScanner& pre );
+
+		/** Resets all intermediate data and starts filling @a statistics.*/
+		void beginScan( DocumentStatistics& statistics );
+
+		/** Evaluates the attributes of the COLLADA element.*/
+		void handleCOLLADAAttributes( const ParserAttributes& attributes );
+
+		/** Evaluates the attributes, that are relevant for the statistics, of the element with
+		@a elementHash.*/
+		void handleAttributes( StringHash elementHash, const ParserAttributes& attributes );
+
+		/** Adds the document referenced by @a uri to the external documents, if @a uri does not point
+		into the current document.*/
+		void addExternalReference( const ParserChar* uri );
+
+		/** Adds the triangles of the primitive that has just been closed to the triangle estimate.*/
+		void finishPrimitive();
+
+		/** Returns the hash of the parent of the currently opened element or 0 if it has no parent.*/
+		StringHash getParentElementHash() const;
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_DOCUMENTSCANNER_H__
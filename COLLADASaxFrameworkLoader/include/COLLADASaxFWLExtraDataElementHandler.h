@@ -17,6 +17,7 @@
 
 namespace COLLADASaxFWL
 {
+    class SourceArrayLoader;
 
     /** The element handler for the extra data preservation. */
     class ExtraDataElementHandler : public GeneratedSaxParser::IUnknownElementHandler 
@@ -30,6 +31,13 @@ namespace COLLADASaxFWL
         of the callback handlers has to be called. */
         bool* mCallbackHandlersCallingList;
 
+        /** Loads the binary arrays referenced within the technique currently parsed. 0 if the technique
+        does not have the binary array profile.*/
+        SourceArrayLoader* mBinaryArrayLoader;
+
+        /** True, while a binary_array element passed to mBinaryArrayLoader is open.*/
+        bool mIsInBinaryArray;
+
 	public:
 
         /** Constructor. */
@@ -47,6 +55,10 @@ namespace COLLADASaxFWL
         /** Set the flag, if the callback handler on the given index position should be called. */
         void setExtraDataCallbackHandlerCalling ( const size_t index, const bool calling );
 
+        /** Sets the loader the binary_array elements are passed to, instead of the extra data callback 
+        handlers. Set while a technique with profile BinaryArray::PROFILE is parsed, 0 otherwise.*/
+        void setBinaryArrayLoader ( SourceArrayLoader* binaryArrayLoader ) { mBinaryArrayLoader = binaryArrayLoader; }
+
         /** Implementation of IUnknownElementHandler. */
         virtual bool elementBegin( const ParserChar* elementName, const GeneratedSaxParser::xmlChar** attributes);
         virtual bool elementEnd(const ParserChar* elementName);
@@ -18,6 +18,7 @@
 #include "COLLADASaxFWLLoader.h"
 #include "COLLADASaxFWLExtraDataLoader.h"
 
+#include "COLLADAFWIWriter.h"
 #include "COLLADAFWUniqueId.h"
 #include "COLLADAFWInstanceController.h"
 
@@ -47,6 +48,7 @@ namespace COLLADAFW
 namespace COLLADABU
 {
 	class URI;
+	class MemoryMappedFile;
 }
 
 namespace COLLADASaxFWL
@@ -94,6 +96,10 @@ namespace COLLADASaxFWL
 		/** Returns the writer the data will be written to.*/
 		COLLADAFW::IWriter* writer();
 
+		/** Returns true, if the writer takes the ownership of the objects of kind @a objectKind,
+		that are passed to it, see COLLADAFW::IWriter::getOwnedObjects().*/
+		bool writerOwnsObjects( COLLADAFW::IWriter::ObjectKind objectKind );
+
 		/** Reports an error to the error handler. If this method returns true, the 
 		loader stops parsing immediately. If severity is not CRITICAL and this method 
 		returns true, the loader continues loading. */
@@ -180,6 +186,10 @@ namespace COLLADASaxFWL
 		/** Returns TextureMapId for @a semantic. Successive call with same semantic return the same TextureMapId.*/
 		COLLADAFW::TextureMapId getTextureMapIdBySematic( const String& semantic );
 
+		/** Returns the binary array file @a uri, mapped into memory, or 0 if it could not be mapped. The 
+		file stays mapped until the loader is destroyed.*/
+		const COLLADABU::MemoryMappedFile* getBinaryArrayFile( const COLLADABU::URI& uri );
+
 		/** Creates a new in the sid tree. Call this method for every collada element that has an sid or that has an id 
 		and can have children with sids. For every call of this method you have to call addToSidTree() when the element
 		is closed.
@@ -0,0 +1,79 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_IPASSTHROUGHHANDLER_H__
+#define __COLLADASAXFWL_IPASSTHROUGHHANDLER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLXmlTypes.h"
+
+
+namespace COLLADASaxFWL
+{
+	class PassThroughRewriter;
+
+	/** Decides, which elements of a document rewritten by PassThroughRewriter are copied unchanged and
+	which are modified. Only the elements whose start tag has been kept or replaced are passed to the
+	handler. Everything else is copied or removed without any handler call. New content is written with
+	PassThroughRewriter::write(). */
+	class IPassThroughHandler
+	{
+	public:
+		/** What to do with an element passed to elementBegin().*/
+		enum ElementAction
+		{
+			/** Copy the element with all its children verbatim. The children are not passed to the handler.*/
+			COPY_ELEMENT,
+
+			/** Remove the element with all its children. The data written by the handler in elementBegin()
+			replaces the element.*/
+			REMOVE_ELEMENT,
+
+			/** Copy the start and end tag verbatim. The children and the character data are passed to
+			the handler.*/
+			COPY_START_TAG,
+
+			/** Replace the start tag by the data written by the handler in elementBegin(). The written
+			start tag must not be an empty element tag; if the element is empty in the input, the rewriter
+			appends the end tag. The children and the character data are passed to the handler.*/
+			REPLACE_START_TAG
+		};
+
+	public:
+		IPassThroughHandler(){}
+		virtual ~IPassThroughHandler(){}
+
+		/** Called for each element whose parent start tag has been kept or replaced, starting with the
+		root element. Data written by the handler is placed in front of the element.
+		@return The action to perform on the element.*/
+		virtual ElementAction elementBegin( const ParserChar* elementName, const ParserAttributes& attributes, PassThroughRewriter& rewriter ) = 0;
+
+		/** Called at the end of each element elementBegin() returned COPY_START_TAG or REPLACE_START_TAG for.
+		Data written by the handler is appended to the content of the element, in front of its end tag.*/
+		virtual void elementEnd( const ParserChar* elementName, PassThroughRewriter& rewriter ) = 0;
+
+		/** Called for character data of elements elementBegin() returned COPY_START_TAG or
+		REPLACE_START_TAG for. The character data might be passed in several chunks. Data written by the
+		handler is placed in front of the character data.
+		@return True to keep the character data, false to remove it. If false is returned for one chunk,
+		the character data up to the next tag is removed, including the chunks already passed.*/
+		virtual bool textData( const ParserChar* text, size_t textLength, PassThroughRewriter& rewriter ) = 0;
+
+	private:
+        /** Disable default copy ctor. */
+		IPassThroughHandler( const IPassThroughHandler& pre );
+        /** Disable default assignment operator. */
+		const IPassThroughHandler& operator= ( const IPassThroughHandler& pre );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_IPASSTHROUGHHANDLER_H__
@@ -27,6 +27,7 @@
 #include "COLLADABUHashFunctions.h"
 #include "COLLADABUURI.h"
 #include "COLLADABUhash_map.h"
+#include "COLLADABUFlatHashMap.h"
 
 #include <set>
 
@@ -43,6 +44,11 @@ namespace COLLADAFW
 	class MorphController;
 }
 
+namespace COLLADABU
+{
+	class MemoryMappedFile;
+}
+
 
 namespace COLLADASaxFWL
 {
@@ -51,13 +57,14 @@ namespace COLLADASaxFWL
 	class DocumentProcessor;
 	class PostProcessor;
     class FileLoader;
+	class Tracer;
 
 
 	typedef std::list<String> StringList;
 
 	typedef std::list<COLLADABU::URI> URIList;
 
-	static StringList EMPTY_STRING_LIST = StringList();
+	static const StringList EMPTY_STRING_LIST = StringList();
 
 
 
@@ -92,6 +99,38 @@ namespace COLLADASaxFWL
 			ALL_OBJECTS_MASK           = (1<<16) - 1,
 		};
 
+		/** The precision the real values of meshes, animations and controllers are passed to the
+		writer with.*/
+		enum NumericPrecision
+		{
+			/** The values keep the type they have been parsed with.*/
+			PRECISION_KEEP,
+			/** Double values are converted to float. In the default build, in which
+			COLLADASAXFWL_REAL_IS_FLOAT is defined, all real values are parsed as float, so this
+			does nothing.*/
+			PRECISION_FLOAT,
+			/** As PRECISION_FLOAT, but additionally the positions and texture coordinates of meshes
+			are stored as 16 bit integers with a scale and a bias per component and source and the
+			normals as octahedral encoded 16 bit pairs, see COLLADAFW::QuantizedArray.*/
+			PRECISION_QUANTIZED
+		};
+
+		/** The largest absolute errors, that have been introduced by the numeric precision.*/
+		struct PrecisionErrors
+		{
+			/** The largest error of a mesh position coordinate.*/
+			double positions;
+			/** The largest error of a component of a mesh normal. Quantized normals are normalized,
+			so the error includes the change of the length of normals, that are not normalized.*/
+			double normals;
+			/** The largest error of a mesh texture coordinate.*/
+			double uvCoordinates;
+			/** The largest error of any other value, e.g. of animation curves or mesh colors.*/
+			double others;
+
+			PrecisionErrors() : positions(0), normals(0), uvCoordinates(0), others(0) {}
+		};
+
 	public:
 		typedef COLLADABU::hash_map<COLLADABU::URI, COLLADAFW::UniqueId> URIUniqueIdMap;
 
@@ -104,7 +143,10 @@ namespace COLLADASaxFWL
 		typedef std::map<String /*id*/, SidTreeNode*> IdStringSidTreeNodeMap;
 
 		/** Maps unique ids of animation list to the corresponding animation list.*/
-		typedef std::map< COLLADAFW::UniqueId , COLLADAFW::AnimationList* > UniqueIdAnimationListMap;
+		typedef COLLADABU::FlatHashMap< COLLADAFW::UniqueId , COLLADAFW::AnimationList* > UniqueIdAnimationListMap;
+
+		/** Maps the uri string of each binary array file to the file, mapped into memory.*/
+		typedef std::map<String, COLLADABU::MemoryMappedFile*> BinaryArrayFileMap;
 
 		/** List of visual scenes.*/
 		typedef std::vector<COLLADAFW::VisualScene*> VisualSceneList;
@@ -135,10 +177,10 @@ namespace COLLADASaxFWL
 		};
 
 		/** Maps unique ids of skin data to the sids or ids of the joints of this skin controller.*/
-		typedef std::map< COLLADAFW::UniqueId, JointSidsOrIds> SkinDataJointSidsMap;
+		typedef COLLADABU::FlatHashMap< COLLADAFW::UniqueId, JointSidsOrIds> SkinDataJointSidsMap;
 
 		/** Maps unique ids of skin data to the source uri string.*/
-		typedef std::map< COLLADAFW::UniqueId/*skin controller data*/, COLLADABU::URI/*source uri string*/> SkinDataSkinSourceMap;
+		typedef COLLADABU::FlatHashMap< COLLADAFW::UniqueId/*skin controller data*/, COLLADABU::URI/*source uri string*/> SkinDataSkinSourceMap;
 
 		/** Set of SkinControllers.*/
 		typedef std::set< COLLADAFW::SkinController, bool(*)(const COLLADAFW::SkinController& lhs, const COLLADAFW::SkinController& rhs)> SkinControllerSet;
@@ -158,12 +200,13 @@ namespace COLLADASaxFWL
 		data for skin controllers.*/
 		typedef std::list<InstanceControllerData> InstanceControllerDataList;
 
-		/** Maps each controller data unique id to the list of nodes instantiating it.*/
+		/** Maps each controller data unique id to the list of nodes instantiating it. This remains a std::map,
+		since NodeLoader keeps a pointer into the list while the map might be extended.*/
 		typedef std::map<COLLADAFW::UniqueId,InstanceControllerDataList> InstanceControllerDataListMap;
 
 
 		/** List of formulas.*/
-		typedef std::map<COLLADAFW::UniqueId, COLLADAFW::Formula*> UniqueIdFormulaMap;
+		typedef COLLADABU::FlatHashMap<COLLADAFW::UniqueId, COLLADAFW::Formula*> UniqueIdFormulaMap;
 
 		/** Contains the binding of an animation to the referenced object. Required to create animation lists*/
 		struct AnimationSidAddressBinding
@@ -260,7 +303,7 @@ namespace COLLADASaxFWL
 		completely been parsed.*/
 		CameraList mCameras;
 
-		/** List of all effects in the file. They are send to the writer and deleted, when the file has 
+		/** List of all morph controllers in the file. They are send to the writer and deleted, when the file has 
 		completely been parsed. This is required to assign animations of the morph weights.*/
 		MorphControllerList mMorphControllerList;
 
@@ -298,6 +341,26 @@ namespace COLLADASaxFWL
 		/** The call back function used to decide which filed should be leaded.*/
 		ExternalReferenceDeciderCallbackFunction mExternalReferenceDeciderCallbackFunction;
 
+		/** All binary array files referenced so far. They stay mapped until the loader is destroyed, 
+		since the framework arrays loaded from them point into the mapped memory.*/
+		BinaryArrayFileMap mBinaryArrayFiles;
+
+		/** The tracer the phases of the load are recorded with or 0, if tracing is disabled.*/
+		Tracer* mTracer;
+
+		/** True, if the index lists of meshes are packed before they are passed to the writer.*/
+		bool mPackMeshIndices;
+
+		/** The precision the real values are passed to the writer with.*/
+		NumericPrecision mNumericPrecision;
+
+		/** The largest errors, that have been introduced by mNumericPrecision.*/
+		PrecisionErrors mPrecisionErrors;
+
+		/** The kinds of objects held by the loader (see COLLADAFW::IWriter::ObjectKind), whose
+		ownership has been transferred to the writer. They are not deleted with the loader.*/
+		int mObjectsOwnedByWriter;
+
 	public:
 
         /** Constructor. */
@@ -347,6 +410,52 @@ namespace COLLADASaxFWL
 		*/
 		void registerExternalReferenceDeciderCallbackFunction( ExternalReferenceDeciderCallbackFunction externalReferenceDeciderCallbackFunction );
 
+		/** Sets the tracer the phases of the following loads are recorded with. The tracer is not owned
+		by the loader and must exist until loading has finished. Pass 0 to disable tracing.*/
+		void setTracer( Tracer* tracer ) { mTracer = tracer; }
+
+		/** The tracer the phases of the load are recorded with or 0, if tracing is disabled.*/
+		Tracer* getTracer() { return mTracer; }
+
+		/** If @a packMeshIndices is true, the index lists of meshes are stored with the smallest
+		width that can address their sources. The width is chosen from the sources of each primitive
+		before its indices are read. This reduces the memory of the indices to a half or a quarter
+		for most meshes. Writers that read the indices through getPositionIndices(), ... and
+		IndexList::getIndices() keep working, but these unpack the lists or widen them into copies.
+		To keep the saving, read them through MeshPrimitive::getPositionIndexArray(), ... and
+		IndexList::getIndexArray(). Disabled by default.*/
+		void setPackMeshIndices( bool packMeshIndices ) { mPackMeshIndices = packMeshIndices; }
+
+		/** True, if the index lists of meshes are packed before they are passed to the writer.*/
+		bool getPackMeshIndices() const { return mPackMeshIndices; }
+
+		/** Sets the precision the real values are passed to the writer with. The values of meshes
+		are converted as soon as their source is loaded into the mesh, while the primitives are
+		parsed, and the full precision values of the source are released. Each source is quantized
+		with a scale and bias of its own, see COLLADAFW::QuantizedArray::appendLinear(), so the
+		values of a mesh are encoded once, even if an input uses several sources. Other values are
+		converted when the object they belong to has been loaded. The converted values are the
+		only copy passed to the writer. PRECISION_FLOAT does nothing in the default build, see
+		COLLADASAXFWL_REAL_IS_FLOAT. The bounding box of a mesh is computed from the full precision
+		positions, the bounding boxes of its primitives from the quantized positions. With
+		PRECISION_QUANTIZED the quantized values are only passed to writers, whose
+		COLLADAFW::IWriter::acceptsQuantizedValues() returns true. For other writers they are
+		decoded to float values before the mesh is written, so the memory is only saved while the
+		mesh is loaded.
+		PRECISION_KEEP by default.*/
+		void setNumericPrecision( NumericPrecision numericPrecision ) { mNumericPrecision = numericPrecision; }
+
+		/** The precision the real values are passed to the writer with.*/
+		NumericPrecision getNumericPrecision() const { return mNumericPrecision; }
+
+		/** The largest errors, that have been introduced by the numeric precision in all documents
+		loaded so far.*/
+		const PrecisionErrors& getPrecisionErrors() const { return mPrecisionErrors; }
+
+		/** The largest errors, that have been introduced by the numeric precision in all documents
+		loaded so far.*/
+		PrecisionErrors& getPrecisionErrors() { return mPrecisionErrors; }
+
 
 		/** Returns the Uri the file id @a fileId was assigned to by getFileId(). If @a fileId has not been 
 		assigned to any Uri, an invalid uri is returned.*/
@@ -460,6 +569,10 @@ namespace COLLADASaxFWL
 		/** Set of all SkinController already created and written.*/
 		SkinControllerSet& getSkinControllerSet() { return mSkinControllerSet; }
 
+		/** Returns the binary array file @a uri, mapped into memory. The file is mapped, when it is
+		requested the first time. Returns 0, if the file could not be mapped.*/
+		const COLLADABU::MemoryMappedFile* getBinaryArrayFile( const COLLADABU::URI& uri );
+
 		/** Compares to SkinControllers. The comparison is suitable for using SkinController as key in stl
 		containers but has no deeper meaning. The unique id of the SkinControllers themselves is not
 		taken into account. Is basically compares if two SkinControllers describe exactly the same skin controller
@@ -469,6 +582,10 @@ namespace COLLADASaxFWL
 		/** Returns the writer the data will be written to.*/
 		COLLADAFW::IWriter* writer(){ return mWriter; }
 
+		/** Records, that the ownership of the objects of the kinds @a objectKinds, that are held by
+		the loader, has been transferred to the writer.*/
+		void addObjectsOwnedByWriter( int objectKinds ) { mObjectsOwnedByWriter |= objectKinds; }
+
 
         /** Disable default copy ctor. */
 		Loader( const Loader& pre );
@@ -181,6 +181,10 @@ namespace COLLADASaxFWL
         /** Returns the mesh that has just been loaded.*/
 		COLLADAFW::Mesh* getMesh() { return mMesh; }
 
+		/** Yields the ownership of the mesh, e.g. to the writer. The mesh will not be deleted by
+		the loader anymore.*/
+		void yieldMeshOwnerShip() { mMesh = 0; }
+
 		/** Sax callback function for the beginning of a source element.*/
 		virtual bool begin__source(const source__AttributeData& attributes);
 
@@ -231,6 +235,10 @@ namespace COLLADASaxFWL
 		/** Sax callback function for the data of a p within a triangles element element.*/
 		virtual bool data__p( const unsigned long long* data, size_t length );
 
+		/** Loads the indices of a triangles, polylist or lines element from a binary array, as if they
+		were contained in a p element. Binary arrays of sources are passed to the base class.*/
+		virtual bool loadBinaryArrayValues( const BinaryArray& binaryArray, const char* values );
+
 
 		/** Sax callback function for the beginning of a polylist element.*/
 		virtual bool begin__polylist( const polylist__AttributeData& attributeData );
@@ -364,6 +372,14 @@ namespace COLLADASaxFWL
 
 		/** Sets the offsets for the different semantics (positions normals etc)*/
 		void initializeOffsets();
+
+		/** If the loader packs mesh indices, chooses the width of the position, normal, tangent
+		and binormal indices of the current primitive from the number of values in the mesh.*/
+		void initializeIndexWidths();
+
+		/** Lets empty @a indices store new indices with the smallest width, that can address
+		@a valueCount values.*/
+		void initializeIndexWidth ( COLLADAFW::IndexArray& indices, size_t valueCount );
         void initializeTexCoordsOffset ();
         void initializeColorsOffset ();
         void initializeNormalsOffset ();
@@ -374,6 +390,10 @@ namespace COLLADASaxFWL
 		/** Writes all the indices in data into the indices array of the current mesh primitive.*/
 		bool writePrimitiveIndices ( const unsigned long long* data, size_t length );
 
+		/** Sets the bounding box of each primitive of the mesh to the positions referenced by its
+		position indices. Called once, after all primitives have been read.*/
+		void calculatePrimitiveBoundingBoxes();
+
         /**
          * Get the number of all indices in all p elements in the current primitive element.
          */
@@ -426,10 +446,15 @@ namespace COLLADASaxFWL
 
         /**
         * Appends the values of the source in the list with the dimension of source's stride.
+        * With a numeric precision other than Loader::PRECISION_KEEP, the values are converted
+        * while they are appended, see appendSourceValues(), and quantized with their stride as
+        * dimension, if @a quantize is true. The error is added to @a maxError.
         */
         bool appendVertexValues ( 
             SourceBase* sourceBase, 
-            COLLADAFW::MeshVertexData& vertexData );
+            COLLADAFW::MeshVertexData& vertexData,
+            double& maxError,
+            bool quantize );
     };
 }
 
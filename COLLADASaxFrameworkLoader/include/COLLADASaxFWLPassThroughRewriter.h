@@ -0,0 +1,181 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_PASSTHROUGHREWRITER_H__
+#define __COLLADASAXFWL_PASSTHROUGHREWRITER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLSaxParserErrorHandler.h"
+#include "COLLADASaxFWLIPassThroughHandler.h"
+#include "COLLADASaxFWLXmlTypes.h"
+
+#include "GeneratedSaxParserParser.h"
+
+#include <vector>
+
+
+namespace Common
+{
+	class Buffer;
+	class IBufferFlusher;
+}
+
+namespace COLLADASaxFWL
+{
+	class IErrorHandler;
+
+	/** Rewrites a document, e.g. to replace the asset, to remove a library or to remap some URLs,
+	without loading it into the framework. The input is parsed once and an IPassThroughHandler decides
+	which elements are changed. All other bytes are copied verbatim from the input to the output, using
+	the byte offsets reported by the sax parser. Large unchanged parts are passed to the output flusher
+	directly from the input memory, so no character data is converted or formatted.
+	Only documents encoded in UTF-8 (or ASCII) are supported. */
+	class PassThroughRewriter : public GeneratedSaxParser::Parser
+	{
+	private:
+		/** An element, whose start tag has been kept or replaced.*/
+		struct OpenElement
+		{
+			/** The offset of the start tag in the input.*/
+			size_t startTagOffset;
+
+			/** The offset behind the start tag in the input.*/
+			size_t startTagEnd;
+
+			/** True, if the element is an empty element tag in the input.*/
+			bool isEmpty;
+
+			/** True, if the start tag has been replaced by the handler.*/
+			bool startTagReplaced;
+		};
+
+		typedef std::vector<OpenElement> OpenElementStack;
+
+	private:
+		/** Passes the errors of the sax parser to the error handler, passed to the constructor.*/
+		SaxParserErrorHandler mSaxParserErrorHandler;
+
+		/** The handler that decides which elements are changed.*/
+		IPassThroughHandler* mHandler;
+
+		/** The document being rewritten.*/
+		const char* mInput;
+
+		/** The size of mInput in bytes.*/
+		size_t mInputLength;
+
+		/** The buffer the rewritten document is written to.*/
+		Common::Buffer* mOutput;
+
+		/** All input before this offset has either been copied to the output or removed.*/
+		size_t mPendingOffset;
+
+		/** Data written by the handler is inserted at this offset of the input.*/
+		size_t mInsertOffset;
+
+		/** The offset behind the last tag in the input that has been passed to the handler.*/
+		size_t mLastTagEnd;
+
+		/** The number of elements opened within an element that is copied or removed as a whole.*/
+		size_t mSkipDepth;
+
+		/** True, if the element currently skipped is removed, false if it is copied.*/
+		bool mIsRemovingSkippedElement;
+
+		/** True, if the handler removed the character data following mLastTagEnd.*/
+		bool mIsRemovingText;
+
+		/** True, if an empty element tag of the input has to be turned into a start tag, before the
+		handler writes content into the element.*/
+		bool mOpenEmptyElementOnWrite;
+
+		/** True, if an empty element tag of the input has been turned into a start tag, that needs a
+		matching end tag.*/
+		bool mNeedsEndTag;
+
+		/** True, if writing to the output failed.*/
+		bool mHasWriteError;
+
+		/** The elements whose children are passed to the handler.*/
+		OpenElementStack mOpenElements;
+
+	public:
+
+		/** Constructor.
+		@param handler The handler that decides which elements are changed.
+		@param errorHandler Receives the errors of the sax parser.*/
+		PassThroughRewriter( IPassThroughHandler* handler, IErrorHandler* errorHandler = 0 );
+
+		/** Destructor. */
+		virtual ~PassThroughRewriter();
+
+		/** Rewrites the file @a inputFileName to @a outputFileName. The input file is mapped into memory.
+		@return True on success, false otherwise.*/
+		bool rewrite( const String& inputFileName, const String& outputFileName );
+
+		/** Rewrites the document in @a buffer and passes the result to @a output.
+		@param uri The URI associated with the buffer, used in error messages.
+		@param buffer The document.
+		@param length The length of the document in bytes.
+		@param output Receives the rewritten document.
+		@return True on success, false otherwise.*/
+		bool rewrite( const String& uri, const char* buffer, size_t length, Common::IBufferFlusher* output );
+
+		/** Writes @a length bytes starting at @a data to the output. May only be called by the handler.
+		Where the data is placed depends on the handler method that is executed. The data is written as 
+		is, i.e. it must already be escaped XML.
+		@return True on success, false otherwise.*/
+		bool write( const char* data, size_t length );
+
+		/** Writes @a text to the output. @see write(const char*, size_t)*/
+		bool write( const String& text );
+
+		/** The number of elements currently opened, including the element passed to
+		IPassThroughHandler::elementBegin() or IPassThroughHandler::elementEnd().*/
+		size_t getDepth() const { return mOpenElements.size(); }
+
+		/** The start tag of the element currently passed to IPassThroughHandler::elementBegin() or
+		IPassThroughHandler::elementEnd(), as found in the input, e.g. to copy it partially when only one 
+		attribute is replaced.
+		@param length Receives the length of the start tag in bytes.
+		@return Pointer to the first byte of the start tag, i.e. the '<'.*/
+		const char* getCurrentStartTag( size_t& length ) const;
+
+		virtual bool elementBegin( const ParserChar* elementName, const ParserAttributes& attributes );
+
+		virtual bool elementEnd( const ParserChar* elementName );
+
+		virtual bool textData( const ParserChar* text, size_t textLength );
+
+	private:
+
+        /** Disable default copy ctor. */
+		PassThroughRewriter( const PassThroughRewriter& pre );
+
+        /** Disable default assignment operator. */
+		const PassThroughRewriter& operator= ( const PassThroughRewriter& pre );
+
+		/** Returns the offset of the '<' of the tag, that ends at @a tagEnd. */
+		size_t findTagStart( size_t tagEnd ) const;
+
+		/** Copies the input from mPendingOffset to @a offset to the output.*/
+		bool copyInput( size_t offset );
+
+		/** Copies @a length bytes starting at @a data to the output and records write errors.*/
+		bool copyToOutput( const char* data, size_t length );
+
+		/** Writes the end tag of @a elementName.*/
+		bool writeEndTag( const ParserChar* elementName );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_PASSTHROUGHREWRITER_H__
@@ -17,9 +17,12 @@
 #include "COLLADASaxFWLXmlTypes.h"
 #include "COLLADAFWFloatOrDoubleArray.h"
 
+#include "COLLADABUhash_map.h"
+
 
 namespace COLLADASaxFWL
 {
+	class BinaryArray;
 
     /** 
     Base class for elements, that contain source arrays. The derived classes need to implement 
@@ -32,6 +35,10 @@ namespace COLLADASaxFWL
 	public:
 		static const COLLADAFW::FloatOrDoubleArray::DataType DATA_TYPE_REAL;
 
+	private:
+		/** Maps the hash of a source id to the index of the source in mSourceArray.*/
+		typedef COLLADABU::hash_multimap<StringHash, size_t> SourceIndexMap;
+
 	protected:
 	
         /**
@@ -48,14 +55,39 @@ namespace COLLADASaxFWL
 		/** The id of the array being parsed.*/
 		String mCurrentArrayId;
 
+	private:
+		/** Index of all sources in mSourceArray by the hash of their ids. Used to resolve the inputs 
+		without comparing the id of each loaded source.*/
+		SourceIndexMap mSourceIndex;
+
+		/** The hash of mCurrentSourceId.*/
+		StringHash mCurrentSourceIdHash;
+
 	public:
 		/** Takes a null terminated string, that represents an uriFragment of URIFragmentType defined in the 
 		COLLADA XSD and returns the id it points to.*/
 		static String getIdFromURIFragmentType( const char* uriFragment );
 
+		/** Returns the first character of the id in the null terminated uriFragment @a uriFragment and
+		stores the number of its characters in @a idLength. Leading white spaces and the '#' are
+		skipped, the id ends at the first white space.*/
+		static const ParserChar* findIdInURIFragment( const ParserChar* uriFragment, size_t& idLength );
+
 		/** Copies the values contained in @a realSource into @a realsArray .*/
 		static void setRealValues( COLLADAFW::FloatOrDoubleArray& realsArray, const RealSource* realSource );
 
+		/** Lets @a target use the values of @a source without copying them. If @a source owns its values,
+		the ownership is passed to @a target. If the values are external, e.g. loaded from a binary array
+		file, @a target uses them as external data as well.*/
+		template<class Type>
+		static void moveValues( COLLADAFW::ArrayPrimitiveType<Type>& source, COLLADAFW::ArrayPrimitiveType<Type>& target );
+
+		/** Loads the values of the binary array referenced by the binary_array element with @a attributes.
+		Called by the ExtraDataElementHandler for each binary_array element within a technique with profile 
+		BinaryArray::PROFILE.
+		@return False, if parsing should be stopped.*/
+		bool loadBinaryArray( const GeneratedSaxParser::xmlChar** attributes );
+
 	protected:
 
         /** Constructor. */
@@ -69,6 +101,24 @@ namespace COLLADASaxFWL
 		are not copied, but the source number array is assignment to the @a floatOrDoubleArray array.*/
 		bool assignSourceValuesToFloatOrDoubleArray( SourceBase* source, COLLADAFW::FloatOrDoubleArray& floatOrDoubleArray);
 
+		/** Converts the double values in @a values to float, unless the numeric precision of the
+		loader is Loader::PRECISION_KEEP. The error of the conversion is added to the precision
+		errors of the loader as @a maxError, or as others, if @a maxError is 0.*/
+		void applyNumericPrecision( COLLADAFW::FloatOrDoubleArray& values, double* maxError = 0 );
+
+		/** Appends @a sourceValues, the values of a source, to @a values with the numeric precision
+		of the loader, which must not be Loader::PRECISION_KEEP, and releases @a sourceValues. With
+		Loader::PRECISION_QUANTIZED and a @a dimension other than 0, the values are quantized with
+		@a encoding and @a dimension as a segment of their own, see
+		COLLADAFW::QuantizedArray::appendLinear(), so the values of the sources appended before are
+		not encoded again. Otherwise, or if the values can not be quantized, they are appended as
+		float values, after quantized values of previous sources have been decoded. The error is
+		added to the precision errors of the loader as @a maxError.*/
+		void appendSourceValues( COLLADAFW::FloatArray& sourceValues, COLLADAFW::FloatOrDoubleArray& values, double& maxError,
+			COLLADAFW::QuantizedArray::Encoding encoding = COLLADAFW::QuantizedArray::ENCODING_LINEAR, size_t dimension = 0 );
+		void appendSourceValues( COLLADAFW::DoubleArray& sourceValues, COLLADAFW::FloatOrDoubleArray& values, double& maxError,
+			COLLADAFW::QuantizedArray::Encoding encoding = COLLADAFW::QuantizedArray::ENCODING_LINEAR, size_t dimension = 0 );
+
 		/** Returns the id of the source being parsed.*/
 		const String& getCurrentSourceId() const { return mCurrentSourceId; }
 
@@ -103,6 +153,19 @@ namespace COLLADASaxFWL
         */
         SourceBase* getSourceById ( const String& sourceId );
 
+		/** Returns the source with the id given by the first @a sourceIdLength characters of 
+		@a sourceId or 0 if it does not exist. @a sourceId does not need to be null terminated.*/
+		const SourceBase* getSourceById ( const ParserChar* sourceId, size_t sourceIdLength ) const;
+
+		/** Returns the source with the id given by the first @a sourceIdLength characters of 
+		@a sourceId or 0 if it does not exist. @a sourceId does not need to be null terminated.*/
+		SourceBase* getSourceById ( const ParserChar* sourceId, size_t sourceIdLength );
+
+		/** Takes a null terminated string, that represents an uriFragment of URIFragmentType defined in the 
+		COLLADA XSD and returns the source it points to or 0 if it does not exist. Unlike 
+		getSourceById( getIdFromURIFragmentType( uriFragment ) ), no temporary string is created.*/
+		SourceBase* getSourceByURIFragment( const ParserChar* uriFragment );
+
 		/** Handles the beginning of a source element. Should be called by derived classes, 
 		when an opening \<source\> tag is detected.*/
 		bool beginSource(const source__AttributeData& attributes);
@@ -119,6 +182,11 @@ namespace COLLADASaxFWL
 		template<class SourceType> 
 		SourceType* beginArray( uint64 count, const ParserChar* id );
 
+		/** Assigns the values of @a binaryArray, starting at @a values in the mapped binary array file, to
+		the current source. Derived classes override this to load binary arrays of other elements.
+		@return False, if parsing should be stopped.*/
+		virtual bool loadBinaryArrayValues( const BinaryArray& binaryArray, const char* values );
+
 
     public:
 		/** Sax callback function for the beginning of a float array element.*/
@@ -131,6 +199,14 @@ namespace COLLADASaxFWL
 		virtual bool data__float_array( const float* data, size_t length );
 
 
+		/** Sax callback function for the beginning of a technique element. Binary arrays are loaded from 
+		techniques with profile BinaryArray::PROFILE.*/
+		virtual bool begin__technique( const technique__AttributeData& attributeData );
+
+		/** Sax callback function for the ending of a technique element.*/
+		virtual bool end__technique();
+
+
 		/** Sax callback function for the beginning of a technique_common element.*/
 		virtual bool begin__animation__source__technique_common();
 
@@ -162,6 +238,13 @@ namespace COLLADASaxFWL
 
         /** Disable default assignment operator. */
 		const SourceArrayLoader& operator= ( const SourceArrayLoader& pre );
+
+		/** Rebuilds mSourceIndex from mSourceArray.*/
+		void rebuildSourceIndex();
+
+		template<class Type>
+		void appendSourceValuesTemplate( COLLADAFW::ArrayPrimitiveType<Type>& sourceValues, COLLADAFW::FloatOrDoubleArray& values, double& maxError,
+			COLLADAFW::QuantizedArray::Encoding encoding, size_t dimension );
 	};
 
 
@@ -178,6 +261,21 @@ namespace COLLADASaxFWL
 		return newSource;
 	}
 
+	//------------------------------
+	template<class Type>
+	void SourceArrayLoader::moveValues( COLLADAFW::ArrayPrimitiveType<Type>& source, COLLADAFW::ArrayPrimitiveType<Type>& target )
+	{
+		if ( source.hasExternalData() )
+		{
+			target.setExternalData( source.getData(), source.getCount() );
+		}
+		else
+		{
+			target.setData( source.getData(), source.getCount() );
+			source.yieldOwnerShip();
+		}
+	}
+
 
 
 } // namespace COLLADAFW
@@ -72,6 +72,10 @@ namespace COLLADASaxFWL
         /** Returns the mesh that has just been loaded.*/
 		COLLADAFW::Spline* getSpline() { return mSpline; }
 
+		/** Yields the ownership of the spline, e.g. to the writer. The spline will not be deleted
+		by the loader anymore.*/
+		void yieldSplineOwnerShip() { mSpline = 0; }
+
 		/** Sax callback function for the beginning of a source element.*/
 		virtual bool begin__source(const source__AttributeData& attributes);
 
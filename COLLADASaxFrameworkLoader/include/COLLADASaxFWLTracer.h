@@ -0,0 +1,186 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_TRACER_H__
+#define __COLLADASAXFWL_TRACER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADABUThread.h"
+
+#include <vector>
+#include <iosfwd>
+
+
+namespace COLLADASaxFWL
+{
+
+	/** Records the time the loader spends in its phases as spans and writes them in the Chrome trace
+	event format, to be viewed in chrome://tracing or Perfetto. Spans are recorded for the whole load,
+	each file, the setup of the version specific parser, each post processing stage and each call
+	of the writer. Each span also records the thread it ran on and the number of objects passed to
+	the writer while it was open.
+	Tracing is enabled by passing a tracer to Loader::setTracer(). Without a tracer, each span costs
+	a pointer comparison.*/
+	class Tracer
+	{
+	public:
+		/** A completed span.*/
+		struct Event
+		{
+			/** The name of the span.*/
+			const char* name;
+
+			/** The category of the span, e.g. "file" or "writer".*/
+			const char* category;
+
+			/** Additional information, e.g. the uri of the loaded file. Might be empty.*/
+			String detail;
+
+			/** The start time in microseconds since the tracer was created.*/
+			double start;
+
+			/** The duration in microseconds.*/
+			double duration;
+
+			/** The id of the thread the span was recorded on.*/
+			unsigned long threadId;
+
+			/** The number of objects passed to the writer while the span was open.*/
+			size_t objectCount;
+		};
+
+		typedef std::vector<Event> EventList;
+
+	private:
+		/** The time the tracer was created, in microseconds.*/
+		double mStartTime;
+
+		/** The completed spans in the order they were completed.*/
+		EventList mEvents;
+
+		/** Guards mEvents and mWrittenObjectCount, spans might be completed and objects might be
+		written on different threads.*/
+		mutable COLLADABU::Mutex mMutex;
+
+		/** The number of objects passed to the writer so far.*/
+		size_t mWrittenObjectCount;
+
+	public:
+
+        /** Constructor. */
+		Tracer();
+
+        /** Destructor. */
+		virtual ~Tracer();
+
+		/** The time elapsed since the tracer was created, in microseconds.*/
+		double getTime() const;
+
+		/** Adds a completed span.*/
+		void addEvent( const Event& event );
+
+		/** A copy of the completed spans in the order they were completed. A copy is returned, since
+		spans might be added by other threads meanwhile.*/
+		EventList getEvents() const;
+
+		/** Removes all completed spans.*/
+		void clear();
+
+		/** Counts an object passed to the writer.*/
+		void addWrittenObject();
+
+		/** The number of objects passed to the writer so far.*/
+		size_t getWrittenObjectCount() const;
+
+		/** Writes all completed spans as Chrome trace event JSON to @a stream.*/
+		void writeChromeTrace( std::ostream& stream ) const;
+
+		/** Writes all completed spans as Chrome trace event JSON to the file @a fileName.
+		@return True on success, false if the file could not be written.*/
+		bool writeChromeTrace( const String& fileName ) const;
+
+	private:
+
+        /** Disable default copy ctor. */
+		Tracer( const Tracer& pre );
+
+        /** Disable default assignment operator. */
+		const Tracer& operator= ( const Tracer& pre );
+
+		/** The time of a monotonic clock in microseconds.*/
+		static double getClockTime();
+
+	};
+
+
+	/** Records a span from its construction to its destruction. Does nothing, if the tracer is 0.*/
+	class TraceSpan
+	{
+	private:
+		/** The tracer the span is added to or 0.*/
+		Tracer* mTracer;
+
+		/** The name of the span.*/
+		const char* mName;
+
+		/** The category of the span.*/
+		const char* mCategory;
+
+		/** Additional information.*/
+		String mDetail;
+
+		/** The start time in microseconds.*/
+		double mStart;
+
+		/** The number of objects passed to the writer before the span was opened.*/
+		size_t mWrittenObjectCount;
+
+	public:
+
+		/** Opens the span. @a name and @a category must stay valid as long as the tracer.*/
+		TraceSpan( Tracer* tracer, const char* name, const char* category )
+			: mTracer( tracer )
+		{
+			if ( mTracer )
+				open( name, category );
+		}
+
+		/** Closes the span and adds it to the tracer.*/
+		~TraceSpan()
+		{
+			if ( mTracer )
+				close();
+		}
+
+		/** Sets additional information, e.g. the uri of the loaded file.*/
+		void setDetail( const String& detail )
+		{
+			if ( mTracer )
+				mDetail = detail;
+		}
+
+	private:
+
+        /** Disable default copy ctor. */
+		TraceSpan( const TraceSpan& pre );
+
+        /** Disable default assignment operator. */
+		const TraceSpan& operator= ( const TraceSpan& pre );
+
+		void open( const char* name, const char* category );
+
+		void close();
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_TRACER_H__
@@ -0,0 +1,96 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_TRACINGWRITER_H__
+#define __COLLADASAXFWL_TRACINGWRITER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADAFWIWriter.h"
+
+
+namespace COLLADASaxFWL
+{
+	class Tracer;
+
+	/** Passes all calls to another writer and records a span of category "writer" for each of them.
+	The loader puts it in front of the writer, if a tracer is set.*/
+	class TracingWriter : public COLLADAFW::IWriter
+	{
+	private:
+		/** The writer the calls are passed to.*/
+		COLLADAFW::IWriter* mWriter;
+
+		/** The tracer the spans are added to.*/
+		Tracer* mTracer;
+
+	public:
+
+        /** Constructor. */
+		TracingWriter( COLLADAFW::IWriter* writer, Tracer* tracer );
+
+        /** Destructor. */
+		virtual ~TracingWriter();
+
+		virtual void cancel( const COLLADAFW::String& errorMessage );
+
+		virtual void start();
+
+		virtual void finish();
+
+		virtual int getOwnedObjects() const;
+
+		virtual bool acceptsQuantizedValues() const;
+
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* asset );
+
+		virtual bool writeScene( const COLLADAFW::Scene* scene );
+
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* visualScene );
+
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes );
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry );
+
+		virtual bool writeMaterial( const COLLADAFW::Material* material );
+
+		virtual bool writeEffect( const COLLADAFW::Effect* effect );
+
+		virtual bool writeCamera( const COLLADAFW::Camera* camera );
+
+		virtual bool writeImage( const COLLADAFW::Image* image );
+
+		virtual bool writeLight( const COLLADAFW::Light* light );
+
+		virtual bool writeAnimation( const COLLADAFW::Animation* animation );
+
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* animationList );
+
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData );
+
+		virtual bool writeController( const COLLADAFW::Controller* controller );
+
+		virtual bool writeFormulas( const COLLADAFW::Formulas* formulas );
+
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene );
+
+	private:
+
+        /** Disable default copy ctor. */
+		TracingWriter( const TracingWriter& pre );
+
+        /** Disable default assignment operator. */
+		const TracingWriter& operator= ( const TracingWriter& pre );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_TRACINGWRITER_H__
@@ -38,6 +38,8 @@ namespace COLLADASaxFWL
 		if ( (getObjectFlags() & Loader::ASSET_FLAG) != 0 )
 		{
 			success = writer()->writeGlobalAsset ( mAsset );
+			if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_GLOBAL_ASSET ) )
+				mAsset = 0;
 		}
 		delete mAsset;
 		finish();
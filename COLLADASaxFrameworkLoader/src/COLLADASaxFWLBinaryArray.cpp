@@ -0,0 +1,122 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLBinaryArray.h"
+
+#include <cstring>
+
+
+namespace COLLADASaxFWL
+{
+
+	const char* BinaryArray::PROFILE = "OpenCOLLADA";
+	const char* BinaryArray::ELEMENT_NAME = "binary_array";
+
+	//------------------------------
+	BinaryArray::BinaryArray()
+		: mOffset(0)
+		, mCount(0)
+		, mValueType(VALUE_TYPE_UNKNOWN)
+	{
+	}
+
+	//------------------------------
+	BinaryArray::~BinaryArray()
+	{
+	}
+
+	//------------------------------
+	bool BinaryArray::readAttributes( const GeneratedSaxParser::xmlChar** attributes )
+	{
+		bool hasFile = false;
+		bool hasOffset = false;
+		bool hasCount = false;
+		mValueType = VALUE_TYPE_UNKNOWN;
+
+		if ( !attributes )
+			return false;
+
+		for ( ; attributes[0] && attributes[1]; attributes += 2 )
+		{
+			const ParserChar* name = attributes[0];
+			const ParserChar* value = attributes[1];
+			bool failed = false;
+			if ( strcmp( name, "file" ) == 0 )
+			{
+				mFile = value;
+				hasFile = !mFile.empty();
+			}
+			else if ( strcmp( name, "offset" ) == 0 )
+			{
+				mOffset = Utils::toUint64( value, failed );
+				hasOffset = !failed;
+			}
+			else if ( strcmp( name, "count" ) == 0 )
+			{
+				mCount = Utils::toUint64( value, failed );
+				hasCount = !failed;
+			}
+			else if ( strcmp( name, "type" ) == 0 )
+			{
+				if ( strcmp( value, "float32" ) == 0 )
+					mValueType = VALUE_TYPE_FLOAT32;
+				else if ( strcmp( value, "float64" ) == 0 )
+					mValueType = VALUE_TYPE_FLOAT64;
+				else if ( strcmp( value, "uint32" ) == 0 )
+					mValueType = VALUE_TYPE_UINT32;
+			}
+		}
+		return hasFile && hasOffset && hasCount && ( mValueType != VALUE_TYPE_UNKNOWN );
+	}
+
+	//------------------------------
+	size_t BinaryArray::getValueSize() const
+	{
+		switch ( mValueType )
+		{
+		case VALUE_TYPE_FLOAT32:
+			return sizeof(float);
+		case VALUE_TYPE_FLOAT64:
+			return sizeof(double);
+		case VALUE_TYPE_UINT32:
+			return sizeof(uint32);
+		default:
+			return 0;
+		}
+	}
+
+	//------------------------------
+	const char* BinaryArray::getValues( const char* fileData, size_t fileSize ) const
+	{
+		size_t valueSize = getValueSize();
+		if ( !fileData || valueSize == 0 || mOffset > fileSize )
+			return 0;
+		// compare without multiplying, which might overflow
+		if ( mCount > ( fileSize - mOffset ) / valueSize )
+			return 0;
+		return fileData + mOffset;
+	}
+
+	//------------------------------
+	bool BinaryArray::isAligned( const char* values ) const
+	{
+		size_t valueSize = getValueSize();
+		return ( valueSize != 0 ) && ( mOffset % valueSize == 0 ) && ( (size_t)values % valueSize == 0 );
+	}
+
+	//------------------------------
+	bool BinaryArray::isNativeByteOrder()
+	{
+		const uint32 one = 1;
+		return *(const unsigned char*)&one == 1;
+	}
+
+} // namespace COLLADASaxFWL
@@ -0,0 +1,315 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLCompressedDocumentStream.h"
+
+#include "COLLADABUURI.h"
+#include "COLLADABUUtils.h"
+
+#include "zlib.h"
+#include "zzip/zzip.h"
+
+#include <fcntl.h>
+
+
+namespace COLLADASaxFWL
+{
+
+	const char GZIP_EXTENSION[] = ".gz";
+	const char ZAE_EXTENSION[] = ".zae";
+	const char DAE_EXTENSION[] = ".dae";
+	const char ZAE_MANIFEST_PATH[] = "manifest.xml";
+	const char ZAE_DAE_ROOT_BEGIN[] = "<dae_root>";
+	const char ZAE_DAE_ROOT_END[] = "</dae_root>";
+	const char ZAE_DAE_ROOT_EMPTY[] = "<dae_root/>";
+	const char WHITESPACES[] = " \t\r\n";
+
+	//------------------------------
+	CompressedDocumentStream::CompressedDocumentStream( const String& filePath,
+														Format format,
+														size_t blockSize,
+														size_t blockCount )
+		: mFormat( format )
+		, mFilePath( filePath )
+		, mGzipFile( 0 )
+		, mZipDirectory( 0 )
+		, mZipFile( 0 )
+		, mBlockSize( blockSize )
+		, mBlocks( blockSize * blockCount )
+		, mBlockFillSizes( blockCount, 0 )
+		, mReadIndex( 0 )
+		, mWriteIndex( 0 )
+		, mFilledBlockCount( 0 )
+		, mIsReadBlockInUse( false )
+		, mIsFinished( false )
+		, mHasFailed( false )
+		, mIsAborted( false )
+	{
+		COLLADABU_ASSERT( blockSize > 0 && blockCount > 0 );
+	}
+
+	//------------------------------
+	CompressedDocumentStream::~CompressedDocumentStream()
+	{
+		close();
+	}
+
+	//------------------------------
+	static bool hasSuffix( const String& path, const char* suffix, size_t suffixLength )
+	{
+		if ( path.length() < suffixLength )
+			return false;
+		return COLLADABU::Utils::equalsIgnoreCase( path.substr( path.length() - suffixLength ), suffix );
+	}
+
+	//------------------------------
+	CompressedDocumentStream::Format CompressedDocumentStream::getFormat( const COLLADABU::URI& uri )
+	{
+		// URI::getPathExtension() returns everything after the first dot, i.e. "dae.gz"
+		const String& path = uri.getPath();
+		if ( hasSuffix( path, GZIP_EXTENSION, sizeof(GZIP_EXTENSION) - 1 ) )
+			return FORMAT_GZIP;
+		if ( hasSuffix( path, ZAE_EXTENSION, sizeof(ZAE_EXTENSION) - 1 ) )
+			return FORMAT_ZAE;
+		return FORMAT_NONE;
+	}
+
+	//------------------------------
+	bool CompressedDocumentStream::open()
+	{
+		switch ( mFormat )
+		{
+		case FORMAT_GZIP:
+			mGzipFile = gzopen( mFilePath.c_str(), "rb" );
+			if ( !mGzipFile )
+			{
+				mErrorMessage = "Could not open gzip file " + mFilePath;
+				return false;
+			}
+			break;
+		case FORMAT_ZAE:
+			if ( !openZae() )
+				return false;
+			break;
+		default:
+			mErrorMessage = "Unsupported format of file " + mFilePath;
+			return false;
+		}
+
+		if ( !start() )
+		{
+			mErrorMessage = "Could not start decompression thread";
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	bool CompressedDocumentStream::openZae()
+	{
+		zzip_error_t error = ZZIP_NO_ERROR;
+		mZipDirectory = zzip_dir_open( mFilePath.c_str(), &error );
+		if ( !mZipDirectory )
+		{
+			mErrorMessage = "Could not open zae archive " + mFilePath + ": " + zzip_strerror( error );
+			return false;
+		}
+
+		if ( !findZaeRootDocument() )
+			return false;
+
+		mZipFile = zzip_file_open( mZipDirectory, mRootDocumentPath.c_str(), O_RDONLY );
+		if ( !mZipFile )
+		{
+			mErrorMessage = "Could not open " + mRootDocumentPath + " in zae archive " + mFilePath;
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	bool CompressedDocumentStream::findZaeRootDocument()
+	{
+		ZZIP_FILE* manifestFile = zzip_file_open( mZipDirectory, ZAE_MANIFEST_PATH, O_RDONLY );
+		if ( manifestFile )
+		{
+			String manifest;
+			char buffer[1024];
+			zzip_ssize_t readBytes;
+			while ( (readBytes = zzip_read( manifestFile, buffer, sizeof(buffer) )) > 0 )
+				manifest.append( buffer, (size_t)readBytes );
+			zzip_file_close( manifestFile );
+
+			size_t begin = manifest.find( ZAE_DAE_ROOT_BEGIN );
+			size_t end = manifest.find( ZAE_DAE_ROOT_END );
+			if ( begin != String::npos || end != String::npos || manifest.find( ZAE_DAE_ROOT_EMPTY ) != String::npos )
+			{
+				// a manifest with a dae_root element has to name the root document
+				String rootPath;
+				if ( begin != String::npos && end != String::npos )
+				{
+					begin = manifest.find_first_not_of( WHITESPACES, begin + sizeof(ZAE_DAE_ROOT_BEGIN) - 1 );
+					if ( begin < end )
+					{
+						end = manifest.find_last_not_of( WHITESPACES, end - 1 ) + 1;
+						rootPath = manifest.substr( begin, end - begin );
+					}
+				}
+
+				// the dae_root is an uri relative to the archive root, that might reference a node
+				size_t fragmentPos = rootPath.find( '#' );
+				if ( fragmentPos != String::npos )
+					rootPath.erase( fragmentPos );
+				if ( rootPath.compare( 0, 2, "./" ) == 0 )
+					rootPath.erase( 0, 2 );
+				if ( rootPath.empty() )
+				{
+					mErrorMessage = "Empty or malformed dae_root in " + String(ZAE_MANIFEST_PATH) + " of zae archive " + mFilePath;
+					return false;
+				}
+				mRootDocumentPath = COLLADABU::URI::uriDecode( rootPath );
+				return true;
+			}
+		}
+
+		// no usable manifest. Take the first dae file in the archive.
+		ZZIP_DIRENT entry;
+		while ( zzip_dir_read( mZipDirectory, &entry ) )
+		{
+			if ( hasSuffix( entry.d_name, DAE_EXTENSION, sizeof(DAE_EXTENSION) - 1 ) )
+			{
+				mRootDocumentPath = entry.d_name;
+				return true;
+			}
+		}
+
+		mErrorMessage = "Could not find the root document in zae archive " + mFilePath;
+		return false;
+	}
+
+	//------------------------------
+	int CompressedDocumentStream::readCompressed( char* buffer, size_t length )
+	{
+		if ( mGzipFile )
+		{
+			int readBytes = gzread( (gzFile)mGzipFile, buffer, (unsigned int)length );
+			if ( readBytes == 0 )
+			{
+				// gzread() reports a truncated stream or a damaged trailer as end of file
+				int errorNumber = Z_OK;
+				gzerror( (gzFile)mGzipFile, &errorNumber );
+				if ( (errorNumber == Z_BUF_ERROR) || (errorNumber == Z_DATA_ERROR) )
+					return -1;
+			}
+			return readBytes;
+		}
+		if ( mZipFile )
+			return (int)zzip_read( mZipFile, buffer, length );
+		return -1;
+	}
+
+	//------------------------------
+	void CompressedDocumentStream::run()
+	{
+		for (;;)
+		{
+			size_t blockIndex;
+			{
+				COLLADABU::ScopedLock lock( mMutex );
+				while ( (mFilledBlockCount == mBlockFillSizes.size()) && !mIsAborted )
+					mStateChanged.wait( mMutex );
+				if ( mIsAborted )
+					return;
+				blockIndex = mWriteIndex;
+			}
+
+			// The block at mWriteIndex is not filled, so the parser does not access it.
+			// Inflate without holding the lock.
+			int readBytes = readCompressed( &mBlocks[blockIndex * mBlockSize], mBlockSize );
+
+			COLLADABU::ScopedLock lock( mMutex );
+			if ( readBytes <= 0 )
+			{
+				mIsFinished = true;
+				mHasFailed = ( readBytes < 0 );
+				mStateChanged.broadcast();
+				return;
+			}
+			mBlockFillSizes[blockIndex] = (size_t)readBytes;
+			mWriteIndex = (mWriteIndex + 1) % mBlockFillSizes.size();
+			++mFilledBlockCount;
+			mStateChanged.broadcast();
+		}
+	}
+
+	//------------------------------
+	const char* CompressedDocumentStream::getNextBlock( size_t& blockSize )
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+
+		// release the block returned by the previous call
+		if ( mIsReadBlockInUse )
+		{
+			mIsReadBlockInUse = false;
+			mReadIndex = (mReadIndex + 1) % mBlockFillSizes.size();
+			--mFilledBlockCount;
+			mStateChanged.broadcast();
+		}
+
+		while ( (mFilledBlockCount == 0) && !mIsFinished && isStarted() )
+			mStateChanged.wait( mMutex );
+
+		if ( mFilledBlockCount == 0 || mHasFailed )
+		{
+			blockSize = 0;
+			return 0;
+		}
+
+		mIsReadBlockInUse = true;
+		blockSize = mBlockFillSizes[mReadIndex];
+		return &mBlocks[mReadIndex * mBlockSize];
+	}
+
+	//------------------------------
+	bool CompressedDocumentStream::hasFailed() const
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		return mHasFailed;
+	}
+
+	//------------------------------
+	void CompressedDocumentStream::close()
+	{
+		{
+			COLLADABU::ScopedLock lock( mMutex );
+			mIsAborted = true;
+			mStateChanged.broadcast();
+		}
+		join();
+
+		if ( mGzipFile )
+		{
+			gzclose( (gzFile)mGzipFile );
+			mGzipFile = 0;
+		}
+		if ( mZipFile )
+		{
+			zzip_file_close( mZipFile );
+			mZipFile = 0;
+		}
+		if ( mZipDirectory )
+		{
+			zzip_dir_close( mZipDirectory );
+			mZipDirectory = 0;
+		}
+	}
+
+} // namespace COLLADASAXFWL
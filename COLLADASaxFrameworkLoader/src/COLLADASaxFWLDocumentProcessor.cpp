@@ -396,7 +396,11 @@ namespace COLLADASaxFWL
 		if ( skinControllerIt == mSkinControllerSet.end() )
 		{
 			skinControllerToWrite = &skinController;
-			success = writer()->writeController(skinControllerToWrite);
+			// the skin controller lives on the stack, so a writer that owns the controllers gets a copy
+			if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_CONTROLLER ) )
+				success = writer()->writeController( FW_NEW COLLADAFW::SkinController( skinController ) );
+			else
+				success = writer()->writeController(skinControllerToWrite);
 			mSkinControllerSet.insert( skinController );
 		}
 		else
@@ -0,0 +1,495 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLDocumentScanner.h"
+
+#include "GeneratedSaxParserUtils.h"
+
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+#	include "GeneratedSaxParserLibxmlSaxParser.h"
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+#	include "GeneratedSaxParserExpatSaxParser.h"
+#else
+#	error "No prepocesser flag set to chose the xml parser to use"
+#endif
+
+
+namespace COLLADASaxFWL
+{
+	namespace
+	{
+		const size_t SCANNER_XMLPARSER_BUFFERSIZE = 64*1024;
+
+		const StringHash HASH_NAMESPACE_COLLADA_14 = 221035537;
+		const StringHash HASH_NAMESPACE_COLLADA_15 = 234671633;
+		const StringHash HASH_ATTRIBUTE_XMLNS = 8340307;
+		const StringHash HASH_ATTRIBUTE_COUNT = 6974548;
+		const StringHash HASH_ATTRIBUTE_OFFSET = 123525572;
+		const StringHash HASH_ATTRIBUTE_URL = 31884;
+		const StringHash HASH_ATTRIBUTE_SOURCE = 128370837;
+
+		const StringHash HASH_ELEMENT_COLLADA = 138479041;
+		const StringHash HASH_ELEMENT_GEOMETRY = 207867209;
+		const StringHash HASH_ELEMENT_MESH = 474264;
+		const StringHash HASH_ELEMENT_CONTROLLER = 194286738;
+		const StringHash HASH_ELEMENT_ANIMATION = 3721230;
+		const StringHash HASH_ELEMENT_NODE = 480677;
+		const StringHash HASH_ELEMENT_IMAGE = 7354325;
+		const StringHash HASH_ELEMENT_INIT_FROM = 10856717;
+		const StringHash HASH_ELEMENT_REF = 30902;
+		const StringHash HASH_ELEMENT_FLOAT_ARRAY = 171289865;
+		const StringHash HASH_ELEMENT_INT_ARRAY = 173598937;
+		const StringHash HASH_ELEMENT_INPUT = 7362500;
+		const StringHash HASH_ELEMENT_P = 112;
+		const StringHash HASH_ELEMENT_TRIANGLES = 260356419;
+		const StringHash HASH_ELEMENT_POLYLIST = 104871892;
+		const StringHash HASH_ELEMENT_POLYGONS = 104850211;
+		const StringHash HASH_ELEMENT_TRISTRIPS = 11275235;
+		const StringHash HASH_ELEMENT_TRIFANS = 193972259;
+		const StringHash HASH_ELEMENT_LINES = 7537859;
+		const StringHash HASH_ELEMENT_LINESTRIPS = 212647987;
+
+		struct LibraryHashFlagPair
+		{
+			StringHash hash;
+			DocumentStatistics::LibraryFlags flag;
+		};
+
+		const LibraryHashFlagPair LIBRARY_HASH_FLAG_PAIRS[] =
+		{
+			{ 223353555, DocumentStatistics::LIBRARY_ANIMATIONS },
+			{ 210579923, DocumentStatistics::LIBRARY_ANIMATION_CLIPS },
+			{ 177341699, DocumentStatistics::LIBRARY_ARTICULATED_SYSTEMS },
+			{ 17507619,  DocumentStatistics::LIBRARY_CAMERAS },
+			{ 117752259, DocumentStatistics::LIBRARY_CONTROLLERS },
+			{ 38033171,  DocumentStatistics::LIBRARY_EFFECTS },
+			{ 262260019, DocumentStatistics::LIBRARY_FORCE_FIELDS },
+			{ 236615907, DocumentStatistics::LIBRARY_FORMULAS },
+			{ 219269923, DocumentStatistics::LIBRARY_GEOMETRIES },
+			{ 175895315, DocumentStatistics::LIBRARY_IMAGES },
+			{ 195922787, DocumentStatistics::LIBRARY_JOINTS },
+			{ 202890947, DocumentStatistics::LIBRARY_KINEMATICS_MODELS },
+			{ 145478195, DocumentStatistics::LIBRARY_KINEMATICS_SCENES },
+			{ 196563299, DocumentStatistics::LIBRARY_LIGHTS },
+			{ 35999283,  DocumentStatistics::LIBRARY_MATERIALS },
+			{ 230609443, DocumentStatistics::LIBRARY_NODES },
+			{ 149953987, DocumentStatistics::LIBRARY_PHYSICS_MATERIALS },
+			{ 247630259, DocumentStatistics::LIBRARY_PHYSICS_MODELS },
+			{ 236889923, DocumentStatistics::LIBRARY_PHYSICS_SCENES },
+			{ 1834835,   DocumentStatistics::LIBRARY_VISUAL_SCENES }
+		};
+
+		const size_t LIBRARY_HASH_FLAG_PAIRS_SIZE = sizeof(LIBRARY_HASH_FLAG_PAIRS)/sizeof(LibraryHashFlagPair);
+
+		//------------------------------
+		bool isPrimitive( StringHash elementHash )
+		{
+			switch ( elementHash )
+			{
+			case HASH_ELEMENT_TRIANGLES:
+			case HASH_ELEMENT_POLYLIST:
+			case HASH_ELEMENT_POLYGONS:
+			case HASH_ELEMENT_TRISTRIPS:
+			case HASH_ELEMENT_TRIFANS:
+			case HASH_ELEMENT_LINES:
+			case HASH_ELEMENT_LINESTRIPS:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		//------------------------------
+		size_t toCount( const ParserChar* attributeValue )
+		{
+			bool failed = false;
+			uint64 count = Utils::toUint64( attributeValue, failed );
+			return failed ? 0 : (size_t)count;
+		}
+	}
+
+	//------------------------------
+	DocumentStatistics::DocumentStatistics()
+	{
+		reset();
+	}
+
+	//------------------------------
+	void DocumentStatistics::reset()
+	{
+		version = COLLADA_UNKNOWN;
+		libraryFlags = NO_LIBRARY;
+		elementCount = 0;
+		geometryCount = 0;
+		meshCount = 0;
+		primitiveCount = 0;
+		controllerCount = 0;
+		animationCount = 0;
+		nodeCount = 0;
+		imageCount = 0;
+		floatArrayCount = 0;
+		floatValueCount = 0;
+		maxFloatArrayValueCount = 0;
+		intArrayCount = 0;
+		intValueCount = 0;
+		pCount = 0;
+		indexCount = 0;
+		maxPIndexCount = 0;
+		triangleEstimate = 0;
+		externalDocuments.clear();
+		imageFiles.clear();
+	}
+
+	//------------------------------
+	DocumentScanner::DocumentScanner( IErrorHandler* errorHandler )
+		: GeneratedSaxParser::Parser( &mSaxParserErrorHandler )
+		, mSaxParserErrorHandler( errorHandler )
+		, mStatistics( 0 )
+		, mCurrentPrimitive( 0 )
+		, mCurrentPrimitiveCount( 0 )
+		, mCurrentPrimitiveMaxOffset( 0 )
+		, mCurrentPrimitiveIndexCount( 0 )
+		, mCurrentPIndexCount( 0 )
+		, mIsInToken( false )
+		, mIsInP( false )
+		, mIsInImagePath( false )
+	{
+	}
+
+	//------------------------------
+	DocumentScanner::~DocumentScanner()
+	{
+	}
+
+	//------------------------------
+	void DocumentScanner::beginScan( DocumentStatistics& statistics )
+	{
+		statistics.reset();
+		mStatistics = &statistics;
+		mElementStack.clear();
+		mCurrentPrimitive = 0;
+		mCurrentPrimitiveCount = 0;
+		mCurrentPrimitiveMaxOffset = 0;
+		mCurrentPrimitiveIndexCount = 0;
+		mCurrentPIndexCount = 0;
+		mIsInToken = false;
+		mIsInP = false;
+		mIsInImagePath = false;
+		mImagePath.clear();
+	}
+
+	//------------------------------
+	bool DocumentScanner::scanDocument( const String& fileName, DocumentStatistics& statistics )
+	{
+		beginScan( statistics );
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+		GeneratedSaxParser::LibxmlSaxParser saxParser( this );
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+		GeneratedSaxParser::ExpatSaxParser saxParser( this, SCANNER_XMLPARSER_BUFFERSIZE );
+#endif
+		bool success = saxParser.parseFile( fileName.c_str() );
+		mStatistics = 0;
+		return success && !mSaxParserErrorHandler.hasCriticalError();
+	}
+
+	//------------------------------
+	bool DocumentScanner::scanDocument( const String& uri, const char* buffer, int length, DocumentStatistics& statistics )
+	{
+		beginScan( statistics );
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+		GeneratedSaxParser::LibxmlSaxParser saxParser( this );
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+		GeneratedSaxParser::ExpatSaxParser saxParser( this, SCANNER_XMLPARSER_BUFFERSIZE );
+#endif
+		bool success = saxParser.parseBuffer( uri.c_str(), buffer, length );
+		mStatistics = 0;
+		return success && !mSaxParserErrorHandler.hasCriticalError();
+	}
+
+	//------------------------------
+	StringHash DocumentScanner::getParentElementHash() const
+	{
+		size_t stackSize = mElementStack.size();
+		return stackSize < 2 ? 0 : mElementStack[stackSize - 2];
+	}
+
+	//------------------------------
+	bool DocumentScanner::elementBegin( const ParserChar* elementName, const ParserAttributes& attributes )
+	{
+		StringHash elementHash = Utils::calculateStringHashWithNamespace( elementName ).second;
+		mElementStack.push_back( elementHash );
+		mStatistics->elementCount++;
+
+		// A child of <init_from> means that it contains no 1.4 path, e.g. a 1.5 <hex>
+		if ( mIsInImagePath )
+		{
+			mImagePath.clear();
+			mIsInImagePath = false;
+		}
+
+		switch ( elementHash )
+		{
+		case HASH_ELEMENT_COLLADA:
+			handleCOLLADAAttributes( attributes );
+			return true;
+		case HASH_ELEMENT_GEOMETRY:
+			mStatistics->geometryCount++;
+			break;
+		case HASH_ELEMENT_MESH:
+			mStatistics->meshCount++;
+			break;
+		case HASH_ELEMENT_CONTROLLER:
+			mStatistics->controllerCount++;
+			break;
+		case HASH_ELEMENT_ANIMATION:
+			mStatistics->animationCount++;
+			break;
+		case HASH_ELEMENT_NODE:
+			mStatistics->nodeCount++;
+			break;
+		case HASH_ELEMENT_IMAGE:
+			mStatistics->imageCount++;
+			break;
+		case HASH_ELEMENT_INIT_FROM:
+			// COLLADA 1.4: <image><init_from>path</init_from></image>
+			mIsInImagePath = (getParentElementHash() == HASH_ELEMENT_IMAGE);
+			break;
+		case HASH_ELEMENT_REF:
+			// COLLADA 1.5: <image><init_from><ref>path</ref></init_from></image>
+			mIsInImagePath = (getParentElementHash() == HASH_ELEMENT_INIT_FROM);
+			break;
+		case HASH_ELEMENT_P:
+			if ( mCurrentPrimitive != 0 )
+			{
+				mIsInP = true;
+				mIsInToken = false;
+				mCurrentPIndexCount = 0;
+			}
+			break;
+		default:
+			if ( isPrimitive( elementHash ) && (getParentElementHash() == HASH_ELEMENT_MESH) )
+			{
+				mStatistics->primitiveCount++;
+				mCurrentPrimitive = elementHash;
+				mCurrentPrimitiveCount = 0;
+				mCurrentPrimitiveMaxOffset = 0;
+				mCurrentPrimitiveIndexCount = 0;
+			}
+			else
+			{
+				for ( size_t i = 0; i < LIBRARY_HASH_FLAG_PAIRS_SIZE; ++i )
+				{
+					if ( LIBRARY_HASH_FLAG_PAIRS[i].hash == elementHash )
+					{
+						mStatistics->libraryFlags |= LIBRARY_HASH_FLAG_PAIRS[i].flag;
+						break;
+					}
+				}
+			}
+			break;
+		}
+
+		handleAttributes( elementHash, attributes );
+		return true;
+	}
+
+	//------------------------------
+	bool DocumentScanner::elementEnd( const ParserChar* /*elementName*/ )
+	{
+		StringHash elementHash = mElementStack.empty() ? 0 : mElementStack.back();
+
+		if ( mIsInP && (elementHash == HASH_ELEMENT_P) )
+		{
+			if ( mIsInToken )
+				mCurrentPIndexCount++;
+			mStatistics->pCount++;
+			mStatistics->indexCount += mCurrentPIndexCount;
+			if ( mCurrentPIndexCount > mStatistics->maxPIndexCount )
+				mStatistics->maxPIndexCount = mCurrentPIndexCount;
+			mCurrentPrimitiveIndexCount += mCurrentPIndexCount;
+			mIsInP = false;
+			mIsInToken = false;
+		}
+		else if ( mIsInImagePath && ((elementHash == HASH_ELEMENT_INIT_FROM) || (elementHash == HASH_ELEMENT_REF)) )
+		{
+			String::size_type begin = mImagePath.find_first_not_of( " \t\r\n" );
+			String::size_type end = mImagePath.find_last_not_of( " \t\r\n" );
+			if ( begin != String::npos )
+				mStatistics->imageFiles.insert( mImagePath.substr( begin, end - begin + 1 ) );
+			mImagePath.clear();
+			mIsInImagePath = false;
+		}
+		else if ( (elementHash != 0) && (elementHash == mCurrentPrimitive) )
+		{
+			finishPrimitive();
+		}
+
+		if ( !mElementStack.empty() )
+			mElementStack.pop_back();
+		return true;
+	}
+
+	//------------------------------
+	bool DocumentScanner::textData( const ParserChar* text, size_t textLength )
+	{
+		if ( mIsInP )
+		{
+			// Count the tokens without converting them. A token might be split between two calls.
+			const ParserChar* bufferEnd = text + textLength;
+			bool isInToken = mIsInToken;
+			size_t tokenCount = 0;
+			for ( const ParserChar* pos = text; pos != bufferEnd; ++pos )
+			{
+				if ( Utils::isWhiteSpace( *pos ) )
+				{
+					if ( isInToken )
+						tokenCount++;
+					isInToken = false;
+				}
+				else
+				{
+					isInToken = true;
+				}
+			}
+			mCurrentPIndexCount += tokenCount;
+			mIsInToken = isInToken;
+		}
+		else if ( mIsInImagePath )
+		{
+			mImagePath.append( text, textLength );
+		}
+		return true;
+	}
+
+	//------------------------------
+	void DocumentScanner::handleCOLLADAAttributes( const ParserAttributes& attributes )
+	{
+		const ParserChar** attributeArray = attributes.attributes;
+		if ( !attributeArray )
+			return;
+
+		while ( *attributeArray && *(attributeArray + 1) )
+		{
+			StringHashPair hashPair = Utils::calculateStringHashWithNamespace( *attributeArray );
+			const ParserChar* attributeValue = *(attributeArray + 1);
+			attributeArray += 2;
+
+			StringHash prefix = hashPair.first;
+			StringHash name = hashPair.second;
+			if ( (prefix == 0 && name == HASH_ATTRIBUTE_XMLNS) || prefix == HASH_ATTRIBUTE_XMLNS )
+			{
+				StringHash attributeValueHash = Utils::calculateStringHash( attributeValue );
+				if ( attributeValueHash == HASH_NAMESPACE_COLLADA_14 )
+					mStatistics->version = COLLADA_14;
+				else if ( attributeValueHash == HASH_NAMESPACE_COLLADA_15 )
+					mStatistics->version = COLLADA_15;
+			}
+		}
+	}
+
+	//------------------------------
+	void DocumentScanner::handleAttributes( StringHash elementHash, const ParserAttributes& attributes )
+	{
+		const ParserChar** attributeArray = attributes.attributes;
+		if ( !attributeArray )
+			return;
+
+		while ( *attributeArray && *(attributeArray + 1) )
+		{
+			StringHash attributeHash = Utils::calculateStringHash( *attributeArray );
+			const ParserChar* attributeValue = *(attributeArray + 1);
+			attributeArray += 2;
+
+			switch ( attributeHash )
+			{
+			case HASH_ATTRIBUTE_URL:
+			case HASH_ATTRIBUTE_SOURCE:
+				addExternalReference( attributeValue );
+				break;
+			case HASH_ATTRIBUTE_COUNT:
+				if ( elementHash == HASH_ELEMENT_FLOAT_ARRAY )
+				{
+					size_t count = toCount( attributeValue );
+					mStatistics->floatArrayCount++;
+					mStatistics->floatValueCount += count;
+					if ( count > mStatistics->maxFloatArrayValueCount )
+						mStatistics->maxFloatArrayValueCount = count;
+				}
+				else if ( elementHash == HASH_ELEMENT_INT_ARRAY )
+				{
+					mStatistics->intArrayCount++;
+					mStatistics->intValueCount += toCount( attributeValue );
+				}
+				else if ( elementHash == mCurrentPrimitive )
+				{
+					mCurrentPrimitiveCount = toCount( attributeValue );
+				}
+				break;
+			case HASH_ATTRIBUTE_OFFSET:
+				if ( (elementHash == HASH_ELEMENT_INPUT) && (mCurrentPrimitive != 0) && (getParentElementHash() == mCurrentPrimitive) )
+				{
+					size_t offset = toCount( attributeValue );
+					if ( offset > mCurrentPrimitiveMaxOffset )
+						mCurrentPrimitiveMaxOffset = offset;
+				}
+				break;
+			}
+		}
+	}
+
+	//------------------------------
+	void DocumentScanner::addExternalReference( const ParserChar* uri )
+	{
+		if ( !uri || (*uri == 0) || (*uri == '#') )
+			return;
+
+		const ParserChar* fragment = uri;
+		while ( (*fragment != 0) && (*fragment != '#') )
+			++fragment;
+
+		mStatistics->externalDocuments.insert( String( uri, fragment - uri ) );
+	}
+
+	//------------------------------
+	void DocumentScanner::finishPrimitive()
+	{
+		size_t vertexCount = mCurrentPrimitiveIndexCount / (mCurrentPrimitiveMaxOffset + 1);
+		size_t triangleCount = 0;
+
+		switch ( mCurrentPrimitive )
+		{
+		case HASH_ELEMENT_TRIANGLES:
+			triangleCount = mCurrentPrimitiveCount;
+			break;
+		case HASH_ELEMENT_POLYLIST:
+		case HASH_ELEMENT_POLYGONS:
+			// every face with n vertices results in n - 2 triangles. Without p, assume triangles.
+			if ( vertexCount == 0 )
+				triangleCount = mCurrentPrimitiveCount;
+			else if ( vertexCount > 2 * mCurrentPrimitiveCount )
+				triangleCount = vertexCount - 2 * mCurrentPrimitiveCount;
+			break;
+		case HASH_ELEMENT_TRISTRIPS:
+		case HASH_ELEMENT_TRIFANS:
+			// every strip or fan with n vertices results in n - 2 triangles
+			if ( vertexCount > 2 * mCurrentPrimitiveCount )
+				triangleCount = vertexCount - 2 * mCurrentPrimitiveCount;
+			break;
+		default:
+			// lines and linestrips do not contain any triangles
+			break;
+		}
+
+		mStatistics->triangleEstimate += triangleCount;
+		mCurrentPrimitive = 0;
+	}
+
+} // namespace COLLADASAXFWL
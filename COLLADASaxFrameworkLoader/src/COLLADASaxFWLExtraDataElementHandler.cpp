@@ -11,6 +11,8 @@
 #include "COLLADASaxFWLStableHeaders.h"
 #include "COLLADASaxFWLExtraDataElementHandler.h"
 #include "COLLADASaxFWLIExtraDataCallbackHandler.h"
+#include "COLLADASaxFWLSourceArrayLoader.h"
+#include "COLLADASaxFWLBinaryArray.h"
 
 
 namespace COLLADASaxFWL
@@ -20,6 +22,8 @@ namespace COLLADASaxFWL
     ExtraDataElementHandler::ExtraDataElementHandler() 
         : mExtraDataCallbackHandlerList (0)
         , mCallbackHandlersCallingList (0)
+        , mBinaryArrayLoader (0)
+        , mIsInBinaryArray (false)
 	{
 	}
 	
@@ -57,6 +61,12 @@ namespace COLLADASaxFWL
     //------------------------------
     bool ExtraDataElementHandler::elementBegin( const ParserChar* elementName, const GeneratedSaxParser::xmlChar** attributes )
     {
+        if ( mBinaryArrayLoader && strcmp( elementName, BinaryArray::ELEMENT_NAME ) == 0 )
+        {
+            mIsInBinaryArray = true;
+            return mBinaryArrayLoader->loadBinaryArray ( attributes );
+        }
+
         // Go through the list of extra data callback handlers and call the elementBegin method.
         const size_t numHandlers = mExtraDataCallbackHandlerList.size ();
         if ( numHandlers > 0 && !mCallbackHandlersCallingList ) return false;
@@ -75,6 +85,12 @@ namespace COLLADASaxFWL
     //------------------------------
     bool ExtraDataElementHandler::elementEnd( const ParserChar* elementName )
     {
+        if ( mIsInBinaryArray )
+        {
+            mIsInBinaryArray = false;
+            return true;
+        }
+
         // Go through the list of extra data callback handlers and call the elementEnd method.
         const size_t numHandlers = mExtraDataCallbackHandlerList.size ();
         if ( numHandlers > 0 && !mCallbackHandlersCallingList ) return false;
@@ -99,13 +99,33 @@ namespace COLLADASaxFWL
 		COLLADAFW::Mesh * mesh = mMeshLoader ? mMeshLoader->getMesh() : 0;
 		if ( ((getObjectFlags() & Loader::GEOMETRY_FLAG) != 0) && mesh )
 		{
+			// an owned mesh may outlive the binary array files, which are unmapped by the loader
+			const bool writerOwnsMesh = writerOwnsObjects( COLLADAFW::IWriter::OBJECT_GEOMETRY );
+			if ( writerOwnsMesh )
+			{
+				mesh->getPositions().copyExternalData();
+				mesh->getNormals().copyExternalData();
+			}
+			if ( !writer()->acceptsQuantizedValues() )
+			{
+				mesh->getPositions().dequantize();
+				mesh->getNormals().dequantize();
+				mesh->getUVCoords().dequantize();
+			}
 			success |= writer()->writeGeometry(mesh);
+			if ( writerOwnsMesh )
+				mMeshLoader->yieldMeshOwnerShip();
 		}
 
         COLLADAFW::Spline * spline = mSplineLoader ? mSplineLoader->getSpline() : 0;
         if ( ((getObjectFlags() & Loader::GEOMETRY_FLAG) != 0) && spline )
         {
+            const bool writerOwnsSpline = writerOwnsObjects( COLLADAFW::IWriter::OBJECT_GEOMETRY );
+            if ( writerOwnsSpline )
+                spline->getPositions().copyExternalData();
             success |= writer()->writeGeometry(spline);
+            if ( writerOwnsSpline )
+                mSplineLoader->yieldSplineOwnerShip();
         }
 
 		finish();
@@ -46,6 +46,12 @@ namespace COLLADASaxFWL
 		return getColladaLoader()->writer();
 	}
 
+	//-----------------------------
+	bool IFilePartLoader::writerOwnsObjects( COLLADAFW::IWriter::ObjectKind objectKind )
+	{
+		return ( writer()->getOwnedObjects() & objectKind ) != 0;
+	}
+
 	//-----------------------------
 	const COLLADAFW::UniqueId& IFilePartLoader::createUniqueId( const String& uriString, COLLADAFW::ClassId classId )
 	{
@@ -195,6 +201,13 @@ namespace COLLADASaxFWL
 		return getColladaLoader()->getTextureMapIdBySematic(semantic);
 	}
 
+	//------------------------------
+	const COLLADABU::MemoryMappedFile* IFilePartLoader::getBinaryArrayFile( const COLLADABU::URI& uri )
+	{
+		COLLADABU_ASSERT( getColladaLoader() );
+		return getColladaLoader()->getBinaryArrayFile(uri);
+	}
+
 	//------------------------------
 	SidTreeNode* IFilePartLoader::addToSidTree( const char* colladaId, const char* colladaSid )
 	{
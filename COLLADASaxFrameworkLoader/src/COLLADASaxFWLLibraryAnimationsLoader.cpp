@@ -392,6 +392,10 @@ namespace COLLADASaxFWL
 			mCurrentAnimationCurve->getInTangentValues().clear();
 			mCurrentAnimationCurve->getOutTangentValues().clear();
 		}
+		applyNumericPrecision( mCurrentAnimationCurve->getInputValues() );
+		applyNumericPrecision( mCurrentAnimationCurve->getOutputValues() );
+		applyNumericPrecision( mCurrentAnimationCurve->getInTangentValues() );
+		applyNumericPrecision( mCurrentAnimationCurve->getOutTangentValues() );
 		if ( (getObjectFlags() & Loader::ANIMATION_FLAG) != 0 )
 		{
 			//assume linear interpolation if no interpolation is set
@@ -403,7 +407,8 @@ namespace COLLADASaxFWL
 			if ( COLLADAFW::validate( mCurrentAnimationCurve, mVerboseValidate ) == 0)
 			{
 				success = writer()->writeAnimation(mCurrentAnimationCurve);
-				FW_DELETE mCurrentAnimationCurve;
+				if ( !writerOwnsObjects( COLLADAFW::IWriter::OBJECT_ANIMATION ) )
+					FW_DELETE mCurrentAnimationCurve;
 			}
 			else
 			{
@@ -498,8 +503,7 @@ namespace COLLADASaxFWL
 			return true;
 		}
 
-		String sourceId = getIdFromURIFragmentType(attributeData.source);
-		const SourceBase* sourceBase = getSourceById ( sourceId );
+		const SourceBase* sourceBase = getSourceByURIFragment( attributeData.source );
 		// TODO handle case where source could not be found
 		if ( !sourceBase )
 			return true;
@@ -229,7 +229,13 @@ namespace COLLADASaxFWL
 		bool success = true;
 		if ( validate( mCurrentSkinControllerData, mVerboseValidate ) == 0 )
 		{
+			// owned skin controller data may outlive the binary array files, which are unmapped by the loader
+			const bool writerOwnsSkinControllerData = writerOwnsObjects( COLLADAFW::IWriter::OBJECT_SKIN_CONTROLLER_DATA );
+			if ( writerOwnsSkinControllerData )
+				mCurrentSkinControllerData->getWeights().copyExternalData();
 			success = writer()->writeSkinControllerData( mCurrentSkinControllerData );
+			if ( writerOwnsSkinControllerData )
+				mCurrentSkinControllerData = 0;
 		}
 
 		FW_DELETE mCurrentSkinControllerData;
@@ -390,8 +396,7 @@ namespace COLLADASaxFWL
 							break;
 						}
 
-						String sourceId = getIdFromURIFragmentType(attributeData.source);
-						SourceBase* sourceBase = getSourceById ( sourceId );
+						SourceBase* sourceBase = getSourceByURIFragment( attributeData.source );
 
 						if ( !sourceBase || (sourceBase->getDataType() != SourceBase::DATA_TYPE_REAL) )
 						{
@@ -483,8 +488,7 @@ namespace COLLADASaxFWL
 							break;
 						}
 
-						String sourceId = getIdFromURIFragmentType(attributeData.source);
-						SourceBase* sourceBase = getSourceById( sourceId );
+						SourceBase* sourceBase = getSourceByURIFragment( attributeData.source );
 
 						if ( !sourceBase || (sourceBase->getDataType() != SourceBase::DATA_TYPE_REAL) )
 						{
@@ -506,10 +510,11 @@ namespace COLLADASaxFWL
 						}
 						const RealSource *weightSource = (const RealSource *)sourceBase;
 						COLLADAFW::FloatOrDoubleArray& morphWeights = mCurrentMorphController->getMorphWeights();
-						addToSidTree( sourceId.c_str(), 0, &morphWeights );
+						addToSidTree( sourceBase->getId().c_str(), 0, &morphWeights );
 						moveUpInSidTree();
 
 						setRealValues( morphWeights, weightSource );
+						applyNumericPrecision( morphWeights );
 					}
 					break;
                     //Prevent warnings for semantics used by SKIN_CONTROLLER
@@ -564,8 +569,7 @@ namespace COLLADASaxFWL
 			return true;
 		}
 
-		String sourceId = getIdFromURIFragmentType(attributeData.source);
-		SourceBase* sourceBase = getSourceById ( sourceId );
+		SourceBase* sourceBase = getSourceByURIFragment( attributeData.source );
 
 		switch ( semantic )
 		{
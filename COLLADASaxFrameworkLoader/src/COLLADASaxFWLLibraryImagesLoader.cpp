@@ -78,6 +78,8 @@ namespace COLLADASaxFWL
 		if ( (getObjectFlags() & Loader::IMAGE_FLAG) != 0 )
 		{
 		    success = writer()->writeImage(mCurrentImage);
+			if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_IMAGE ) )
+				mCurrentImage = 0;
 		}
 		FW_DELETE mCurrentImage;
 		mCurrentImage = 0;
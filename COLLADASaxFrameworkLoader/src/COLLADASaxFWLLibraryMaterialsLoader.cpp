@@ -57,6 +57,8 @@ namespace COLLADASaxFWL
 		if ( (getObjectFlags() & Loader::MATERIAL_FLAG) != 0 )
 		{
 			success = writer()->writeMaterial(mCurrentMaterial);
+			if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_MATERIAL ) )
+				mCurrentMaterial = 0;
 		}
 
 		FW_DELETE mCurrentMaterial;
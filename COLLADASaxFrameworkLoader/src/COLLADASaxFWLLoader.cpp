@@ -16,6 +16,7 @@ http://www.opensource.org/licenses/mit-license.php
 #include "COLLADASaxFWLUtils.h"
 
 #include "COLLADABUURI.h"
+#include "COLLADABUMemoryMappedFile.h"
 
 #include "COLLADAFWVisualScene.h"
 #include "COLLADAFWLibraryNodes.h"
@@ -24,8 +25,12 @@ http://www.opensource.org/licenses/mit-license.php
 #include "COLLADAFWLight.h"
 #include "COLLADAFWCamera.h"
 #include "COLLADAFWAnimationList.h"
+#include "COLLADAFWMorphController.h"
 #include "COLLADAFWConstants.h"
 
+#include "COLLADASaxFWLTracer.h"
+#include "COLLADASaxFWLTracingWriter.h"
+
 #include <sys/types.h>
 #include <sys/timeb.h>
 #include <fstream>
@@ -49,6 +54,10 @@ namespace COLLADASaxFWL
 		, mSidTreeRoot( new SidTreeNode("", 0) )
 		, mSkinControllerSet( compare )
 		, mExternalReferenceDeciderCallbackFunction()
+		, mTracer(0)
+		, mPackMeshIndices(false)
+		, mNumericPrecision(PRECISION_KEEP)
+		, mObjectsOwnedByWriter(COLLADAFW::IWriter::OBJECT_NONE)
 
 	{
 	}
@@ -59,29 +68,50 @@ namespace COLLADASaxFWL
 	{
 		delete mSidTreeRoot;
 
+		// The objects, whose ownership has been transferred to the writer, are deleted by the writer
+
 		// delete visual scenes
-		deleteVectorFW(mVisualScenes);
+		if ( (mObjectsOwnedByWriter & COLLADAFW::IWriter::OBJECT_VISUAL_SCENE) == 0 )
+			deleteVectorFW(mVisualScenes);
 
 		// delete library nodes
-		deleteVectorFW(mLibraryNodes);
+		if ( (mObjectsOwnedByWriter & COLLADAFW::IWriter::OBJECT_LIBRARY_NODES) == 0 )
+			deleteVectorFW(mLibraryNodes);
 
 		// delete effects
-		deleteVectorFW(mEffects);
+		if ( (mObjectsOwnedByWriter & COLLADAFW::IWriter::OBJECT_EFFECT) == 0 )
+			deleteVectorFW(mEffects);
 
 		// delete lights
-		deleteVectorFW(mLights);
+		if ( (mObjectsOwnedByWriter & COLLADAFW::IWriter::OBJECT_LIGHT) == 0 )
+			deleteVectorFW(mLights);
 
 		// delete cameras
-		deleteVectorFW(mCameras);
+		if ( (mObjectsOwnedByWriter & COLLADAFW::IWriter::OBJECT_CAMERA) == 0 )
+			deleteVectorFW(mCameras);
+
+		// delete morph controllers
+		if ( (mObjectsOwnedByWriter & COLLADAFW::IWriter::OBJECT_CONTROLLER) == 0 )
+			deleteVectorFW(mMorphControllerList);
 
 		// We do not delete formulas here. They are deleted by the Formulas class
 
 		// delete animation lists
-		Loader::UniqueIdAnimationListMap::const_iterator it = mUniqueIdAnimationListMap.begin();
-		for ( ; it != mUniqueIdAnimationListMap.end(); ++it )
+		if ( (mObjectsOwnedByWriter & COLLADAFW::IWriter::OBJECT_ANIMATION_LIST) == 0 )
+		{
+			Loader::UniqueIdAnimationListMap::const_iterator it = mUniqueIdAnimationListMap.begin();
+			for ( ; it != mUniqueIdAnimationListMap.end(); ++it )
+			{
+				COLLADAFW::AnimationList* animationList = it->second;
+				FW_DELETE animationList;
+			}
+		}
+
+		// unmap the binary array files
+		BinaryArrayFileMap::const_iterator fileIt = mBinaryArrayFiles.begin();
+		for ( ; fileIt != mBinaryArrayFiles.end(); ++fileIt )
 		{
-			COLLADAFW::AnimationList* animationList = it->second;
-			FW_DELETE animationList;
+			delete fileIt->second;
 		}
 	}
 
@@ -191,7 +221,12 @@ namespace COLLADASaxFWL
 	{
 		if ( !writer )
 			return false;
-		mWriter = writer;
+
+		// with a tracer, the calls of the writer are traced by a writer put in front of it
+		TracingWriter tracingWriter( writer, mTracer );
+		mWriter = mTracer ? &tracingWriter : writer;
+		TraceSpan loadSpan( mTracer, "loadDocument", "load" );
+		loadSpan.setDetail( fileName );
 
 		mWriter->start();
 
@@ -212,6 +247,8 @@ namespace COLLADASaxFWL
 				|| !mExternalReferenceDeciderCallbackFunction 
 				|| mExternalReferenceDeciderCallbackFunction(fileUri, mCurrentFileId) )
 			{
+				TraceSpan fileSpan( mTracer, "FileLoader", "file" );
+				fileSpan.setDetail( fileUri.getURIString() );
 				mFileLoader = new FileLoader(this, 
 					fileUri,
 					&saxParserErrorHandler, 
@@ -228,6 +265,7 @@ namespace COLLADASaxFWL
 
 		if ( !abortLoading )
 		{
+			TraceSpan postProcessSpan( mTracer, "postProcess", "postprocess" );
 			PostProcessor postProcessor(this, 
 				&saxParserErrorHandler, 
 				mObjectFlags,
@@ -242,6 +280,7 @@ namespace COLLADASaxFWL
 		mWriter->finish();
 
 		mParsedObjectFlags |= mObjectFlags;
+		mWriter = writer;
 
 		return !abortLoading;
 	}
@@ -251,7 +290,11 @@ namespace COLLADASaxFWL
 	{
 		if ( !writer )
 			return false;
-		mWriter = writer;
+
+		TracingWriter tracingWriter( writer, mTracer );
+		mWriter = mTracer ? &tracingWriter : writer;
+		TraceSpan loadSpan( mTracer, "loadDocument", "load" );
+		loadSpan.setDetail( uri );
         
 		SaxParserErrorHandler saxParserErrorHandler(mErrorHandler);
         
@@ -270,6 +313,8 @@ namespace COLLADASaxFWL
 				|| !mExternalReferenceDeciderCallbackFunction 
 				|| mExternalReferenceDeciderCallbackFunction(fileUri, mCurrentFileId) )
 			{
+				TraceSpan fileSpan( mTracer, "FileLoader", "file" );
+				fileSpan.setDetail( fileUri.getURIString() );
 				FileLoader fileLoader(this, 
 					getFileUri( mCurrentFileId ),
 					&saxParserErrorHandler, 
@@ -285,6 +330,7 @@ namespace COLLADASaxFWL
         
 		if ( !abortLoading )
 		{
+			TraceSpan postProcessSpan( mTracer, "postProcess", "postprocess" );
 			PostProcessor postProcessor(this, 
 				&saxParserErrorHandler, 
 				mObjectFlags,
@@ -299,6 +345,7 @@ namespace COLLADASaxFWL
 		mWriter->finish();
 
 		mParsedObjectFlags |= mObjectFlags;
+		mWriter = writer;
         
 		return !abortLoading;
 	}
@@ -332,6 +379,26 @@ namespace COLLADASaxFWL
 		}
 	}
 
+	//-----------------------------
+	const COLLADABU::MemoryMappedFile* Loader::getBinaryArrayFile( const COLLADABU::URI& uri )
+	{
+		const String& uriString = uri.getURIString();
+		BinaryArrayFileMap::iterator it = mBinaryArrayFiles.find( uriString );
+		if ( it != mBinaryArrayFiles.end() )
+		{
+			return it->second;
+		}
+
+		COLLADABU::MemoryMappedFile* file = new COLLADABU::MemoryMappedFile();
+		if ( !file->open( COLLADABU::NativeString( uri.toNativePath() ) ) )
+		{
+			delete file;
+			return 0;
+		}
+		mBinaryArrayFiles[uriString] = file;
+		return file;
+	}
+
 	//-----------------------------
 	bool Loader::compare( const COLLADAFW::SkinController& lhs, const COLLADAFW::SkinController& rhs )
 	{
@@ -13,6 +13,7 @@
 #include "COLLADASaxFWLGeometryMaterialIdInfo.h"
 #include "COLLADASaxFWLLoader.h"
 #include "COLLADASaxFWLFileLoader.h"
+#include "COLLADASaxFWLBinaryArray.h"
 
 #include "COLLADAFWTriangles.h"
 #include "COLLADAFWLines.h"
@@ -24,6 +25,7 @@
 #include "COLLADAFWIWriter.h"
 
 #include <fstream>
+#include <algorithm>
 
 
 namespace COLLADASaxFWL
@@ -105,8 +107,8 @@ namespace COLLADASaxFWL
         if ( positionsInput == 0 ) return 0;
 
         // Get the source element with the uri of the input element.
-        COLLADABU::URI positionsInputSource = positionsInput->getSource ();
-        String sourceId = positionsInputSource.getFragment ();
+        const COLLADABU::URI& positionsInputSource = positionsInput->getSource ();
+        const String& sourceId = positionsInputSource.getFragment ();
 
         return getSourceById ( sourceId );
     }
@@ -182,8 +184,8 @@ namespace COLLADASaxFWL
         }
 
         // Get the source element with the uri of the input element.
-        COLLADABU::URI inputUrl = input.getSource ();
-        String sourceId = inputUrl.getFragment ();
+        const COLLADABU::URI& inputUrl = input.getSource ();
+        const String& sourceId = inputUrl.getFragment ();
         SourceBase* sourceBase = getSourceById ( sourceId );
         if ( sourceBase == 0 ) return false;
         
@@ -210,17 +212,22 @@ namespace COLLADASaxFWL
                 const size_t initialIndex = positions.getValuesCount ();
                 sourceBase->setInitialIndex ( initialIndex );
 
+                // Extend the bounding box of the mesh by the new positions with their full precision.
+                mMesh->getBoundingBox ().extendByPositions ( valuesArray.getData (), valuesArray.getCount () / 3 );
+
                 // Push the new positions into the list of positions.
-                positions.setType ( COLLADAFW::MeshVertexData::DATA_TYPE_FLOAT );
-                if ( initialIndex != 0 ) 
-				{
-					positions.appendValues ( valuesArray );
-				}
+                if ( getColladaLoader ()->getNumericPrecision () != Loader::PRECISION_KEEP )
+                {
+                    appendSourceValues ( valuesArray, positions, getColladaLoader ()->getPrecisionErrors ().positions, COLLADAFW::QuantizedArray::ENCODING_LINEAR, 3 );
+                }
                 else
-				{
-					positions.setData ( valuesArray.getData (), valuesArray.getCount () );
-					valuesArray.yieldOwnerShip();
-				}
+                {
+                    positions.setType ( COLLADAFW::MeshVertexData::DATA_TYPE_FLOAT );
+                    if ( initialIndex != 0 )
+                        positions.appendValues ( valuesArray );
+                    else
+                        moveValues ( valuesArray, *positions.getFloatValues () );
+                }
 
                 // Set the source base as loaded element.
                 sourceBase->addLoadedInputElement ( semantic );
@@ -240,17 +247,22 @@ namespace COLLADASaxFWL
                 const size_t initialIndex = positions.getValuesCount ();
                 sourceBase->setInitialIndex ( initialIndex );
 
+                // Extend the bounding box of the mesh by the new positions with their full precision.
+                mMesh->getBoundingBox ().extendByPositions ( valuesArray.getData (), valuesArray.getCount () / 3 );
+
                 // Push the new positions into the list of positions.
-                positions.setType ( COLLADAFW::MeshVertexData::DATA_TYPE_DOUBLE );
-                if ( initialIndex != 0 ) 
-				{
-					positions.appendValues ( valuesArray );
-				}
-                else 
-				{
-					positions.setData ( valuesArray.getData (), valuesArray.getCount () );
-					valuesArray.yieldOwnerShip();
-				}
+                if ( getColladaLoader ()->getNumericPrecision () != Loader::PRECISION_KEEP )
+                {
+                    appendSourceValues ( valuesArray, positions, getColladaLoader ()->getPrecisionErrors ().positions, COLLADAFW::QuantizedArray::ENCODING_LINEAR, 3 );
+                }
+                else
+                {
+                    positions.setType ( COLLADAFW::MeshVertexData::DATA_TYPE_DOUBLE );
+                    if ( initialIndex != 0 )
+                        positions.appendValues ( valuesArray );
+                    else
+                        moveValues ( valuesArray, *positions.getDoubleValues () );
+                }
                 
                 // Set the source base as loaded element.
                 sourceBase->addLoadedInputElement ( semantic );
@@ -277,8 +289,8 @@ namespace COLLADASaxFWL
         }
 
         // Get the source element with the uri of the input element.
-        COLLADABU::URI inputUrl = input.getSource ();
-        String sourceId = inputUrl.getFragment ();
+        const COLLADABU::URI& inputUrl = input.getSource ();
+        const String& sourceId = inputUrl.getFragment ();
         SourceBase* sourceBase = getSourceById ( sourceId );
         if ( sourceBase == 0 ) return false;
 
@@ -302,17 +314,19 @@ namespace COLLADASaxFWL
                 const size_t initialIndex = normals.getValuesCount ();
                 sourceBase->setInitialIndex ( initialIndex );
 
-                // Push the new positions into the list of positions.
-                normals.setType ( COLLADAFW::MeshVertexData::DATA_TYPE_FLOAT );
-                if ( initialIndex != 0 ) 
-				{
-					normals.appendValues ( valuesArray );
-				}
-                else 
-				{
-					normals.setData ( valuesArray.getData (), valuesArray.getCount () );
-					valuesArray.yieldOwnerShip();
-				}
+                // Push the new normals into the list of normals.
+                if ( getColladaLoader ()->getNumericPrecision () != Loader::PRECISION_KEEP )
+                {
+                    appendSourceValues ( valuesArray, normals, getColladaLoader ()->getPrecisionErrors ().normals, COLLADAFW::QuantizedArray::ENCODING_OCTAHEDRAL, 3 );
+                }
+                else
+                {
+                    normals.setType ( COLLADAFW::MeshVertexData::DATA_TYPE_FLOAT );
+                    if ( initialIndex != 0 )
+                        normals.appendValues ( valuesArray );
+                    else
+                        moveValues ( valuesArray, *normals.getFloatValues () );
+                }
 
                 // Set the source base as loaded element.
                 sourceBase->addLoadedInputElement ( semantic );
@@ -332,17 +346,19 @@ namespace COLLADASaxFWL
                 const size_t initialIndex = normals.getValuesCount ();
                 sourceBase->setInitialIndex ( initialIndex );
 
-                // Push the new positions into the list of positions.
-                normals.setType ( COLLADAFW::MeshVertexData::DATA_TYPE_DOUBLE );
-                if ( initialIndex != 0 ) 
-				{
-					normals.appendValues ( valuesArray );
-				}
-                else 
-				{ 
-					normals.setData ( valuesArray.getData (), valuesArray.getCount () );
-					valuesArray.yieldOwnerShip();
-				}
+                // Push the new normals into the list of normals.
+                if ( getColladaLoader ()->getNumericPrecision () != Loader::PRECISION_KEEP )
+                {
+                    appendSourceValues ( valuesArray, normals, getColladaLoader ()->getPrecisionErrors ().normals, COLLADAFW::QuantizedArray::ENCODING_OCTAHEDRAL, 3 );
+                }
+                else
+                {
+                    normals.setType ( COLLADAFW::MeshVertexData::DATA_TYPE_DOUBLE );
+                    if ( initialIndex != 0 )
+                        normals.appendValues ( valuesArray );
+                    else
+                        moveValues ( valuesArray, *normals.getDoubleValues () );
+                }
 
                 // Set the source base as loaded element.
                 sourceBase->addLoadedInputElement ( semantic );
@@ -370,8 +386,8 @@ namespace COLLADASaxFWL
         }
 
         // Get the source element with the uri of the input element.
-        COLLADABU::URI inputUrl = input.getSource ();
-        String sourceId = inputUrl.getFragment ();
+        const COLLADABU::URI& inputUrl = input.getSource ();
+        const String& sourceId = inputUrl.getFragment ();
         SourceBase* sourceBase = getSourceById ( sourceId );
         if ( sourceBase == 0 ) return false;
 
@@ -392,7 +408,7 @@ namespace COLLADASaxFWL
         else
         {
             COLLADAFW::MeshVertexData& colors = mMesh->getColors ();
-            retValue = appendVertexValues ( sourceBase, colors );
+            retValue = appendVertexValues ( sourceBase, colors, getColladaLoader ()->getPrecisionErrors ().others, false );
         }
 
         // Set the source base as loaded element.
@@ -414,8 +430,8 @@ namespace COLLADASaxFWL
         }
 
         // Get the source element with the uri of the input element.
-        COLLADABU::URI inputUrl = input.getSource ();
-        String sourceId = inputUrl.getFragment ();
+        const COLLADABU::URI& inputUrl = input.getSource ();
+        const String& sourceId = inputUrl.getFragment ();
         SourceBase* sourceBase = getSourceById ( sourceId );
         if ( sourceBase == 0 ) return false;
 
@@ -436,7 +452,7 @@ namespace COLLADASaxFWL
         else
         {
             COLLADAFW::MeshVertexData& colors = mMesh->getTangents ();
-            retValue = appendVertexValues ( sourceBase, colors );
+            retValue = appendVertexValues ( sourceBase, colors, getColladaLoader ()->getPrecisionErrors ().others, false );
         }
 
         // Set the source base as loaded element.
@@ -458,8 +474,8 @@ namespace COLLADASaxFWL
         }
 
         // Get the source element with the uri of the input element.
-        COLLADABU::URI inputUrl = input.getSource ();
-        String sourceId = inputUrl.getFragment ();
+        const COLLADABU::URI& inputUrl = input.getSource ();
+        const String& sourceId = inputUrl.getFragment ();
         SourceBase* sourceBase = getSourceById ( sourceId );
         if ( sourceBase == 0 ) return false;
 
@@ -480,7 +496,7 @@ namespace COLLADASaxFWL
         else
         {
             COLLADAFW::MeshVertexData& colors = mMesh->getBinormals ();
-            retValue = appendVertexValues ( sourceBase, colors );
+            retValue = appendVertexValues ( sourceBase, colors, getColladaLoader ()->getPrecisionErrors ().others, false );
         }
 
         // Set the source base as loaded element.
@@ -492,7 +508,9 @@ namespace COLLADASaxFWL
     //------------------------------
     bool MeshLoader::appendVertexValues ( 
         SourceBase* sourceBase, 
-        COLLADAFW::MeshVertexData &vertexData )
+        COLLADAFW::MeshVertexData &vertexData,
+        double& maxError,
+        bool quantize )
     {
         bool retValue = true;
 
@@ -501,6 +519,9 @@ namespace COLLADASaxFWL
         const size_t initialIndex = vertexData.getValuesCount ();
         sourceBase->setInitialIndex ( initialIndex );
 
+        const bool hasNumericPrecision = getColladaLoader ()->getNumericPrecision () != Loader::PRECISION_KEEP;
+        const size_t stride = (size_t) sourceBase->getStride ();
+
         // Get the source input array
         const SourceBase::DataType& dataType = sourceBase->getDataType ();
         switch ( dataType )
@@ -513,7 +534,16 @@ namespace COLLADASaxFWL
                 COLLADAFW::ArrayPrimitiveType<float>& valuesArray = arrayElement.getValues ();
 
                 // Push the values with the infos into the list.
-                vertexData.appendValues ( valuesArray, source->getId (), (size_t) source->getStride () );
+                if ( hasNumericPrecision )
+                {
+                    const size_t valuesCount = valuesArray.getCount ();
+                    appendSourceValues ( valuesArray, vertexData, maxError, COLLADAFW::QuantizedArray::ENCODING_LINEAR, quantize ? stride : 0 );
+                    vertexData.appendInputInfos ( source->getId (), stride, valuesCount );
+                }
+                else
+                {
+                    vertexData.appendValues ( valuesArray, source->getId (), stride );
+                }
 
                 break;  
             }
@@ -525,7 +555,16 @@ namespace COLLADASaxFWL
                 COLLADAFW::ArrayPrimitiveType<double>& valuesArray = arrayElement.getValues ();
 
                 // Push the values with the infos into the list.
-                vertexData.appendValues ( valuesArray, source->getId (), (size_t) source->getStride () );
+                if ( hasNumericPrecision )
+                {
+                    const size_t valuesCount = valuesArray.getCount ();
+                    appendSourceValues ( valuesArray, vertexData, maxError, COLLADAFW::QuantizedArray::ENCODING_LINEAR, quantize ? stride : 0 );
+                    vertexData.appendInputInfos ( source->getId (), stride, valuesCount );
+                }
+                else
+                {
+                    vertexData.appendValues ( valuesArray, source->getId (), stride );
+                }
 
                 break;
             }
@@ -551,8 +590,8 @@ namespace COLLADASaxFWL
         }
 
         // Get the source element with the uri of the input element.
-        COLLADABU::URI inputUrl = input.getSource ();
-        String sourceId = inputUrl.getFragment ();
+        const COLLADABU::URI& inputUrl = input.getSource ();
+        const String& sourceId = inputUrl.getFragment ();
         SourceBase* sourceBase = getSourceById ( sourceId );
         if ( sourceBase == 0 ) return false;
 
@@ -573,7 +612,7 @@ namespace COLLADASaxFWL
         else
         {
             COLLADAFW::MeshVertexData& uvCoords = mMesh->getUVCoords ();
-            retValue = appendVertexValues ( sourceBase, uvCoords );
+            retValue = appendVertexValues ( sourceBase, uvCoords, getColladaLoader ()->getPrecisionErrors ().uvCoordinates, true );
         }
 
         // Set the source base as loaded element.
@@ -598,25 +637,25 @@ namespace COLLADASaxFWL
 			// Write the indices
 			if ( mUsePositions && (mCurrentOffset == mPositionsOffset) )
 			{
-				COLLADAFW::UIntValuesArray& positionIndices = mCurrentMeshPrimitive->getPositionIndices();
+				COLLADAFW::IndexArray& positionIndices = mCurrentMeshPrimitive->getPositionIndexArray();
 				positionIndices.append ( index + mPositionsIndexOffset );
 			}
 
 			if ( mUseNormals && (mCurrentOffset == mNormalsOffset) )
 			{
-				COLLADAFW::UIntValuesArray& normalIndices = mCurrentMeshPrimitive->getNormalIndices();
+				COLLADAFW::IndexArray& normalIndices = mCurrentMeshPrimitive->getNormalIndexArray();
 				normalIndices.append ( index + mNormalsIndexOffset );
 			}
 
             if ( mUseTangents && (mCurrentOffset == mTangentsOffset) )
             {
-                COLLADAFW::UIntValuesArray& tangentIndices = mCurrentMeshPrimitive->getTangentIndices();
+                COLLADAFW::IndexArray& tangentIndices = mCurrentMeshPrimitive->getTangentIndexArray();
                 tangentIndices.append ( index + mTangentsIndexOffset );
             }
 
             if ( mUseBinormals && (mCurrentOffset == mBinormalsOffset) )
             {
-                COLLADAFW::UIntValuesArray& binormalIndices = mCurrentMeshPrimitive->getBinormalIndices();
+                COLLADAFW::IndexArray& binormalIndices = mCurrentMeshPrimitive->getBinormalIndexArray();
                 binormalIndices.append ( index + mBinormalsIndexOffset );
             }
 
@@ -644,6 +683,8 @@ namespace COLLADASaxFWL
                             texCoordIndices->setName ( tex.mName );
                             texCoordIndices->setStride ( tex.mStride );
                             texCoordIndices->setInitialIndex ( tex.mInitialIndex );
+                            if ( getColladaLoader()->getPackMeshIndices() )
+                                initializeIndexWidth ( texCoordIndices->getIndexArray(), mMesh->getUVCoords().getValuesCount() / ( tex.mStride > 0 ? tex.mStride : 1 ) );
 
                             texCoordIndicesArray.append( texCoordIndices );
                         }
@@ -651,7 +692,7 @@ namespace COLLADASaxFWL
 
                     // Write the values.
                     COLLADAFW::IndexList* texCoordIndices = mCurrentMeshPrimitive->getUVCoordIndices ( j );
-                    texCoordIndices->getIndices().append ( index + (unsigned int)texCoord.mInitialIndex );
+                    texCoordIndices->getIndexArray().append ( index + (unsigned int)texCoord.mInitialIndex );
                 }
             }
 
@@ -678,6 +719,8 @@ namespace COLLADASaxFWL
                             colorIndices->setName ( col.mName );
                             colorIndices->setStride ( col.mStride );
                             colorIndices->setInitialIndex ( col.mInitialIndex );
+                            if ( getColladaLoader()->getPackMeshIndices() )
+                                initializeIndexWidth ( colorIndices->getIndexArray(), mMesh->getColors().getValuesCount() / ( col.mStride > 0 ? col.mStride : 1 ) );
 
                             colorIndicesArray.append ( colorIndices );
                         }
@@ -685,7 +728,7 @@ namespace COLLADASaxFWL
 
                     // Write the values.
                     COLLADAFW::IndexList* colorIndices = mCurrentMeshPrimitive->getColorIndices ( j );
-                    colorIndices->getIndices().append ( index + (unsigned int)color.mInitialIndex );
+                    colorIndices->getIndexArray().append ( index + (unsigned int)color.mInitialIndex );
                 }
             }
 
@@ -706,6 +749,76 @@ namespace COLLADASaxFWL
 	}
 
 
+	//------------------------------
+	void MeshLoader::calculatePrimitiveBoundingBoxes()
+	{
+		const COLLADAFW::MeshVertexData& positions = mMesh->getPositions();
+		const size_t positionsCount = positions.getValuesCount() / 3;
+		const float* floatPositions = 0;
+		const double* doublePositions = 0;
+		const COLLADAFW::QuantizedArray* quantizedPositions = positions.getQuantizedValues();
+		if ( positions.getType() == COLLADAFW::MeshVertexData::DATA_TYPE_FLOAT )
+			floatPositions = positions.getFloatValues()->getData();
+		else if ( positions.getType() == COLLADAFW::MeshVertexData::DATA_TYPE_DOUBLE )
+			doublePositions = positions.getDoubleValues()->getData();
+
+		COLLADAFW::MeshPrimitiveArray& meshPrimitives = mMesh->getMeshPrimitives();
+		for ( size_t i = 0, count = meshPrimitives.getCount(); i < count; ++i )
+		{
+			COLLADAFW::BoundingBox& boundingBox = meshPrimitives[i]->getBoundingBox();
+			boundingBox.clear();
+
+			// Quantized positions are decoded, so that the box contains the positions a writer reads.
+			const COLLADAFW::IndexArray& positionIndices = meshPrimitives[i]->getPositionIndexArray();
+			for ( COLLADAFW::IndexArray::const_iterator it = positionIndices.begin(); it != positionIndices.end(); ++it )
+			{
+				unsigned int positionIndex = *it;
+				if ( positionIndex >= positionsCount )
+					continue;
+
+				if ( floatPositions )
+				{
+					const float* position = floatPositions + 3 * positionIndex;
+					boundingBox.extend ( position[0], position[1], position[2] );
+				}
+				else if ( doublePositions )
+				{
+					const double* position = doublePositions + 3 * positionIndex;
+					boundingBox.extend ( position[0], position[1], position[2] );
+				}
+				else if ( quantizedPositions )
+				{
+					double position[3];
+					quantizedPositions->decode ( 3 * positionIndex, 3, position );
+					boundingBox.extend ( position[0], position[1], position[2] );
+				}
+			}
+		}
+	}
+
+	//------------------------------
+	void MeshLoader::initializeIndexWidths()
+	{
+		if ( !getColladaLoader()->getPackMeshIndices() || !mCurrentMeshPrimitive )
+			return;
+
+		// The sources of the primitive have been appended to the mesh, so the width can be chosen
+		// before the indices are read. The uv coordinate and color lists are initialized, when
+		// they are created by writePrimitiveIndices().
+		initializeIndexWidth ( mCurrentMeshPrimitive->getPositionIndexArray(), mMesh->getPositions().getValuesCount() / 3 );
+		initializeIndexWidth ( mCurrentMeshPrimitive->getNormalIndexArray(), mMesh->getNormals().getValuesCount() / 3 );
+		initializeIndexWidth ( mCurrentMeshPrimitive->getTangentIndexArray(), mMesh->getTangents().getValuesCount() / 3 );
+		initializeIndexWidth ( mCurrentMeshPrimitive->getBinormalIndexArray(), mMesh->getBinormals().getValuesCount() / 3 );
+	}
+
+	//------------------------------
+	void MeshLoader::initializeIndexWidth ( COLLADAFW::IndexArray& indices, size_t valueCount )
+	{
+		// indices read from a previous p element keep their width
+		if ( indices.empty() )
+			indices.setWidth ( COLLADAFW::IndexArray::getWidthForValueCount ( valueCount ) );
+	}
+
 	//------------------------------
 	void MeshLoader::initializeOffsets()
 	{
@@ -745,8 +858,8 @@ namespace COLLADASaxFWL
 
         // Get the offset value, the initial index values and alloc the memory.
         mPositionsOffset = positionInput->getOffset ();
-        COLLADABU::URI inputUrl = positionInput->getSource ();
-        String sourceId = inputUrl.getFragment ();
+        const COLLADABU::URI& inputUrl = positionInput->getSource ();
+        const String& sourceId = inputUrl.getFragment ();
         const SourceBase* sourceBase = getSourceById ( sourceId );
         COLLADABU_ASSERT ( sourceBase != 0 );
         if ( sourceBase == 0 )
@@ -888,7 +1001,7 @@ namespace COLLADASaxFWL
             if ( input->getSemantic () == InputSemantic::COLOR )
             {
                 // TODO Id management!
-                String sourceId = input->getSource ().getFragment ();
+                const String& sourceId = input->getSource ().getFragment ();
                 SourceBase* sourceBase = getSourceById ( sourceId );
                 if ( sourceBase == 0 ) 
                 {
@@ -928,7 +1041,7 @@ namespace COLLADASaxFWL
             if ( input->getSemantic () == InputSemantic::TEXCOORD )
             {
                 // TODO Id management!
-                String sourceId = input->getSource ().getFragment ();
+                const String& sourceId = input->getSource ().getFragment ();
                 SourceBase* sourceBase = getSourceById ( sourceId );
                 if ( sourceBase == 0 ) 
                 {
@@ -973,6 +1086,8 @@ namespace COLLADASaxFWL
 	{
         mInMesh = false;
 
+		calculatePrimitiveBoundingBoxes();
+
 		// The mesh will be written by the GeometyLoader. Therefore nothing to with the mesh here
 		finish();
 		return true;
@@ -1032,20 +1147,20 @@ namespace COLLADASaxFWL
 		mCurrentMeshPrimitive = new COLLADAFW::Triangles(createUniqueId(COLLADAFW::Triangles::ID()));
 		if ( (size_t)attributeData.count > 0)
 		{
-			mCurrentMeshPrimitive->getPositionIndices().reallocMemory((size_t)attributeData.count);
+			mCurrentMeshPrimitive->getPositionIndexArray().reserve((size_t)attributeData.count);
 			if ( mUseNormals )
 			{
-				mCurrentMeshPrimitive->getNormalIndices().reallocMemory((size_t)attributeData.count);
+				mCurrentMeshPrimitive->getNormalIndexArray().reserve((size_t)attributeData.count);
 			}
 
             if ( mUseTangents )
             {
-                mCurrentMeshPrimitive->getTangentIndices().reallocMemory((size_t)attributeData.count);
+                mCurrentMeshPrimitive->getTangentIndexArray().reserve((size_t)attributeData.count);
             }
 
             if ( mUseBinormals )
             {
-                mCurrentMeshPrimitive->getBinormalIndices().reallocMemory((size_t)attributeData.count);
+                mCurrentMeshPrimitive->getBinormalIndexArray().reserve((size_t)attributeData.count);
             }
 
 			// TODO pre-alloc memory for uv indices
@@ -1386,6 +1501,7 @@ namespace COLLADASaxFWL
 			{
 				loadSourceElements(mMeshPrimitiveInputs);
 				initializeOffsets();
+				initializeIndexWidths();
 			}
 			break;
         case LINES:
@@ -1395,13 +1511,14 @@ namespace COLLADASaxFWL
                 mCurrentMeshPrimitive = new COLLADAFW::Lines(createUniqueId(COLLADAFW::Lines::ID()));
                 if ( mCurrentCOLLADAPrimitiveCount > 0)
                 {
-                    mCurrentMeshPrimitive->getPositionIndices().reallocMemory(mCurrentCOLLADAPrimitiveCount);
+                    mCurrentMeshPrimitive->getPositionIndexArray().reserve(mCurrentCOLLADAPrimitiveCount);
                     if ( mUseNormals )
                     {
-                        mCurrentMeshPrimitive->getNormalIndices().reallocMemory(mCurrentCOLLADAPrimitiveCount);
+                        mCurrentMeshPrimitive->getNormalIndexArray().reserve(mCurrentCOLLADAPrimitiveCount);
                     }
                     // TODO pre-alloc memory for uv indices
                 }
+                initializeIndexWidths();
                 mCurrentMeshPrimitive->setMaterialId(mMaterialIdInfo.getMaterialId(mCurrentMeshMaterial));
 				mCurrentMeshPrimitive->setMaterial(mCurrentMeshMaterial);
             }
@@ -1412,6 +1529,7 @@ namespace COLLADASaxFWL
 				{
 					loadSourceElements(mMeshPrimitiveInputs);
 					initializeOffsets();
+					initializeIndexWidths();
 				}
 				int currentTrifanVertexCount = (int)mCurrentVertexCount - (int)mCurrentLastPrimitiveVertexCount;
 				if ( currentTrifanVertexCount > 0 )
@@ -1426,16 +1544,16 @@ namespace COLLADASaxFWL
 					}
 					else
 					{
-						trifans->getPositionIndices().erase(currentTrifanVertexCount);
-						trifans->getNormalIndices().erase(currentTrifanVertexCount);
+						trifans->getPositionIndexArray().erase(currentTrifanVertexCount);
+						trifans->getNormalIndexArray().erase(currentTrifanVertexCount);
 
 						const COLLADAFW::IndexListArray& colorIndicesArray = trifans->getColorIndicesArray ();
 						for ( size_t i=0; i<colorIndicesArray.getCount (); ++i )
-							trifans->getColorIndices(i)->getIndices ().erase(currentTrifanVertexCount);
+							trifans->getColorIndices(i)->getIndexArray().erase(currentTrifanVertexCount);
 
 						const COLLADAFW::IndexListArray& uvCoordIndicesArray = trifans->getUVCoordIndicesArray ();
 						for ( size_t i=0; i<uvCoordIndicesArray.getCount (); ++i )
-							trifans->getUVCoordIndices(i)->getIndices ().erase(currentTrifanVertexCount);
+							trifans->getUVCoordIndices(i)->getIndexArray().erase(currentTrifanVertexCount);
 					}
 					mCurrentLastPrimitiveVertexCount = mCurrentVertexCount;
 				}
@@ -1451,6 +1569,7 @@ namespace COLLADASaxFWL
 				{
 					loadSourceElements(mMeshPrimitiveInputs);
 					initializeOffsets();
+					initializeIndexWidths();
 				}
 			}
 			break;
@@ -1502,16 +1621,16 @@ namespace COLLADASaxFWL
 					}
 					else
 					{
-						trifans->getPositionIndices().erase(currentTrifanVertexCount);
-						trifans->getNormalIndices().erase(currentTrifanVertexCount);
+						trifans->getPositionIndexArray().erase(currentTrifanVertexCount);
+						trifans->getNormalIndexArray().erase(currentTrifanVertexCount);
 
 						const COLLADAFW::IndexListArray& colorIndicesArray = trifans->getColorIndicesArray ();
 						for ( size_t i=0; i<colorIndicesArray.getCount (); ++i )
-							trifans->getColorIndices(i)->getIndices ().erase(currentTrifanVertexCount);
+							trifans->getColorIndices(i)->getIndexArray().erase(currentTrifanVertexCount);
 
 						const COLLADAFW::IndexListArray& uvCoordIndicesArray = trifans->getUVCoordIndicesArray ();
 						for ( size_t i=0; i<uvCoordIndicesArray.getCount (); ++i )
-							trifans->getUVCoordIndices(i)->getIndices ().erase(currentTrifanVertexCount);
+							trifans->getUVCoordIndices(i)->getIndexArray().erase(currentTrifanVertexCount);
 					}
 					mCurrentLastPrimitiveVertexCount = mCurrentVertexCount;
 				}
@@ -1532,16 +1651,16 @@ namespace COLLADASaxFWL
 					}
 					else
 					{
-						tristrips->getPositionIndices().erase(currentTristripVertexCount);
-						tristrips->getNormalIndices().erase(currentTristripVertexCount);
+						tristrips->getPositionIndexArray().erase(currentTristripVertexCount);
+						tristrips->getNormalIndexArray().erase(currentTristripVertexCount);
 
 						const COLLADAFW::IndexListArray& colorIndicesArray = tristrips->getColorIndicesArray ();
 						for ( size_t i=0; i<colorIndicesArray.getCount (); ++i )
-							tristrips->getColorIndices(i)->getIndices().erase(currentTristripVertexCount);
+							tristrips->getColorIndices(i)->getIndexArray().erase(currentTristripVertexCount);
 
 						const COLLADAFW::IndexListArray& uvCoordIndicesArray = tristrips->getUVCoordIndicesArray ();
 						for ( size_t i=0; i<uvCoordIndicesArray.getCount (); ++i )
-							tristrips->getUVCoordIndices(i)->getIndices ().erase(currentTristripVertexCount);
+							tristrips->getUVCoordIndices(i)->getIndexArray().erase(currentTristripVertexCount);
 					}
 					mCurrentLastPrimitiveVertexCount = mCurrentVertexCount;
 				}
@@ -1562,16 +1681,16 @@ namespace COLLADASaxFWL
 					}
 					else
 					{
-						linestrips->getPositionIndices().erase(currentLinestripVertexCount);
-						linestrips->getNormalIndices().erase(currentLinestripVertexCount);
+						linestrips->getPositionIndexArray().erase(currentLinestripVertexCount);
+						linestrips->getNormalIndexArray().erase(currentLinestripVertexCount);
 
 						const COLLADAFW::IndexListArray& colorIndicesArray = linestrips->getColorIndicesArray ();
 						for ( size_t i=0; i<colorIndicesArray.getCount (); ++i )
-							linestrips->getColorIndices(i)->getIndices().erase(currentLinestripVertexCount);
+							linestrips->getColorIndices(i)->getIndexArray().erase(currentLinestripVertexCount);
 
 						const COLLADAFW::IndexListArray& uvCoordIndicesArray = linestrips->getUVCoordIndicesArray ();
 						for ( size_t i=0; i<uvCoordIndicesArray.getCount (); ++i )
-							linestrips->getUVCoordIndices(i)->getIndices ().erase(currentLinestripVertexCount);
+							linestrips->getUVCoordIndices(i)->getIndexArray().erase(currentLinestripVertexCount);
 					}
 					mCurrentLastPrimitiveVertexCount = mCurrentVertexCount;
 				}
@@ -1625,5 +1744,43 @@ namespace COLLADASaxFWL
 		return writePrimitiveIndices(data, length);
 	}
 
+	//------------------------------
+	bool MeshLoader::loadBinaryArrayValues( const BinaryArray& binaryArray, const char* values )
+	{
+		switch ( mCurrentPrimitiveType )
+		{
+		case NONE:
+			return SourceArrayLoader::loadBinaryArrayValues( binaryArray, values );
+		case TRIANGLES:
+		case POLYLIST:
+		case LINES:
+			break;
+		default:
+			return !handleFWLError( SaxFWLError::ERROR_DATA_NOT_SUPPORTED, "Binary arrays are only supported for triangles, polylist and lines." );
+		}
+
+		if ( binaryArray.getValueType() != BinaryArray::VALUE_TYPE_UINT32 )
+		{
+			return !handleFWLError( SaxFWLError::ERROR_DATA_NOT_VALID, "Binary array of primitive indices must be of type uint32." );
+		}
+
+		// pass the indices in chunks to the same functions a p element is passed to
+		const size_t CHUNK_SIZE = 4096;
+		unsigned long long indices[CHUNK_SIZE];
+		size_t count = (size_t)binaryArray.getCount();
+
+		if ( !begin__p() )
+			return false;
+		for ( size_t first = 0; first < count; first += CHUNK_SIZE )
+		{
+			size_t chunkCount = std::min( CHUNK_SIZE, count - first );
+			for ( size_t i = 0; i < chunkCount; ++i )
+				indices[i] = binaryArray.getValue<unsigned long long>( values, first + i );
+			if ( !writePrimitiveIndices( indices, chunkCount ) )
+				return false;
+		}
+		return end__p();
+	}
+
 
 } // namespace COLLADASaxFWL
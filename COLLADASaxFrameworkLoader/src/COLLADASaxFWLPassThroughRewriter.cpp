@@ -0,0 +1,372 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLPassThroughRewriter.h"
+
+#include "COLLADABUMemoryMappedFile.h"
+
+#include "GeneratedSaxParserIInputStream.h"
+
+#include "CommonBuffer.h"
+#include "CommonFWriteBufferFlusher.h"
+
+#include <cstring>
+
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+#	include "GeneratedSaxParserLibxmlSaxParser.h"
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+#	include "GeneratedSaxParserExpatSaxParser.h"
+#else
+#	error "No prepocesser flag set to chose the xml parser to use"
+#endif
+
+
+namespace COLLADASaxFWL
+{
+	namespace
+	{
+		const size_t REWRITER_XMLPARSER_BUFFERSIZE = 64*1024;
+
+		/** The size of the blocks the input is passed to the sax parser in.*/
+		const size_t REWRITER_INPUT_BLOCKSIZE = 1024*1024;
+
+		/** The size of the output buffer. Written data and short input ranges are collected in it.*/
+		const size_t REWRITER_OUTPUT_BUFFERSIZE = 64*1024;
+
+		/** Input ranges of at least this size are passed to the flusher directly.*/
+		const size_t REWRITER_DIRECT_FLUSH_SIZE = 4*1024;
+
+		/** Passes a document in memory to the sax parser block by block. Unlike parseBuffer(), this
+		works for documents larger than 2GB.*/
+		class MemoryInputStream : public GeneratedSaxParser::IInputStream
+		{
+		private:
+			const char* mData;
+			size_t mLength;
+			size_t mPosition;
+
+		public:
+			MemoryInputStream( const char* data, size_t length )
+				: mData(data), mLength(length), mPosition(0) {}
+
+			virtual const char* getNextBlock( size_t& blockSize )
+			{
+				if ( mPosition >= mLength )
+					return 0;
+				const char* block = mData + mPosition;
+				blockSize = std::min( REWRITER_INPUT_BLOCKSIZE, mLength - mPosition );
+				mPosition += blockSize;
+				return block;
+			}
+
+			virtual bool hasFailed() const { return false; }
+		};
+	}
+
+	//------------------------------
+	PassThroughRewriter::PassThroughRewriter( IPassThroughHandler* handler, IErrorHandler* errorHandler )
+		: GeneratedSaxParser::Parser( &mSaxParserErrorHandler )
+		, mSaxParserErrorHandler( errorHandler )
+		, mHandler( handler )
+		, mInput( 0 )
+		, mInputLength( 0 )
+		, mOutput( 0 )
+		, mPendingOffset( 0 )
+		, mInsertOffset( 0 )
+		, mLastTagEnd( 0 )
+		, mSkipDepth( 0 )
+		, mIsRemovingSkippedElement( false )
+		, mIsRemovingText( false )
+		, mOpenEmptyElementOnWrite( false )
+		, mNeedsEndTag( false )
+		, mHasWriteError( false )
+	{
+	}
+
+	//------------------------------
+	PassThroughRewriter::~PassThroughRewriter()
+	{
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::rewrite( const String& inputFileName, const String& outputFileName )
+	{
+		COLLADABU::MemoryMappedFile inputFile;
+		if ( !inputFile.open( COLLADABU::NativeString(inputFileName) ) )
+		{
+			GeneratedSaxParser::ParserError error( GeneratedSaxParser::ParserError::SEVERITY_CRITICAL,
+			                                       GeneratedSaxParser::ParserError::ERROR_COULD_NOT_OPEN_FILE,
+			                                       0, 0, 0, 0, inputFileName.c_str() );
+			mSaxParserErrorHandler.handleError( error );
+			return false;
+		}
+
+		Common::FWriteBufferFlusher outputFile( outputFileName.c_str() );
+		if ( outputFile.getError() != 0 )
+		{
+			GeneratedSaxParser::ParserError error( GeneratedSaxParser::ParserError::SEVERITY_CRITICAL,
+			                                       GeneratedSaxParser::ParserError::ERROR_COULD_NOT_OPEN_FILE,
+			                                       0, 0, 0, 0, outputFileName.c_str() );
+			mSaxParserErrorHandler.handleError( error );
+			return false;
+		}
+
+		return rewrite( inputFileName, inputFile.getData(), inputFile.getSize(), &outputFile );
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::rewrite( const String& uri, const char* buffer, size_t length, Common::IBufferFlusher* output )
+	{
+		Common::Buffer outputBuffer( REWRITER_OUTPUT_BUFFERSIZE, output );
+		outputBuffer.setDirectFlushSize( REWRITER_DIRECT_FLUSH_SIZE );
+
+		mInput = buffer;
+		mInputLength = length;
+		mOutput = &outputBuffer;
+		mPendingOffset = 0;
+		mInsertOffset = 0;
+		mLastTagEnd = 0;
+		mSkipDepth = 0;
+		mIsRemovingSkippedElement = false;
+		mIsRemovingText = false;
+		mOpenEmptyElementOnWrite = false;
+		mNeedsEndTag = false;
+		mHasWriteError = false;
+		mOpenElements.clear();
+
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+		GeneratedSaxParser::LibxmlSaxParser saxParser( this );
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+		GeneratedSaxParser::ExpatSaxParser saxParser( this, REWRITER_XMLPARSER_BUFFERSIZE );
+#endif
+		MemoryInputStream inputStream( buffer, length );
+		bool success = saxParser.parseStream( uri.c_str(), inputStream ) && !mSaxParserErrorHandler.hasCriticalError();
+
+		if ( success )
+		{
+			// everything behind the root element
+			success = copyInput( mInputLength ) && outputBuffer.flushFlusher();
+		}
+
+		mInput = 0;
+		mInputLength = 0;
+		mOutput = 0;
+		mOpenElements.clear();
+		return success && !mHasWriteError;
+	}
+
+	//------------------------------
+	size_t PassThroughRewriter::findTagStart( size_t tagEnd ) const
+	{
+		// '<' is not allowed in attribute values, so the first '<' in front of the tag end starts the tag
+		size_t offset = tagEnd;
+		while ( offset > 0 )
+		{
+			offset--;
+			if ( mInput[offset] == '<' )
+				return offset;
+		}
+		return 0;
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::copyToOutput( const char* data, size_t length )
+	{
+		if ( length == 0 )
+			return true;
+		if ( !mOutput->copyToBuffer( data, length ) )
+		{
+			mHasWriteError = true;
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::copyInput( size_t offset )
+	{
+		if ( offset <= mPendingOffset )
+			return true;
+		size_t pendingOffset = mPendingOffset;
+		mPendingOffset = offset;
+		return copyToOutput( mInput + pendingOffset, offset - pendingOffset );
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::write( const char* data, size_t length )
+	{
+		if ( !mOutput )
+			return false;
+		copyInput( mInsertOffset );
+		if ( mOpenEmptyElementOnWrite )
+		{
+			// the empty element tag has been copied without its "/>"
+			mOpenEmptyElementOnWrite = false;
+			mNeedsEndTag = true;
+			copyToOutput( ">", 1 );
+		}
+		return copyToOutput( data, length );
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::write( const String& text )
+	{
+		return write( text.c_str(), text.length() );
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::writeEndTag( const ParserChar* elementName )
+	{
+		return copyToOutput( "</", 2 )
+			&& copyToOutput( elementName, strlen(elementName) )
+			&& copyToOutput( ">", 1 );
+	}
+
+	//------------------------------
+	const char* PassThroughRewriter::getCurrentStartTag( size_t& length ) const
+	{
+		if ( mOpenElements.empty() )
+		{
+			length = 0;
+			return 0;
+		}
+		const OpenElement& element = mOpenElements.back();
+		length = element.startTagEnd - element.startTagOffset;
+		return mInput + element.startTagOffset;
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::elementBegin( const ParserChar* elementName, const ParserAttributes& attributes )
+	{
+		if ( mSkipDepth > 0 )
+		{
+			mSkipDepth++;
+			return true;
+		}
+
+		size_t startTagEnd = getMarkupEndOffset();
+		size_t startTagOffset = findTagStart( startTagEnd );
+
+		if ( mIsRemovingText )
+		{
+			mPendingOffset = startTagOffset;
+			mIsRemovingText = false;
+		}
+
+		OpenElement element;
+		element.startTagOffset = startTagOffset;
+		element.startTagEnd = startTagEnd;
+		element.isEmpty = (startTagEnd >= 2) && (mInput[startTagEnd - 2] == '/');
+		element.startTagReplaced = false;
+		mOpenElements.push_back( element );
+
+		mInsertOffset = startTagOffset;
+		IPassThroughHandler::ElementAction action = mHandler->elementBegin( elementName, attributes, *this );
+		mLastTagEnd = startTagEnd;
+
+		switch ( action )
+		{
+		case IPassThroughHandler::COPY_ELEMENT:
+			mOpenElements.pop_back();
+			mSkipDepth = 1;
+			mIsRemovingSkippedElement = false;
+			break;
+		case IPassThroughHandler::REMOVE_ELEMENT:
+			mOpenElements.pop_back();
+			copyInput( startTagOffset );
+			mSkipDepth = 1;
+			mIsRemovingSkippedElement = true;
+			break;
+		case IPassThroughHandler::COPY_START_TAG:
+			break;
+		case IPassThroughHandler::REPLACE_START_TAG:
+			copyInput( startTagOffset );
+			mPendingOffset = startTagEnd;
+			mOpenElements.back().startTagReplaced = true;
+			break;
+		}
+		return !mHasWriteError;
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::elementEnd( const ParserChar* elementName )
+	{
+		size_t endTagEnd = getMarkupEndOffset();
+
+		if ( mSkipDepth > 0 )
+		{
+			mSkipDepth--;
+			if ( mSkipDepth == 0 )
+			{
+				if ( mIsRemovingSkippedElement )
+					mPendingOffset = endTagEnd;
+				mLastTagEnd = endTagEnd;
+			}
+			return true;
+		}
+
+		const OpenElement& element = mOpenElements.back();
+
+		if ( !element.isEmpty )
+		{
+			size_t endTagOffset = findTagStart( endTagEnd );
+			if ( mIsRemovingText )
+			{
+				mPendingOffset = endTagOffset;
+				mIsRemovingText = false;
+			}
+			mInsertOffset = endTagOffset;
+			mHandler->elementEnd( elementName, *this );
+		}
+		else if ( !element.startTagReplaced )
+		{
+			// content written by the handler turns the empty element tag into a start tag
+			mInsertOffset = endTagEnd - 2;
+			mOpenEmptyElementOnWrite = true;
+			mHandler->elementEnd( elementName, *this );
+			mOpenEmptyElementOnWrite = false;
+			if ( mNeedsEndTag )
+			{
+				mNeedsEndTag = false;
+				writeEndTag( elementName );
+				mPendingOffset = endTagEnd;
+			}
+		}
+		else
+		{
+			// the replaced start tag is never an empty element tag
+			mInsertOffset = endTagEnd;
+			mHandler->elementEnd( elementName, *this );
+			writeEndTag( elementName );
+		}
+
+		mOpenElements.pop_back();
+		mLastTagEnd = endTagEnd;
+		return !mHasWriteError;
+	}
+
+	//------------------------------
+	bool PassThroughRewriter::textData( const ParserChar* text, size_t textLength )
+	{
+		if ( mSkipDepth > 0 || mOpenElements.empty() )
+			return true;
+
+		mInsertOffset = mLastTagEnd;
+		if ( !mHandler->textData( text, textLength, *this ) && !mIsRemovingText )
+		{
+			// the text starts behind the last tag and is removed up to the next tag
+			copyInput( mLastTagEnd );
+			mIsRemovingText = true;
+		}
+		return !mHasWriteError;
+	}
+
+} // namespace COLLADASaxFWL
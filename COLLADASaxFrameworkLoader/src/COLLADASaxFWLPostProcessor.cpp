@@ -13,6 +13,7 @@
 
 #include "COLLADASaxFWLFormulasLinker.h"
 #include "COLLADASaxFWLKinematicsSceneCreator.h"
+#include "COLLADASaxFWLTracer.h"
 
 #include "COLLADAFWIWriter.h"
 #include "COLLADAFWMorphController.h"
@@ -36,54 +37,69 @@ namespace COLLADASaxFWL
 	//---------------------------------
 	void PostProcessor::postProcess()
 	{
+		Tracer* tracer = getColladaLoader()->getTracer();
+
 		if ( (getObjectFlags() & Loader::ANIMATION_LIST_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "createMissingAnimationLists", "postprocess" );
 			createMissingAnimationLists();
 		}
 
 		if ( (getObjectFlags() & Loader::EFFECT_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "writeEffects", "postprocess" );
 			writeEffects();
 		}
 
 		if ( (getObjectFlags() & Loader::LIGHT_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "writeLights", "postprocess" );
 			writeLights();
 		}
 
 		if ( (getObjectFlags() & Loader::CAMERA_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "writeCameras", "postprocess" );
 			writeCameras();
 		}
 
 		if ( (getObjectFlags() & Loader::CONTROLLER_FLAG) != 0 )
 		{
-			createAndWriteSkinControllers();
+			{
+				TraceSpan span( tracer, "createAndWriteSkinControllers", "postprocess" );
+				createAndWriteSkinControllers();
+			}
+			TraceSpan span( tracer, "writeMorphControllers", "postprocess" );
 			writeMorphControllers();
 		}
 
 		if ( (getObjectFlags() & Loader::VISUAL_SCENES_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "writeVisualScenes", "postprocess" );
 			writeVisualScenes();
 		}
 
 		if ( (getObjectFlags() & Loader::LIBRARY_NODES_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "writeLibraryNodes", "postprocess" );
 			writeLibraryNodes();
 		}
 
 		if ( (getObjectFlags() & Loader::ANIMATION_LIST_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "writeAnimationLists", "postprocess" );
 			writeAnimationLists();
 		}
 
 		if ( (getObjectFlags() & Loader::FORMULA_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "linkAndWriteFormulas", "postprocess" );
 			linkAndWriteFormulas();
 		}
 
 		if ( (getObjectFlags() & Loader::KINEMATICS_FLAG) != 0 )
 		{
+			TraceSpan span( tracer, "createAndWriteKinematicsScene", "postprocess" );
 			createAndWriteKinematicsScene();
 		}
 	}
@@ -96,6 +112,8 @@ namespace COLLADASaxFWL
 			COLLADAFW::VisualScene *visualScene = mVisualScenes[i];
 			writer()->writeVisualScene(visualScene);
 		}
+		if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_VISUAL_SCENE ) )
+			mColladaLoader->addObjectsOwnedByWriter( COLLADAFW::IWriter::OBJECT_VISUAL_SCENE );
 	}
 
 	//-----------------------------
@@ -106,6 +124,8 @@ namespace COLLADASaxFWL
 			COLLADAFW::LibraryNodes *libraryNodes = mLibraryNodes[i];
 			writer()->writeLibraryNodes(libraryNodes);
 		}
+		if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_LIBRARY_NODES ) )
+			mColladaLoader->addObjectsOwnedByWriter( COLLADAFW::IWriter::OBJECT_LIBRARY_NODES );
 	}
 
 	//-----------------------------
@@ -116,6 +136,8 @@ namespace COLLADASaxFWL
 			COLLADAFW::Effect *effect = mEffects[i];
 			writer()->writeEffect(effect);
 		}
+		if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_EFFECT ) )
+			mColladaLoader->addObjectsOwnedByWriter( COLLADAFW::IWriter::OBJECT_EFFECT );
 	}
 
 	//-----------------------------
@@ -126,6 +148,8 @@ namespace COLLADASaxFWL
 			COLLADAFW::Light *light = mLights[i];
 			writer()->writeLight(light);
 		}
+		if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_LIGHT ) )
+			mColladaLoader->addObjectsOwnedByWriter( COLLADAFW::IWriter::OBJECT_LIGHT );
 	}
 
 	//-----------------------------
@@ -136,6 +160,8 @@ namespace COLLADASaxFWL
 			COLLADAFW::Camera *camera = mCameras[i];
 			writer()->writeCamera(camera);
 		}
+		if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_CAMERA ) )
+			mColladaLoader->addObjectsOwnedByWriter( COLLADAFW::IWriter::OBJECT_CAMERA );
 	}
 
 	//-----------------------------
@@ -202,11 +228,12 @@ namespace COLLADASaxFWL
 	//-----------------------------
 	bool PostProcessor::writeMorphControllers()
 	{
-		const Loader::MorphControllerList& morphControllerList = mColladaLoader->getMorphControllerList();
-		Loader::MorphControllerList::const_iterator it = morphControllerList.begin();
-		for ( ; it != morphControllerList.end(); ++it)
+		Loader::MorphControllerList& morphControllerList = mColladaLoader->getMorphControllerList();
+		const bool writerOwnsControllers = writerOwnsObjects( COLLADAFW::IWriter::OBJECT_CONTROLLER );
+		Loader::MorphControllerList::iterator morphControllerIt = morphControllerList.begin();
+		for ( ; morphControllerIt != morphControllerList.end(); ++morphControllerIt)
 		{
-			const COLLADAFW::MorphController* morphController = *it;
+			const COLLADAFW::MorphController* morphController = *morphControllerIt;
 			const COLLADAFW::UniqueId& morphControllerUniqueId = morphController->getUniqueId();
 			const Loader::InstanceControllerDataList& instanceControllerDataList = getInstanceControllerDataListByControllerUniqueId(morphControllerUniqueId);
 
@@ -219,8 +246,21 @@ namespace COLLADASaxFWL
 			}
 
 			if ( ! writer()->writeController( morphController ) )
+			{
+				if ( writerOwnsControllers )
+				{
+					// the failed controller already belongs to the writer, delete the ones not handed over
+					Loader::MorphControllerList::iterator unwrittenIt = morphControllerIt + 1;
+					for ( ; unwrittenIt != morphControllerList.end(); ++unwrittenIt )
+						FW_DELETE *unwrittenIt;
+					morphControllerList.erase( morphControllerIt + 1, morphControllerList.end() );
+					mColladaLoader->addObjectsOwnedByWriter( COLLADAFW::IWriter::OBJECT_CONTROLLER );
+				}
 				return false;
+			}
 		}
+		if ( writerOwnsControllers )
+			mColladaLoader->addObjectsOwnedByWriter( COLLADAFW::IWriter::OBJECT_CONTROLLER );
 		return true;
 	}
 
@@ -233,6 +273,8 @@ namespace COLLADASaxFWL
 			COLLADAFW::AnimationList* animationList = it->second;
 			writer()->writeAnimationList( animationList );
 		}
+		if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_ANIMATION_LIST ) )
+			mColladaLoader->addObjectsOwnedByWriter( COLLADAFW::IWriter::OBJECT_ANIMATION_LIST );
 	}
 
 	//-----------------------------
@@ -251,7 +293,8 @@ namespace COLLADASaxFWL
 		formulasLinker.link();
 
 		writer()->writeFormulas(formulas);
-		FW_DELETE formulas;
+		if ( !writerOwnsObjects( COLLADAFW::IWriter::OBJECT_FORMULAS ) )
+			FW_DELETE formulas;
 	}
 
 	//-----------------------------
@@ -260,7 +303,8 @@ namespace COLLADASaxFWL
 		KinematicsSceneCreator kinematicsSceneCreator( this );
 		COLLADAFW::KinematicsScene* kinematicsScene = kinematicsSceneCreator.createAndGetKinematicsScene();
 		writer()->writeKinematicsScene( kinematicsScene );
-		FW_DELETE kinematicsScene;
+		if ( !writerOwnsObjects( COLLADAFW::IWriter::OBJECT_KINEMATICS_SCENE ) )
+			FW_DELETE kinematicsScene;
 	}
 
 
@@ -21,6 +21,8 @@ namespace COLLADASaxFWL
 
 	SaxParserErrorHandler::SaxParserErrorHandler( COLLADASaxFWL::IErrorHandler* errorHandler )
 		: mErrorHandler(errorHandler)
+		, mHasErrors(false)
+		, mHasCriticalError(false)
 	{
 	}
 
@@ -31,6 +33,11 @@ namespace COLLADASaxFWL
 
 	bool SaxParserErrorHandler::handleError( const GeneratedSaxParser::ParserError& error )
 	{
+		if ( error.getSeverity() == GeneratedSaxParser::ParserError::SEVERITY_CRITICAL )
+			mHasCriticalError = true;
+		else
+			mHasErrors = true;
+
 		SaxParserError saxParserError(error);
 
 		if ( mErrorHandler)
@@ -66,6 +66,8 @@ namespace COLLADASaxFWL
 		if ( (getObjectFlags() & Loader::SCENE_FLAG) != 0 )
 		{
 			success = writer()->writeScene ( mCurrentScene );
+			if ( writerOwnsObjects( COLLADAFW::IWriter::OBJECT_SCENE ) )
+				mCurrentScene = 0;
 		}
         delete mCurrentScene;
         finish();
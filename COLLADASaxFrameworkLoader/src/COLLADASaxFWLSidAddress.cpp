@@ -21,6 +21,32 @@ namespace COLLADASaxFWL
 	const int regExpMatchesVectorLength = 30;    /* should be a multiple of 3 */
 	const char* sidSeparator = "/";
 
+	/** The compiled patterns are created by SidAddressPatternsInitializer during static initialization,
+	since function local statics are not initialized thread safe by all supported compilers.*/
+	// regular expression: "(.+)\.(.+)"
+	static pcre* getAccessorNamePattern()
+	{
+		static const COLLADABU::PcreCompiledPattern accessorNameRegexCompiledPattern("(.+)\\.(.+)");
+		return accessorNameRegexCompiledPattern.getCompiledPattern();
+	}
+
+	// regular expression: "([^(]+)(?:\(([0-9]+)\))?(?:\(([0-9]+)\))?"
+	static pcre* getAccessorIndexPattern()
+	{
+		static const COLLADABU::PcreCompiledPattern accessorIndexRegexCompiledPattern("([^(]+)(?:\\(([0-9]+)\\))?(?:\\(([0-9]+)\\))?");
+		return accessorIndexRegexCompiledPattern.getCompiledPattern();
+	}
+
+	/** Creates the compiled patterns during static initialization.*/
+	static struct SidAddressPatternsInitializer
+	{
+		SidAddressPatternsInitializer()
+		{
+			getAccessorNamePattern();
+			getAccessorIndexPattern();
+		}
+	} sidAddressPatternsInitializer;
+
 	//------------------------------
 	SidAddress::SidAddress( )
 		: mMemberSelection(MEMBER_SELECTION_NONE)
@@ -111,9 +137,7 @@ namespace COLLADASaxFWL
 		int secondPartLength = (int)sidAddress.length() - (int)lastSidSeparator - 1;
 
 
-		// regular expression: "(.+)\.(.+)"
-		static const COLLADABU::PcreCompiledPattern accessorNameRegexCompiledPattern("(.+)\\.(.+)");
-		pcre* accessorNameRegex = accessorNameRegexCompiledPattern.getCompiledPattern();
+		pcre* accessorNameRegex = getAccessorNamePattern();
 
 		int accessorNameMatches[regExpMatchesVectorLength];
 
@@ -164,9 +188,7 @@ namespace COLLADASaxFWL
 		}
 		else 
 		{
-			// regular expression: "([^(]+)(?:\(([0-9]+)\))?(?:\(([0-9]+)\))?"
-			static const COLLADABU::PcreCompiledPattern accessorIndexRegexCompiledPattern("([^(]+)(?:\\(([0-9]+)\\))?(?:\\(([0-9]+)\\))?");
-			pcre* accessorIndexRegex = accessorIndexRegexCompiledPattern.getCompiledPattern();
+			pcre* accessorIndexRegex = getAccessorIndexPattern();
 
 			int accessorIndexMatches[regExpMatchesVectorLength];
 
@@ -10,8 +10,15 @@
 
 #include "COLLADASaxFWLStableHeaders.h"
 #include "COLLADASaxFWLSourceArrayLoader.h"
+#include "COLLADASaxFWLBinaryArray.h"
+#include "COLLADASaxFWLFileLoader.h"
+#include "COLLADASaxFWLLoader.h"
 #include "COLLADAFWTypes.h"
 
+#include "COLLADABUMemoryMappedFile.h"
+
+#include <math.h>
+
 namespace COLLADASaxFWL
 {
 
@@ -26,7 +33,8 @@ namespace COLLADASaxFWL
 	SourceArrayLoader::SourceArrayLoader(IFilePartLoader* callingFilePartLoader)
 		:FilePartLoader(callingFilePartLoader),
 		 mSourceArray( SourceArray::OWNER ),
-		 mCurrentSoure(0)
+		 mCurrentSoure(0),
+		 mCurrentSourceIdHash(0)
 	{
 	}
 
@@ -57,6 +65,19 @@ namespace COLLADASaxFWL
 		for ( size_t i = 0, count = mSourceArray.getCount(); i < count; ++i)
 			delete mSourceArray[i];
 		mSourceArray.setCount(0);
+		mSourceIndex.clear();
+	}
+
+	//------------------------------
+	void SourceArrayLoader::rebuildSourceIndex()
+	{
+		mSourceIndex.clear();
+		for ( size_t i = 0, count = mSourceArray.getCount(); i < count; ++i)
+		{
+			const String& sourceId = mSourceArray[i]->getId();
+			StringHash sourceIdHash = Utils::calculateStringHash( sourceId.c_str(), sourceId.length() );
+			mSourceIndex.insert( std::make_pair( sourceIdHash, i ) );
+		}
 	}
 
 	//------------------------------
@@ -69,8 +90,7 @@ namespace COLLADASaxFWL
 			FloatSource* source = ( FloatSource* ) sourceBase;
 			FloatArrayElement& arrayElement = source->getArrayElement();
 			COLLADAFW::FloatArray& valuesArray = arrayElement.getValues();
-			values->setData ( valuesArray.getData (), valuesArray.getCount () );
-			valuesArray.yieldOwnerShip();
+			moveValues( valuesArray, *values );
 			return true;
 		}
 		else if (sourceBase->getDataType() == SourceBase::DATA_TYPE_DOUBLE)
@@ -80,8 +100,8 @@ namespace COLLADASaxFWL
 			DoubleSource* source = ( DoubleSource* ) sourceBase;
 			DoubleArrayElement& arrayElement = source->getArrayElement();
 			COLLADAFW::DoubleArray& valuesArray = arrayElement.getValues();
-			values->setData ( valuesArray.getData (), valuesArray.getCount () );
-			valuesArray.yieldOwnerShip();
+			moveValues( valuesArray, *values );
+			applyNumericPrecision( floatOrDoubleArray );
 			return true;
 		}
 		else
@@ -91,12 +111,73 @@ namespace COLLADASaxFWL
 	}
 
 	//------------------------------
-	COLLADAFW::String SourceArrayLoader::getIdFromURIFragmentType( const char* uriFragment )
+	void SourceArrayLoader::applyNumericPrecision( COLLADAFW::FloatOrDoubleArray& values, double* maxError )
 	{
-		if ( !uriFragment )
-			return "";
+		Loader* loader = getColladaLoader();
+		if ( loader->getNumericPrecision() == Loader::PRECISION_KEEP )
+			return;
 
-		const char* startPos = uriFragment;
+		double error = values.convertToFloat();
+		double& errorBound = maxError ? *maxError : loader->getPrecisionErrors().others;
+		if ( error > errorBound )
+			errorBound = error;
+	}
+
+	//------------------------------
+	template<class Type>
+	void SourceArrayLoader::appendSourceValuesTemplate( COLLADAFW::ArrayPrimitiveType<Type>& sourceValues, COLLADAFW::FloatOrDoubleArray& values, double& maxError,
+		COLLADAFW::QuantizedArray::Encoding encoding, size_t dimension )
+	{
+		double error = 0;
+		if ( (getColladaLoader()->getNumericPrecision() == Loader::PRECISION_QUANTIZED) && (dimension > 0) && values.appendQuantized( sourceValues, encoding, dimension ) )
+		{
+			error = values.getQuantizedValues()->getMaxError();
+		}
+		else
+		{
+			// the values of previous sources are decoded, but not encoded again
+			values.dequantize();
+			error = values.convertToFloat();
+			if ( values.empty() )
+				values.setType( COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT );
+
+			COLLADAFW::FloatArray& floatValues = *values.getFloatValues();
+			const size_t count = sourceValues.getCount();
+			floatValues.reallocMemory( floatValues.getCount() + count );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				const float value = (float)sourceValues[i];
+				floatValues.append( value );
+				const double valueError = fabs( (double)sourceValues[i] - value );
+				if ( valueError > error )
+					error = valueError;
+			}
+		}
+
+		// the full precision values are not needed anymore
+		sourceValues.clear();
+		if ( error > maxError )
+			maxError = error;
+	}
+
+	//------------------------------
+	void SourceArrayLoader::appendSourceValues( COLLADAFW::FloatArray& sourceValues, COLLADAFW::FloatOrDoubleArray& values, double& maxError,
+		COLLADAFW::QuantizedArray::Encoding encoding, size_t dimension )
+	{
+		appendSourceValuesTemplate( sourceValues, values, maxError, encoding, dimension );
+	}
+
+	//------------------------------
+	void SourceArrayLoader::appendSourceValues( COLLADAFW::DoubleArray& sourceValues, COLLADAFW::FloatOrDoubleArray& values, double& maxError,
+		COLLADAFW::QuantizedArray::Encoding encoding, size_t dimension )
+	{
+		appendSourceValuesTemplate( sourceValues, values, maxError, encoding, dimension );
+	}
+
+	//------------------------------
+	const ParserChar* SourceArrayLoader::findIdInURIFragment( const ParserChar* uriFragment, size_t& idLength )
+	{
+		const ParserChar* startPos = uriFragment;
 		while ( *startPos && GeneratedSaxParser::Utils::isWhiteSpace(*startPos))
 			startPos++;
 
@@ -104,11 +185,23 @@ namespace COLLADASaxFWL
 		if ( *startPos == '#' )
 			startPos++;
 
-		const char* endPos = startPos;
+		const ParserChar* endPos = startPos;
 		while ( *endPos && !GeneratedSaxParser::Utils::isWhiteSpace(*endPos) )
 			endPos++;
 
-		return String(startPos, endPos - startPos);
+		idLength = endPos - startPos;
+		return startPos;
+	}
+
+	//------------------------------
+	COLLADAFW::String SourceArrayLoader::getIdFromURIFragmentType( const char* uriFragment )
+	{
+		if ( !uriFragment )
+			return "";
+
+		size_t idLength;
+		const ParserChar* id = findIdInURIFragment( uriFragment, idLength );
+		return String(id, idLength);
 	}
 
     //------------------------------
@@ -121,37 +214,72 @@ namespace COLLADASaxFWL
     void SourceArrayLoader::setSourceArray ( const SourceArray& sourceArray )
     {
         mSourceArray = sourceArray;
+        rebuildSourceIndex();
     }
 
     //------------------------------
     const SourceBase* SourceArrayLoader::getSourceById ( const String& sourceId ) const
     {
-        for ( size_t i=0; i<mSourceArray.getCount (); ++i )
-        {
-            const SourceBase* source = mSourceArray [ i ];
-            if ( COLLADABU::Utils::equals ( source->getId (), sourceId ) )
-                return source;
-        }
-        return 0;
+        return getSourceById ( sourceId.c_str(), sourceId.length() );
     }
 
     //------------------------------
     SourceBase* SourceArrayLoader::getSourceById ( const String& sourceId ) 
     {
-        for ( size_t i=0; i<mSourceArray.getCount (); ++i )
-        {
-            SourceBase* source = mSourceArray [ i ];
-            if ( COLLADABU::Utils::equals ( source->getId (), sourceId ) )
-                return source;
-        }
-        return 0;
+        return getSourceById ( sourceId.c_str(), sourceId.length() );
     }
 
+	//------------------------------
+	const SourceBase* SourceArrayLoader::getSourceById ( const ParserChar* sourceId, size_t sourceIdLength ) const
+	{
+		StringHash sourceIdHash = Utils::calculateStringHash( sourceId, sourceIdLength );
+		std::pair<SourceIndexMap::const_iterator, SourceIndexMap::const_iterator> range = mSourceIndex.equal_range( sourceIdHash );
+
+		// If several sources have the same id, the one loaded first is returned
+		const SourceBase* foundSource = 0;
+		size_t foundIndex = mSourceArray.getCount();
+		for ( SourceIndexMap::const_iterator it = range.first; it != range.second; ++it )
+		{
+			size_t index = it->second;
+			if ( index >= foundIndex )
+				continue;
+			const SourceBase* source = mSourceArray [ index ];
+			const String& id = source->getId();
+			if ( (id.length() == sourceIdLength) && (id.compare( 0, sourceIdLength, sourceId, sourceIdLength ) == 0) )
+			{
+				foundSource = source;
+				foundIndex = index;
+			}
+		}
+		return foundSource;
+	}
+
+	//------------------------------
+	SourceBase* SourceArrayLoader::getSourceById ( const ParserChar* sourceId, size_t sourceIdLength )
+	{
+		const SourceArrayLoader* constThis = this;
+		return const_cast<SourceBase*>( constThis->getSourceById( sourceId, sourceIdLength ) );
+	}
+
+	//------------------------------
+	SourceBase* SourceArrayLoader::getSourceByURIFragment( const ParserChar* uriFragment )
+	{
+		if ( !uriFragment )
+			return 0;
+
+		size_t idLength;
+		const ParserChar* id = findIdInURIFragment( uriFragment, idLength );
+		return getSourceById( id, idLength );
+	}
+
 	//------------------------------
 	bool SourceArrayLoader::beginSource( const source__AttributeData& attributes )
 	{
 		if ( attributes.id )
+		{
 			mCurrentSourceId = attributes.id;
+			mCurrentSourceIdHash = Utils::calculateStringHash( mCurrentSourceId.c_str(), mCurrentSourceId.length() );
+		}
 		return true;
 	}
 
@@ -161,9 +289,11 @@ namespace COLLADASaxFWL
 	{
 		if ( mCurrentSoure )
 		{
+			mSourceIndex.insert( std::make_pair( mCurrentSourceIdHash, mSourceArray.getCount() ) );
 			mSourceArray.append(mCurrentSoure);
 		}
 		mCurrentSoure = 0;
+		mCurrentSourceIdHash = 0;
 		mCurrentSourceId.clear();
 		mCurrentArrayId.clear();
 		return true;
@@ -191,6 +321,77 @@ namespace COLLADASaxFWL
 		return true;
 	}
 
+	//------------------------------
+	bool SourceArrayLoader::begin__technique( const technique__AttributeData& attributeData )
+	{
+		if ( attributeData.profile && strcmp( attributeData.profile, BinaryArray::PROFILE ) == 0 )
+			getFileLoader()->getExtraDataElementHandler().setBinaryArrayLoader( this );
+		return FilePartLoader::begin__technique( attributeData );
+	}
+
+	//------------------------------
+	bool SourceArrayLoader::end__technique()
+	{
+		getFileLoader()->getExtraDataElementHandler().setBinaryArrayLoader( 0 );
+		return FilePartLoader::end__technique();
+	}
+
+	//------------------------------
+	bool SourceArrayLoader::loadBinaryArray( const GeneratedSaxParser::xmlChar** attributes )
+	{
+		BinaryArray binaryArray;
+		if ( !binaryArray.readAttributes( attributes ) )
+		{
+			return !handleFWLError( SaxFWLError::ERROR_DATA_NOT_VALID, "Invalid binary_array element." );
+		}
+
+		COLLADABU::URI fileUri( getFileUri(), binaryArray.getFile() );
+		const COLLADABU::MemoryMappedFile* file = getBinaryArrayFile( fileUri );
+		if ( !file )
+		{
+			return !handleFWLError( SaxFWLError::ERROR_DATA_NOT_VALID, "Could not open binary array file \"" + fileUri.getURIString() + "\"." );
+		}
+
+		const char* values = binaryArray.getValues( file->getData(), file->getSize() );
+		if ( !values || (binaryArray.getCount() > (size_t)-1) )
+		{
+			return !handleFWLError( SaxFWLError::ERROR_DATA_NOT_VALID, "Binary array exceeds the file \"" + fileUri.getURIString() + "\"." );
+		}
+
+		return loadBinaryArrayValues( binaryArray, values );
+	}
+
+	//------------------------------
+	bool SourceArrayLoader::loadBinaryArrayValues( const BinaryArray& binaryArray, const char* values )
+	{
+		if ( !mCurrentSoure || (mCurrentSoure->getDataType() != SourceBase::DATA_TYPE_FLOAT) )
+		{
+			return !handleFWLError( SaxFWLError::ERROR_DATA_NOT_SUPPORTED, "Binary arrays are only supported for float arrays." );
+		}
+
+		FloatSource* source = (FloatSource*)mCurrentSoure;
+		COLLADAFW::FloatArray& array = source->getArrayElement().getValues();
+		size_t count = (size_t)binaryArray.getCount();
+
+		if ( (binaryArray.getValueType() == BinaryArray::VALUE_TYPE_FLOAT32) 
+			&& BinaryArray::isNativeByteOrder() 
+			&& binaryArray.isAligned( values ) )
+		{
+			// use the mapped file directly. The array never writes to external data.
+			array.setExternalData( (float*)values, count );
+		}
+		else
+		{
+			array.setCount( 0 );
+			array.reallocMemory( count );
+			float* data = array.getData();
+			for ( size_t i = 0; i < count; ++i )
+				data[i] = binaryArray.getValue<float>( values, i );
+			array.setCount( count );
+		}
+		return true;
+	}
+
 	//------------------------------
 	bool SourceArrayLoader::begin__animation__source__technique_common()
 	{
@@ -160,8 +160,8 @@ namespace COLLADASaxFWL
         if( input )
         {
             // Get the source element with the uri of the input element.
-            COLLADABU::URI inputUrl = input->getSource ();
-            String sourceId = inputUrl.getFragment ();
+            const COLLADABU::URI& inputUrl = input->getSource ();
+            const String& sourceId = inputUrl.getFragment ();
             SourceBase* sourceBase = getSourceById ( sourceId );
             if ( sourceBase == 0 ) return false;
 
@@ -193,8 +193,7 @@ namespace COLLADASaxFWL
                     }
                     else
                     {
-                        positions.setData ( valuesArray.getData (), valuesArray.getCount () );
-                        valuesArray.yieldOwnerShip();
+                        moveValues ( valuesArray, *positions.getFloatValues () );
                     }
 
                     // Set the source base as loaded element.
@@ -223,8 +222,7 @@ namespace COLLADASaxFWL
                     }
                     else 
                     {
-                        positions.setData ( valuesArray.getData (), valuesArray.getCount () );
-                        valuesArray.yieldOwnerShip();
+                        moveValues ( valuesArray, *positions.getDoubleValues () );
                     }
 
                     // Set the source base as loaded element.
@@ -252,8 +250,8 @@ namespace COLLADASaxFWL
         if( input )
         {
             // Get the source element with the uri of the input element.
-            COLLADABU::URI inputUrl = input->getSource ();
-            String sourceId = inputUrl.getFragment ();
+            const COLLADABU::URI& inputUrl = input->getSource ();
+            const String& sourceId = inputUrl.getFragment ();
             SourceBase* sourceBase = getSourceById ( sourceId );
             if ( sourceBase == 0 ) return false;
 
@@ -285,8 +283,7 @@ namespace COLLADASaxFWL
                     }
                     else
                     {
-                        positions.setData ( valuesArray.getData (), valuesArray.getCount () );
-                        valuesArray.yieldOwnerShip();
+                        moveValues ( valuesArray, *positions.getFloatValues () );
                     }
 
                     // Set the source base as loaded element.
@@ -315,8 +312,7 @@ namespace COLLADASaxFWL
                     }
                     else 
                     {
-                        positions.setData ( valuesArray.getData (), valuesArray.getCount () );
-                        valuesArray.yieldOwnerShip();
+                        moveValues ( valuesArray, *positions.getDoubleValues () );
                     }
 
                     // Set the source base as loaded element.
@@ -344,8 +340,8 @@ namespace COLLADASaxFWL
         if( input )
         {
             // Get the source element with the uri of the input element.
-            COLLADABU::URI inputUrl = input->getSource ();
-            String sourceId = inputUrl.getFragment ();
+            const COLLADABU::URI& inputUrl = input->getSource ();
+            const String& sourceId = inputUrl.getFragment ();
             SourceBase* sourceBase = getSourceById ( sourceId );
             if ( sourceBase == 0 ) return false;
 
@@ -377,8 +373,7 @@ namespace COLLADASaxFWL
                     }
                     else
                     {
-                        positions.setData ( valuesArray.getData (), valuesArray.getCount () );
-                        valuesArray.yieldOwnerShip();
+                        moveValues ( valuesArray, *positions.getFloatValues () );
                     }
 
                     // Set the source base as loaded element.
@@ -407,8 +402,7 @@ namespace COLLADASaxFWL
                     }
                     else 
                     {
-                        positions.setData ( valuesArray.getData (), valuesArray.getCount () );
-                        valuesArray.yieldOwnerShip();
+                        moveValues ( valuesArray, *positions.getDoubleValues () );
                     }
 
                     // Set the source base as loaded element.
@@ -0,0 +1,192 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLTracer.h"
+
+#include <fstream>
+#include <stdio.h>
+
+#ifdef COLLADABU_OS_WIN
+#	include <windows.h>
+#else
+#	include <time.h>
+#	include <sys/time.h>
+#endif
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	static void writeJsonString( std::ostream& stream, const char* text )
+	{
+		stream << '"';
+		for ( const char* c = text; *c; ++c )
+		{
+			switch ( *c )
+			{
+			case '"':
+				stream << "\\\"";
+				break;
+			case '\\':
+				stream << "\\\\";
+				break;
+			default:
+				if ( (unsigned char)*c < 0x20 )
+				{
+					char escaped[8];
+					sprintf( escaped, "\\u%04x", (unsigned int)(unsigned char)*c );
+					stream << escaped;
+				}
+				else
+				{
+					stream << *c;
+				}
+			}
+		}
+		stream << '"';
+	}
+
+	//------------------------------
+	Tracer::Tracer()
+		: mStartTime( getClockTime() )
+		, mWrittenObjectCount( 0 )
+	{
+	}
+
+	//------------------------------
+	Tracer::~Tracer()
+	{
+	}
+
+	//------------------------------
+	double Tracer::getClockTime()
+	{
+#ifdef COLLADABU_OS_WIN
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER counter;
+		QueryPerformanceFrequency( &frequency );
+		QueryPerformanceCounter( &counter );
+		return (double)counter.QuadPart * 1e6 / (double)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+		timespec now;
+		clock_gettime( CLOCK_MONOTONIC, &now );
+		return now.tv_sec * 1e6 + now.tv_nsec * 1e-3;
+#else
+		timeval now;
+		gettimeofday( &now, 0 );
+		return now.tv_sec * 1e6 + now.tv_usec;
+#endif
+	}
+
+	//------------------------------
+	double Tracer::getTime() const
+	{
+		return getClockTime() - mStartTime;
+	}
+
+	//------------------------------
+	void Tracer::addEvent( const Event& event )
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		mEvents.push_back( event );
+	}
+
+	//------------------------------
+	Tracer::EventList Tracer::getEvents() const
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		return mEvents;
+	}
+
+	//------------------------------
+	void Tracer::clear()
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		mEvents.clear();
+	}
+
+	//------------------------------
+	void Tracer::addWrittenObject()
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		++mWrittenObjectCount;
+	}
+
+	//------------------------------
+	size_t Tracer::getWrittenObjectCount() const
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		return mWrittenObjectCount;
+	}
+
+	//------------------------------
+	void Tracer::writeChromeTrace( std::ostream& stream ) const
+	{
+		const EventList events = getEvents();
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		for ( size_t i = 0, count = events.size(); i < count; ++i )
+		{
+			const Event& event = events[i];
+			char times[64];
+			sprintf( times, "\"ts\":%.3f,\"dur\":%.3f", event.start, event.duration );
+
+			stream << ( i == 0 ? "\n" : ",\n" ) << "{\"name\":";
+			writeJsonString( stream, event.name );
+			stream << ",\"cat\":";
+			writeJsonString( stream, event.category );
+			stream << ",\"ph\":\"X\"," << times << ",\"pid\":1,\"tid\":" << event.threadId
+				<< ",\"args\":{\"objects\":" << event.objectCount;
+			if ( !event.detail.empty() )
+			{
+				stream << ",\"detail\":";
+				writeJsonString( stream, event.detail.c_str() );
+			}
+			stream << "}}";
+		}
+		stream << "\n]}\n";
+	}
+
+	//------------------------------
+	bool Tracer::writeChromeTrace( const String& fileName ) const
+	{
+		std::ofstream stream( fileName.c_str(), std::ios::out | std::ios::binary );
+		if ( !stream )
+			return false;
+		writeChromeTrace( stream );
+		stream.close();
+		return !stream.fail();
+	}
+
+	//------------------------------
+	void TraceSpan::open( const char* name, const char* category )
+	{
+		mName = name;
+		mCategory = category;
+		mWrittenObjectCount = mTracer->getWrittenObjectCount();
+		mStart = mTracer->getTime();
+	}
+
+	//------------------------------
+	void TraceSpan::close()
+	{
+		Tracer::Event event;
+		event.duration = mTracer->getTime() - mStart;
+		event.start = mStart;
+		event.name = mName;
+		event.category = mCategory;
+		event.detail = mDetail;
+		event.threadId = COLLADABU::Thread::getCurrentThreadId();
+		event.objectCount = mTracer->getWrittenObjectCount() - mWrittenObjectCount;
+		mTracer->addEvent( event );
+	}
+
+} // namespace COLLADASaxFWL
@@ -0,0 +1,193 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLTracingWriter.h"
+#include "COLLADASaxFWLTracer.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	TracingWriter::TracingWriter( COLLADAFW::IWriter* writer, Tracer* tracer )
+		: mWriter( writer )
+		, mTracer( tracer )
+	{
+	}
+
+	//------------------------------
+	TracingWriter::~TracingWriter()
+	{
+	}
+
+	//------------------------------
+	void TracingWriter::cancel( const COLLADAFW::String& errorMessage )
+	{
+		TraceSpan span( mTracer, "cancel", "writer" );
+		span.setDetail( errorMessage );
+		mWriter->cancel( errorMessage );
+	}
+
+	//------------------------------
+	void TracingWriter::start()
+	{
+		TraceSpan span( mTracer, "start", "writer" );
+		mWriter->start();
+	}
+
+	//------------------------------
+	void TracingWriter::finish()
+	{
+		TraceSpan span( mTracer, "finish", "writer" );
+		mWriter->finish();
+	}
+
+	//------------------------------
+	int TracingWriter::getOwnedObjects() const
+	{
+		return mWriter->getOwnedObjects();
+	}
+
+	//------------------------------
+	bool TracingWriter::acceptsQuantizedValues() const
+	{
+		return mWriter->acceptsQuantizedValues();
+	}
+
+	//------------------------------
+	bool TracingWriter::writeGlobalAsset( const COLLADAFW::FileInfo* asset )
+	{
+		TraceSpan span( mTracer, "writeGlobalAsset", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeGlobalAsset( asset );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeScene( const COLLADAFW::Scene* scene )
+	{
+		TraceSpan span( mTracer, "writeScene", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeScene( scene );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeVisualScene( const COLLADAFW::VisualScene* visualScene )
+	{
+		TraceSpan span( mTracer, "writeVisualScene", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeVisualScene( visualScene );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes )
+	{
+		TraceSpan span( mTracer, "writeLibraryNodes", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeLibraryNodes( libraryNodes );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeGeometry( const COLLADAFW::Geometry* geometry )
+	{
+		TraceSpan span( mTracer, "writeGeometry", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeGeometry( geometry );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeMaterial( const COLLADAFW::Material* material )
+	{
+		TraceSpan span( mTracer, "writeMaterial", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeMaterial( material );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeEffect( const COLLADAFW::Effect* effect )
+	{
+		TraceSpan span( mTracer, "writeEffect", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeEffect( effect );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeCamera( const COLLADAFW::Camera* camera )
+	{
+		TraceSpan span( mTracer, "writeCamera", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeCamera( camera );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeImage( const COLLADAFW::Image* image )
+	{
+		TraceSpan span( mTracer, "writeImage", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeImage( image );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeLight( const COLLADAFW::Light* light )
+	{
+		TraceSpan span( mTracer, "writeLight", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeLight( light );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeAnimation( const COLLADAFW::Animation* animation )
+	{
+		TraceSpan span( mTracer, "writeAnimation", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeAnimation( animation );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeAnimationList( const COLLADAFW::AnimationList* animationList )
+	{
+		TraceSpan span( mTracer, "writeAnimationList", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeAnimationList( animationList );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData )
+	{
+		TraceSpan span( mTracer, "writeSkinControllerData", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeSkinControllerData( skinControllerData );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeController( const COLLADAFW::Controller* controller )
+	{
+		TraceSpan span( mTracer, "writeController", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeController( controller );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeFormulas( const COLLADAFW::Formulas* formulas )
+	{
+		TraceSpan span( mTracer, "writeFormulas", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeFormulas( formulas );
+	}
+
+	//------------------------------
+	bool TracingWriter::writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene )
+	{
+		TraceSpan span( mTracer, "writeKinematicsScene", "writer" );
+		mTracer->addWrittenObject();
+		return mWriter->writeKinematicsScene( kinematicsScene );
+	}
+
+} // namespace COLLADASaxFWL
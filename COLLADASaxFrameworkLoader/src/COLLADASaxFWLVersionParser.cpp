@@ -11,8 +11,10 @@
 #include "COLLADASaxFWLStableHeaders.h"
 #include "COLLADASaxFWLVersionParser.h"
 #include "COLLADASaxFWLFileLoader.h"
+#include "COLLADASaxFWLCompressedDocumentStream.h"
 #include "COLLADASaxFWLRootParser14.h"
 #include "COLLADASaxFWLRootParser15.h"
+#include "COLLADASaxFWLTracer.h"
 
 #include "GeneratedSaxParserUtils.h"
 
@@ -23,7 +25,7 @@ namespace COLLADASaxFWL
     const StringHash HASH_ELEMENT_COLLADA = 138479041;
     const StringHash HASH_ATTRIBUTE_XMLNS = 8340307;
 
-    size_t XMLPARSER_BUFFERSIZE = 64*1024;
+    const size_t XMLPARSER_BUFFERSIZE = 64*1024;
 
     enum LibraryFlags
     {
@@ -326,7 +328,35 @@ namespace COLLADASaxFWL
 #elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
         GeneratedSaxParser::ExpatSaxParser versionSaxParser( this, XMLPARSER_BUFFERSIZE );
 #endif
-        bool success = versionSaxParser.parseFile( fileName );
+        bool success;
+        CompressedDocumentStream::Format format = CompressedDocumentStream::getFormat( fileURI );
+        if ( format == CompressedDocumentStream::FORMAT_NONE )
+        {
+            success = versionSaxParser.parseFile( fileName );
+        }
+        else
+        {
+            // inflate on a separate thread while parsing
+            CompressedDocumentStream stream( nativePath, format );
+            success = stream.open();
+            if ( success )
+            {
+                success = versionSaxParser.parseStream( fileName, stream );
+            }
+            else
+            {
+                GeneratedSaxParser::ParserError error( GeneratedSaxParser::ParserError::SEVERITY_CRITICAL,
+                                                       GeneratedSaxParser::ParserError::ERROR_COULD_NOT_OPEN_FILE,
+                                                       0,
+                                                       0,
+                                                       0,
+                                                       0,
+                                                       stream.getErrorMessage().c_str() );
+                GeneratedSaxParser::IErrorHandler* errorHandler = getErrorHandler();
+                if ( errorHandler )
+                    errorHandler->handleError( error );
+            }
+        }
 
  //       mFileLoader->postProcess();
 
@@ -425,6 +455,8 @@ namespace COLLADASaxFWL
     //------------------------------
     bool VersionParser::parse14( const ParserChar* elementName, const ParserAttributes& attributes )
     {
+        // the span ends after the root element, the rest of the document is parsed after returning
+        TraceSpan span( mFileLoader->getColladaLoader()->getTracer(), "VersionParser setup", "parse" );
         createFunctionMap14();
 
         // note: rootParser is created with new because it is deleted in IFilePartLoader::~IFilePartLoader()
@@ -448,6 +480,8 @@ namespace COLLADASaxFWL
     //------------------------------
     bool VersionParser::parse15( const ParserChar* elementName, const ParserAttributes& attributes )
     {
+        // the span ends after the root element, the rest of the document is parsed after returning
+        TraceSpan span( mFileLoader->getColladaLoader()->getTracer(), "VersionParser setup", "parse" );
         createFunctionMap15();
 
         // note: rootParser is created with new because it is deleted in IFilePartLoader::~IFilePartLoader()
@@ -0,0 +1,517 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Writes a mesh with COLLADASW, once with its float arrays and indices in a binary array file and
+    once as text, loads both documents and compares the loaded positions, normals and indices with
+    the written ones. Each document is loaded by a writer that copies the mesh during the write call
+    and by a writer that takes the ownership of the mesh and reads it after the loader, which unmaps
+    the binary array file, has been destroyed. A copy of the binary document, whose arrays are
+    shifted to offsets that are not multiples of the value size, must load the same values, but
+    copied instead of used in place.
+
+    usage: binaryArrayTest [directory]
+*/
+
+#include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLIErrorHandler.h"
+
+#include "COLLADAFW.h"
+
+#include "COLLADASWStreamWriter.h"
+#include "COLLADASWException.h"
+#include "COLLADASWBinaryArrayFile.h"
+#include "COLLADASWLibraryGeometries.h"
+#include "COLLADASWSource.h"
+#include "COLLADASWVertices.h"
+#include "COLLADASWPrimitves.h"
+#include "COLLADASWBaseInputElement.h"
+#include "COLLADASWInputList.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/** The number of vertices per side of the written grid.*/
+	const size_t GRID_SIZE = 20;
+
+	/** The minimum number of values of the arrays written to the binary array file.*/
+	const size_t MINIMUM_BINARY_COUNT = 16;
+
+	/** The largest difference of a value loaded from text, relative to the value or 1 for values
+	below 1, since the text conversion is not exact.*/
+	const double MAX_TEXT_DIFFERENCE = 1e-5;
+
+	const char* MESH_ID = "grid";
+
+
+	/** The values written to the document.*/
+	struct MeshValues
+	{
+		std::vector<float> positions;
+		std::vector<float> normals;
+		std::vector<unsigned int> positionIndices;
+		std::vector<unsigned int> normalIndices;
+
+		/** True, if the loaded float arrays were used in place from the binary array file.*/
+		bool hasExternalData;
+
+		MeshValues() : hasExternalData( false ) {}
+	};
+
+
+	/** Makes the methods of the library writers, that are protected in COLLADASW, accessible.*/
+	class GeometriesWriter : public COLLADASW::LibraryGeometries
+	{
+	public:
+		GeometriesWriter( COLLADASW::StreamWriter* streamWriter ) : COLLADASW::LibraryGeometries( streamWriter ) {}
+		using COLLADASW::LibraryGeometries::openMesh;
+		using COLLADASW::LibraryGeometries::closeMesh;
+		using COLLADASW::LibraryGeometries::closeLibrary;
+	};
+
+
+	/** Copies the float values of @a array to @a values.*/
+	void getFloatValues( const COLLADAFW::FloatOrDoubleArray& array, std::vector<float>& values )
+	{
+		values.clear();
+		const COLLADAFW::FloatArray* floatValues = array.getFloatValues();
+		if ( array.getType() == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT && floatValues )
+			values.assign( floatValues->getData(), floatValues->getData() + floatValues->getCount() );
+	}
+
+	/** True, if the float values of @a array refer to a binary array file.*/
+	bool hasExternalData( const COLLADAFW::FloatOrDoubleArray& array )
+	{
+		const COLLADAFW::FloatArray* floatValues = array.getFloatValues();
+		return floatValues && floatValues->hasExternalData();
+	}
+
+	/** Appends @a indices to @a values.*/
+	void appendIndices( const COLLADAFW::IndexArray& indices, std::vector<unsigned int>& values )
+	{
+		values.insert( values.end(), indices.begin(), indices.end() );
+	}
+
+	/** Copies the values of @a mesh to @a values.*/
+	void getMeshValues( const COLLADAFW::Mesh& mesh, MeshValues& values )
+	{
+		getFloatValues( mesh.getPositions(), values.positions );
+		getFloatValues( mesh.getNormals(), values.normals );
+		values.hasExternalData = hasExternalData( mesh.getPositions() ) || hasExternalData( mesh.getNormals() );
+		values.positionIndices.clear();
+		values.normalIndices.clear();
+		const COLLADAFW::MeshPrimitiveArray& primitives = mesh.getMeshPrimitives();
+		for ( size_t i = 0, count = primitives.getCount(); i < count; ++i )
+		{
+			appendIndices( primitives[i]->getPositionIndexArray(), values.positionIndices );
+			appendIndices( primitives[i]->getNormalIndexArray(), values.normalIndices );
+		}
+	}
+
+
+	/** Writer that receives the mesh. If it owns the geometries, it keeps the mesh, otherwise it
+	copies its values during the write call.*/
+	class MeshWriter : public COLLADAFW::IWriter
+	{
+	private:
+		bool mOwnsGeometries;
+		COLLADAFW::Mesh* mMesh;
+		MeshValues mValues;
+
+	public:
+		MeshWriter( bool ownsGeometries ) : mOwnsGeometries( ownsGeometries ), mMesh( 0 ) {}
+		virtual ~MeshWriter() { delete mMesh; }
+
+		/** The mesh, if the writer owns the geometries.*/
+		const COLLADAFW::Mesh* getMesh() const { return mMesh; }
+
+		/** The values copied during the write call, if the writer does not own the geometries.*/
+		const MeshValues& getValues() const { return mValues; }
+
+		virtual int getOwnedObjects() const { return mOwnsGeometries ? OBJECT_GEOMETRY : OBJECT_NONE; }
+
+		virtual void cancel( const COLLADAFW::String& /*errorMessage*/ ) {}
+		virtual void start() {}
+		virtual void finish() {}
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* /*asset*/ ) { return true; }
+		virtual bool writeScene( const COLLADAFW::Scene* /*scene*/ ) { return true; }
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* /*visualScene*/ ) { return true; }
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* /*libraryNodes*/ ) { return true; }
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry )
+		{
+			if ( geometry->getType() != COLLADAFW::Geometry::GEO_TYPE_MESH )
+			{
+				if ( mOwnsGeometries )
+					delete geometry;
+				return true;
+			}
+			const COLLADAFW::Mesh* mesh = (const COLLADAFW::Mesh*)geometry;
+			if ( mOwnsGeometries )
+			{
+				delete mMesh;
+				mMesh = (COLLADAFW::Mesh*)mesh;
+			}
+			else
+			{
+				getMeshValues( *mesh, mValues );
+			}
+			return true;
+		}
+
+		virtual bool writeMaterial( const COLLADAFW::Material* /*material*/ ) { return true; }
+		virtual bool writeEffect( const COLLADAFW::Effect* /*effect*/ ) { return true; }
+		virtual bool writeCamera( const COLLADAFW::Camera* /*camera*/ ) { return true; }
+		virtual bool writeImage( const COLLADAFW::Image* /*image*/ ) { return true; }
+		virtual bool writeLight( const COLLADAFW::Light* /*light*/ ) { return true; }
+		virtual bool writeAnimation( const COLLADAFW::Animation* /*animation*/ ) { return true; }
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* /*animationList*/ ) { return true; }
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* /*skinControllerData*/ ) { return true; }
+		virtual bool writeController( const COLLADAFW::Controller* /*controller*/ ) { return true; }
+		virtual bool writeFormulas( const COLLADAFW::Formulas* /*formulas*/ ) { return true; }
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* /*kinematicsScene*/ ) { return true; }
+
+	private:
+		/** Disable default copy ctor. */
+		MeshWriter( const MeshWriter& pre );
+		/** Disable default assignment operator. */
+		const MeshWriter& operator= ( const MeshWriter& pre );
+	};
+
+
+	/** Counts the errors reported by the loader.*/
+	class CountingErrorHandler : public COLLADASaxFWL::IErrorHandler
+	{
+	public:
+		size_t mErrorCount;
+
+		CountingErrorHandler() : mErrorCount(0) {}
+		virtual ~CountingErrorHandler() {}
+
+		virtual bool handleError( const COLLADASaxFWL::IError* /*error*/ ) { ++mErrorCount; return false; }
+	};
+
+
+	/** Creates the values of a grid of GRID_SIZE x GRID_SIZE vertices with two triangles per cell.*/
+	void createMeshValues( MeshValues& values )
+	{
+		for ( size_t y = 0; y < GRID_SIZE; ++y )
+		{
+			for ( size_t x = 0; x < GRID_SIZE; ++x )
+			{
+				values.positions.push_back( (float)x * 0.37f - 1.5f );
+				values.positions.push_back( (float)sin( 0.3 * x ) * (float)cos( 0.7 * y ) );
+				values.positions.push_back( (float)y * 0.41f + 1e-3f );
+				values.normals.push_back( (float)( x % 3 ) * 0.25f );
+				values.normals.push_back( 1.0f / ( 1.0f + (float)y ) );
+				values.normals.push_back( -0.125f );
+			}
+		}
+		for ( size_t y = 0; y + 1 < GRID_SIZE; ++y )
+		{
+			for ( size_t x = 0; x + 1 < GRID_SIZE; ++x )
+			{
+				const unsigned int corner = (unsigned int)( y * GRID_SIZE + x );
+				const unsigned int triangles[6] = { corner, corner + (unsigned int)GRID_SIZE, corner + 1,
+					corner + 1, corner + (unsigned int)GRID_SIZE, corner + (unsigned int)GRID_SIZE + 1 };
+				for ( size_t i = 0; i < 6; ++i )
+				{
+					values.positionIndices.push_back( triangles[i] );
+					// the normals are indexed in reverse order, so they differ from the position indices
+					values.normalIndices.push_back( (unsigned int)( GRID_SIZE * GRID_SIZE - 1 ) - triangles[i] );
+				}
+			}
+		}
+	}
+
+	/** Writes a float source with @a id and the values @a values, three per vertex.*/
+	void writeSource( COLLADASW::StreamWriter& streamWriter, const std::string& id, const std::vector<float>& values )
+	{
+		COLLADASW::FloatSourceF source( &streamWriter );
+		source.setId( id );
+		source.setArrayId( id + COLLADASW::LibraryGeometries::ARRAY_ID_SUFFIX );
+		source.setAccessorStride( 3 );
+		source.setAccessorCount( (unsigned long)( values.size() / 3 ) );
+		source.getParameterNameList().push_back( "X" );
+		source.getParameterNameList().push_back( "Y" );
+		source.getParameterNameList().push_back( "Z" );
+		source.prepareToAppendValues();
+		for ( size_t i = 0; i < values.size(); i += 3 )
+			source.appendValues( values[i], values[i + 1], values[i + 2] );
+		source.finish();
+	}
+
+	/** Writes the document @a fileName with the mesh @a values. If @a binaryFileName is not empty,
+	the arrays are written to the binary array file @a binaryFileName.*/
+	bool writeDocument( const std::string& fileName, const std::string& binaryFileName, const MeshValues& values )
+	{
+		try
+		{
+			const COLLADASW::NativeString nativeFileName( fileName );
+			COLLADASW::StreamWriter streamWriter( nativeFileName );
+			COLLADASW::BinaryArrayFile* binaryArrayFile = 0;
+			if ( !binaryFileName.empty() )
+			{
+				const std::string reference = binaryFileName.substr( binaryFileName.find_last_of( '/' ) + 1 );
+				binaryArrayFile = new COLLADASW::BinaryArrayFile( COLLADASW::NativeString( binaryFileName ), reference, MINIMUM_BINARY_COUNT );
+				streamWriter.setBinaryArrayFile( binaryArrayFile );
+			}
+			streamWriter.startDocument();
+
+			GeometriesWriter geometries( &streamWriter );
+			geometries.openMesh( MESH_ID );
+			const std::string positionsId = MESH_ID + COLLADASW::LibraryGeometries::POSITIONS_SOURCE_ID_SUFFIX;
+			const std::string normalsId = MESH_ID + COLLADASW::LibraryGeometries::NORMALS_SOURCE_ID_SUFFIX;
+			writeSource( streamWriter, positionsId, values.positions );
+			writeSource( streamWriter, normalsId, values.normals );
+
+			COLLADASW::VerticesElement vertices( &streamWriter );
+			vertices.setId( MESH_ID + COLLADASW::LibraryGeometries::VERTICES_ID_SUFFIX );
+			vertices.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::POSITION, "#" + positionsId ) );
+			vertices.add();
+
+			COLLADASW::Triangles triangles( &streamWriter );
+			triangles.setCount( (unsigned long)( values.positionIndices.size() / 3 ) );
+			triangles.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::VERTEX, "#" + std::string( MESH_ID ) + COLLADASW::LibraryGeometries::VERTICES_ID_SUFFIX, 0 ) );
+			triangles.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::NORMAL, "#" + normalsId, 1 ) );
+			triangles.prepareToAppendValues();
+			for ( size_t i = 0; i < values.positionIndices.size(); ++i )
+				triangles.appendValues( (unsigned long)values.positionIndices[i], (unsigned long)values.normalIndices[i] );
+			triangles.finish();
+
+			geometries.closeMesh();
+			geometries.closeLibrary();
+			streamWriter.endDocument();
+
+			// writes the remaining values and closes the file
+			delete binaryArrayFile;
+		}
+		catch ( const COLLADASW::StreamWriterException& )
+		{
+			fprintf( stderr, "could not write %s\n", fileName.c_str() );
+			return false;
+		}
+		return true;
+	}
+
+	/** Reads the file @a fileName into @a content.*/
+	bool readFile( const std::string& fileName, std::string& content )
+	{
+		FILE* file = fopen( fileName.c_str(), "rb" );
+		if ( !file )
+			return false;
+		char buffer[4096];
+		size_t readBytes;
+		content.clear();
+		while ( ( readBytes = fread( buffer, 1, sizeof(buffer), file ) ) > 0 )
+			content.append( buffer, readBytes );
+		fclose( file );
+		return true;
+	}
+
+	/** Writes @a content to the file @a fileName.*/
+	bool writeFile( const std::string& fileName, const std::string& content )
+	{
+		FILE* file = fopen( fileName.c_str(), "wb" );
+		if ( !file )
+			return false;
+		bool success = fwrite( content.data(), 1, content.size(), file ) == content.size();
+		return ( fclose( file ) == 0 ) && success;
+	}
+
+	/** Copies the binary document @a fileName and its binary array file @a binaryFileName to
+	@a misalignedFileName and @a misalignedBinaryFileName. The copied binary array file starts with
+	@a shift additional bytes, and the offsets in the document are shifted accordingly.*/
+	bool writeMisalignedCopy( const std::string& fileName, const std::string& binaryFileName,
+							  const std::string& misalignedFileName, const std::string& misalignedBinaryFileName, size_t shift )
+	{
+		std::string document;
+		std::string binaryData;
+		if ( !readFile( fileName, document ) || !readFile( binaryFileName, binaryData ) )
+			return false;
+
+		const std::string reference = binaryFileName.substr( binaryFileName.find_last_of( '/' ) + 1 );
+		const std::string misalignedReference = misalignedBinaryFileName.substr( misalignedBinaryFileName.find_last_of( '/' ) + 1 );
+		const std::string fileAttribute = "file=\"" + reference + "\"";
+		const std::string offsetAttribute = "offset=\"";
+		std::string misalignedDocument;
+		size_t position = 0;
+		size_t arrayCount = 0;
+		for ( size_t found; ( found = document.find( fileAttribute, position ) ) != std::string::npos; ++arrayCount )
+		{
+			misalignedDocument.append( document, position, found - position );
+			misalignedDocument += "file=\"" + misalignedReference + "\"";
+			position = found + fileAttribute.length();
+
+			size_t offsetBegin = document.find( offsetAttribute, position );
+			if ( offsetBegin == std::string::npos )
+				return false;
+			offsetBegin += offsetAttribute.length();
+			misalignedDocument.append( document, position, offsetBegin - position );
+			unsigned long offset = strtoul( document.c_str() + offsetBegin, 0, 10 );
+			char shiftedOffset[32];
+			sprintf( shiftedOffset, "%lu", offset + (unsigned long)shift );
+			misalignedDocument += shiftedOffset;
+			position = document.find( '"', offsetBegin );
+		}
+		misalignedDocument.append( document, position, std::string::npos );
+
+		if ( arrayCount == 0 )
+		{
+			fprintf( stderr, "%s: no binary arrays found\n", fileName.c_str() );
+			return false;
+		}
+		return writeFile( misalignedFileName, misalignedDocument )
+			&& writeFile( misalignedBinaryFileName, std::string( shift, '\0' ) + binaryData );
+	}
+
+	/** Loads the mesh of @a fileName into @a values. If @a ownsGeometries is true, the writer takes
+	the ownership of the mesh and the values are read after the loader has been destroyed.*/
+	bool loadDocument( const std::string& fileName, bool ownsGeometries, MeshValues& values )
+	{
+		MeshWriter writer( ownsGeometries );
+		CountingErrorHandler errorHandler;
+		bool success;
+		{
+			COLLADASaxFWL::Loader loader( &errorHandler );
+			COLLADAFW::Root root( &loader, &writer );
+			success = root.loadDocument( fileName );
+		}
+		if ( !success || errorHandler.mErrorCount > 0 )
+		{
+			fprintf( stderr, "%s: loading failed with %d errors\n", fileName.c_str(), (int)errorHandler.mErrorCount );
+			return false;
+		}
+		if ( !ownsGeometries )
+		{
+			values = writer.getValues();
+			return true;
+		}
+
+		const COLLADAFW::Mesh* mesh = writer.getMesh();
+		if ( !mesh )
+		{
+			fprintf( stderr, "%s: no mesh has been loaded\n", fileName.c_str() );
+			return false;
+		}
+		if ( hasExternalData( mesh->getPositions() ) || hasExternalData( mesh->getNormals() ) )
+		{
+			fprintf( stderr, "%s: the owned mesh refers to the binary array file\n", fileName.c_str() );
+			return false;
+		}
+		getMeshValues( *mesh, values );
+		return true;
+	}
+
+	/** Returns the number of values in @a loaded, that differ from @a written by more than
+	@a maxRelativeDifference times the written value or 1, whichever is larger.*/
+	size_t countDifferences( const std::vector<float>& written, const std::vector<float>& loaded, double maxRelativeDifference )
+	{
+		if ( written.size() != loaded.size() )
+			return written.size() + loaded.size();
+		size_t differenceCount = 0;
+		for ( size_t i = 0; i < written.size(); ++i )
+		{
+			if ( fabs( (double)written[i] - loaded[i] ) > maxRelativeDifference * std::max( fabs( (double)written[i] ), 1.0 ) )
+				++differenceCount;
+		}
+		return differenceCount;
+	}
+
+	/** Returns the number of values in @a loaded, that differ from @a written.*/
+	size_t countDifferences( const std::vector<unsigned int>& written, const std::vector<unsigned int>& loaded )
+	{
+		if ( written.size() != loaded.size() )
+			return written.size() + loaded.size();
+		size_t differenceCount = 0;
+		for ( size_t i = 0; i < written.size(); ++i )
+		{
+			if ( written[i] != loaded[i] )
+				++differenceCount;
+		}
+		return differenceCount;
+	}
+
+	/** Loads @a fileName with and without owning the mesh and compares the values with @a written.
+	Values loaded from binary arrays must be identical. The mesh copied during the write call must
+	use the binary array file in place, if and only if @a inPlace is true.
+	@return The number of failed checks.*/
+	size_t checkDocument( const std::string& fileName, const MeshValues& written, bool binary, bool inPlace )
+	{
+		size_t failureCount = 0;
+		const double maxDifference = binary ? 0.0 : MAX_TEXT_DIFFERENCE;
+		for ( int owned = 0; owned < 2; ++owned )
+		{
+			MeshValues loaded;
+			if ( !loadDocument( fileName, owned != 0, loaded ) )
+			{
+				++failureCount;
+				continue;
+			}
+			size_t differences[4];
+			differences[0] = countDifferences( written.positions, loaded.positions, maxDifference );
+			differences[1] = countDifferences( written.normals, loaded.normals, maxDifference );
+			differences[2] = countDifferences( written.positionIndices, loaded.positionIndices );
+			differences[3] = countDifferences( written.normalIndices, loaded.normalIndices );
+			printf( "%s %s: %d positions, %d indices, differences %d %d %d %d\n", fileName.c_str(), owned ? "owned" : "copied",
+				(int)loaded.positions.size(), (int)loaded.positionIndices.size(),
+				(int)differences[0], (int)differences[1], (int)differences[2], (int)differences[3] );
+			for ( size_t i = 0; i < 4; ++i )
+			{
+				if ( differences[i] > 0 )
+					++failureCount;
+			}
+			if ( !owned && loaded.hasExternalData != inPlace )
+			{
+				fprintf( stderr, "%s: the float arrays are %s\n", fileName.c_str(), inPlace ? "copied" : "used in place" );
+				++failureCount;
+			}
+		}
+		return failureCount;
+	}
+}
+
+
+int main( int argc, char** argv )
+{
+	if ( argc > 2 )
+	{
+		fprintf( stderr, "usage: %s [directory]\n", argv[0] );
+		return 2;
+	}
+	const std::string directory = argc == 2 ? std::string( argv[1] ) + "/" : std::string( "./" );
+	const std::string binaryDocument = directory + "binaryArrayTest.dae";
+	const std::string binaryFile = directory + "binaryArrayTest.bin";
+	const std::string textDocument = directory + "binaryArrayTestText.dae";
+	const std::string misalignedDocument = directory + "binaryArrayTestMisaligned.dae";
+	const std::string misalignedFile = directory + "binaryArrayTestMisaligned.bin";
+
+	MeshValues written;
+	createMeshValues( written );
+	if ( !writeDocument( binaryDocument, binaryFile, written ) || !writeDocument( textDocument, std::string(), written ) )
+		return 1;
+	if ( !writeMisalignedCopy( binaryDocument, binaryFile, misalignedDocument, misalignedFile, 2 ) )
+		return 1;
+
+	size_t failureCount = checkDocument( binaryDocument, written, true, true );
+	failureCount += checkDocument( misalignedDocument, written, true, false );
+	failureCount += checkDocument( textDocument, written, false, false );
+
+	printf( "%d failed checks\n", (int)failureCount );
+	return failureCount == 0 ? 0 : 1;
+}
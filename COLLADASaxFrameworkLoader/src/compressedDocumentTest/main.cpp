@@ -0,0 +1,218 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Writes a document with a mesh as .dae.gz and loads it. Copies of the compressed document, that
+    lack the gzip trailer, that end within the deflate data or whose checksum is damaged, must fail
+    to load. Without the trailer, the xml document itself is complete, so only the decompression
+    can detect the damage.
+
+    usage: compressedDocumentTest [directory]
+*/
+
+#include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLIErrorHandler.h"
+
+#include "COLLADAFW.h"
+
+#include "zlib.h"
+
+#include <stdio.h>
+
+#include <string>
+
+
+namespace
+{
+	/** The size of the gzip trailer, i.e. the crc and the size of the uncompressed data.*/
+	const size_t GZIP_TRAILER_SIZE = 8;
+
+	/** A COLLADA 1.4 document with one mesh.*/
+	const char* DOCUMENT =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+		"  <library_geometries>\n"
+		"    <geometry id=\"triangle\">\n"
+		"      <mesh>\n"
+		"        <source id=\"triangle-positions\">\n"
+		"          <float_array id=\"triangle-positions-array\" count=\"9\">0 0 0 1 0 0 0 1 0</float_array>\n"
+		"          <technique_common>\n"
+		"            <accessor source=\"#triangle-positions-array\" count=\"3\" stride=\"3\">\n"
+		"              <param name=\"X\" type=\"float\"/><param name=\"Y\" type=\"float\"/><param name=\"Z\" type=\"float\"/>\n"
+		"            </accessor>\n"
+		"          </technique_common>\n"
+		"        </source>\n"
+		"        <vertices id=\"triangle-vertices\"><input semantic=\"POSITION\" source=\"#triangle-positions\"/></vertices>\n"
+		"        <triangles count=\"1\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#triangle-vertices\" offset=\"0\"/>\n"
+		"          <p>0 1 2</p>\n"
+		"        </triangles>\n"
+		"      </mesh>\n"
+		"    </geometry>\n"
+		"  </library_geometries>\n"
+		"</COLLADA>\n";
+
+
+	/** Writer that counts the meshes.*/
+	class MeshCountingWriter : public COLLADAFW::IWriter
+	{
+	public:
+		size_t mMeshCount;
+
+		MeshCountingWriter() : mMeshCount( 0 ) {}
+		virtual ~MeshCountingWriter() {}
+
+		virtual void cancel( const COLLADAFW::String& /*errorMessage*/ ) {}
+		virtual void start() {}
+		virtual void finish() {}
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* /*asset*/ ) { return true; }
+		virtual bool writeScene( const COLLADAFW::Scene* /*scene*/ ) { return true; }
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* /*visualScene*/ ) { return true; }
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* /*libraryNodes*/ ) { return true; }
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry )
+		{
+			if ( geometry->getType() == COLLADAFW::Geometry::GEO_TYPE_MESH )
+				++mMeshCount;
+			return true;
+		}
+
+		virtual bool writeMaterial( const COLLADAFW::Material* /*material*/ ) { return true; }
+		virtual bool writeEffect( const COLLADAFW::Effect* /*effect*/ ) { return true; }
+		virtual bool writeCamera( const COLLADAFW::Camera* /*camera*/ ) { return true; }
+		virtual bool writeImage( const COLLADAFW::Image* /*image*/ ) { return true; }
+		virtual bool writeLight( const COLLADAFW::Light* /*light*/ ) { return true; }
+		virtual bool writeAnimation( const COLLADAFW::Animation* /*animation*/ ) { return true; }
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* /*animationList*/ ) { return true; }
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* /*skinControllerData*/ ) { return true; }
+		virtual bool writeController( const COLLADAFW::Controller* /*controller*/ ) { return true; }
+		virtual bool writeFormulas( const COLLADAFW::Formulas* /*formulas*/ ) { return true; }
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* /*kinematicsScene*/ ) { return true; }
+	};
+
+
+	/** Counts the errors reported by the loader.*/
+	class CountingErrorHandler : public COLLADASaxFWL::IErrorHandler
+	{
+	public:
+		size_t mErrorCount;
+
+		CountingErrorHandler() : mErrorCount(0) {}
+		virtual ~CountingErrorHandler() {}
+
+		virtual bool handleError( const COLLADASaxFWL::IError* /*error*/ ) { ++mErrorCount; return false; }
+	};
+
+
+	/** Writes @a document compressed with gzip to @a fileName.*/
+	bool writeGzipDocument( const std::string& fileName, const char* document )
+	{
+		gzFile file = gzopen( fileName.c_str(), "wb" );
+		if ( !file )
+		{
+			fprintf( stderr, "Could not open %s\n", fileName.c_str() );
+			return false;
+		}
+		std::string data( document );
+		bool success = gzwrite( file, data.c_str(), (unsigned int)data.size() ) == (int)data.size();
+		success = (gzclose( file ) == Z_OK) && success;
+		if ( !success )
+			fprintf( stderr, "Could not write %s\n", fileName.c_str() );
+		return success;
+	}
+
+	/** Reads the content of @a fileName into @a data.*/
+	bool readFile( const std::string& fileName, std::string& data )
+	{
+		FILE* file = fopen( fileName.c_str(), "rb" );
+		if ( !file )
+		{
+			fprintf( stderr, "Could not open %s\n", fileName.c_str() );
+			return false;
+		}
+		char buffer[4096];
+		size_t readBytes;
+		data.clear();
+		while ( (readBytes = fread( buffer, 1, sizeof(buffer), file )) > 0 )
+			data.append( buffer, readBytes );
+		fclose( file );
+		return true;
+	}
+
+	/** Writes @a data to @a fileName.*/
+	bool writeFile( const std::string& fileName, const std::string& data )
+	{
+		FILE* file = fopen( fileName.c_str(), "wb" );
+		if ( !file )
+		{
+			fprintf( stderr, "Could not open %s\n", fileName.c_str() );
+			return false;
+		}
+		bool success = fwrite( data.data(), 1, data.size(), file ) == data.size();
+		success = (fclose( file ) == 0) && success;
+		return success;
+	}
+
+	/** Loads @a fileName. The load must succeed without errors and deliver the mesh, if
+	@a isComplete is true, and fail otherwise.
+	@return The number of failed checks.*/
+	size_t checkDocument( const std::string& fileName, bool isComplete )
+	{
+		MeshCountingWriter writer;
+		CountingErrorHandler errorHandler;
+		bool success;
+		{
+			COLLADASaxFWL::Loader loader( &errorHandler );
+			COLLADAFW::Root root( &loader, &writer );
+			success = root.loadDocument( fileName );
+		}
+		bool isLoaded = success && (errorHandler.mErrorCount == 0) && (writer.mMeshCount == 1);
+		printf( "%s: %s, %d errors, %d meshes\n", fileName.c_str(), success ? "loaded" : "failed",
+			(int)errorHandler.mErrorCount, (int)writer.mMeshCount );
+		if ( isLoaded == isComplete )
+			return 0;
+		fprintf( stderr, "%s: %s\n", fileName.c_str(), isComplete ? "loading failed" : "the damaged document has been loaded" );
+		return 1;
+	}
+}
+
+
+int main( int argc, char** argv )
+{
+	if ( argc > 2 )
+	{
+		fprintf( stderr, "usage: %s [directory]\n", argv[0] );
+		return 2;
+	}
+	const std::string directory = argc == 2 ? std::string( argv[1] ) + "/" : std::string( "./" );
+	const std::string document = directory + "compressedDocumentTest.dae.gz";
+	const std::string noTrailerDocument = directory + "compressedDocumentTestNoTrailer.dae.gz";
+	const std::string truncatedDocument = directory + "compressedDocumentTestTruncated.dae.gz";
+	const std::string badChecksumDocument = directory + "compressedDocumentTestBadChecksum.dae.gz";
+
+	std::string data;
+	if ( !writeGzipDocument( document, DOCUMENT ) || !readFile( document, data ) )
+		return 1;
+
+	std::string badChecksumData( data );
+	badChecksumData[data.size() - GZIP_TRAILER_SIZE] ^= 0x01;
+	if ( !writeFile( noTrailerDocument, data.substr( 0, data.size() - GZIP_TRAILER_SIZE ) )
+		|| !writeFile( truncatedDocument, data.substr( 0, data.size() / 2 ) )
+		|| !writeFile( badChecksumDocument, badChecksumData ) )
+		return 1;
+
+	size_t failureCount = checkDocument( document, true );
+	failureCount += checkDocument( noTrailerDocument, false );
+	failureCount += checkDocument( truncatedDocument, false );
+	failureCount += checkDocument( badChecksumDocument, false );
+
+	printf( "%d failed checks\n", (int)failureCount );
+	return failureCount == 0 ? 0 : 1;
+}
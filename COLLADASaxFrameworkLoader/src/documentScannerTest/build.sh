@@ -0,0 +1,20 @@
+
+# Builds the document scanner test. LIBDIR must point to the directory that contains the
+# static libraries of a regular build of OpenCOLLADA (built with libxml as xml parser).
+# run: ./documentScannerTest [directory]   writes its documents to the directory, default .
+
+LIBDIR=${LIBDIR:-../../../build/lib}
+
+OPTIONS="-O2 -Wall -pthread"
+
+INCLUDES="-I../../include -I../../include/generated14 -I../../include/generated15 -I../../../COLLADAFramework/include -I../../../COLLADABaseUtils/include -I../../../COLLADABaseUtils/include/Math -I../../../GeneratedSaxParser/include -I../../../Externals/MathMLSolver/include -I../../../Externals/MathMLSolver/include/AST -I/usr/include/libxml2"
+
+FILES="main.cpp"
+
+LIBS="-L$LIBDIR -lOpenCOLLADASaxFrameworkLoader -lGeneratedSaxParser -lOpenCOLLADAFramework -lMathMLSolver -lOpenCOLLADABaseUtils -lUTF -lbuffer -lftoa -lpcre -lzziplib -lzlib -lxml2"
+
+OUTPUTFILE="-o documentScannerTest"
+
+
+
+g++ $OPTIONS $INCLUDES $FILES $LIBS $OUTPUTFILE
@@ -0,0 +1,257 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Scans small COLLADA 1.4 and 1.5 documents with COLLADASaxFWL::DocumentScanner, from a buffer and
+    from a file, and compares the statistics with the values known from the documents: the number
+    of geometries, meshes and primitives, the sizes of the float_array, int_array and p elements,
+    the triangle estimate of each primitive type, the external references, the image files and the
+    library flags.
+
+    usage: documentScannerTest [directory]   writes its documents to the directory, default .
+*/
+
+#include "COLLADASaxFWLDocumentScanner.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+
+namespace
+{
+	/** A COLLADA 1.4 document with two meshes. The first has a triangles primitive with two
+	inputs (2 triangles) and a polylist with a triangle and a quad (3 triangles), the second a
+	tristrips primitive with two strips (1 + 2 triangles), a trifans primitive with one fan
+	(3 triangles), a polygons primitive with a pentagon (3 triangles) and lines (no triangles).*/
+	const char* DOCUMENT_14 =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+		"  <asset><up_axis>Y_UP</up_axis></asset>\n"
+		"  <library_images>\n"
+		"    <image id=\"wood\"><init_from> textures/wood.png </init_from></image>\n"
+		"  </library_images>\n"
+		"  <library_geometries>\n"
+		"    <geometry id=\"first\">\n"
+		"      <mesh>\n"
+		"        <source id=\"first-positions\">\n"
+		"          <float_array id=\"first-positions-array\" count=\"15\">0 0 0 1 0 0 1 1 0 0 1 0 2 2 2</float_array>\n"
+		"          <technique_common><accessor source=\"#first-positions-array\" count=\"5\" stride=\"3\"/></technique_common>\n"
+		"        </source>\n"
+		"        <source id=\"first-normals\">\n"
+		"          <float_array id=\"first-normals-array\" count=\"3\">0 0 1</float_array>\n"
+		"        </source>\n"
+		"        <vertices id=\"first-vertices\"><input semantic=\"POSITION\" source=\"#first-positions\"/></vertices>\n"
+		"        <triangles count=\"2\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#first-vertices\" offset=\"0\"/>\n"
+		"          <input semantic=\"NORMAL\" source=\"#first-normals\" offset=\"1\"/>\n"
+		"          <p>0 0 1 0 2 0\n 0 0 2 0 3 0</p>\n"
+		"        </triangles>\n"
+		"        <polylist count=\"2\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#first-vertices\" offset=\"0\"/>\n"
+		"          <vcount>3 4</vcount>\n"
+		"          <p> 0 1 4   0 1 2 3 </p>\n"
+		"        </polylist>\n"
+		"      </mesh>\n"
+		"    </geometry>\n"
+		"    <geometry id=\"second\">\n"
+		"      <mesh>\n"
+		"        <source id=\"second-positions\">\n"
+		"          <float_array id=\"second-positions-array\" count=\"6\">0 0 0 1 1 1</float_array>\n"
+		"        </source>\n"
+		"        <source id=\"second-ids\">\n"
+		"          <int_array id=\"second-ids-array\" count=\"4\">1 2 3 4</int_array>\n"
+		"        </source>\n"
+		"        <vertices id=\"second-vertices\"><input semantic=\"POSITION\" source=\"#second-positions\"/></vertices>\n"
+		"        <tristrips count=\"2\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#second-vertices\" offset=\"0\"/>\n"
+		"          <p>0 1 0</p>\n"
+		"          <p>1 0 1 0</p>\n"
+		"        </tristrips>\n"
+		"        <trifans count=\"1\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#second-vertices\" offset=\"0\"/>\n"
+		"          <p>0 1 0 1 0</p>\n"
+		"        </trifans>\n"
+		"        <polygons count=\"1\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#second-vertices\" offset=\"0\"/>\n"
+		"          <p>0 1 0 1 0</p>\n"
+		"        </polygons>\n"
+		"        <lines count=\"1\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#second-vertices\" offset=\"0\"/>\n"
+		"          <p>0 1</p>\n"
+		"        </lines>\n"
+		"      </mesh>\n"
+		"    </geometry>\n"
+		"  </library_geometries>\n"
+		"  <library_visual_scenes>\n"
+		"    <visual_scene id=\"scene\">\n"
+		"      <node id=\"local\"><instance_geometry url=\"#first\"/></node>\n"
+		"      <node id=\"external\">\n"
+		"        <instance_geometry url=\"lib/shared.dae#geometry\"/>\n"
+		"        <instance_node url=\"other.dae#node\"/>\n"
+		"        <node id=\"child\"><instance_node url=\"other.dae#another-node\"/></node>\n"
+		"      </node>\n"
+		"    </visual_scene>\n"
+		"  </library_visual_scenes>\n"
+		"  <scene><instance_visual_scene url=\"#scene\"/></scene>\n"
+		"</COLLADA>\n";
+
+	/** A COLLADA 1.5 document with an image referenced by a ref element, an embedded image and a
+	controller.*/
+	const char* DOCUMENT_15 =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<COLLADA xmlns=\"http://www.collada.org/2008/03/COLLADASchema\" version=\"1.5.0\">\n"
+		"  <library_images>\n"
+		"    <image id=\"stone\"><init_from><ref>file:///images/stone.jpg</ref></init_from></image>\n"
+		"    <image id=\"logo\"><init_from>\n"
+		"      <hex format=\"PNG\">89504E470D0A1A0A</hex>\n"
+		"    </init_from></image>\n"
+		"  </library_images>\n"
+		"  <library_controllers>\n"
+		"    <controller id=\"skin\"><skin source=\"meshes.dae#body\"/></controller>\n"
+		"  </library_controllers>\n"
+		"</COLLADA>\n";
+
+
+	/** The number of failed checks.*/
+	size_t failureCount = 0;
+
+	//------------------------------
+	/** Compares @a value with @a expected and reports a difference.*/
+	void check( const char* name, size_t value, size_t expected )
+	{
+		if ( value == expected )
+			return;
+		fprintf( stderr, "%s is %d, expected %d\n", name, (int)value, (int)expected );
+		++failureCount;
+	}
+
+	//------------------------------
+	/** Returns the number of elements in @a document, i.e. the number of start tags.*/
+	size_t countElements( const char* document )
+	{
+		size_t elementCount = 0;
+		for ( const char* pos = strchr( document, '<' ); pos; pos = strchr( pos + 1, '<' ) )
+		{
+			if ( pos[1] != '/' && pos[1] != '?' )
+				++elementCount;
+		}
+		return elementCount;
+	}
+
+	//------------------------------
+	/** Checks the statistics of DOCUMENT_14.*/
+	void checkStatistics14( const COLLADASaxFWL::DocumentStatistics& statistics )
+	{
+		check( "version", statistics.version, COLLADASaxFWL::COLLADA_14 );
+		check( "libraryFlags", statistics.libraryFlags, COLLADASaxFWL::DocumentStatistics::LIBRARY_IMAGES
+			| COLLADASaxFWL::DocumentStatistics::LIBRARY_GEOMETRIES | COLLADASaxFWL::DocumentStatistics::LIBRARY_VISUAL_SCENES );
+		check( "elementCount", statistics.elementCount, countElements( DOCUMENT_14 ) );
+		check( "geometryCount", statistics.geometryCount, 2 );
+		check( "meshCount", statistics.meshCount, 2 );
+		check( "primitiveCount", statistics.primitiveCount, 6 );
+		check( "controllerCount", statistics.controllerCount, 0 );
+		check( "animationCount", statistics.animationCount, 0 );
+		check( "nodeCount", statistics.nodeCount, 3 );
+		check( "imageCount", statistics.imageCount, 1 );
+		check( "floatArrayCount", statistics.floatArrayCount, 3 );
+		check( "floatValueCount", statistics.floatValueCount, 15 + 3 + 6 );
+		check( "maxFloatArrayValueCount", statistics.maxFloatArrayValueCount, 15 );
+		check( "intArrayCount", statistics.intArrayCount, 1 );
+		check( "intValueCount", statistics.intValueCount, 4 );
+		check( "pCount", statistics.pCount, 7 );
+		check( "indexCount", statistics.indexCount, 12 + 7 + 3 + 4 + 5 + 5 + 2 );
+		check( "maxPIndexCount", statistics.maxPIndexCount, 12 );
+		check( "triangleEstimate", statistics.triangleEstimate, 2 + 3 + 3 + 3 + 3 );
+
+		check( "externalDocuments", statistics.externalDocuments.size(), 2 );
+		check( "externalDocuments other.dae", statistics.externalDocuments.count( "other.dae" ), 1 );
+		check( "externalDocuments lib/shared.dae", statistics.externalDocuments.count( "lib/shared.dae" ), 1 );
+		check( "imageFiles", statistics.imageFiles.size(), 1 );
+		check( "imageFiles textures/wood.png", statistics.imageFiles.count( "textures/wood.png" ), 1 );
+	}
+
+	//------------------------------
+	/** Checks the statistics of DOCUMENT_15.*/
+	void checkStatistics15( const COLLADASaxFWL::DocumentStatistics& statistics )
+	{
+		check( "version", statistics.version, COLLADASaxFWL::COLLADA_15 );
+		check( "libraryFlags", statistics.libraryFlags, COLLADASaxFWL::DocumentStatistics::LIBRARY_IMAGES
+			| COLLADASaxFWL::DocumentStatistics::LIBRARY_CONTROLLERS );
+		check( "elementCount", statistics.elementCount, countElements( DOCUMENT_15 ) );
+		check( "geometryCount", statistics.geometryCount, 0 );
+		check( "controllerCount", statistics.controllerCount, 1 );
+		check( "imageCount", statistics.imageCount, 2 );
+		check( "triangleEstimate", statistics.triangleEstimate, 0 );
+		check( "externalDocuments", statistics.externalDocuments.size(), 1 );
+		check( "externalDocuments meshes.dae", statistics.externalDocuments.count( "meshes.dae" ), 1 );
+		check( "imageFiles", statistics.imageFiles.size(), 1 );
+		check( "imageFiles file:///images/stone.jpg", statistics.imageFiles.count( "file:///images/stone.jpg" ), 1 );
+	}
+
+	//------------------------------
+	/** Writes @a document to @a fileName.*/
+	bool writeDocument( const std::string& fileName, const char* document )
+	{
+		FILE* file = fopen( fileName.c_str(), "wb" );
+		if ( !file )
+		{
+			fprintf( stderr, "could not write %s\n", fileName.c_str() );
+			return false;
+		}
+		const size_t length = strlen( document );
+		const bool success = fwrite( document, 1, length, file ) == length;
+		return ( fclose( file ) == 0 ) && success;
+	}
+
+	//------------------------------
+	/** Scans @a document from a buffer and from the file @a fileName with the same scanner and
+	checks the statistics with @a checkStatistics.*/
+	void checkDocument( COLLADASaxFWL::DocumentScanner& scanner, const char* document, const std::string& fileName,
+		void (*checkStatistics)( const COLLADASaxFWL::DocumentStatistics& ) )
+	{
+		COLLADASaxFWL::DocumentStatistics statistics;
+		if ( !scanner.scanDocument( fileName, document, (int)strlen( document ), statistics ) )
+		{
+			fprintf( stderr, "%s: scanning the buffer failed\n", fileName.c_str() );
+			++failureCount;
+		}
+		checkStatistics( statistics );
+
+		if ( !writeDocument( fileName, document ) || !scanner.scanDocument( fileName, statistics ) )
+		{
+			fprintf( stderr, "%s: scanning the file failed\n", fileName.c_str() );
+			++failureCount;
+		}
+		checkStatistics( statistics );
+	}
+}
+
+
+//--------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	if ( argc > 2 )
+	{
+		fprintf( stderr, "usage: %s [directory]\n", argv[0] );
+		return 2;
+	}
+	const std::string directory = argc == 2 ? std::string( argv[1] ) + "/" : std::string( "./" );
+
+	// the scanner is reused, so the statistics of one document must not leak into the next one
+	COLLADASaxFWL::DocumentScanner scanner;
+	checkDocument( scanner, DOCUMENT_14, directory + "documentScannerTest14.dae", checkStatistics14 );
+	checkDocument( scanner, DOCUMENT_15, directory + "documentScannerTest15.dae", checkStatistics15 );
+	checkDocument( scanner, DOCUMENT_14, directory + "documentScannerTest14.dae", checkStatistics14 );
+
+	printf( "%d failed checks\n", (int)failureCount );
+	return failureCount == 0 ? 0 : 1;
+}
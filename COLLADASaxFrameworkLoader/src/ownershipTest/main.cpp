@@ -0,0 +1,657 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Loads a document with objects of most kinds by a writer that takes the ownership of no objects
+    and by writers that take the ownership of all objects (COLLADAFW::IWriter::OBJECT_ALL). The
+    owning writers read their objects after the loader has been destroyed and delete them then.
+    One of them fails to write the first morph controller, so that the loader has to delete the
+    controllers it did not hand over.
+    The test replaces the global operator new and delete. Freed memory is overwritten, so objects
+    deleted by the loader are noticed when the writer reads them, deleting a block twice aborts the
+    test and the number of allocated blocks after each load is compared with the number before it,
+    which detects leaked objects.
+
+    usage: ownershipTest [directory]   writes its document to the directory, default .
+*/
+
+#include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLIErrorHandler.h"
+
+#include "COLLADAFW.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/** Marks the blocks allocated by operator new.*/
+	const size_t BLOCK_ALLOCATED = 0x0a110ca7edb10c4bULL;
+
+	/** Marks the blocks freed by operator delete.*/
+	const size_t BLOCK_FREED = 0xf4eedb10cf4eedb1ULL;
+
+	/** The size of the header in front of each block, that holds the marker and the size. It keeps
+	the blocks aligned to 16 bytes.*/
+	const size_t BLOCK_HEADER_SIZE = 16;
+
+	/** The number of blocks allocated by operator new and not yet freed.*/
+	size_t allocatedBlockCount = 0;
+
+	//------------------------------
+	void* allocateBlock( size_t size )
+	{
+		char* header = (char*)malloc( size + BLOCK_HEADER_SIZE );
+		if ( !header )
+			return 0;
+		((size_t*)header)[0] = BLOCK_ALLOCATED;
+		((size_t*)header)[1] = size;
+		__sync_fetch_and_add( &allocatedBlockCount, 1 );
+		return header + BLOCK_HEADER_SIZE;
+	}
+
+	//------------------------------
+	void freeBlock( void* block )
+	{
+		if ( !block )
+			return;
+		char* header = (char*)block - BLOCK_HEADER_SIZE;
+		if ( ((size_t*)header)[0] != BLOCK_ALLOCATED )
+		{
+			fprintf( stderr, "deleted a block that has not been allocated or has already been deleted\n" );
+			abort();
+		}
+		// overwrite the block, so that reading a deleted object gives wrong values
+		memset( block, 0xdd, ((size_t*)header)[1] );
+		((size_t*)header)[0] = BLOCK_FREED;
+		__sync_fetch_and_sub( &allocatedBlockCount, 1 );
+		free( header );
+	}
+}
+
+
+//--------------------------------------------------------------------
+void* operator new( size_t size )
+{
+	void* block = allocateBlock( size );
+	if ( !block )
+		throw std::bad_alloc();
+	return block;
+}
+
+//--------------------------------------------------------------------
+void* operator new[]( size_t size )
+{
+	return operator new( size );
+}
+
+//--------------------------------------------------------------------
+void* operator new( size_t size, const std::nothrow_t& ) throw()
+{
+	return allocateBlock( size );
+}
+
+//--------------------------------------------------------------------
+void* operator new[]( size_t size, const std::nothrow_t& ) throw()
+{
+	return allocateBlock( size );
+}
+
+//--------------------------------------------------------------------
+void operator delete( void* block ) throw()
+{
+	freeBlock( block );
+}
+
+//--------------------------------------------------------------------
+void operator delete[]( void* block ) throw()
+{
+	freeBlock( block );
+}
+
+//--------------------------------------------------------------------
+void operator delete( void* block, size_t ) throw()
+{
+	freeBlock( block );
+}
+
+//--------------------------------------------------------------------
+void operator delete[]( void* block, size_t ) throw()
+{
+	freeBlock( block );
+}
+
+
+namespace
+{
+	/** A COLLADA 1.4 document with an asset, an image, a material, an effect, a camera, a light,
+	two meshes, a skin and two morph controllers, an animation of a node, a visual scene, library
+	nodes and a scene.*/
+	const char* DOCUMENT =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+		"  <asset><unit name=\"meter\" meter=\"1\"/><up_axis>Y_UP</up_axis></asset>\n"
+		"  <library_images>\n"
+		"    <image id=\"wood\"><init_from>wood.png</init_from></image>\n"
+		"  </library_images>\n"
+		"  <library_materials>\n"
+		"    <material id=\"material\"><instance_effect url=\"#effect\"/></material>\n"
+		"  </library_materials>\n"
+		"  <library_effects>\n"
+		"    <effect id=\"effect\"><profile_COMMON><technique sid=\"common\">\n"
+		"      <phong><diffuse><color>1 0 0 1</color></diffuse></phong>\n"
+		"    </technique></profile_COMMON></effect>\n"
+		"  </library_effects>\n"
+		"  <library_cameras>\n"
+		"    <camera id=\"camera\"><optics><technique_common>\n"
+		"      <perspective><yfov>45</yfov><aspect_ratio>1.5</aspect_ratio><znear>0.1</znear><zfar>100</zfar></perspective>\n"
+		"    </technique_common></optics></camera>\n"
+		"  </library_cameras>\n"
+		"  <library_lights>\n"
+		"    <light id=\"light\"><technique_common><point><color>1 1 1</color></point></technique_common></light>\n"
+		"  </library_lights>\n"
+		"  <library_geometries>\n"
+		"    <geometry id=\"triangle\">\n"
+		"      <mesh>\n"
+		"        <source id=\"triangle-positions\">\n"
+		"          <float_array id=\"triangle-positions-array\" count=\"9\">0 0 0 1 0 0 0 1 0</float_array>\n"
+		"          <technique_common><accessor source=\"#triangle-positions-array\" count=\"3\" stride=\"3\">\n"
+		"            <param name=\"X\" type=\"float\"/><param name=\"Y\" type=\"float\"/><param name=\"Z\" type=\"float\"/>\n"
+		"          </accessor></technique_common>\n"
+		"        </source>\n"
+		"        <vertices id=\"triangle-vertices\"><input semantic=\"POSITION\" source=\"#triangle-positions\"/></vertices>\n"
+		"        <triangles count=\"1\" material=\"symbol\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#triangle-vertices\" offset=\"0\"/>\n"
+		"          <p>0 1 2</p>\n"
+		"        </triangles>\n"
+		"      </mesh>\n"
+		"    </geometry>\n"
+		"    <geometry id=\"target\">\n"
+		"      <mesh>\n"
+		"        <source id=\"target-positions\">\n"
+		"          <float_array id=\"target-positions-array\" count=\"9\">0 0 1 1 0 1 0 1 1</float_array>\n"
+		"          <technique_common><accessor source=\"#target-positions-array\" count=\"3\" stride=\"3\">\n"
+		"            <param name=\"X\" type=\"float\"/><param name=\"Y\" type=\"float\"/><param name=\"Z\" type=\"float\"/>\n"
+		"          </accessor></technique_common>\n"
+		"        </source>\n"
+		"        <vertices id=\"target-vertices\"><input semantic=\"POSITION\" source=\"#target-positions\"/></vertices>\n"
+		"        <triangles count=\"1\">\n"
+		"          <input semantic=\"VERTEX\" source=\"#target-vertices\" offset=\"0\"/>\n"
+		"          <p>0 1 2</p>\n"
+		"        </triangles>\n"
+		"      </mesh>\n"
+		"    </geometry>\n"
+		"  </library_geometries>\n"
+		"  <library_controllers>\n"
+		"    <controller id=\"skin\">\n"
+		"      <skin source=\"#triangle\">\n"
+		"        <bind_shape_matrix>1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1</bind_shape_matrix>\n"
+		"        <source id=\"skin-joints\">\n"
+		"          <Name_array id=\"skin-joints-array\" count=\"1\">joint</Name_array>\n"
+		"          <technique_common><accessor source=\"#skin-joints-array\" count=\"1\"><param name=\"JOINT\" type=\"name\"/></accessor></technique_common>\n"
+		"        </source>\n"
+		"        <source id=\"skin-bind-poses\">\n"
+		"          <float_array id=\"skin-bind-poses-array\" count=\"16\">1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1</float_array>\n"
+		"          <technique_common><accessor source=\"#skin-bind-poses-array\" count=\"1\" stride=\"16\"><param name=\"TRANSFORM\" type=\"float4x4\"/></accessor></technique_common>\n"
+		"        </source>\n"
+		"        <source id=\"skin-weights\">\n"
+		"          <float_array id=\"skin-weights-array\" count=\"1\">1</float_array>\n"
+		"          <technique_common><accessor source=\"#skin-weights-array\" count=\"1\"><param name=\"WEIGHT\" type=\"float\"/></accessor></technique_common>\n"
+		"        </source>\n"
+		"        <joints>\n"
+		"          <input semantic=\"JOINT\" source=\"#skin-joints\"/>\n"
+		"          <input semantic=\"INV_BIND_MATRIX\" source=\"#skin-bind-poses\"/>\n"
+		"        </joints>\n"
+		"        <vertex_weights count=\"3\">\n"
+		"          <input semantic=\"JOINT\" source=\"#skin-joints\" offset=\"0\"/>\n"
+		"          <input semantic=\"WEIGHT\" source=\"#skin-weights\" offset=\"1\"/>\n"
+		"          <vcount>1 1 1</vcount>\n"
+		"          <v>0 0 0 0 0 0</v>\n"
+		"        </vertex_weights>\n"
+		"      </skin>\n"
+		"    </controller>\n"
+		"    <controller id=\"morph\">\n"
+		"      <morph source=\"#triangle\" method=\"NORMALIZED\">\n"
+		"        <source id=\"morph-targets\">\n"
+		"          <IDREF_array id=\"morph-targets-array\" count=\"1\">target</IDREF_array>\n"
+		"          <technique_common><accessor source=\"#morph-targets-array\" count=\"1\"><param name=\"IDREF\" type=\"IDREF\"/></accessor></technique_common>\n"
+		"        </source>\n"
+		"        <source id=\"morph-weights\">\n"
+		"          <float_array id=\"morph-weights-array\" count=\"1\">0.5</float_array>\n"
+		"          <technique_common><accessor source=\"#morph-weights-array\" count=\"1\"><param name=\"MORPH_WEIGHT\" type=\"float\"/></accessor></technique_common>\n"
+		"        </source>\n"
+		"        <targets>\n"
+		"          <input semantic=\"MORPH_TARGET\" source=\"#morph-targets\"/>\n"
+		"          <input semantic=\"MORPH_WEIGHT\" source=\"#morph-weights\"/>\n"
+		"        </targets>\n"
+		"      </morph>\n"
+		"    </controller>\n"
+		"    <controller id=\"second-morph\">\n"
+		"      <morph source=\"#target\" method=\"RELATIVE\">\n"
+		"        <source id=\"second-morph-targets\">\n"
+		"          <IDREF_array id=\"second-morph-targets-array\" count=\"1\">triangle</IDREF_array>\n"
+		"          <technique_common><accessor source=\"#second-morph-targets-array\" count=\"1\"><param name=\"IDREF\" type=\"IDREF\"/></accessor></technique_common>\n"
+		"        </source>\n"
+		"        <source id=\"second-morph-weights\">\n"
+		"          <float_array id=\"second-morph-weights-array\" count=\"1\">0.25</float_array>\n"
+		"          <technique_common><accessor source=\"#second-morph-weights-array\" count=\"1\"><param name=\"MORPH_WEIGHT\" type=\"float\"/></accessor></technique_common>\n"
+		"        </source>\n"
+		"        <targets>\n"
+		"          <input semantic=\"MORPH_TARGET\" source=\"#second-morph-targets\"/>\n"
+		"          <input semantic=\"MORPH_WEIGHT\" source=\"#second-morph-weights\"/>\n"
+		"        </targets>\n"
+		"      </morph>\n"
+		"    </controller>\n"
+		"  </library_controllers>\n"
+		"  <library_animations>\n"
+		"    <animation id=\"move\">\n"
+		"      <source id=\"move-input\">\n"
+		"        <float_array id=\"move-input-array\" count=\"2\">0 1</float_array>\n"
+		"        <technique_common><accessor source=\"#move-input-array\" count=\"2\"><param name=\"TIME\" type=\"float\"/></accessor></technique_common>\n"
+		"      </source>\n"
+		"      <source id=\"move-output\">\n"
+		"        <float_array id=\"move-output-array\" count=\"2\">0 10</float_array>\n"
+		"        <technique_common><accessor source=\"#move-output-array\" count=\"2\"><param name=\"X\" type=\"float\"/></accessor></technique_common>\n"
+		"      </source>\n"
+		"      <source id=\"move-interpolation\">\n"
+		"        <Name_array id=\"move-interpolation-array\" count=\"2\">LINEAR LINEAR</Name_array>\n"
+		"        <technique_common><accessor source=\"#move-interpolation-array\" count=\"2\"><param name=\"INTERPOLATION\" type=\"name\"/></accessor></technique_common>\n"
+		"      </source>\n"
+		"      <sampler id=\"move-sampler\">\n"
+		"        <input semantic=\"INPUT\" source=\"#move-input\"/>\n"
+		"        <input semantic=\"OUTPUT\" source=\"#move-output\"/>\n"
+		"        <input semantic=\"INTERPOLATION\" source=\"#move-interpolation\"/>\n"
+		"      </sampler>\n"
+		"      <channel source=\"#move-sampler\" target=\"moved/translation.X\"/>\n"
+		"    </animation>\n"
+		"  </library_animations>\n"
+		"  <library_nodes>\n"
+		"    <node id=\"library-node\" name=\"library-node\"><instance_light url=\"#light\"/></node>\n"
+		"  </library_nodes>\n"
+		"  <library_visual_scenes>\n"
+		"    <visual_scene id=\"scene\">\n"
+		"      <node id=\"moved\" name=\"moved\">\n"
+		"        <translate sid=\"translation\">0 0 0</translate>\n"
+		"        <instance_geometry url=\"#triangle\">\n"
+		"          <bind_material><technique_common>\n"
+		"            <instance_material symbol=\"symbol\" target=\"#material\"/>\n"
+		"          </technique_common></bind_material>\n"
+		"        </instance_geometry>\n"
+		"        <instance_camera url=\"#camera\"/>\n"
+		"        <instance_node url=\"#library-node\"/>\n"
+		"      </node>\n"
+		"      <node id=\"joint\" sid=\"joint\" name=\"joint\" type=\"JOINT\"/>\n"
+		"      <node id=\"skinned\" name=\"skinned\">\n"
+		"        <instance_controller url=\"#skin\"><skeleton>#joint</skeleton></instance_controller>\n"
+		"        <instance_controller url=\"#morph\"/>\n"
+		"        <instance_controller url=\"#second-morph\"/>\n"
+		"      </node>\n"
+		"    </visual_scene>\n"
+		"  </library_visual_scenes>\n"
+		"  <scene><instance_visual_scene url=\"#scene\"/></scene>\n"
+		"</COLLADA>\n";
+
+
+	/** The number of failed checks.*/
+	size_t failureCount = 0;
+
+	//------------------------------
+	/** Compares @a value with @a expected and reports a difference.*/
+	void check( const char* name, size_t value, size_t expected )
+	{
+		if ( value == expected )
+			return;
+		fprintf( stderr, "%s is %d, expected %d\n", name, (int)value, (int)expected );
+		++failureCount;
+	}
+
+
+	/** Writer that keeps the objects it receives, if it takes the ownership of all objects.
+	Otherwise it only counts them.*/
+	class OwningWriter : public COLLADAFW::IWriter
+	{
+	public:
+		/** The numbers of the objects received by the writer.*/
+		struct ObjectCounts
+		{
+			size_t geometries;
+			size_t materials;
+			size_t effects;
+			size_t cameras;
+			size_t images;
+			size_t lights;
+			size_t animations;
+			size_t animationLists;
+			size_t skinControllerData;
+			size_t skinControllers;
+			size_t morphControllers;
+			size_t visualScenes;
+			size_t libraryNodes;
+			size_t scenes;
+		};
+
+	private:
+		bool mOwnsObjects;
+		bool mFailMorphControllers;
+		ObjectCounts mCounts;
+
+		const COLLADAFW::FileInfo* mAsset;
+		const COLLADAFW::Scene* mScene;
+		const COLLADAFW::Formulas* mFormulas;
+		const COLLADAFW::KinematicsScene* mKinematicsScene;
+		std::vector<const COLLADAFW::VisualScene*> mVisualScenes;
+		std::vector<const COLLADAFW::LibraryNodes*> mLibraryNodes;
+		std::vector<const COLLADAFW::Geometry*> mGeometries;
+		std::vector<const COLLADAFW::Material*> mMaterials;
+		std::vector<const COLLADAFW::Effect*> mEffects;
+		std::vector<const COLLADAFW::Camera*> mCameras;
+		std::vector<const COLLADAFW::Image*> mImages;
+		std::vector<const COLLADAFW::Light*> mLights;
+		std::vector<const COLLADAFW::Animation*> mAnimations;
+		std::vector<const COLLADAFW::AnimationList*> mAnimationLists;
+		std::vector<const COLLADAFW::SkinControllerData*> mSkinControllerData;
+		std::vector<const COLLADAFW::Controller*> mControllers;
+
+	public:
+		/** @param ownsObjects True, if the writer takes the ownership of all objects.
+		@param failMorphControllers True, if writing a morph controller fails.*/
+		OwningWriter( bool ownsObjects, bool failMorphControllers )
+			: mOwnsObjects( ownsObjects )
+			, mFailMorphControllers( failMorphControllers )
+			, mAsset( 0 )
+			, mScene( 0 )
+			, mFormulas( 0 )
+			, mKinematicsScene( 0 )
+		{
+			memset( &mCounts, 0, sizeof(mCounts) );
+		}
+
+		virtual ~OwningWriter() { deleteObjects(); }
+
+		const ObjectCounts& getCounts() const { return mCounts; }
+
+		/** Checks the kept objects. They must still be valid after the loader has been destroyed.*/
+		void checkObjects() const
+		{
+			if ( !mOwnsObjects )
+				return;
+			check( "kept geometries", mGeometries.size(), mCounts.geometries );
+			for ( size_t i = 0; i < mGeometries.size(); ++i )
+			{
+				check( "geometry type", mGeometries[i]->getType(), COLLADAFW::Geometry::GEO_TYPE_MESH );
+				const COLLADAFW::Mesh* mesh = (const COLLADAFW::Mesh*)mGeometries[i];
+				check( "mesh positions", mesh->getPositions().getValuesCount(), 9 );
+				check( "mesh primitives", mesh->getMeshPrimitives().getCount(), 1 );
+			}
+			for ( size_t i = 0; i < mVisualScenes.size(); ++i )
+			{
+				const COLLADAFW::NodePointerArray& rootNodes = mVisualScenes[i]->getRootNodes();
+				check( "visual scene root nodes", rootNodes.getCount(), 3 );
+				if ( rootNodes.getCount() > 0 )
+					check( "first root node name", rootNodes[0]->getName() == "moved", true );
+			}
+			for ( size_t i = 0; i < mLibraryNodes.size(); ++i )
+				check( "library nodes", mLibraryNodes[i]->getNodes().getCount(), 1 );
+			for ( size_t i = 0; i < mSkinControllerData.size(); ++i )
+				check( "skin controller data joints", mSkinControllerData[i]->getJointsCount(), 1 );
+			for ( size_t i = 0; i < mControllers.size(); ++i )
+			{
+				const COLLADAFW::Controller* controller = mControllers[i];
+				if ( controller->getControllerType() == COLLADAFW::Controller::CONTROLLER_TYPE_MORPH )
+					check( "morph targets", ((const COLLADAFW::MorphController*)controller)->getMorphTargets().getCount(), 1 );
+				else
+					check( "controller type", controller->getControllerType(), COLLADAFW::Controller::CONTROLLER_TYPE_SKIN );
+			}
+			for ( size_t i = 0; i < mAnimations.size(); ++i )
+				check( "animation keys", ((const COLLADAFW::AnimationCurve*)mAnimations[i])->getKeyCount(), 2 );
+			for ( size_t i = 0; i < mAnimationLists.size(); ++i )
+				check( "animation bindings", mAnimationLists[i]->getAnimationBindings().getCount(), 1 );
+			for ( size_t i = 0; i < mEffects.size(); ++i )
+				check( "effect common effects", mEffects[i]->getCommonEffects().getCount(), 1 );
+			for ( size_t i = 0; i < mImages.size(); ++i )
+				check( "image file", mImages[i]->getImageURI().getURIString().find( "wood.png" ) != COLLADAFW::String::npos, true );
+		}
+
+		/** Deletes the kept objects.*/
+		void deleteObjects()
+		{
+			delete mAsset;
+			mAsset = 0;
+			delete mScene;
+			mScene = 0;
+			delete mFormulas;
+			mFormulas = 0;
+			delete mKinematicsScene;
+			mKinematicsScene = 0;
+			deleteAll( mVisualScenes );
+			deleteAll( mLibraryNodes );
+			deleteAll( mGeometries );
+			deleteAll( mMaterials );
+			deleteAll( mEffects );
+			deleteAll( mCameras );
+			deleteAll( mImages );
+			deleteAll( mLights );
+			deleteAll( mAnimations );
+			deleteAll( mAnimationLists );
+			deleteAll( mSkinControllerData );
+			deleteAll( mControllers );
+		}
+
+		virtual int getOwnedObjects() const { return mOwnsObjects ? OBJECT_ALL : OBJECT_NONE; }
+
+		virtual void cancel( const COLLADAFW::String& /*errorMessage*/ ) {}
+		virtual void start() {}
+		virtual void finish() {}
+
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* asset )
+		{
+			if ( mOwnsObjects )
+			{
+				delete mAsset;
+				mAsset = asset;
+			}
+			return true;
+		}
+
+		virtual bool writeScene( const COLLADAFW::Scene* scene )
+		{
+			++mCounts.scenes;
+			if ( mOwnsObjects )
+			{
+				delete mScene;
+				mScene = scene;
+			}
+			return true;
+		}
+
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* visualScene ) { return keep( mVisualScenes, visualScene, mCounts.visualScenes ); }
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes ) { return keep( mLibraryNodes, libraryNodes, mCounts.libraryNodes ); }
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry ) { return keep( mGeometries, geometry, mCounts.geometries ); }
+		virtual bool writeMaterial( const COLLADAFW::Material* material ) { return keep( mMaterials, material, mCounts.materials ); }
+		virtual bool writeEffect( const COLLADAFW::Effect* effect ) { return keep( mEffects, effect, mCounts.effects ); }
+		virtual bool writeCamera( const COLLADAFW::Camera* camera ) { return keep( mCameras, camera, mCounts.cameras ); }
+		virtual bool writeImage( const COLLADAFW::Image* image ) { return keep( mImages, image, mCounts.images ); }
+		virtual bool writeLight( const COLLADAFW::Light* light ) { return keep( mLights, light, mCounts.lights ); }
+		virtual bool writeAnimation( const COLLADAFW::Animation* animation ) { return keep( mAnimations, animation, mCounts.animations ); }
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* animationList ) { return keep( mAnimationLists, animationList, mCounts.animationLists ); }
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData ) { return keep( mSkinControllerData, skinControllerData, mCounts.skinControllerData ); }
+
+		virtual bool writeController( const COLLADAFW::Controller* controller )
+		{
+			const bool isMorph = controller->getControllerType() == COLLADAFW::Controller::CONTROLLER_TYPE_MORPH;
+			keep( mControllers, controller, isMorph ? mCounts.morphControllers : mCounts.skinControllers );
+			return !( isMorph && mFailMorphControllers );
+		}
+
+		virtual bool writeFormulas( const COLLADAFW::Formulas* formulas )
+		{
+			if ( mOwnsObjects )
+			{
+				delete mFormulas;
+				mFormulas = formulas;
+			}
+			return true;
+		}
+
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene )
+		{
+			if ( mOwnsObjects )
+			{
+				delete mKinematicsScene;
+				mKinematicsScene = kinematicsScene;
+			}
+			return true;
+		}
+
+	private:
+		/** Counts @a object and keeps it in @a objects, if the writer owns the objects.*/
+		template<class ObjectType>
+		bool keep( std::vector<const ObjectType*>& objects, const ObjectType* object, size_t& count )
+		{
+			++count;
+			if ( mOwnsObjects )
+				objects.push_back( object );
+			return true;
+		}
+
+		/** Deletes the objects in @a objects.*/
+		template<class ObjectType>
+		static void deleteAll( std::vector<const ObjectType*>& objects )
+		{
+			for ( size_t i = 0; i < objects.size(); ++i )
+				delete objects[i];
+			objects.clear();
+		}
+
+		/** Disable default copy ctor. */
+		OwningWriter( const OwningWriter& pre );
+		/** Disable default assignment operator. */
+		const OwningWriter& operator= ( const OwningWriter& pre );
+	};
+
+
+	/** Counts the errors reported by the loader.*/
+	class CountingErrorHandler : public COLLADASaxFWL::IErrorHandler
+	{
+	public:
+		size_t mErrorCount;
+
+		CountingErrorHandler() : mErrorCount(0) {}
+		virtual ~CountingErrorHandler() {}
+
+		virtual bool handleError( const COLLADASaxFWL::IError* /*error*/ ) { ++mErrorCount; return false; }
+	};
+
+
+	//------------------------------
+	/** Writes @a document to @a fileName.*/
+	bool writeDocument( const std::string& fileName, const char* document )
+	{
+		FILE* file = fopen( fileName.c_str(), "wb" );
+		if ( !file )
+		{
+			fprintf( stderr, "could not write %s\n", fileName.c_str() );
+			return false;
+		}
+		const size_t length = strlen( document );
+		const bool success = fwrite( document, 1, length, file ) == length;
+		return ( fclose( file ) == 0 ) && success;
+	}
+
+	//------------------------------
+	/** Loads @a fileName with @a writer and destroys the loader, before the writer checks its
+	objects.*/
+	void loadDocument( const std::string& fileName, OwningWriter& writer )
+	{
+		CountingErrorHandler errorHandler;
+		bool success = false;
+		{
+			COLLADASaxFWL::Loader loader( &errorHandler );
+			COLLADAFW::Root root( &loader, &writer );
+			success = root.loadDocument( fileName );
+		}
+		if ( !success )
+		{
+			fprintf( stderr, "%s: loading failed with %d errors\n", fileName.c_str(), (int)errorHandler.mErrorCount );
+			++failureCount;
+		}
+		writer.checkObjects();
+	}
+
+	//------------------------------
+	/** Loads @a fileName with a writer, that owns all objects, if @a ownsObjects is true. Checks
+	the number of received objects and that the objects are neither leaked nor deleted twice.*/
+	void checkOwnership( const std::string& fileName, bool ownsObjects, bool failMorphControllers )
+	{
+		const size_t allocatedBlockCountBefore = allocatedBlockCount;
+		{
+			OwningWriter writer( ownsObjects, failMorphControllers );
+			loadDocument( fileName, writer );
+
+			const OwningWriter::ObjectCounts& counts = writer.getCounts();
+			check( "geometries", counts.geometries, 2 );
+			check( "materials", counts.materials, 1 );
+			check( "effects", counts.effects, 1 );
+			check( "cameras", counts.cameras, 1 );
+			check( "images", counts.images, 1 );
+			check( "lights", counts.lights, 1 );
+			check( "animations", counts.animations, 1 );
+			check( "animation lists", counts.animationLists, 1 );
+			check( "skin controller data", counts.skinControllerData, 1 );
+			check( "skin controllers", counts.skinControllers, 1 );
+			// the loader stops writing morph controllers at the first one that fails
+			check( "morph controllers", counts.morphControllers, failMorphControllers ? 1 : 2 );
+			check( "visual scenes", counts.visualScenes, 1 );
+			check( "library nodes", counts.libraryNodes, 1 );
+			check( "scenes", counts.scenes, 1 );
+		}
+		if ( allocatedBlockCount != allocatedBlockCountBefore )
+		{
+			fprintf( stderr, "%s: %d blocks leaked (owned objects %d, failing morph controllers %d)\n", fileName.c_str(),
+				(int)( allocatedBlockCount - allocatedBlockCountBefore ), (int)ownsObjects, (int)failMorphControllers );
+			++failureCount;
+		}
+	}
+}
+
+
+//--------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	if ( argc > 2 )
+	{
+		fprintf( stderr, "usage: %s [directory]\n", argv[0] );
+		return 2;
+	}
+	const std::string directory = argc == 2 ? std::string( argv[1] ) + "/" : std::string( "./" );
+	const std::string fileName = directory + "ownershipTest.dae";
+	if ( !writeDocument( fileName, DOCUMENT ) )
+		return 1;
+
+	// the first load initializes the static data of the loader and the parser, which are
+	// allocated once and never freed
+	{
+		OwningWriter writer( false, false );
+		loadDocument( fileName, writer );
+	}
+
+	checkOwnership( fileName, false, false );
+	checkOwnership( fileName, true, false );
+	checkOwnership( fileName, true, true );
+
+	printf( "%d failed checks\n", (int)failureCount );
+	return failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+
+# Builds the pass-through rewriter test twice, once with libxml and once with expat as xml parser.
+# The rewriter and the sax parser are compiled from source for each xml parser, everything else is
+# taken from the static libraries of a regular build of OpenCOLLADA in LIBDIR.
+# run: ./passThroughTestLibxml && ./passThroughTestExpat
+
+LIBDIR=${LIBDIR:-../../../build/lib}
+
+OPTIONS="-O2 -Wall -pthread"
+
+INCLUDES="-I../../include -I../../include/generated14 -I../../include/generated15 -I../../../COLLADAFramework/include -I../../../COLLADABaseUtils/include -I../../../COLLADABaseUtils/include/Math -I../../../GeneratedSaxParser/include -I../../../Externals/MathMLSolver/include -I../../../Externals/MathMLSolver/include/AST -I../../../Externals/pcre/include -I../../../common/libBuffer/include -I../../../common/libftoa/include -I/usr/include/libxml2"
+
+FILES="main.cpp ../COLLADASaxFWLPassThroughRewriter.cpp"
+
+LIBS="-L$LIBDIR -lOpenCOLLADASaxFrameworkLoader -lGeneratedSaxParser -lOpenCOLLADAFramework -lMathMLSolver -lOpenCOLLADABaseUtils -lUTF -lbuffer -lftoa -lpcre -lzziplib -lzlib"
+
+
+
+g++ $OPTIONS -DGENERATEDSAXPARSER_XMLPARSER_LIBXML $INCLUDES $FILES $LIBS -lxml2 -o passThroughTestLibxml
+
+g++ $OPTIONS -DGENERATEDSAXPARSER_XMLPARSER_EXPAT $INCLUDES $FILES ../../../GeneratedSaxParser/src/GeneratedSaxParserExpatSaxParser.cpp $LIBS -lexpat -lxml2 -o passThroughTestExpat
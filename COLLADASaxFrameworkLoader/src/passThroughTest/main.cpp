@@ -0,0 +1,369 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Rewrites documents with PassThroughRewriter and compares the output with the expected bytes.
+    A handler that keeps everything must reproduce the input byte for byte, including a document
+    larger than the blocks the input is passed to the sax parser in. The offsets reported by
+    getMarkupEndOffset() are checked against the tags of the input directly.
+    The xml parser is chosen at compile time, build.sh builds the test once for libxml and once
+    for expat.
+
+    usage: passThroughTest
+*/
+
+#include "COLLADASaxFWLPassThroughRewriter.h"
+#include "COLLADASaxFWLIPassThroughHandler.h"
+#include "COLLADASaxFWLIErrorHandler.h"
+#include "COLLADASaxFWLIError.h"
+
+#include "GeneratedSaxParserParser.h"
+
+#include "CommonMemoryBufferFlusher.h"
+
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+#	include "GeneratedSaxParserLibxmlSaxParser.h"
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+#	include "GeneratedSaxParserExpatSaxParser.h"
+#else
+#	error "No prepocesser flag set to chose the xml parser to use"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+
+namespace
+{
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+	const char* XMLPARSER_NAME = "libxml";
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+	const char* XMLPARSER_NAME = "expat";
+#endif
+
+	/** A document with everything the rewriter copies verbatim: the xml declaration, comments,
+	processing instructions, CDATA sections, entity references, '>' in attribute values, empty
+	element tags with and without white space and white space in end tags.*/
+	const char* SAMPLE_DOCUMENT =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<!-- exported for the pass-through test -->\n"
+		"<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+		"  <asset>\n"
+		"    <contributor><author>a &amp; b</author><comments>x &lt; y</comments></contributor>\n"
+		"    <unit name=\"meter\" meter=\"1\"/>\n"
+		"    <up_axis >Y_UP</up_axis >\n"
+		"  </asset>\n"
+		"  <?tool keep=\"this\"?>\n"
+		"  <library_lights>\n"
+		"    <light id=\"sun\" name=\"a > b\"><technique_common><directional><color>1 1 1</color></directional></technique_common></light>\n"
+		"  </library_lights>\n"
+		"  <library_images>\n"
+		"    <image id=\"tex\"><init_from>file:///tex.png</init_from></image>\n"
+		"    <image id=\"empty\" />\n"
+		"  </library_images>\n"
+		"  <extra><technique profile=\"test\"><![CDATA[<not a tag>]]></technique></extra>\n"
+		"  <scene><instance_visual_scene url=\"#scene\"/></scene>\n"
+		"</COLLADA>\n"
+		"<!-- trailing comment -->\n";
+
+	/** SAMPLE_DOCUMENT as rewritten by EditingHandler.*/
+	const char* EDITED_SAMPLE_DOCUMENT =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<!-- exported for the pass-through test -->\n"
+		"<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+		"  <asset>\n"
+		"    <contributor><author>rewriter</author><comments>x &lt; y</comments></contributor>\n"
+		"    <unit name=\"meter\" meter=\"1\"/>\n"
+		"    <up_axis >Z_UP</up_axis >\n"
+		"  </asset>\n"
+		"  <?tool keep=\"this\"?>\n"
+		"  <!-- lights removed -->\n"
+		"  <library_images>\n"
+		"    <image id=\"tex\"><init_from>file:///tex.png</init_from></image>\n"
+		"    <image id=\"empty\" ><init_from>file:///empty.png</init_from></image>\n"
+		"  </library_images>\n"
+		"  <extra><technique profile=\"test\"><![CDATA[<not a tag>]]></technique></extra>\n"
+		"  <scene><instance_visual_scene url=\"#main\"></instance_visual_scene></scene>\n"
+		"</COLLADA>\n"
+		"<!-- trailing comment -->\n";
+
+	/** The number of nodes of the large document. Large enough to exceed the 1MB blocks the
+	rewriter passes the input in, so that tags are split between two blocks.*/
+	const size_t LARGE_DOCUMENT_NODE_COUNT = 40000;
+
+
+	int failedChecks = 0;
+
+	void check( bool condition, const char* test, const char* message )
+	{
+		if ( condition )
+			return;
+		printf( "%s: %s: %s\n", XMLPARSER_NAME, test, message );
+		failedChecks++;
+	}
+
+
+	/** Passes all errors to stdout.*/
+	class PrintingErrorHandler : public COLLADASaxFWL::IErrorHandler
+	{
+	public:
+		virtual bool handleError( const COLLADASaxFWL::IError* error )
+		{
+			printf( "%s: %s\n", XMLPARSER_NAME, error->getFullErrorMessage().c_str() );
+			return false;
+		}
+	};
+
+
+	/** Keeps every element and all character data, i.e. the output must equal the input.*/
+	class KeepingHandler : public COLLADASaxFWL::IPassThroughHandler
+	{
+	public:
+		virtual ElementAction elementBegin( const COLLADASaxFWL::ParserChar* elementName, const COLLADASaxFWL::ParserAttributes& attributes, COLLADASaxFWL::PassThroughRewriter& rewriter )
+		{
+			return COPY_START_TAG;
+		}
+
+		virtual void elementEnd( const COLLADASaxFWL::ParserChar* elementName, COLLADASaxFWL::PassThroughRewriter& rewriter ) {}
+
+		virtual bool textData( const COLLADASaxFWL::ParserChar* text, size_t textLength, COLLADASaxFWL::PassThroughRewriter& rewriter )
+		{
+			return true;
+		}
+	};
+
+
+	/** Copies the root element as a whole, i.e. no child is passed to the handler.*/
+	class CopyingHandler : public KeepingHandler
+	{
+	public:
+		virtual ElementAction elementBegin( const COLLADASaxFWL::ParserChar* elementName, const COLLADASaxFWL::ParserAttributes& attributes, COLLADASaxFWL::PassThroughRewriter& rewriter )
+		{
+			return COPY_ELEMENT;
+		}
+	};
+
+
+	/** Uses every element action on SAMPLE_DOCUMENT. The result is EDITED_SAMPLE_DOCUMENT.*/
+	class EditingHandler : public KeepingHandler
+	{
+	private:
+		/** The name of the element, whose character data is currently passed to textData().*/
+		std::string mCurrentElement;
+
+	public:
+		virtual ElementAction elementBegin( const COLLADASaxFWL::ParserChar* elementName, const COLLADASaxFWL::ParserAttributes& attributes, COLLADASaxFWL::PassThroughRewriter& rewriter )
+		{
+			mCurrentElement = elementName;
+			if ( strcmp( elementName, "library_lights" ) == 0 )
+			{
+				rewriter.write( "<!-- lights removed -->" );
+				return REMOVE_ELEMENT;
+			}
+			if ( strcmp( elementName, "extra" ) == 0 || strcmp( elementName, "comments" ) == 0 )
+				return COPY_ELEMENT;
+			if ( strcmp( elementName, "instance_visual_scene" ) == 0 )
+			{
+				rewriter.write( "<instance_visual_scene url=\"#main\">" );
+				return REPLACE_START_TAG;
+			}
+			return COPY_START_TAG;
+		}
+
+		virtual void elementEnd( const COLLADASaxFWL::ParserChar* elementName, COLLADASaxFWL::PassThroughRewriter& rewriter )
+		{
+			mCurrentElement.clear();
+			if ( strcmp( elementName, "image" ) != 0 )
+				return;
+			// only the empty image gets a child
+			size_t startTagLength = 0;
+			const char* startTag = rewriter.getCurrentStartTag( startTagLength );
+			if ( std::string( startTag, startTagLength ) == "<image id=\"empty\" />" )
+				rewriter.write( "<init_from>file:///empty.png</init_from>" );
+		}
+
+		virtual bool textData( const COLLADASaxFWL::ParserChar* text, size_t textLength, COLLADASaxFWL::PassThroughRewriter& rewriter )
+		{
+			const char* replacement = 0;
+			if ( mCurrentElement == "author" )
+				replacement = "rewriter";
+			else if ( mCurrentElement == "up_axis" )
+				replacement = "Z_UP";
+			if ( !replacement )
+				return true;
+			rewriter.write( replacement );
+			// write only once, if the text is passed in several chunks. Returning false once removes all of them.
+			mCurrentElement.clear();
+			return false;
+		}
+	};
+
+
+	/** Parses a document with the sax parser the rewriter uses and checks, that the offsets
+	reported by getMarkupEndOffset() are behind the tag of the reported element.*/
+	class MarkupOffsetChecker : public GeneratedSaxParser::Parser
+	{
+	private:
+		const char* mDocument;
+		size_t mLength;
+		size_t mLastOffset;
+		size_t mTagCount;
+		size_t mWrongOffsetCount;
+
+	public:
+		MarkupOffsetChecker( const char* document, size_t length )
+			: GeneratedSaxParser::Parser( 0 )
+			, mDocument( document )
+			, mLength( length )
+			, mLastOffset( 0 )
+			, mTagCount( 0 )
+			, mWrongOffsetCount( 0 )
+		{}
+
+		/** Parses the document and reports the offsets that do not match their tag.*/
+		void run( const char* test )
+		{
+#if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
+			GeneratedSaxParser::LibxmlSaxParser saxParser( this );
+#elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
+			GeneratedSaxParser::ExpatSaxParser saxParser( this, 64*1024 );
+#endif
+			check( saxParser.parseBuffer( test, mDocument, (int)mLength ), test, "parsing failed" );
+			check( mTagCount > 0, test, "no tags reported" );
+			if ( mWrongOffsetCount > 0 )
+			{
+				printf( "%s: %s: %d of %d markup end offsets are wrong\n", XMLPARSER_NAME, test, (int)mWrongOffsetCount, (int)mTagCount );
+				failedChecks++;
+			}
+		}
+
+		virtual bool elementBegin( const GeneratedSaxParser::ParserChar* elementName, const GeneratedSaxParser::ParserAttributes& attributes )
+		{
+			std::string tag = currentTag();
+			std::string expected = std::string( "<" ) + elementName;
+			bool matches = tag.compare( 0, expected.length(), expected ) == 0
+				&& tag.length() > expected.length()
+				&& strchr( " \t\r\n/>", tag[expected.length()] ) != 0;
+			countTag( matches );
+			return true;
+		}
+
+		virtual bool elementEnd( const GeneratedSaxParser::ParserChar* elementName )
+		{
+			std::string tag = currentTag();
+			std::string expectedEndTag = std::string( "</" ) + elementName;
+			std::string expectedStartTag = std::string( "<" ) + elementName;
+			bool isEndTag = tag.compare( 0, expectedEndTag.length(), expectedEndTag ) == 0;
+			bool isEmptyElementTag = tag.compare( 0, expectedStartTag.length(), expectedStartTag ) == 0
+				&& tag.length() >= 2 && tag.compare( tag.length() - 2, 2, "/>" ) == 0;
+			countTag( isEndTag || isEmptyElementTag );
+			return true;
+		}
+
+		virtual bool textData( const GeneratedSaxParser::ParserChar* text, size_t textLength )
+		{
+			return true;
+		}
+
+	private:
+		/** The tag, that ends at the offset reported by the sax parser.*/
+		std::string currentTag() const
+		{
+			size_t end = getMarkupEndOffset();
+			if ( end == 0 || end > mLength || mDocument[end - 1] != '>' )
+				return std::string();
+			size_t start = end - 1;
+			while ( start > 0 && mDocument[start] != '<' )
+				start--;
+			return std::string( mDocument + start, end - start );
+		}
+
+		void countTag( bool matches )
+		{
+			size_t offset = getMarkupEndOffset();
+			if ( !matches || offset < mLastOffset )
+				mWrongOffsetCount++;
+			mLastOffset = offset;
+			mTagCount++;
+		}
+	};
+
+
+	/** Rewrites @a input with @a handler and compares the output with @a expected.*/
+	void checkRewrite( const char* test, const std::string& input, const std::string& expected, COLLADASaxFWL::IPassThroughHandler& handler )
+	{
+		PrintingErrorHandler errorHandler;
+		COLLADASaxFWL::PassThroughRewriter rewriter( &handler, &errorHandler );
+		Common::MemoryBufferFlusher output;
+		bool success = rewriter.rewrite( test, input.c_str(), input.length(), &output );
+		check( success, test, "rewriting failed" );
+		if ( !success )
+			return;
+
+		std::string result( output.getData(), output.getSize() );
+		if ( result == expected )
+			return;
+
+		size_t difference = 0;
+		while ( difference < result.length() && difference < expected.length() && result[difference] == expected[difference] )
+			difference++;
+		printf( "%s: %s: output differs at byte %d (%d bytes written, %d expected)\n", XMLPARSER_NAME, test,
+		        (int)difference, (int)result.length(), (int)expected.length() );
+		failedChecks++;
+	}
+
+
+	/** A document with LARGE_DOCUMENT_NODE_COUNT nodes, whose tags vary in length so that the block
+	boundaries fall into different parts of the tags.*/
+	std::string makeLargeDocument()
+	{
+		std::string document = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<COLLADA version=\"1.4.1\">\n  <library_nodes>\n";
+		char node[256];
+		for ( size_t i = 0; i < LARGE_DOCUMENT_NODE_COUNT; ++i )
+		{
+			sprintf( node, "    <node id=\"node%d\" name=\"%*s\"><matrix>1 0 0 %d 0 1 0 0 0 0 1 0 0 0 0 1</matrix><instance_node url=\"#n%d\" /></node>\n",
+			         (int)i, (int)(i % 7), "", (int)i, (int)(i / 2) );
+			document += node;
+		}
+		document += "  </library_nodes>\n</COLLADA>\n";
+		return document;
+	}
+}
+
+
+int main( int argc, char** argv )
+{
+	const std::string sample( SAMPLE_DOCUMENT );
+
+	MarkupOffsetChecker sampleChecker( sample.c_str(), sample.length() );
+	sampleChecker.run( "sample markup offsets" );
+
+	KeepingHandler keepingHandler;
+	checkRewrite( "sample kept", sample, sample, keepingHandler );
+
+	CopyingHandler copyingHandler;
+	checkRewrite( "sample copied", sample, sample, copyingHandler );
+
+	EditingHandler editingHandler;
+	checkRewrite( "sample edited", sample, EDITED_SAMPLE_DOCUMENT, editingHandler );
+
+	const std::string large = makeLargeDocument();
+
+	MarkupOffsetChecker largeChecker( large.c_str(), large.length() );
+	largeChecker.run( "large markup offsets" );
+
+	checkRewrite( "large kept", large, large, keepingHandler );
+
+	printf( "%s: %d failed checks\n", XMLPARSER_NAME, failedChecks );
+	return failedChecks == 0 ? 0 : 1;
+}
@@ -0,0 +1,634 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Checks the quantization of mesh values. Positions and uv coordinates are encoded with
+    COLLADAFW::QuantizedArray::ENCODING_LINEAR, normals of unit and other lengths with
+    ENCODING_OCTAHEDRAL, from float and double values. Each decoded value must not differ from the
+    encoded one by more than getMaxError(). Values appended to an array must be decoded with the
+    scales and biases of their own segment. Then a mesh, whose two triangles primitives use
+    different normal and uv sources, is written with COLLADASW and loaded with
+    Loader::PRECISION_QUANTIZED. The loader quantizes each source once, when it is appended to the
+    mesh, so the precision errors of the loader must be the errors of encoding each source on its
+    own, and the loaded values must not differ from the written ones by more than these errors.
+
+    usage: quantizationTest [directory]   writes its document to the directory, default .
+*/
+
+#include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLIErrorHandler.h"
+
+#include "COLLADAFW.h"
+
+#include "COLLADASWStreamWriter.h"
+#include "COLLADASWException.h"
+#include "COLLADASWLibraryGeometries.h"
+#include "COLLADASWSource.h"
+#include "COLLADASWVertices.h"
+#include "COLLADASWPrimitves.h"
+#include "COLLADASWBaseInputElement.h"
+#include "COLLADASWInputList.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/** The number of vertices per side of the written grid.*/
+	const size_t GRID_SIZE = 12;
+
+	/** The number of random elements encoded by the QuantizedArray checks.*/
+	const size_t ELEMENT_COUNT = 2000;
+
+	/** The largest acceptable error of the encodings, relative to the range of the values.*/
+	const double MAX_LINEAR_ERROR = 1.0 / 65535.0;
+	const double MAX_OCTAHEDRAL_ERROR = 1e-4;
+
+	const char* MESH_ID = "quantized";
+
+	typedef std::vector<double> Values;
+
+
+	//------------------------------
+	/** Returns a pseudo random number in -1..1.*/
+	double getRandom( unsigned int& seed )
+	{
+		seed = seed * 1103515245u + 12345u;
+		return ( ( seed >> 8 ) & 0xffff ) / 32767.5 - 1.0;
+	}
+
+	//------------------------------
+	/** Returns the largest difference between @a values and their decoded values in @a array.*/
+	double getLargestError( const COLLADAFW::QuantizedArray& array, const Values& values )
+	{
+		Values decoded( values.size() );
+		array.decode( 0, decoded.size(), &decoded[0] );
+		double largestError = 0;
+		for ( size_t i = 0; i < values.size(); ++i )
+		{
+			const double error = fabs( decoded[i] - values[i] );
+			if ( error > largestError )
+				largestError = error;
+		}
+
+		// the float decoding must match the double decoding up to the float precision
+		std::vector<float> decodedFloats( values.size() );
+		array.decode( 0, decodedFloats.size(), &decodedFloats[0] );
+		for ( size_t i = 0; i < values.size(); ++i )
+		{
+			if ( decodedFloats[i] != (float)decoded[i] )
+				return HUGE_VAL;
+		}
+		return largestError;
+	}
+
+	//------------------------------
+	/** Encodes @a values with @a encoding and @a dimension from double and float values and checks,
+	that no value differs by more than getMaxError() and that getMaxError() is at most
+	@a maxError.
+	@return The number of failed checks.*/
+	size_t checkEncoding( const char* name, const Values& values, COLLADAFW::QuantizedArray::Encoding encoding, size_t dimension, double maxError )
+	{
+		size_t failureCount = 0;
+		const std::vector<float> floatValues( values.begin(), values.end() );
+		const Values roundedValues( floatValues.begin(), floatValues.end() );
+		for ( int useFloat = 0; useFloat < 2; ++useFloat )
+		{
+			COLLADAFW::QuantizedArray array;
+			bool success;
+			if ( encoding == COLLADAFW::QuantizedArray::ENCODING_OCTAHEDRAL )
+				success = useFloat ? array.encodeOctahedral( &floatValues[0], floatValues.size() ) : array.encodeOctahedral( &values[0], values.size() );
+			else
+				success = useFloat ? array.encodeLinear( &floatValues[0], floatValues.size(), dimension ) : array.encodeLinear( &values[0], values.size(), dimension );
+			if ( !success || array.getValuesCount() != values.size() || array.getDimension() != dimension || array.getEncoding() != encoding )
+			{
+				printf( "%s %s: encoding failed\n", name, useFloat ? "float" : "double" );
+				++failureCount;
+				continue;
+			}
+
+			const double largestError = getLargestError( array, useFloat ? roundedValues : values );
+			printf( "%s %s: max error %g, largest error %g\n", name, useFloat ? "float" : "double", array.getMaxError(), largestError );
+			if ( largestError > array.getMaxError() )
+				++failureCount;
+			if ( array.getMaxError() > maxError )
+				++failureCount;
+		}
+		return failureCount;
+	}
+
+	//------------------------------
+	/** Returns @a count random values in @a min..@a max.*/
+	Values getRandomValues( size_t count, double min, double max, unsigned int& seed )
+	{
+		Values values( count );
+		for ( size_t i = 0; i < count; ++i )
+			values[i] = min + ( getRandom( seed ) * 0.5 + 0.5 ) * ( max - min );
+		return values;
+	}
+
+	//------------------------------
+	/** Returns @a count random directions. If @a normalize is true, they have unit length,
+	otherwise their length is random in 0..2, including zero directions.*/
+	Values getRandomDirections( size_t count, bool normalize, unsigned int& seed )
+	{
+		Values values( 3 * count );
+		for ( size_t i = 0; i < count; ++i )
+		{
+			double* direction = &values[3 * i];
+			for ( size_t j = 0; j < 3; ++j )
+				direction[j] = getRandom( seed );
+			// directions along the axes and on the folded edge of the octahedron
+			if ( i % 50 == 1 )
+				direction[i % 3] = 0;
+			if ( i % 50 == 2 )
+				direction[2] = 0;
+			if ( i % 50 == 3 )
+				direction[0] = direction[1] = 0;
+
+			const double length = sqrt( direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2] );
+			const double newLength = normalize ? 1.0 : ( i % 50 == 4 ? 0.0 : 2.0 * ( getRandom( seed ) * 0.5 + 0.5 ) );
+			for ( size_t j = 0; j < 3; ++j )
+				direction[j] = length > 0 ? direction[j] / length * newLength : 0;
+		}
+		return values;
+	}
+
+	//------------------------------
+	/** Checks NaN values, which must not change the encoding of the other values.
+	@return The number of failed checks.*/
+	size_t checkNaN()
+	{
+		size_t failureCount = 0;
+		const double nan = sqrt( -1.0 );
+		const double values[] = { 1.0, nan, 3.0, 2.0, nan, nan };
+
+		COLLADAFW::QuantizedArray linear;
+		linear.encodeLinear( values, 6, 1 );
+		double decoded[6];
+		linear.decode( 0, 6, decoded );
+		if ( linear.getBias( 0 ) != 1.0 || fabs( decoded[2] - 3.0 ) > linear.getMaxError() || fabs( decoded[3] - 2.0 ) > linear.getMaxError() )
+			++failureCount;
+		if ( decoded[1] != 1.0 || decoded[4] != 1.0 || linear.getMaxError() != linear.getMaxError() )
+			++failureCount;
+
+		COLLADAFW::QuantizedArray octahedral;
+		octahedral.encodeOctahedral( values, 6 );
+		octahedral.decode( 0, 6, decoded );
+		for ( size_t i = 0; i < 6; ++i )
+		{
+			if ( fabs( decoded[i] - ( i % 3 == 2 ? 1.0 : 0.0 ) ) > MAX_OCTAHEDRAL_ERROR )
+				++failureCount;
+		}
+		printf( "NaN: %d failed checks\n", (int)failureCount );
+		return failureCount;
+	}
+
+	//------------------------------
+	/** Appends segments of different ranges and dimensions to a linear and directions to an
+	octahedral encoded array. Each value must be decoded as if its segment had been encoded on its
+	own, also if the decoded values span several segments.
+	@return The number of failed checks.*/
+	size_t checkAppend( unsigned int& seed )
+	{
+		size_t failureCount = 0;
+		const Values small = getRandomValues( 2 * ELEMENT_COUNT, -0.5, 0.5, seed );
+		const Values large = getRandomValues( 3 * ELEMENT_COUNT, 100.0, 5000.0, seed );
+		Values values( small );
+		values.insert( values.end(), large.begin(), large.end() );
+
+		COLLADAFW::QuantizedArray smallArray;
+		COLLADAFW::QuantizedArray largeArray;
+		COLLADAFW::QuantizedArray linear;
+		smallArray.encodeLinear( &small[0], small.size(), 2 );
+		largeArray.encodeLinear( &large[0], large.size(), 3 );
+		if ( !linear.appendLinear( &small[0], small.size(), 2 ) || !linear.appendLinear( &large[0], large.size(), 3 ) )
+			++failureCount;
+		if ( linear.getSegmentCount() != 2 || linear.getSegmentFirstValue( 1 ) != small.size() || linear.getSegmentDimension( 1 ) != 3 )
+			++failureCount;
+		// the segments have different dimensions, so each value is an element
+		if ( linear.getDimension() != 1 || linear.getValuesCount() != values.size() )
+			++failureCount;
+		// the small values are not encoded with the range of the large ones
+		const double maxError = smallArray.getMaxError() > largeArray.getMaxError() ? smallArray.getMaxError() : largeArray.getMaxError();
+		if ( linear.getMaxError() != maxError || getLargestError( linear, values ) > maxError )
+			++failureCount;
+
+		// values decoded across the segment boundary
+		Values decoded( 10 );
+		Values expected( 10 );
+		linear.decode( small.size() - 5, 10, &decoded[0] );
+		smallArray.decode( small.size() - 5, 5, &expected[0] );
+		largeArray.decode( 0, 5, &expected[5] );
+		if ( decoded != expected )
+			++failureCount;
+
+		// an octahedral encoded array only takes further directions
+		const size_t encodedCount = linear.getEncodedValues().getCount();
+		const Values directions = getRandomDirections( ELEMENT_COUNT, true, seed );
+		if ( linear.appendOctahedral( &directions[0], directions.size() ) || linear.getEncodedValues().getCount() != encodedCount )
+			++failureCount;
+		COLLADAFW::QuantizedArray octahedral;
+		octahedral.encodeOctahedral( &directions[0], 3 * ( ELEMENT_COUNT / 2 ) );
+		const size_t appendedCount = directions.size() - 3 * ( ELEMENT_COUNT / 2 );
+		if ( !octahedral.appendOctahedral( &directions[3 * ( ELEMENT_COUNT / 2 )], appendedCount ) || octahedral.appendLinear( &small[0], small.size(), 2 ) )
+			++failureCount;
+		if ( octahedral.getValuesCount() != directions.size() || getLargestError( octahedral, directions ) > octahedral.getMaxError() )
+			++failureCount;
+
+		printf( "append: max error %g, %d failed checks\n", linear.getMaxError(), (int)failureCount );
+		return failureCount;
+	}
+
+	//------------------------------
+	/** Checks the encodings of random positions, uv coordinates and normals.
+	@return The number of failed checks.*/
+	size_t checkQuantizedArray()
+	{
+		unsigned int seed = 1;
+		size_t failureCount = 0;
+
+		const Values positions = getRandomValues( 3 * ELEMENT_COUNT, -250.0, 1000.0, seed );
+		failureCount += checkEncoding( "positions", positions, COLLADAFW::QuantizedArray::ENCODING_LINEAR, 3, 1250.0 * MAX_LINEAR_ERROR );
+
+		const Values uvCoordinates = getRandomValues( 2 * ELEMENT_COUNT, -0.5, 1.5, seed );
+		failureCount += checkEncoding( "uv coordinates", uvCoordinates, COLLADAFW::QuantizedArray::ENCODING_LINEAR, 2, 2.0 * MAX_LINEAR_ERROR );
+
+		const Values constantValues( 4 * ELEMENT_COUNT, 0.75 );
+		failureCount += checkEncoding( "constant values", constantValues, COLLADAFW::QuantizedArray::ENCODING_LINEAR, 4, 0.0 );
+
+		const Values normals = getRandomDirections( ELEMENT_COUNT, true, seed );
+		failureCount += checkEncoding( "normals", normals, COLLADAFW::QuantizedArray::ENCODING_OCTAHEDRAL, 3, MAX_OCTAHEDRAL_ERROR );
+
+		// the error includes the change of the length
+		const Values directions = getRandomDirections( ELEMENT_COUNT, false, seed );
+		failureCount += checkEncoding( "directions", directions, COLLADAFW::QuantizedArray::ENCODING_OCTAHEDRAL, 3, 2.0 );
+
+		failureCount += checkNaN();
+		failureCount += checkAppend( seed );
+		return failureCount;
+	}
+
+
+	/** The values written to the document. The second normal and uv source are used by the second
+	triangles primitive.*/
+	struct MeshValues
+	{
+		std::vector<float> positions;
+		std::vector<float> normals[2];
+		std::vector<float> uvCoordinates[2];
+		std::vector<unsigned int> indices;
+	};
+
+
+	/** The values of the loaded mesh.*/
+	struct LoadedValues
+	{
+		COLLADAFW::FloatOrDoubleArray::DataType positionsType;
+		COLLADAFW::FloatOrDoubleArray::DataType normalsType;
+		COLLADAFW::FloatOrDoubleArray::DataType uvCoordinatesType;
+		Values positions;
+		Values normals;
+		Values uvCoordinates;
+	};
+
+
+	/** Makes the methods of the library writers, that are protected in COLLADASW, accessible.*/
+	class GeometriesWriter : public COLLADASW::LibraryGeometries
+	{
+	public:
+		GeometriesWriter( COLLADASW::StreamWriter* streamWriter ) : COLLADASW::LibraryGeometries( streamWriter ) {}
+		using COLLADASW::LibraryGeometries::openMesh;
+		using COLLADASW::LibraryGeometries::closeMesh;
+		using COLLADASW::LibraryGeometries::closeLibrary;
+	};
+
+
+	/** Writer that accepts quantized values and copies the decoded values of the mesh.*/
+	class MeshWriter : public COLLADAFW::IWriter
+	{
+	private:
+		LoadedValues mValues;
+		size_t mMeshCount;
+
+	public:
+		MeshWriter() : mMeshCount( 0 ) {}
+		virtual ~MeshWriter() {}
+
+		const LoadedValues& getValues() const { return mValues; }
+
+		size_t getMeshCount() const { return mMeshCount; }
+
+		virtual bool acceptsQuantizedValues() const { return true; }
+
+		virtual void cancel( const COLLADAFW::String& /*errorMessage*/ ) {}
+		virtual void start() {}
+		virtual void finish() {}
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* /*asset*/ ) { return true; }
+		virtual bool writeScene( const COLLADAFW::Scene* /*scene*/ ) { return true; }
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* /*visualScene*/ ) { return true; }
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* /*libraryNodes*/ ) { return true; }
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry )
+		{
+			if ( geometry->getType() != COLLADAFW::Geometry::GEO_TYPE_MESH )
+				return true;
+			const COLLADAFW::Mesh* mesh = (const COLLADAFW::Mesh*)geometry;
+			++mMeshCount;
+			mValues.positionsType = mesh->getPositions().getType();
+			mValues.normalsType = mesh->getNormals().getType();
+			mValues.uvCoordinatesType = mesh->getUVCoords().getType();
+			mesh->getPositions().copyValues( mValues.positions );
+			mesh->getNormals().copyValues( mValues.normals );
+			mesh->getUVCoords().copyValues( mValues.uvCoordinates );
+			return true;
+		}
+
+		virtual bool writeMaterial( const COLLADAFW::Material* /*material*/ ) { return true; }
+		virtual bool writeEffect( const COLLADAFW::Effect* /*effect*/ ) { return true; }
+		virtual bool writeCamera( const COLLADAFW::Camera* /*camera*/ ) { return true; }
+		virtual bool writeImage( const COLLADAFW::Image* /*image*/ ) { return true; }
+		virtual bool writeLight( const COLLADAFW::Light* /*light*/ ) { return true; }
+		virtual bool writeAnimation( const COLLADAFW::Animation* /*animation*/ ) { return true; }
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* /*animationList*/ ) { return true; }
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* /*skinControllerData*/ ) { return true; }
+		virtual bool writeController( const COLLADAFW::Controller* /*controller*/ ) { return true; }
+		virtual bool writeFormulas( const COLLADAFW::Formulas* /*formulas*/ ) { return true; }
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* /*kinematicsScene*/ ) { return true; }
+
+	private:
+		/** Disable default copy ctor. */
+		MeshWriter( const MeshWriter& pre );
+		/** Disable default assignment operator. */
+		const MeshWriter& operator= ( const MeshWriter& pre );
+	};
+
+
+	/** Counts the errors reported by the loader.*/
+	class CountingErrorHandler : public COLLADASaxFWL::IErrorHandler
+	{
+	public:
+		size_t mErrorCount;
+
+		CountingErrorHandler() : mErrorCount(0) {}
+		virtual ~CountingErrorHandler() {}
+
+		virtual bool handleError( const COLLADASaxFWL::IError* /*error*/ ) { ++mErrorCount; return false; }
+	};
+
+
+	//------------------------------
+	/** Creates a grid of GRID_SIZE x GRID_SIZE vertices with two triangles per cell. The values are
+	written to the document with few digits, so they are loaded without rounding.*/
+	void createMeshValues( MeshValues& values )
+	{
+		// unit directions with short decimal components
+		static const float DIRECTIONS[][3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.6f, 0.8f }, { 0.36f, 0.48f, 0.8f },
+			{ -0.28f, 0.0f, 0.96f }, { 0.0f, -1.0f, 0.0f }, { 0.6f, -0.8f, 0.0f }, { -0.48f, 0.36f, -0.8f } };
+		const size_t directionCount = sizeof(DIRECTIONS) / sizeof(DIRECTIONS[0]);
+
+		const size_t vertexCount = GRID_SIZE * GRID_SIZE;
+		for ( size_t y = 0; y < GRID_SIZE; ++y )
+		{
+			for ( size_t x = 0; x < GRID_SIZE; ++x )
+			{
+				values.positions.push_back( (float)x * 0.5f - 2.0f );
+				values.positions.push_back( (float)( ( x * y ) % 7 ) * 0.125f );
+				values.positions.push_back( (float)y * 0.75f );
+			}
+		}
+		for ( size_t source = 0; source < 2; ++source )
+		{
+			for ( size_t i = 0; i < vertexCount; ++i )
+			{
+				// the second source has the directions in a different order and mirrored
+				const float* direction = DIRECTIONS[( source == 0 ? i : 3 * i + 1 ) % directionCount];
+				const float sign = source == 0 ? 1.0f : -1.0f;
+				for ( size_t j = 0; j < 3; ++j )
+					values.normals[source].push_back( sign * direction[j] );
+				// the uv coordinates of the second source have a different range
+				values.uvCoordinates[source].push_back( (float)( i % GRID_SIZE ) / 16.0f + (float)source * 4.0f );
+				values.uvCoordinates[source].push_back( (float)( i / GRID_SIZE ) / ( source == 0 ? 16.0f : 2.0f ) );
+			}
+		}
+		for ( size_t y = 0; y + 1 < GRID_SIZE; ++y )
+		{
+			for ( size_t x = 0; x + 1 < GRID_SIZE; ++x )
+			{
+				const unsigned int corner = (unsigned int)( y * GRID_SIZE + x );
+				const unsigned int triangles[6] = { corner, corner + (unsigned int)GRID_SIZE, corner + 1,
+					corner + 1, corner + (unsigned int)GRID_SIZE, corner + (unsigned int)GRID_SIZE + 1 };
+				values.indices.insert( values.indices.end(), triangles, triangles + 6 );
+			}
+		}
+	}
+
+	//------------------------------
+	/** Writes a float source with @a id and the values @a values, @a dimension per vertex.*/
+	void writeSource( COLLADASW::StreamWriter& streamWriter, const std::string& id, const std::vector<float>& values, size_t dimension )
+	{
+		static const char* PARAMETER_NAMES[] = { "X", "Y", "Z" };
+		static const char* UV_PARAMETER_NAMES[] = { "S", "T" };
+		COLLADASW::FloatSourceF source( &streamWriter );
+		source.setId( id );
+		source.setArrayId( id + COLLADASW::LibraryGeometries::ARRAY_ID_SUFFIX );
+		source.setAccessorStride( (unsigned long)dimension );
+		source.setAccessorCount( (unsigned long)( values.size() / dimension ) );
+		for ( size_t i = 0; i < dimension; ++i )
+			source.getParameterNameList().push_back( dimension == 2 ? UV_PARAMETER_NAMES[i] : PARAMETER_NAMES[i] );
+		source.prepareToAppendValues();
+		for ( size_t i = 0; i < values.size(); ++i )
+			source.appendValues( values[i] );
+		source.finish();
+	}
+
+	//------------------------------
+	/** Writes the document @a fileName with the mesh @a values. The first half of the triangles is
+	written to a triangles primitive with the first normal and uv source, the second half to one
+	with the second sources.*/
+	bool writeDocument( const std::string& fileName, const MeshValues& values )
+	{
+		try
+		{
+			const COLLADASW::NativeString nativeFileName( fileName );
+			COLLADASW::StreamWriter streamWriter( nativeFileName );
+			streamWriter.startDocument();
+
+			GeometriesWriter geometries( &streamWriter );
+			geometries.openMesh( MESH_ID );
+			const std::string positionsId = MESH_ID + COLLADASW::LibraryGeometries::POSITIONS_SOURCE_ID_SUFFIX;
+			writeSource( streamWriter, positionsId, values.positions, 3 );
+			std::string normalsIds[2];
+			std::string uvCoordinatesIds[2];
+			for ( size_t source = 0; source < 2; ++source )
+			{
+				const std::string suffix = source == 0 ? "" : "-2";
+				normalsIds[source] = MESH_ID + COLLADASW::LibraryGeometries::NORMALS_SOURCE_ID_SUFFIX + suffix;
+				uvCoordinatesIds[source] = MESH_ID + COLLADASW::LibraryGeometries::TEXCOORDS_SOURCE_ID_SUFFIX + suffix;
+				writeSource( streamWriter, normalsIds[source], values.normals[source], 3 );
+				writeSource( streamWriter, uvCoordinatesIds[source], values.uvCoordinates[source], 2 );
+			}
+
+			COLLADASW::VerticesElement vertices( &streamWriter );
+			vertices.setId( MESH_ID + COLLADASW::LibraryGeometries::VERTICES_ID_SUFFIX );
+			vertices.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::POSITION, "#" + positionsId ) );
+			vertices.add();
+
+			const size_t halfIndexCount = values.indices.size() / 6 * 3;
+			for ( size_t source = 0; source < 2; ++source )
+			{
+				const size_t firstIndex = source == 0 ? 0 : halfIndexCount;
+				const size_t endIndex = source == 0 ? halfIndexCount : values.indices.size();
+				COLLADASW::Triangles triangles( &streamWriter );
+				triangles.setCount( (unsigned long)( ( endIndex - firstIndex ) / 3 ) );
+				triangles.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::VERTEX, "#" + std::string( MESH_ID ) + COLLADASW::LibraryGeometries::VERTICES_ID_SUFFIX, 0 ) );
+				triangles.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::NORMAL, "#" + normalsIds[source], 0 ) );
+				triangles.getInputList().push_back( COLLADASW::Input( COLLADASW::InputSemantic::TEXCOORD, "#" + uvCoordinatesIds[source], 0, 0 ) );
+				triangles.prepareToAppendValues();
+				for ( size_t i = firstIndex; i < endIndex; ++i )
+					triangles.appendValues( (unsigned long)values.indices[i] );
+				triangles.finish();
+			}
+
+			geometries.closeMesh();
+			geometries.closeLibrary();
+			streamWriter.endDocument();
+		}
+		catch ( const COLLADASW::StreamWriterException& )
+		{
+			fprintf( stderr, "could not write %s\n", fileName.c_str() );
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	/** Returns the largest difference between @a written and @a loaded, or HUGE_VAL if their
+	sizes differ.*/
+	double getLargestDifference( const std::vector<float>& written, const Values& loaded )
+	{
+		if ( written.size() != loaded.size() )
+			return HUGE_VAL;
+		double largestDifference = 0;
+		for ( size_t i = 0; i < written.size(); ++i )
+		{
+			const double difference = fabs( written[i] - loaded[i] );
+			if ( difference > largestDifference )
+				largestDifference = difference;
+		}
+		return largestDifference;
+	}
+
+	//------------------------------
+	/** Checks, that @a loaded is quantized and does not differ from @a written by more than
+	@a maxError, which must be at most @a maxAcceptableError and the @a encodingError of encoding
+	each source of the written values once.
+	@return The number of failed checks.*/
+	size_t checkLoadedValues( const char* name, const std::vector<float>& written, const Values& loaded, COLLADAFW::FloatOrDoubleArray::DataType dataType, double maxError, double maxAcceptableError, double encodingError )
+	{
+		const double largestDifference = getLargestDifference( written, loaded );
+		printf( "loaded %s: %d values, precision error %g, encoding error %g, largest difference %g\n", name, (int)loaded.size(), maxError, encodingError, largestDifference );
+		size_t failureCount = 0;
+		if ( dataType != COLLADAFW::FloatOrDoubleArray::DATA_TYPE_QUANTIZED )
+			++failureCount;
+		if ( largestDifference > maxError )
+			++failureCount;
+		if ( maxError > maxAcceptableError )
+			++failureCount;
+		// each source is quantized once, the loaded and written values may only differ in rounding
+		if ( maxError > encodingError * 1.001 )
+			++failureCount;
+		return failureCount;
+	}
+
+	//------------------------------
+	/** Returns the largest error of encoding each of the @a sourceCount @a sources once with
+	@a encoding and @a dimension.*/
+	double getEncodingError( const std::vector<float>* sources, size_t sourceCount, COLLADAFW::QuantizedArray::Encoding encoding, size_t dimension )
+	{
+		double maxError = 0;
+		for ( size_t i = 0; i < sourceCount; ++i )
+		{
+			const std::vector<float>& values = sources[i];
+			COLLADAFW::QuantizedArray array;
+			bool success;
+			if ( encoding == COLLADAFW::QuantizedArray::ENCODING_OCTAHEDRAL )
+				success = array.encodeOctahedral( &values[0], values.size() );
+			else
+				success = array.encodeLinear( &values[0], values.size(), dimension );
+			if ( !success )
+				return HUGE_VAL;
+			if ( array.getMaxError() > maxError )
+				maxError = array.getMaxError();
+		}
+		return maxError;
+	}
+
+	//------------------------------
+	/** Writes and loads the mesh with two normal and uv sources.
+	@return The number of failed checks.*/
+	size_t checkLoader( const std::string& fileName )
+	{
+		MeshValues written;
+		createMeshValues( written );
+		if ( !writeDocument( fileName, written ) )
+			return 1;
+
+		MeshWriter writer;
+		CountingErrorHandler errorHandler;
+		COLLADASaxFWL::Loader loader( &errorHandler );
+		loader.setNumericPrecision( COLLADASaxFWL::Loader::PRECISION_QUANTIZED );
+		COLLADAFW::Root root( &loader, &writer );
+		if ( !root.loadDocument( fileName ) || errorHandler.mErrorCount > 0 || writer.getMeshCount() != 1 )
+		{
+			fprintf( stderr, "%s: loading failed with %d errors\n", fileName.c_str(), (int)errorHandler.mErrorCount );
+			return 1;
+		}
+
+		// the loaded arrays contain the values of both sources
+		std::vector<float> normals( written.normals[0] );
+		normals.insert( normals.end(), written.normals[1].begin(), written.normals[1].end() );
+		std::vector<float> uvCoordinates( written.uvCoordinates[0] );
+		uvCoordinates.insert( uvCoordinates.end(), written.uvCoordinates[1].begin(), written.uvCoordinates[1].end() );
+
+		const COLLADASaxFWL::Loader::PrecisionErrors& errors = loader.getPrecisionErrors();
+		const LoadedValues& loaded = writer.getValues();
+		size_t failureCount = 0;
+		failureCount += checkLoadedValues( "positions", written.positions, loaded.positions, loaded.positionsType, errors.positions, 6.0 * MAX_LINEAR_ERROR,
+			getEncodingError( &written.positions, 1, COLLADAFW::QuantizedArray::ENCODING_LINEAR, 3 ) );
+		failureCount += checkLoadedValues( "normals", normals, loaded.normals, loaded.normalsType, errors.normals, 4.0 * MAX_OCTAHEDRAL_ERROR,
+			getEncodingError( written.normals, 2, COLLADAFW::QuantizedArray::ENCODING_OCTAHEDRAL, 3 ) );
+		failureCount += checkLoadedValues( "uv coordinates", uvCoordinates, loaded.uvCoordinates, loaded.uvCoordinatesType, errors.uvCoordinates, 12.0 * MAX_LINEAR_ERROR,
+			getEncodingError( written.uvCoordinates, 2, COLLADAFW::QuantizedArray::ENCODING_LINEAR, 2 ) );
+		return failureCount;
+	}
+}
+
+
+//--------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	if ( argc > 2 )
+	{
+		fprintf( stderr, "usage: %s [directory]\n", argv[0] );
+		return 2;
+	}
+	const std::string directory = argc == 2 ? std::string( argv[1] ) + "/" : std::string( "./" );
+
+	size_t failureCount = checkQuantizedArray();
+	failureCount += checkLoader( directory + "quantizationTest.dae" );
+
+	printf( "%d failed checks\n", (int)failureCount );
+	return failureCount == 0 ? 0 : 1;
+}
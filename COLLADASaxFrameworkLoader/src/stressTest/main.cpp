@@ -0,0 +1,299 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Loads the same set of COLLADA documents with one Loader per thread and checks that every
+    thread receives exactly the same sequence of writer calls as a serial reference run.
+
+    usage: stressTest [-t threadCount] [-i iterations] file1.dae [file2.dae ...]
+*/
+
+#include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLIErrorHandler.h"
+
+#include "COLLADAFW.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	const int DEFAULT_THREAD_COUNT = 32;
+	const int DEFAULT_ITERATIONS = 4;
+
+
+	/** Writer that records a line for each received object. Two loads of the same document must
+	result in the same digest.*/
+	class DigestWriter : public COLLADAFW::IWriter
+	{
+	private:
+		std::ostringstream mDigest;
+
+	public:
+		DigestWriter() {}
+		virtual ~DigestWriter() {}
+
+		std::string getDigest() const { return mDigest.str(); }
+
+		virtual void cancel( const COLLADAFW::String& errorMessage ) { mDigest << "cancel " << errorMessage << "\n"; }
+		virtual void start() { mDigest << "start\n"; }
+		virtual void finish() { mDigest << "finish\n"; }
+
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* asset )
+		{
+			mDigest << "asset " << asset->getUpAxisType() << "\n";
+			return true;
+		}
+
+		virtual bool writeScene( const COLLADAFW::Scene* scene ) { mDigest << "scene\n"; return true; }
+
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* visualScene )
+		{
+			mDigest << "visualScene " << visualScene->getUniqueId().toAscii() << " " << visualScene->getRootNodes().getCount() << "\n";
+			return true;
+		}
+
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes )
+		{
+			mDigest << "libraryNodes " << libraryNodes->getNodes().getCount() << "\n";
+			return true;
+		}
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry )
+		{
+			mDigest << "geometry " << geometry->getUniqueId().toAscii() << " " << geometry->getOriginalId();
+			if ( geometry->getType() == COLLADAFW::Geometry::GEO_TYPE_MESH )
+			{
+				const COLLADAFW::Mesh* mesh = (const COLLADAFW::Mesh*)geometry;
+				mDigest << " " << mesh->getPositions().getValuesCount();
+				const COLLADAFW::MeshPrimitiveArray& primitives = mesh->getMeshPrimitives();
+				for ( size_t i = 0, count = primitives.getCount(); i < count; ++i )
+				{
+					const COLLADAFW::MeshPrimitive* primitive = primitives[i];
+					const COLLADAFW::IndexArray& indices = primitive->getPositionIndexArray();
+					unsigned int sum = 0;
+					for ( size_t j = 0, indexCount = indices.getCount(); j < indexCount; ++j )
+						sum = sum * 31 + indices[j];
+					mDigest << " [" << primitive->getFaceCount() << " " << indices.getCount() << " " << sum << "]";
+				}
+			}
+			mDigest << "\n";
+			return true;
+		}
+
+		virtual bool writeMaterial( const COLLADAFW::Material* material )
+		{
+			mDigest << "material " << material->getUniqueId().toAscii() << " " << material->getInstantiatedEffect().toAscii() << "\n";
+			return true;
+		}
+
+		virtual bool writeEffect( const COLLADAFW::Effect* effect )
+		{
+			mDigest << "effect " << effect->getUniqueId().toAscii() << " " << effect->getCommonEffects().getCount() << "\n";
+			return true;
+		}
+
+		virtual bool writeCamera( const COLLADAFW::Camera* camera )
+		{
+			mDigest << "camera " << camera->getUniqueId().toAscii() << "\n";
+			return true;
+		}
+
+		virtual bool writeImage( const COLLADAFW::Image* image )
+		{
+			mDigest << "image " << image->getUniqueId().toAscii() << " " << image->getImageURI().getURIString() << "\n";
+			return true;
+		}
+
+		virtual bool writeLight( const COLLADAFW::Light* light )
+		{
+			mDigest << "light " << light->getUniqueId().toAscii() << "\n";
+			return true;
+		}
+
+		virtual bool writeAnimation( const COLLADAFW::Animation* animation )
+		{
+			mDigest << "animation " << animation->getUniqueId().toAscii();
+			if ( animation->getAnimationType() == COLLADAFW::Animation::ANIMATION_CURVE )
+				mDigest << " " << ((const COLLADAFW::AnimationCurve*)animation)->getKeyCount();
+			mDigest << "\n";
+			return true;
+		}
+
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* animationList )
+		{
+			mDigest << "animationList " << animationList->getUniqueId().toAscii() << " " << animationList->getAnimationBindings().getCount() << "\n";
+			return true;
+		}
+
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData )
+		{
+			mDigest << "skinControllerData " << skinControllerData->getUniqueId().toAscii() << " " << skinControllerData->getJointsCount() << "\n";
+			return true;
+		}
+
+		virtual bool writeController( const COLLADAFW::Controller* controller )
+		{
+			mDigest << "controller " << controller->getUniqueId().toAscii() << " " << controller->getSource().toAscii() << "\n";
+			return true;
+		}
+
+		virtual bool writeFormulas( const COLLADAFW::Formulas* formulas )
+		{
+			mDigest << "formulas " << formulas->getFormulas().getCount() << "\n";
+			return true;
+		}
+
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene )
+		{
+			mDigest << "kinematicsScene\n";
+			return true;
+		}
+
+	private:
+		/** Disable default copy ctor. */
+		DigestWriter( const DigestWriter& pre );
+		/** Disable default assignment operator. */
+		const DigestWriter& operator= ( const DigestWriter& pre );
+	};
+
+
+	/** Counts the errors reported by the loader, so they become part of the digest.*/
+	class CountingErrorHandler : public COLLADASaxFWL::IErrorHandler
+	{
+	public:
+		size_t mErrorCount;
+
+		CountingErrorHandler() : mErrorCount(0) {}
+		virtual ~CountingErrorHandler() {}
+
+		virtual bool handleError( const COLLADASaxFWL::IError* error ) { ++mErrorCount; return false; }
+	};
+
+
+	/** Loads @a fileName with a new loader and returns the digest of all writer calls.*/
+	std::string loadDocument( const std::string& fileName )
+	{
+		CountingErrorHandler errorHandler;
+		COLLADASaxFWL::Loader loader( &errorHandler );
+		DigestWriter writer;
+		COLLADAFW::Root root( &loader, &writer );
+		bool success = root.loadDocument( fileName );
+
+		std::ostringstream digest;
+		digest << writer.getDigest() << "success " << success << " errors " << errorHandler.mErrorCount << "\n";
+		return digest.str();
+	}
+
+
+	struct ThreadData
+	{
+		const std::vector<std::string>* fileNames;
+		const std::vector<std::string>* expectedDigests;
+		int threadIndex;
+		int iterations;
+		size_t mismatchCount;
+	};
+
+
+	void* loadThread( void* userData )
+	{
+		ThreadData* data = (ThreadData*)userData;
+		size_t fileCount = data->fileNames->size();
+		for ( int iteration = 0; iteration < data->iterations; ++iteration )
+		{
+			for ( size_t i = 0; i < fileCount; ++i )
+			{
+				// every thread starts with a different file, to mix the workload
+				size_t fileIndex = (i + data->threadIndex + iteration) % fileCount;
+				std::string digest = loadDocument( (*data->fileNames)[fileIndex] );
+				if ( digest != (*data->expectedDigests)[fileIndex] )
+				{
+					++data->mismatchCount;
+					fprintf( stderr, "thread %d: digest mismatch for %s\n", data->threadIndex, (*data->fileNames)[fileIndex].c_str() );
+				}
+			}
+		}
+		return 0;
+	}
+}
+
+
+int main( int argc, char** argv )
+{
+	int threadCount = DEFAULT_THREAD_COUNT;
+	int iterations = DEFAULT_ITERATIONS;
+	std::vector<std::string> fileNames;
+
+	for ( int i = 1; i < argc; ++i )
+	{
+		if ( strcmp( argv[i], "-t" ) == 0 && i + 1 < argc )
+			threadCount = atoi( argv[++i] );
+		else if ( strcmp( argv[i], "-i" ) == 0 && i + 1 < argc )
+			iterations = atoi( argv[++i] );
+		else
+			fileNames.push_back( argv[i] );
+	}
+
+	if ( fileNames.empty() || threadCount < 1 || iterations < 1 )
+	{
+		fprintf( stderr, "usage: %s [-t threadCount] [-i iterations] file1.dae [file2.dae ...]\n", argv[0] );
+		return 2;
+	}
+
+	// serial reference run
+	std::vector<std::string> expectedDigests;
+	for ( size_t i = 0; i < fileNames.size(); ++i )
+	{
+		expectedDigests.push_back( loadDocument( fileNames[i] ) );
+		// a second serial load must not differ either, otherwise the loader depends on global state
+		if ( loadDocument( fileNames[i] ) != expectedDigests.back() )
+		{
+			fprintf( stderr, "serial loads of %s differ\n", fileNames[i].c_str() );
+			return 1;
+		}
+	}
+
+	std::vector<ThreadData> threadData( threadCount );
+	std::vector<pthread_t> threads( threadCount );
+	for ( int i = 0; i < threadCount; ++i )
+	{
+		ThreadData& data = threadData[i];
+		data.fileNames = &fileNames;
+		data.expectedDigests = &expectedDigests;
+		data.threadIndex = i;
+		data.iterations = iterations;
+		data.mismatchCount = 0;
+		if ( pthread_create( &threads[i], 0, &loadThread, &data ) != 0 )
+		{
+			fprintf( stderr, "could not create thread %d\n", i );
+			return 1;
+		}
+	}
+
+	size_t mismatchCount = 0;
+	for ( int i = 0; i < threadCount; ++i )
+	{
+		pthread_join( threads[i], 0 );
+		mismatchCount += threadData[i].mismatchCount;
+	}
+
+	printf( "%d threads, %d iterations, %d files: %d mismatches\n",
+		threadCount, iterations, (int)fileNames.size(), (int)mismatchCount );
+
+	return mismatchCount == 0 ? 0 : 1;
+}
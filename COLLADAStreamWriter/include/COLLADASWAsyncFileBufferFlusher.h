@@ -0,0 +1,189 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+	This file is part of COLLADAStreamWriter.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASTREAMWRITER_ASYNCFILEBUFFERFLUSHER_H__
+#define __COLLADASTREAMWRITER_ASYNCFILEBUFFERFLUSHER_H__
+
+#include "COLLADASWPrerequisites.h"
+
+#include "CommonIBufferFlusher.h"
+
+#include "COLLADABUThread.h"
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#ifndef _WIN32
+#	include <sys/types.h> /* off_t */
+#endif
+
+
+namespace COLLADASW
+{
+	/** Flusher that writes to a file on a separate I/O thread. The received data is copied into one of
+	a small number of buffers. Full buffers are written with positional writes (pwrite) by the I/O
+	thread, while the next buffer is filled, so formatting and disk I/O overlap.
+	Jumping to a mark does not seek. The data received afterwards is collected in a new buffer, that
+	is written to the position of the mark. Since the I/O thread writes the buffers in the order they
+	have been filled, overwritten data always ends up in the file.
+	Optionally, full buffers are written with direct I/O (O_DIRECT), bypassing the page cache. Writes
+	that are not aligned to DIRECT_IO_ALIGNMENT, i.e. the last buffer and buffers started at a mark,
+	use normal I/O.*/
+	class AsyncFileBufferFlusher : public Common::IBufferFlusher
+	{
+	public:
+#ifdef _WIN32
+		typedef __int64 FilePosType;
+#else
+		typedef off_t FilePosType;
+#endif
+
+		/** The default size of each buffer.*/
+		static const size_t DEFAULT_BUFFER_SIZE = 1024*1024;
+
+		/** The default number of buffers.*/
+		static const size_t DEFAULT_BUFFER_COUNT = 3;
+
+		/** The alignment of buffers, file positions and sizes required for direct I/O.*/
+		static const size_t DIRECT_IO_ALIGNMENT = 4096;
+
+	private:
+		/** A buffer and the file position it is written to.*/
+		struct WriteBuffer
+		{
+			char* data;
+			size_t size;
+			FilePosType filePosition;
+		};
+
+		typedef std::deque<WriteBuffer*> WriteBufferQueue;
+
+		typedef std::map<MarkId, FilePosType> MarkIdToFilePos;
+
+		class WriterThread;
+		friend class WriterThread;
+
+		/** The I/O thread.*/
+		class WriterThread : public COLLADABU::Thread
+		{
+		private:
+			AsyncFileBufferFlusher& mFlusher;
+		public:
+			WriterThread( AsyncFileBufferFlusher& flusher ) : mFlusher(flusher) {}
+			virtual ~WriterThread() { join(); }
+		protected:
+			virtual void run() { mFlusher.writeBuffers(); }
+		private:
+			/** Disable default copy ctor. */
+			WriterThread( const WriterThread& pre );
+			/** Disable default assignment operator. */
+			const WriterThread& operator= ( const WriterThread& pre );
+		};
+
+	private:
+		/** The size of each buffer.*/
+		size_t mBufferSize;
+
+		/** The file descriptor used for normal I/O.*/
+		int mFile;
+
+		/** The file descriptor used for direct I/O or -1, if direct I/O is not used.*/
+		int mDirectFile;
+
+		/** The error code. 0 on success, an errno value otherwise.*/
+		int mError;
+
+		/** All buffers.*/
+		std::vector<WriteBuffer> mBuffers;
+
+		/** The buffer that receives data or 0, if a free buffer is taken on the next receiveData().*/
+		WriteBuffer* mCurrentBuffer;
+
+		/** Buffers that can be filled.*/
+		WriteBufferQueue mFreeBuffers;
+
+		/** Buffers that wait for the I/O thread, in the order they have been filled.*/
+		WriteBufferQueue mBuffersToWrite;
+
+		/** The file position the next received byte is written to.*/
+		FilePosType mWritePosition;
+
+		/** The size of the file, once all buffers have been written.*/
+		FilePosType mEndPosition;
+
+		MarkId mLastMarkId;
+
+		MarkIdToFilePos mMarkIds;
+
+		/** Set to stop the I/O thread.*/
+		bool mIsShuttingDown;
+
+		/** Protects the buffer queues, mError and mIsShuttingDown.*/
+		mutable COLLADABU::Mutex mMutex;
+
+		/** Signaled whenever a buffer has been submitted or written.*/
+		COLLADABU::Condition mStateChanged;
+
+		/** The I/O thread.*/
+		WriterThread mWriterThread;
+
+	public:
+		/** Constructor.
+		@param fileName The file to write.
+		@param bufferSize The size of each buffer. Rounded up to DIRECT_IO_ALIGNMENT, if direct I/O
+		is used.
+		@param bufferCount The number of buffers, at least 2.
+		@param useDirectIO If true, full buffers are written bypassing the page cache. Ignored on
+		platforms without O_DIRECT.*/
+		AsyncFileBufferFlusher( const char* fileName,
+								size_t bufferSize = DEFAULT_BUFFER_SIZE,
+								size_t bufferCount = DEFAULT_BUFFER_COUNT,
+								bool useDirectIO = false );
+
+		/** Destructor. Writes all buffers and closes the file.*/
+		virtual ~AsyncFileBufferFlusher();
+
+		/** The error code. 0 on success, an errno value otherwise.*/
+		int getError() const;
+
+		/** Receives and handles @a length bytes starting at @a buffer.
+		@return True on success, false otherwise.*/
+		virtual bool receiveData( const char* buffer, size_t length);
+
+		/** Blocks until all data previously received by receiveData has been written to the file.*/
+		virtual bool flush();
+
+		void startMark();
+
+		IBufferFlusher::MarkId endMark();
+
+		bool jumpToMark(IBufferFlusher::MarkId markId, bool keepMarkId = false);
+
+	private:
+        /** Disable default copy ctor. */
+		AsyncFileBufferFlusher( const AsyncFileBufferFlusher& pre );
+        /** Disable default assignment operator. */
+		const AsyncFileBufferFlusher& operator= ( const AsyncFileBufferFlusher& pre );
+
+		/** Passes the current buffer to the I/O thread.*/
+		void submitCurrentBuffer();
+
+		/** Executed by the I/O thread.*/
+		void writeBuffers();
+
+		/** Writes @a buffer to the file.
+		@return 0 on success, an errno value otherwise.*/
+		int writeBuffer( const WriteBuffer& buffer );
+
+	};
+} //namespace COLLADASW
+
+#endif // __COLLADASTREAMWRITER_ASYNCFILEBUFFERFLUSHER_H__
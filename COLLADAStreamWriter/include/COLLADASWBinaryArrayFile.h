@@ -0,0 +1,119 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+	This file is part of COLLADAStreamWriter.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASTREAMWRITER_BINARYARRAYFILE_H__
+#define __COLLADASTREAMWRITER_BINARYARRAYFILE_H__
+
+#include "COLLADASWPrerequisites.h"
+
+namespace Common
+{
+	class Buffer;
+	class IBufferFlusher;
+}
+
+namespace COLLADASW
+{
+	class StreamWriter;
+
+	/** A sidecar file the values of large float arrays and \<p\> elements are written to, instead of
+	being written as text into the document. Pass it to StreamWriter::setBinaryArrayFile() to enable
+	binary arrays. Each array is stored little endian, aligned to 8 bytes. The element that would have
+	contained the values references them by a \<binary_array\> element with the attributes file, offset
+	(in bytes), count (number of values) and type (float32, float64 or uint32), placed in a technique
+	with profile CSWC::CSW_PROFILE_OPENCOLLADA. Float arrays keep their count attribute but are written
+	empty. Primitives are written without \<p\> element and reference the indices from their \<extra\>.*/
+	class BinaryArrayFile
+	{
+	public:
+		/** The value types of the binary arrays.*/
+		enum ValueType
+		{
+			VALUE_TYPE_FLOAT32,
+			VALUE_TYPE_FLOAT64,
+			VALUE_TYPE_UINT32
+		};
+
+		/** The default of the minimum number of values or primitives an array needs to be written binary.*/
+		static const size_t DEFAULT_MINIMUM_COUNT;
+
+	private:
+		/** The file the values are written to.*/
+		Common::IBufferFlusher* mFlusher;
+
+		/** Collects the values of the array currently being written.*/
+		Common::Buffer* mBuffer;
+
+		/** The value of the file attribute of the \<binary_array\> elements.*/
+		String mReference;
+
+		/** Float arrays with fewer values and primitives with fewer primitives are written as text.*/
+		size_t mMinimumCount;
+
+		/** The number of bytes written to the file.*/
+		unsigned long long mOffset;
+
+		/** The type of the values of the array currently being written.*/
+		ValueType mValueType;
+
+		/** The offset of the array currently being written.*/
+		unsigned long long mArrayOffset;
+
+		/** The number of values in the array currently being written.*/
+		size_t mArrayCount;
+
+	public:
+		/** Creates the file @a fileName. Throws a StreamWriterException if the file can not be created.
+		@param fileName The name of the sidecar file.
+		@param reference The uri of the sidecar file, relative to the document, written into the file
+		attribute of the \<binary_array\> elements.
+		@param minimumCount Float arrays with fewer values and primitives with fewer primitives are
+		written as text.*/
+		BinaryArrayFile( const NativeString& fileName, const String& reference, size_t minimumCount = DEFAULT_MINIMUM_COUNT );
+
+		/** Writes all data to the file and closes it.*/
+		virtual ~BinaryArrayFile();
+
+		/** The value of the file attribute of the \<binary_array\> elements.*/
+		const String& getReference() const { return mReference; }
+
+		/** True, if an array with @a count values or primitives should be written binary.*/
+		bool isBinaryArray( size_t count ) const { return count >= mMinimumCount && count > 0; }
+
+		/** Starts a new array, whose values are stored as @a valueType.*/
+		void beginArray( ValueType valueType );
+
+		/** Adds @a value to the current array, converted to the type passed to beginArray().*/
+		void appendValue( double value );
+
+		/** Adds @a value to the current array, converted to the type passed to beginArray().*/
+		void appendValue( float value );
+
+		/** Adds @a value to the current array, converted to the type passed to beginArray().*/
+		void appendValue( unsigned long value );
+
+		/** Finishes the current array and writes the technique referencing it to @a streamWriter.*/
+		void endArray( StreamWriter* streamWriter );
+
+	private:
+
+        /** Disable default copy ctor. */
+		BinaryArrayFile( const BinaryArrayFile& pre );
+
+        /** Disable default assignment operator. */
+		const BinaryArrayFile& operator= ( const BinaryArrayFile& pre );
+
+		/** Writes @a size bytes starting at @a value to the file in little endian byte order.*/
+		void appendBytes( const void* value, size_t size );
+	};
+
+} //namespace COLLADASW
+
+#endif //__COLLADASTREAMWRITER_BINARYARRAYFILE_H__
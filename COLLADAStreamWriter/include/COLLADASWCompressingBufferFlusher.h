@@ -0,0 +1,291 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+	This file is part of COLLADAStreamWriter.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASTREAMWRITER_COMPRESSINGBUFFERFLUSHER_H__
+#define __COLLADASTREAMWRITER_COMPRESSINGBUFFERFLUSHER_H__
+
+#include "COLLADASWPrerequisites.h"
+
+#include "CommonIBufferFlusher.h"
+
+#include "COLLADABUThread.h"
+
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace COLLADASW
+{
+	/** Flusher that writes the received data gzip compressed (.dae.gz) or as the root document of a
+	zae archive (.zae).
+	The data is cut into blocks that are deflated independently by a pool of worker threads, each
+	block primed with the last 32 KB of its predecessor as dictionary. The raw deflate streams of the
+	blocks are concatenated in order by a writer thread, so neither compression nor disk I/O is done
+	on the thread that calls receiveData().
+	Marks are supported by keeping the uncompressed data from the oldest mark that has not been
+	jumped to without keepMarkId on in memory. Data is passed to the compression threads only once no
+	mark refers to it any more, so long lived marks increase the memory consumption.*/
+	class CompressingBufferFlusher : public Common::IBufferFlusher
+	{
+	public:
+		/** The formats that can be written.*/
+		enum Format
+		{
+			FORMAT_GZIP,	///< gzip compressed file
+			FORMAT_ZAE		///< zae archive, containing a manifest and the document
+		};
+
+		/** The default size of the blocks, that are compressed independently.*/
+		static const size_t DEFAULT_BLOCK_SIZE = 128*1024;
+
+		/** The default number of compression threads.*/
+		static const size_t DEFAULT_THREAD_COUNT = 4;
+
+		/** The default name of the document within a zae archive.*/
+		static const char DEFAULT_ZAE_DOCUMENT_NAME[];
+
+	private:
+		/** A block of uncompressed data and its compressed representation.*/
+		struct Block
+		{
+			/** The uncompressed data.*/
+			std::vector<char> input;
+
+			/** The uncompressed data that precedes the block, used as dictionary.*/
+			std::vector<char> dictionary;
+
+			/** The raw deflate data.*/
+			std::vector<char> output;
+
+			/** The crc32 of input.*/
+			unsigned long crc;
+
+			/** True, if this is the last block of the stream.*/
+			bool isLast;
+
+			/** True, once the block has been compressed.*/
+			bool isCompressed;
+
+			/** True, if compressing the block failed.*/
+			bool hasFailed;
+		};
+
+		typedef std::deque<Block*> BlockQueue;
+
+		typedef void (CompressingBufferFlusher::*Task)();
+
+		/** Thread that executes a member function of the flusher.*/
+		class TaskThread : public COLLADABU::Thread
+		{
+		private:
+			CompressingBufferFlusher& mFlusher;
+			Task mTask;
+		public:
+			TaskThread( CompressingBufferFlusher& flusher, Task task ) : mFlusher(flusher), mTask(task) {}
+			virtual ~TaskThread() { join(); }
+		protected:
+			virtual void run() { (mFlusher.*mTask)(); }
+		private:
+			/** Disable default copy ctor. */
+			TaskThread( const TaskThread& pre );
+			/** Disable default assignment operator. */
+			const TaskThread& operator= ( const TaskThread& pre );
+		};
+
+		typedef std::map<MarkId, size_t> MarkIdToPosition;
+
+	private:
+		/** The output format.*/
+		Format mFormat;
+
+		/** The zlib compression level.*/
+		int mCompressionLevel;
+
+		/** The size of the blocks.*/
+		size_t mBlockSize;
+
+		/** Maximum number of blocks that are compressed or waiting to be written.*/
+		size_t mMaxBlocksInFlight;
+
+		/** The name of the document within the zae archive.*/
+		std::string mZaeDocumentName;
+
+		/** The stream to write the data to.*/
+		FILE* mStream;
+
+		/** The error code. 0 on success, an errno value otherwise.*/
+		int mError;
+
+		/** Set together with mError, so receiveData() can test for an error without locking mMutex.*/
+		COLLADABU::AtomicFlag mHasFailed;
+
+		/** True, once finish() has been called.*/
+		bool mIsFinished;
+
+		/** Uncompressed data not yet passed to the compression threads. mHeldData[mHeldDataStart]
+		is the byte at stream position mSubmittedSize.*/
+		std::vector<char> mHeldData;
+
+		/** Index of the first valid byte in mHeldData.*/
+		size_t mHeldDataStart;
+
+		/** Number of uncompressed bytes passed to the compression threads.*/
+		size_t mSubmittedSize;
+
+		/** The stream position, receiveData() writes to.*/
+		size_t mWritePosition;
+
+		/** The total number of uncompressed bytes received.*/
+		size_t mEndPosition;
+
+		/** The last 32 KB of the data passed to the compression threads.*/
+		std::vector<char> mDictionary;
+
+		MarkId mLastMarkId;
+
+		/** The stream positions of all marks that can still be jumped to.*/
+		MarkIdToPosition mMarkIds;
+
+		/** Blocks waiting to be compressed, in stream order.*/
+		BlockQueue mBlocksToCompress;
+
+		/** Blocks passed to the compression threads, in stream order, until they have been written.*/
+		BlockQueue mBlocksInFlight;
+
+		/** Blocks that can be reused.*/
+		BlockQueue mFreeBlocks;
+
+		/** Set to stop the threads.*/
+		bool mIsShuttingDown;
+
+		/** The crc32 of the uncompressed data written so far.*/
+		unsigned long mCrc;
+
+		/** The number of uncompressed bytes written so far.*/
+		size_t mUncompressedSize;
+
+		/** The number of compressed bytes of the document written so far.*/
+		size_t mCompressedSize;
+
+		/** The number of bytes written to the file.*/
+		size_t mFileSize;
+
+		/** The file offset of the local header of the document, if mFormat is FORMAT_ZAE.*/
+		size_t mDocumentHeaderOffset;
+
+		/** The size of manifest.xml, if mFormat is FORMAT_ZAE.*/
+		size_t mManifestSize;
+
+		/** The crc32 of manifest.xml, if mFormat is FORMAT_ZAE.*/
+		unsigned long mManifestCrc;
+
+		/** Protects all members shared with the compression and writer threads.*/
+		mutable COLLADABU::Mutex mMutex;
+
+		/** Signaled whenever a block has been submitted, compressed or written.*/
+		COLLADABU::Condition mStateChanged;
+
+		/** The compression threads.*/
+		std::vector<TaskThread*> mCompressionThreads;
+
+		/** The thread that writes the compressed blocks in order.*/
+		TaskThread* mWriterThread;
+
+	public:
+		/** Constructor.
+		@param fileName The file to write.
+		@param format The output format.
+		@param compressionLevel The zlib compression level, 1 (fastest) to 9 (best).
+		@param threadCount The number of compression threads.
+		@param blockSize The size of the blocks, that are compressed independently.
+		@param zaeDocumentName The name of the document within the zae archive. Must be a valid
+		relative uri. Ignored for FORMAT_GZIP.*/
+		CompressingBufferFlusher( const char* fileName,
+								  Format format = FORMAT_GZIP,
+								  int compressionLevel = 6,
+								  size_t threadCount = DEFAULT_THREAD_COUNT,
+								  size_t blockSize = DEFAULT_BLOCK_SIZE,
+								  const char* zaeDocumentName = DEFAULT_ZAE_DOCUMENT_NAME );
+
+		/** Destructor. Calls finish().*/
+		virtual ~CompressingBufferFlusher();
+
+		/** The error code. 0 on success, an errno value otherwise. The writer thread might set it
+		at any time.*/
+		int getError() const;
+
+		/** Receives and handles @a length bytes starting at @a buffer.
+		@return True on success, false otherwise.*/
+		virtual bool receiveData( const char* buffer, size_t length);
+
+		/** Compresses and writes all data received by receiveData, that is not referenced by a mark.*/
+		virtual bool flush();
+
+		/** Compresses and writes all remaining data and the trailer of the file. The flusher does
+		not accept data afterwards. Called by the destructor.*/
+		bool finish();
+
+		void startMark();
+
+		IBufferFlusher::MarkId endMark();
+
+		bool jumpToMark(IBufferFlusher::MarkId markId, bool keepMarkId = false);
+
+	private:
+        /** Disable default copy ctor. */
+		CompressingBufferFlusher( const CompressingBufferFlusher& pre );
+        /** Disable default assignment operator. */
+		const CompressingBufferFlusher& operator= ( const CompressingBufferFlusher& pre );
+
+		/** Writes the gzip header or the zae manifest and the local header of the document.*/
+		bool writeHeader();
+
+		/** Writes the gzip trailer or the zae central directory.*/
+		bool writeTrailer();
+
+		/** The stream position up to which data can be passed to the compression threads.*/
+		size_t getSubmitLimit() const;
+
+		/** Passes the held data up to getSubmitLimit() to the compression threads. A remaining
+		partial block is only submitted if @a submitPartialBlock is true.*/
+		bool submitHeldData( bool submitPartialBlock );
+
+		/** Passes @a length bytes of held data as one block to the compression threads.*/
+		bool submitBlock( size_t length, bool isLast );
+
+		/** Blocks until all submitted blocks have been written.*/
+		bool waitForBlocksWritten();
+
+		/** Executed by the compression threads.*/
+		void compressBlocks();
+
+		/** Compresses @a block into block->output.*/
+		void compressBlock( Block* block );
+
+		/** Executed by the writer thread.*/
+		void writeBlocks();
+
+		/** Writes @a length bytes to the file.*/
+		bool writeToFile( const void* data, size_t length );
+
+		/** Sets mError to @a error and sets mHasFailed. mMutex must be locked while the threads are
+		running.*/
+		void setError( int error );
+
+		/** Stops and deletes all threads.*/
+		void stopThreads();
+
+	};
+} //namespace COLLADASW
+
+#endif // __COLLADASTREAMWRITER_COMPRESSINGBUFFERFLUSHER_H__
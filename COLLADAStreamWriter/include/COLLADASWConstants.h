@@ -36,6 +36,8 @@ namespace COLLADASW
 
 		static const String CSW_PLATFORM_PC_OGL;
 
+		static const String CSW_PROFILE_OPENCOLLADA;
+
         static const String CSW_ELEMENT_ACCESSOR;
         static const String CSW_ELEMENT_AMBIENT;
         static const String CSW_ELEMENT_ANIMATION;
@@ -46,6 +48,7 @@ namespace COLLADASW
         static const String CSW_ELEMENT_AUTHOR;
         static const String CSW_ELEMENT_AUTHORING_TOOL;
         static const String CSW_ELEMENT_BLINN;
+        static const String CSW_ELEMENT_BINARY_ARRAY;
         static const String CSW_ELEMENT_BIND;
         static const String CSW_ELEMENT_BIND_MATERIAL;
 		static const String CSW_ELEMENT_BIND_SHAPE_MATRIX;
@@ -248,6 +251,7 @@ namespace COLLADASW
 		static const String CSW_ATTRIBUTE_COUNT;
         static const String CSW_ATTRIBUTE_END;
         static const String CSW_ATTRIBUTE_FACE;
+        static const String CSW_ATTRIBUTE_FILE;
         static const String CSW_ATTRIBUTE_ID;
 		static const String CSW_ATTRIBUTE_INDEX;
 		static const String CSW_ATTRIBUTE_INPUT_SEMANTIC;
@@ -342,6 +346,10 @@ namespace COLLADASW
         static const String CSW_VALUE_TYPE_NAME;
         static const String CSW_VALUE_TYPE_IDREF;
 
+        static const String CSW_BINARY_ARRAY_TYPE_FLOAT32;
+        static const String CSW_BINARY_ARRAY_TYPE_FLOAT64;
+        static const String CSW_BINARY_ARRAY_TYPE_UINT32;
+
         static const String CSW_SAMPLER_FILTER_LINEAR;
         static const String CSW_SAMPLER_FILTER_LINEAR_MIPMAP_LINEAR;
         static const String CSW_SAMPLER_FILTER_LINEAR_MIPMAP_NEAREST;
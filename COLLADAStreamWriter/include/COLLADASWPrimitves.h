@@ -21,6 +21,7 @@
 
 namespace COLLADASW
 {
+    class BinaryArrayFile;
 
     class PrimitivesBase : public ElementWriter
     {
@@ -50,6 +51,9 @@ namespace COLLADASW
         /** List of the number in the @a \<vcount\> element*/
         VCountList mVCountList;
 
+        /** The file the indices are written to or 0, if they are written into the \<p\> element.*/
+        BinaryArrayFile* mBinaryArrayFile;
+
     public:
 
         /**
@@ -60,6 +64,7 @@ namespace COLLADASW
         : ElementWriter ( streamWriter )
         , mInputList ( streamWriter )
         , mPrimitiveName ( primitiveName )
+        , mBinaryArrayFile ( 0 )
         {
             if ( strcmp(primitiveName.c_str(), mPrimitiveName.c_str() ) != 0)
             {
@@ -157,49 +162,96 @@ namespace COLLADASW
         /** Adds @a number to the array*/
         void appendValues ( const std::vector<unsigned long>& numberVec )
         {
-            mSW->appendValues ( numberVec );
+            if ( mBinaryArrayFile )
+            {
+                for ( size_t i = 0; i < numberVec.size(); ++i )
+                    appendBinaryValue ( numberVec[i] );
+            }
+            else
+            {
+                mSW->appendValues ( numberVec );
+            }
         }
 
         /** Adds @a number to the array*/
         void appendValues ( const int number )
         {
-            mSW->appendValues ( number );
+            if ( mBinaryArrayFile )
+                appendBinaryValue ( (unsigned long)number );
+            else
+                mSW->appendValues ( number );
         }
 
         /** Adds @a number to the array*/
         void appendValues ( const unsigned int number )
         {
-            mSW->appendValues ( number );
+            if ( mBinaryArrayFile )
+                appendBinaryValue ( (unsigned long)number );
+            else
+                mSW->appendValues ( number );
         }
 
         /** Adds @a number to the array*/
         void appendValues ( const long number )
         {
-            mSW->appendValues ( number );
+            if ( mBinaryArrayFile )
+                appendBinaryValue ( (unsigned long)number );
+            else
+                mSW->appendValues ( number );
         }
 
         /** Adds @a number to the array*/
         void appendValues ( const unsigned long number )
         {
-            mSW->appendValues ( number );
+            if ( mBinaryArrayFile )
+                appendBinaryValue ( (unsigned long)number );
+            else
+                mSW->appendValues ( number );
         }
 
         /** Adds @a number1  and @a number2 to the array*/
         void appendValues ( const unsigned long number1, const unsigned long number2 )
         {
-            mSW->appendValues ( number1, number2 );
+            if ( mBinaryArrayFile )
+            {
+                appendBinaryValue ( number1 );
+                appendBinaryValue ( number2 );
+            }
+            else
+            {
+                mSW->appendValues ( number1, number2 );
+            }
         }
 
         /** Adds @a number1, @a number2 and @a number3 to the array*/
         void appendValues ( const unsigned long number1, const unsigned long number2, const unsigned long number3 )
         {
-            mSW->appendValues ( number1, number2, number3 );
+            if ( mBinaryArrayFile )
+            {
+                appendBinaryValue ( number1 );
+                appendBinaryValue ( number2 );
+                appendBinaryValue ( number3 );
+            }
+            else
+            {
+                mSW->appendValues ( number1, number2, number3 );
+            }
         }
 
         /** Adds @a number1, @a number2, @a number3 and @a number4 to the array*/
         void appendValues ( const unsigned long number1, const unsigned long number2, const unsigned long number3, const unsigned long number4 )
         {
-            mSW->appendValues ( number1, number2, number3, number4 );
+            if ( mBinaryArrayFile )
+            {
+                appendBinaryValue ( number1 );
+                appendBinaryValue ( number2 );
+                appendBinaryValue ( number3 );
+                appendBinaryValue ( number4 );
+            }
+            else
+            {
+                mSW->appendValues ( number1, number2, number3, number4 );
+            }
         };
 
         /** 
@@ -219,6 +271,17 @@ namespace COLLADASW
          */
         void prepareBaseToAppendValues ( bool openPolyListElement=true, bool openVertexListElement=false );
 
+        /** Starts writing the indices to the binary array file of the stream writer, if there is one 
+        and the primitive count is large enough. Must be called before prepareBaseToAppendValues().
+        @return True, if the indices are written to the binary array file. The \<p\> element must not
+        be opened in that case.*/
+        bool prepareBinaryArray();
+
+    private:
+
+        /** Adds @a number to the binary array file.*/
+        void appendBinaryValue ( const unsigned long number );
+
     };
 
 
@@ -245,7 +308,7 @@ namespace COLLADASW
         This member must be called exactly once before add is called the first time.*/
         void prepareToAppendValues()
         {
-            prepareBaseToAppendValues ( );
+            prepareBaseToAppendValues ( !prepareBinaryArray() );
         }
 
     };
@@ -20,6 +20,7 @@
 
 namespace COLLADASW
 {
+    class BinaryArrayFile;
 
     /** A class to add a source, including the array and an accessor.
     It is the base class for the Source template class.*/
@@ -54,12 +55,18 @@ namespace COLLADASW
         /** The list with the parameters. */
         ParameterNameList mParameterNameList;
 
+    protected:
+
+        /** The file the values of the array are written to or 0, if they are written as text.*/
+        BinaryArrayFile* mBinaryArrayFile;
+
     public:
 
     	SourceBase ( StreamWriter* streamWriter ) 
             : ElementWriter ( streamWriter )
             , mAccessorCount (0)
             , mAccessorStride (0)
+            , mBinaryArrayFile (0)
         {}
 
         /** Returns a reference to the id of the source*/
@@ -148,6 +155,25 @@ namespace COLLADASW
         /** Adds the base technique common to the source. */
         void addBaseTechnique ( const String* parameterTypeName );
 
+        /** Adds @a value to the binary array file.*/
+        void appendBinaryValue ( const double value );
+
+        /** Adds @a value to the binary array file.*/
+        void appendBinaryValue ( const float value );
+
+        /** Strings are never written to the binary array file, since only float arrays are binary.
+        Writes @a value as text into the array instead.*/
+        void appendBinaryValue ( const String& value );
+
+        /** Adds the 16 values of @a matrix to the binary array file.*/
+        template < class MatrixType >
+        void appendBinaryMatrix ( const MatrixType matrix[][4] )
+        {
+            for ( int i = 0; i < 4; ++i )
+                for ( int j = 0; j < 4; ++j )
+                    appendBinaryValue ( matrix[i][j] );
+        }
+
     };
 
     /** A class template to add a source, including an the array and an accessor*/
@@ -175,43 +201,87 @@ namespace COLLADASW
         /** Adds @a value to the array*/
         void appendValues ( const double matrix[][4] )
         {
-            mSW->appendValues ( matrix );
+            if ( mBinaryArrayFile )
+                appendBinaryMatrix ( matrix );
+            else
+                mSW->appendValues ( matrix );
         }
 
         /** Adds @a value to the array*/
         void appendValues ( const float matrix[][4] )
         {
-            mSW->appendValues ( matrix );
+            if ( mBinaryArrayFile )
+                appendBinaryMatrix ( matrix );
+            else
+                mSW->appendValues ( matrix );
         }
 
         /** Adds @a value to the array*/
         void appendValues ( const std::vector<Type>& value )
         {
-            mSW->appendValues ( value );
+            if ( mBinaryArrayFile )
+            {
+                for ( size_t i = 0; i < value.size(); ++i )
+                    appendBinaryValue ( value[i] );
+            }
+            else
+            {
+                mSW->appendValues ( value );
+            }
         }
 
         /** Adds @a value to the array*/
         void appendValues ( const Type value )
         {
-            mSW->appendValues ( value );
+            if ( mBinaryArrayFile )
+                appendBinaryValue ( value );
+            else
+                mSW->appendValues ( value );
         }
 
         /** Adds @a value1  and @a value2 to the array*/
         void appendValues ( const Type value1, const Type value2 )
         {
-            mSW->appendValues ( value1, value2 );
+            if ( mBinaryArrayFile )
+            {
+                appendBinaryValue ( value1 );
+                appendBinaryValue ( value2 );
+            }
+            else
+            {
+                mSW->appendValues ( value1, value2 );
+            }
         }
 
         /** Adds @a value1, @a value2 and @a value3 to the array*/
         void appendValues ( const Type value1, const Type value2, const Type value3 )
         {
-            mSW->appendValues ( value1, value2, value3 );
+            if ( mBinaryArrayFile )
+            {
+                appendBinaryValue ( value1 );
+                appendBinaryValue ( value2 );
+                appendBinaryValue ( value3 );
+            }
+            else
+            {
+                mSW->appendValues ( value1, value2, value3 );
+            }
         }
 
         /** Adds @a value1, @a value2, @a value3 and @a value4 to the array*/
         void appendValues ( const Type value1, const Type value2, const Type value3, const Type value4 )
         {
-            mSW->appendValues ( value1, value2, value3, value4 );
+            if ( mBinaryArrayFile )
+            {
+                appendBinaryValue ( value1 );
+                appendBinaryValue ( value2 );
+                appendBinaryValue ( value3 );
+                appendBinaryValue ( value4 );
+            }
+            else
+            {
+                mSW->appendValues ( value1, value2, value3, value4 );
+            }
         }
 
         /**
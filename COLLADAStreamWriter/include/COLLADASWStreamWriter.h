@@ -33,7 +33,7 @@ namespace COLLADABU
 
 namespace Common
 {
-	class FWriteBufferFlusher;
+	class IBufferFlusher;
 	class CharacterBuffer;
 }
 
@@ -41,6 +41,7 @@ namespace COLLADASW
 {
 
     class StreamWriter;
+	class BinaryArrayFile;
 
 	typedef unsigned long ElementIndexType;
 
@@ -78,6 +79,14 @@ namespace COLLADASW
 			COLLADA_1_4_1,
 			COLLADA_1_5_0
 		};
+
+		/** How a document written to a file is compressed.*/
+		enum Compression
+		{
+			COMPRESSION_NONE,	///< The document is written as text
+			COMPRESSION_GZIP,	///< The document is written gzip compressed, e.g. to a .dae.gz file
+			COMPRESSION_ZAE		///< A zae archive is written, that contains the document as scene.dae
+		};
     private:
 
         /** Contains information about an open tag*/
@@ -99,7 +108,10 @@ namespace COLLADASW
 		typedef std::deque<OpenTag> OpenTagStack;
 
     private:
-		Common::FWriteBufferFlusher* mBufferFlusher;
+		Common::IBufferFlusher* mBufferFlusher;
+
+		/** True, if mBufferFlusher has been created by the stream writer and is deleted by it.*/
+		bool mOwnsBufferFlusher;
 
 		Common::CharacterBuffer* mCharacterBuffer;
 
@@ -126,9 +138,20 @@ namespace COLLADASW
 		/** The version of the COLLADA file.*/
 		COLLADAVersion mCOLLADAVersion;
 
+		/** The file large arrays are written to or 0, if all arrays are written as text.*/
+		BinaryArrayFile* mBinaryArrayFile;
+
     public:
-        /** Creates a stream writer that writes to file @a fileName*/
-        StreamWriter ( const NativeString& fileName, bool doublePrecision = false, COLLADAVersion cOLLADAVersion = COLLADA_1_4_1);
+        /** Creates a stream writer that writes to file @a fileName, compressed as requested by
+		@a compression. The name of the file is not used to choose the compression.*/
+        StreamWriter ( const NativeString& fileName, bool doublePrecision = false, COLLADAVersion cOLLADAVersion = COLLADA_1_4_1, Compression compression = COMPRESSION_NONE );
+
+        /** Creates a stream writer that passes the document to @a bufferFlusher, e.g. a 
+		Common::MemoryBufferFlusher to keep the document in memory or a Common::CallbackBufferFlusher to 
+		pass it to a user supplied function. The flusher is not deleted by the stream writer and must 
+		outlive it. All data has been passed to the flusher, once the stream writer has been destroyed.
+		Throws a StreamWriterException, if the flusher already reports an error.*/
+        StreamWriter ( Common::IBufferFlusher* bufferFlusher, bool doublePrecision = false, COLLADAVersion cOLLADAVersion = COLLADA_1_4_1);
 
         /** Closes all open tags and closes the stream*/
         ~StreamWriter();
@@ -317,6 +340,18 @@ namespace COLLADASW
 		/** Returns the version of the COLLADA file that ias written by the StreamWriter.*/
 		COLLADAVersion getCOLLADAVersion() const { return mCOLLADAVersion; } 
 
+		/** True, if double values are written with full precision.*/
+		bool getDoublePrecision() const { return mDoublePrecision; }
+
+		/** Sets the file the values of large float arrays and primitives are written to, instead of
+		writing them as text. Pass 0 to write all arrays as text again, which is the default. The file
+		is not deleted by the stream writer and must outlive all sources and primitives written with it.
+		@see BinaryArrayFile*/
+		void setBinaryArrayFile( BinaryArrayFile* binaryArrayFile ) { mBinaryArrayFile = binaryArrayFile; }
+
+		/** The file large arrays are written to or 0, if all arrays are written as text.*/
+		BinaryArrayFile* getBinaryArrayFile() const { return mBinaryArrayFile; }
+
     private:
 
 		/** Closes all elements opened since the element with index @a elementIndex has been open, 
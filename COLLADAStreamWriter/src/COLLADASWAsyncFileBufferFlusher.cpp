@@ -0,0 +1,366 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+	This file is part of COLLADAStreamWriter.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASWAsyncFileBufferFlusher.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#	include <io.h>
+#	include <malloc.h>
+#	include <sys/stat.h>
+#else
+#	include <unistd.h>
+#endif
+
+namespace COLLADASW
+{
+	//--------------------------------------------------------------------
+	static char* allocateAligned( size_t size )
+	{
+#ifdef _WIN32
+		return (char*)_aligned_malloc( size, AsyncFileBufferFlusher::DIRECT_IO_ALIGNMENT );
+#else
+		void* memory = 0;
+		if ( posix_memalign( &memory, AsyncFileBufferFlusher::DIRECT_IO_ALIGNMENT, size ) != 0 )
+		{
+			return 0;
+		}
+		return (char*)memory;
+#endif
+	}
+
+	//--------------------------------------------------------------------
+	static void freeAligned( char* memory )
+	{
+#ifdef _WIN32
+		_aligned_free( memory );
+#else
+		free( memory );
+#endif
+	}
+
+	//--------------------------------------------------------------------
+	AsyncFileBufferFlusher::AsyncFileBufferFlusher( const char* fileName,
+													size_t bufferSize,
+													size_t bufferCount,
+													bool useDirectIO )
+		: mBufferSize( bufferSize > 0 ? bufferSize : DEFAULT_BUFFER_SIZE )
+		, mFile(-1)
+		, mDirectFile(-1)
+		, mError(0)
+		, mBuffers( bufferCount > 2 ? bufferCount : 2 )
+		, mCurrentBuffer(0)
+		, mWritePosition(0)
+		, mEndPosition(0)
+		, mLastMarkId(END_OF_STREAM)
+		, mIsShuttingDown(false)
+		, mWriterThread(*this)
+	{
+#ifdef _WIN32
+		mFile = _open( fileName, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE );
+#else
+		mFile = open( fileName, O_WRONLY | O_CREAT | O_TRUNC, 0666 );
+#endif
+		if ( mFile < 0 )
+		{
+			mError = errno;
+			return;
+		}
+
+#ifdef O_DIRECT
+		if ( useDirectIO )
+		{
+			mBufferSize = (mBufferSize + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+			// not all file systems support direct I/O. Fall back to normal I/O in that case.
+			mDirectFile = open( fileName, O_WRONLY | O_DIRECT );
+		}
+#endif
+
+		for ( size_t i = 0; i < mBuffers.size(); ++i )
+		{
+			WriteBuffer& buffer = mBuffers[i];
+			buffer.data = allocateAligned( mBufferSize );
+			buffer.size = 0;
+			buffer.filePosition = 0;
+			mFreeBuffers.push_back( &buffer );
+			if ( !buffer.data )
+			{
+				mError = ENOMEM;
+			}
+		}
+		if ( mError != 0 )
+		{
+			return;
+		}
+
+		if ( !mWriterThread.start() )
+		{
+			mError = EAGAIN;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	AsyncFileBufferFlusher::~AsyncFileBufferFlusher()
+	{
+		if ( mWriterThread.isStarted() )
+		{
+			flush();
+			{
+				COLLADABU::ScopedLock lock( mMutex );
+				mIsShuttingDown = true;
+				mStateChanged.broadcast();
+			}
+			mWriterThread.join();
+		}
+
+#ifdef _WIN32
+		if ( mFile >= 0 )
+			_close( mFile );
+#else
+		if ( mDirectFile >= 0 )
+			close( mDirectFile );
+		if ( mFile >= 0 )
+			close( mFile );
+#endif
+		for ( size_t i = 0; i < mBuffers.size(); ++i )
+		{
+			freeAligned( mBuffers[i].data );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	int AsyncFileBufferFlusher::getError() const
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		return mError;
+	}
+
+	//--------------------------------------------------------------------
+	bool AsyncFileBufferFlusher::receiveData( const char* buffer, size_t length )
+	{
+		if ( !mWriterThread.isStarted() )
+		{
+			return false;
+		}
+
+		while ( length > 0 )
+		{
+			if ( !mCurrentBuffer )
+			{
+				COLLADABU::ScopedLock lock( mMutex );
+				while ( mFreeBuffers.empty() && mError == 0 )
+				{
+					mStateChanged.wait( mMutex );
+				}
+				if ( mError != 0 )
+				{
+					return false;
+				}
+				mCurrentBuffer = mFreeBuffers.front();
+				mFreeBuffers.pop_front();
+				mCurrentBuffer->size = 0;
+				mCurrentBuffer->filePosition = mWritePosition;
+			}
+
+			// with direct I/O, a buffer that starts at an unaligned position is filled only up to the
+			// next aligned position, so the following buffers are aligned again
+			size_t capacity = mBufferSize;
+			if ( mDirectFile >= 0 )
+			{
+				capacity -= (size_t)(mCurrentBuffer->filePosition % DIRECT_IO_ALIGNMENT);
+			}
+
+			size_t copyLength = capacity - mCurrentBuffer->size;
+			if ( copyLength > length )
+			{
+				copyLength = length;
+			}
+			memcpy( mCurrentBuffer->data + mCurrentBuffer->size, buffer, copyLength );
+			mCurrentBuffer->size += copyLength;
+			mWritePosition += copyLength;
+			buffer += copyLength;
+			length -= copyLength;
+
+			if ( mWritePosition > mEndPosition )
+			{
+				mEndPosition = mWritePosition;
+			}
+			if ( mCurrentBuffer->size == capacity )
+			{
+				submitCurrentBuffer();
+			}
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool AsyncFileBufferFlusher::flush()
+	{
+		if ( !mWriterThread.isStarted() )
+		{
+			return false;
+		}
+		submitCurrentBuffer();
+
+		COLLADABU::ScopedLock lock( mMutex );
+		while ( mFreeBuffers.size() < mBuffers.size() )
+		{
+			mStateChanged.wait( mMutex );
+		}
+		return mError == 0;
+	}
+
+	//------------------------------
+	void AsyncFileBufferFlusher::startMark()
+	{
+		mLastMarkId++;
+		mMarkIds.insert( std::make_pair( mLastMarkId, mWritePosition ) );
+	}
+
+	//------------------------------
+	Common::IBufferFlusher::MarkId AsyncFileBufferFlusher::endMark()
+	{
+		return mLastMarkId;
+	}
+
+	//------------------------------
+	bool AsyncFileBufferFlusher::jumpToMark( IBufferFlusher::MarkId markId, bool keepMarkId /*= false*/ )
+	{
+		// the data received so far has to be written to the position it has been received for
+		submitCurrentBuffer();
+
+		if ( markId == END_OF_STREAM )
+		{
+			mWritePosition = mEndPosition;
+			return true;
+		}
+
+		MarkIdToFilePos::iterator markIdIt = mMarkIds.find( markId );
+		if ( markIdIt == mMarkIds.end() )
+		{
+			return false;
+		}
+		mWritePosition = markIdIt->second;
+		if ( !keepMarkId )
+		{
+			mMarkIds.erase( markIdIt );
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	void AsyncFileBufferFlusher::submitCurrentBuffer()
+	{
+		if ( !mCurrentBuffer )
+		{
+			return;
+		}
+
+		COLLADABU::ScopedLock lock( mMutex );
+		if ( mCurrentBuffer->size > 0 )
+		{
+			mBuffersToWrite.push_back( mCurrentBuffer );
+		}
+		else
+		{
+			mFreeBuffers.push_back( mCurrentBuffer );
+		}
+		mCurrentBuffer = 0;
+		mStateChanged.broadcast();
+	}
+
+	//--------------------------------------------------------------------
+	void AsyncFileBufferFlusher::writeBuffers()
+	{
+		for (;;)
+		{
+			WriteBuffer* buffer = 0;
+			bool isWriting = false;
+			{
+				COLLADABU::ScopedLock lock( mMutex );
+				while ( mBuffersToWrite.empty() && !mIsShuttingDown )
+				{
+					mStateChanged.wait( mMutex );
+				}
+				if ( mBuffersToWrite.empty() )
+				{
+					return;
+				}
+				buffer = mBuffersToWrite.front();
+				mBuffersToWrite.pop_front();
+				// after an error, the remaining buffers are discarded
+				isWriting = ( mError == 0 );
+			}
+
+			int error = isWriting ? writeBuffer( *buffer ) : 0;
+
+			COLLADABU::ScopedLock lock( mMutex );
+			if ( error != 0 && mError == 0 )
+			{
+				mError = error;
+			}
+			mFreeBuffers.push_back( buffer );
+			mStateChanged.broadcast();
+		}
+	}
+
+	//--------------------------------------------------------------------
+	int AsyncFileBufferFlusher::writeBuffer( const WriteBuffer& buffer )
+	{
+		const char* data = buffer.data;
+		size_t size = buffer.size;
+		FilePosType filePosition = buffer.filePosition;
+
+#ifdef _WIN32
+		// only the I/O thread accesses the file, so seeking is safe
+		if ( _lseeki64( mFile, filePosition, SEEK_SET ) < 0 )
+		{
+			return errno;
+		}
+		while ( size > 0 )
+		{
+			int written = _write( mFile, data, (unsigned int)size );
+			if ( written < 0 )
+			{
+				return errno;
+			}
+			data += written;
+			size -= (size_t)written;
+		}
+#else
+		int file = mFile;
+		if ( mDirectFile >= 0 && (filePosition % DIRECT_IO_ALIGNMENT) == 0 && (size % DIRECT_IO_ALIGNMENT) == 0 )
+		{
+			file = mDirectFile;
+		}
+		while ( size > 0 )
+		{
+			ssize_t written = pwrite( file, data, size, filePosition );
+			if ( written < 0 )
+			{
+				if ( errno == EINTR )
+				{
+					continue;
+				}
+				return errno;
+			}
+			data += written;
+			size -= (size_t)written;
+			filePosition += written;
+		}
+#endif
+		return 0;
+	}
+
+} //namespace COLLADASW
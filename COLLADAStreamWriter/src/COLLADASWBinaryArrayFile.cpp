@@ -0,0 +1,163 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+	This file is part of COLLADAStreamWriter.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASWBinaryArrayFile.h"
+#include "COLLADASWStreamWriter.h"
+#include "COLLADASWConstants.h"
+#include "COLLADASWException.h"
+
+#include "COLLADABUUtils.h"
+
+#include "CommonBuffer.h"
+#include "CommonFWriteBufferFlusher.h"
+
+namespace COLLADASW
+{
+
+	const size_t BinaryArrayFile::DEFAULT_MINIMUM_COUNT = 1024;
+
+	/** The size of the buffer the values are collected in.*/
+	static const size_t BINARYARRAYFILE_BUFFERSIZE = 1024*64;
+
+	/** The alignment of the arrays in the file.*/
+	static const size_t BINARYARRAYFILE_ALIGNMENT = 8;
+
+	//---------------------------------------------------------------
+	static bool isLittleEndian()
+	{
+		const unsigned int one = 1;
+		return *(const unsigned char*)&one == 1;
+	}
+
+	//---------------------------------------------------------------
+	BinaryArrayFile::BinaryArrayFile( const NativeString& fileName, const String& reference, size_t minimumCount /*= DEFAULT_MINIMUM_COUNT*/ )
+		: mFlusher( new Common::FWriteBufferFlusher( fileName.c_str(), BINARYARRAYFILE_BUFFERSIZE ) )
+		, mBuffer( 0 )
+		, mReference( reference )
+		, mMinimumCount( minimumCount )
+		, mOffset( 0 )
+		, mValueType( VALUE_TYPE_FLOAT32 )
+		, mArrayOffset( 0 )
+		, mArrayCount( 0 )
+	{
+		int error = mFlusher->getError();
+		if ( error != 0 )
+		{
+			delete mFlusher;
+			throw StreamWriterException(StreamWriterException::ERROR_FILE_OPEN, "Could not open file \"" + fileName + "\" for writing. errno_t = " + Utils::toString(error) );
+		}
+		mBuffer = new Common::Buffer( BINARYARRAYFILE_BUFFERSIZE, mFlusher );
+	}
+
+	//---------------------------------------------------------------
+	BinaryArrayFile::~BinaryArrayFile()
+	{
+		mBuffer->flushFlusher();
+		delete mBuffer;
+		delete mFlusher;
+	}
+
+	//---------------------------------------------------------------
+	void BinaryArrayFile::beginArray( ValueType valueType )
+	{
+		static const char padding[BINARYARRAYFILE_ALIGNMENT] = { 0 };
+		size_t misalignment = (size_t)(mOffset % BINARYARRAYFILE_ALIGNMENT);
+		if ( misalignment != 0 )
+		{
+			mBuffer->copyToBuffer( padding, BINARYARRAYFILE_ALIGNMENT - misalignment );
+			mOffset += BINARYARRAYFILE_ALIGNMENT - misalignment;
+		}
+		mValueType = valueType;
+		mArrayOffset = mOffset;
+		mArrayCount = 0;
+	}
+
+	//---------------------------------------------------------------
+	void BinaryArrayFile::appendBytes( const void* value, size_t size )
+	{
+		if ( isLittleEndian() )
+		{
+			mBuffer->copyToBuffer( (const char*)value, size );
+		}
+		else
+		{
+			char swapped[8];
+			for ( size_t i = 0; i < size; ++i )
+				swapped[i] = ((const char*)value)[size - 1 - i];
+			mBuffer->copyToBuffer( swapped, size );
+		}
+		mOffset += size;
+		mArrayCount++;
+	}
+
+	//---------------------------------------------------------------
+	void BinaryArrayFile::appendValue( double value )
+	{
+		switch ( mValueType )
+		{
+		case VALUE_TYPE_FLOAT32:
+			{
+				float floatValue = (float)value;
+				appendBytes( &floatValue, sizeof(floatValue) );
+				break;
+			}
+		case VALUE_TYPE_FLOAT64:
+			appendBytes( &value, sizeof(value) );
+			break;
+		case VALUE_TYPE_UINT32:
+			appendValue( (unsigned long)value );
+			break;
+		}
+	}
+
+	//---------------------------------------------------------------
+	void BinaryArrayFile::appendValue( float value )
+	{
+		if ( mValueType == VALUE_TYPE_FLOAT32 )
+			appendBytes( &value, sizeof(value) );
+		else
+			appendValue( (double)value );
+	}
+
+	//---------------------------------------------------------------
+	void BinaryArrayFile::appendValue( unsigned long value )
+	{
+		if ( mValueType == VALUE_TYPE_UINT32 )
+		{
+			unsigned int intValue = (unsigned int)value;
+			appendBytes( &intValue, sizeof(intValue) );
+		}
+		else
+		{
+			appendValue( (double)value );
+		}
+	}
+
+	//---------------------------------------------------------------
+	void BinaryArrayFile::endArray( StreamWriter* streamWriter )
+	{
+		const String* type = &CSWC::CSW_BINARY_ARRAY_TYPE_FLOAT32;
+		if ( mValueType == VALUE_TYPE_FLOAT64 )
+			type = &CSWC::CSW_BINARY_ARRAY_TYPE_FLOAT64;
+		else if ( mValueType == VALUE_TYPE_UINT32 )
+			type = &CSWC::CSW_BINARY_ARRAY_TYPE_UINT32;
+
+		streamWriter->openElement( CSWC::CSW_ELEMENT_TECHNIQUE );
+		streamWriter->appendAttribute( CSWC::CSW_ATTRIBUTE_PROFILE, CSWC::CSW_PROFILE_OPENCOLLADA );
+		streamWriter->openElement( CSWC::CSW_ELEMENT_BINARY_ARRAY );
+		streamWriter->appendAttribute( CSWC::CSW_ATTRIBUTE_FILE, mReference );
+		streamWriter->appendAttribute( CSWC::CSW_ATTRIBUTE_OFFSET, Utils::toString( mArrayOffset ) );
+		streamWriter->appendAttribute( CSWC::CSW_ATTRIBUTE_COUNT, (unsigned long)mArrayCount );
+		streamWriter->appendAttribute( CSWC::CSW_ATTRIBUTE_TYPE, *type );
+		streamWriter->closeElement();
+		streamWriter->closeElement();
+	}
+
+} //namespace COLLADASW
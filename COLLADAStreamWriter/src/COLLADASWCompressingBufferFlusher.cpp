@@ -0,0 +1,636 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+	This file is part of COLLADAStreamWriter.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASWCompressingBufferFlusher.h"
+
+#include "zlib.h"
+
+#include <cerrno>
+#include <cstring>
+
+namespace COLLADASW
+{
+	const char CompressingBufferFlusher::DEFAULT_ZAE_DOCUMENT_NAME[] = "scene.dae";
+
+	/** The maximum distance of a deflate back reference.*/
+	const size_t DICTIONARY_SIZE = 32*1024;
+
+	const char ZAE_MANIFEST_NAME[] = "manifest.xml";
+
+	/** 1980-01-01 00:00, the earliest date that can be stored in a zip archive.*/
+	const unsigned short ZIP_DOS_TIME = 0;
+	const unsigned short ZIP_DOS_DATE = (1 << 5) | 1;
+
+	const unsigned short ZIP_VERSION = 20;
+	const unsigned short ZIP_METHOD_STORED = 0;
+	const unsigned short ZIP_METHOD_DEFLATED = 8;
+
+	/** Offset of the crc in a zip local file header.*/
+	const size_t ZIP_LOCAL_HEADER_CRC_OFFSET = 14;
+
+	//--------------------------------------------------------------------
+	static void appendUint16( std::string& data, unsigned long value )
+	{
+		data += (char)(value & 0xff);
+		data += (char)((value >> 8) & 0xff);
+	}
+
+	//--------------------------------------------------------------------
+	static void appendUint32( std::string& data, unsigned long value )
+	{
+		appendUint16( data, value & 0xffff );
+		appendUint16( data, (value >> 16) & 0xffff );
+	}
+
+	//--------------------------------------------------------------------
+	static void appendZipEntryHeader( std::string& data, bool isCentral, unsigned short method, unsigned long crc,
+									  size_t compressedSize, size_t uncompressedSize, const std::string& name,
+									  size_t localHeaderOffset )
+	{
+		appendUint32( data, isCentral ? 0x02014b50 : 0x04034b50 );
+		if ( isCentral )
+			appendUint16( data, ZIP_VERSION );	// version made by
+		appendUint16( data, ZIP_VERSION );		// version needed to extract
+		appendUint16( data, 0 );				// flags
+		appendUint16( data, method );
+		appendUint16( data, ZIP_DOS_TIME );
+		appendUint16( data, ZIP_DOS_DATE );
+		appendUint32( data, crc );
+		appendUint32( data, (unsigned long)compressedSize );
+		appendUint32( data, (unsigned long)uncompressedSize );
+		appendUint16( data, (unsigned long)name.length() );
+		appendUint16( data, 0 );				// extra field length
+		if ( isCentral )
+		{
+			appendUint16( data, 0 );			// comment length
+			appendUint16( data, 0 );			// disk number
+			appendUint16( data, 0 );			// internal attributes
+			appendUint32( data, 0 );			// external attributes
+			appendUint32( data, (unsigned long)localHeaderOffset );
+		}
+		data += name;
+	}
+
+	//--------------------------------------------------------------------
+	/** Sets the position of @a stream with a 64 bit offset, like FWriteBufferFlusher does.*/
+	static bool seekFile( FILE* stream, unsigned long long offset, int origin )
+	{
+#ifdef __MINGW32__
+		return fseeko64( stream, (off64_t)offset, origin ) == 0;
+#elif defined( _WIN32)
+		return _fseeki64( stream, (__int64)offset, origin ) == 0;
+#elif defined (__APPLE__) || defined(__FreeBSD__)
+		return fseeko( stream, (off_t)offset, origin ) == 0;
+#else
+		return fseeko64( stream, (off64_t)offset, origin ) == 0;
+#endif
+	}
+
+	//--------------------------------------------------------------------
+	CompressingBufferFlusher::CompressingBufferFlusher( const char* fileName,
+														Format format,
+														int compressionLevel,
+														size_t threadCount,
+														size_t blockSize,
+														const char* zaeDocumentName )
+		: mFormat(format)
+		, mCompressionLevel(compressionLevel)
+		, mBlockSize( blockSize > 0 ? blockSize : DEFAULT_BLOCK_SIZE )
+		, mMaxBlocksInFlight( 2 * threadCount + 2 )
+		, mZaeDocumentName(zaeDocumentName)
+		, mStream( fopen( fileName, "wb" ) )
+		, mError( mStream ? 0 : errno )
+		, mIsFinished(false)
+		, mHeldDataStart(0)
+		, mSubmittedSize(0)
+		, mWritePosition(0)
+		, mEndPosition(0)
+		, mLastMarkId(END_OF_STREAM)
+		, mIsShuttingDown(false)
+		, mCrc( crc32(0, Z_NULL, 0) )
+		, mUncompressedSize(0)
+		, mCompressedSize(0)
+		, mFileSize(0)
+		, mDocumentHeaderOffset(0)
+		, mManifestSize(0)
+		, mManifestCrc(0)
+		, mWriterThread(0)
+	{
+		if ( mError != 0 || !writeHeader() )
+		{
+			mHasFailed.set();
+			return;
+		}
+
+		mWriterThread = new TaskThread( *this, &CompressingBufferFlusher::writeBlocks );
+		bool threadsStarted = mWriterThread->start();
+		if ( threadCount == 0 )
+		{
+			threadCount = 1;
+		}
+		for ( size_t i = 0; i < threadCount && threadsStarted; ++i )
+		{
+			TaskThread* thread = new TaskThread( *this, &CompressingBufferFlusher::compressBlocks );
+			mCompressionThreads.push_back( thread );
+			threadsStarted = thread->start();
+		}
+		if ( !threadsStarted )
+		{
+			COLLADABU::ScopedLock lock( mMutex );
+			setError( EAGAIN );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	CompressingBufferFlusher::~CompressingBufferFlusher()
+	{
+		finish();
+		stopThreads();
+		if ( mStream )
+		{
+			fclose( mStream );
+		}
+		for ( BlockQueue::iterator it = mFreeBlocks.begin(); it != mFreeBlocks.end(); ++it )
+		{
+			delete *it;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	int CompressingBufferFlusher::getError() const
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		return mError;
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::receiveData( const char* buffer, size_t length )
+	{
+		// checked for every buffer, so the error is tested without locking the mutex
+		if ( !mStream || mIsFinished || mHasFailed.isSet() )
+		{
+			return false;
+		}
+
+		if ( mWritePosition < mEndPosition )
+		{
+			// we have jumped to a mark. Overwrite the held data.
+			size_t overwriteLength = mEndPosition - mWritePosition;
+			if ( overwriteLength > length )
+			{
+				overwriteLength = length;
+			}
+			memcpy( &mHeldData[mHeldDataStart + mWritePosition - mSubmittedSize], buffer, overwriteLength );
+			mWritePosition += overwriteLength;
+			buffer += overwriteLength;
+			length -= overwriteLength;
+		}
+
+		mHeldData.insert( mHeldData.end(), buffer, buffer + length );
+		mWritePosition += length;
+		if ( mWritePosition > mEndPosition )
+		{
+			mEndPosition = mWritePosition;
+		}
+
+		return submitHeldData( false );
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::flush()
+	{
+		if ( !mStream || mIsFinished )
+		{
+			return false;
+		}
+		bool success = submitHeldData( true );
+		success &= waitForBlocksWritten();
+		return success && ( fflush( mStream ) == 0 );
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::finish()
+	{
+		if ( mIsFinished )
+		{
+			return mError == 0;
+		}
+		mIsFinished = true;
+		if ( !mStream || !mWriterThread )
+		{
+			return false;
+		}
+
+		// marks cannot be jumped to anymore
+		mMarkIds.clear();
+		mWritePosition = mEndPosition;
+
+		bool success = submitHeldData( false );
+		success = success && submitBlock( mEndPosition - mSubmittedSize, true );
+		success &= waitForBlocksWritten();
+		stopThreads();
+		success = success && writeTrailer();
+
+		success &= ( fclose( mStream ) == 0 );
+		mStream = 0;
+		if ( !success && mError == 0 )
+		{
+			setError( EIO );
+		}
+		return success;
+	}
+
+	//------------------------------
+	void CompressingBufferFlusher::startMark()
+	{
+		mLastMarkId++;
+		mMarkIds.insert( std::make_pair( mLastMarkId, mWritePosition ) );
+	}
+
+	//------------------------------
+	Common::IBufferFlusher::MarkId CompressingBufferFlusher::endMark()
+	{
+		return mLastMarkId;
+	}
+
+	//------------------------------
+	bool CompressingBufferFlusher::jumpToMark( IBufferFlusher::MarkId markId, bool keepMarkId /*= false*/ )
+	{
+		if ( markId == END_OF_STREAM )
+		{
+			mWritePosition = mEndPosition;
+			// data held only because of the jump can be compressed now
+			return submitHeldData( false );
+		}
+
+		MarkIdToPosition::iterator markIdIt = mMarkIds.find( markId );
+		if ( markIdIt == mMarkIds.end() )
+		{
+			return false;
+		}
+		mWritePosition = markIdIt->second;
+		if ( !keepMarkId )
+		{
+			mMarkIds.erase( markIdIt );
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::writeHeader()
+	{
+		std::string header;
+		if ( mFormat == FORMAT_GZIP )
+		{
+			appendUint16( header, 0x8b1f );	// magic
+			header += (char)Z_DEFLATED;		// method
+			header += (char)0;				// flags
+			appendUint32( header, 0 );		// modification time
+			header += (char)0;				// extra flags
+			header += (char)0xff;			// os unknown
+		}
+		else
+		{
+			std::string manifest = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<dae_root>./";
+			manifest += mZaeDocumentName;
+			manifest += "</dae_root>\n";
+			mManifestSize = manifest.length();
+			mManifestCrc = crc32( crc32(0, Z_NULL, 0), (const Bytef*)manifest.data(), (uInt)manifest.length() );
+
+			appendZipEntryHeader( header, false, ZIP_METHOD_STORED, mManifestCrc, mManifestSize, mManifestSize, ZAE_MANIFEST_NAME, 0 );
+			header += manifest;
+
+			// crc and sizes of the document are filled in by writeTrailer()
+			mDocumentHeaderOffset = header.length();
+			appendZipEntryHeader( header, false, ZIP_METHOD_DEFLATED, 0, 0, 0, mZaeDocumentName, 0 );
+		}
+
+		if ( !writeToFile( header.data(), header.length() ) )
+		{
+			setError( EIO );
+			return false;
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::writeTrailer()
+	{
+		std::string trailer;
+		if ( mFormat == FORMAT_GZIP )
+		{
+			appendUint32( trailer, mCrc );
+			appendUint32( trailer, (unsigned long)(mUncompressedSize & 0xffffffff) );
+			return writeToFile( trailer.data(), trailer.length() );
+		}
+
+		// zae archives are written without zip64 extensions
+		const size_t maxSize = 0xffffffff;
+		if ( mUncompressedSize > maxSize || mFileSize > maxSize )
+		{
+			setError( EFBIG );
+			return false;
+		}
+
+		std::string documentSizes;
+		appendUint32( documentSizes, mCrc );
+		appendUint32( documentSizes, (unsigned long)mCompressedSize );
+		appendUint32( documentSizes, (unsigned long)mUncompressedSize );
+		if ( !seekFile( mStream, mDocumentHeaderOffset + ZIP_LOCAL_HEADER_CRC_OFFSET, SEEK_SET )
+			|| fwrite( documentSizes.data(), 1, documentSizes.length(), mStream ) != documentSizes.length()
+			|| !seekFile( mStream, 0, SEEK_END ) )
+		{
+			return false;
+		}
+
+		size_t centralDirectoryOffset = mFileSize;
+		appendZipEntryHeader( trailer, true, ZIP_METHOD_STORED, mManifestCrc, mManifestSize, mManifestSize, ZAE_MANIFEST_NAME, 0 );
+		appendZipEntryHeader( trailer, true, ZIP_METHOD_DEFLATED, mCrc, mCompressedSize, mUncompressedSize, mZaeDocumentName, mDocumentHeaderOffset );
+		size_t centralDirectorySize = trailer.length();
+
+		appendUint32( trailer, 0x06054b50 );
+		appendUint16( trailer, 0 );			// number of this disk
+		appendUint16( trailer, 0 );			// disk with the central directory
+		appendUint16( trailer, 2 );			// entries on this disk
+		appendUint16( trailer, 2 );			// total entries
+		appendUint32( trailer, (unsigned long)centralDirectorySize );
+		appendUint32( trailer, (unsigned long)centralDirectoryOffset );
+		appendUint16( trailer, 0 );			// comment length
+		return writeToFile( trailer.data(), trailer.length() );
+	}
+
+	//--------------------------------------------------------------------
+	size_t CompressingBufferFlusher::getSubmitLimit() const
+	{
+		size_t limit = mWritePosition;
+		for ( MarkIdToPosition::const_iterator it = mMarkIds.begin(); it != mMarkIds.end(); ++it )
+		{
+			if ( it->second < limit )
+			{
+				limit = it->second;
+			}
+		}
+		return limit;
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::submitHeldData( bool submitPartialBlock )
+	{
+		size_t limit = getSubmitLimit();
+		while ( limit - mSubmittedSize >= mBlockSize )
+		{
+			if ( !submitBlock( mBlockSize, false ) )
+			{
+				return false;
+			}
+		}
+		if ( submitPartialBlock && limit > mSubmittedSize )
+		{
+			if ( !submitBlock( limit - mSubmittedSize, false ) )
+			{
+				return false;
+			}
+		}
+
+		// discard submitted data, once it makes up the larger part of mHeldData
+		if ( mHeldDataStart > 0 && mHeldDataStart >= mHeldData.size() - mHeldDataStart )
+		{
+			mHeldData.erase( mHeldData.begin(), mHeldData.begin() + mHeldDataStart );
+			mHeldDataStart = 0;
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::submitBlock( size_t length, bool isLast )
+	{
+		Block* block = 0;
+		{
+			COLLADABU::ScopedLock lock( mMutex );
+			while ( mBlocksInFlight.size() >= mMaxBlocksInFlight && mError == 0 )
+			{
+				mStateChanged.wait( mMutex );
+			}
+			if ( mError != 0 )
+			{
+				return false;
+			}
+			if ( mFreeBlocks.empty() )
+			{
+				block = new Block();
+			}
+			else
+			{
+				block = mFreeBlocks.front();
+				mFreeBlocks.pop_front();
+			}
+		}
+
+		// the block is not visible to the other threads yet
+		std::vector<char>::const_iterator blockBegin = mHeldData.begin() + mHeldDataStart;
+		block->input.assign( blockBegin, blockBegin + length );
+		block->dictionary = mDictionary;
+		block->output.clear();
+		block->crc = 0;
+		block->isLast = isLast;
+		block->isCompressed = false;
+		block->hasFailed = false;
+
+		// the dictionary of the next block are the last 32 KB before it
+		mDictionary.insert( mDictionary.end(), block->input.begin(), block->input.end() );
+		if ( mDictionary.size() > DICTIONARY_SIZE )
+		{
+			mDictionary.erase( mDictionary.begin(), mDictionary.end() - DICTIONARY_SIZE );
+		}
+
+		mHeldDataStart += length;
+		mSubmittedSize += length;
+
+		COLLADABU::ScopedLock lock( mMutex );
+		mBlocksToCompress.push_back( block );
+		mBlocksInFlight.push_back( block );
+		mStateChanged.broadcast();
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::waitForBlocksWritten()
+	{
+		COLLADABU::ScopedLock lock( mMutex );
+		while ( !mBlocksInFlight.empty() )
+		{
+			mStateChanged.wait( mMutex );
+		}
+		return mError == 0;
+	}
+
+	//--------------------------------------------------------------------
+	void CompressingBufferFlusher::compressBlocks()
+	{
+		for (;;)
+		{
+			Block* block = 0;
+			{
+				COLLADABU::ScopedLock lock( mMutex );
+				while ( mBlocksToCompress.empty() && !mIsShuttingDown )
+				{
+					mStateChanged.wait( mMutex );
+				}
+				if ( mBlocksToCompress.empty() )
+				{
+					return;
+				}
+				block = mBlocksToCompress.front();
+				mBlocksToCompress.pop_front();
+			}
+
+			compressBlock( block );
+
+			COLLADABU::ScopedLock lock( mMutex );
+			block->isCompressed = true;
+			mStateChanged.broadcast();
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void CompressingBufferFlusher::compressBlock( Block* block )
+	{
+		Bytef emptyInput = 0;
+		uInt inputSize = (uInt)block->input.size();
+		Bytef* input = inputSize > 0 ? (Bytef*)&block->input[0] : &emptyInput;
+		block->crc = crc32( crc32(0, Z_NULL, 0), input, inputSize );
+
+		z_stream stream;
+		memset( &stream, 0, sizeof(stream) );
+		// raw deflate, the gzip or zip framing is written by the flusher
+		if ( deflateInit2( &stream, mCompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+		{
+			block->hasFailed = true;
+			return;
+		}
+		if ( !block->dictionary.empty() )
+		{
+			deflateSetDictionary( &stream, (const Bytef*)&block->dictionary[0], (uInt)block->dictionary.size() );
+		}
+
+		// all but the last block end with a sync flush, which byte aligns the output, so the blocks
+		// can be concatenated to one deflate stream
+		int flush = block->isLast ? Z_FINISH : Z_SYNC_FLUSH;
+		block->output.resize( deflateBound( &stream, inputSize ) + 16 );
+		stream.next_in = input;
+		stream.avail_in = inputSize;
+		for (;;)
+		{
+			stream.next_out = (Bytef*)&block->output[stream.total_out];
+			stream.avail_out = (uInt)(block->output.size() - stream.total_out);
+			int result = deflate( &stream, flush );
+			if ( result == Z_STREAM_ERROR )
+			{
+				block->hasFailed = true;
+				break;
+			}
+			bool isDone = block->isLast ? (result == Z_STREAM_END) : (stream.avail_out != 0);
+			if ( isDone )
+			{
+				break;
+			}
+			block->output.resize( 2 * block->output.size() );
+		}
+		block->output.resize( stream.total_out );
+		deflateEnd( &stream );
+	}
+
+	//--------------------------------------------------------------------
+	void CompressingBufferFlusher::writeBlocks()
+	{
+		for (;;)
+		{
+			Block* block = 0;
+			bool isWriting = false;
+			{
+				COLLADABU::ScopedLock lock( mMutex );
+				while ( (mBlocksInFlight.empty() || !mBlocksInFlight.front()->isCompressed)
+					&& !(mBlocksInFlight.empty() && mIsShuttingDown) )
+				{
+					mStateChanged.wait( mMutex );
+				}
+				if ( mBlocksInFlight.empty() )
+				{
+					return;
+				}
+				block = mBlocksInFlight.front();
+				isWriting = ( mError == 0 );
+				if ( block->hasFailed && isWriting )
+				{
+					setError( EIO );
+					isWriting = false;
+				}
+			}
+
+			// after an error, the remaining blocks are discarded
+			bool success = true;
+			if ( isWriting && !block->output.empty() )
+			{
+				success = writeToFile( &block->output[0], block->output.size() );
+			}
+			if ( isWriting )
+			{
+				mCrc = crc32_combine( mCrc, block->crc, (z_off_t)block->input.size() );
+				mUncompressedSize += block->input.size();
+				mCompressedSize += block->output.size();
+			}
+
+			COLLADABU::ScopedLock lock( mMutex );
+			if ( !success && mError == 0 )
+			{
+				setError( EIO );
+			}
+			mBlocksInFlight.pop_front();
+			mFreeBlocks.push_back( block );
+			mStateChanged.broadcast();
+		}
+	}
+
+	//--------------------------------------------------------------------
+	bool CompressingBufferFlusher::writeToFile( const void* data, size_t length )
+	{
+		if ( fwrite( data, 1, length, mStream ) != length )
+		{
+			return false;
+		}
+		mFileSize += length;
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	void CompressingBufferFlusher::setError( int error )
+	{
+		mError = error;
+		mHasFailed.set();
+	}
+
+	//--------------------------------------------------------------------
+	void CompressingBufferFlusher::stopThreads()
+	{
+		{
+			COLLADABU::ScopedLock lock( mMutex );
+			mIsShuttingDown = true;
+			mStateChanged.broadcast();
+		}
+		for ( size_t i = 0; i < mCompressionThreads.size(); ++i )
+		{
+			delete mCompressionThreads[i];
+		}
+		mCompressionThreads.clear();
+		delete mWriterThread;
+		mWriterThread = 0;
+	}
+
+} //namespace COLLADASW
@@ -27,6 +27,8 @@ namespace COLLADASW
 
     const String CSWC::CSW_PLATFORM_PC_OGL               = "PC-OGL";
 
+    const String CSWC::CSW_PROFILE_OPENCOLLADA = "OpenCOLLADA";
+
     const String CSWC::CSW_ELEMENT_ACCESSOR = "accessor";
     const String CSWC::CSW_ELEMENT_ALL = "all";
     const String CSWC::CSW_ELEMENT_AMBIENT = "ambient";
@@ -38,6 +40,7 @@ namespace COLLADASW
     const String CSWC::CSW_ELEMENT_AUTHOR = "author";
     const String CSWC::CSW_ELEMENT_AUTHORING_TOOL = "authoring_tool";
     const String CSWC::CSW_ELEMENT_BLINN = "blinn";
+    const String CSWC::CSW_ELEMENT_BINARY_ARRAY = "binary_array";
     const String CSWC::CSW_ELEMENT_BIND = "bind";
     const String CSWC::CSW_ELEMENT_BIND_MATERIAL = "bind_material";
 	const String CSWC::CSW_ELEMENT_BIND_SHAPE_MATRIX = "bind_shape_matrix";
@@ -238,6 +241,7 @@ namespace COLLADASW
     const String CSWC::CSW_ATTRIBUTE_COUNT = "count";
     const String CSWC::CSW_ATTRIBUTE_END = "end";
     const String CSWC::CSW_ATTRIBUTE_FACE = "face";
+    const String CSWC::CSW_ATTRIBUTE_FILE = "file";
     const String CSWC::CSW_ATTRIBUTE_ID = "id";
 	const String CSWC::CSW_ATTRIBUTE_INDEX = "index";
 	const String CSWC::CSW_ATTRIBUTE_INPUT_SEMANTIC = "input_semantic";
@@ -332,6 +336,10 @@ namespace COLLADASW
     const String CSWC::CSW_VALUE_TYPE_NAME = "name";
     const String CSWC::CSW_VALUE_TYPE_IDREF = "IDREF";
 
+    const String CSWC::CSW_BINARY_ARRAY_TYPE_FLOAT32 = "float32";
+    const String CSWC::CSW_BINARY_ARRAY_TYPE_FLOAT64 = "float64";
+    const String CSWC::CSW_BINARY_ARRAY_TYPE_UINT32 = "uint32";
+
     const String CSWC::CSW_SAMPLER_FILTER_LINEAR = "LINEAR";
     const String CSWC::CSW_SAMPLER_FILTER_LINEAR_MIPMAP_LINEAR = "LINEAR_MIPMAP_LINEAR" ;
     const String CSWC::CSW_SAMPLER_FILTER_LINEAR_MIPMAP_NEAREST = "LINEAR_MIPMAP_NEAREST";
@@ -9,6 +9,7 @@
 */
 
 #include "COLLADASWPrimitves.h"
+#include "COLLADASWBinaryArrayFile.h"
 
 namespace COLLADASW
 {
@@ -44,6 +45,25 @@ namespace COLLADASW
         }
     }
 
+    //---------------------------------------------------------------
+    bool PrimitivesBase::prepareBinaryArray()
+    {
+        mBinaryArrayFile = 0;
+        BinaryArrayFile* binaryArrayFile = mSW->getBinaryArrayFile();
+        if ( !binaryArrayFile || !binaryArrayFile->isBinaryArray ( mCount ) )
+            return false;
+
+        mBinaryArrayFile = binaryArrayFile;
+        mBinaryArrayFile->beginArray ( BinaryArrayFile::VALUE_TYPE_UINT32 );
+        return true;
+    }
+
+    //---------------------------------------------------------------
+    void PrimitivesBase::appendBinaryValue ( const unsigned long number )
+    {
+        mBinaryArrayFile->appendValue ( number );
+    }
+
     //---------------------------------------------------------------
     void PrimitivesBase::openPrimitiveElement ( )
     {
@@ -107,6 +127,14 @@ namespace COLLADASW
     //---------------------------------------------------------------
     void PrimitivesBase::finish()
     {
+        if ( mBinaryArrayFile )
+        {
+            // the indices are referenced from the extra of the primitive element
+            mSW->openElement ( CSWC::CSW_ELEMENT_EXTRA );
+            mBinaryArrayFile->endArray ( mSW );
+            mSW->closeElement();
+            mBinaryArrayFile = 0;
+        }
         mPrimitiveCloser.close();
     }
 
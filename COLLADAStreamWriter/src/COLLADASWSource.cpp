@@ -9,6 +9,7 @@
 */
 
 #include "COLLADASWSource.h"
+#include "COLLADASWBinaryArrayFile.h"
 #include "COLLADABUUtils.h"
 
 namespace COLLADASW
@@ -24,6 +25,15 @@ namespace COLLADASW
         mSW->openElement ( *arrayName );
         mSW->appendAttribute ( CSWC::CSW_ATTRIBUTE_ID, mArrayId );
         mSW->appendAttribute ( CSWC::CSW_ATTRIBUTE_COUNT, mAccessorCount * mAccessorStride );
+
+        // large float arrays are written to the binary array file, if there is one
+        mBinaryArrayFile = 0;
+        BinaryArrayFile* binaryArrayFile = mSW->getBinaryArrayFile();
+        if ( binaryArrayFile && ( *arrayName == CSWC::CSW_ELEMENT_FLOAT_ARRAY ) && binaryArrayFile->isBinaryArray ( mAccessorCount * mAccessorStride ) )
+        {
+            mBinaryArrayFile = binaryArrayFile;
+            mBinaryArrayFile->beginArray ( mSW->getDoublePrecision() ? BinaryArrayFile::VALUE_TYPE_FLOAT64 : BinaryArrayFile::VALUE_TYPE_FLOAT32 );
+        }
     }
 
     //---------------------------------------------------------------
@@ -33,6 +43,12 @@ namespace COLLADASW
 
         addBaseTechnique ( parameterTypeName );
 
+        if ( mBinaryArrayFile )
+        {
+            mBinaryArrayFile->endArray ( mSW );
+            mBinaryArrayFile = 0;
+        }
+
         if ( closeSourceElement ) closeSource();
     }
 
@@ -71,5 +87,23 @@ namespace COLLADASW
         mSW->closeElement();
     }
 
+    //---------------------------------------------------------------
+    void SourceBase::appendBinaryValue ( const double value )
+    {
+        mBinaryArrayFile->appendValue ( value );
+    }
+
+    //---------------------------------------------------------------
+    void SourceBase::appendBinaryValue ( const float value )
+    {
+        mBinaryArrayFile->appendValue ( value );
+    }
+
+    //---------------------------------------------------------------
+    void SourceBase::appendBinaryValue ( const String& value )
+    {
+        mSW->appendValues ( value );
+    }
+
 
 } //namespace COLLADASW
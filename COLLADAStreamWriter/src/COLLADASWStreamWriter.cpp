@@ -10,10 +10,12 @@
 
 #include "COLLADASWStreamWriter.h"
 
+#include "COLLADASWCompressingBufferFlusher.h"
 #include "COLLADASWConstants.h"
 #include "COLLADASWException.h"
 
 #include "COLLADABUStringUtils.h"
+#include "COLLADABUUtils.h"
 
 #include "CommonCharacterBuffer.h"
 #include "CommonFWriteBufferFlusher.h"
@@ -63,16 +65,32 @@ namespace COLLADASW
 	const int StreamWriter::FWRITEBUFFERSIZE = 1024*64;
 	const int StreamWriter::CHARACTERBUFFERSIZE = 1024*64*64;
 
+	//---------------------------------------------------------------
+	static Common::IBufferFlusher* createBufferFlusher( const NativeString& fileName, size_t bufferSize, StreamWriter::Compression compression )
+	{
+		switch ( compression )
+		{
+		case StreamWriter::COMPRESSION_GZIP:
+			return new CompressingBufferFlusher( fileName.c_str(), CompressingBufferFlusher::FORMAT_GZIP );
+		case StreamWriter::COMPRESSION_ZAE:
+			return new CompressingBufferFlusher( fileName.c_str(), CompressingBufferFlusher::FORMAT_ZAE );
+		default:
+			return new Common::FWriteBufferFlusher( fileName.c_str(), bufferSize );
+		}
+	}
+
 
     //---------------------------------------------------------------
-    StreamWriter::StreamWriter ( const NativeString & fileName, bool doublePrecision /*= false*/, COLLADAVersion cOLLADAVersion /*= COLLADA_1_4_1*/ )
-            : mBufferFlusher( new Common::FWriteBufferFlusher(fileName.c_str(), FWRITEBUFFERSIZE))
+    StreamWriter::StreamWriter ( const NativeString & fileName, bool doublePrecision /*= false*/, COLLADAVersion cOLLADAVersion /*= COLLADA_1_4_1*/, Compression compression /*= COMPRESSION_NONE*/ )
+            : mBufferFlusher( createBufferFlusher(fileName, FWRITEBUFFERSIZE, compression) )
+			, mOwnsBufferFlusher( true )
 			, mCharacterBuffer( new Common::CharacterBuffer(CHARACTERBUFFERSIZE, mBufferFlusher) )
+            , mDoublePrecision (doublePrecision)
 			, mLevel ( 0 )
             , mIndent ( 2 )
-            , mDoublePrecision (doublePrecision)
-			, mCOLLADAVersion(cOLLADAVersion)
 			, mNextElementIndex(0)
+			, mCOLLADAVersion(cOLLADAVersion)
+			, mBinaryArrayFile(0)
     {
 		int error = mBufferFlusher->getError();
 		if ( error != 0 )
@@ -81,12 +99,34 @@ namespace COLLADASW
 		}
     }
 
+    //---------------------------------------------------------------
+    StreamWriter::StreamWriter ( Common::IBufferFlusher* bufferFlusher, bool doublePrecision /*= false*/, COLLADAVersion cOLLADAVersion /*= COLLADA_1_4_1*/ )
+            : mBufferFlusher( bufferFlusher )
+			, mOwnsBufferFlusher( false )
+			, mCharacterBuffer( new Common::CharacterBuffer(CHARACTERBUFFERSIZE, mBufferFlusher) )
+            , mDoublePrecision (doublePrecision)
+			, mLevel ( 0 )
+            , mIndent ( 2 )
+			, mNextElementIndex(0)
+			, mCOLLADAVersion(cOLLADAVersion)
+			, mBinaryArrayFile(0)
+    {
+		int error = mBufferFlusher->getError();
+		if ( error != 0 )
+		{
+			// the destructor is not called, if the constructor throws
+			delete mCharacterBuffer;
+			throw StreamWriterException(StreamWriterException::ERROR_SET_BUFFER, "The buffer flusher is in an error state. errno_t = " + Utils::toString(error) );
+		}
+    }
+
     //---------------------------------------------------------------
     StreamWriter::~StreamWriter()
     {
         endDocument();
 		delete mCharacterBuffer;
-		delete mBufferFlusher;
+		if ( mOwnsBufferFlusher )
+			delete mBufferFlusher;
     }
 
     //---------------------------------------------------------------
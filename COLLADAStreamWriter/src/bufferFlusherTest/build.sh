@@ -0,0 +1,20 @@
+
+# Builds the buffer flusher test. LIBDIR must point to the directory that contains the static
+# libraries of a regular build of OpenCOLLADA.
+# run: ./bufferFlusherTest [directory]   writes its file to the directory, default .
+
+LIBDIR=${LIBDIR:-../../../build/lib}
+
+OPTIONS="-O2 -Wall -pthread"
+
+INCLUDES="-I../../include -I../../../common/test/include -I../../../COLLADABaseUtils/include -I../../../COLLADABaseUtils/include/Math -I../../../common/libBuffer/include -I../../../common/libftoa/include"
+
+FILES="main.cpp"
+
+LIBS="-L$LIBDIR -lOpenCOLLADAStreamWriter -lOpenCOLLADABaseUtils -lUTF -lbuffer -lftoa -lpcre -lzziplib -lzlib"
+
+OUTPUTFILE="-o bufferFlusherTest"
+
+
+
+g++ $OPTIONS $INCLUDES $FILES $LIBS $OUTPUTFILE
@@ -0,0 +1,232 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAStreamWriter.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+/*
+    Checks COLLADASW::StreamWriter with a user supplied buffer flusher. The same document, that is
+    larger than the character buffer of the stream writer, is written to a file, to a
+    Common::MemoryBufferFlusher and to a Common::CallbackBufferFlusher. The documents passed to
+    the flushers must be identical to the file. The stream writer must refuse a flusher that
+    already reports an error and a MemoryBufferFlusher must accept empty data before it has
+    allocated memory.
+
+    usage: bufferFlusherTest [directory]   writes its file to the directory, default .
+*/
+
+#include "COLLADASWStreamWriter.h"
+#include "COLLADASWException.h"
+#include "COLLADASWLibraryGeometries.h"
+#include "COLLADASWSource.h"
+
+#include "CommonMemoryBufferFlusher.h"
+#include "CommonCallbackBufferFlusher.h"
+
+#include "CommonTestCheck.h"
+
+#include <stdio.h>
+
+#include <string>
+
+
+namespace
+{
+	/** The number of values of the source, enough to flush the character buffer several times.*/
+	const size_t VALUE_COUNT = 3 * 400000;
+
+	const char* MESH_ID = "mesh";
+
+	/** Makes the methods of the library writers, that are protected in COLLADASW, accessible.*/
+	class GeometriesWriter : public COLLADASW::LibraryGeometries
+	{
+	public:
+		GeometriesWriter( COLLADASW::StreamWriter* streamWriter ) : COLLADASW::LibraryGeometries( streamWriter ) {}
+		using COLLADASW::LibraryGeometries::openMesh;
+		using COLLADASW::LibraryGeometries::closeMesh;
+		using COLLADASW::LibraryGeometries::closeLibrary;
+	};
+
+	//------------------------------
+	/** Writes the test document to @a streamWriter.*/
+	void writeDocument( COLLADASW::StreamWriter& streamWriter )
+	{
+		streamWriter.startDocument();
+
+		GeometriesWriter geometries( &streamWriter );
+		geometries.openMesh( MESH_ID );
+
+		const std::string positionsId = std::string( MESH_ID ) + COLLADASW::LibraryGeometries::POSITIONS_SOURCE_ID_SUFFIX;
+		COLLADASW::FloatSourceF source( &streamWriter );
+		source.setId( positionsId );
+		source.setArrayId( positionsId + COLLADASW::LibraryGeometries::ARRAY_ID_SUFFIX );
+		source.setAccessorStride( 3 );
+		source.setAccessorCount( (unsigned long)( VALUE_COUNT / 3 ) );
+		source.getParameterNameList().push_back( "X" );
+		source.getParameterNameList().push_back( "Y" );
+		source.getParameterNameList().push_back( "Z" );
+		source.prepareToAppendValues();
+		for ( size_t i = 0; i < VALUE_COUNT; ++i )
+			source.appendValues( (float)i * 0.125f - 1000.0f );
+		source.finish();
+
+		geometries.closeMesh();
+		geometries.closeLibrary();
+		streamWriter.endDocument();
+	}
+
+	//------------------------------
+	/** Reads the file @a fileName into @a content.
+	@return True on success, false otherwise.*/
+	bool readFile( const std::string& fileName, std::string& content )
+	{
+		FILE* file = fopen( fileName.c_str(), "rb" );
+		if ( !file )
+			return false;
+		content.clear();
+		char buffer[64*1024];
+		size_t bytesRead;
+		while ( ( bytesRead = fread( buffer, 1, sizeof(buffer), file ) ) > 0 )
+			content.append( buffer, bytesRead );
+		bool success = ferror( file ) == 0;
+		fclose( file );
+		return success;
+	}
+
+	//------------------------------
+	/** Callback of the CallbackBufferFlusher, that appends the data to the string @a userData.*/
+	bool appendToString( const char* data, size_t length, void* userData )
+	{
+		((std::string*)userData)->append( data, length );
+		return true;
+	}
+
+	//------------------------------
+	/** Callback of the CallbackBufferFlusher, that always fails.*/
+	bool fail( const char* /*data*/, size_t /*length*/, void* /*userData*/ )
+	{
+		return false;
+	}
+
+	//------------------------------
+	/** Writes the document to a file and returns its content in @a fileContent.*/
+	void checkFile( const std::string& fileName, std::string& fileContent )
+	{
+		try
+		{
+			const COLLADASW::NativeString nativeFileName( fileName );
+			COLLADASW::StreamWriter streamWriter( nativeFileName );
+			writeDocument( streamWriter );
+		}
+		catch ( const COLLADASW::StreamWriterException& )
+		{
+			CHECK( !"could not write the file" );
+			return;
+		}
+		CHECK( readFile( fileName, fileContent ) );
+		// larger than the character buffer of the stream writer
+		CHECK( fileContent.size() > 64*64*1024 );
+	}
+
+	//------------------------------
+	/** Writes the document to a MemoryBufferFlusher and compares it with @a fileContent.*/
+	void checkMemoryBufferFlusher( const std::string& fileContent )
+	{
+		// a small initial capacity, so the memory block has to grow
+		Common::MemoryBufferFlusher flusher( 16 );
+		{
+			COLLADASW::StreamWriter streamWriter( &flusher );
+			writeDocument( streamWriter );
+		}
+		CHECK( flusher.getError() == 0 );
+		CHECK( flusher.getSize() == fileContent.size() );
+		CHECK( std::string( flusher.getData(), flusher.getSize() ) == fileContent );
+
+		// the flusher can be reused after clear()
+		flusher.clear();
+		{
+			COLLADASW::StreamWriter streamWriter( &flusher );
+			writeDocument( streamWriter );
+		}
+		CHECK( std::string( flusher.getData(), flusher.getSize() ) == fileContent );
+	}
+
+	//------------------------------
+	/** Writes the document to a CallbackBufferFlusher and compares it with @a fileContent.*/
+	void checkCallbackBufferFlusher( const std::string& fileContent )
+	{
+		std::string received;
+		{
+			Common::CallbackBufferFlusher flusher( appendToString, &received );
+			{
+				COLLADASW::StreamWriter streamWriter( &flusher );
+				writeDocument( streamWriter );
+			}
+			CHECK( flusher.getError() == 0 );
+		}
+		CHECK( received.size() == fileContent.size() );
+		CHECK( received == fileContent );
+	}
+
+	//------------------------------
+	/** Checks that the stream writer refuses a flusher in an error state.*/
+	void checkFlusherError()
+	{
+		Common::CallbackBufferFlusher flusher( fail );
+		flusher.receiveData( "x", 1 );
+		flusher.flush();
+		CHECK( flusher.getError() != 0 );
+
+		bool thrown = false;
+		try
+		{
+			COLLADASW::StreamWriter streamWriter( &flusher );
+		}
+		catch ( const COLLADASW::StreamWriterException& )
+		{
+			thrown = true;
+		}
+		CHECK( thrown );
+	}
+
+	//------------------------------
+	/** Checks that a MemoryBufferFlusher without memory accepts empty data.*/
+	void checkEmptyData()
+	{
+		Common::MemoryBufferFlusher flusher( 0 );
+		CHECK( flusher.receiveData( 0, 0 ) );
+		CHECK( flusher.getSize() == 0 );
+		CHECK( flusher.getError() == 0 );
+		CHECK( flusher.receiveData( "abc", 3 ) );
+		CHECK( flusher.receiveData( 0, 0 ) );
+		CHECK( flusher.getSize() == 3 );
+		CHECK( std::string( flusher.getData(), flusher.getSize() ) == "abc" );
+	}
+}
+
+
+//------------------------------
+int main( int argc, char** argv )
+{
+	const std::string directory = argc > 1 ? argv[1] : ".";
+	const std::string fileName = directory + "/bufferFlusherTest.dae";
+
+	std::string fileContent;
+	checkFile( fileName, fileContent );
+	if ( !fileContent.empty() )
+	{
+		checkMemoryBufferFlusher( fileContent );
+		checkCallbackBufferFlusher( fileContent );
+	}
+	checkFlusherError();
+	checkEmptyData();
+
+	remove( fileName.c_str() );
+
+	printf( "%d failed checks\n", (int)Common::Test::failureCount );
+	return Common::Test::failureCount == 0 ? 0 : 1;
+}
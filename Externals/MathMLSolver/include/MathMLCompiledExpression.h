@@ -0,0 +1,231 @@
+/******************************************************************************
+Copyright (c) 2007 netAllied GmbH, Tettnang
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __MATHML_COMPILED_EXPRESSION_H__
+#define __MATHML_COMPILED_EXPRESSION_H__
+
+#include "MathMLSolverPrerequisites.h"
+
+#include <vector>
+
+#include "MathMLASTNode.h"
+#include "MathMLASTConstantExpression.h"
+#include "MathMLSymbolTable.h"
+
+
+namespace MathML
+{
+    /** Forward Declaration. */
+    class ErrorHandler;
+    class CompilerVisitor;
+
+    /** An expression compiled into a flat list of register instructions, for evaluating
+    the same expression many times with changing variables.
+    @par The expression is compiled once from an AST, see compile(). Each variable, that is
+    bound to a constant in the symbol table, gets a slot, whose value can be changed with
+    setVariable() without string lookups. Constants are stored in registers at compile time,
+    and every operation writes its own register, so evaluate() is a single loop over the
+    instructions that neither allocates nor calls virtual methods. Function calls reuse their
+    argument lists.
+    @par The results are identical to those of EvaluatorVisitor on the same AST and symbol
+    table, including the types of the values. Errors found while compiling, i.e. unknown
+    variables and functions and wrong argument counts, are reported once by compile() instead
+    of on each evaluation. Division of long values by zero results in 0.
+    @par evaluate() uses registers of the object, so an object must not be evaluated by
+    several threads at once.
+    */
+    class _MATHML_SOLVER_EXPORT CompiledExpression
+    {
+        friend class CompilerVisitor;
+
+    public:
+        /** Slot returned by getVariableSlot() for variables that are not used. */
+        static const unsigned int NO_SLOT;
+
+    private:
+        /** Instruction codes. */
+        enum OpCode
+        {
+            OP_ADD,
+            OP_SUB,
+            OP_MUL,
+            OP_DIV,
+            OP_EQ,
+            OP_NEQ,
+            OP_LTE,
+            OP_GTE,
+            OP_LT,
+            OP_GT,
+            OP_AND,
+            OP_OR,
+            OP_XOR,
+            OP_NEG,
+            OP_NOT,
+            OP_CALL
+        };
+
+        /** A single instruction. The result register is written from the lhs and rhs registers.
+        Unary instructions use lhs only. OP_CALL uses lhs as index of the function call and rhs
+        as the register the result is initialized with, as functions may leave it unchanged.
+        */
+        struct Instruction
+        {
+            OpCode opCode;
+            unsigned int result;
+            unsigned int lhs;
+            unsigned int rhs;
+        };
+
+        /** A value with the same meaning as type and value of a ConstantExpression. */
+        struct Register
+        {
+            double value;
+            AST::ConstantExpression::Type type;
+        };
+
+        /** A call of a function of the symbol table. */
+        struct FunctionCall
+        {
+            /** The function to call. */
+            SymbolTable::FunctionPtr function;
+            /** The registers of the arguments. */
+            std::vector< unsigned int > argumentRegisters;
+            /** The argument values passed to the function. */
+            ScalarList arguments;
+        };
+
+        /** Registers of variables, constants and results of instructions. Register 0 holds
+        the double 0, the value of an empty expression. */
+        std::vector< Register > mRegisters;
+
+        /** The instructions in the order of evaluation. */
+        std::vector< Instruction > mInstructions;
+
+        /** Function calls referenced by OP_CALL instructions. */
+        std::vector< FunctionCall > mFunctionCalls;
+
+        /** Names of the variable slots. */
+        std::vector< String > mVariableNames;
+
+        /** Registers of the variable slots. */
+        std::vector< unsigned int > mVariableRegisters;
+
+        /** Register holding the value of the expression. */
+        unsigned int mResultRegister;
+
+        /** Receives the results of function calls. */
+        AST::ConstantExpression mFunctionResult;
+
+        /** Error handler passed to called functions. */
+        ErrorHandler* mErrorHandler;
+
+    public:
+        /** C-tor. Creates an expression that evaluates to 0. */
+        CompiledExpression();
+
+        /** D-tor. */
+        virtual ~CompiledExpression();
+
+        /** Replaces the expression with @a node compiled for @a symbolTable.
+        Functions are resolved and variables are bound now. The values of variables bound
+        to constants are copied into their slots.
+        @param node The root node of the AST. It is not needed after compiling.
+        @param symbolTable Symbol table holding variables and functions.
+        @param errorHandler Error handler for errors found while compiling and passed to
+        called functions.
+        */
+        void compile( const AST::INode* node, const SymbolTable& symbolTable, ErrorHandler* errorHandler );
+
+        /** Returns the number of variable slots. */
+        unsigned int getVariableCount() const { return static_cast<unsigned int>( mVariableNames.size() ); }
+
+        /** Returns the name of the variable in @a slot. */
+        const String& getVariableName( unsigned int slot ) const { return mVariableNames[ slot ]; }
+
+        /** Returns the slot of the variable @a name or NO_SLOT, if the expression does not use it. */
+        unsigned int getVariableSlot( const String& name ) const;
+
+        /** Sets the value of the variable in @a slot. */
+        void setVariable( unsigned int slot, double value );
+
+        /** Sets the value of the variable in @a slot. */
+        void setVariable( unsigned int slot, long value );
+
+        /** Sets the value of the variable in @a slot. */
+        void setVariable( unsigned int slot, bool value );
+
+        /** Evaluates the expression with the current variable values.
+        @param result Receives the value of the expression.
+        */
+        void evaluate( AST::ConstantExpression& result );
+
+    private:
+
+        /** Disable default copy ctor. */
+        CompiledExpression( const CompiledExpression& pre );
+
+        /** Disable default assignment operator. */
+        const CompiledExpression& operator= ( const CompiledExpression& pre );
+
+        /** Removes all instructions, registers and variables. */
+        void clear();
+
+        /** Appends a register holding the value of @a constant and returns its index. */
+        unsigned int addRegister( const AST::ConstantExpression& constant );
+
+        /** Appends an instruction writing a new register and returns the index of the register. */
+        unsigned int addInstruction( OpCode opCode, unsigned int lhs, unsigned int rhs );
+
+        /** Appends a call of @a function with the arguments in @a argumentRegisters and returns
+        the index of the result register. The result is initialized with @a initialRegister. */
+        unsigned int addFunctionCall( SymbolTable::FunctionPtr function, const std::vector< unsigned int >& argumentRegisters, unsigned int initialRegister );
+
+        /** Returns the register of the variable @a name. A slot initialized with @a value
+        is added, if the variable has none yet. */
+        unsigned int addVariable( const String& name, const AST::ConstantExpression& value );
+
+        /** Writes the result of the arithmetic @a opCode like ConstantExpression does, for
+        operands that are not both doubles. */
+        static void arithmeticOperation( Register& result, const Register& lhs, const Register& rhs, OpCode opCode );
+
+        /** Writes the result of the comparison @a opCode like ConstantExpression does, for
+        operands that are not both doubles. */
+        static void comparisonOperation( Register& result, const Register& lhs, const Register& rhs, OpCode opCode );
+
+        /** Writes the result of the unary @a opCode like ConstantExpression does. */
+        static void unaryOperation( Register& result, const Register& operand, OpCode opCode );
+
+        /** Copies the value of @a source to @a target. */
+        static void copyValue( AST::ConstantExpression& target, const Register& source );
+
+        /** Calls the function with index @a functionCall and writes the result to @a result,
+        which is initialized with @a initialValue. */
+        void callFunction( Register& result, unsigned int functionCall, const Register& initialValue );
+
+    };
+
+} //namespace MathML
+
+#endif //__MATHML_COMPILED_EXPRESSION_H__
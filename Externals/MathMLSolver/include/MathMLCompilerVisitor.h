@@ -0,0 +1,152 @@
+/******************************************************************************
+Copyright (c) 2007 netAllied GmbH, Tettnang
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __MATHML_COMPILER_VISITOR_H__
+#define __MATHML_COMPILER_VISITOR_H__
+
+#include "MathMLSolverPrerequisites.h"
+
+#include <vector>
+
+#include "MathMLASTNode.h"
+#include "MathMLASTArithmeticExpression.h"
+#include "MathMLASTLogicExpression.h"
+#include "MathMLASTBinaryComparisionExpression.h"
+#include "MathMLASTConstantExpression.h"
+#include "MathMLASTUnaryArithmeticExpression.h"
+#include "MathMLASTFragmentExpression.h"
+#include "MathMLASTVariableExpression.h"
+#include "MathMLASTFunctionExpression.h"
+#include "MathMLASTVisitor.h"
+#include "MathMLSymbolTable.h"
+#include "MathMLError.h"
+
+
+namespace MathML
+{
+    /** Forward Declaration. */
+    class ErrorHandler;
+    class CompiledExpression;
+
+    /** Expression node visitor for compiling into a CompiledExpression.
+    @par Appends the instructions of the visited nodes to the compiled expression, in the
+    order EvaluatorVisitor evaluates them. Variables bound to constants in the root symbol
+    table become variable slots. Variables bound to other nodes and fragment parameters are
+    compiled in place, so a fragment is compiled once per use. Recursive definitions are
+    reported as errors and evaluate to 0.
+    Use CompiledExpression::compile() instead of this class directly.
+    */
+
+    class _MATHML_SOLVER_EXPORT CompilerVisitor : public AST::IVisitor
+    {
+
+    private:
+        /** A variable or fragment node that is being compiled, with the symbol table it is compiled with. */
+        typedef std::pair< const AST::INode*, const SymbolTable* > ActiveNode;
+
+        /** List of active nodes. */
+        typedef std::vector< ActiveNode > ActiveNodeList;
+
+        /** The expression receiving the instructions. */
+        CompiledExpression& mExpression;
+
+        /** Symbol table of the current scope. */
+        const SymbolTable& mSymbolTable;
+
+        /** Symbol table passed to the compiler of the root node. */
+        const SymbolTable& mRootSymbolTable;
+
+        /** Error handler. */
+        ErrorHandler* mErrorHandler;
+
+        /** Register holding the value of the last compiled node. */
+        unsigned int mRegister;
+
+        /** Active nodes of the root compiler. */
+        ActiveNodeList mRootActiveNodes;
+
+        /** Variable and fragment nodes that are being compiled, to detect recursion. */
+        ActiveNodeList& mActiveNodes;
+
+    public:
+        /** Creates a new compiler that appends to @a expression and resolves variables and
+        functions with @a symbolTable.
+        */
+        CompilerVisitor( CompiledExpression& expression, const SymbolTable& symbolTable, ErrorHandler* errorHandler );
+
+        /** D-tor. */
+        virtual ~CompilerVisitor();
+
+        // see IVisitor::visit(const ArithmeticExpression&)
+        virtual void visit( const AST::ArithmeticExpression* const node );
+
+        // see IVisitor::visit(const BinaryComparisionExpression&)
+        virtual void visit( const AST::BinaryComparisonExpression* const node );
+
+        // see IVisitor::visit(const FragmentExpression&)
+        virtual void visit( const AST::FragmentExpression* const node );
+
+        // see IVisitor::visit(const LogicExpression&)
+        virtual void visit( const AST::LogicExpression* const node );
+
+        // see IVisitor::visit(const ConstantExpression&)
+        virtual void visit( const AST::ConstantExpression* const node );
+
+        // see IVisitor::visit(const FunctionExpression&)
+        virtual void visit( const AST::FunctionExpression* const node );
+
+        // see IVisitor::visit(const UnaryArithmeticExpression&)
+        virtual void visit( const AST::UnaryExpression* const node );
+
+        // see IVisitor::visit(const VariableExpression&)
+        virtual void visit( const AST::VariableExpression* const node );
+
+        /** Getter for the register holding the value of the last compiled node. */
+        unsigned int getRegister() const { return mRegister; }
+
+    private:
+
+        /** Creates a compiler for the fragment scope @a symbolTable of @a parent. */
+        CompilerVisitor( CompilerVisitor& parent, const SymbolTable& symbolTable );
+
+        /** Disable default copy ctor. */
+        CompilerVisitor( const CompilerVisitor& pre );
+
+        /** Disable default assignment operator. */
+        const CompilerVisitor& operator= ( const CompilerVisitor& pre );
+
+        /** Returns true, if @a node is being compiled with the same variables as in the current
+        scope. Compiling it again would never end, as EvaluatorVisitor would recurse endlessly.
+        */
+        bool isActive( const AST::INode* node ) const;
+
+        /** Reports @a description with @a errorCode to the error handler. */
+        void reportError( Error::ErrorCode errorCode, const String& description );
+
+    };
+
+} //namespace MathML
+
+#endif //__MATHML_COMPILER_VISITOR_H__
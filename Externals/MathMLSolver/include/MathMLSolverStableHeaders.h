@@ -64,6 +64,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "MathMLASTVisitor.h"
 #include "MathMLASTStringVisitor.h"
 #include "MathMLEvaluatorVisitor.h"
+#include "MathMLCompiledExpression.h"
+#include "MathMLCompilerVisitor.h"
 #include "MathMLSerializationVisitor.h"
 #include "MathMLSerializationUtil.h"
 #include "MathMLParserConstants.h"
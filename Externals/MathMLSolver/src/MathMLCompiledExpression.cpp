@@ -0,0 +1,474 @@
+#include "MathMLSolverStableHeaders.h"
+#include "MathMLCompiledExpression.h"
+#include "MathMLCompilerVisitor.h"
+
+namespace MathML
+{
+    //----------------------------------------------------------------------------
+    const unsigned int CompiledExpression::NO_SLOT = static_cast<unsigned int>( -1 );
+
+    //----------------------------------------------------------------------------
+    CompiledExpression::CompiledExpression()
+            : mResultRegister( 0 )
+            , mErrorHandler( 0 )
+    {
+        clear();
+    }
+
+    //----------------------------------------------------------------------------
+    CompiledExpression::~CompiledExpression()
+    {}
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::clear()
+    {
+        mRegisters.clear();
+        mInstructions.clear();
+        mFunctionCalls.clear();
+        mVariableNames.clear();
+        mVariableRegisters.clear();
+        mErrorHandler = 0;
+
+        mResultRegister = addRegister( AST::ConstantExpression( 0. ) );
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::compile( const AST::INode* node, const SymbolTable& symbolTable, ErrorHandler* errorHandler )
+    {
+        clear();
+        mErrorHandler = errorHandler;
+
+        if ( node != 0 )
+        {
+            CompilerVisitor compiler( *this, symbolTable, errorHandler );
+            node->accept( &compiler );
+            mResultRegister = compiler.getRegister();
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    unsigned int CompiledExpression::getVariableSlot( const String& name ) const
+    {
+        for ( size_t i = 0; i < mVariableNames.size(); ++i )
+        {
+            if ( mVariableNames[ i ] == name )
+                return static_cast<unsigned int>( i );
+        }
+
+        return NO_SLOT;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::setVariable( unsigned int slot, double value )
+    {
+        Register& variable = mRegisters[ mVariableRegisters[ slot ] ];
+        variable.value = value;
+        variable.type = AST::ConstantExpression::SCALAR_DOUBLE;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::setVariable( unsigned int slot, long value )
+    {
+        Register& variable = mRegisters[ mVariableRegisters[ slot ] ];
+        variable.value = static_cast<double>( value );
+        variable.type = AST::ConstantExpression::SCALAR_LONG;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::setVariable( unsigned int slot, bool value )
+    {
+        Register& variable = mRegisters[ mVariableRegisters[ slot ] ];
+        variable.value = value ? 1. : 0.;
+        variable.type = AST::ConstantExpression::SCALAR_BOOL;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::evaluate( AST::ConstantExpression& result )
+    {
+        Register* registers = &mRegisters[ 0 ];
+        const Instruction* instruction = mInstructions.empty() ? 0 : &mInstructions[ 0 ];
+        const Instruction* end = instruction + mInstructions.size();
+
+        for ( ; instruction != end; ++instruction )
+        {
+            Register& target = registers[ instruction->result ];
+
+            switch ( instruction->opCode )
+            {
+
+            case OP_ADD:
+                {
+                    const Register& lhs = registers[ instruction->lhs ];
+                    const Register& rhs = registers[ instruction->rhs ];
+                    if ( lhs.type == AST::ConstantExpression::SCALAR_DOUBLE && rhs.type == AST::ConstantExpression::SCALAR_DOUBLE )
+                    {
+                        target.value = lhs.value + rhs.value;
+                        target.type = AST::ConstantExpression::SCALAR_DOUBLE;
+                    }
+                    else
+                    {
+                        arithmeticOperation( target, lhs, rhs, OP_ADD );
+                    }
+                    break;
+                }
+
+            case OP_SUB:
+                {
+                    const Register& lhs = registers[ instruction->lhs ];
+                    const Register& rhs = registers[ instruction->rhs ];
+                    if ( lhs.type == AST::ConstantExpression::SCALAR_DOUBLE && rhs.type == AST::ConstantExpression::SCALAR_DOUBLE )
+                    {
+                        target.value = lhs.value - rhs.value;
+                        target.type = AST::ConstantExpression::SCALAR_DOUBLE;
+                    }
+                    else
+                    {
+                        arithmeticOperation( target, lhs, rhs, OP_SUB );
+                    }
+                    break;
+                }
+
+            case OP_MUL:
+                {
+                    const Register& lhs = registers[ instruction->lhs ];
+                    const Register& rhs = registers[ instruction->rhs ];
+                    if ( lhs.type == AST::ConstantExpression::SCALAR_DOUBLE && rhs.type == AST::ConstantExpression::SCALAR_DOUBLE )
+                    {
+                        target.value = lhs.value * rhs.value;
+                        target.type = AST::ConstantExpression::SCALAR_DOUBLE;
+                    }
+                    else
+                    {
+                        arithmeticOperation( target, lhs, rhs, OP_MUL );
+                    }
+                    break;
+                }
+
+            case OP_DIV:
+                {
+                    const Register& lhs = registers[ instruction->lhs ];
+                    const Register& rhs = registers[ instruction->rhs ];
+                    if ( lhs.type == AST::ConstantExpression::SCALAR_DOUBLE && rhs.type == AST::ConstantExpression::SCALAR_DOUBLE )
+                    {
+                        target.value = lhs.value / rhs.value;
+                        target.type = AST::ConstantExpression::SCALAR_DOUBLE;
+                    }
+                    else
+                    {
+                        arithmeticOperation( target, lhs, rhs, OP_DIV );
+                    }
+                    break;
+                }
+
+            case OP_EQ:
+            case OP_NEQ:
+            case OP_LTE:
+            case OP_GTE:
+            case OP_LT:
+            case OP_GT:
+                comparisonOperation( target, registers[ instruction->lhs ], registers[ instruction->rhs ], instruction->opCode );
+                break;
+
+            case OP_AND:
+                target.value = ( registers[ instruction->lhs ].value != 0. && registers[ instruction->rhs ].value != 0. ) ? 1. : 0.;
+                target.type = AST::ConstantExpression::SCALAR_BOOL;
+                break;
+
+            case OP_OR:
+                target.value = ( registers[ instruction->lhs ].value != 0. || registers[ instruction->rhs ].value != 0. ) ? 1. : 0.;
+                target.type = AST::ConstantExpression::SCALAR_BOOL;
+                break;
+
+            case OP_XOR:
+                target.value = ( ( registers[ instruction->lhs ].value != 0. ) != ( registers[ instruction->rhs ].value != 0. ) ) ? 1. : 0.;
+                target.type = AST::ConstantExpression::SCALAR_BOOL;
+                break;
+
+            case OP_NEG:
+                {
+                    const Register& operand = registers[ instruction->lhs ];
+                    if ( operand.type == AST::ConstantExpression::SCALAR_DOUBLE )
+                    {
+                        target.value = -operand.value;
+                        target.type = AST::ConstantExpression::SCALAR_DOUBLE;
+                    }
+                    else
+                    {
+                        unaryOperation( target, operand, OP_NEG );
+                    }
+                    break;
+                }
+
+            case OP_NOT:
+                unaryOperation( target, registers[ instruction->lhs ], OP_NOT );
+                break;
+
+            case OP_CALL:
+                callFunction( target, instruction->lhs, registers[ instruction->rhs ] );
+                break;
+            }
+        }
+
+        copyValue( result, registers[ mResultRegister ] );
+    }
+
+    //----------------------------------------------------------------------------
+    unsigned int CompiledExpression::addRegister( const AST::ConstantExpression& constant )
+    {
+        Register value;
+        value.value = constant.getDoubleValue();
+        value.type = constant.getType();
+        mRegisters.push_back( value );
+        return static_cast<unsigned int>( mRegisters.size() - 1 );
+    }
+
+    //----------------------------------------------------------------------------
+    unsigned int CompiledExpression::addInstruction( OpCode opCode, unsigned int lhs, unsigned int rhs )
+    {
+        Instruction instruction;
+        instruction.opCode = opCode;
+        instruction.result = addRegister( AST::ConstantExpression( 0. ) );
+        instruction.lhs = lhs;
+        instruction.rhs = rhs;
+        mInstructions.push_back( instruction );
+        return instruction.result;
+    }
+
+    //----------------------------------------------------------------------------
+    unsigned int CompiledExpression::addFunctionCall( SymbolTable::FunctionPtr function, const std::vector< unsigned int >& argumentRegisters, unsigned int initialRegister )
+    {
+        FunctionCall functionCall;
+        functionCall.function = function;
+        functionCall.argumentRegisters = argumentRegisters;
+        functionCall.arguments.resize( argumentRegisters.size() );
+        mFunctionCalls.push_back( functionCall );
+
+        unsigned int index = static_cast<unsigned int>( mFunctionCalls.size() - 1 );
+        return addInstruction( OP_CALL, index, initialRegister );
+    }
+
+    //----------------------------------------------------------------------------
+    unsigned int CompiledExpression::addVariable( const String& name, const AST::ConstantExpression& value )
+    {
+        unsigned int slot = getVariableSlot( name );
+
+        if ( slot != NO_SLOT )
+            return mVariableRegisters[ slot ];
+
+        unsigned int variableRegister = addRegister( value );
+        mVariableNames.push_back( name );
+        mVariableRegisters.push_back( variableRegister );
+        return variableRegister;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::arithmeticOperation( Register& result, const Register& lhs, const Register& rhs, OpCode opCode )
+    {
+        if ( lhs.type == AST::ConstantExpression::SCALAR_INVALID || rhs.type == AST::ConstantExpression::SCALAR_INVALID )
+        {
+            result.value = 0.;
+            result.type = AST::ConstantExpression::SCALAR_DOUBLE;
+            return;
+        }
+
+        // long and long or bool and long operands are calculated as long values, all others as double values
+        if ( lhs.type != AST::ConstantExpression::SCALAR_DOUBLE && rhs.type != AST::ConstantExpression::SCALAR_DOUBLE
+                && ( lhs.type == AST::ConstantExpression::SCALAR_LONG || rhs.type == AST::ConstantExpression::SCALAR_LONG ) )
+        {
+            long lhsValue = static_cast<long>( lhs.value );
+            long rhsValue = static_cast<long>( rhs.value );
+            long value;
+
+            switch ( opCode )
+            {
+
+            case OP_ADD:
+                value = lhsValue + rhsValue;
+                break;
+
+            case OP_SUB:
+                value = lhsValue - rhsValue;
+                break;
+
+            case OP_MUL:
+                value = lhsValue * rhsValue;
+                break;
+
+            default:
+                if ( rhsValue == 0 )
+                {
+                    result.value = 0.;
+                    result.type = AST::ConstantExpression::SCALAR_DOUBLE;
+                    return;
+                }
+                value = lhsValue / rhsValue;
+                break;
+            }
+
+            result.value = static_cast<double>( value );
+            result.type = AST::ConstantExpression::SCALAR_LONG;
+            return;
+        }
+
+        switch ( opCode )
+        {
+
+        case OP_ADD:
+            result.value = lhs.value + rhs.value;
+            break;
+
+        case OP_SUB:
+            result.value = lhs.value - rhs.value;
+            break;
+
+        case OP_MUL:
+            result.value = lhs.value * rhs.value;
+            break;
+
+        default:
+            result.value = lhs.value / rhs.value;
+            break;
+        }
+
+        result.type = AST::ConstantExpression::SCALAR_DOUBLE;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::comparisonOperation( Register& result, const Register& lhs, const Register& rhs, OpCode opCode )
+    {
+        if ( lhs.type == AST::ConstantExpression::SCALAR_INVALID || rhs.type == AST::ConstantExpression::SCALAR_INVALID )
+        {
+            result.value = 0.;
+            result.type = AST::ConstantExpression::SCALAR_DOUBLE;
+            return;
+        }
+
+        bool value;
+
+        if ( lhs.type == AST::ConstantExpression::SCALAR_BOOL || rhs.type == AST::ConstantExpression::SCALAR_BOOL )
+        {
+            // bool values can only be compared for equality with bool values
+            if ( lhs.type != rhs.type || ( opCode != OP_EQ && opCode != OP_NEQ ) )
+            {
+                result.value = 0.;
+                result.type = AST::ConstantExpression::SCALAR_DOUBLE;
+                return;
+            }
+
+            bool equal = static_cast<long>( lhs.value ) == static_cast<long>( rhs.value );
+            value = ( opCode == OP_EQ ) ? equal : !equal;
+        }
+        else
+        {
+            switch ( opCode )
+            {
+
+            case OP_EQ:
+                value = lhs.value == rhs.value;
+                break;
+
+            case OP_NEQ:
+                value = lhs.value != rhs.value;
+                break;
+
+            case OP_LTE:
+                value = lhs.value <= rhs.value;
+                break;
+
+            case OP_GTE:
+                value = lhs.value >= rhs.value;
+                break;
+
+            case OP_LT:
+                value = lhs.value < rhs.value;
+                break;
+
+            default:
+                value = lhs.value > rhs.value;
+                break;
+            }
+        }
+
+        result.value = value ? 1. : 0.;
+        result.type = AST::ConstantExpression::SCALAR_BOOL;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::unaryOperation( Register& result, const Register& operand, OpCode opCode )
+    {
+        switch ( operand.type )
+        {
+
+        case AST::ConstantExpression::SCALAR_BOOL:
+            if ( opCode == OP_NOT )
+            {
+                result.value = ( operand.value != 0. ) ? 0. : 1.;
+                result.type = AST::ConstantExpression::SCALAR_BOOL;
+                return;
+            }
+            break;
+
+        case AST::ConstantExpression::SCALAR_LONG:
+            {
+                long value = static_cast<long>( operand.value );
+                result.value = static_cast<double>( ( opCode == OP_NOT ) ? static_cast<long>( !value ) : -value );
+                result.type = AST::ConstantExpression::SCALAR_LONG;
+                return;
+            }
+
+        case AST::ConstantExpression::SCALAR_DOUBLE:
+            result.value = ( opCode == OP_NOT ) ? ( operand.value != 0. ? 0. : 1. ) : -operand.value;
+            result.type = AST::ConstantExpression::SCALAR_DOUBLE;
+            return;
+
+        default:
+            break;
+        }
+
+        // invalid operands and negated bool values
+        result.value = 0.;
+        result.type = AST::ConstantExpression::SCALAR_DOUBLE;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::copyValue( AST::ConstantExpression& target, const Register& source )
+    {
+        switch ( source.type )
+        {
+
+        case AST::ConstantExpression::SCALAR_BOOL:
+            target.setValue( source.value != 0. );
+            break;
+
+        case AST::ConstantExpression::SCALAR_LONG:
+            target.setValue( static_cast<long>( source.value ) );
+            break;
+
+        case AST::ConstantExpression::SCALAR_DOUBLE:
+            target.setValue( source.value );
+            break;
+
+        default:
+            target = AST::ConstantExpression();
+            break;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::callFunction( Register& result, unsigned int functionCall, const Register& initialValue )
+    {
+        FunctionCall& call = mFunctionCalls[ functionCall ];
+
+        for ( size_t i = 0; i < call.argumentRegisters.size(); ++i )
+        {
+            copyValue( call.arguments[ i ], mRegisters[ call.argumentRegisters[ i ] ] );
+        }
+
+        copyValue( mFunctionResult, initialValue );
+        call.function( mFunctionResult, call.arguments, mErrorHandler );
+
+        result.value = mFunctionResult.getDoubleValue();
+        result.type = mFunctionResult.getType();
+    }
+
+} //namespace MathML
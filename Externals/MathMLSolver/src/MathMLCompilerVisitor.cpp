@@ -0,0 +1,332 @@
+#include "MathMLSolverStableHeaders.h"
+#include "MathMLCompilerVisitor.h"
+#include "MathMLCompiledExpression.h"
+
+namespace MathML
+{
+    //----------------------------------------------------------------------------
+    CompilerVisitor::CompilerVisitor( CompiledExpression& expression, const SymbolTable& symbolTable, ErrorHandler* errorHandler )
+            : mExpression( expression )
+            , mSymbolTable( symbolTable )
+            , mRootSymbolTable( symbolTable )
+            , mErrorHandler( errorHandler )
+            , mRegister( 0 )
+            , mActiveNodes( mRootActiveNodes )
+    {}
+
+    //----------------------------------------------------------------------------
+    CompilerVisitor::CompilerVisitor( CompilerVisitor& parent, const SymbolTable& symbolTable )
+            : mExpression( parent.mExpression )
+            , mSymbolTable( symbolTable )
+            , mRootSymbolTable( parent.mRootSymbolTable )
+            , mErrorHandler( parent.mErrorHandler )
+            , mRegister( 0 )
+            , mActiveNodes( parent.mActiveNodes )
+    {}
+
+    //----------------------------------------------------------------------------
+    CompilerVisitor::~CompilerVisitor()
+    {}
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::ArithmeticExpression* const node )
+    {
+        const AST::NodeList& operands = node->getOperands();
+
+        if ( operands.empty() )
+            return;
+
+        CompiledExpression::OpCode opCode;
+        bool validOperator = true;
+
+        switch ( node->getOperator() )
+        {
+
+        case AST::ArithmeticExpression::ADD:
+            opCode = CompiledExpression::OP_ADD;
+            break;
+
+        case AST::ArithmeticExpression::SUB:
+            opCode = CompiledExpression::OP_SUB;
+            break;
+
+        case AST::ArithmeticExpression::MUL:
+            opCode = CompiledExpression::OP_MUL;
+            break;
+
+        case AST::ArithmeticExpression::DIV:
+            opCode = CompiledExpression::OP_DIV;
+            break;
+
+        default:
+            opCode = CompiledExpression::OP_ADD;
+            validOperator = false;
+            break;
+        }
+
+        // compile first operand, then apply operation with each other operand
+        operands[ 0 ] ->accept( this );
+
+        for ( size_t i = 1; i < operands.size(); ++i )
+        {
+            unsigned int lhs = mRegister;
+            operands[ i ] ->accept( this );
+
+            if ( validOperator )
+                mRegister = mExpression.addInstruction( opCode, lhs, mRegister );
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::BinaryComparisonExpression* const node )
+    {
+        ( node->getLeftOperand() ) ->accept( this );
+        unsigned int lhs = mRegister;
+        ( node->getRightOperand() ) ->accept( this );
+
+        switch ( node->getOperator() )
+        {
+
+        case AST::BinaryComparisonExpression::EQ:
+            mRegister = mExpression.addInstruction( CompiledExpression::OP_EQ, lhs, mRegister );
+            break;
+
+        case AST::BinaryComparisonExpression::NEQ:
+            mRegister = mExpression.addInstruction( CompiledExpression::OP_NEQ, lhs, mRegister );
+            break;
+
+        case AST::BinaryComparisonExpression::LTE:
+            mRegister = mExpression.addInstruction( CompiledExpression::OP_LTE, lhs, mRegister );
+            break;
+
+        case AST::BinaryComparisonExpression::GTE:
+            mRegister = mExpression.addInstruction( CompiledExpression::OP_GTE, lhs, mRegister );
+            break;
+
+        case AST::BinaryComparisonExpression::LT:
+            mRegister = mExpression.addInstruction( CompiledExpression::OP_LT, lhs, mRegister );
+            break;
+
+        case AST::BinaryComparisonExpression::GT:
+            mRegister = mExpression.addInstruction( CompiledExpression::OP_GT, lhs, mRegister );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::FragmentExpression* const node )
+    {
+        AST::INode* fragment = node->getFragment();
+
+        if ( fragment == 0 )
+        {
+            std::ostringstream desc;
+            desc << "Symbol " << node->getName() << " not declared!";
+            reportError( Error::ERR_ITEM_NOT_FOUND, desc.str() );
+            return;
+        }
+
+        if ( isActive( node ) )
+        {
+            reportError( Error::ERR_INVALIDPARAMS, "fragment '" + node->getName() + "' is used recursively!" );
+            mRegister = 0;
+            return;
+        }
+
+        // the parameters are only visible inside the fragment
+        SymbolTable scopeTable = mSymbolTable;
+
+        const AST::FragmentExpression::ParameterMap& params = node->getParameterMap();
+        AST::FragmentExpression::ParameterMap::const_iterator it;
+
+        for ( it = params.begin(); it != params.end(); ++it )
+        {
+            scopeTable.setVariable( it->first, it->second );
+        }
+
+        CompilerVisitor compiler( *this, scopeTable );
+        mActiveNodes.push_back( ActiveNode( node, &mSymbolTable ) );
+        fragment->accept( &compiler );
+        mActiveNodes.pop_back();
+        mRegister = compiler.getRegister();
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::LogicExpression* const node )
+    {
+        const AST::NodeList& operands = node->getOperands();
+
+        if ( operands.empty() )
+            return;
+
+        CompiledExpression::OpCode opCode;
+        bool validOperator = true;
+
+        switch ( node->getOperator() )
+        {
+
+        case AST::LogicExpression::AND:
+            opCode = CompiledExpression::OP_AND;
+            break;
+
+        case AST::LogicExpression::OR:
+            opCode = CompiledExpression::OP_OR;
+            break;
+
+        case AST::LogicExpression::XOR:
+            opCode = CompiledExpression::OP_XOR;
+            break;
+
+        default:
+            opCode = CompiledExpression::OP_AND;
+            validOperator = false;
+            break;
+        }
+
+        // compile first operand, then apply operation with each other operand
+        operands[ 0 ] ->accept( this );
+
+        for ( size_t i = 1; i < operands.size(); ++i )
+        {
+            unsigned int lhs = mRegister;
+            operands[ i ] ->accept( this );
+
+            if ( validOperator )
+                mRegister = mExpression.addInstruction( opCode, lhs, mRegister );
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::ConstantExpression* const node )
+    {
+        mRegister = mExpression.addRegister( *node );
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::FunctionExpression* const node )
+    {
+        const AST::NodeList& params = node->getParameterList();
+        std::vector< unsigned int > argumentRegisters;
+
+        for ( size_t i = 0; i < params.size(); ++i )
+        {
+            params[ i ] ->accept( this );
+            argumentRegisters.push_back( mRegister );
+        }
+
+        const String& name = node->getName();
+
+        // note: getFunction() calls the error handler of the symbol table
+        const SymbolTable::FunctionInfo* functionInfo = mSymbolTable.getFunction( name );
+
+        if ( !functionInfo )
+            return;
+
+        if ( functionInfo->argc < -1 )
+        {
+            reportError( Error::ERR_INVALIDPARAMS, "Unknown function " + name + "()" );
+            return;
+        }
+
+        // a wrong argument count is reported, but the function is called anyway
+        if ( functionInfo->argc == 0 && !params.empty() )
+        {
+            reportError( Error::ERR_INVALIDPARAMS, "Function " + name + "() does not take any parameter." );
+        }
+        else if ( functionInfo->argc == 1 && params.size() != 1 )
+        {
+            reportError( Error::ERR_INVALIDPARAMS, "Function " + name + "() takes exactly one parameter." );
+        }
+        else if ( functionInfo->argc > 1 && static_cast<size_t>( functionInfo->argc ) != params.size() )
+        {
+            std::ostringstream oss;
+            oss << "Function " << name << "() takes exactly " << functionInfo->argc << " parameters.";
+            reportError( Error::ERR_INVALIDPARAMS, oss.str() );
+        }
+
+        mRegister = mExpression.addFunctionCall( functionInfo->func, argumentRegisters, mRegister );
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::UnaryExpression* const node )
+    {
+        ( node->getOperand() ) ->accept( this );
+
+        switch ( node->getOperator() )
+        {
+
+        case AST::UnaryExpression::ADD:
+            //do nothing
+            break;
+
+        case AST::UnaryExpression::SUB:
+            mRegister = mExpression.addInstruction( CompiledExpression::OP_NEG, mRegister, mRegister );
+            break;
+
+        case AST::UnaryExpression::NOT:
+            mRegister = mExpression.addInstruction( CompiledExpression::OP_NOT, mRegister, mRegister );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::VariableExpression* const node )
+    {
+        const String& name = node->getName();
+        AST::INode* variableNode = mSymbolTable.getVariable( name );
+
+        if ( variableNode != 0 )
+        {
+            // constants of the root symbol table become slots, that can be changed between evaluations
+            if ( variableNode->getNodeType() == AST::INode::CONSTANT && variableNode == mRootSymbolTable.getVariable( name ) )
+            {
+                mRegister = mExpression.addVariable( name, *static_cast<const AST::ConstantExpression*>( variableNode ) );
+            }
+            else if ( isActive( node ) )
+            {
+                reportError( Error::ERR_INVALIDPARAMS, "variable '" + name + "' is defined recursively!" );
+                mRegister = 0;
+            }
+            else
+            {
+                mActiveNodes.push_back( ActiveNode( node, &mSymbolTable ) );
+                variableNode->accept( this );
+                mActiveNodes.pop_back();
+            }
+            return;
+        }
+
+        //variable not found, a slot is added anyway, so it can be set later
+        reportError( Error::ERR_INVALIDPARAMS, "variable '" + name + "' could not be found!" );
+        mRegister = mExpression.addVariable( name, AST::ConstantExpression( 0. ) );
+    }
+
+    //----------------------------------------------------------------------------
+    bool CompilerVisitor::isActive( const AST::INode* node ) const
+    {
+        for ( ActiveNodeList::const_iterator it = mActiveNodes.begin(); it != mActiveNodes.end(); ++it )
+        {
+            if ( it->first == node && it->second->getVariables() == mSymbolTable.getVariables() )
+                return true;
+        }
+
+        return false;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::reportError( Error::ErrorCode errorCode, const String& description )
+    {
+        if ( mErrorHandler )
+        {
+            Error err( errorCode, description );
+            mErrorHandler->handleError( &err );
+        }
+    }
+
+} //namespace MathML
@@ -27,6 +27,7 @@
 #include "GeneratedSaxParserNamespaceStack.h"
 #include "GeneratedSaxParserParserError.h"
 #include "GeneratedSaxParserParser.h"
+#include "GeneratedSaxParserIInputStream.h"
 #include "GeneratedSaxParserSaxParser.h"
 #if defined(GENERATEDSAXPARSER_XMLPARSER_LIBXML)
 #include "GeneratedSaxParserLibxmlSaxParser.h"
@@ -32,15 +32,20 @@ namespace GeneratedSaxParser
 		XML_Parser mParser;
 		size_t mBufferSize;
 
+		/** The byte offset behind the markup reported last.*/
+		size_t mMarkupEndOffset;
+
 	public:
 		ExpatSaxParser(Parser* parser, size_t bufferSize);
 		virtual ~ExpatSaxParser();
 
 		bool parseFile(const char* fileName);
 		virtual bool parseBuffer(const char* uri, const char* buffer, int length);
+		virtual bool parseStream(const char* uri, IInputStream& stream);
 
 		size_t getLineNumer()const;
 		size_t getColumnNumer()const;
+		size_t getMarkupEndOffset()const;
 
 	private:
 		/** Disable default copy ctor. */
@@ -0,0 +1,48 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of GeneratedSaxParser.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __GENERATEDSAXPARSER_IINPUTSTREAM_H__
+#define __GENERATEDSAXPARSER_IINPUTSTREAM_H__
+
+#include "GeneratedSaxParserPrerequisites.h"
+
+
+namespace GeneratedSaxParser
+{
+
+	/** Source of a document that is not available as file or as one contiguous buffer, e.g. because
+	it is decompressed while it is parsed. The document is passed to SaxParser::parseStream() block
+	by block.*/
+	class IInputStream
+	{
+	public:
+		IInputStream(){}
+		virtual ~IInputStream(){}
+
+		/** Returns the next block of the document. The block stays valid until getNextBlock() is called
+		again or the stream is destroyed.
+		@param blockSize Receives the number of bytes in the returned block.
+		@return The next block or 0, if the end of the document has been reached or an error occurred.*/
+		virtual const char* getNextBlock( size_t& blockSize ) = 0;
+
+		/** Returns true, if reading the document failed. The stream does not deliver any more blocks
+		after an error.*/
+		virtual bool hasFailed() const = 0;
+
+	private:
+        /** Disable default copy ctor. */
+		IInputStream( const IInputStream& pre );
+        /** Disable default assignment operator. */
+		const IInputStream& operator= ( const IInputStream& pre );
+
+	};
+} // namespace GeneratedSaxParser
+
+#endif // __GENERATEDSAXPARSER_IINPUTSTREAM_H__
@@ -25,19 +25,30 @@ namespace GeneratedSaxParser
 	class LibxmlSaxParser  : public SaxParser
 	{
 	private:
-		static xmlSAXHandler SAXHANDLER;
+		/** The handler all instances start with. It is never passed to libxml directly.*/
+		static const xmlSAXHandler SAXHANDLER;
+
+		/** Copy of SAXHANDLER used by the parser context of this instance. libxml might modify the
+		handler of a context, so sharing one handler between parsers running in different threads
+		is not safe.*/
+		xmlSAXHandler mSaxHandler;
 
 		xmlParserCtxtPtr mParserContext;
 
+		/** True, while the start tag of an element is being reported.*/
+		bool mIsInStartTag;
+
 	public:
 		LibxmlSaxParser(Parser* parser);
 		virtual ~LibxmlSaxParser();
 
 		bool parseFile(const char* fileName);
 		bool parseBuffer(const char* uri, const char* buffer, int length);
+		bool parseStream(const char* uri, IInputStream& stream);
 
 		size_t getLineNumer()const;
 		size_t getColumnNumer()const;
+		size_t getMarkupEndOffset()const;
 
 	private:
         /** Disable default copy ctor. */
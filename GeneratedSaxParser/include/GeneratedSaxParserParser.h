@@ -40,6 +40,8 @@ namespace GeneratedSaxParser
 	protected:
 		size_t getLineNumber()const;
 		size_t getColumnNumber()const;
+		/** @see SaxParser::getMarkupEndOffset()*/
+		size_t getMarkupEndOffset()const;
         SaxParser* getSaxParser() {return mSaxParser;}
 
 	private:
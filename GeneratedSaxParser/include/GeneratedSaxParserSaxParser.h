@@ -17,6 +17,7 @@
 namespace GeneratedSaxParser
 {
 	class Parser;
+	class IInputStream;
 
 	class SaxParser
 	{
@@ -30,9 +31,19 @@ namespace GeneratedSaxParser
 		virtual bool parseFile(const char* fileName)=0;
 		virtual bool parseBuffer(const char* uri, const char* buffer, int length)=0;
 
+		/** Parses the document delivered block by block by @a stream.
+		@param uri The URI associated with the document, used in error messages.*/
+		virtual bool parseStream(const char* uri, IInputStream& stream)=0;
+
 		virtual size_t getLineNumer()const=0;
 		virtual size_t getColumnNumer()const=0;
 
+		/** The byte offset in the document, right behind the markup reported by the current callback.
+		In elementBegin() it is the offset behind the '>' of the start tag, in elementEnd() the offset
+		behind the '>' of the end tag. For empty elements both are the offset behind the "/>". Only 
+		valid within elementBegin() and elementEnd().*/
+		virtual size_t getMarkupEndOffset()const=0;
+
 		Parser* getParser(){return mParser;}
         void setParser( Parser* parser );
 
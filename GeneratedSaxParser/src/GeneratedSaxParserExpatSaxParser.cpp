@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <iostream>
 #include "GeneratedSaxParserParser.h"
+#include "GeneratedSaxParserIInputStream.h"
 
 
 namespace GeneratedSaxParser
@@ -30,6 +31,7 @@ namespace GeneratedSaxParser
 		: SaxParser(parser)
 		, mParser(0)
 		, mBufferSize(bufferSize)
+		, mMarkupEndOffset(0)
 	{
 	}
 
@@ -90,11 +92,36 @@ namespace GeneratedSaxParser
 		return status != XML_STATUS_ERROR;
 	}
 
+	//--------------------------------------------------------------------
+	bool ExpatSaxParser::parseStream( const char* uri, IInputStream& stream )
+	{
+		mParser = XML_ParserCreate(0);
+
+		XML_SetUserData(mParser, this);
+		XML_SetElementHandler(mParser, startElement, endElement);
+		XML_SetCharacterDataHandler(mParser, characters);
+
+		XML_Status status = XML_STATUS_OK;
+		size_t blockSize = 0;
+		const char* block = 0;
+		while ( (status != XML_STATUS_ERROR) && (block = stream.getNextBlock(blockSize)) != 0 )
+		{
+			status = XML_Parse(mParser, block, (int)blockSize, false);
+		}
+		if ( status != XML_STATUS_ERROR )
+			status = XML_Parse(mParser, 0, 0, true);
+
+		XML_ParserFree(mParser);
+
+		return (status != XML_STATUS_ERROR) && !stream.hasFailed();
+	}
+
 	//--------------------------------------------------------------------
 	void ExpatSaxParser::startElement( void* user_data, const XML_Char* name, const XML_Char** attrs )
 	{
 		ExpatSaxParser* thisObject = (ExpatSaxParser*)user_data;
 		Parser* parser = thisObject->getParser();
+		thisObject->mMarkupEndOffset = (size_t)(XML_GetCurrentByteIndex(thisObject->mParser) + XML_GetCurrentByteCount(thisObject->mParser));
 		if ( !parser->elementBegin((const ParserChar*)name, (const ParserChar**)attrs) )
 			thisObject->abortParsing();
 
@@ -105,6 +132,10 @@ namespace GeneratedSaxParser
 	{
 		ExpatSaxParser* thisObject = (ExpatSaxParser*)user_data;
 		Parser* parser = thisObject->getParser();
+		// the end of an empty element has no bytes of its own, it ends where its start tag ends
+		int byteCount = XML_GetCurrentByteCount(thisObject->mParser);
+		if ( byteCount > 0 )
+			thisObject->mMarkupEndOffset = (size_t)(XML_GetCurrentByteIndex(thisObject->mParser) + byteCount);
 		if ( !parser->elementEnd((const ParserChar*)name) )
 			thisObject->abortParsing();
 	}
@@ -132,6 +163,12 @@ namespace GeneratedSaxParser
 		return (size_t) XML_GetCurrentColumnNumber(mParser);
 	}
 
+	//--------------------------------------------------------------------
+	size_t ExpatSaxParser::getMarkupEndOffset() const
+	{
+		return mMarkupEndOffset;
+	}
+
 	//--------------------------------------------------------------------
 	void ExpatSaxParser::abortParsing()
 	{
@@ -14,6 +14,7 @@
 #include "GeneratedSaxParserLibxmlSaxParser.h"
 #include "GeneratedSaxParserParser.h"
 #include "GeneratedSaxParserIErrorHandler.h"
+#include "GeneratedSaxParserIInputStream.h"
 
 #include <libxml/parserInternals.h> // for xmlCreateFileParserCtxt
 
@@ -21,7 +22,7 @@
 namespace GeneratedSaxParser
 {
 
-    xmlSAXHandler LibxmlSaxParser::SAXHANDLER =
+    const xmlSAXHandler LibxmlSaxParser::SAXHANDLER =
 	{
 		0,                 		           //internalSubsetSAXFunc internalSubset;
 		0,                 		           //isStandaloneSAXFunc isStandalone;
@@ -51,10 +52,24 @@ namespace GeneratedSaxParser
 	};
 
 
+	/** xmlInitParser() is not thread safe. It is called implicitly when the first parser context
+	is created, which might happen in several threads at the same time. Calling it during static
+	initialization makes sure it has completed before any thread can create a parser.*/
+	static struct LibxmlInitializer
+	{
+		LibxmlInitializer()
+		{
+			xmlInitParser();
+		}
+	} libxmlInitializer;
+
+
 	//--------------------------------------------------------------------
 	LibxmlSaxParser::LibxmlSaxParser(Parser* parser)
 		: SaxParser(parser),
-		mParserContext(0)
+		mSaxHandler(SAXHANDLER),
+		mParserContext(0),
+		mIsInStartTag(false)
 	{
 	}
 
@@ -96,7 +111,8 @@ namespace GeneratedSaxParser
 				xmlFree(mParserContext->sax);
 			}
 
-			mParserContext->sax = &SAXHANDLER;
+			mSaxHandler = SAXHANDLER;
+			mParserContext->sax = &mSaxHandler;
 			mParserContext->userData = (void*)this;
 
 			initializeParserContext();
@@ -145,7 +161,8 @@ namespace GeneratedSaxParser
             xmlFree(mParserContext->sax);
         }
         
-        mParserContext->sax = &SAXHANDLER;
+        mSaxHandler = SAXHANDLER;
+        mParserContext->sax = &mSaxHandler;
         mParserContext->userData = (void*)this;
         
         initializeParserContext();
@@ -165,6 +182,92 @@ namespace GeneratedSaxParser
         return true;
 	}
 
+	bool LibxmlSaxParser::parseStream( const char* uri, IInputStream& stream )
+	{
+		// libxml detects the encoding from the first bytes, so the first block is passed on
+		// creation of the push parser context
+		size_t blockSize = 0;
+		const char* block = stream.getNextBlock( blockSize );
+
+		mParserContext = xmlCreatePushParserCtxt( 0, 0, block, block ? (int)blockSize : 0, uri );
+
+		if ( !mParserContext || stream.hasFailed() )
+		{
+			if ( mParserContext )
+			{
+				xmlFreeParserCtxt(mParserContext);
+				mParserContext = 0;
+			}
+			ParserError error(ParserError::SEVERITY_CRITICAL,
+							  ParserError::ERROR_COULD_NOT_OPEN_FILE,
+							  0,
+							  0,
+							  0,
+							  0,
+							  uri);
+			IErrorHandler* errorHandler = getParser()->getErrorHandler();
+			if ( errorHandler )
+			{
+				errorHandler->handleError(error);
+			}
+			return false;
+		}
+
+		// We let libxml replace the entities
+		mParserContext->replaceEntities = 1;
+
+		if (mParserContext->sax != (xmlSAXHandlerPtr) &xmlDefaultSAXHandler)
+		{
+			xmlFree(mParserContext->sax);
+		}
+
+		mSaxHandler = SAXHANDLER;
+		mParserContext->sax = &mSaxHandler;
+		mParserContext->userData = (void*)this;
+
+		initializeParserContext();
+
+		// parse block by block, until the stream ends or the parser has been stopped
+		while ( block && !mParserContext->disableSAX )
+		{
+			block = stream.getNextBlock( blockSize );
+			if ( block )
+				xmlParseChunk( mParserContext, block, (int)blockSize, 0 );
+		}
+		if ( !mParserContext->disableSAX )
+			xmlParseChunk( mParserContext, 0, 0, 1 );
+
+		mParserContext->sax = 0;
+
+		if ( mParserContext->myDoc )
+		{
+			xmlFreeDoc(mParserContext->myDoc);
+			mParserContext->myDoc = 0;
+		}
+
+		xmlFreeParserCtxt(mParserContext);
+		mParserContext = 0;
+
+		if ( stream.hasFailed() )
+		{
+			ParserError error(ParserError::SEVERITY_CRITICAL,
+							  ParserError::ERROR_COULD_NOT_OPEN_FILE,
+							  0,
+							  0,
+							  0,
+							  0,
+							  uri);
+			IErrorHandler* errorHandler = getParser()->getErrorHandler();
+			if ( errorHandler )
+			{
+				errorHandler->handleError(error);
+			}
+			return false;
+		}
+
+		return true;
+	}
+
 	void LibxmlSaxParser::initializeParserContext()
 	{
 		mParserContext->linenumbers = true;
@@ -176,8 +279,10 @@ namespace GeneratedSaxParser
 	{
 		LibxmlSaxParser* thisObject = (LibxmlSaxParser*)user_data;
 		Parser* parser = thisObject->getParser();
+		thisObject->mIsInStartTag = true;
 		if ( !parser->elementBegin((const ParserChar*)name, (const ParserChar**)attrs) )
 			thisObject->abortParsing();
+		thisObject->mIsInStartTag = false;
 	}
 
 	void LibxmlSaxParser::endElement( void* user_data, const ::xmlChar* name)
@@ -212,6 +317,21 @@ namespace GeneratedSaxParser
 		return (size_t)xmlSAX2GetColumnNumber(mParserContext);
 	}
 
+	size_t LibxmlSaxParser::getMarkupEndOffset() const
+	{
+		size_t offset = (size_t)xmlByteConsumed(mParserContext);
+		if ( mIsInStartTag )
+		{
+			// libxml reports the start tag before it consumes the closing '>' or "/>"
+			const ::xmlChar* current = mParserContext->input->cur;
+			if ( current[0] == '/' )
+				offset += 2;
+			else if ( current[0] == '>' )
+				offset += 1;
+		}
+		return offset;
+	}
+
 	void LibxmlSaxParser::errorFunction( void *userData, const char *msg, ... )
 	{
         // if msg is just one string, get it. Otherwise ignore it.
@@ -52,4 +52,9 @@ namespace GeneratedSaxParser
 		return mSaxParser ? mSaxParser->getColumnNumer() : 0;
 	}
 
+	size_t Parser::getMarkupEndOffset() const
+	{
+		return mSaxParser ? mSaxParser->getMarkupEndOffset() : 0;
+	}
+
 } // namespace GeneratedSaxParser
@@ -13,11 +13,22 @@
 
 #include "CommonIBufferFlusher.h"
 #include <string.h>
+#include <map>
 
 namespace Common
 {
 	class Buffer 	
 	{
+	public:
+		/** Identifies a slot reserved by reserveUint32(). It is the number of bytes copied to the buffer
+		before the slot.*/
+		typedef size_t ReservedId;
+
+	private:
+		/** Maps the reserved slots that have not been filled yet to the flusher marks set at their
+		position, or to IBufferFlusher::INVALID_ID, if the slot has not been passed to the flusher yet.*/
+		typedef std::map<ReservedId, IBufferFlusher::MarkId> ReservedIdMarkIdMap;
+
 	private:
 		/** Pointer to the buffer.*/
 		char* mBuffer;
@@ -40,8 +51,14 @@ namespace Common
 
 		bool mMarkSet;
 
+		/** The id of the flusher mark set by the last call of startMark().*/
+		IBufferFlusher::MarkId mLastMarkId;
+
 		bool mIsOverwriting;
 
+		/** The reserved slots that have not been filled yet.*/
+		ReservedIdMarkIdMap mReservedSlots;
+
 	public:
 		Buffer(size_t bufferSize, IBufferFlusher* flusher);
 
@@ -103,6 +120,20 @@ namespace Common
 
 	    bool jumpToMark(IBufferFlusher::MarkId markId, bool keepMarkId = false);
 
+		/** Reserves four bytes for an unsigned int, whose value is not known yet, e.g. the length of a
+		chunk that precedes the chunk's content. The slot is filled with zeros until fillReserved() is 
+		called. Slots can be nested and filled in any order. Must not be called after jumping to a mark, 
+		before jumping back to the end of the stream.
+		@return The id of the slot, which is the number of bytes copied to the buffer before the slot.*/
+		ReservedId reserveUint32();
+
+		/** Writes @a value into the slot @a reservedId returned by reserveUint32(). As long as the slot is
+		still in the buffer, it is simply overwritten. Otherwise, the value is written through a flusher 
+		mark, that has been set at the slot's position when the slot was passed to the flusher. Like 
+		reserveUint32(), it must not be called while overwriting data after jumping to a mark.
+		@return True on success, false otherwise.*/
+		bool fillReserved( ReservedId reservedId, unsigned int value );
+
 	protected:
 
 		/** Provides access to the current position of the buffer for derived classes. Might be useful for 
@@ -126,6 +157,10 @@ namespace Common
 		const Buffer& operator= ( const Buffer& pre );
 
 		bool sendDataToFlusher( const char* buffer, size_t length);
+
+		/** Passes the content of the buffer to the flusher. A flusher mark is set at the position of each
+		reserved slot, that has not been filled yet.*/
+		bool sendBufferToFlusher();
 	};
 
 
@@ -0,0 +1,104 @@
+/*
+    Copyright (c) 2009 NetAllied Systems GmbH
+
+    This file is part of Common libBuffer.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COMMON_CALLBACKBUFFERFLUSHER_H__
+#define __COMMON_CALLBACKBUFFERFLUSHER_H__
+
+#include "CommonIBufferFlusher.h"
+
+#include <map>
+#include <vector>
+
+
+namespace Common
+{
+	/** Flusher that passes the received data to a user supplied function, e.g. to send it to a socket.
+	The data is passed in stream order and every byte is passed exactly once.
+	Since data that has been passed to the function can not be overwritten, the data received after
+	a mark has been set is held in memory, until no mark refers to it any more.*/
+	class CallbackBufferFlusher : public IBufferFlusher
+	{
+	public:
+		/** The function that receives the data.
+		@param data The data.
+		@param length The number of bytes starting at @a data.
+		@param userData The pointer passed to the constructor.
+		@return True on success, false otherwise. Once false has been returned, the function is not
+		called any more.*/
+		typedef bool (*Callback)( const char* data, size_t length, void* userData );
+
+	private:
+		typedef std::map<MarkId, size_t> MarkIdToPosition;
+
+	private:
+		/** The function that receives the data.*/
+		Callback mCallback;
+
+		/** Passed to mCallback.*/
+		void* mUserData;
+
+		/** The error code. 0 on success, EIO if mCallback failed.*/
+		int mError;
+
+		/** Data not yet passed to mCallback. mHeldData[0] is the byte at stream position mHeldDataStart.*/
+		std::vector<char> mHeldData;
+
+		/** The stream position of the first held byte, i.e. the number of bytes passed to mCallback.*/
+		size_t mHeldDataStart;
+
+		/** The stream position receiveData() writes to.*/
+		size_t mWritePosition;
+
+		MarkId mLastMarkId;
+
+		/** The stream positions of all marks that can still be jumped to.*/
+		MarkIdToPosition mMarkIds;
+
+	public:
+		/** Constructor.
+		@param callback The function that receives the data.
+		@param userData Passed to @a callback.*/
+		CallbackBufferFlusher( Callback callback, void* userData = 0 );
+
+		/** Destructor. Passes all held data to the callback.*/
+		virtual ~CallbackBufferFlusher();
+
+		/** The error code. 0 on success, EIO if the callback failed.*/
+		int getError() const { return mError; }
+
+		/** Receives and handles @a length bytes starting at @a buffer.
+		@return True on success, false otherwise.*/
+		virtual bool receiveData( const char* buffer, size_t length);
+
+		/** Passes all held data, that is not referenced by a mark, to the callback.*/
+		virtual bool flush();
+
+		void startMark();
+
+		IBufferFlusher::MarkId endMark();
+
+		bool jumpToMark(IBufferFlusher::MarkId markId, bool keepMarkId = false);
+
+	private:
+        /** Disable default copy ctor. */
+		CallbackBufferFlusher( const CallbackBufferFlusher& pre );
+        /** Disable default assignment operator. */
+		const CallbackBufferFlusher& operator= ( const CallbackBufferFlusher& pre );
+
+		/** Passes @a length bytes starting at @a data to the callback.*/
+		bool passData( const char* data, size_t length );
+
+		/** Passes the held data up to the write position or the oldest mark to the callback.*/
+		bool passHeldData();
+
+	};
+} // namespace COMMON
+
+#endif // __COMMON_CALLBACKBUFFERFLUSHER_H__
@@ -0,0 +1,99 @@
+/*
+    Copyright (c) 2009 NetAllied Systems GmbH
+
+    This file is part of Common libBuffer.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COMMON_MEMORYBUFFERFLUSHER_H__
+#define __COMMON_MEMORYBUFFERFLUSHER_H__
+
+#include "CommonIBufferFlusher.h"
+
+#include <map>
+
+
+namespace Common
+{
+	/** Flusher that collects all received data in a memory block, that grows as needed. The data can
+	be accessed with getData() and getSize(), e.g. to send a document without writing it to disk.
+	Jumping to a mark overwrites the data in memory.*/
+	class MemoryBufferFlusher : public IBufferFlusher
+	{
+	public:
+		/** The default initial capacity of the memory block.*/
+		static const size_t DEFAULT_INITIAL_CAPACITY = 64*1024;
+
+	private:
+		typedef std::map<MarkId, size_t> MarkIdToPosition;
+
+	private:
+		/** The received data.*/
+		char* mData;
+
+		/** The size of the memory block mData points to.*/
+		size_t mCapacity;
+
+		/** The number of bytes received, i.e. the size of the data.*/
+		size_t mSize;
+
+		/** The position the next received byte is written to.*/
+		size_t mWritePosition;
+
+		/** The error code. 0 on success, ENOMEM if the memory block could not be enlarged.*/
+		int mError;
+
+		MarkId mLastMarkId;
+
+		MarkIdToPosition mMarkIds;
+
+	public:
+		/** Constructor.
+		@param initialCapacity The number of bytes allocated up front.*/
+		MemoryBufferFlusher( size_t initialCapacity = DEFAULT_INITIAL_CAPACITY );
+
+		/** Destructor. Frees the data.*/
+		virtual ~MemoryBufferFlusher();
+
+		/** The error code. 0 on success, ENOMEM if the memory block could not be enlarged.*/
+		int getError() const { return mError; }
+
+		/** The received data. Only valid until the next call of receiveData() or clear().*/
+		const char* getData() const { return mData; }
+
+		/** The number of bytes received.*/
+		size_t getSize() const { return mSize; }
+
+		/** Discards all received data and all marks. The memory block is kept for reuse.*/
+		void clear();
+
+		/** Receives and handles @a length bytes starting at @a buffer.
+		@return True on success, false otherwise.*/
+		virtual bool receiveData( const char* buffer, size_t length);
+
+		/** Does nothing, the data is already in memory.*/
+		virtual bool flush();
+
+		void startMark();
+
+		IBufferFlusher::MarkId endMark();
+
+		bool jumpToMark(IBufferFlusher::MarkId markId, bool keepMarkId = false);
+
+	private:
+        /** Disable default copy ctor. */
+		MemoryBufferFlusher( const MemoryBufferFlusher& pre );
+        /** Disable default assignment operator. */
+		const MemoryBufferFlusher& operator= ( const MemoryBufferFlusher& pre );
+
+		/** Enlarges the memory block to at least @a capacity bytes.
+		@return True on success, false otherwise.*/
+		bool reserve( size_t capacity );
+
+	};
+} // namespace COMMON
+
+#endif // __COMMON_MEMORYBUFFERFLUSHER_H__
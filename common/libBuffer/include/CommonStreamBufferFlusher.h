@@ -13,12 +13,16 @@
 
 #include "CommonIBufferFlusher.h"
 #include <fstream>
+#include <map>
 
 
 namespace Common
 {
 	class StreamBufferFlusher : public IBufferFlusher	
 	{
+	private:
+		typedef std::map<MarkId, std::streampos> MarkIdToStreamPos;
+
 	private:
 		/** The stream to write the data to.*/
 		std::ofstream mStream;
@@ -29,6 +33,10 @@ namespace Common
 		/** The buffer of the stream.*/
 		char *mBuffer;
 
+		MarkId mLastMarkId;
+
+		MarkIdToStreamPos mMarkIds;
+
 	public:
 		StreamBufferFlusher(const char* fileName, size_t bufferSize);
 		virtual ~StreamBufferFlusher();
@@ -40,6 +48,14 @@ namespace Common
 		/** Flushes all the data previously received by receiveData.*/
 		virtual bool flush();
 
+		/** Returns 0, if the stream is good, 1 otherwise.*/
+		int getError() const;
+
+		void startMark();
+
+		IBufferFlusher::MarkId endMark();
+
+		bool jumpToMark(IBufferFlusher::MarkId markId, bool keepMarkId = false);
 
 	private:
         /** Disable default copy ctor. */
@@ -13,5 +13,10 @@
 
 void performanceTest();
 
+/** Writes the same data with back-patched marks through each flusher and compares the files with the
+output of FWriteBufferFlusher.
+@return True, if all files are equal, false otherwise.*/
+bool correctnessTest();
+
 
 #endif // ___PERFORMANCETEST_H__
@@ -0,0 +1,20 @@
+/*
+    Copyright (c) 2009 NetAllied Systems GmbH
+
+    This file is part of Common libBuffer.
+	
+    Licensed under the MIT Open Source License, 
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COMMON_RESERVEDSLOTUNITTEST_H__
+#define __COMMON_RESERVEDSLOTUNITTEST_H__
+
+/** Writes nested chunks, whose lengths are reserved with Buffer::reserveUint32() and filled with
+Buffer::fillReserved(), and compares the flushed data with the expected bytes.
+@return True, if all checks passed, false otherwise.*/
+bool reservedSlotUnitTest();
+
+
+#endif // __COMMON_RESERVEDSLOTUNITTEST_H__
@@ -13,6 +13,10 @@
 
 namespace Common
 {
+	// definitions of the in-class initialized constants of IBufferFlusher, needed if they are odr-used
+	const IBufferFlusher::MarkId IBufferFlusher::END_OF_STREAM;
+	const IBufferFlusher::MarkId IBufferFlusher::INVALID_ID;
+
 	//--------------------------------------------------------------------
 	Buffer::Buffer( size_t bufferSize, IBufferFlusher* flusher )
 		: mBuffer( new char[bufferSize] )
@@ -22,6 +26,7 @@ namespace Common
 		, mBytesFlushed(0)
 		, mFlusher(flusher)
 		, mMarkSet(false)
+		, mLastMarkId(IBufferFlusher::INVALID_ID)
 		, mIsOverwriting(false)
 	{
 
@@ -44,7 +49,7 @@ namespace Common
 		}
 
 		// flush the buffer
-		bool success = sendDataToFlusher( mBuffer, getBytesUsed() );
+		bool success = sendBufferToFlusher();
 
 		// reset the buffer
 		mCurrentPos = mBuffer;
@@ -122,6 +127,8 @@ namespace Common
 		flushBuffer();
 		mMarkSet = true;
 		mFlusher->startMark();
+		// reserved slots also set flusher marks, so we need to remember the id of this one
+		mLastMarkId = mFlusher->endMark();
 
 		return true;
 	}
@@ -135,7 +142,7 @@ namespace Common
 
 		mMarkSet = false;
 		flushBuffer();
-		return mFlusher->endMark();
+		return mLastMarkId;
 	}
 
 	//------------------------------
@@ -169,4 +176,84 @@ namespace Common
 		return mFlusher->receiveData( buffer, length );
 	}
 
+	//------------------------------
+	bool Buffer::sendBufferToFlusher()
+	{
+		if ( mReservedSlots.empty() || mIsOverwriting )
+		{
+			return sendDataToFlusher( mBuffer, getBytesUsed() );
+		}
+
+		// slots not yet passed to the flusher are the ones at or behind the first byte in the buffer
+		size_t bufferStart = mBytesFlushed;
+		const char* dataStart = mBuffer;
+		ReservedIdMarkIdMap::iterator it = mReservedSlots.lower_bound( bufferStart );
+		for ( ; it != mReservedSlots.end(); ++it )
+		{
+			const char* slotPos = mBuffer + (it->first - bufferStart);
+			if ( slotPos > dataStart )
+			{
+				if ( !sendDataToFlusher( dataStart, slotPos - dataStart ) )
+				{
+					return false;
+				}
+				dataStart = slotPos;
+			}
+			mFlusher->startMark();
+			it->second = mFlusher->endMark();
+		}
+		return sendDataToFlusher( dataStart, mCurrentPos - dataStart );
+	}
+
+	//------------------------------
+	Buffer::ReservedId Buffer::reserveUint32()
+	{
+		static const unsigned int placeholder = 0;
+		static const size_t slotSize = sizeof(placeholder);
+
+		if ( getBytesAvailable() < slotSize )
+		{
+			flushBuffer();
+		}
+
+		// the slot is always copied into the buffer, regardless of the direct flush size, so it can be
+		// filled in memory as long as it has not been flushed
+		ReservedId reservedId = getBytesCopiedToBuffer();
+		memcpy( mCurrentPos, &placeholder, slotSize );
+		mCurrentPos += slotSize;
+		mReservedSlots.insert( ReservedIdMarkIdMap::value_type( reservedId, IBufferFlusher::INVALID_ID ) );
+		return reservedId;
+	}
+
+	//------------------------------
+	bool Buffer::fillReserved( ReservedId reservedId, unsigned int value )
+	{
+		ReservedIdMarkIdMap::iterator it = mReservedSlots.find( reservedId );
+		if ( it == mReservedSlots.end() )
+		{
+			return false;
+		}
+		IBufferFlusher::MarkId markId = it->second;
+		mReservedSlots.erase( it );
+
+		if ( reservedId >= mBytesFlushed )
+		{
+			// the slot is still in the buffer
+			memcpy( mBuffer + (reservedId - mBytesFlushed), &value, sizeof(value) );
+			return true;
+		}
+
+		// the slot has already been passed to the flusher
+		if ( !flushBuffer() )
+		{
+			return false;
+		}
+		if ( !mFlusher->jumpToMark( markId ) )
+		{
+			return false;
+		}
+		bool success = mFlusher->receiveData( (const char*)&value, sizeof(value) );
+		return mFlusher->jumpToMark( IBufferFlusher::END_OF_STREAM ) && success;
+	}
+
 } // namespace Common
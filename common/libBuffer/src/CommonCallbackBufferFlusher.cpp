@@ -0,0 +1,143 @@
+/*
+    Copyright (c) 2009 NetAllied Systems GmbH
+
+    This file is part of Common libBuffer.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "CommonCallbackBufferFlusher.h"
+
+#include <cerrno>
+#include <cstring>
+
+namespace Common
+{
+	//--------------------------------------------------------------------
+	CallbackBufferFlusher::CallbackBufferFlusher( Callback callback, void* userData )
+		: mCallback(callback)
+		, mUserData(userData)
+		, mError(0)
+		, mHeldDataStart(0)
+		, mWritePosition(0)
+		, mLastMarkId(END_OF_STREAM)
+	{
+	}
+
+	//--------------------------------------------------------------------
+	CallbackBufferFlusher::~CallbackBufferFlusher()
+	{
+		// marks can not be jumped to any more, so all the data is final
+		mMarkIds.clear();
+		mWritePosition = mHeldDataStart + mHeldData.size();
+		passHeldData();
+	}
+
+	//--------------------------------------------------------------------
+	bool CallbackBufferFlusher::receiveData( const char* buffer, size_t length )
+	{
+		if ( mHeldData.empty() && mMarkIds.empty() )
+		{
+			// nothing can be overwritten, pass the data right away
+			mWritePosition += length;
+			mHeldDataStart += length;
+			return passData( buffer, length );
+		}
+
+		size_t offset = mWritePosition - mHeldDataStart;
+		if ( mHeldData.size() < offset + length )
+		{
+			mHeldData.resize( offset + length );
+		}
+		if ( length > 0 )
+		{
+			memcpy( &mHeldData[offset], buffer, length );
+		}
+		mWritePosition += length;
+		return mError == 0;
+	}
+
+	//--------------------------------------------------------------------
+	bool CallbackBufferFlusher::flush()
+	{
+		return passHeldData();
+	}
+
+	//------------------------------
+	void CallbackBufferFlusher::startMark()
+	{
+		mLastMarkId++;
+		mMarkIds.insert( std::make_pair( mLastMarkId, mWritePosition ) );
+	}
+
+	//------------------------------
+	IBufferFlusher::MarkId CallbackBufferFlusher::endMark()
+	{
+		return mLastMarkId;
+	}
+
+	//------------------------------
+	bool CallbackBufferFlusher::jumpToMark( IBufferFlusher::MarkId markId, bool keepMarkId /*= false*/ )
+	{
+		if ( markId == END_OF_STREAM )
+		{
+			mWritePosition = mHeldDataStart + mHeldData.size();
+			// data held only because of the jump can be passed now
+			return passHeldData();
+		}
+
+		MarkIdToPosition::iterator markIdIt = mMarkIds.find( markId );
+		if ( markIdIt == mMarkIds.end() )
+		{
+			return false;
+		}
+		mWritePosition = markIdIt->second;
+		if ( !keepMarkId )
+		{
+			mMarkIds.erase( markIdIt );
+		}
+		return passHeldData();
+	}
+
+	//--------------------------------------------------------------------
+	bool CallbackBufferFlusher::passData( const char* data, size_t length )
+	{
+		if ( mError != 0 )
+		{
+			return false;
+		}
+		if ( length > 0 && !mCallback( data, length, mUserData ) )
+		{
+			mError = EIO;
+			return false;
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool CallbackBufferFlusher::passHeldData()
+	{
+		// data behind the write position or a mark might still be overwritten
+		size_t limit = mWritePosition;
+		for ( MarkIdToPosition::const_iterator it = mMarkIds.begin(); it != mMarkIds.end(); ++it )
+		{
+			if ( it->second < limit )
+			{
+				limit = it->second;
+			}
+		}
+
+		size_t length = limit - mHeldDataStart;
+		if ( length == 0 )
+		{
+			return mError == 0;
+		}
+		bool success = passData( &mHeldData[0], length );
+		mHeldData.erase( mHeldData.begin(), mHeldData.begin() + length );
+		mHeldDataStart = limit;
+		return success;
+	}
+
+} // namespace Common
@@ -0,0 +1,135 @@
+/*
+    Copyright (c) 2009 NetAllied Systems GmbH
+
+    This file is part of Common libBuffer.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "CommonMemoryBufferFlusher.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace Common
+{
+	//--------------------------------------------------------------------
+	MemoryBufferFlusher::MemoryBufferFlusher( size_t initialCapacity )
+		: mData(0)
+		, mCapacity(0)
+		, mSize(0)
+		, mWritePosition(0)
+		, mError(0)
+		, mLastMarkId(END_OF_STREAM)
+	{
+		reserve( initialCapacity );
+	}
+
+	//--------------------------------------------------------------------
+	MemoryBufferFlusher::~MemoryBufferFlusher()
+	{
+		free( mData );
+	}
+
+	//--------------------------------------------------------------------
+	void MemoryBufferFlusher::clear()
+	{
+		mSize = 0;
+		mWritePosition = 0;
+		mError = 0;
+		mMarkIds.clear();
+	}
+
+	//--------------------------------------------------------------------
+	bool MemoryBufferFlusher::reserve( size_t capacity )
+	{
+		if ( capacity <= mCapacity )
+		{
+			return true;
+		}
+
+		// grow geometrically, so appending is amortized constant time
+		size_t newCapacity = mCapacity * 2;
+		if ( newCapacity < capacity )
+		{
+			newCapacity = capacity;
+		}
+
+		char* newData = (char*)realloc( mData, newCapacity );
+		if ( !newData )
+		{
+			mError = ENOMEM;
+			return false;
+		}
+		mData = newData;
+		mCapacity = newCapacity;
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool MemoryBufferFlusher::receiveData( const char* buffer, size_t length )
+	{
+		if ( length == 0 )
+		{
+			// mData might still be null, which memcpy must not be passed
+			return true;
+		}
+		size_t endPosition = mWritePosition + length;
+		if ( !reserve( endPosition ) )
+		{
+			return false;
+		}
+		memcpy( mData + mWritePosition, buffer, length );
+		mWritePosition = endPosition;
+		if ( mWritePosition > mSize )
+		{
+			mSize = mWritePosition;
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool MemoryBufferFlusher::flush()
+	{
+		return mError == 0;
+	}
+
+	//------------------------------
+	void MemoryBufferFlusher::startMark()
+	{
+		mLastMarkId++;
+		mMarkIds.insert( std::make_pair( mLastMarkId, mWritePosition ) );
+	}
+
+	//------------------------------
+	IBufferFlusher::MarkId MemoryBufferFlusher::endMark()
+	{
+		return mLastMarkId;
+	}
+
+	//------------------------------
+	bool MemoryBufferFlusher::jumpToMark( IBufferFlusher::MarkId markId, bool keepMarkId /*= false*/ )
+	{
+		if ( markId == END_OF_STREAM )
+		{
+			mWritePosition = mSize;
+			return true;
+		}
+
+		MarkIdToPosition::iterator markIdIt = mMarkIds.find( markId );
+		if ( markIdIt == mMarkIds.end() )
+		{
+			return false;
+		}
+		mWritePosition = markIdIt->second;
+		if ( !keepMarkId )
+		{
+			mMarkIds.erase( markIdIt );
+		}
+		return true;
+	}
+
+} // namespace Common
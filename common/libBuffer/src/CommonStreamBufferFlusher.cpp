@@ -16,6 +16,8 @@ namespace Common
 	StreamBufferFlusher::StreamBufferFlusher( const char* fileName, size_t bufferSize )
 		: mBufferSize(bufferSize)
 		, mBuffer( new char[mBufferSize] )
+		, mLastMarkId(END_OF_STREAM)
+		, mMarkIds()
 	{
 		mStream.rdbuf()->pubsetbuf ( mBuffer, (std::streamsize)mBufferSize );
 		mStream.open ( fileName );
@@ -42,5 +44,46 @@ namespace Common
 		return !mStream.bad(); 
 	}
 
+	//--------------------------------------------------------------------
+	int StreamBufferFlusher::getError() const
+	{
+		return ( mStream.is_open() && mStream.good() ) ? 0 : 1;
+	}
+
+	//------------------------------
+	void StreamBufferFlusher::startMark()
+	{
+		mLastMarkId++;
+		mMarkIds.insert( std::make_pair( mLastMarkId, mStream.tellp() ) );
+	}
+
+	//------------------------------
+	IBufferFlusher::MarkId StreamBufferFlusher::endMark()
+	{
+		return mLastMarkId;
+	}
+
+	//------------------------------
+	bool StreamBufferFlusher::jumpToMark( IBufferFlusher::MarkId markId, bool keepMarkId /*= false*/ )
+	{
+		if ( markId == END_OF_STREAM )
+		{
+			mStream.seekp( 0, std::ios_base::end );
+			return !mStream.fail();
+		}
+
+		MarkIdToStreamPos::iterator markIdIt = mMarkIds.find( markId );
+		if ( markIdIt == mMarkIds.end() )
+		{
+			return false;
+		}
+		mStream.seekp( markIdIt->second );
+		if ( !keepMarkId )
+		{
+			mMarkIds.erase( markIdIt );
+		}
+		return !mStream.fail();
+	}
+
 
 } // namespace Common
@@ -1,13 +1,17 @@
 
-OPTIONS="-O3 -Wall"
+OPTIONS="-O3 -Wall -pthread"
 
-INCLUDES="-I../../include -I../../include/performanceTest -I../../../libftoa/include"
+INCLUDES="-I../../include -I../../include/performanceTest -I../../../libftoa/include -I../../../../COLLADABaseUtils/include -I../../../../COLLADABaseUtils/include/Math -I../../../../COLLADAStreamWriter/include -I../../../../Externals/UTF/include"
 
 BUFFERFILES="main.cpp performanceTest.cpp ../CommonBuffer.cpp ../CommonFWriteBufferFlusher.cpp ../CommonCharacterBuffer.cpp ../CommonStreamBufferFlusher.cpp "
 
-FTOAFILES="../../../libftoa/src/Commondtoa.cpp ../../../libftoa/src/Commonftoa.cpp"
+FTOAFILES="../../../libftoa/src/Commondtoa.cpp ../../../libftoa/src/Commonftoa.cpp ../../../libftoa/src/Commonitoa.cpp "
 
-FILES=$BUFFERFILES$FTOAFILES
+ASYNCFILES="../../../../COLLADAStreamWriter/src/COLLADASWAsyncFileBufferFlusher.cpp ../../../../COLLADABaseUtils/src/COLLADABUThread.cpp "
+
+UTFFILES="../../../../Externals/UTF/src/ConvertUTF.c"
+
+FILES=$BUFFERFILES$FTOAFILES$ASYNCFILES$UTFFILES
 
 OUTPUTFILE="-o performanceTest"
 
@@ -16,6 +16,10 @@
 int main()
 {
 	unsigned int i = 0xFFFFFFFF;
+	if ( !correctnessTest() )
+	{
+		return 1;
+	}
 	performanceTest();
 
 	return 0;
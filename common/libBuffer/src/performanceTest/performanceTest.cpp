@@ -2,8 +2,8 @@
     Copyright (c) 2009 NetAllied Systems GmbH
 
     This file is part of Common libBuffer.
-	
-    Licensed under the MIT Open Source License, 
+
+    Licensed under the MIT Open Source License,
     for details please see LICENSE file or the website
     http://www.opensource.org/licenses/mit-license.php
 */
@@ -13,13 +13,15 @@
 #include "CommonCharacterBuffer.h"
 #include "CommonFWriteBufferFlusher.h"
 #include "CommonStreamBufferFlusher.h"
+#include "COLLADASWAsyncFileBufferFlusher.h"
 #include "math.h"
 
 #include <iostream>
+#include <vector>
  #include <errno.h>
 
 #include <sys/types.h>
-#include <sys/timeb.h> 
+#include <sys/timeb.h>
 
 
 #ifdef WIN32
@@ -29,39 +31,30 @@
 #endif
 
 
+const size_t BUFFERSIZE = /*1024**/1024*64;
 
-void performanceTest()
-{
-
-	const size_t BUFFERSIZE = /*1024**/1024*64;
-	char *mBuffer = new char[BUFFERSIZE];
-	FILE* stream;
-	std::string mLocale = setlocale(LC_NUMERIC, 0);
-	setlocale(LC_NUMERIC, "C");
+const size_t ITERATIONS = 20000000;
 
 
+double getTime()
+{
 #ifdef WIN32
-	char fileNameBuffer[] = "c:\\temp\\testBuffer.txt";
-	char fileNameFwrite[] = "c:\\temp\\testFwrite.txt";
-#else
-	char fileNameBuffer[] = "/tmp/testBuffer.txt";
-	char fileNameFwrite[] = "/tmp/testFwrite.txt";
-#endif
-	
-	int error = 0;
-#ifdef WIN32
-	error = fopen_s ( &stream, fileNameFwrite, "wb" );
+#pragma warning(disable: 4996)
+	_timeb timeBuffer;
+	_ftime( &timeBuffer );
+#pragma warning(default: 4996)
 #else
-    stream = fopen( fileNameBuffer, "wb" );
-	error = stream ? 0 : errno;
+	timeb timeBuffer;
+	ftime( &timeBuffer );
 #endif
-
-	bool failed = ( setvbuf ( stream , mBuffer, _IOFBF, BUFFERSIZE ) != 0 );
+	return (double)timeBuffer.time + (double)timeBuffer.millitm / 1000;
+}
 
 
-
-	Common::FWriteBufferFlusher bufferFlusher(fileNameBuffer, BUFFERSIZE);
-//	Common::StreamBufferFlusher bufferFlusher(fileNameBuffer, BUFFERSIZE);
+/** Formats ITERATIONS numbers into a character buffer, that is flushed by @a bufferFlusher, and returns
+the time elapsed, including the time required to flush all data.*/
+double measure( Common::IBufferFlusher& bufferFlusher )
+{
 	Common::CharacterBuffer buffer(64*BUFFERSIZE, &bufferFlusher);
 	buffer.setDirectFlushSize( 40 );
 
@@ -76,59 +69,217 @@ void performanceTest()
 
 	int testInt = 123;
 
+	double startTime = getTime();
+
+	for ( size_t i= 0; i < ITERATIONS; ++i)
+	{
+//		buffer.copyToBufferAsChar( testDouble );
+
+//		buffer.copyToBufferAsChar( testInt );
+
+//		buffer.copyToBuffer( testString, sizeof(testString)-1);
+//		buffer.copyToBuffer( testChar);
+
+		buffer.copyToBufferAsChar( testFloat );
+		buffer.copyToBuffer( ' ' );
+	}
+	buffer.flushFlusher();
+
+	return getTime() - startTime;
+}
+
+
+/** Writes the same numbers with fprintf, for comparison.*/
+double measureFprintf( const char* fileName )
+{
+	char *mBuffer = new char[BUFFERSIZE];
+	FILE* stream;
+	int error = 0;
 #ifdef WIN32
-#pragma warning(disable: 4996)
-	_timeb startTimeBuffer;
-	_ftime( &startTimeBuffer );
-#pragma warning(default: 4996)
+	error = fopen_s ( &stream, fileName, "wb" );
 #else
-	timeb startTimeBuffer;
-	ftime( &startTimeBuffer );
+    stream = fopen( fileName, "wb" );
+	error = stream ? 0 : errno;
 #endif
+	if ( error != 0 )
+	{
+		delete[] mBuffer;
+		return -1;
+	}
+	setvbuf ( stream , mBuffer, _IOFBF, BUFFERSIZE );
 
-	double startTime = (double)startTimeBuffer.time + (double)startTimeBuffer.millitm / 1000;
-
+	float testFloat = 1.23456;
 
-	for ( size_t i= 0; i < 100000000; ++i)
+	double startTime = getTime();
+	for ( size_t i= 0; i < ITERATIONS; ++i)
 	{
-//		fwrite( testString, sizeof(char), sizeof(testString)-1, stream);
+	    FPRINTF( stream, "%g ", testFloat);
+	}
+	fclose ( stream );
+	double elapsed = getTime() - startTime;
 
-//	    FPRINTF( stream, "%g", testFloat);
+	delete[] mBuffer;
+	return elapsed;
+}
 
-//		FPRINTF( stream, "%g", testDouble);
 
-//		FPRINTF( stream, "%d", testInt);
+/** Writes chunks of numbers, each preceded by its length in a reserved slot, and overwrites a
+placeholder before every hundredth chunk by jumping back to a mark. Small buffers are used, so most
+slots and marks have already been passed to the flusher when they are filled.*/
+void writeWithMarks( Common::IBufferFlusher& bufferFlusher )
+{
+	Common::CharacterBuffer buffer(1000, &bufferFlusher);
+	buffer.setDirectFlushSize( 40 );
 
-		buffer.copyToBufferAsChar( testFloat );
+	const size_t CHUNK_COUNT = 3000;
+	const char PLACEHOLDER[] = "########";
+	Common::IBufferFlusher::MarkId markId = Common::IBufferFlusher::INVALID_ID;
+	size_t markedChunk = 0;
 
-//		buffer.copyToBufferAsChar( testDouble );
+	for ( size_t i = 0; i < CHUNK_COUNT; ++i )
+	{
+		if ( i % 100 == 0 )
+		{
+			if ( markId != Common::IBufferFlusher::INVALID_ID )
+			{
+				buffer.jumpToMark( markId );
+				char text[sizeof(PLACEHOLDER)];
+				sprintf( text, "%08u", (unsigned int)markedChunk );
+				buffer.copyToBuffer( text, sizeof(text) - 1 );
+				buffer.jumpToMark( Common::IBufferFlusher::END_OF_STREAM );
+			}
+			buffer.startMark();
+			buffer.copyToBuffer( PLACEHOLDER, sizeof(PLACEHOLDER) - 1 );
+			markId = buffer.endMark();
+			markedChunk = i;
+		}
+
+		Common::Buffer::ReservedId slot = buffer.reserveUint32();
+		size_t valueCount = (i * 7919) % 257;
+		for ( size_t j = 0; j < valueCount; ++j )
+		{
+			buffer.copyToBufferAsChar( (float)(i * 0.37 + j) );
+			buffer.copyToBuffer( ' ' );
+		}
+		buffer.fillReserved( slot, (unsigned int)valueCount );
+	}
+	buffer.flushFlusher();
+}
 
-//		buffer.copyToBufferAsChar( testInt );
 
-//		buffer.copyToBuffer( testString, sizeof(testString)-1);
-//		buffer.copyToBuffer( testChar);
+/** Reads the file @a fileName into @a content.*/
+bool readFile( const char* fileName, std::vector<char>& content )
+{
+	FILE* stream = fopen( fileName, "rb" );
+	if ( !stream )
+	{
+		return false;
 	}
+	char readBuffer[BUFFERSIZE];
+	size_t readBytes = 0;
+	while ( (readBytes = fread( readBuffer, 1, sizeof(readBuffer), stream )) > 0 )
+	{
+		content.insert( content.end(), readBuffer, readBuffer + readBytes );
+	}
+	fclose( stream );
+	return true;
+}
 
 
+/** Compares the file @a fileName with @a reference and prints the result.*/
+bool checkFile( const char* name, const char* fileName, const std::vector<char>& reference )
+{
+	std::vector<char> content;
+	bool equal = readFile( fileName, content ) && content == reference;
+	std::cout << name << (equal ? "correct" : "FAILED") << std::endl;
+	return equal;
+}
+
+
+bool correctnessTest()
+{
 #ifdef WIN32
-#pragma warning(disable: 4996)
-	_timeb endTimeBuffer;
-	_ftime(&endTimeBuffer);
-#pragma warning(default: 4996)
+	char fileNameReference[] = "c:\\temp\\testMarksFwrite.txt";
+	char fileNameBuffer[] = "c:\\temp\\testMarks.txt";
 #else
-	timeb endTimeBuffer;
-	ftime(&endTimeBuffer);
+	char fileNameReference[] = "/tmp/testMarksFwrite.txt";
+	char fileNameBuffer[] = "/tmp/testMarks.txt";
 #endif
 
+	// FWriteBufferFlusher writes the reference, each flusher is destroyed before its file is read
+	{
+		Common::FWriteBufferFlusher bufferFlusher(fileNameReference, BUFFERSIZE);
+		writeWithMarks( bufferFlusher );
+	}
+	std::vector<char> reference;
+	if ( !readFile( fileNameReference, reference ) || reference.empty() )
+	{
+		std::cout << "FWriteBufferFlusher reference could not be written" << std::endl;
+		return false;
+	}
 
+	bool success = true;
 
+	{
+		Common::StreamBufferFlusher bufferFlusher(fileNameBuffer, BUFFERSIZE);
+		writeWithMarks( bufferFlusher );
+	}
+	success &= checkFile( "StreamBufferFlusher:             ", fileNameBuffer, reference );
 
-	fclose ( stream );
+	{
+		COLLADASW::AsyncFileBufferFlusher bufferFlusher(fileNameBuffer, 5000);
+		writeWithMarks( bufferFlusher );
+	}
+	success &= checkFile( "AsyncFileBufferFlusher:          ", fileNameBuffer, reference );
 
-	delete[] mBuffer;
+	{
+		// buffers that are not a multiple of the alignment are shortened, the tail is written normally
+		COLLADASW::AsyncFileBufferFlusher bufferFlusher(fileNameBuffer, 10000,
+			COLLADASW::AsyncFileBufferFlusher::DEFAULT_BUFFER_COUNT, true);
+		writeWithMarks( bufferFlusher );
+	}
+	success &= checkFile( "AsyncFileBufferFlusher (direct): ", fileNameBuffer, reference );
 
-	double endTime = (double)endTimeBuffer.time + (double)endTimeBuffer.millitm / 1000;
+	return success;
+}
 
-	std::cout << std::endl << "time elapsed: " << endTime - startTime << std::endl;
 
+void performanceTest()
+{
+	std::string mLocale = setlocale(LC_NUMERIC, 0);
+	setlocale(LC_NUMERIC, "C");
+
+
+#ifdef WIN32
+	char fileNameBuffer[] = "c:\\temp\\testBuffer.txt";
+	char fileNameFwrite[] = "c:\\temp\\testFwrite.txt";
+#else
+	char fileNameBuffer[] = "/tmp/testBuffer.txt";
+	char fileNameFwrite[] = "/tmp/testFwrite.txt";
+#endif
+
+	std::cout << "fprintf:                         " << measureFprintf( fileNameFwrite ) << std::endl;
+
+	{
+		Common::FWriteBufferFlusher bufferFlusher(fileNameBuffer, BUFFERSIZE);
+		std::cout << "FWriteBufferFlusher:             " << measure( bufferFlusher ) << std::endl;
+	}
+
+	{
+		Common::StreamBufferFlusher bufferFlusher(fileNameBuffer, BUFFERSIZE);
+		std::cout << "StreamBufferFlusher:             " << measure( bufferFlusher ) << std::endl;
+	}
+
+	{
+		COLLADASW::AsyncFileBufferFlusher bufferFlusher(fileNameBuffer);
+		std::cout << "AsyncFileBufferFlusher:          " << measure( bufferFlusher ) << std::endl;
+	}
+
+	{
+		COLLADASW::AsyncFileBufferFlusher bufferFlusher(fileNameBuffer, COLLADASW::AsyncFileBufferFlusher::DEFAULT_BUFFER_SIZE,
+			COLLADASW::AsyncFileBufferFlusher::DEFAULT_BUFFER_COUNT, true);
+		std::cout << "AsyncFileBufferFlusher (direct): " << measure( bufferFlusher ) << std::endl;
+	}
+
+	setlocale(LC_NUMERIC, mLocale.c_str());
 };
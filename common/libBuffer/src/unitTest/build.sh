@@ -0,0 +1,12 @@
+
+OPTIONS="-O2 -Wall"
+
+INCLUDES="-I../../include -I../../include/unitTest"
+
+FILES="main.cpp reservedSlotUnitTest.cpp ../CommonBuffer.cpp ../CommonMemoryBufferFlusher.cpp ../CommonFWriteBufferFlusher.cpp "
+
+OUTPUTFILE="-o unitTest"
+
+
+
+g++ $OPTIONS $INCLUDES $FILES $OUTPUTFILE
@@ -9,11 +9,14 @@
 */
 
 
+#include "reservedSlotUnitTest.h"
+
 #include <stdio.h>
 
 
 int main()
 {
+	bool success = reservedSlotUnitTest();
 
-	return 0;
+	return success ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*
+    Copyright (c) 2009 NetAllied Systems GmbH
+
+    This file is part of Common libBuffer.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "reservedSlotUnitTest.h"
+
+#include "CommonBuffer.h"
+#include "CommonMemoryBufferFlusher.h"
+#include "CommonFWriteBufferFlusher.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/** The file written by the FWriteBufferFlusher.*/
+	const char* FILE_NAME = "reservedSlotUnitTest.bin";
+
+	/** The depth of the written chunk tree.*/
+	const size_t CHUNK_DEPTH = 4;
+
+	/** The number of children of each chunk above the leafs.*/
+	const size_t CHILD_COUNT = 3;
+
+	int errorCount = 0;
+
+
+	/** Writes chunks consisting of an id, a reserved length and the content, to a buffer and the same
+	bytes to a string, the expected output. The lengths are filled when the chunk is complete or, to
+	fill outer slots before inner ones, all at once by fillPendingSlots().*/
+	class ChunkWriter
+	{
+	private:
+		struct Slot
+		{
+			Common::Buffer::ReservedId reservedId;
+			unsigned int value;
+		};
+
+		Common::Buffer& mBuffer;
+
+		std::string mExpected;
+
+		bool mFillAtEnd;
+
+		/** The slots to fill in fillPendingSlots(), in the order they have been reserved.*/
+		std::vector<Slot> mPendingSlots;
+
+	public:
+		ChunkWriter( Common::Buffer& buffer, bool fillAtEnd ) : mBuffer( buffer ), mFillAtEnd( fillAtEnd ) {}
+
+		/** The bytes the flusher must have received.*/
+		const std::string& getExpected() const { return mExpected; }
+
+		/** Writes the chunk @a id and @a depth levels of children.*/
+		void writeChunk( unsigned short id, size_t depth )
+		{
+			size_t chunkStart = mExpected.size();
+			mBuffer.copyToBuffer( id );
+			mExpected.append( (const char*)&id, sizeof(id) );
+
+			Common::Buffer::ReservedId reservedId = mBuffer.reserveUint32();
+			if ( reservedId != mExpected.size() )
+			{
+				printf( "chunk %d: slot id %d, expected %d\n", (int)id, (int)reservedId, (int)mExpected.size() );
+				errorCount++;
+			}
+			mExpected.append( sizeof(unsigned int), '\0' );
+
+			// content of different sizes, some of them large enough to be flushed directly
+			size_t contentSize = (id % 5 == 0) ? 2 * mBuffer.getBufferSize() + id % 7 : id % 23;
+			std::string content;
+			for ( size_t i = 0; i < contentSize; ++i )
+				content += (char)('a' + (id + i) % 26);
+			mBuffer.copyToBuffer( content.c_str(), content.size() );
+			mExpected += content;
+
+			if ( depth > 0 )
+			{
+				for ( size_t i = 0; i < CHILD_COUNT; ++i )
+					writeChunk( (unsigned short)(id * CHILD_COUNT + i + 1), depth - 1 );
+			}
+
+			Slot slot = { reservedId, (unsigned int)(mExpected.size() - chunkStart) };
+			memcpy( &mExpected[reservedId], &slot.value, sizeof(slot.value) );
+			if ( mFillAtEnd )
+				mPendingSlots.push_back( slot );
+			else
+				fillSlot( slot );
+		}
+
+		/** Fills the slots not filled by writeChunk(), outer chunks first.*/
+		void fillPendingSlots()
+		{
+			for ( size_t i = mPendingSlots.size(); i > 0; --i )
+				fillSlot( mPendingSlots[i - 1] );
+			mPendingSlots.clear();
+		}
+
+	private:
+		void fillSlot( const Slot& slot )
+		{
+			if ( !mBuffer.fillReserved( slot.reservedId, slot.value ) )
+			{
+				printf( "slot %d could not be filled\n", (int)slot.reservedId );
+				errorCount++;
+			}
+		}
+	};
+
+
+	//--------------------------------------------------------------------
+	/** Writes the chunk tree through a buffer of @a bufferSize bytes into @a flusher.
+	@return The bytes the flusher must have received.*/
+	std::string writeChunks( Common::IBufferFlusher* flusher, size_t bufferSize, bool fillAtEnd )
+	{
+		Common::Buffer buffer( bufferSize, flusher );
+		ChunkWriter writer( buffer, fillAtEnd );
+		writer.writeChunk( 1, CHUNK_DEPTH );
+		writer.writeChunk( 2, 0 );
+		writer.fillPendingSlots();
+
+		// a slot that is filled twice does not exist anymore
+		if ( buffer.fillReserved( 2, 0 ) )
+		{
+			printf( "filling a filled slot succeeded\n" );
+			errorCount++;
+		}
+		buffer.flushFlusher();
+		return writer.getExpected();
+	}
+
+	//--------------------------------------------------------------------
+	void compare( const char* flusherName, size_t bufferSize, bool fillAtEnd, const std::string& expected, const char* data, size_t size )
+	{
+		size_t mismatchPos = 0;
+		while ( mismatchPos < size && mismatchPos < expected.size() && data[mismatchPos] == expected[mismatchPos] )
+			mismatchPos++;
+
+		if ( size == expected.size() && mismatchPos == size )
+		{
+			printf( "match              %s, buffer size %d, %s: %d bytes\n", flusherName, (int)bufferSize,
+				fillAtEnd ? "filled at end" : "filled per chunk", (int)size );
+		}
+		else
+		{
+			printf( "      don't match  %s, buffer size %d, %s: %d bytes, expected %d, first difference at %d\n", flusherName,
+				(int)bufferSize, fillAtEnd ? "filled at end" : "filled per chunk", (int)size, (int)expected.size(), (int)mismatchPos );
+			errorCount++;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void testMemoryBufferFlusher( size_t bufferSize, bool fillAtEnd )
+	{
+		Common::MemoryBufferFlusher flusher;
+		std::string expected = writeChunks( &flusher, bufferSize, fillAtEnd );
+		compare( "MemoryBufferFlusher", bufferSize, fillAtEnd, expected, flusher.getData(), flusher.getSize() );
+	}
+
+	//--------------------------------------------------------------------
+	void testFWriteBufferFlusher( size_t bufferSize, bool fillAtEnd )
+	{
+		std::string expected;
+		{
+			Common::FWriteBufferFlusher flusher( FILE_NAME, bufferSize );
+			if ( flusher.getError() != 0 )
+			{
+				printf( "could not open %s\n", FILE_NAME );
+				errorCount++;
+				return;
+			}
+			expected = writeChunks( &flusher, bufferSize, fillAtEnd );
+		}
+
+		std::string data;
+		FILE* file = fopen( FILE_NAME, "rb" );
+		if ( file )
+		{
+			char block[4096];
+			size_t readBytes;
+			while ( (readBytes = fread( block, 1, sizeof(block), file )) > 0 )
+				data.append( block, readBytes );
+			fclose( file );
+		}
+		remove( FILE_NAME );
+		compare( "FWriteBufferFlusher", bufferSize, fillAtEnd, expected, data.data(), data.size() );
+	}
+}
+
+
+//--------------------------------------------------------------------
+bool reservedSlotUnitTest()
+{
+	printf( "reservedSlotUnitTest()\n\n" );
+
+	// buffer sizes smaller than a chunk header, not a multiple of the slot size and larger than most chunks
+	const size_t bufferSizes[] = { 4, 13, 64, 4096 };
+	for ( size_t i = 0; i < sizeof(bufferSizes) / sizeof(bufferSizes[0]); ++i )
+	{
+		for ( int fillAtEnd = 0; fillAtEnd < 2; ++fillAtEnd )
+		{
+			testMemoryBufferFlusher( bufferSizes[i], fillAtEnd != 0 );
+			testFWriteBufferFlusher( bufferSizes[i], fillAtEnd != 0 );
+		}
+	}
+
+	printf( "\n%d errors\n", errorCount );
+	return errorCount == 0;
+}
@@ -15,9 +15,10 @@
 #include "math.h"
 
 #include <iostream>
+#include <time.h>
 
-#include <sys/types.h>
-#include <sys/timeb.h> 
+// OpenCOLLADANumericBenchmark in COLLADABenchmark compares ftoa and dtoa with the conversions of
+// the standard library on realistic values and measures their accuracy.
 
 
 void performanceTest()
@@ -31,10 +32,7 @@ void performanceTest()
 	float testFloat = 0;
 	double testDouble = 1.23456;
 
-#pragma warning(disable: 4996)
-	_timeb startTimeBuffer;
-	_ftime( &startTimeBuffer );
-	double startTime = (double)startTimeBuffer.time + (double)startTimeBuffer.millitm / 1000;
+	clock_t startTime = clock();
 
 
 	char ftoaBuffer[Common::FTOA_BUFFERSIZE];
@@ -60,13 +58,9 @@ void performanceTest()
 	}
 
 
+	clock_t endTime = clock();
 	setlocale(LC_NUMERIC, mLocale.c_str());
-	_timeb endTimeBuffer;
-	_ftime(&endTimeBuffer);
-#pragma warning(default: 4996)
 
-	double endTime = (double)endTimeBuffer.time + (double)endTimeBuffer.millitm / 1000;
-
-	std::cout << std::endl << "time elapsed: " << endTime - startTime << std::endl;
+	std::cout << std::endl << "time elapsed: " << (double)( endTime - startTime ) / CLOCKS_PER_SEC << std::endl;
 
 };
\ No newline at end of file
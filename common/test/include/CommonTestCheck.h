@@ -0,0 +1,44 @@
+/*
+    Copyright (c) 2009 NetAllied Systems GmbH
+
+    This file is part of Common.
+	
+    Licensed under the MIT Open Source License, 
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COMMON_TESTCHECK_H__
+#define __COMMON_TESTCHECK_H__
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+    Check counting for the test programs built by the build.sh scripts. Each test program consists
+    of one translation unit, that includes this header once, checks its conditions with CHECK() and
+    returns a non zero exit code, if Common::Test::failureCount is not 0.
+*/
+namespace Common
+{
+	namespace Test
+	{
+		/** The number of failed checks.*/
+		static size_t failureCount = 0;
+
+		//------------------------------
+		/** Counts and reports a failed check.*/
+		inline void check( bool condition, const char* expression, int line )
+		{
+			if ( condition )
+				return;
+			fprintf( stderr, "line %d: check failed: %s\n", line, expression );
+			++failureCount;
+		}
+	}
+}
+
+/** Checks @a condition and reports the expression and the line, if it is false.*/
+#define CHECK( condition ) Common::Test::check( ( condition ), #condition, __LINE__ )
+
+#endif // __COMMON_TESTCHECK_H__
@@ -68,17 +68,11 @@ namespace DAE23ds
 
 		Common::Buffer& getBuffer() { return mWriter->getBuffer(); }
 
-		/** The chunk length of all object block and material blocks.*/
-		ChunkLength getObjectAndMaterialBlockLength() const { return mWriter->getObjectAndMaterialBlockLength(); }
+		/** Writes the id of a chunk, whose length is not known yet, and reserves space for the length.*/
+		Common::Buffer::ReservedId beginChunk( ChunkID chunkId ) { return mWriter->beginChunk(chunkId); }
 
-		/** The chunk length of all object block and material blocks.*/
-		void setObjectAndMaterialBlockLength(ChunkLength val) { mWriter->setObjectAndMaterialBlockLength(val); }
-
-		void addToObjectAndMaterialBlockLength(ChunkLength val);
-
-		void addMeshData( const Writer::MeshData& meshData );
-
-		const Writer::MeshData& getMeshData( const COLLADAFW::UniqueId& meshUniqueId ) const;
+		/** Fills the length of the chunk started by beginChunk().*/
+		void endChunk( Common::Buffer::ReservedId chunkLength ) { mWriter->endChunk(chunkLength); }
 
 		Writer::UniqueIdNodeMap& getUniqueIdNodeMap() { return mWriter->getUniqueIdNodeMap(); }
 
@@ -34,7 +34,6 @@ namespace DAE23ds
 
 		struct WriteMeshIntoMultipleObjectsData
 		{
-			ChunkLength editObjectLength;
 			ChunkLength fullBlocksCount;
 			ChunkLength remainingTriangles;
 		};
@@ -42,10 +41,6 @@ namespace DAE23ds
 
 		struct WriteMeshIntoOneObject
 		{
-			ChunkLength editObjectLength;
-			ChunkLength triangularMeshLength;
-			ChunkLength verticesLength;
-			ChunkLength facesDescriptionLength;
 			CountType trianglesCount;
 		};
 
@@ -100,36 +95,12 @@ namespace DAE23ds
 		void setMeshData(const Writer::MeshData& meshData) { mMeshData = meshData; }
 
 
-		/** Calculates the length of the vertices of the current mesh.*/
-		ChunkLength calculateVerticesLength();
-
-		/** Calculates the length of the vertices for a mesh with  (verticesCount_times3 / 3) vertices.*/
-		ChunkLength calculateVerticesLength(ChunkLength verticesCount_times3);
-
-		/** Calculates the length of all the vertices of the current mesh, if written into multiple objects.*/
-		ChunkLength calculateTotalVerticesLengthMultiObject(size_t trianglesCount, ChunkLength blockCount );
-
-		/** Calculates the length of the object of the current mesh given the length of the triangular mesh.*/
-		ChunkLength calculateObjectLength(ChunkLength triangularMeshLength);
-
-		/** Calculates the length of all the object of the current mesh given the length of the triangular mesh.*/
-		ChunkLength calculateTotalObjectLengthMultiObject(ChunkLength triangularMeshLength, ChunkLength blockCount);
-
 		/** Calculates the number of triangles in the mesh.*/
 		size_t calculateTrianglesCount();
 
 		/** Calculates the length including null termination of all materials names.*/
 //		ChunkLength calculateMaterialNamesLength( const COLLADAFW::MaterialBindingArray& materialBindings);
 
-		/** Calculates the length of all material faces.*/
-		ChunkLength calculateFacesMaterialsLength(CountType trianglesCount, const COLLADAFW::MaterialBindingArray& materialBindings);
-
-		/** Calculates the length of the faces description, given the number of triangles.*/
-		ChunkLength calculateFacesDescriptionLength(CountType trianglesCount, ChunkLength facesMaterialsLength);
-
-		/** Calculates the length of the faces description, given the number of triangles and blocks. The calculated size is for all object blocks.*/
-		ChunkLength calculateFacesDescriptionLengthMultiObject(size_t trianglesCount, ChunkLength blockCount, ChunkLength facesMaterialsLength, ChunkLength remainderFacesMaterialsLength, ChunkLength fullBlocksCount);
-
 		bool splitMeshInChunks();
 		
 //		ChunkLength calculateMaterialNameLengthFromMaterialBinding( const COLLADAFW::InstanceGeometry::MaterialBinding& materialBinding);
@@ -21,21 +21,8 @@ namespace DAE23ds
 	class SceneGraphHandler : public SceneGraphBase 
 	{
 	private:
-		struct NodeInfo
-		{
-			NodeInfo( COLLADABU::Math::Matrix4 _worldTransformation)
-				: worldTransformation(_worldTransformation){}
-			COLLADABU::Math::Matrix4 worldTransformation;
-		};
-
-		typedef std::stack<NodeInfo> NodeInfoStack;
-
-	private:
-		NodeInfoStack mNodeInfoStack;
 		Writer::UniqueIdNodeMap& mUniqueIdNodeMap;
 
-		ChunkLength mSceneGraphLength;
-
 	public:
 
 		SceneGraphHandler( Writer* writer3ds, const COLLADAFW::VisualScene* visualScene, const Writer::LibraryNodesList& libraryNodesList );
@@ -44,8 +31,6 @@ namespace DAE23ds
 
 		bool handle();
 
-		ChunkLength getScenegraphLength() const { return mSceneGraphLength; }
-
 
 	private:
 
@@ -55,15 +40,7 @@ namespace DAE23ds
 		/** Disable default assignment operator. */
 		const SceneGraphHandler& operator= ( const SceneGraphHandler& pre );
 
-		bool handleNodes(  const COLLADAFW::NodePointerArray& nodesToWriter);
-
-		bool handleNode(  const COLLADAFW::Node* nodeToWriter);
-
 		void handleInstanceGeometries( const COLLADAFW::Node* node, const COLLADABU::Math::Matrix4& matrix );
-
-		void handleInstanceNodes( const COLLADAFW::InstanceNodePointerArray& instanceNodes);
-
-		void addNodeLength( ChunkLength objectRefLength, ChunkLength factor , const COLLADABU::Math::Matrix4& matrix);
 	};
 
 } // namespace DAE23DS
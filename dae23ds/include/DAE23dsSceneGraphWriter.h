@@ -45,7 +45,7 @@ namespace DAE23ds
 
 		virtual ~SceneGraphWriter();
 
-		bool write( ChunkLength scenegraphLength );
+		bool write();
 
 
 	private:
@@ -22,18 +22,16 @@
 #include "COLLADAFWEffect.h"
 #include "COLLADAFWImage.h"
 
+#include "CommonBuffer.h"
+
 #include "COLLADABUURI.h"
+#include "COLLADABUFlatHashMap.h"
 #include "Math/COLLADABUMathMatrix4.h"
 
 #include <stack>
 #include <list>
 #include <map>
-
-
-namespace Common
-{
-	class Buffer;
-}
+#include <vector>
 
 
 namespace DAE23ds
@@ -180,14 +178,24 @@ namespace DAE23ds
 
 		typedef std::map<InstanceGeometryIdentifier, ObjectIdList> InstanceGeometryObjectIdMap;
 
-		/** Maps unique ids of framework materials to the corresponding framework material.*/
-		typedef std::map<COLLADAFW::UniqueId, COLLADAFW::Material> UniqueIdFWMaterialMap;
+		/** Maps unique ids of framework materials to the corresponding framework material. The
+		materials are owned by the writer.*/
+		typedef std::map<COLLADAFW::UniqueId, const COLLADAFW::Material*> UniqueIdFWMaterialMap;
 
-		/** Maps unique ids of framework images to the corresponding framework image.*/
-		typedef std::map<COLLADAFW::UniqueId, COLLADAFW::Image> UniqueIdFWImageMap;
+		/** Maps unique ids of framework images to the corresponding framework image. The images are
+		owned by the writer.*/
+		typedef std::map<COLLADAFW::UniqueId, const COLLADAFW::Image*> UniqueIdFWImageMap;
 
-		/** Maps unique ids of framework effects to the corresponding framework material.*/
-		typedef std::map<COLLADAFW::UniqueId, COLLADAFW::Effect> UniqueIdFWEffectMap;
+		/** Maps unique ids of framework effects to the corresponding framework effect. The effects
+		are owned by the writer.*/
+		typedef std::map<COLLADAFW::UniqueId, const COLLADAFW::Effect*> UniqueIdFWEffectMap;
+
+		/** Visual scenes owned by the writer, that have been replaced by a later visual scene.*/
+		typedef std::vector<const COLLADAFW::VisualScene*> VisualSceneList;
+
+		/** Objects owned by the writer, e.g. materials, that have the unique id of an object
+		passed before.*/
+		typedef std::vector<const COLLADAFW::Object*> ObjectList;
 
 		enum Severity
 		{
@@ -204,11 +212,9 @@ namespace DAE23ds
 			String name;
 		};
 
-		typedef std::map< COLLADAFW::UniqueId, MeshData > MeshDataMap;
-
-		typedef std::map<COLLADAFW::UniqueId, COLLADAFW::Node*> UniqueIdNodeMap;
+		typedef COLLADABU::FlatHashMap<COLLADAFW::UniqueId, COLLADAFW::Node*> UniqueIdNodeMap;
 
-		typedef std::map< COLLADAFW::UniqueId, MaterialNumber> UniqueMaterialNumberMap;
+		typedef COLLADABU::FlatHashMap< COLLADAFW::UniqueId, MaterialNumber> UniqueMaterialNumberMap;
 
 	private:
 		COLLADABU::URI mInputFile;
@@ -221,7 +227,17 @@ namespace DAE23ds
 
 		Runs mCurrentRun;
 
-		COLLADAFW::VisualScene* mVisualScene;
+		const COLLADAFW::VisualScene* mVisualScene;
+
+		/** Visual scenes, that have been replaced by mVisualScene. They are deleted in finish(),
+		not while the loader is still running.*/
+		VisualSceneList mReplacedVisualScenes;
+
+		/** Materials, effects and images with the unique id of one in mUniqueIdFWMaterialMap,
+		mUniqueIdFWEffectMap or mUniqueIdFWImageMap. They are deleted in finish(), like
+		mReplacedVisualScenes.*/
+		ObjectList mDuplicateObjects;
+
 		LibraryNodesList mLibraryNodesList;
 		UniqueIdNodeMap mUniqueIdNodeMap;
 
@@ -243,11 +259,11 @@ namespace DAE23ds
 		UniqueIdFWImageMap mUniqueIdFWImageMap;
 		UniqueIdFWEffectMap mUniqueIdFWEffectMap;
 
-		/** The chunk length of all object block and material blocks.*/
-		ChunkLength mObjectAndMaterialBlockLength;
+		/** The reserved length of the main chunk.*/
+		Common::Buffer::ReservedId mMainChunkLength;
 
-		/** The mesh data of all the meshes parsed at the first run.*/
-		MeshDataMap mMeshDataMap;
+		/** The reserved length of the 3d editor chunk, that contains all object and material blocks.*/
+		Common::Buffer::ReservedId mEdit3DSChunkLength;
 
 		/** The Object Id of the next object that will be exported.*/
 		ObjectId mNextObjectId;
@@ -280,6 +296,10 @@ namespace DAE23ds
 		/** Remove all objects that don't have an object. Deletes unused visual scenes.*/
 		void finish();;
 
+		/** The visual scene, the materials, the effects and the images are kept without copying
+		them, while the scene graph is loaded.*/
+		virtual int getOwnedObjects() const;
+
 		/** When this method is called, the writer must write the global document asset.
 		@return The writer should return true, if writing succeeded, false otherwise.*/
 		virtual bool writeGlobalAsset ( const COLLADAFW::FileInfo* asset );
@@ -395,20 +415,13 @@ namespace DAE23ds
 
 		Common::Buffer& getBuffer() { return *mBuffer; }
 
-		/** The chunk length of all object block and material blocks.*/
-		ChunkLength getObjectAndMaterialBlockLength() const { return mObjectAndMaterialBlockLength; }
-
-		/** The chunk length of all object block and material blocks.*/
-		void setObjectAndMaterialBlockLength(ChunkLength val) { mObjectAndMaterialBlockLength = val; }
-
-		/** The mesh data of all the meshes parsed at the first run.*/
-		MeshDataMap& getMeshDataMap() { return mMeshDataMap; }
-
-		/** Calculates the length of all meshes.*/
-		void calculateMeshesLength();
+		/** Writes the id of a chunk, whose length is not known yet, and reserves space for the length.
+		@return The id of the reserved length, that has to be passed to endChunk().*/
+		Common::Buffer::ReservedId beginChunk( ChunkID chunkId );
 
-		/** Calculates the length of all material blocks.*/
-		void calculateMaterialsBlockLength();
+		/** Fills the length of the chunk started by beginChunk() with the number of bytes written since
+		then, including the chunk header.*/
+		void endChunk( Common::Buffer::ReservedId chunkLength );
 
 		/** Writes all material blocks.*/
 		void writeMaterialsBlocks();
@@ -448,7 +461,9 @@ namespace DAE23ds
 		/** Fills the bindingMap of @a materialBinding.*/
 		static void fillMaterialBindingMap(const GeometryMaterialBinding& materialBinding);
 
-		bool writeHeader( ChunkLength sceneGraphLength );
+		/** Writes the main chunk header and the header of the 3d editor chunk. The lengths of both chunks
+		are reserved and filled once all their sub chunks have been written.*/
+		bool writeHeader();
 
 		template<class NumberType, char prefix>
 		static const char* calculateNameFromNumber( const NumberType& number);
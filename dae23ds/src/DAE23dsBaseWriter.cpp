@@ -92,7 +92,7 @@ namespace DAE23ds
 		}
 		else
 		{
-			return &it->second;
+			return it->second;
 		}
 	}
 
@@ -107,7 +107,7 @@ namespace DAE23ds
 		}
 		else
 		{
-			return &it->second;
+			return it->second;
 		}
 	}
 
@@ -156,24 +156,6 @@ namespace DAE23ds
 
 	}
 
-	//------------------------------
-	void BaseWriter::addToObjectAndMaterialBlockLength( ChunkLength val )
-	{
-		mWriter->setObjectAndMaterialBlockLength( mWriter->getObjectAndMaterialBlockLength() + val );
-	}
-
-	//------------------------------
-	void BaseWriter::addMeshData( const Writer::MeshData& meshData )
-	{
-		mWriter->getMeshDataMap().insert( std::make_pair( meshData.meshUniqueId, meshData ) );
-	}
-
-	//------------------------------
-	const Writer::MeshData& BaseWriter::getMeshData( const COLLADAFW::UniqueId& meshUniqueId ) const
-	{
-		return mWriter->getMeshDataMap()[meshUniqueId];
-	}
-
 	//------------------------------
 	Writer::ObjectId BaseWriter::getAndIncreaseNextObjectId() const
 	{
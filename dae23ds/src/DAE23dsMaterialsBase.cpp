@@ -47,48 +47,5 @@ namespace DAE23ds
 		}
 	}
 
-	//------------------------------
-	ChunkLength MaterialsBase::calculateMaterialColorLength( const COLLADAFW::Material* material)
-	{
-		ChunkLength length = 0;
-
-		const COLLADAFW::EffectCommon* effectCommon = getEffectCommon(material);
-		assert(effectCommon);
-
-		if ( effectCommon->getAmbient().isColor() )
-		{
-			length += COLOR_CHUNK_LENGTH_RGB_BYTE;
-		}
-
-		if ( effectCommon->getDiffuse().isColor() )
-		{
-			length += COLOR_CHUNK_LENGTH_RGB_BYTE;
-		}
-
-		if ( effectCommon->getSpecular().isColor() )
-		{
-			length += COLOR_CHUNK_LENGTH_RGB_BYTE;
-		}
-
-		return length; 
-	}
-
-	//------------------------------
-	ChunkLength MaterialsBase::calculateMaterialBlockLength( const COLLADAFW::Material* material)
-	{
-		ChunkLength length = 0;
-
-		// empty chunk length of the material block
-		// plus empty chunk length of the name
-		length += 2 * EMPTY_CHUNK_LENGTH;
-
-		// add length required for the color chunks
-
-		length += calculateMaterialColorLength( material );
-
-		length += Writer::getMaterialNameLength();
-		return length;
-	}
-
 
 } // namespace DAE23ds
@@ -60,7 +60,7 @@ namespace DAE23ds
 		{
 		case COLLADAFW::MeshPrimitive::TRIANGLES:
 			{
-				const COLLADAFW::UIntValuesArray& positionsIndices = meshPrimitive->getPositionIndices();
+				const COLLADAFW::IndexArray& positionsIndices = meshPrimitive->getPositionIndexArray();
 				size_t positionsIndicesCount = positionsIndices.getCount();
 				trianglesCount = positionsIndicesCount/3;
 				break;
@@ -113,7 +113,7 @@ namespace DAE23ds
 
 		mCurrentPrimitiveIndex = meshPrimitiveIndex;
 
-		const COLLADAFW::UIntValuesArray& positionsIndices = meshPrimitive->getPositionIndices();
+		const COLLADAFW::IndexArray& positionsIndices = meshPrimitive->getPositionIndexArray();
 
 		switch ( meshPrimitive->getPrimitiveType() )
 		{
@@ -181,7 +181,7 @@ namespace DAE23ds
 	{
 		mCurrentTriangleIndex++;
 		const COLLADAFW::MeshPrimitive* meshPrimitive = mMesh->getMeshPrimitives()[mCurrentPrimitiveIndex];
-		const COLLADAFW::UIntValuesArray& positionsIndices = meshPrimitive->getPositionIndices();
+		const COLLADAFW::IndexArray& positionsIndices = meshPrimitive->getPositionIndexArray();
 
 		COLLADAFW::MaterialId materialId = meshPrimitive->getMaterialId();
 
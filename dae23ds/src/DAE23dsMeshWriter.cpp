@@ -97,20 +97,9 @@ namespace DAE23ds
 	{
 		const COLLADAFW::InstanceGeometry* instanceGeometry = instanceGeometryInfo.fwInstanceGeometry;
 		const COLLADAFW::MaterialBindingArray& materialBindings = instanceGeometry->getMaterialBindings();
-		ChunkLength verticesLength = calculateVerticesLength(blockData.trianglesCount*3*3);
-
-		ChunkLength facesMaterialsLength = calculateFacesMaterialsLength(blockData.trianglesCount, materialBindings);
-
-		ChunkLength facesDescriptionLength = calculateFacesDescriptionLength(blockData.trianglesCount, facesMaterialsLength);
-
-		// vertices  and faces description plus empty chunk
-		ChunkLength triangularMeshLength = verticesLength + facesDescriptionLength+ EMPTY_CHUNK_LENGTH+TRI_LOCAL_LENGTH;
-
-		ChunkLength editObjectLength = calculateObjectLength(triangularMeshLength);
 
 		// object chunk
-		mBuffer.copyToBuffer(EDIT_OBJECT);
-		mBuffer.copyToBuffer(editObjectLength);
+		Common::Buffer::ReservedId editObjectLength = beginChunk(EDIT_OBJECT);
 
 		Writer::ObjectId objectId = getAndIncreaseNextObjectId();
 		const char* meshName3ds = Writer::calculateObjectNameFromObjectId( objectId );
@@ -118,24 +107,26 @@ namespace DAE23ds
 		addInstanceGeometryObjectId(Writer::InstanceGeometryIdentifier(instanceGeometryInfo.fwInstanceGeometry, instanceGeometryInfo.instanceNumber), objectId);
 
 		// triangular mesh
-		mBuffer.copyToBuffer(OBJ_TRIMESH);
-		mBuffer.copyToBuffer(triangularMeshLength);
+		Common::Buffer::ReservedId triangularMeshLength = beginChunk(OBJ_TRIMESH);
 
 		// vertices list mesh
-		mBuffer.copyToBuffer(TRI_VERTEXL);
-		mBuffer.copyToBuffer(verticesLength);
+		Common::Buffer::ReservedId verticesLength = beginChunk(TRI_VERTEXL);
 		mBuffer.copyToBuffer((CountType)(blockData.trianglesCount*3));
 		writeVerticesForMultipleObjects(blockData.firstTriangleIndex, blockData.trianglesCount,instanceGeometryInfo.worldMatrix);
+		endChunk(verticesLength);
 
 		// faces description
-		mBuffer.copyToBuffer(TRI_FACEL1);
-		mBuffer.copyToBuffer(facesDescriptionLength);
+		Common::Buffer::ReservedId facesDescriptionLength = beginChunk(TRI_FACEL1);
 		mBuffer.copyToBuffer((CountType)(blockData.trianglesCount));
 		writeTrianglesForMultipleObjects(blockData.trianglesCount);
 
 		writeFaceMaterialsForMultipleObjects(materialBindings, blockData);
+		endChunk(facesDescriptionLength);
 
 		writeMeshMatrix(instanceGeometryInfo.worldMatrix);
+		endChunk(triangularMeshLength);
+
+		endChunk(editObjectLength);
 		return true;
 	}
 
@@ -162,8 +153,7 @@ namespace DAE23ds
 //			writeMaterialBlocks(materialBindings);
 
 			// object chunk
-			mBuffer.copyToBuffer(EDIT_OBJECT);
-			mBuffer.copyToBuffer(data.editObjectLength);
+			Common::Buffer::ReservedId editObjectLength = beginChunk(EDIT_OBJECT);
 
 			Writer::ObjectId objectId = getAndIncreaseNextObjectId();
 			const char* meshName3ds = Writer::calculateObjectNameFromObjectId( objectId );
@@ -171,23 +161,26 @@ namespace DAE23ds
 			addInstanceGeometryObjectId(Writer::InstanceGeometryIdentifier(instanceGeometryInfo.fwInstanceGeometry, instanceGeometryInfo.instanceNumber), objectId);
 
 			// triangular mesh
-			mBuffer.copyToBuffer(OBJ_TRIMESH);
-			mBuffer.copyToBuffer(data.triangularMeshLength);
+			Common::Buffer::ReservedId triangularMeshLength = beginChunk(OBJ_TRIMESH);
 
 			// vertices list mesh
-			mBuffer.copyToBuffer(TRI_VERTEXL);
-			mBuffer.copyToBuffer(data.verticesLength);
+			Common::Buffer::ReservedId verticesLength = beginChunk(TRI_VERTEXL);
 			mBuffer.copyToBuffer((CountType)(mMeshPositions.getValuesCount()/3));
 			writeVertices(instanceGeometryInfo.worldMatrix);
+			endChunk(verticesLength);
 
 			// faces description
-			mBuffer.copyToBuffer(TRI_FACEL1);
-			mBuffer.copyToBuffer(data.facesDescriptionLength);
+			Common::Buffer::ReservedId facesDescriptionLength = beginChunk(TRI_FACEL1);
 			mBuffer.copyToBuffer(data.trianglesCount);
 			writeTriangles();
 
 			writeFaceMaterials(materialBindings);
+			endChunk(facesDescriptionLength);
+
 			writeMeshMatrix(instanceGeometryInfo.worldMatrix);
+			endChunk(triangularMeshLength);
+
+			endChunk(editObjectLength);
 		}
 
 		return true;
@@ -442,22 +435,8 @@ namespace DAE23ds
 			const char* materialName = Writer::calculateMaterialNameFromMaterialNumer(materialNumber);
 
 
-			// calculate size of the chunk
-			// empty chunk 
-			ChunkLength chunkLength = EMPTY_CHUNK_LENGTH;
-
-			// materialname plus material plus one for null termination
-			chunkLength	+= Writer::getMaterialNameLength();
-
-			// plus sizeof(IndexType) for each face
-			chunkLength	+= (ChunkLength)sizeof(IndexType)*faceCount;
-
-			// plus size of face count
-			chunkLength	+= (ChunkLength)sizeof(CountType);
-
 			// write faces material
-			mBuffer.copyToBuffer(TRI_FACES_MAT);
-			mBuffer.copyToBuffer(chunkLength);
+			Common::Buffer::ReservedId chunkLength = beginChunk(TRI_FACES_MAT);
 			mBuffer.copyToBuffer(materialName, Writer::getMaterialNameLength());
 			mBuffer.copyToBuffer(faceCount);
 
@@ -483,6 +462,7 @@ namespace DAE23ds
 					}
 				}
 			}
+			endChunk(chunkLength);
 		}
 		return true;
 	}
@@ -514,22 +494,8 @@ namespace DAE23ds
 			MaterialNumber materialNumber = getMaterialNumberByUniqueId(materialUniqueId );
 			const char* materialName = Writer::calculateMaterialNameFromMaterialNumer(materialNumber);
 
-			// calculate size of the chunk
-			// empty chunk 
-			ChunkLength chunkLength = EMPTY_CHUNK_LENGTH;
-
-			// materialname plus material plus one for null termination
-			chunkLength	+= Writer::getMaterialNameLength();
-
-			// plus sizeof(IndexType) for each face
-			chunkLength	+= (ChunkLength)sizeof(IndexType)*faceCount;
-
-			// plus size of face count
-			chunkLength	+= (ChunkLength)sizeof(CountType);
-
 			// write faces material
-			mBuffer.copyToBuffer(TRI_FACES_MAT);
-			mBuffer.copyToBuffer(chunkLength);
+			Common::Buffer::ReservedId chunkLength = beginChunk(TRI_FACES_MAT);
 			mBuffer.copyToBuffer(materialName, Writer::getMaterialNameLength());
 			mBuffer.copyToBuffer(faceCount);
 
@@ -544,6 +510,7 @@ namespace DAE23ds
 					mBuffer.copyToBuffer((IndexType)j);
 				}
 			}
+			endChunk(chunkLength);
 		}
 		return true;
 	}
@@ -559,7 +526,7 @@ namespace DAE23ds
 		{
 			const COLLADAFW::MeshPrimitive* meshPrimitive = meshPrimitives[i];
 
-			const COLLADAFW::UIntValuesArray& positionsIndices = meshPrimitive->getPositionIndices();
+			const COLLADAFW::IndexArray& positionsIndices = meshPrimitive->getPositionIndexArray();
 			size_t positionsIndicesCount = positionsIndices.getCount();
 
 			switch ( meshPrimitive->getPrimitiveType() )
@@ -11,11 +11,8 @@
 #include "DAE23dsStableHeaders.h"
 #include "DAE23dsWriter.h"
 #include "DAE23dsMeshWriter.h"
-#include "DAE23dsMeshHandler.h"
-#include "DAE23dsMeshLengthCalculator.h"
 #include "DAE23dsSceneGraphWriter.h"
 #include "DAE23dsSceneGraphHandler.h"
-#include "DAE23dsMaterialsLengthCalculator.h"
 #include "DAE23dsMaterialsWriter.h"
 
 #include "COLLADASaxFWLLoader.h"
@@ -39,6 +36,33 @@ namespace DAE23ds
 	static const size_t RESERVED_OBJECTIDS_COUNT = 0;
 	static const size_t RESERVED_MATERIALNUMBERS_COUNT = 1;
 
+	/** Deletes the values of @a map, which must be pointers.*/
+	template<class MapType>
+	static void deleteMapValues( const MapType& map )
+	{
+		for ( typename MapType::const_iterator it = map.begin(); it != map.end(); ++it )
+			delete it->second;
+	}
+
+	/** Adds @a object, which is owned by the writer, to @a map. If @a map already contains an
+	object with the same unique id, @a object is added to @a duplicates, which are deleted in
+	finish(), not while the loader is still running.*/
+	template<class MapType, class ObjectType>
+	static void insertOwnedObject( MapType& map, const ObjectType* object, std::vector<const COLLADAFW::Object*>& duplicates )
+	{
+		if ( !map.insert( std::make_pair( object->getUniqueId(), object ) ).second )
+			duplicates.push_back( object );
+	}
+
+	/** Deletes the objects in @a objects and clears the list.*/
+	template<class ObjectType>
+	static void deleteObjects( std::vector<const ObjectType*>& objects )
+	{
+		for ( size_t i = 0; i < objects.size(); ++i )
+			delete objects[i];
+		objects.clear();
+	}
+
 
 	//--------------------------------------------------------------------
 	bool Writer::InstanceGeometryInfo::operator<( const InstanceGeometryInfo& rhs ) const
@@ -76,7 +100,8 @@ namespace DAE23ds
 		, mCurrentRun(SCENEGRAPH_RUN)
 		, mVisualScene(0)
 		, mGeometryMaterialBindingFileNameMap(compare)
-		, mObjectAndMaterialBlockLength(0)
+		, mMainChunkLength(0)
+		, mEdit3DSChunkLength(0)
 		, mNextObjectId( RESERVED_OBJECTIDS_COUNT )
 		, mNextMaterialNumber( RESERVED_MATERIALNUMBERS_COUNT )
 	{
@@ -86,6 +111,11 @@ namespace DAE23ds
 	Writer::~Writer()
 	{
 		delete mVisualScene;
+		deleteObjects( mReplacedVisualScenes );
+		deleteObjects( mDuplicateObjects );
+		deleteMapValues( mUniqueIdFWMaterialMap );
+		deleteMapValues( mUniqueIdFWImageMap );
+		deleteMapValues( mUniqueIdFWEffectMap );
 	}
 
 	//--------------------------------------------------------------------
@@ -120,14 +150,13 @@ namespace DAE23ds
 
 		mBuffer = &buffer;
 
-		// Load scene graph 
+		// Load scene graph. The geometries are not needed before they are written
 		loader.setObjectFlags(   COLLADASaxFWL::Loader::ASSET_FLAG 
 							   | COLLADASaxFWL::Loader::EFFECT_FLAG
 							   | COLLADASaxFWL::Loader::MATERIAL_FLAG
 							   | COLLADASaxFWL::Loader::LIBRARY_NODES_FLAG
 							   | COLLADASaxFWL::Loader::VISUAL_SCENES_FLAG
-							   | COLLADASaxFWL::Loader::SCENE_FLAG
-							   | COLLADASaxFWL::Loader::GEOMETRY_FLAG);
+							   | COLLADASaxFWL::Loader::SCENE_FLAG);
 		if ( !root.loadDocument(mInputFile.toNativePath()) )
 			return false;
 
@@ -136,40 +165,25 @@ namespace DAE23ds
 		SceneGraphHandler sceneGraphHandler(this, mVisualScene, mLibraryNodesList);
 		sceneGraphHandler.handle();
 
-		calculateMaterialsBlockLength();
-		calculateMeshesLength();
-
-		writeHeader( sceneGraphHandler.getScenegraphLength() );
+		writeHeader();
 		writeMaterialsBlocks();
 
 		// load and write geometries
 		mCurrentRun = GEOMETRY_RUN;
+		loader.setObjectFlags(   COLLADASaxFWL::Loader::ASSET_FLAG 
+							   | COLLADASaxFWL::Loader::GEOMETRY_FLAG);
 		if ( !root.loadDocument(mInputFile.toNativePath()) )
 			return false;
 
+		// all object and material blocks have been written
+		endChunk( mEdit3DSChunkLength );
+
 		SceneGraphWriter sceneGraphWriter(this, mVisualScene, mLibraryNodesList);
-		sceneGraphWriter.write( sceneGraphHandler.getScenegraphLength() );
+		sceneGraphWriter.write();
 
-		return true;
-	}
+		endChunk( mMainChunkLength );
 
-	//--------------------------------------------------------------------
-	void Writer::calculateMeshesLength()
-	{
-		MeshDataMap::const_iterator it = mMeshDataMap.begin();
-		for ( ; it != mMeshDataMap.end(); ++it)
-		{
-			const MeshData& meshData = it->second;
-			MeshLengthCalculator meshLengthCalculator( this, meshData );
-			meshLengthCalculator.handle();
-		}
-	}
-
-	//--------------------------------------------------------------------
-	void Writer::calculateMaterialsBlockLength()
-	{
-		MaterialsLengthCalculator materialsLengthCalculator(this);
-		materialsLengthCalculator.calculate();
+		return true;
 	}
 
 	//--------------------------------------------------------------------
@@ -222,6 +236,19 @@ namespace DAE23ds
 	//--------------------------------------------------------------------
 	void Writer::finish()
 	{
+		deleteObjects( mReplacedVisualScenes );
+		deleteObjects( mDuplicateObjects );
+	}
+
+	//--------------------------------------------------------------------
+	int Writer::getOwnedObjects() const
+	{
+		if ( mCurrentRun != SCENEGRAPH_RUN )
+			return COLLADAFW::IWriter::OBJECT_NONE;
+		return   COLLADAFW::IWriter::OBJECT_VISUAL_SCENE
+			   | COLLADAFW::IWriter::OBJECT_MATERIAL
+			   | COLLADAFW::IWriter::OBJECT_EFFECT
+			   | COLLADAFW::IWriter::OBJECT_IMAGE;
 	}
 
 	//--------------------------------------------------------------------
@@ -237,7 +264,10 @@ namespace DAE23ds
 	{
 		if ( mCurrentRun != SCENEGRAPH_RUN )
 			return true;
-		mVisualScene = new COLLADAFW::VisualScene(*visualScene);
+		// the writer owns the visual scene, see getOwnedObjects(). A replaced one is deleted in finish().
+		if ( mVisualScene )
+			mReplacedVisualScenes.push_back( mVisualScene );
+		mVisualScene = visualScene;
 		return true;
 	}
 
@@ -258,12 +288,6 @@ namespace DAE23ds
 
 		switch ( mCurrentRun )
 		{
-		case SCENEGRAPH_RUN:
-			{
-				MeshHandler meshHandler( this, (COLLADAFW::Mesh*)geometry );
-				return meshHandler.handle();
-				break;
-			}
 		case GEOMETRY_RUN:
 			{
 				MeshWriter meshWriter( this, (COLLADAFW::Mesh*)geometry );
@@ -280,7 +304,7 @@ namespace DAE23ds
 	{
 		if ( mCurrentRun != SCENEGRAPH_RUN )
 			return true;
-		mUniqueIdFWMaterialMap.insert(std::make_pair(material->getUniqueId(),*material ));
+		insertOwnedObject( mUniqueIdFWMaterialMap, material, mDuplicateObjects );
 		return true;
 	}
 
@@ -289,7 +313,7 @@ namespace DAE23ds
 	{
 		if ( mCurrentRun != SCENEGRAPH_RUN )
 			return true;
-		mUniqueIdFWEffectMap.insert(std::make_pair(effect->getUniqueId(),*effect ));
+		insertOwnedObject( mUniqueIdFWEffectMap, effect, mDuplicateObjects );
 		return true;
 	}
 
@@ -306,7 +330,7 @@ namespace DAE23ds
 	{
 		if ( mCurrentRun != SCENEGRAPH_RUN )
 			return true;
-		mUniqueIdFWImageMap.insert(std::make_pair(image->getUniqueId(),*image ));
+		insertOwnedObject( mUniqueIdFWImageMap, image, mDuplicateObjects );
 		return true;
 	}
 
@@ -400,42 +424,18 @@ namespace DAE23ds
 	}
 
 	//--------------------------------------------------------------------
-	bool Writer::writeHeader( ChunkLength sceneGraphLength )
+	bool Writer::writeHeader()
 	{
-		// triangle mesh 
-		//plus material blocks
-		//plus plus empty chunk
-		ChunkLength edit3DSLength = mObjectAndMaterialBlockLength + EMPTY_CHUNK_LENGTH ;
-
-		// add mesh version size
-		edit3DSLength += MESH_VERSION_CHUNK_LENGTH;
-
-		// add EDIT_MASTERSCALE version length
-		edit3DSLength += EDIT_MASTERSCALE_CHUNK_LENGTH;
-
-
-		// edit 3ds plus empty chunk
-		ChunkLength mainLength = edit3DSLength + EMPTY_CHUNK_LENGTH;
-
-		// add M3D3DS_VERSION version length and scene graph length
-		mainLength += M3D_VERSION_CHUNK_LENGTH+ sceneGraphLength;
-
-
-		//  write header
- 
 		//Main chunk
- 		mBuffer->copyToBuffer(MAIN3DS);
- 		mBuffer->copyToBuffer(mainLength);
- 
- 
+		mMainChunkLength = beginChunk(MAIN3DS);
+
 		// M3D_VERSION version
 		mBuffer->copyToBuffer(M3D3DS_VERSION);
 		mBuffer->copyToBuffer(M3D_VERSION_CHUNK_LENGTH);
 		mBuffer->copyToBuffer(M3D_VERSION);
 
 		//3d editor chunk
- 		mBuffer->copyToBuffer(EDIT3DS);
- 		mBuffer->copyToBuffer(edit3DSLength);
+		mEdit3DSChunkLength = beginChunk(EDIT3DS);
  
 		// mesh version
  		mBuffer->copyToBuffer(MESH3DS_VERSION);
@@ -450,6 +450,21 @@ namespace DAE23ds
 		return true;
 	}
 
+	//--------------------------------------------------------------------
+	Common::Buffer::ReservedId Writer::beginChunk( ChunkID chunkId )
+	{
+		mBuffer->copyToBuffer(chunkId);
+		return mBuffer->reserveUint32();
+	}
+
+	//--------------------------------------------------------------------
+	void Writer::endChunk( Common::Buffer::ReservedId chunkLength )
+	{
+		// the chunk starts with its id, right before the length
+		size_t chunkStart = chunkLength - sizeof(ChunkID);
+		mBuffer->fillReserved( chunkLength, (ChunkLength)(mBuffer->getBytesCopiedToBuffer() - chunkStart) );
+	}
+
 	//--------------------------------------------------------------------
 	ChunkLength Writer::getObjectNameLength()
 	{
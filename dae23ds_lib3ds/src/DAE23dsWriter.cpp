@@ -659,7 +659,7 @@ namespace DAE23ds
 				{
 					assert(COLLADAFW::MeshPrimitive::TRIANGLES==primitives[pi]->getPrimitiveType());
 
-					const COLLADAFW::UIntValuesArray &vertexi = primitives[pi]->getPositionIndices();
+					const COLLADAFW::IndexArray &vertexi = primitives[pi]->getPositionIndexArray();
 					assert(primitives[pi]->getFaceCount()==vertexi.getCount()/3);
 
 					//we write the primitives[pi]->getMaterial() as the tempMIndex'th material to 3ds file.
@@ -668,7 +668,7 @@ namespace DAE2MA
             const COLLADAFW::MeshPrimitive* meshPrimitive = meshPrimitives [ i ];
             COLLADAFW::MeshPrimitive::PrimitiveType primitiveType = meshPrimitive->getPrimitiveType();
             // Get the normal indices of the current primitive.
-            const COLLADAFW::UIntValuesArray& normalIndices = meshPrimitive->getNormalIndices ();
+            const COLLADAFW::IndexArray& normalIndices = meshPrimitive->getNormalIndexArray ();
 
             switch ( primitiveType )
             {
@@ -922,8 +922,8 @@ namespace DAE2MA
             const COLLADAFW::MeshPrimitive::PrimitiveType& primitiveType = meshPrimitive->getPrimitiveType ();
 
             // Get the normal indices of the current primitive.
-            const COLLADAFW::UIntValuesArray& normalIndices = meshPrimitive->getNormalIndices ();
-            const COLLADAFW::UIntValuesArray& vertexIndices = meshPrimitive->getPositionIndices ();
+            const COLLADAFW::IndexArray& normalIndices = meshPrimitive->getNormalIndexArray ();
+            const COLLADAFW::IndexArray& vertexIndices = meshPrimitive->getPositionIndexArray ();
 
             // Get the number of faces of the current primitive element.
             const size_t primitiveFaceCount = meshPrimitive->getFaceCount ();
@@ -1037,8 +1037,8 @@ namespace DAE2MA
         const size_t globalFaceIndex )
     {
         // Get the normal indices of the current primitive.
-        const COLLADAFW::UIntValuesArray& normalIndices = meshPrimitive->getNormalIndices ();
-        const COLLADAFW::UIntValuesArray& vertexIndices = meshPrimitive->getPositionIndices ();
+        const COLLADAFW::IndexArray& normalIndices = meshPrimitive->getNormalIndexArray ();
+        const COLLADAFW::IndexArray& vertexIndices = meshPrimitive->getPositionIndexArray ();
 
         // Get the vertex index.
         unsigned int vertexIndex = vertexIndices [ primitiveVertexIndex ];
@@ -1722,7 +1722,7 @@ namespace DAE2MA
         size_t& endPosition )
     {
         // Get the position and the normal indices.
-        const COLLADAFW::UIntValuesArray& positionIndices = primitiveElement->getPositionIndices ();
+        const COLLADAFW::IndexArray& positionIndices = primitiveElement->getPositionIndexArray ();
 
         // The points of an edge
         int edgeStartVertexIdx=0, edgeEndVertexIdx=0;
@@ -1877,7 +1877,7 @@ namespace DAE2MA
         size_t& endPosition )
     {
         // Get the position indices.
-        const COLLADAFW::UIntValuesArray& positionIndices = primitiveElement->getPositionIndices ();
+        const COLLADAFW::IndexArray& positionIndices = primitiveElement->getPositionIndexArray ();
 
         // The points of an edge
         int edgeStartVertexIdx=0, edgeEndVertexIdx=0;
@@ -2051,7 +2051,7 @@ namespace DAE2MA
         polyFace.f.edgeIdValue = new int[numEdges];
 
         // Get the position indices
-        const COLLADAFW::UIntValuesArray& positionIndices = primitiveElement->getPositionIndices ();
+        const COLLADAFW::IndexArray& positionIndices = primitiveElement->getPositionIndexArray ();
 
         int edgeStartVertexIdx=0, edgeEndVertexIdx=0;
 
@@ -2114,7 +2114,7 @@ namespace DAE2MA
         std::vector<COLLADABU::Math::Vector3*> & polygonPoints )
     {
         // Get the position indices
-        const COLLADAFW::UIntValuesArray& positionIndices = primitiveElement->getPositionIndices ();
+        const COLLADAFW::IndexArray& positionIndices = primitiveElement->getPositionIndexArray ();
         int edgeStartVertexIdx=0, edgeEndVertexIdx=0;
 
         // Handle a hole element.
@@ -2689,7 +2689,7 @@ namespace DAE2MA
         const size_t groupedVertexElementsCount = primitiveElement->getGroupedVertexElementsCount ();
 
         // Get the position indices.
-        const COLLADAFW::UIntValuesArray& positionIndices = primitiveElement->getPositionIndices ();
+        const COLLADAFW::IndexArray& positionIndices = primitiveElement->getPositionIndexArray ();
 
         // The points of an edge
         int edgeStartVertexIdx=0, edgeEndVertexIdx=0;
@@ -2781,7 +2781,7 @@ namespace DAE2MA
         EdgeMap& edgeIndicesMap )
     {
         // Get the position indices.
-        const COLLADAFW::UIntValuesArray& positionIndices = primitiveElement->getPositionIndices ();
+        const COLLADAFW::IndexArray& positionIndices = primitiveElement->getPositionIndexArray ();
 
         // The points of an edge
         int edgeStartVertexIdx=0, edgeEndVertexIdx=0;
@@ -2846,7 +2846,7 @@ namespace DAE2MA
         EdgeMap& edgeIndicesMap )
     {
         // Get the position indices.
-        const COLLADAFW::UIntValuesArray& positionIndices = primitiveElement->getPositionIndices ();
+        const COLLADAFW::IndexArray& positionIndices = primitiveElement->getPositionIndexArray ();
 
         // The points of an edge
         int edgeStartVertexIdx=0, edgeEndVertexIdx=0;
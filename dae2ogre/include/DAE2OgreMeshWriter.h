@@ -115,7 +115,8 @@ namespace DAE2Ogre
 		size_t calcSubMeshSize( int numIndices, const String& submeshName );
 		void calcMeshSize( );
 		void writeSubMeshOperation( COLLADAFW::MeshPrimitive::PrimitiveType primitiveType );
-		void calculateMeshBounds();
+		/** Extends the mesh bounds by @a boundingBox transformed by @a matrix.*/
+		void calculateMeshBounds( const COLLADAFW::BoundingBox& boundingBox, const COLLADABU::Math::Matrix4& matrix );
 		void writeSubMeshNameTableEntry( const String& name, uint16 index );
 		void writeBoundsInfo( );
 		void writeSubMeshNameTable( );
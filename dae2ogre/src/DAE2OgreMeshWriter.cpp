@@ -313,20 +313,20 @@ namespace DAE2Ogre
 
 		int numIndices = 0;
 
-		const COLLADAFW::UIntValuesArray& positionIndices =  meshPrimitive->getPositionIndices();
+		const COLLADAFW::IndexArray& positionIndices =  meshPrimitive->getPositionIndexArray();
 		size_t positionIndicesCount  = positionIndices.getCount();
 
-		const COLLADAFW::UIntValuesArray& normalIndices =  meshPrimitive->getNormalIndices();
+		const COLLADAFW::IndexArray& normalIndices =  meshPrimitive->getNormalIndexArray();
 		size_t normalIndicesCount = normalIndices.getCount();
 		mHasNormals = (normalIndicesCount != 0);
 
 
-		const COLLADAFW::UIntValuesArray* uvIndices;
+		const COLLADAFW::IndexArray* uvIndices;
 		size_t uvIndicesCount = 0;
 		const COLLADAFW::IndexListArray& uVIndicesList = meshPrimitive->getUVCoordIndicesArray();
 		if ( !uVIndicesList.empty() )
 		{
-			uvIndices = &uVIndicesList[0]->getIndices();
+			uvIndices = &uVIndicesList[0]->getIndexArray();
 			uvIndicesCount = uvIndices->getCount();
 			mHasUVCoords = (uvIndicesCount != 0);
 		}
@@ -361,6 +361,8 @@ namespace DAE2Ogre
 					Tuple tuple( positionIndex, normalIndex, uvIndex, 0);
 					addTupleIndex(tuple);
 				}
+
+				calculateMeshBounds( meshPrimitive->getBoundingBox(), matrix );
 			}
 			break;
 		default:
@@ -400,8 +402,6 @@ namespace DAE2Ogre
 
 		writeSubMeshOperation( meshPrimitive->getPrimitiveType() );
 
-		calculateMeshBounds();
-
 		mNextTupleIndex = 0;
 		mOgrPositions.clear();
 		mOgreNormals.clear();
@@ -693,43 +693,25 @@ namespace DAE2Ogre
 	}
 
 	//-----------------------------------------------------------------------
-	void MeshWriter::calculateMeshBounds()
+	void MeshWriter::calculateMeshBounds( const COLLADAFW::BoundingBox& boundingBox, const COLLADABU::Math::Matrix4& matrix )
 	{
-		size_t count = mOgrPositions.getCount();
-		for ( size_t i = 0; i < count; i += 3)
+		// The bounding box of the primitive has been calculated by the loader, so the positions
+		// do not need to be walked again.
+		if ( boundingBox.isEmpty() )
+			return;
+
+		COLLADAFW::BoundingBox transformedBoundingBox = boundingBox.transformed( matrix );
+		const COLLADABU::Math::Vector3& min = transformedBoundingBox.getMin();
+		const COLLADABU::Math::Vector3& max = transformedBoundingBox.getMax();
+		for ( size_t i = 0; i < 3; ++i )
 		{
-			double* position = &mOgrPositions[i];
-			if ( mMeshBoundsSet )
-			{
-				if ( position[0] < mMeshBoundsMin[ 0 ] )
-					mMeshBoundsMin[ 0 ] = ( float ) position[0];
-
-				if ( position[1] < mMeshBoundsMin[ 1 ] )
-					mMeshBoundsMin[ 1 ] = ( float ) position[1];
-
-				if ( position[2] < mMeshBoundsMin[ 2 ] )
-					mMeshBoundsMin[ 2 ] = ( float ) position[2];
-
-				if ( position[0] > mMeshBoundsMax[ 0 ] )
-					mMeshBoundsMax[ 0 ] = ( float ) position[0];
+			if ( !mMeshBoundsSet || min[i] < mMeshBoundsMin[ i ] )
+				mMeshBoundsMin[ i ] = ( float ) min[i];
 
-				if ( position[1] > mMeshBoundsMax[ 1 ] )
-					mMeshBoundsMax[ 1 ] = ( float ) position[1];
-
-				if ( position[2] > mMeshBoundsMax[ 2 ] )
-					mMeshBoundsMax[ 2 ] = ( float ) position[2];
-			}
-			else
-			{
-				mMeshBoundsMin[ 0 ] = ( float ) position[0];
-				mMeshBoundsMin[ 1 ] = ( float ) position[1];
-				mMeshBoundsMin[ 2 ] = ( float ) position[2];
-				mMeshBoundsMax[ 0 ] = ( float ) position[0];
-				mMeshBoundsMax[ 1 ] = ( float ) position[1];
-				mMeshBoundsMax[ 2 ] = ( float ) position[2];
-				mMeshBoundsSet = true;
-			}
+			if ( !mMeshBoundsSet || max[i] > mMeshBoundsMax[ i ] )
+				mMeshBoundsMax[ i ] = ( float ) max[i];
 		}
+		mMeshBoundsSet = true;
 	}
 
 } // namespace DAE2Ogre